@@ -156,6 +156,103 @@ pub fn build(b: *std.Build) void {
     // way for the user to request running the tests.
     const test_step = b.step("test", "Run tests");
     test_step.dependOn(&test_command.step);
+
+    // Benchmarks are built for and ran on the host, so they can be measured natively without Wine.
+    // They are always built in release mode unless told otherwise, because debug measurements are meaningless.
+    const bench_target = b.graph.host;
+    const bench_optimize = b.option(
+        std.builtin.OptimizeMode,
+        "bench-optimize",
+        "Optimization mode of the benchmarks. (Default: ReleaseFast)",
+    ) orelse .ReleaseFast;
+    const bench_lib_c_time = libCTimeDependency(b, bench_target, bench_optimize);
+    const bench_xz = xzDependency(b, bench_target, bench_optimize);
+    const bench = b.addExecutable(.{
+        .name = "irony_bench",
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("src/bench.zig"),
+            .target = bench_target,
+            .optimize = bench_optimize,
+            .link_libc = true,
+        }),
+    });
+    bench.root_module.addImport("build_info", build_info_t8);
+    bench.root_module.addImport("lib_c_time", bench_lib_c_time);
+    bench.root_module.addImport("win32", win32);
+    bench.root_module.linkLibrary(bench_xz.library);
+    bench.root_module.addImport("xz", bench_xz.module);
+
+    // This allows passing arguments to the benchmarks, like this: `zig build bench -- --baseline bench.json`
+    const bench_command = b.addRunArtifact(bench);
+    if (b.args) |args| {
+        bench_command.addArgs(args);
+    }
+    const bench_step = b.step("bench", "Run benchmarks natively on the host");
+    bench_step.dependOn(&bench_command.step);
+
+    // Headless tool for editing recording files. Like the benchmarks, it runs natively on the host.
+    const recording_tool = b.addExecutable(.{
+        .name = "irony_recording",
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("src/recording.zig"),
+            .target = bench_target,
+            .optimize = optimize,
+            .link_libc = true,
+        }),
+    });
+    const recording_tool_lib_c_time = libCTimeDependency(b, bench_target, optimize);
+    const recording_tool_xz = xzDependency(b, bench_target, optimize);
+    recording_tool.root_module.addImport("build_info", build_info_t8);
+    recording_tool.root_module.addImport("lib_c_time", recording_tool_lib_c_time);
+    recording_tool.root_module.addImport("win32", win32);
+    recording_tool.root_module.linkLibrary(recording_tool_xz.library);
+    recording_tool.root_module.addImport("xz", recording_tool_xz.module);
+
+    // This allows passing the command to the tool, like this: `zig build recording -- trim in.irony out.irony 0 600`
+    const recording_tool_command = b.addRunArtifact(recording_tool);
+    if (b.args) |args| {
+        recording_tool_command.addArgs(args);
+    }
+    const recording_tool_step = b.step("recording", "Edit recording files without starting the game");
+    recording_tool_step.dependOn(&recording_tool_command.step);
+
+    // Shortcut for exporting recordings for bulk analysis, like this: `zig build columnar -- recordings columnar`
+    const columnar_command = b.addRunArtifact(recording_tool);
+    columnar_command.addArg("to-columnar");
+    if (b.args) |args| {
+        columnar_command.addArgs(args);
+    }
+    const columnar_step = b.step("columnar", "Export recordings or whole directories of them as columnar files");
+    columnar_step.dependOn(&columnar_command.step);
+
+    // UI perf tests draw the UI headless with the test engine, without any renderer, natively on the host.
+    const ui_perf_lib_c_time = libCTimeDependency(b, bench_target, bench_optimize);
+    const ui_perf_imgui_te = imguiDependency(b, bench_target, bench_optimize, true);
+    const ui_perf_xz = xzDependency(b, bench_target, bench_optimize);
+    const ui_perf = b.addExecutable(.{
+        .name = "irony_ui_perf",
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("src/ui_perf.zig"),
+            .target = bench_target,
+            .optimize = bench_optimize,
+            .link_libc = true,
+        }),
+    });
+    ui_perf.root_module.addImport("build_info", build_info_t8);
+    ui_perf.root_module.addImport("lib_c_time", ui_perf_lib_c_time);
+    ui_perf.root_module.addImport("win32", win32);
+    ui_perf.root_module.linkLibrary(ui_perf_imgui_te.library);
+    ui_perf.root_module.addImport("imgui", ui_perf_imgui_te.module);
+    ui_perf.root_module.linkLibrary(ui_perf_xz.library);
+    ui_perf.root_module.addImport("xz", ui_perf_xz.module);
+
+    // This allows passing arguments to the perf tests, like this: `zig build ui-perf -- --format junit`
+    const ui_perf_command = b.addRunArtifact(ui_perf);
+    if (b.args) |args| {
+        ui_perf_command.addArgs(args);
+    }
+    const ui_perf_step = b.step("ui-perf", "Run headless UI perf tests natively on the host");
+    ui_perf_step.dependOn(&ui_perf_command.step);
 }
 
 const ModuleAndLibrary = struct {
@@ -280,11 +377,17 @@ fn imguiDependency(
         "./imgui/imgui_draw.cpp",
         "./imgui/imgui_tables.cpp",
         "./imgui/imgui_widgets.cpp",
-        "./imgui/backends/imgui_impl_dx11.cpp",
-        "./imgui/backends/imgui_impl_dx12.cpp",
-        "./imgui/backends/imgui_impl_win32.cpp",
         "./imgui_file_dialog/ImGuiFileDialog_patched.cpp",
     } });
+    // Backends are left out when building for the host, where the UI only runs headless inside the UI perf tests.
+    const is_windows = target.result.os.tag == .windows;
+    if (is_windows) {
+        library.root_module.addCSourceFiles(.{ .root = directory, .files = &.{
+            "./imgui/backends/imgui_impl_dx11.cpp",
+            "./imgui/backends/imgui_impl_dx12.cpp",
+            "./imgui/backends/imgui_impl_win32.cpp",
+        } });
+    }
     if (use_test_engine) {
         library.root_module.addCSourceFiles(.{ .root = directory, .files = &.{
             "./cimgui_test_engine.cpp",
@@ -298,12 +401,14 @@ fn imguiDependency(
             "./imgui_test_engine/imgui_te_utils.cpp",
         } });
     }
-    library.root_module.linkSystemLibrary("d3dcompiler_47", .{}); // Required by: imgui_impl_dx12.cpp
-    library.root_module.linkSystemLibrary("dwmapi", .{}); // Required by: imgui_impl_win32.cpp
-    switch (target.result.abi) { // Required by: imgui_impl_win32.cpp
-        .msvc => library.root_module.linkSystemLibrary("Gdi32", .{}),
-        .gnu => library.root_module.linkSystemLibrary("gdi32", .{}),
-        else => {},
+    if (is_windows) {
+        library.root_module.linkSystemLibrary("d3dcompiler_47", .{}); // Required by: imgui_impl_dx12.cpp
+        library.root_module.linkSystemLibrary("dwmapi", .{}); // Required by: imgui_impl_win32.cpp
+        switch (target.result.abi) { // Required by: imgui_impl_win32.cpp
+            .msvc => library.root_module.linkSystemLibrary("Gdi32", .{}),
+            .gnu => library.root_module.linkSystemLibrary("gdi32", .{}),
+            else => {},
+        }
     }
     library.root_module.addCMacro("IMGUI_IMPL_API", "extern \"C\"");
     library.root_module.addCMacro("IMGUI_DISABLE_OBSOLETE_FUNCTIONS", "1");
@@ -0,0 +1,166 @@
+const std = @import("std");
+const sdk = @import("sdk/root.zig");
+const bench = @import("bench/root.zig");
+
+const console_logger = sdk.log.ConsoleLogger(.{ .level = .info });
+pub const std_options = std.Options{
+    .log_level = .info,
+    .logFn = console_logger.logFn,
+};
+
+const usage =
+    \\Usage: zig build bench -- [options]
+    \\
+    \\Options:
+    \\  --warmup <n>            Number of unmeasured iterations before measuring. (Default: 3)
+    \\  --iterations <n>        Number of measured iterations. (Default: 20)
+    \\  --filter <text>         Only run benchmarks whose name contains the text.
+    \\  --output <path>         Write the JSON report into a file instead of the standard output.
+    \\  --baseline <path>       Compare results with a previously written JSON report.
+    \\  --threshold <ratio>     Relative median slowdown considered a regression. (Default: 0.1)
+    \\  --fail-on-regression    Exit with a non zero code when a regression is detected.
+    \\
+;
+
+const Arguments = struct {
+    runner_config: bench.RunnerConfig = .{},
+    output_path: ?[]const u8 = null,
+    baseline_path: ?[]const u8 = null,
+    threshold: f64 = 0.1,
+    fail_on_regression: bool = false,
+};
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    const args = std.process.argsAlloc(allocator) catch |err| {
+        sdk.misc.error_context.new("Failed to read process arguments.", .{});
+        sdk.misc.error_context.logError(err);
+        return err;
+    };
+    defer std.process.argsFree(allocator, args);
+    const arguments = parseArguments(args[1..]) catch |err| {
+        sdk.misc.error_context.logError(err);
+        std.debug.print("{s}", .{usage});
+        return err;
+    };
+
+    var runner = bench.Runner.init(allocator, arguments.runner_config);
+    defer runner.deinit();
+    inline for (bench.suites) |suite| {
+        suite.run(&runner) catch |err| {
+            sdk.misc.error_context.append("Failed to run benchmark suite: {s}", .{@typeName(suite)});
+            sdk.misc.error_context.logError(err);
+            return err;
+        };
+    }
+
+    var parsed_baseline: ?std.json.Parsed(bench.Report) = null;
+    defer if (parsed_baseline) |*p| p.deinit();
+    var comparisons: []const bench.Comparison = &.{};
+    defer if (comparisons.len > 0) allocator.free(comparisons);
+    if (arguments.baseline_path) |path| {
+        parsed_baseline = bench.loadReport(allocator, path) catch |err| {
+            sdk.misc.error_context.append("Failed to load baseline.", .{});
+            sdk.misc.error_context.logError(err);
+            return err;
+        };
+        comparisons = bench.compareWithBaseline(
+            allocator,
+            runner.results.items,
+            parsed_baseline.?.value.results,
+            arguments.threshold,
+        ) catch |err| {
+            sdk.misc.error_context.append("Failed to compare results with baseline.", .{});
+            sdk.misc.error_context.logError(err);
+            return err;
+        };
+    }
+
+    const report = bench.Report{ .results = runner.results.items, .comparisons = comparisons };
+    if (arguments.output_path) |path| {
+        bench.saveReport(&report, path) catch |err| {
+            sdk.misc.error_context.logError(err);
+            return err;
+        };
+        std.log.info("Report written to: {s}", .{path});
+    } else {
+        var buffer: [4096]u8 = undefined;
+        var stdout_writer = std.fs.File.stdout().writer(&buffer);
+        bench.writeReport(&stdout_writer.interface, &report) catch |err| {
+            sdk.misc.error_context.logError(err);
+            return err;
+        };
+        stdout_writer.interface.flush() catch |err| {
+            sdk.misc.error_context.new("Failed to flush the standard output.", .{});
+            sdk.misc.error_context.logError(err);
+            return err;
+        };
+    }
+
+    var number_of_regressions: usize = 0;
+    for (comparisons) |*comparison| {
+        if (comparison.is_regression) {
+            number_of_regressions += 1;
+            std.log.warn("Regression in {s}: {} ns -> {} ns ({d:.2}x)", .{
+                comparison.name,
+                comparison.baseline_median_ns,
+                comparison.median_ns,
+                comparison.ratio,
+            });
+        }
+    }
+    if (number_of_regressions > 0 and arguments.fail_on_regression) {
+        std.log.err("Detected {} regressions compared to the baseline.", .{number_of_regressions});
+        std.process.exit(1);
+    }
+}
+
+fn parseArguments(args: []const []const u8) !Arguments {
+    var arguments = Arguments{};
+    var index: usize = 0;
+    while (index < args.len) : (index += 1) {
+        const arg = args[index];
+        if (std.mem.eql(u8, arg, "--fail-on-regression")) {
+            arguments.fail_on_regression = true;
+            continue;
+        }
+        if (index + 1 >= args.len) {
+            sdk.misc.error_context.new("Missing value for argument: {s}", .{arg});
+            return error.MissingValue;
+        }
+        index += 1;
+        const value = args[index];
+        if (std.mem.eql(u8, arg, "--warmup")) {
+            arguments.runner_config.warmup_iterations = try parseValue(usize, arg, value);
+        } else if (std.mem.eql(u8, arg, "--iterations")) {
+            arguments.runner_config.iterations = try parseValue(usize, arg, value);
+        } else if (std.mem.eql(u8, arg, "--threshold")) {
+            arguments.threshold = try parseValue(f64, arg, value);
+        } else if (std.mem.eql(u8, arg, "--filter")) {
+            arguments.runner_config.filter = value;
+        } else if (std.mem.eql(u8, arg, "--output")) {
+            arguments.output_path = value;
+        } else if (std.mem.eql(u8, arg, "--baseline")) {
+            arguments.baseline_path = value;
+        } else {
+            sdk.misc.error_context.new("Unknown argument: {s}", .{arg});
+            return error.UnknownArgument;
+        }
+    }
+    return arguments;
+}
+
+fn parseValue(comptime Type: type, arg: []const u8, value: []const u8) !Type {
+    const result = switch (@typeInfo(Type)) {
+        .int => std.fmt.parseInt(Type, value, 10),
+        .float => std.fmt.parseFloat(Type, value),
+        else => @compileError("Unsupported argument type: " ++ @typeName(Type)),
+    };
+    return result catch |err| {
+        sdk.misc.error_context.new("Invalid value \"{s}\" for argument: {s}", .{ value, arg });
+        return err;
+    };
+}
@@ -0,0 +1,188 @@
+const std = @import("std");
+const sdk = @import("../sdk/root.zig");
+const core = @import("../dll/core/root.zig");
+const model = @import("../dll/model/root.zig");
+const bench = @import("root.zig");
+
+const number_of_frames = 1024;
+const number_of_redetected_frames = 10 * 60 * 60;
+
+pub fn run(runner: *bench.Runner) !void {
+    try runHitDetector(runner);
+    try runInputIndex(runner);
+    try runRedetection(runner);
+    try runInstantReplay(runner);
+}
+
+fn runHitDetector(runner: *bench.Runner) !void {
+    if (!runner.isEnabled("core.hit_detector.detect")) {
+        return;
+    }
+    const source_frames = bench.generateFrames(runner.allocator, number_of_frames, 0) catch |err| {
+        sdk.misc.error_context.append("Failed to generate frames.", .{});
+        return err;
+    };
+    defer runner.allocator.free(source_frames);
+    const work_frames = runner.allocator.alloc(model.Frame, number_of_frames) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate frames.", .{});
+        return err;
+    };
+    defer runner.allocator.free(work_frames);
+
+    const Context = struct {
+        source_frames: []const model.Frame,
+        work_frames: []model.Frame,
+    };
+    // Copying the frames is part of every iteration because detection marks the flags inside the frames.
+    try runner.run("core.hit_detector.detect", .{
+        .items_per_iteration = number_of_frames,
+    }, &Context{ .source_frames = source_frames, .work_frames = work_frames }, struct {
+        fn call(context: *const Context) anyerror!void {
+            @memcpy(context.work_frames, context.source_frames);
+            var detector = core.HitDetector{};
+            for (context.work_frames) |*frame| {
+                detector.detect(frame);
+            }
+            std.mem.doNotOptimizeAway(context.work_frames.ptr);
+        }
+    }.call);
+}
+
+fn runInputIndex(runner: *bench.Runner) !void {
+    if (!runner.isEnabled("core.input_index.build") and !runner.isEnabled("core.input_index.search")) {
+        return;
+    }
+    const frames = bench.generateFrames(runner.allocator, number_of_frames, 0) catch |err| {
+        sdk.misc.error_context.append("Failed to generate frames.", .{});
+        return err;
+    };
+    defer runner.allocator.free(frames);
+    var index = core.InputIndex.init(runner.allocator, frames) catch |err| {
+        sdk.misc.error_context.append("Failed to build input index.", .{});
+        return err;
+    };
+    defer index.deinit();
+
+    const Context = struct {
+        allocator: std.mem.Allocator,
+        frames: []const model.Frame,
+        index: *const core.InputIndex,
+        query: core.InputQuery,
+        matches: std.ArrayList(core.InputMatch) = .empty,
+    };
+    // Pressing 2 within 3 frames of the opponent's block stun ending, a common frame trap check.
+    var context = Context{
+        .allocator = runner.allocator,
+        .frames = frames,
+        .index = &index,
+        .query = .{ .steps = &.{
+            .{ .player_id = .player_2, .event = .block_stun_end },
+            .{ .player_id = .player_1, .event = .button_2, .min_offset = -3, .max_offset = 3 },
+        } },
+    };
+    defer context.matches.deinit(runner.allocator);
+    try runner.run("core.input_index.build", .{
+        .items_per_iteration = number_of_frames,
+    }, &context, struct {
+        fn call(c: *Context) anyerror!void {
+            var built = try core.InputIndex.init(c.allocator, c.frames);
+            defer built.deinit();
+            std.mem.doNotOptimizeAway(&built);
+        }
+    }.call);
+    try runner.run("core.input_index.search", .{
+        .items_per_iteration = number_of_frames,
+    }, &context, struct {
+        fn call(c: *Context) anyerror!void {
+            c.matches.clearRetainingCapacity();
+            try c.index.search(c.allocator, &c.query, &c.matches);
+            std.mem.doNotOptimizeAway(c.matches.items.ptr);
+        }
+    }.call);
+}
+
+fn runRedetection(runner: *bench.Runner) !void {
+    if (!runner.isEnabled("core.redetect.serial") and !runner.isEnabled("core.redetect.parallel")) {
+        return;
+    }
+    const frames = bench.generateFrames(runner.allocator, number_of_redetected_frames, 0) catch |err| {
+        sdk.misc.error_context.append("Failed to generate frames.", .{});
+        return err;
+    };
+    defer runner.allocator.free(frames);
+    var pool: sdk.misc.ThreadPool = undefined;
+    pool.init(runner.allocator, .{}) catch |err| {
+        sdk.misc.error_context.append("Failed to initialize thread pool.", .{});
+        return err;
+    };
+    defer pool.deinit();
+
+    const Context = struct {
+        allocator: std.mem.Allocator,
+        pool: *sdk.misc.ThreadPool,
+        frames: []model.Frame,
+        stats: core.RedetectionStats = .{},
+    };
+    var context = Context{ .allocator = runner.allocator, .pool = &pool, .frames = frames };
+    // Redetection replaces everything detected before, so the frames don't have to be copied between iterations.
+    try runner.run("core.redetect.serial", .{
+        .items_per_iteration = number_of_redetected_frames,
+    }, &context, struct {
+        fn call(c: *Context) anyerror!void {
+            core.redetect(c.frames);
+            std.mem.doNotOptimizeAway(c.frames.ptr);
+        }
+    }.call);
+    try runner.run("core.redetect.parallel", .{
+        .items_per_iteration = number_of_redetected_frames,
+    }, &context, struct {
+        fn call(c: *Context) anyerror!void {
+            c.stats = try core.redetectParallel(c.allocator, c.pool, c.frames, .{});
+            std.mem.doNotOptimizeAway(c.frames.ptr);
+        }
+    }.call);
+    if (runner.isEnabled("core.redetect.parallel")) {
+        std.log.info("core.redetect.parallel: {} of {} chunks had to be detected serially", .{
+            context.stats.number_of_serial_chunks,
+            context.stats.number_of_chunks,
+        });
+    }
+}
+
+fn runInstantReplay(runner: *bench.Runner) !void {
+    if (!runner.isEnabled("core.instant_replay.capture")) {
+        return;
+    }
+    const frames = bench.generateFrames(runner.allocator, number_of_frames, 0) catch |err| {
+        sdk.misc.error_context.append("Failed to generate frames.", .{});
+        return err;
+    };
+    defer runner.allocator.free(frames);
+    var replay = core.InstantReplay.init(runner.allocator, ".") catch |err| {
+        sdk.misc.error_context.append("Failed to initialize instant replay.", .{});
+        return err;
+    };
+    defer replay.deinit();
+
+    const Context = struct {
+        frames: []const model.Frame,
+        replay: *core.InstantReplay,
+    };
+    // Once the ring fills up every capture also overwrites the oldest frame, which is how it runs during a session.
+    try runner.run("core.instant_replay.capture", .{
+        .items_per_iteration = number_of_frames,
+        .bytes_per_iteration = number_of_frames * @sizeOf(model.PackedFrame),
+    }, &Context{ .frames = frames, .replay = &replay }, struct {
+        fn call(context: *const Context) anyerror!void {
+            for (context.frames) |*frame| {
+                context.replay.capture(frame);
+            }
+            std.mem.doNotOptimizeAway(context.replay.ring);
+        }
+    }.call);
+    std.log.info("core.instant_replay: {} frames ({} seconds) in {} bytes", .{
+        core.InstantReplay.capacity,
+        core.InstantReplay.duration,
+        core.InstantReplay.memory_size,
+    });
+}
@@ -0,0 +1,116 @@
+const std = @import("std");
+const sdk = @import("../sdk/root.zig");
+const model = @import("../dll/model/root.zig");
+
+// Generates a deterministic sequence of fully populated frames.
+// Players circle each other, bones sway smoothly and the discrete state changes every few frames,
+// which resembles the kind of data the capturer produces during a real match.
+pub fn generateFrames(allocator: std.mem.Allocator, number_of_frames: usize, seed: u64) ![]model.Frame {
+    const frames = allocator.alloc(model.Frame, number_of_frames) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate {} frames.", .{number_of_frames});
+        return err;
+    };
+    var random = std.Random.DefaultPrng.init(seed);
+    for (frames, 0..) |*frame, index| {
+        frame.* = generateFrame(index, random.random());
+    }
+    return frames;
+}
+
+pub fn generateFrame(index: usize, random: std.Random) model.Frame {
+    const t: f32 = @floatFromInt(index);
+    return .{
+        .frames_since_round_start = @intCast(index),
+        .floor_z = 0,
+        .players = .{
+            generatePlayer(.player_1, index, random),
+            generatePlayer(.player_2, index, random),
+        },
+        .camera = .{
+            .position = .fromArray(.{ 300 * @cos(0.002 * t), 300 * @sin(0.002 * t), 150 }),
+            .pitch = -0.1,
+            .yaw = 0.002 * t,
+            .roll = 0,
+        },
+        .left_player_id = if ((index / 600) % 2 == 0) .player_1 else .player_2,
+        .main_player_id = .player_1,
+    };
+}
+
+fn generatePlayer(id: model.PlayerId, index: usize, random: std.Random) model.Player {
+    const t: f32 = @floatFromInt(index);
+    const side: f32 = if (id == .player_1) 1 else -1;
+    const center = sdk.math.Vec3.fromArray(.{ side * 150 * @cos(0.005 * t), side * 150 * @sin(0.005 * t), 0 });
+    const move_length = 30 + 10 * @as(usize, @intFromEnum(id));
+    const move_frame: u32 = @intCast(index % move_length);
+    const move_phase: model.MovePhase = switch (move_frame) {
+        0...9 => .start_up,
+        10...12 => .active,
+        else => .recovery,
+    };
+
+    var hurt_cylinders = model.HurtCylinders.initUndefined();
+    for (std.enums.values(model.HurtCylinderId), 0..) |cylinder_id, cylinder_index| {
+        const phase: f32 = @floatFromInt(cylinder_index);
+        hurt_cylinders.set(cylinder_id, .{ .cylinder = .{
+            .center = center.add(.fromArray(.{
+                10 * @sin(0.1 * t + phase),
+                10 * @cos(0.1 * t + phase),
+                10 + 8 * phase,
+            })),
+            .radius = 8 + phase,
+            .half_height = 6,
+        } });
+    }
+    var collision_spheres = model.CollisionSpheres.initUndefined();
+    for (std.enums.values(model.CollisionSphereId), 0..) |sphere_id, sphere_index| {
+        const phase: f32 = @floatFromInt(sphere_index);
+        collision_spheres.set(sphere_id, .{
+            .center = center.add(.fromArray(.{ 5 * @sin(0.1 * t + phase), 5 * @cos(0.1 * t + phase), 15 * phase })),
+            .radius = 10,
+        });
+    }
+    var hit_lines = model.HitLines{};
+    if (move_phase == .active) {
+        const other_center = center.negate();
+        for (0..2) |line_index| {
+            const offset: f32 = @floatFromInt(line_index);
+            hit_lines.buffer[line_index] = .{ .line = .{
+                .point_1 = center.add(.fromArray(.{ 0, 0, 100 + 10 * offset })),
+                .point_2 = other_center.add(.fromArray(.{ 0, 0, 100 + 10 * offset })),
+            } };
+        }
+        hit_lines.len = 2;
+    }
+
+    return .{
+        .character_id = 10 + @as(u32, @intFromEnum(id)),
+        .animation_id = 1000 + @as(u32, @intCast(index / move_length)),
+        .animation_frame = move_frame,
+        .animation_total_frames = @intCast(move_length),
+        .move_phase = move_phase,
+        .animation_to_move_delta = 0,
+        .first_active_frame = 10,
+        .last_active_frame = 12,
+        .connected_frame = if (move_frame > 12) 11 else null,
+        .attack_type = if (random.uintLessThan(u8, 4) == 0) .low else .mid,
+        .min_attack_z = 80,
+        .max_attack_z = 120,
+        .attack_range = 2 + random.float(f32),
+        .recovery_range = 1 + random.float(f32),
+        .attack_damage = 12,
+        .hit_outcome = if (move_phase == .active) .normal_hit_standing else .none,
+        .posture = .standing,
+        .blocking = .not_blocking,
+        .crushing = .{ .high_crushing = move_phase == .recovery },
+        .can_move = move_phase == .recovery,
+        .input = .{ .forward = move_frame < 5, .button_1 = move_frame == 0 },
+        .health = 180 - @as(i32, @intCast((index / 200) % 180)),
+        .rage = .available,
+        .heat = .{ .activated = .{ .gauge = @mod(0.001 * t, 1) } },
+        .rotation = @mod(0.005 * t + side, 2 * std.math.pi),
+        .hurt_cylinders = hurt_cylinders,
+        .collision_spheres = collision_spheres,
+        .hit_lines = hit_lines,
+    };
+}
@@ -0,0 +1,302 @@
+const std = @import("std");
+const build_info = @import("build_info");
+const sdk = @import("../sdk/root.zig");
+const game = @import("../dll/game/root.zig");
+const model = @import("../dll/model/root.zig");
+
+// Stand-in for the memory of a running game. Player and camera structs are laid out inside process local buffers
+// using the same field offsets that game.Memory.init uses, so the proxies, frame detector and capturer run the exact
+// same code paths they run inside the game. Frames are written into the buffers by reversing the game conversions.
+pub fn GameMemory(comptime game_id: build_info.Game) type {
+    return struct {
+        allocator: std.mem.Allocator,
+        player_offsets: PlayerOffsets,
+        player_1: []align(buffer_alignment) u8,
+        player_2: []align(buffer_alignment) u8,
+        camera: *game.Camera(game_id),
+        memory: game.Memory(game_id),
+
+        const Self = @This();
+        const Player = game.Player(game_id);
+        const PlayerOffsets = sdk.misc.FieldMap(Player, ?usize, null);
+        const buffer_alignment = std.mem.Alignment.@"64";
+        const offset_patterns = game.Memory(game_id).player_offset_patterns;
+
+        pub fn init(allocator: std.mem.Allocator) !Self {
+            const player_offsets = try findPlayerOffsets(allocator);
+            const size = (sdk.memory.StructProxy(Player){
+                .base_trail = .fromArray(.{0}),
+                .field_offsets = player_offsets,
+            }).findSizeFromMaxOffset();
+            const player_1 = allocator.alignedAlloc(u8, buffer_alignment, size) catch |err| {
+                sdk.misc.error_context.new("Failed to allocate player 1 memory.", .{});
+                return err;
+            };
+            errdefer allocator.free(player_1);
+            @memset(player_1, 0);
+            const player_2 = allocator.alignedAlloc(u8, buffer_alignment, size) catch |err| {
+                sdk.misc.error_context.new("Failed to allocate player 2 memory.", .{});
+                return err;
+            };
+            errdefer allocator.free(player_2);
+            @memset(player_2, 0);
+            const camera = allocator.create(game.Camera(game_id)) catch |err| {
+                sdk.misc.error_context.new("Failed to allocate camera memory.", .{});
+                return err;
+            };
+            camera.* = std.mem.zeroes(game.Camera(game_id));
+            return .{
+                .allocator = allocator,
+                .player_offsets = player_offsets,
+                .player_1 = player_1,
+                .player_2 = player_2,
+                .camera = camera,
+                .memory = .{
+                    .player_1 = .{
+                        .base_trail = .fromArray(.{@intFromPtr(player_1.ptr)}),
+                        .field_offsets = player_offsets,
+                    },
+                    .player_2 = .{
+                        .base_trail = .fromArray(.{@intFromPtr(player_2.ptr)}),
+                        .field_offsets = player_offsets,
+                    },
+                    .camera = .fromArray(.{@intFromPtr(camera)}),
+                    .functions = .{},
+                },
+            };
+        }
+
+        pub fn deinit(self: *Self) void {
+            self.allocator.destroy(self.camera);
+            self.allocator.free(self.player_2);
+            self.allocator.free(self.player_1);
+        }
+
+        pub fn writeFrame(self: *Self, frame: *const model.Frame) void {
+            self.writePlayer(self.player_1, frame, .player_1);
+            self.writePlayer(self.player_2, frame, .player_2);
+            if (frame.camera) |*camera| {
+                self.camera.* = .fromConverted(.{
+                    .position = camera.position,
+                    .pitch = camera.pitch,
+                    .yaw = camera.yaw,
+                    .roll = camera.roll,
+                });
+            }
+        }
+
+        fn writePlayer(self: *const Self, buffer: []u8, frame: *const model.Frame, player_id: model.PlayerId) void {
+            const player = frame.getPlayerById(player_id);
+            const is_main = frame.main_player_id == player_id;
+            const is_left = frame.left_player_id == player_id;
+            self.writeField(buffer, "is_picked_by_main_player", .fromBool(is_main));
+            self.writeField(buffer, "input_side", if (is_left) .left else .right);
+            if (frame.frames_since_round_start) |value| self.writeField(buffer, "frames_since_round_start", value);
+            if (frame.floor_z) |value| self.writeField(buffer, "floor_z", .fromConverted(value));
+            if (player.character_id) |value| self.writeField(buffer, "character_id", value);
+            if (player.animation_id) |value| self.writeField(buffer, "animation_id", value);
+            if (player.animation_frame) |value| self.writeField(buffer, "animation_frame", value);
+            if (player.animation_total_frames) |value| self.writeField(buffer, "animation_total_frames", value);
+            if (player.attack_damage) |value| self.writeField(buffer, "attack_damage", value);
+            if (player.can_move) |value| self.writeField(buffer, "can_move", .fromBool(value));
+            if (player.rotation) |rotation| {
+                self.writeField(buffer, "rotation", .fromConverted(rotation));
+                if (player.getPosition()) |position| {
+                    // Model's forward direction is +Y, so the transform rotation differs from it by 90 deg.
+                    const matrix = sdk.math.Mat4.fromZRotation(rotation - 0.5 * std.math.pi).translate(position);
+                    self.writeField(buffer, "transform_matrix", .fromConverted(matrix));
+                }
+            }
+            if (player.hurt_cylinders) |*cylinders| {
+                var raw_cylinders: game.HurtCylinders(game_id) = undefined;
+                inline for (@typeInfo(game.HurtCylinders(game_id)).@"struct".fields) |*field| {
+                    const cylinder = &cylinders.get(@field(model.HurtCylinderId, field.name)).cylinder;
+                    @field(raw_cylinders, field.name) = .fromConverted(.{
+                        .center = cylinder.center,
+                        .multiplier = 1.0,
+                        .half_height = cylinder.half_height,
+                        .squared_radius = cylinder.radius * cylinder.radius,
+                        .radius = cylinder.radius,
+                        ._padding = @splat(0),
+                    });
+                }
+                self.writeField(buffer, "hurt_cylinders", raw_cylinders);
+            }
+            if (player.collision_spheres) |*spheres| {
+                var raw_spheres: game.CollisionSpheres = undefined;
+                inline for (@typeInfo(game.CollisionSpheres).@"struct".fields) |*field| {
+                    const sphere = spheres.get(@field(model.CollisionSphereId, field.name));
+                    @field(raw_spheres, field.name) = .fromConverted(.{
+                        .center = sphere.center,
+                        .multiplier = 1.0,
+                        .radius = sphere.radius,
+                        ._padding = @splat(0),
+                    });
+                }
+                self.writeField(buffer, "collision_spheres", raw_spheres);
+            }
+            self.writeHitLines(buffer, player.hit_lines.asConstSlice());
+            switch (game_id) {
+                .t7 => if (player.health) |value| {
+                    const health = game.Health(.t7){ .value = @intCast(value), .encryption_key = 0 };
+                    self.writeField(buffer, "health", .fromConverted(health));
+                },
+                .t8 => if (player.heat) |heat| {
+                    self.writeField(buffer, "in_heat", .fromBool(heat == .activated));
+                    if (heat == .activated) {
+                        self.writeField(buffer, "heat_gauge", .fromConverted(heat.activated.gauge));
+                    }
+                },
+            }
+        }
+
+        // The capturer only reports hit lines that changed since the previous frame, so lines are written every
+        // frame and the unused slots are cleared.
+        fn writeHitLines(self: *const Self, buffer: []u8, lines: []const model.HitLine) void {
+            var raw_lines: game.HitLines(game_id) = undefined;
+            switch (game_id) {
+                .t7 => {
+                    for (&raw_lines, 0..) |*raw_point, index| {
+                        const position = if (index / 2 < lines.len) block: {
+                            const line = &lines[index / 2].line;
+                            break :block if (index % 2 == 0) line.point_1 else line.point_2;
+                        } else sdk.math.Vec3.zero;
+                        raw_point.* = .fromConverted(.{ .position = position, ._padding = 0 });
+                    }
+                    self.writeField(buffer, "phase_flags", .{ .is_active = lines.len > 0 });
+                },
+                .t8 => {
+                    for (&raw_lines, 0..) |*raw_line, index| {
+                        const first = 2 * index;
+                        if (first + 1 >= lines.len) {
+                            raw_line.* = .fromConverted(.{
+                                .points = std.mem.zeroes([3]game.HitLinePoint),
+                                ._padding_1 = @splat(0),
+                                .ignore = .true,
+                                ._padding_2 = @splat(0),
+                            });
+                            continue;
+                        }
+                        raw_line.* = .fromConverted(.{
+                            .points = .{
+                                .{ .position = lines[first].line.point_1, ._padding = 0 },
+                                .{ .position = lines[first].line.point_2, ._padding = 0 },
+                                .{ .position = lines[first + 1].line.point_2, ._padding = 0 },
+                            },
+                            ._padding_1 = @splat(0),
+                            .ignore = .false,
+                            ._padding_2 = @splat(0),
+                        });
+                    }
+                },
+            }
+            self.writeField(buffer, "hit_lines", raw_lines);
+        }
+
+        fn writeField(
+            self: *const Self,
+            buffer: []u8,
+            comptime field_name: []const u8,
+            value: @FieldType(Player, field_name),
+        ) void {
+            const Field = @FieldType(Player, field_name);
+            const offset = @field(self.player_offsets, field_name) orelse return;
+            const pointer: *align(1) Field = @ptrCast(buffer[offset..][0..@sizeOf(Field)]);
+            pointer.* = value;
+        }
+
+        // Offsets that game.Memory reads from the game's instructions are placed after all the other fields. The
+        // instructions containing them are synthesized, so the offsets still go through the same pattern lookup.
+        fn findPlayerOffsets(allocator: std.mem.Allocator) !PlayerOffsets {
+            const decls = @typeInfo(offset_patterns).@"struct".decls;
+            if (decls.len == 0) {
+                var cache: ?sdk.memory.PatternCache = null;
+                return game.Memory(game_id).playerOffsets(&cache);
+            } else {
+                var values: [decls.len]usize = @splat(0);
+                const initial_offsets = try resolvePlayerOffsets(allocator, &values);
+                var end: usize = 0;
+                inline for (@typeInfo(Player).@"struct".fields) |*field| {
+                    if (@field(initial_offsets, field.name)) |offset| {
+                        end = @max(end, offset + @sizeOf(field.type));
+                    }
+                }
+                inline for (decls, 0..) |decl, index| {
+                    const Field = @FieldType(Player, decl.name);
+                    end = std.mem.alignForward(usize, end, @alignOf(Field));
+                    values[index] = end;
+                    end += @sizeOf(Field);
+                }
+                return resolvePlayerOffsets(allocator, &values);
+            }
+        }
+
+        fn resolvePlayerOffsets(allocator: std.mem.Allocator, values: []const usize) !PlayerOffsets {
+            const decls = @typeInfo(offset_patterns).@"struct".decls;
+            var code: [decls.len * 64]u8 = undefined;
+            var code_len: usize = 0;
+            inline for (decls, 0..) |decl, index| {
+                const offset_pattern = @field(offset_patterns, decl.name);
+                const pattern = sdk.memory.Pattern.fromComptime(offset_pattern.pattern);
+                const bytes = pattern.getBytes();
+                const instruction = code[code_len..][0..bytes.len];
+                for (instruction, bytes) |*byte, pattern_byte| {
+                    byte.* = pattern_byte orelse 0;
+                }
+                const value: u32 = @intCast(values[index]);
+                std.mem.writeInt(u32, instruction[offset_pattern.offset_position..][0..4], value, .little);
+                for (instruction, bytes) |byte, pattern_byte| {
+                    if (pattern_byte != null and pattern_byte.? != byte) {
+                        sdk.misc.error_context.new(
+                            "Offset 0x{X} of field \"{s}\" can not be encoded into the instruction pattern.",
+                            .{ value, decl.name },
+                        );
+                        return error.UnencodableOffset;
+                    }
+                }
+                code_len += bytes.len;
+            }
+            var cache: ?sdk.memory.PatternCache = sdk.memory.PatternCache.init(allocator, .{
+                .base_address = @intFromPtr(&code),
+                .size_in_bytes = code_len,
+            });
+            defer if (cache) |*c| c.deinit();
+            return game.Memory(game_id).playerOffsets(&cache);
+        }
+    };
+}
+
+const testing = std.testing;
+
+test "Capturer should capture the same frame that GameMemory wrote" {
+    inline for (.{ build_info.Game.t7, build_info.Game.t8 }) |game_id| {
+        var random = std.Random.DefaultPrng.init(0);
+        var game_memory = try GameMemory(game_id).init(testing.allocator);
+        defer game_memory.deinit();
+        var capturer = game.Capturer(game_id){};
+        for (0..20) |index| {
+            const expected = @import("frames.zig").generateFrame(index, random.random());
+            game_memory.writeFrame(&expected);
+            const actual = capturer.captureFrame(&.{
+                .player_1 = game_memory.memory.player_1.takePartialCopy(),
+                .player_2 = game_memory.memory.player_2.takePartialCopy(),
+                .camera = game_memory.memory.camera.takeCopy(),
+            });
+            try testing.expectEqual(expected.frames_since_round_start, actual.frames_since_round_start);
+            try testing.expectEqual(expected.main_player_id, actual.main_player_id);
+            try testing.expectEqual(expected.left_player_id, actual.left_player_id);
+            for (&expected.players, &actual.players) |*expected_player, *actual_player| {
+                try testing.expectEqual(expected_player.character_id, actual_player.character_id);
+                try testing.expectEqual(expected_player.animation_frame, actual_player.animation_frame);
+                const rotation_difference = expected_player.rotation.? - actual_player.rotation.? + std.math.pi;
+                try testing.expectApproxEqAbs(std.math.pi, @mod(rotation_difference, 2 * std.math.pi), 0.001);
+                const expected_position = expected_player.getPosition().?;
+                const actual_position = actual_player.getPosition().?;
+                try testing.expectApproxEqAbs(expected_position.x(), actual_position.x(), 0.001);
+                try testing.expectApproxEqAbs(expected_position.y(), actual_position.y(), 0.001);
+                try testing.expectApproxEqAbs(expected_position.z(), actual_position.z(), 0.001);
+            }
+            try testing.expectApproxEqAbs(expected.camera.?.yaw, actual.camera.?.yaw, 0.001);
+        }
+    }
+}
@@ -0,0 +1,285 @@
+const std = @import("std");
+const sdk = @import("../sdk/root.zig");
+const core = @import("../dll/core/root.zig");
+const model = @import("../dll/model/root.zig");
+const bench = @import("root.zig");
+
+const number_of_frames = 60 * 60;
+const file_path = "./bench_recording.irony";
+const scratch_file_path = "./bench_recording.scratch";
+const columnar_file_path = "./bench_recording.columnar";
+const corpus_file_path = "./bench_corpus.irony";
+const corpus_size = 8;
+const max_dictionary_size = 64 * 1024;
+const clip_lengths = .{ 60, 600, 3600 };
+// Filled at runtime by training on generated recordings, which configs can reference since it's address is comptime.
+var bench_dictionary = sdk.io.RecordingDictionary{};
+
+pub fn run(runner: *bench.Runner) !void {
+    const frames = bench.generateFrames(runner.allocator, number_of_frames, 0) catch |err| {
+        sdk.misc.error_context.append("Failed to generate recording frames.", .{});
+        return err;
+    };
+    defer runner.allocator.free(frames);
+    defer std.fs.cwd().deleteFile(file_path) catch {};
+    defer std.fs.cwd().deleteFile(scratch_file_path) catch {};
+    defer std.fs.cwd().deleteFile(columnar_file_path) catch {};
+    var sizes: [5]u64 = undefined;
+    inline for (.{ "raw", "predictive", "archival", "gameplay", "inputs" }, 0..) |name, index| {
+        const config = comptime getRecordingConfig(name);
+        sizes[index] = runRecording(runner, frames, name, config) catch |err| {
+            sdk.misc.error_context.append("Failed to benchmark recording config: {s}", .{name});
+            return err;
+        };
+    }
+    std.log.info(
+        "Recording size: raw {} bytes, predictive {} bytes, archival {} bytes ({d:.1}% of predictive).",
+        .{ sizes[0], sizes[1], sizes[2], getPercentage(sizes[2], sizes[1]) },
+    );
+    std.log.info(
+        "Recording profile size: gameplay {} bytes ({d:.1}% of raw), inputs {} bytes ({d:.1}% of raw).",
+        .{ sizes[3], getPercentage(sizes[3], sizes[0]), sizes[4], getPercentage(sizes[4], sizes[0]) },
+    );
+    runDictionary(runner, frames) catch |err| {
+        sdk.misc.error_context.append("Failed to benchmark recording dictionary.", .{});
+        return err;
+    };
+    runChangeMask(runner, frames) catch |err| {
+        sdk.misc.error_context.append("Failed to benchmark change mask.", .{});
+        return err;
+    };
+    runScratch(runner, frames) catch |err| {
+        sdk.misc.error_context.append("Failed to benchmark scratch recordings.", .{});
+        return err;
+    };
+    runColumnar(runner, frames) catch |err| {
+        sdk.misc.error_context.append("Failed to benchmark columnar export.", .{});
+        return err;
+    };
+}
+
+fn getPercentage(part: u64, whole: u64) f64 {
+    return 100 * @as(f64, @floatFromInt(part)) / @as(f64, @floatFromInt(whole));
+}
+
+fn getRecordingConfig(comptime name: []const u8) *const sdk.io.RecordingConfig {
+    if (std.mem.eql(u8, name, "archival")) {
+        return &core.Controller.archival_config;
+    }
+    if (std.meta.stringToEnum(model.RecordingProfile, name)) |profile| {
+        return core.Controller.getRecordingConfig(profile);
+    }
+    var config = core.Controller.serialization_config;
+    config.codec = @field(sdk.io.RecordingCodec, name);
+    const final = config;
+    return &final;
+}
+
+// Recording always gets saved once, even when filtered out, since it's size gets logged.
+fn runRecording(
+    runner: *bench.Runner,
+    frames: []const model.Frame,
+    comptime name: []const u8,
+    comptime config: *const sdk.io.RecordingConfig,
+) !u64 {
+    const encode_name = "io.recording.encode." ++ name;
+    const decode_name = "io.recording.decode." ++ name;
+    const Context = RecordingContext(config);
+    const context = Context{ .allocator = runner.allocator, .frames = frames };
+    Context.encode(&context) catch |err| {
+        sdk.misc.error_context.append("Failed to save the recording that gets measured.", .{});
+        return err;
+    };
+    const stat = std.fs.cwd().statFile(file_path) catch |err| {
+        sdk.misc.error_context.new("Failed to stat file: {s}", .{file_path});
+        return err;
+    };
+    const throughput = bench.Throughput{
+        .items_per_iteration = frames.len,
+        .bytes_per_iteration = stat.size,
+    };
+    try runner.run(encode_name, throughput, &context, Context.encode);
+    try runner.run(decode_name, throughput, &context, Context.decode);
+    return stat.size;
+}
+
+fn RecordingContext(comptime config: *const sdk.io.RecordingConfig) type {
+    return struct {
+        allocator: std.mem.Allocator,
+        frames: []const model.Frame,
+
+        const Self = @This();
+
+        fn encode(self: *const Self) anyerror!void {
+            try sdk.io.saveRecording(model.Frame, self.allocator, self.frames, file_path, config);
+        }
+
+        fn decode(self: *const Self) anyerror!void {
+            const frames = try sdk.io.loadRecording(model.Frame, self.allocator, file_path, config);
+            defer self.allocator.free(frames);
+            std.mem.doNotOptimizeAway(frames.ptr);
+        }
+    };
+}
+
+// Dictionary gets trained on recordings generated with other seeds, so that the measured clips are not part of it.
+fn runDictionary(runner: *bench.Runner, frames: []const model.Frame) !void {
+    var paths: [corpus_size][]const u8 = undefined;
+    var path_buffers: [corpus_size][32]u8 = undefined;
+    var number_of_paths: usize = 0;
+    defer for (paths[0..number_of_paths]) |path| std.fs.cwd().deleteFile(path) catch {};
+    const plain_config = &core.Controller.serialization_config;
+    for (&paths, &path_buffers, 1..) |*path, *buffer, seed| {
+        path.* = std.fmt.bufPrint(buffer, "{s}.{}", .{ corpus_file_path, seed }) catch unreachable;
+        number_of_paths += 1;
+        const corpus_frames = bench.generateFrames(runner.allocator, 600, seed) catch |err| {
+            sdk.misc.error_context.append("Failed to generate corpus frames.", .{});
+            return err;
+        };
+        defer runner.allocator.free(corpus_frames);
+        sdk.io.saveRecording(model.Frame, runner.allocator, corpus_frames, path.*, plain_config) catch |err| {
+            sdk.misc.error_context.append("Failed to save corpus recording: {s}", .{path.*});
+            return err;
+        };
+    }
+    const dictionary = sdk.io.trainRecordingDictionary(
+        model.Frame,
+        runner.allocator,
+        &paths,
+        max_dictionary_size,
+        plain_config,
+    ) catch |err| {
+        sdk.misc.error_context.append("Failed to train dictionary.", .{});
+        return err;
+    };
+    defer runner.allocator.free(dictionary);
+    bench_dictionary = .{ .bytes = dictionary };
+    defer bench_dictionary = .{};
+
+    const dictionary_config = comptime block: {
+        var config = core.Controller.serialization_config;
+        config.dictionaries = &.{&bench_dictionary};
+        const final = config;
+        break :block &final;
+    };
+    inline for (clip_lengths) |len| {
+        const name = std.fmt.comptimePrint("clip_{}", .{len});
+        const clip = frames[0..len];
+        const plain_size = runRecording(runner, clip, name, plain_config) catch |err| {
+            sdk.misc.error_context.append("Failed to benchmark recording config: {s}", .{name});
+            return err;
+        };
+        const dictionary_name = name ++ "_dictionary";
+        const dictionary_size = runRecording(runner, clip, dictionary_name, dictionary_config) catch |err| {
+            sdk.misc.error_context.append("Failed to benchmark recording config: {s}", .{dictionary_name});
+            return err;
+        };
+        std.log.info(
+            "Recording of {} frames: {} bytes without dictionary, {} bytes with dictionary ({d:.1}%).",
+            .{ len, plain_size, dictionary_size, getPercentage(dictionary_size, plain_size) },
+        );
+    }
+}
+
+// Byte mask that saving uses to find which fields of a frame changed since the previous frame.
+fn runChangeMask(runner: *bench.Runner, frames: []const model.Frame) !void {
+    const context = ChangeMaskContext{ .frames = frames };
+    const throughput = bench.Throughput{
+        .items_per_iteration = frames.len - 1,
+        .bytes_per_iteration = (frames.len - 1) * @sizeOf(model.Frame),
+    };
+    try runner.run("io.change_mask.frame", throughput, &context, ChangeMaskContext.compare);
+}
+
+const ChangeMaskContext = struct {
+    frames: []const model.Frame,
+
+    const Self = @This();
+
+    fn compare(self: *const Self) anyerror!void {
+        for (self.frames[1..], self.frames[0..(self.frames.len - 1)]) |*current, *previous| {
+            const mask = sdk.io.ChangeMask(model.Frame).init(current, previous);
+            std.mem.doNotOptimizeAway(&mask);
+        }
+    }
+};
+
+fn runScratch(runner: *bench.Runner, frames: []const model.Frame) !void {
+    if (!runner.isEnabled("io.scratch.save") and !runner.isEnabled("io.scratch.open")) {
+        return;
+    }
+    const context = ScratchContext{ .frames = frames };
+    ScratchContext.save(&context) catch |err| {
+        sdk.misc.error_context.append("Failed to save the scratch recording that gets measured.", .{});
+        return err;
+    };
+    const throughput = bench.Throughput{
+        .items_per_iteration = frames.len,
+        .bytes_per_iteration = frames.len * @sizeOf(model.Frame),
+    };
+    try runner.run("io.scratch.save", throughput, &context, ScratchContext.save);
+    try runner.run("io.scratch.open", throughput, &context, ScratchContext.open);
+}
+
+const ScratchContext = struct {
+    frames: []const model.Frame,
+
+    const Self = @This();
+    const config = &core.Controller.serialization_config;
+
+    fn save(self: *const Self) anyerror!void {
+        try sdk.io.saveScratchRecording(model.Frame, self.frames, scratch_file_path, config);
+    }
+
+    // Touches only the last frame, since opening is what gets measured. Frames get paged in when used.
+    fn open(_: *const Self) anyerror!void {
+        var scratch = try sdk.io.ScratchRecording(model.Frame, config).open(scratch_file_path);
+        defer scratch.close();
+        std.mem.doNotOptimizeAway(scratch.frames[scratch.frames.len - 1].frames_since_round_start);
+    }
+};
+
+fn runColumnar(runner: *bench.Runner, frames: []const model.Frame) !void {
+    if (!runner.isEnabled("io.columnar.save") and !runner.isEnabled("io.columnar.scan")) {
+        return;
+    }
+    const context = ColumnarContext{ .allocator = runner.allocator, .frames = frames };
+    ColumnarContext.save(&context) catch |err| {
+        sdk.misc.error_context.append("Failed to save the columnar file that gets measured.", .{});
+        return err;
+    };
+    const stat = std.fs.cwd().statFile(columnar_file_path) catch |err| {
+        sdk.misc.error_context.new("Failed to stat file: {s}", .{columnar_file_path});
+        return err;
+    };
+    const throughput = bench.Throughput{
+        .items_per_iteration = frames.len,
+        .bytes_per_iteration = stat.size,
+    };
+    try runner.run("io.columnar.save", throughput, &context, ColumnarContext.save);
+    try runner.run("io.columnar.scan", throughput, &context, ColumnarContext.scan);
+}
+
+const ColumnarContext = struct {
+    allocator: std.mem.Allocator,
+    frames: []const model.Frame,
+
+    const Self = @This();
+    const config = &core.Controller.serialization_config;
+
+    fn save(self: *const Self) anyerror!void {
+        try sdk.io.saveColumnar(model.Frame, self.frames, columnar_file_path, config);
+    }
+
+    // Loads the file and decodes every column, which is the worst case for an analysis tool.
+    fn scan(self: *const Self) anyerror!void {
+        var file = try sdk.io.ColumnarFile.load(self.allocator, columnar_file_path);
+        defer file.deinit();
+        const values = try self.allocator.alloc(u64, file.number_of_frames);
+        defer self.allocator.free(values);
+        for (file.columns) |*column| {
+            column.decodeBits(values);
+            std.mem.doNotOptimizeAway(values[values.len - 1]);
+        }
+    }
+};
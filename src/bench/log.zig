@@ -0,0 +1,25 @@
+const std = @import("std");
+const sdk = @import("../sdk/root.zig");
+const bench = @import("root.zig");
+
+const number_of_messages = 1024;
+
+pub fn run(runner: *bench.Runner) !void {
+    const logger = sdk.log.BufferLogger(.{
+        .time_zone = .utc,
+        .nanoTimestamp = struct {
+            fn call() i128 {
+                return 1_700_000_000 * std.time.ns_per_s;
+            }
+        }.call,
+    });
+    try runner.run("log.buffer_logger.log_fn", .{
+        .items_per_iteration = number_of_messages,
+    }, {}, struct {
+        fn call(_: void) anyerror!void {
+            for (0..number_of_messages) |index| {
+                logger.logFn(.info, .bench, "Processed frame {} with {d:.3} ms delay.", .{ index, 1.25 });
+            }
+        }
+    }.call);
+}
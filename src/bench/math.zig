@@ -0,0 +1,81 @@
+const std = @import("std");
+const sdk = @import("../sdk/root.zig");
+const bench = @import("root.zig");
+
+const batch_size = 1024;
+
+pub fn run(runner: *bench.Runner) !void {
+    var random = std.Random.DefaultPrng.init(0);
+    const r = random.random();
+
+    const Shapes = struct {
+        cylinders: [batch_size]sdk.math.Cylinder,
+        lines: [batch_size]sdk.math.LineSegment3,
+    };
+    const shapes = runner.allocator.create(Shapes) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate shapes.", .{});
+        return err;
+    };
+    defer runner.allocator.destroy(shapes);
+    for (&shapes.cylinders, &shapes.lines) |*cylinder, *line| {
+        cylinder.* = .{ .center = randomVec3(r, 100), .radius = 5 + 20 * r.float(f32), .half_height = 30 * r.float(f32) };
+        line.* = .{ .point_1 = randomVec3(r, 100), .point_2 = randomVec3(r, 100) };
+    }
+    try runner.run("math.check_cylinder_line_segment_intersection", .{
+        .items_per_iteration = batch_size,
+    }, shapes, struct {
+        fn call(s: *const Shapes) anyerror!void {
+            var number_of_intersections: usize = 0;
+            for (&s.cylinders, &s.lines) |*cylinder, *line| {
+                if (sdk.math.checkCylinderLineSegmentIntersection(cylinder.*, line.*)) {
+                    number_of_intersections += 1;
+                }
+            }
+            std.mem.doNotOptimizeAway(number_of_intersections);
+        }
+    }.call);
+
+    const Matrices = struct {
+        inputs: [batch_size]sdk.math.Mat4,
+        outputs: [batch_size]sdk.math.Mat4,
+    };
+    const matrices = runner.allocator.create(Matrices) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate matrices.", .{});
+        return err;
+    };
+    defer runner.allocator.destroy(matrices);
+    for (&matrices.inputs) |*matrix| {
+        matrix.* = sdk.math.Mat4.fromXRotation(r.float(f32))
+            .rotateZ(r.float(f32))
+            .scale(.fromArray(.{ 1 + r.float(f32), 1 + r.float(f32), 1 + r.float(f32) }))
+            .translate(randomVec3(r, 100));
+    }
+    try runner.run("math.matrix.inverse", .{
+        .items_per_iteration = batch_size,
+    }, matrices, struct {
+        fn call(m: *Matrices) anyerror!void {
+            for (&m.inputs, &m.outputs) |*input, *output| {
+                output.* = input.inverse() orelse sdk.math.Mat4.identity;
+            }
+            std.mem.doNotOptimizeAway(&m.outputs);
+        }
+    }.call);
+    try runner.run("math.matrix.multiply", .{
+        .items_per_iteration = batch_size,
+    }, matrices, struct {
+        fn call(m: *Matrices) anyerror!void {
+            for (&m.inputs, &m.outputs, 0..) |*input, *output, index| {
+                output.* = input.multiply(m.inputs[(index + 1) % batch_size]);
+            }
+            std.mem.doNotOptimizeAway(&m.outputs);
+        }
+    }.call);
+}
+
+fn randomVec3(random: std.Random, extent: f32) sdk.math.Vec3 {
+    return .fromArray(.{
+        extent * (2 * random.float(f32) - 1),
+        extent * (2 * random.float(f32) - 1),
+        extent * (2 * random.float(f32) - 1),
+    });
+}
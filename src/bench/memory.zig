@@ -0,0 +1,58 @@
+const std = @import("std");
+const sdk = @import("../sdk/root.zig");
+const bench = @import("root.zig");
+
+const haystack_size = 16 * 1024 * 1024;
+const number_of_cached_patterns = 64;
+const pattern = sdk.memory.Pattern.fromComptime("48 8B 05 ?? ?? ?? ?? 48 85 C0 74 ?? 48 8B 40 ?? C3");
+const pattern_bytes = [_]u8{ 0x48, 0x8B, 0x05, 0x11, 0x22, 0x33, 0x44, 0x48, 0x85, 0xC0, 0x74, 0x55, 0x48, 0x8B, 0x40, 0x66, 0xC3 };
+
+pub fn run(runner: *bench.Runner) !void {
+    // The pattern is placed at the very end of random bytes, so every scan goes through the whole range.
+    const haystack = runner.allocator.alloc(u8, haystack_size) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate memory to scan.", .{});
+        return err;
+    };
+    defer runner.allocator.free(haystack);
+    var random = std.Random.DefaultPrng.init(0);
+    random.random().bytes(haystack);
+    @memcpy(haystack[haystack.len - pattern_bytes.len ..], &pattern_bytes);
+    const range = sdk.memory.Range{ .base_address = @intFromPtr(haystack.ptr), .size_in_bytes = haystack.len };
+
+    try runner.run("memory.pattern.find_address", .{
+        .items_per_iteration = haystack_size,
+    }, &range, struct {
+        fn call(r: *const sdk.memory.Range) anyerror!void {
+            const address = try pattern.findAddress(r.*);
+            std.mem.doNotOptimizeAway(address);
+        }
+    }.call);
+
+    if (!runner.isEnabled("memory.pattern_cache.find_address")) {
+        return;
+    }
+    var patterns: [number_of_cached_patterns]sdk.memory.Pattern = undefined;
+    for (&patterns, 0..) |*p, index| {
+        p.* = pattern;
+        p.buffer[3] = @intCast(index); // Wildcards are turned into distinct bytes so each pattern has its own entry.
+    }
+    var cache = sdk.memory.PatternCache.init(runner.allocator, range);
+    defer cache.deinit();
+    for (&patterns) |*p| {
+        _ = cache.findAddress(p) catch {}; // Fills the cache, including the patterns that get cached as not found.
+    }
+    const Context = struct {
+        cache: *sdk.memory.PatternCache,
+        patterns: []const sdk.memory.Pattern,
+    };
+    try runner.run("memory.pattern_cache.find_address", .{
+        .items_per_iteration = number_of_cached_patterns,
+    }, &Context{ .cache = &cache, .patterns = &patterns }, struct {
+        fn call(context: *const Context) anyerror!void {
+            for (context.patterns) |*p| {
+                const address = context.cache.findAddress(p) catch 0;
+                std.mem.doNotOptimizeAway(address);
+            }
+        }
+    }.call);
+}
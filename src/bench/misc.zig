@@ -0,0 +1,144 @@
+const std = @import("std");
+const sdk = @import("../sdk/root.zig");
+const bench = @import("root.zig");
+
+const capacity = 1024;
+const number_of_operations = 64 * 1024;
+const number_of_sequential_jobs = 64;
+const number_of_concurrent_jobs = 256;
+
+pub fn run(runner: *bench.Runner) !void {
+    try runCircularBuffer(runner);
+    try runThreadPool(runner);
+}
+
+fn runCircularBuffer(runner: *bench.Runner) !void {
+    const Buffer = sdk.misc.CircularBuffer(capacity, u64);
+    const buffer = runner.allocator.create(Buffer) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate circular buffer.", .{});
+        return err;
+    };
+    defer runner.allocator.destroy(buffer);
+
+    try runner.run("misc.circular_buffer.add_to_back", .{
+        .items_per_iteration = number_of_operations,
+    }, buffer, struct {
+        fn call(b: *Buffer) anyerror!void {
+            b.clear();
+            for (0..number_of_operations) |index| {
+                const removed = b.addToBack(index);
+                std.mem.doNotOptimizeAway(removed);
+            }
+        }
+    }.call);
+    try runner.run("misc.circular_buffer.add_remove", .{
+        .items_per_iteration = number_of_operations,
+    }, buffer, struct {
+        fn call(b: *Buffer) anyerror!void {
+            b.clear();
+            for (0..number_of_operations) |index| {
+                _ = b.addToFront(index);
+                if (index % 3 == 0) {
+                    const removed = try b.removeLast();
+                    std.mem.doNotOptimizeAway(removed);
+                }
+            }
+        }
+    }.call);
+    try runner.run("misc.circular_buffer.get", .{
+        .items_per_iteration = number_of_operations,
+    }, buffer, struct {
+        fn call(b: *Buffer) anyerror!void {
+            var sum: u64 = 0;
+            for (0..number_of_operations) |index| {
+                sum +%= (try b.get(index % b.len)).*;
+            }
+            std.mem.doNotOptimizeAway(sum);
+        }
+    }.call);
+}
+
+// Compares running small jobs on the thread pool against spawning a thread for each one, which is what Task used to do.
+// Spawn-join measures the time until a result is back when jobs are issued one by one, throughput measures many jobs
+// that are all in flight at once.
+fn runThreadPool(runner: *bench.Runner) !void {
+    var pool: sdk.misc.ThreadPool = undefined;
+    pool.init(runner.allocator, .{}) catch |err| {
+        sdk.misc.error_context.append("Failed to initialize thread pool.", .{});
+        return err;
+    };
+    defer pool.deinit();
+    var context = ThreadPoolContext{ .allocator = runner.allocator, .pool = &pool };
+
+    try runner.run("misc.thread.spawn_join", .{
+        .items_per_iteration = number_of_sequential_jobs,
+    }, &context, struct {
+        fn call(_: *ThreadPoolContext) anyerror!void {
+            for (0..number_of_sequential_jobs) |index| {
+                var result: u64 = 0;
+                const thread = try std.Thread.spawn(.{}, threadJob, .{ index, &result });
+                thread.join();
+                std.mem.doNotOptimizeAway(result);
+            }
+        }
+    }.call);
+    try runner.run("misc.thread_pool.spawn_join", .{
+        .items_per_iteration = number_of_sequential_jobs,
+    }, &context, struct {
+        fn call(c: *ThreadPoolContext) anyerror!void {
+            for (0..number_of_sequential_jobs) |index| {
+                const future = try c.pool.spawn(c.allocator, job, .{index});
+                const result = try future.join();
+                std.mem.doNotOptimizeAway(result);
+            }
+        }
+    }.call);
+    try runner.run("misc.thread.throughput", .{
+        .items_per_iteration = number_of_concurrent_jobs,
+    }, &context, struct {
+        fn call(_: *ThreadPoolContext) anyerror!void {
+            var threads: [number_of_concurrent_jobs]std.Thread = undefined;
+            var results: [number_of_concurrent_jobs]u64 = undefined;
+            var number_of_spawned: usize = 0;
+            defer for (threads[0..number_of_spawned]) |thread| {
+                thread.join();
+            };
+            while (number_of_spawned < number_of_concurrent_jobs) : (number_of_spawned += 1) {
+                const index = number_of_spawned;
+                threads[index] = try std.Thread.spawn(.{}, threadJob, .{ index, &results[index] });
+            }
+        }
+    }.call);
+    try runner.run("misc.thread_pool.throughput", .{
+        .items_per_iteration = number_of_concurrent_jobs,
+    }, &context, struct {
+        fn call(c: *ThreadPoolContext) anyerror!void {
+            var futures: [number_of_concurrent_jobs]sdk.misc.Future(u64) = undefined;
+            var number_of_spawned: usize = 0;
+            defer for (futures[0..number_of_spawned]) |*future| {
+                const result = future.join() catch unreachable;
+                std.mem.doNotOptimizeAway(result);
+            };
+            while (number_of_spawned < number_of_concurrent_jobs) : (number_of_spawned += 1) {
+                futures[number_of_spawned] = try c.pool.spawn(c.allocator, job, .{number_of_spawned});
+            }
+        }
+    }.call);
+}
+
+const ThreadPoolContext = struct {
+    allocator: std.mem.Allocator,
+    pool: *sdk.misc.ThreadPool,
+};
+
+fn job(index: usize) u64 {
+    var hash: u64 = index;
+    for (0..64) |_| {
+        hash = std.hash.int(hash);
+    }
+    return hash;
+}
+
+fn threadJob(index: usize, result: *u64) void {
+    result.* = job(index);
+}
@@ -0,0 +1,82 @@
+const std = @import("std");
+const sdk = @import("../sdk/root.zig");
+const model = @import("../dll/model/root.zig");
+const bench = @import("root.zig");
+
+const number_of_frames = 1024;
+
+pub fn run(runner: *bench.Runner) !void {
+    if (!runner.isEnabled("model.frame.copy") and
+        !runner.isEnabled("model.packed_frame.pack") and
+        !runner.isEnabled("model.packed_frame.unpack"))
+    {
+        return;
+    }
+    const frames = bench.generateFrames(runner.allocator, number_of_frames, 0) catch |err| {
+        sdk.misc.error_context.append("Failed to generate frames.", .{});
+        return err;
+    };
+    defer runner.allocator.free(frames);
+    const frame_copies = runner.allocator.alloc(model.Frame, number_of_frames) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate {} frames.", .{number_of_frames});
+        return err;
+    };
+    defer runner.allocator.free(frame_copies);
+    const packed_frames = runner.allocator.alloc(model.PackedFrame, number_of_frames) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate {} packed frames.", .{number_of_frames});
+        return err;
+    };
+    defer runner.allocator.free(packed_frames);
+    for (frames, packed_frames) |*frame, *packed_frame| {
+        packed_frame.* = .pack(frame);
+    }
+    std.log.info(
+        "Frame size: {} bytes. Packed frame size: {} bytes.",
+        .{ @sizeOf(model.Frame), @sizeOf(model.PackedFrame) },
+    );
+
+    var context = Context{
+        .frames = frames,
+        .frame_copies = frame_copies,
+        .packed_frames = packed_frames,
+    };
+    try runner.run("model.frame.copy", .{
+        .items_per_iteration = number_of_frames,
+        .bytes_per_iteration = number_of_frames * @sizeOf(model.Frame),
+    }, &context, struct {
+        fn call(c: *Context) anyerror!void {
+            for (c.frames, c.frame_copies) |*frame, *copy| {
+                copy.* = frame.*;
+            }
+            std.mem.doNotOptimizeAway(c.frame_copies.ptr);
+        }
+    }.call);
+    try runner.run("model.packed_frame.pack", .{
+        .items_per_iteration = number_of_frames,
+        .bytes_per_iteration = number_of_frames * @sizeOf(model.PackedFrame),
+    }, &context, struct {
+        fn call(c: *Context) anyerror!void {
+            for (c.frames, c.packed_frames) |*frame, *packed_frame| {
+                packed_frame.* = .pack(frame);
+            }
+            std.mem.doNotOptimizeAway(c.packed_frames.ptr);
+        }
+    }.call);
+    try runner.run("model.packed_frame.unpack", .{
+        .items_per_iteration = number_of_frames,
+        .bytes_per_iteration = number_of_frames * @sizeOf(model.PackedFrame),
+    }, &context, struct {
+        fn call(c: *Context) anyerror!void {
+            for (c.packed_frames, c.frame_copies) |*packed_frame, *frame| {
+                frame.* = packed_frame.unpack();
+            }
+            std.mem.doNotOptimizeAway(c.frame_copies.ptr);
+        }
+    }.call);
+}
+
+const Context = struct {
+    frames: []const model.Frame,
+    frame_copies: []model.Frame,
+    packed_frames: []model.PackedFrame,
+};
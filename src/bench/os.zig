@@ -0,0 +1,146 @@
+const std = @import("std");
+const sdk = @import("../sdk/root.zig");
+const core = @import("../dll/core/root.zig");
+const model = @import("../dll/model/root.zig");
+const bench = @import("root.zig");
+
+const number_of_frames = 1024;
+const ring_name = "bench_frame_feed";
+// Enough frames for about 2 seconds at every rate, which keeps the latency benchmarks short while still sampling
+// the reader waking up from sleep many times.
+const latency_duration_ns = 2 * std.time.ns_per_s;
+const latency_timeout_ns = std.time.ns_per_s;
+
+pub fn run(runner: *bench.Runner) !void {
+    try runPublish(runner);
+    try runLatency(runner, "os.shared_ring.latency.60fps", 60);
+    try runLatency(runner, "os.shared_ring.latency.600fps", 600);
+}
+
+fn runPublish(runner: *bench.Runner) !void {
+    if (!runner.isEnabled("os.shared_ring.publish")) {
+        return;
+    }
+    const frames = bench.generateFrames(runner.allocator, number_of_frames, 0) catch |err| {
+        sdk.misc.error_context.append("Failed to generate frames.", .{});
+        return err;
+    };
+    defer runner.allocator.free(frames);
+    var ring = core.FrameFeed.create(ring_name) catch |err| {
+        sdk.misc.error_context.append("Failed to create frame feed.", .{});
+        return err;
+    };
+    defer ring.close();
+    var context = PublishContext{ .ring = &ring, .frames = frames };
+    try runner.run("os.shared_ring.publish", .{
+        .items_per_iteration = number_of_frames,
+        .bytes_per_iteration = number_of_frames * @sizeOf(model.Frame),
+    }, &context, struct {
+        fn call(c: *PublishContext) anyerror!void {
+            for (c.frames) |*frame| {
+                c.ring.publish(frame);
+            }
+        }
+    }.call);
+}
+
+const PublishContext = struct {
+    ring: *const core.FrameFeed,
+    frames: []const model.Frame,
+};
+
+// The latency is measured from right before publishing until the reader has a full copy of the frame. The reader uses
+// a mapping of it's own, same as an external process would.
+const LatencyItem = struct {
+    published_ns: u64,
+    frame: model.Frame,
+};
+const LatencyRing = sdk.os.SharedRing(LatencyItem, .{ .capacity = core.FrameFeed.capacity });
+
+fn runLatency(runner: *bench.Runner, comptime name: []const u8, comptime frames_per_second: u64) !void {
+    if (!runner.isEnabled(name)) {
+        return;
+    }
+    const frame_count = latency_duration_ns * frames_per_second / std.time.ns_per_s;
+    const frames = bench.generateFrames(runner.allocator, number_of_frames, 0) catch |err| {
+        sdk.misc.error_context.append("Failed to generate frames.", .{});
+        return err;
+    };
+    defer runner.allocator.free(frames);
+    const samples = runner.allocator.alloc(u64, frame_count) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate latency samples.", .{});
+        return err;
+    };
+    defer runner.allocator.free(samples);
+
+    var producer = LatencyRing.create(ring_name) catch |err| {
+        sdk.misc.error_context.append("Failed to create shared ring.", .{});
+        return err;
+    };
+    defer producer.close();
+    var consumer = LatencyRing.open(sdk.os.ProcessId.getCurrent(), ring_name) catch |err| {
+        sdk.misc.error_context.append("Failed to open shared ring.", .{});
+        return err;
+    };
+    defer consumer.close();
+    var reader = consumer.reader();
+    const start = std.time.Instant.now() catch |err| {
+        sdk.misc.error_context.new("Failed to read the monotonic clock.", .{});
+        return err;
+    };
+
+    std.log.info("Running benchmark: {s}", .{name});
+    const publisher = std.Thread.spawn(.{}, publish, .{
+        &producer,
+        frames,
+        start,
+        frame_count,
+        std.time.ns_per_s / frames_per_second,
+    }) catch |err| {
+        sdk.misc.error_context.new("Failed to spawn the publisher thread.", .{});
+        return err;
+    };
+    defer publisher.join();
+
+    const item = runner.allocator.create(LatencyItem) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate latency item.", .{});
+        return err;
+    };
+    defer runner.allocator.destroy(item);
+    var number_of_samples: usize = 0;
+    var number_of_skipped: u64 = 0;
+    while (number_of_samples < samples.len) {
+        const result = reader.wait(&consumer, item, latency_timeout_ns) orelse break;
+        const now = std.time.Instant.now() catch unreachable;
+        samples[number_of_samples] = now.since(start) -| item.published_ns;
+        number_of_samples += 1;
+        number_of_skipped += result.number_of_skipped;
+    }
+    std.log.info("{s}: {} frames received, {} frames skipped", .{ name, number_of_samples, number_of_skipped });
+    try runner.addSamples(name, .{
+        .items_per_iteration = 1,
+        .bytes_per_iteration = @sizeOf(model.Frame),
+    }, samples[0..number_of_samples]);
+}
+
+fn publish(
+    ring: *const LatencyRing,
+    frames: []const model.Frame,
+    start: std.time.Instant,
+    count: usize,
+    period: u64,
+) void {
+    const item = std.heap.page_allocator.create(LatencyItem) catch @panic("Failed to allocate latency item.");
+    defer std.heap.page_allocator.destroy(item);
+    for (0..count) |index| {
+        const deadline = index * period;
+        const now = std.time.Instant.now() catch unreachable;
+        const elapsed = now.since(start);
+        if (elapsed < deadline) {
+            std.Thread.sleep(deadline - elapsed);
+        }
+        item.frame = frames[index % frames.len];
+        item.published_ns = (std.time.Instant.now() catch unreachable).since(start);
+        ring.publish(item);
+    }
+}
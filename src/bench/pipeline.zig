@@ -0,0 +1,95 @@
+const std = @import("std");
+const build_info = @import("build_info");
+const sdk = @import("../sdk/root.zig");
+const core = @import("../dll/core/root.zig");
+const model = @import("../dll/model/root.zig");
+const ui = @import("../dll/ui/root.zig");
+const bench = @import("root.zig");
+
+const number_of_frames = 1024;
+const snapshots_file_path = "./bench_snapshots.snapshots";
+
+pub fn run(runner: *bench.Runner) !void {
+    if (!runner.isEnabled("pipeline.core_tick") and
+        !runner.isEnabled("pipeline.core_tick_and_view") and
+        !runner.isEnabled("pipeline.core_tick_raw_snapshots"))
+    {
+        return;
+    }
+    const frames = bench.generateFrames(runner.allocator, number_of_frames, 0) catch |err| {
+        sdk.misc.error_context.append("Failed to generate frames.", .{});
+        return err;
+    };
+    defer runner.allocator.free(frames);
+    var game_memory = bench.GameMemory(build_info.game).init(runner.allocator) catch |err| {
+        sdk.misc.error_context.append("Failed to initialize game memory stand-in.", .{});
+        return err;
+    };
+    defer game_memory.deinit();
+    var context = Context{
+        .core = .init(runner.allocator, runner.allocator),
+        .game_memory = &game_memory,
+        .frames = frames,
+        .view = .init(runner.allocator),
+    };
+    defer context.core.deinit();
+    defer context.view.deinit();
+    try runner.run("pipeline.core_tick", .{ .items_per_iteration = number_of_frames }, &context, tick);
+    try runner.run("pipeline.core_tick_and_view", .{ .items_per_iteration = number_of_frames }, &context, tickAndView);
+
+    if (!runner.isEnabled("pipeline.core_tick_raw_snapshots")) {
+        return;
+    }
+    defer std.fs.cwd().deleteFile(snapshots_file_path) catch {};
+    context.core.snapshot_recorder = core.SnapshotRecorder.init(runner.allocator, snapshots_file_path) catch |err| {
+        sdk.misc.error_context.append("Failed to initialize snapshot recorder.", .{});
+        return err;
+    };
+    const recorder = &context.core.snapshot_recorder.?;
+    defer {
+        recorder.deinit();
+        context.core.snapshot_recorder = null;
+    }
+    try runner.run("pipeline.core_tick_raw_snapshots", .{ .items_per_iteration = number_of_frames }, &context, tick);
+    std.log.info("pipeline.core_tick_raw_snapshots: {d:.1} bytes per snapshot of {} bytes", .{
+        @as(f64, @floatFromInt(recorder.number_of_delta_bytes)) / @as(f64, @floatFromInt(recorder.number_of_snapshots)),
+        @sizeOf(core.Snapshot),
+    });
+}
+
+// Mirrors what the DLL does every game tick, minus drawing. Writing the frame into the stand-in memory is included in
+// the measurement, but it is only a few memory copies compared to the rest of the pipeline.
+const Context = struct {
+    core: core.Core,
+    game_memory: *bench.GameMemory(build_info.game),
+    frames: []const model.Frame,
+    settings: model.Settings = .{},
+    view: ui.View,
+    processed_frames: usize = 0,
+};
+
+fn tick(context: *Context) anyerror!void {
+    for (context.frames) |*frame| {
+        context.game_memory.writeFrame(frame);
+        context.core.tick(&context.game_memory.memory, context, struct {
+            fn call(c: *Context, processed_frame: *const model.Frame) void {
+                c.processed_frames += 1;
+                std.mem.doNotOptimizeAway(processed_frame);
+            }
+        }.call);
+    }
+}
+
+// Only the view part of Ui.processFrame is measured. The rest of the Ui references draw functions and the DLL's
+// shut down procedure, which can not be linked into a native executable.
+fn tickAndView(context: *Context) anyerror!void {
+    for (context.frames) |*frame| {
+        context.game_memory.writeFrame(frame);
+        context.core.tick(&context.game_memory.memory, context, struct {
+            fn call(c: *Context, processed_frame: *const model.Frame) void {
+                c.processed_frames += 1;
+                c.view.processFrame(&c.settings, processed_frame);
+            }
+        }.call);
+    }
+}
@@ -0,0 +1,139 @@
+const std = @import("std");
+const builtin = @import("builtin");
+const sdk = @import("../sdk/root.zig");
+const bench = @import("root.zig");
+
+pub const Report = struct {
+    build_mode: []const u8 = @tagName(builtin.mode),
+    results: []const bench.Result,
+    comparisons: []const Comparison = &.{},
+};
+
+pub const Comparison = struct {
+    name: []const u8,
+    baseline_median_ns: u64,
+    median_ns: u64,
+    ratio: f64,
+    is_regression: bool,
+};
+
+pub fn writeReport(writer: *std.io.Writer, report: *const Report) !void {
+    std.json.Stringify.value(report.*, .{ .whitespace = .indent_2 }, writer) catch |err| {
+        sdk.misc.error_context.new("Failed to serialize benchmark report.", .{});
+        return err;
+    };
+    writer.writeByte('\n') catch |err| {
+        sdk.misc.error_context.new("Failed to write new line after benchmark report.", .{});
+        return err;
+    };
+}
+
+pub fn saveReport(report: *const Report, file_path: []const u8) !void {
+    const file = std.fs.cwd().createFile(file_path, .{}) catch |err| {
+        sdk.misc.error_context.new("Failed to create or open file: {s}", .{file_path});
+        return err;
+    };
+    defer file.close();
+    var buffer: [4096]u8 = undefined;
+    var file_writer = file.writer(&buffer);
+    writeReport(&file_writer.interface, report) catch |err| {
+        sdk.misc.error_context.append("Failed to write benchmark report to: {s}", .{file_path});
+        return err;
+    };
+    file_writer.end() catch |err| {
+        sdk.misc.error_context.new("Failed to end file writing.", .{});
+        return err;
+    };
+}
+
+pub fn loadReport(allocator: std.mem.Allocator, file_path: []const u8) !std.json.Parsed(Report) {
+    const file_data = std.fs.cwd().readFileAlloc(allocator, file_path, 16 * 1024 * 1024) catch |err| {
+        sdk.misc.error_context.new("Failed to read file: {s}", .{file_path});
+        return err;
+    };
+    defer allocator.free(file_data);
+    return std.json.parseFromSlice(Report, allocator, file_data, .{
+        .ignore_unknown_fields = true,
+        .allocate = .alloc_always,
+    }) catch |err| {
+        sdk.misc.error_context.new("Failed to parse benchmark report: {s}", .{file_path});
+        return err;
+    };
+}
+
+// Compares medians because they are less sensitive to outliers caused by the rest of the system.
+// Results without a matching baseline entry are left out.
+pub fn compareWithBaseline(
+    allocator: std.mem.Allocator,
+    results: []const bench.Result,
+    baseline: []const bench.Result,
+    threshold: f64,
+) ![]Comparison {
+    var comparisons: std.ArrayList(Comparison) = .empty;
+    errdefer comparisons.deinit(allocator);
+    for (results) |*result| {
+        const baseline_result = for (baseline) |*b| {
+            if (std.mem.eql(u8, b.name, result.name)) {
+                break b;
+            }
+        } else continue;
+        const baseline_median: f64 = @floatFromInt(@max(baseline_result.median_ns, 1));
+        const ratio = @as(f64, @floatFromInt(result.median_ns)) / baseline_median;
+        comparisons.append(allocator, .{
+            .name = result.name,
+            .baseline_median_ns = baseline_result.median_ns,
+            .median_ns = result.median_ns,
+            .ratio = ratio,
+            .is_regression = ratio > 1.0 + threshold,
+        }) catch |err| {
+            sdk.misc.error_context.new("Failed to append benchmark comparison.", .{});
+            return err;
+        };
+    }
+    return comparisons.toOwnedSlice(allocator) catch |err| {
+        sdk.misc.error_context.new("Failed to convert benchmark comparisons to owned slice.", .{});
+        return err;
+    };
+}
+
+const testing = std.testing;
+
+fn testResult(name: []const u8, median_ns: u64) bench.Result {
+    return .{
+        .name = name,
+        .warmup_iterations = 1,
+        .iterations = 1,
+        .min_ns = median_ns,
+        .max_ns = median_ns,
+        .mean_ns = @floatFromInt(median_ns),
+        .median_ns = median_ns,
+        .std_dev_ns = 0,
+    };
+}
+
+test "compareWithBaseline should detect regressions above the threshold" {
+    const results = [_]bench.Result{ testResult("a", 115), testResult("b", 105), testResult("c", 100) };
+    const baseline = [_]bench.Result{ testResult("b", 100), testResult("a", 100) };
+    const comparisons = try compareWithBaseline(testing.allocator, &results, &baseline, 0.1);
+    defer testing.allocator.free(comparisons);
+    try testing.expectEqual(2, comparisons.len);
+    try testing.expectEqualStrings("a", comparisons[0].name);
+    try testing.expectApproxEqAbs(1.15, comparisons[0].ratio, 0.0001);
+    try testing.expectEqual(true, comparisons[0].is_regression);
+    try testing.expectEqualStrings("b", comparisons[1].name);
+    try testing.expectEqual(false, comparisons[1].is_regression);
+}
+
+test "loadReport should load the same report that saveReport saved" {
+    const results = [_]bench.Result{ testResult("a", 123), testResult("b", 456) };
+    try saveReport(&.{ .results = &results }, "./test_assets/bench.json");
+    defer std.fs.cwd().deleteFile("./test_assets/bench.json") catch @panic("Failed to cleanup test file.");
+    const parsed = try loadReport(testing.allocator, "./test_assets/bench.json");
+    defer parsed.deinit();
+    try testing.expectEqualStrings(@tagName(builtin.mode), parsed.value.build_mode);
+    try testing.expectEqual(2, parsed.value.results.len);
+    try testing.expectEqualStrings("a", parsed.value.results[0].name);
+    try testing.expectEqual(123, parsed.value.results[0].median_ns);
+    try testing.expectEqualStrings("b", parsed.value.results[1].name);
+    try testing.expectEqual(456, parsed.value.results[1].median_ns);
+}
@@ -0,0 +1,24 @@
+pub const generateFrames = @import("frames.zig").generateFrames;
+pub const generateFrame = @import("frames.zig").generateFrame;
+pub const GameMemory = @import("game_memory.zig").GameMemory;
+pub const Report = @import("report.zig").Report;
+pub const Comparison = @import("report.zig").Comparison;
+pub const writeReport = @import("report.zig").writeReport;
+pub const saveReport = @import("report.zig").saveReport;
+pub const loadReport = @import("report.zig").loadReport;
+pub const compareWithBaseline = @import("report.zig").compareWithBaseline;
+pub const RunnerConfig = @import("runner.zig").RunnerConfig;
+pub const Throughput = @import("runner.zig").Throughput;
+pub const Result = @import("runner.zig").Result;
+pub const Runner = @import("runner.zig").Runner;
+pub const suites = .{
+    @import("core.zig"),
+    @import("io.zig"),
+    @import("log.zig"),
+    @import("math.zig"),
+    @import("memory.zig"),
+    @import("misc.zig"),
+    @import("model.zig"),
+    @import("os.zig"),
+    @import("pipeline.zig"),
+};
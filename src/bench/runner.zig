@@ -0,0 +1,214 @@
+const std = @import("std");
+const sdk = @import("../sdk/root.zig");
+
+pub const RunnerConfig = struct {
+    warmup_iterations: usize = 3,
+    iterations: usize = 20,
+    filter: ?[]const u8 = null,
+};
+
+pub const Throughput = struct {
+    items_per_iteration: u64,
+    bytes_per_iteration: ?u64 = null,
+};
+
+pub const Result = struct {
+    name: []const u8,
+    warmup_iterations: usize,
+    iterations: usize,
+    min_ns: u64,
+    max_ns: u64,
+    mean_ns: f64,
+    median_ns: u64,
+    std_dev_ns: f64,
+    items_per_second: ?f64 = null,
+    bytes_per_item: ?f64 = null,
+};
+
+pub const Runner = struct {
+    allocator: std.mem.Allocator,
+    config: RunnerConfig,
+    results: std.ArrayList(Result),
+
+    const Self = @This();
+
+    pub fn init(allocator: std.mem.Allocator, config: RunnerConfig) Self {
+        return .{
+            .allocator = allocator,
+            .config = config,
+            .results = .empty,
+        };
+    }
+
+    pub fn deinit(self: *Self) void {
+        for (self.results.items) |*result| {
+            self.allocator.free(result.name);
+        }
+        self.results.deinit(self.allocator);
+    }
+
+    pub fn isEnabled(self: *const Self, name: []const u8) bool {
+        const filter = self.config.filter orelse return true;
+        return std.mem.indexOf(u8, name, filter) != null;
+    }
+
+    pub fn run(
+        self: *Self,
+        name: []const u8,
+        throughput: ?Throughput,
+        context: anytype,
+        comptime function: fn (@TypeOf(context)) anyerror!void,
+    ) !void {
+        if (!self.isEnabled(name)) {
+            return;
+        }
+        std.log.info("Running benchmark: {s}", .{name});
+        for (0..self.config.warmup_iterations) |index| {
+            function(context) catch |err| {
+                sdk.misc.error_context.append("Failed to execute warmup iteration {} of: {s}", .{ index, name });
+                return err;
+            };
+        }
+
+        const samples = self.allocator.alloc(u64, @max(self.config.iterations, 1)) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate benchmark samples.", .{});
+            return err;
+        };
+        defer self.allocator.free(samples);
+        for (samples, 0..) |*sample, index| {
+            var timer = std.time.Timer.start() catch |err| {
+                sdk.misc.error_context.new("Failed to start the timer.", .{});
+                return err;
+            };
+            function(context) catch |err| {
+                sdk.misc.error_context.append("Failed to execute iteration {} of: {s}", .{ index, name });
+                return err;
+            };
+            sample.* = timer.read();
+        }
+        try self.addResult(name, throughput, self.config.warmup_iterations, samples);
+    }
+
+    // For benchmarks that can't be expressed as a function call, like latency between threads. Every sample counts as
+    // one iteration. Sorts the samples in place.
+    pub fn addSamples(self: *Self, name: []const u8, throughput: ?Throughput, samples: []u64) !void {
+        if (samples.len == 0) {
+            sdk.misc.error_context.new("Benchmark {s} produced no samples.", .{name});
+            return error.NoSamples;
+        }
+        try self.addResult(name, throughput, 0, samples);
+    }
+
+    fn addResult(
+        self: *Self,
+        name: []const u8,
+        throughput: ?Throughput,
+        warmup_iterations: usize,
+        samples: []u64,
+    ) !void {
+        var result = calculateResult(samples, throughput);
+        result.name = self.allocator.dupe(u8, name) catch |err| {
+            sdk.misc.error_context.new("Failed to copy benchmark name.", .{});
+            return err;
+        };
+        result.warmup_iterations = warmup_iterations;
+        self.results.append(self.allocator, result) catch |err| {
+            self.allocator.free(result.name);
+            sdk.misc.error_context.new("Failed to append benchmark result.", .{});
+            return err;
+        };
+        std.log.info("{s}: median {} ns, mean {d:.1} ns", .{ name, result.median_ns, result.mean_ns });
+    }
+};
+
+// Sorts the samples in place.
+fn calculateResult(samples: []u64, throughput: ?Throughput) Result {
+    std.mem.sort(u64, samples, {}, std.sort.asc(u64));
+    var sum: f64 = 0;
+    for (samples) |sample| {
+        sum += @floatFromInt(sample);
+    }
+    const len: f64 = @floatFromInt(samples.len);
+    const mean = sum / len;
+    var squared_sum: f64 = 0;
+    for (samples) |sample| {
+        const difference = @as(f64, @floatFromInt(sample)) - mean;
+        squared_sum += difference * difference;
+    }
+    const median = if (samples.len % 2 == 1) block: {
+        break :block samples[samples.len / 2];
+    } else block: {
+        break :block (samples[samples.len / 2 - 1] + samples[samples.len / 2]) / 2;
+    };
+    var result = Result{
+        .name = "",
+        .warmup_iterations = 0,
+        .iterations = samples.len,
+        .min_ns = samples[0],
+        .max_ns = samples[samples.len - 1],
+        .mean_ns = mean,
+        .median_ns = median,
+        .std_dev_ns = @sqrt(squared_sum / len),
+    };
+    if (throughput) |*t| {
+        const items: f64 = @floatFromInt(t.items_per_iteration);
+        const median_s = @as(f64, @floatFromInt(@max(median, 1))) / std.time.ns_per_s;
+        result.items_per_second = items / median_s;
+        if (t.bytes_per_iteration) |bytes| {
+            result.bytes_per_item = @as(f64, @floatFromInt(bytes)) / @max(items, 1);
+        }
+    }
+    return result;
+}
+
+const testing = std.testing;
+
+test "calculateResult should calculate correct statistics" {
+    var samples = [_]u64{ 40, 10, 30, 20 };
+    const result = calculateResult(&samples, null);
+    try testing.expectEqual(4, result.iterations);
+    try testing.expectEqual(10, result.min_ns);
+    try testing.expectEqual(40, result.max_ns);
+    try testing.expectEqual(25, result.median_ns);
+    try testing.expectApproxEqAbs(25.0, result.mean_ns, 0.0001);
+    try testing.expectApproxEqAbs(@sqrt(125.0), result.std_dev_ns, 0.0001);
+    try testing.expectEqual(null, result.items_per_second);
+    try testing.expectEqual(null, result.bytes_per_item);
+}
+
+test "calculateResult should calculate correct throughput" {
+    var samples = [_]u64{ 2 * std.time.ns_per_s, 1 * std.time.ns_per_s, 3 * std.time.ns_per_s };
+    const result = calculateResult(&samples, .{ .items_per_iteration = 100, .bytes_per_iteration = 400 });
+    try testing.expectApproxEqAbs(50.0, result.items_per_second.?, 0.0001);
+    try testing.expectApproxEqAbs(4.0, result.bytes_per_item.?, 0.0001);
+}
+
+test "Runner.run should execute warmup and measured iterations and skip filtered benchmarks" {
+    var runner = Runner.init(testing.allocator, .{ .warmup_iterations = 2, .iterations = 3, .filter = "math" });
+    defer runner.deinit();
+    var counter: usize = 0;
+    const increment = struct {
+        fn call(c: *usize) anyerror!void {
+            c.* += 1;
+        }
+    }.call;
+    try runner.run("math.add", null, &counter, increment);
+    try runner.run("misc.skipped", null, &counter, increment);
+    try testing.expectEqual(5, counter);
+    try testing.expectEqual(1, runner.results.items.len);
+    try testing.expectEqualStrings("math.add", runner.results.items[0].name);
+    try testing.expectEqual(2, runner.results.items[0].warmup_iterations);
+    try testing.expectEqual(3, runner.results.items[0].iterations);
+}
+
+test "Runner.addSamples should add result calculated from the samples" {
+    var runner = Runner.init(testing.allocator, .{});
+    defer runner.deinit();
+    var samples = [_]u64{ 30, 10, 20 };
+    try runner.addSamples("os.latency", null, &samples);
+    try testing.expectEqual(1, runner.results.items.len);
+    try testing.expectEqualStrings("os.latency", runner.results.items[0].name);
+    try testing.expectEqual(0, runner.results.items[0].warmup_iterations);
+    try testing.expectEqual(20, runner.results.items[0].median_ns);
+    try testing.expectError(error.NoSamples, runner.addSamples("os.empty", null, &.{}));
+}
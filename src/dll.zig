@@ -1,4 +1,5 @@
 const std = @import("std");
+const builtin = @import("builtin");
 const w32 = @import("win32").everything;
 const build_info = @import("build_info");
 const sdk = @import("sdk/root.zig");
@@ -21,6 +22,9 @@ const dx = switch (build_info.rendering_api) {
     .dx12 => sdk.dx12,
 };
 
+pub const MemoryTag = enum { recording, io, imgui, pattern_cache, tasks, other };
+pub const TaggingAllocator = sdk.misc.TaggingAllocator(MemoryTag);
+
 const MainAllocator = std.heap.GeneralPurposeAllocator(.{});
 const MemorySearchTask = sdk.misc.Task(dll.game.Memory(build_info.game));
 const Event = union(enum) {
@@ -125,6 +129,9 @@ pub fn DllMain(
 }
 
 pub fn selfShutDown() void {
+    if (builtin.os.tag != .windows) {
+        return; // The UI also gets drawn by the host native UI perf tests, where there is no DLL to unload.
+    }
     const thread = std.Thread.spawn(.{}, struct {
         fn call() void {
             w32.FreeLibraryAndExitThread(dll_module.handle, 0);
@@ -171,15 +178,21 @@ pub fn main() void {
 
     std.log.debug("Initializing main allocator...", .{});
     var main_allocator = MainAllocator.init;
-    const allocator = main_allocator.allocator();
+    var tagging_allocator = TaggingAllocator.init(main_allocator.allocator());
     std.log.info("Main allocator initialized.", .{});
     defer {
+        tagging_allocator.logStats();
         std.log.debug("De-initializing main allocator...", .{});
         switch (main_allocator.deinit()) {
             .ok => std.log.info("Main allocator de-initialized.", .{}),
             .leak => std.log.err("Main allocator detected memory leaks.", .{}),
         }
     }
+    defer {
+        std.log.debug("De-initializing default thread pool...", .{});
+        sdk.misc.ThreadPool.deinitDefault();
+        std.log.info("Default thread pool de-initialized.", .{});
+    }
 
     std.log.debug("Initializing hooking...", .{});
     sdk.memory.hooking.init() catch |err| {
@@ -220,17 +233,18 @@ pub fn main() void {
     }
 
     std.log.debug("Spawning memory search task...", .{});
+    const pattern_cache_allocator = tagging_allocator.allocator(.pattern_cache);
     var memory_search_task = if (MemorySearchTask.spawn(
-        allocator,
+        tagging_allocator.allocator(.tasks),
         performMemorySearch,
-        .{ allocator, &base_dir },
+        .{ pattern_cache_allocator, &base_dir },
     )) |task| block: {
         std.log.info("Memory search task spawned.", .{});
         break :block task;
     } else |err| block: {
         sdk.misc.error_context.append("Failed to spawn memory search task. Searching in main thread...", .{});
         sdk.misc.error_context.logWarning(err);
-        const result = performMemorySearch(allocator, &base_dir);
+        const result = performMemorySearch(pattern_cache_allocator, &base_dir);
         break :block MemorySearchTask.createCompleted(result);
     };
     defer {
@@ -263,7 +277,7 @@ pub fn main() void {
             .present => |*host_context| switch (state) {
                 .starting_up => {
                     std.log.info("Initializing event buss...", .{});
-                    event_buss = .init(allocator, &base_dir, host_context);
+                    event_buss = .init(&tagging_allocator, &base_dir, host_context);
                     std.log.info("Event buss initialized.", .{});
 
                     std.log.debug("Initializing window procedure...", .{});
@@ -6,11 +6,20 @@ const model = @import("../model/root.zig");
 
 pub const Controller = struct {
     allocator: std.mem.Allocator,
+    // Used for the temporary memory of saving, so it can be told apart from the memory of the recording itself.
+    io_allocator: std.mem.Allocator,
     recording: Recording,
     mode: Mode,
     playback_speed: f32,
     contains_unsaved_changes: bool,
     did_last_save_or_load_succeed: bool,
+    comparison: ?Comparison,
+    // Decides which frame fields get stored when saving the recording.
+    recording_profile: model.RecordingProfile,
+    // Captures the last few seconds of live frames in every mode, as long as it's turned on.
+    instant_replay: ?core.InstantReplay,
+    // Saves the kept instant replay next to whatever mode is active, since it doesn't touch the recording.
+    instant_replay_task: ?SaveTask,
 
     const Self = @This();
     pub const Recording = std.ArrayList(model.Frame);
@@ -54,13 +63,25 @@ pub const Controller = struct {
     pub const LoadState = struct {
         task: LoadTask,
         frame_index: ?usize,
+        is_comparison: bool = false,
     };
     pub const LoadTask = sdk.misc.Task(?[]model.Frame);
     pub const SaveState = struct {
         task: SaveTask,
         frame_index: ?usize,
+        is_range: bool = false,
     };
     pub const SaveTask = sdk.misc.Task(?void);
+    pub const RangeEdit = enum {
+        keep,
+        delete,
+    };
+    // Second recording that follows the current frame of the recording through the alignment of the two recordings.
+    pub const Comparison = struct {
+        recording: []model.Frame,
+        config: core.AlignmentConfig,
+        alignment: core.RecordingAlignment,
+    };
 
     pub const frame_time = 1.0 / 60.0;
     pub const min_scrub_speed = 1.0;
@@ -84,22 +105,97 @@ pub const Controller = struct {
             sdk.math.Vec3,
             model.HitLine,
         },
+        .MetadataExtractor = RecordingMetadataExtractor,
+    };
+    // Trades exact positions and rotations for considerably smaller files. Positions are kept to 0.1 mm and rotations
+    // to 0.01 degrees, which is far below anything that can be seen or measured. Used for archiving recordings.
+    pub const archival_config = block: {
+        var config = serialization_config;
+        config.codec = .predictive;
+        config.quantized_paths = &.{
+            .{ .pattern = "players.?.rotation", .precision = 0.01 * std.math.rad_per_deg },
+            .{ .pattern = "players.?.hurt_cylinders", .precision = 0.01 },
+            .{ .pattern = "players.?.collision_spheres", .precision = 0.01 },
+            .{ .pattern = "players.?.hit_lines", .precision = 0.01 },
+        };
+        break :block config;
+    };
+    // Keeps everything needed to examine the gameplay, but leaves out the geometry that only the views draw.
+    pub const gameplay_config = block: {
+        var config = serialization_config;
+        config.profile = "gameplay";
+        config.excluded_paths = &.{
+            "camera",
+            "players.?.hurt_cylinders",
+            "players.?.hit_lines",
+        };
+        break :block config;
+    };
+    // Keeps the inputs, positions, health and move data, including everything the move detectors produce, since the
+    // move database and input search are built from them. Leaves out the camera, the geometry that only the views draw
+    // and the rage and heat state. Used for recording large numbers of matches.
+    pub const inputs_config = block: {
+        var config = serialization_config;
+        config.profile = "inputs";
+        config.excluded_paths = &.{
+            "camera",
+            "players.?.rage",
+            "players.?.heat",
+            "players.?.hurt_cylinders",
+            "players.?.hit_lines",
+        };
+        break :block config;
+    };
+    // Recordings saved with any profile load with serialization_config. Fields that were left out get default values.
+    pub fn getRecordingConfig(comptime profile: model.RecordingProfile) *const sdk.io.RecordingConfig {
+        return switch (profile) {
+            .full => &serialization_config,
+            .gameplay => &gameplay_config,
+            .inputs => &inputs_config,
+        };
+    }
+    // Marks the frames where rounds start and labels the recording with IDs of the characters that appear in it.
+    pub const RecordingMetadataExtractor = struct {
+        pub fn isMarker(previous_maybe: ?*const model.Frame, current: *const model.Frame) bool {
+            const current_frames = current.frames_since_round_start orelse return false;
+            const previous = previous_maybe orelse return true;
+            const previous_frames = previous.frames_since_round_start orelse return true;
+            return current_frames < previous_frames;
+        }
+
+        pub fn getLabels(frame: *const model.Frame) [2]?u32 {
+            return .{ frame.players[0].character_id, frame.players[1].character_id };
+        }
     };
 
     pub fn init(allocator: std.mem.Allocator) Self {
         return .{
             .allocator = allocator,
+            .io_allocator = allocator,
             .recording = .empty,
             .mode = .{ .live = .{ .frame = .{} } },
             .playback_speed = 1.0,
             .contains_unsaved_changes = false,
             .did_last_save_or_load_succeed = false,
+            .comparison = null,
+            .recording_profile = .full,
+            .instant_replay = null,
+            .instant_replay_task = null,
         };
     }
 
     pub fn deinit(self: *Self) void {
         self.cleanUpModeState();
+        self.clearComparison();
         self.recording.deinit(self.allocator);
+        if (self.instant_replay_task) |*task| {
+            _ = task.join();
+            self.instant_replay_task = null;
+        }
+        if (self.instant_replay) |*replay| {
+            replay.deinit();
+            self.instant_replay = null;
+        }
     }
 
     pub fn processFrame(
@@ -108,6 +204,9 @@ pub const Controller = struct {
         context: anytype,
         onFrameChange: ?*const fn (context: @TypeOf(context), frame: *const model.Frame) void,
     ) void {
+        if (self.instant_replay) |*replay| {
+            replay.capture(frame);
+        }
         switch (self.mode) {
             .live => |*state| {
                 state.frame = frame.*;
@@ -175,7 +274,7 @@ pub const Controller = struct {
                 self.applyFrameProgress(&state.frame_progress, &state.frame_index, context, onFrameChange);
             },
             .load => |*state| if (state.task.peek()) |task_result| {
-                if (task_result.* != null) {
+                if (task_result.* != null and !state.is_comparison) {
                     self.cleanUpModeState();
                     self.mode = .{ .pause = .{
                         .frame_index = self.recording.items.len -| 1,
@@ -206,6 +305,9 @@ pub const Controller = struct {
             },
             else => {},
         }
+        if (self.instant_replay_task) |*task| if (task.peek() != null) {
+            self.instant_replay_task = null;
+        };
     }
 
     fn processUnprocessedFrames(
@@ -405,9 +507,134 @@ pub const Controller = struct {
         self.recording.clearAndFree(self.allocator);
         self.contains_unsaved_changes = false;
         self.mode = .{ .live = .{ .frame = .{} } };
+        self.realignComparison();
+    }
+
+    // Saves the frames that the instant replay captured into a new file, named after the current time, and starts the
+    // capture over, so that keeping the replay again never saves the same frames twice.
+    pub fn keepInstantReplay(self: *Self) void {
+        const replay = if (self.instant_replay) |*r| r else return;
+        if (replay.getLen() == 0 or self.isSavingInstantReplay()) {
+            return;
+        }
+        var file_path_buffer: [sdk.os.max_file_path_length]u8 = undefined;
+        const file_path = replay.getNewFilePath(&file_path_buffer) catch |err| {
+            sdk.misc.error_context.append("Failed to keep instant replay.", .{});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+        std.log.info("Keeping instant replay... {s}", .{file_path});
+        const frames = self.io_allocator.alloc(model.Frame, replay.getLen()) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate {} instant replay frames.", .{replay.getLen()});
+            sdk.misc.error_context.append("Failed to keep instant replay: {s}", .{file_path});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+        replay.unpackInto(frames);
+        std.log.debug("Spawning save instant replay task...", .{});
+        const task = SaveTask.spawn(self.allocator, struct {
+            fn call(
+                allocator: std.mem.Allocator,
+                owned_frames: []model.Frame,
+                path_buffer: [sdk.os.max_file_path_length]u8,
+                path_len: usize,
+                profile: model.RecordingProfile,
+            ) ?void {
+                std.log.debug("Save instant replay task spawned.", .{});
+                defer allocator.free(owned_frames);
+                const path = path_buffer[0..path_len];
+                const result = switch (profile) {
+                    inline else => |p| block: {
+                        const config = getRecordingConfig(p);
+                        break :block sdk.io.saveRecording(model.Frame, allocator, owned_frames, path, config);
+                    },
+                };
+                if (result) {
+                    std.log.info("Instant replay kept.", .{});
+                    sdk.ui.toasts.send(.success, null, "Instant replay saved to: {s}", .{path});
+                } else |err| {
+                    sdk.misc.error_context.append("Failed to keep instant replay: {s}", .{path});
+                    sdk.misc.error_context.logError(err);
+                    return null;
+                }
+            }
+        }.call, .{
+            self.io_allocator,
+            frames,
+            file_path_buffer,
+            file_path.len,
+            self.recording_profile,
+        }) catch |err| {
+            sdk.misc.error_context.append("Failed to spawn save instant replay task.", .{});
+            sdk.misc.error_context.append("Failed to keep instant replay: {s}", .{file_path});
+            sdk.misc.error_context.logError(err);
+            self.io_allocator.free(frames);
+            return;
+        };
+        replay.clear();
+        self.instant_replay_task = task;
+    }
+
+    pub fn isSavingInstantReplay(self: *const Self) bool {
+        return self.instant_replay_task != null;
+    }
+
+    pub fn getInstantReplayLen(self: *const Self) usize {
+        const replay = if (self.instant_replay) |*r| r else return 0;
+        return replay.getLen();
+    }
+
+    // Takes ownership of the frames, which have to be allocated by the controller's allocator. Frames stay owned by the
+    // caller when aligning fails.
+    pub fn setComparison(self: *Self, frames: []model.Frame, config: *const core.AlignmentConfig) !void {
+        const recording = self.recording.items;
+        const alignment = core.RecordingAlignment.init(self.allocator, recording, frames, config) catch |err| {
+            sdk.misc.error_context.append("Failed to align the comparison recording.", .{});
+            return err;
+        };
+        self.clearComparison();
+        self.comparison = .{ .recording = frames, .config = config.*, .alignment = alignment };
+        std.log.info(
+            "Comparison recording aligned. Matched {} of {} frames.",
+            .{ alignment.getNumberOfMatched(), self.recording.items.len },
+        );
+    }
+
+    pub fn clearComparison(self: *Self) void {
+        const comparison = if (self.comparison) |*c| c else return;
+        comparison.alignment.deinit();
+        self.allocator.free(comparison.recording);
+        self.comparison = null;
+    }
+
+    // Alignment only covers the frames that the recording had when aligning, so it has to be redone on every change.
+    fn realignComparison(self: *Self) void {
+        const comparison = if (self.comparison) |*c| c else return;
+        const alignment = core.RecordingAlignment.init(
+            self.allocator,
+            self.recording.items,
+            comparison.recording,
+            &comparison.config,
+        ) catch |err| {
+            sdk.misc.error_context.append("Failed to realign the comparison recording.", .{});
+            sdk.misc.error_context.logError(err);
+            self.clearComparison();
+            return;
+        };
+        comparison.alignment.deinit();
+        comparison.alignment = alignment;
     }
 
     pub fn load(self: *Self, file_path: []const u8) void {
+        self.startLoading(file_path, false);
+    }
+
+    // Loads a recording that gets aligned with the current recording instead of replacing it.
+    pub fn loadComparison(self: *Self, file_path: []const u8) void {
+        self.startLoading(file_path, true);
+    }
+
+    fn startLoading(self: *Self, file_path: []const u8, is_comparison: bool) void {
         if (self.mode == .load or self.mode == .save) {
             return;
         }
@@ -449,6 +676,7 @@ pub const Controller = struct {
         self.mode = .{ .load = .{
             .task = task,
             .frame_index = frame_index,
+            .is_comparison = is_comparison,
         } };
     }
 
@@ -472,10 +700,17 @@ pub const Controller = struct {
                 frames: []const model.Frame,
                 path_buffer: [sdk.os.max_file_path_length]u8,
                 path_len: usize,
+                profile: model.RecordingProfile,
             ) ?void {
                 std.log.debug("Save recording task spawned.", .{});
                 const path = path_buffer[0..path_len];
-                if (sdk.io.saveRecording(model.Frame, allocator, frames, path, &serialization_config)) {
+                const result = switch (profile) {
+                    inline else => |p| block: {
+                        const config = getRecordingConfig(p);
+                        break :block sdk.io.saveRecording(model.Frame, allocator, frames, path, config);
+                    },
+                };
+                if (result) {
                     std.log.info("Recording saved.", .{});
                     sdk.ui.toasts.send(.success, null, "Recording saved successfully.", .{});
                 } else |err| {
@@ -484,7 +719,13 @@ pub const Controller = struct {
                     return null;
                 }
             }
-        }.call, .{ self.allocator, self.recording.items, file_path_buffer, file_path_copy.len }) catch |err| {
+        }.call, .{
+            self.io_allocator,
+            self.recording.items,
+            file_path_buffer,
+            file_path_copy.len,
+            self.recording_profile,
+        }) catch |err| {
             sdk.misc.error_context.append("Failed to spawn save recording task.", .{});
             sdk.misc.error_context.append("Failed to save recording: {s}", .{file_path});
             sdk.misc.error_context.logError(err);
@@ -497,6 +738,156 @@ pub const Controller = struct {
         } };
     }
 
+    // Saves only a part of the recording (keep) or the recording without that part (delete) into a new file.
+    // When the source path is provided and the recording is unchanged since it was loaded from that file, compressed
+    // chunks are copied from that file instead of re-encoding the whole recording.
+    pub fn saveRange(
+        self: *Self,
+        file_path: []const u8,
+        source_path: ?[]const u8,
+        edit: RangeEdit,
+        start: usize,
+        end: usize,
+    ) void {
+        if (self.mode == .load or self.mode == .save) {
+            return;
+        }
+        std.log.info("Saving recording range [{}, {})... {s}", .{ start, end, file_path });
+        if (start > end or end > self.getTotalFrames()) {
+            sdk.misc.error_context.new(
+                "Range [{}, {}) is out of bounds. Total number of frames is: {}",
+                .{ start, end, self.getTotalFrames() },
+            );
+            sdk.misc.error_context.append("Failed to save recording range: {s}", .{file_path});
+            sdk.misc.error_context.logError(error.OutOfBounds);
+            return;
+        }
+        var file_path_buffer: [sdk.os.max_file_path_length]u8 = undefined;
+        const file_path_copy = std.fmt.bufPrint(&file_path_buffer, "{s}", .{file_path}) catch |err| {
+            sdk.misc.error_context.new("Failed to copy file path to buffer.", .{});
+            sdk.misc.error_context.append("Failed to save recording range: {s}", .{file_path});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+        var source_path_buffer: [sdk.os.max_file_path_length]u8 = undefined;
+        const source_path_copy = std.fmt.bufPrint(&source_path_buffer, "{s}", .{source_path orelse ""}) catch |err| {
+            sdk.misc.error_context.new("Failed to copy source path to buffer.", .{});
+            sdk.misc.error_context.append("Failed to save recording range: {s}", .{file_path});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+        std.log.debug("Spawning save recording range task...", .{});
+        self.cleanUpModeState(); // Called here to ensure the recorded segment gets flushed before spawning the task.
+        const task = SaveTask.spawn(self.allocator, struct {
+            fn call(
+                allocator: std.mem.Allocator,
+                frames: []const model.Frame,
+                path_buffer: [sdk.os.max_file_path_length]u8,
+                path_len: usize,
+                source_buffer: [sdk.os.max_file_path_length]u8,
+                source_len: usize,
+                range_edit: RangeEdit,
+                range_start: usize,
+                range_end: usize,
+                profile: model.RecordingProfile,
+            ) ?void {
+                std.log.debug("Save recording range task spawned.", .{});
+                const path = path_buffer[0..path_len];
+                const source = if (source_len > 0) source_buffer[0..source_len] else null;
+                const result = switch (profile) {
+                    inline else => |p| saveRecordingRange(
+                        allocator,
+                        frames,
+                        path,
+                        source,
+                        range_edit,
+                        range_start,
+                        range_end,
+                        getRecordingConfig(p),
+                    ),
+                };
+                if (result) {
+                    std.log.info("Recording range saved.", .{});
+                    sdk.ui.toasts.send(.success, null, "Recording range saved successfully.", .{});
+                } else |err| {
+                    sdk.misc.error_context.append("Failed to save recording range: {s}", .{path});
+                    sdk.misc.error_context.logError(err);
+                    return null;
+                }
+            }
+        }.call, .{
+            self.io_allocator,
+            self.recording.items,
+            file_path_buffer,
+            file_path_copy.len,
+            source_path_buffer,
+            source_path_copy.len,
+            edit,
+            start,
+            end,
+            self.recording_profile,
+        }) catch |err| {
+            sdk.misc.error_context.append("Failed to spawn save recording range task.", .{});
+            sdk.misc.error_context.append("Failed to save recording range: {s}", .{file_path});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+        const frame_index = self.getCurrentFrameIndex();
+        self.mode = .{ .save = .{
+            .task = task,
+            .frame_index = frame_index,
+            .is_range = true,
+        } };
+    }
+
+    fn saveRecordingRange(
+        allocator: std.mem.Allocator,
+        frames: []const model.Frame,
+        file_path: []const u8,
+        source_path: ?[]const u8,
+        edit: RangeEdit,
+        start: usize,
+        end: usize,
+        comptime config: *const sdk.io.RecordingConfig,
+    ) !void {
+        if (source_path) |source| {
+            const result = switch (edit) {
+                .keep => sdk.io.trimRecording(model.Frame, allocator, source, file_path, start, end, config),
+                .delete => sdk.io.deleteRecordingRange(model.Frame, allocator, source, file_path, start, end, config),
+            };
+            if (result) {
+                return;
+            } else |err| switch (err) {
+                // Files saved by older versions or with different settings can not be edited without re-encoding.
+                error.UnsupportedVersion,
+                error.CodecMismatch,
+                error.FieldListMismatch,
+                error.DictionaryMismatch,
+                => {
+                    sdk.misc.error_context.append("Falling back to saving the range from memory.", .{});
+                    sdk.misc.error_context.logWarning(err);
+                },
+                else => return err,
+            }
+        }
+        switch (edit) {
+            .keep => {
+                const kept = frames[start..end];
+                return sdk.io.saveRecording(model.Frame, allocator, kept, file_path, config);
+            },
+            .delete => {
+                const remaining = allocator.alloc(model.Frame, frames.len - (end - start)) catch |err| {
+                    sdk.misc.error_context.new("Failed to allocate {} frames.", .{frames.len - (end - start)});
+                    return err;
+                };
+                defer allocator.free(remaining);
+                @memcpy(remaining[0..start], frames[0..start]);
+                @memcpy(remaining[start..], frames[end..]);
+                return sdk.io.saveRecording(model.Frame, allocator, remaining, file_path, config);
+            },
+        }
+    }
+
     fn cleanUpModeState(self: *Self) void {
         switch (self.mode) {
             .live, .pause, .playback, .scrub => {},
@@ -506,20 +897,34 @@ pub const Controller = struct {
                     sdk.misc.error_context.logError(err);
                 };
                 state.segment.deinit(self.allocator);
+                self.realignComparison();
             },
             .load => |*state| {
-                if (state.task.join().*) |frames| {
+                const frames = state.task.join().* orelse {
+                    self.did_last_save_or_load_succeed = false;
+                    return;
+                };
+                if (state.is_comparison) {
+                    self.setComparison(frames, &.{}) catch |err| {
+                        sdk.misc.error_context.append("Failed to set the comparison recording.", .{});
+                        sdk.misc.error_context.logError(err);
+                        self.allocator.free(frames);
+                        self.did_last_save_or_load_succeed = false;
+                        return;
+                    };
+                } else {
                     self.recording.clearAndFree(self.allocator);
                     self.recording = .fromOwnedSlice(frames);
                     self.contains_unsaved_changes = false;
-                    self.did_last_save_or_load_succeed = true;
-                } else {
-                    self.did_last_save_or_load_succeed = false;
+                    self.realignComparison();
                 }
+                self.did_last_save_or_load_succeed = true;
             },
             .save => |*state| {
                 if (state.task.join().* != null) {
-                    self.contains_unsaved_changes = false;
+                    if (!state.is_range) {
+                        self.contains_unsaved_changes = false;
+                    }
                     self.did_last_save_or_load_succeed = true;
                 } else {
                     self.did_last_save_or_load_succeed = false;
@@ -653,6 +1058,24 @@ pub const Controller = struct {
         }
     }
 
+    pub fn hasComparison(self: *const Self) bool {
+        return self.comparison != null;
+    }
+
+    // Index of the comparison recording's frame that corresponds to the current frame.
+    pub fn getComparisonFrameIndex(self: *const Self) ?usize {
+        const comparison = if (self.comparison) |*c| c else return null;
+        const index = self.getCurrentFrameIndex() orelse return null;
+        return comparison.alignment.getCorrespondingIndex(index);
+    }
+
+    // Frame of the comparison recording that corresponds to the current frame.
+    pub fn getComparisonFrame(self: *const Self) ?*const model.Frame {
+        const comparison = if (self.comparison) |*c| c else return null;
+        const comparison_index = self.getComparisonFrameIndex() orelse return null;
+        return &comparison.recording[comparison_index];
+    }
+
     pub fn getScrubDirection(self: *const Self) ?ScrubDirection {
         return switch (self.mode) {
             .scrub => |*state| state.direction,
@@ -1741,6 +2164,265 @@ test "should load the same frames that were previously saved" {
     try testing.expectEqual(frame_4, controller.getFrameAt(3).?.*);
 }
 
+test "should store round starts and character IDs inside the metadata of the saved recording" {
+    var controller = Controller.init(testing.allocator);
+    defer controller.deinit();
+
+    const frames = [_]model.Frame{
+        .{ .frames_since_round_start = 5, .players = .{ .{ .character_id = 1 }, .{ .character_id = 2 } } },
+        .{ .frames_since_round_start = 6, .players = .{ .{ .character_id = 1 }, .{ .character_id = 2 } } },
+        .{ .frames_since_round_start = null, .players = .{ .{ .character_id = 1 }, .{ .character_id = 2 } } },
+        .{ .frames_since_round_start = 0, .players = .{ .{ .character_id = 3 }, .{ .character_id = 2 } } },
+        .{ .frames_since_round_start = 1, .players = .{ .{ .character_id = 3 }, .{ .character_id = 2 } } },
+        .{ .frames_since_round_start = 0, .players = .{ .{ .character_id = 3 }, .{ .character_id = 2 } } },
+    };
+    controller.record();
+    for (&frames) |*frame| {
+        controller.processFrame(frame, {}, struct {
+            fn call(_: void, _: *const model.Frame) void {}
+        }.call);
+    }
+    controller.save("./test_assets/recording.irony");
+    while (controller.mode == .save) {
+        controller.update(Controller.frame_time, {}, struct {
+            fn call(_: void, _: *const model.Frame) void {}
+        }.call);
+        std.Thread.yield() catch {};
+    }
+    try testing.expectEqual(true, controller.did_last_save_or_load_succeed);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+
+    const info = try sdk.io.loadRecordingInfo("./test_assets/recording.irony");
+    const metadata = &(info.metadata orelse return error.MissingMetadata);
+    try testing.expectEqual(6, metadata.number_of_frames);
+    try testing.expectEqualSlices(u32, &.{ 0, 3, 5 }, metadata.getMarkers());
+    try testing.expectEqualSlices(u32, &.{ 1, 2, 3 }, metadata.getLabels());
+}
+
+test "should save only the fields of the selected recording profile" {
+    var controller = Controller.init(testing.allocator);
+    defer controller.deinit();
+    controller.recording_profile = .inputs;
+
+    const frame_1 = model.Frame{ .frames_since_round_start = 1, .players = .{
+        .{ .character_id = 1, .health = 100, .input = .{ .forward = true }, .can_move = true, .rage = .activated },
+        .{ .character_id = 2, .health = 90, .posture = .standing, .hit_lines = .{ .len = 1 } },
+    } };
+    controller.record();
+    controller.processFrame(&frame_1, {}, null);
+
+    controller.save("./test_assets/recording.irony");
+    while (controller.mode == .save) {
+        controller.update(Controller.frame_time, {}, null);
+        std.Thread.yield() catch {};
+    }
+    try testing.expectEqual(true, controller.did_last_save_or_load_succeed);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+
+    const info = try sdk.io.loadRecordingInfo("./test_assets/recording.irony");
+    const profile = &(info.profile orelse return error.MissingProfile);
+    try testing.expectEqualStrings("inputs", profile.get());
+    const loaded = try sdk.io.loadRecording(
+        model.Frame,
+        testing.allocator,
+        "./test_assets/recording.irony",
+        &Controller.serialization_config,
+    );
+    defer testing.allocator.free(loaded);
+    try testing.expectEqualSlices(model.Frame, &.{.{ .frames_since_round_start = 1, .players = .{
+        .{ .character_id = 1, .health = 100, .input = .{ .forward = true }, .can_move = true },
+        .{ .character_id = 2, .health = 90, .posture = .standing },
+    } }}, loaded);
+}
+
+test "should keep the move data when saving with inputs recording profile" {
+    var controller = Controller.init(testing.allocator);
+    defer controller.deinit();
+    controller.recording_profile = .inputs;
+
+    const player = model.Player{
+        .character_id = 1,
+        .animation_id = 2,
+        .animation_frame = 12,
+        .animation_total_frames = 40,
+        .move_phase = .active,
+        .animation_to_move_delta = 0,
+        .first_active_frame = 10,
+        .last_active_frame = 13,
+        .connected_frame = 12,
+        .attack_type = .mid,
+        .min_attack_z = 0.5,
+        .max_attack_z = 1.5,
+        .attack_range = 2.5,
+        .recovery_range = 1.25,
+        .attack_damage = 15,
+        .hit_outcome = .blocked_standing,
+        .can_move = false,
+    };
+    const frame = model.Frame{ .frames_since_round_start = 1, .players = .{ player, .{ .can_move = true } } };
+    controller.record();
+    controller.processFrame(&frame, {}, null);
+
+    controller.save("./test_assets/recording.irony");
+    while (controller.mode == .save) {
+        controller.update(Controller.frame_time, {}, null);
+        std.Thread.yield() catch {};
+    }
+    try testing.expectEqual(true, controller.did_last_save_or_load_succeed);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+
+    const loaded = try sdk.io.loadRecording(
+        model.Frame,
+        testing.allocator,
+        "./test_assets/recording.irony",
+        &Controller.serialization_config,
+    );
+    defer testing.allocator.free(loaded);
+    try testing.expectEqualSlices(model.Frame, &.{frame}, loaded);
+}
+
+test "should save frames captured by instant replay into a new file without touching the recording" {
+    var controller = Controller.init(testing.allocator);
+    defer controller.deinit();
+    controller.instant_replay = try core.InstantReplay.init(testing.allocator, "./test_assets/instant_replay");
+    defer std.fs.cwd().deleteTree("./test_assets/instant_replay") catch @panic("Failed to cleanup test directory.");
+
+    const frame_1 = model.Frame{ .frames_since_round_start = 1 };
+    const frame_2 = model.Frame{ .frames_since_round_start = 2 };
+    const frame_3 = model.Frame{ .frames_since_round_start = 3 };
+
+    controller.record();
+    controller.processFrame(&frame_1, {}, null);
+    controller.stop();
+    controller.processFrame(&frame_2, {}, null);
+    controller.processFrame(&frame_3, {}, null);
+    try testing.expectEqual(3, controller.getInstantReplayLen());
+    controller.contains_unsaved_changes = false;
+
+    controller.keepInstantReplay();
+    try testing.expectEqual(0, controller.getInstantReplayLen());
+    while (controller.isSavingInstantReplay()) {
+        controller.update(Controller.frame_time, {}, null);
+        std.Thread.yield() catch {};
+    }
+    try testing.expect(controller.mode == .live);
+    try testing.expectEqualSlices(model.Frame, &.{frame_1}, controller.recording.items);
+    try testing.expectEqual(false, controller.contains_unsaved_changes);
+
+    var directory = try std.fs.cwd().openDir("./test_assets/instant_replay", .{ .iterate = true });
+    defer directory.close();
+    var iterator = directory.iterate();
+    const entry = try iterator.next() orelse return error.MissingReplayFile;
+    try testing.expectEqual(null, try iterator.next());
+    var path_buffer: [sdk.os.max_file_path_length]u8 = undefined;
+    const path = try std.fmt.bufPrint(&path_buffer, "./test_assets/instant_replay/{s}", .{entry.name});
+    const kept = try sdk.io.loadRecording(model.Frame, testing.allocator, path, &Controller.serialization_config);
+    defer testing.allocator.free(kept);
+    try testing.expectEqualSlices(model.Frame, &.{ frame_1, frame_2, frame_3 }, kept);
+}
+
+test "should save the range of frames both when editing the linked file and when saving from memory" {
+    var controller = Controller.init(testing.allocator);
+    defer controller.deinit();
+
+    const frame_1 = model.Frame{ .frames_since_round_start = 1 };
+    const frame_2 = model.Frame{ .frames_since_round_start = 2 };
+    const frame_3 = model.Frame{ .frames_since_round_start = 3 };
+    const frame_4 = model.Frame{ .frames_since_round_start = 4 };
+
+    controller.record();
+    controller.processFrame(&frame_1, {}, null);
+    controller.processFrame(&frame_2, {}, null);
+    controller.processFrame(&frame_3, {}, null);
+    controller.processFrame(&frame_4, {}, null);
+
+    controller.save("./test_assets/recording.irony");
+    while (controller.mode == .save) {
+        controller.update(Controller.frame_time, {}, null);
+        std.Thread.yield() catch {};
+    }
+    try testing.expectEqual(true, controller.did_last_save_or_load_succeed);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+
+    controller.saveRange("./test_assets/edited.irony", "./test_assets/recording.irony", .delete, 1, 3);
+    while (controller.mode == .save) {
+        controller.update(Controller.frame_time, {}, null);
+        std.Thread.yield() catch {};
+    }
+    try testing.expectEqual(true, controller.did_last_save_or_load_succeed);
+    defer std.fs.cwd().deleteFile("./test_assets/edited.irony") catch @panic("Failed to cleanup test file.");
+    const edited = try sdk.io.loadRecording(
+        model.Frame,
+        testing.allocator,
+        "./test_assets/edited.irony",
+        &Controller.serialization_config,
+    );
+    defer testing.allocator.free(edited);
+    try testing.expectEqualSlices(model.Frame, &.{ frame_1, frame_4 }, edited);
+
+    controller.saveRange("./test_assets/edited.irony", null, .keep, 1, 3);
+    while (controller.mode == .save) {
+        controller.update(Controller.frame_time, {}, null);
+        std.Thread.yield() catch {};
+    }
+    try testing.expectEqual(true, controller.did_last_save_or_load_succeed);
+    const kept = try sdk.io.loadRecording(
+        model.Frame,
+        testing.allocator,
+        "./test_assets/edited.irony",
+        &Controller.serialization_config,
+    );
+    defer testing.allocator.free(kept);
+    try testing.expectEqualSlices(model.Frame, &.{ frame_2, frame_3 }, kept);
+    try testing.expectEqual(4, controller.getTotalFrames());
+}
+
+test "saveRange should save with the selected recording profile when falling back to saving from memory" {
+    var controller = Controller.init(testing.allocator);
+    defer controller.deinit();
+
+    const frame_1 = model.Frame{ .frames_since_round_start = 1, .players = .{ .{ .rage = .activated }, .{} } };
+    const frame_2 = model.Frame{ .frames_since_round_start = 2, .players = .{ .{ .can_move = true }, .{} } };
+    const frame_3 = model.Frame{ .frames_since_round_start = 3, .players = .{ .{ .health = 100 }, .{} } };
+
+    controller.record();
+    controller.processFrame(&frame_1, {}, null);
+    controller.processFrame(&frame_2, {}, null);
+    controller.processFrame(&frame_3, {}, null);
+
+    controller.save("./test_assets/recording.irony");
+    while (controller.mode == .save) {
+        controller.update(Controller.frame_time, {}, null);
+        std.Thread.yield() catch {};
+    }
+    try testing.expectEqual(true, controller.did_last_save_or_load_succeed);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+
+    controller.recording_profile = .inputs;
+    controller.saveRange("./test_assets/edited.irony", "./test_assets/recording.irony", .keep, 0, 2);
+    while (controller.mode == .save) {
+        controller.update(Controller.frame_time, {}, null);
+        std.Thread.yield() catch {};
+    }
+    try testing.expectEqual(true, controller.did_last_save_or_load_succeed);
+    defer std.fs.cwd().deleteFile("./test_assets/edited.irony") catch @panic("Failed to cleanup test file.");
+
+    const info = try sdk.io.loadRecordingInfo("./test_assets/edited.irony");
+    const profile = &(info.profile orelse return error.MissingProfile);
+    try testing.expectEqualStrings("inputs", profile.get());
+    const edited = try sdk.io.loadRecording(
+        model.Frame,
+        testing.allocator,
+        "./test_assets/edited.irony",
+        &Controller.serialization_config,
+    );
+    defer testing.allocator.free(edited);
+    try testing.expectEqualSlices(model.Frame, &.{
+        .{ .frames_since_round_start = 1 },
+        .{ .frames_since_round_start = 2, .players = .{ .{ .can_move = true }, .{} } },
+    }, edited);
+}
+
 test "should pause at the previously current frame after recording save completes" {
     const Callback = struct {
         var times_called: usize = 0;
@@ -1826,3 +2508,100 @@ test "should pause at the last frame of the recording after recording load compl
     try testing.expect(controller.mode == .pause);
     try testing.expectEqual(3, controller.getCurrentFrameIndex());
 }
+
+test "getComparisonFrame should return the frame of the comparison recording that corresponds to the current frame" {
+    const Callback = struct {
+        fn call(_: void, _: *const model.Frame) void {}
+    };
+    const getFrame = struct {
+        fn call(index: usize) model.Frame {
+            var frame = model.Frame{ .frames_since_round_start = @intCast(index) };
+            frame.players[0] = .{
+                .character_id = 1,
+                .animation_id = @intCast(index / 20),
+                .animation_frame = @intCast(index % 20),
+                .animation_to_move_delta = 0,
+            };
+            return frame;
+        }
+    }.call;
+
+    var controller = Controller.init(testing.allocator);
+    defer controller.deinit();
+    controller.record();
+    for (0..100) |index| {
+        const frame = getFrame(index);
+        controller.processFrame(&frame, {}, Callback.call);
+    }
+    controller.pause();
+    try testing.expectEqual(null, controller.getComparisonFrame());
+
+    const comparison = try testing.allocator.alloc(model.Frame, 130);
+    for (comparison, 0..) |*frame, index| {
+        frame.* = if (index < 30) .{} else getFrame(index - 30);
+    }
+    try controller.setComparison(comparison, &.{});
+    controller.setCurrentFrameIndex(50);
+    try testing.expect(controller.getComparisonFrame() != null);
+    try testing.expectEqual(&comparison[80], controller.getComparisonFrame().?);
+
+    controller.clearComparison();
+    try testing.expectEqual(null, controller.getComparisonFrame());
+}
+
+test "loadComparison should align the loaded recording with the current recording without replacing it" {
+    const Callback = struct {
+        fn call(_: void, _: *const model.Frame) void {}
+    };
+    const getFrame = struct {
+        fn call(index: usize) model.Frame {
+            var frame = model.Frame{ .frames_since_round_start = @intCast(index) };
+            frame.players[0] = .{
+                .character_id = 1,
+                .animation_id = @intCast(index / 20),
+                .animation_frame = @intCast(index % 20),
+                .animation_to_move_delta = 0,
+            };
+            return frame;
+        }
+    }.call;
+
+    var controller = Controller.init(testing.allocator);
+    defer controller.deinit();
+    controller.record();
+    for (0..130) |index| {
+        const frame = if (index < 30) model.Frame{} else getFrame(index - 30);
+        controller.processFrame(&frame, {}, Callback.call);
+    }
+    controller.save("./test_assets/recording.irony");
+    while (controller.mode == .save) {
+        controller.update(Controller.frame_time, {}, Callback.call);
+        std.Thread.yield() catch {};
+    }
+    try testing.expectEqual(true, controller.did_last_save_or_load_succeed);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+
+    controller.clear();
+    controller.record();
+    for (0..100) |index| {
+        const frame = getFrame(index);
+        controller.processFrame(&frame, {}, Callback.call);
+    }
+    controller.pause();
+    controller.setCurrentFrameIndex(50);
+    try testing.expectEqual(false, controller.hasComparison());
+    try testing.expectEqual(null, controller.getComparisonFrameIndex());
+
+    controller.loadComparison("./test_assets/recording.irony");
+    while (controller.mode == .load) {
+        controller.update(Controller.frame_time, {}, Callback.call);
+        std.Thread.yield() catch {};
+    }
+    try testing.expectEqual(true, controller.did_last_save_or_load_succeed);
+    try testing.expectEqual(true, controller.hasComparison());
+    try testing.expect(controller.mode == .pause);
+    try testing.expectEqual(100, controller.getTotalFrames());
+    try testing.expectEqual(50, controller.getCurrentFrameIndex());
+    try testing.expectEqual(80, controller.getComparisonFrameIndex());
+    try testing.expectEqual(getFrame(50), controller.getComparisonFrame().?.*);
+}
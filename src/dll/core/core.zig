@@ -1,5 +1,6 @@
 const std = @import("std");
 const build_info = @import("build_info");
+const sdk = @import("../../sdk/root.zig");
 const core = @import("../core/root.zig");
 const game = @import("../game/root.zig");
 const model = @import("../model/root.zig");
@@ -12,10 +13,14 @@ pub const Core = struct {
     move_detector: core.MoveDetector,
     move_measurer: core.MoveMeasurer,
     controller: core.Controller,
+    frame_feed: ?core.FrameFeed,
+    snapshot_recorder: ?core.SnapshotRecorder,
 
     const Self = @This();
 
-    pub fn init(allocator: std.mem.Allocator) Self {
+    pub fn init(allocator: std.mem.Allocator, io_allocator: std.mem.Allocator) Self {
+        var controller = core.Controller.init(allocator);
+        controller.io_allocator = io_allocator;
         return .{
             .frame_detector = .{},
             .capturer = .{},
@@ -23,11 +28,21 @@ pub const Core = struct {
             .hit_detector = .{},
             .move_detector = .{},
             .move_measurer = .{},
-            .controller = core.Controller.init(allocator),
+            .controller = controller,
+            .frame_feed = null,
+            .snapshot_recorder = null,
         };
     }
 
     pub fn deinit(self: *Self) void {
+        if (self.frame_feed) |*feed| {
+            feed.close();
+            self.frame_feed = null;
+        }
+        if (self.snapshot_recorder) |*recorder| {
+            recorder.deinit();
+            self.snapshot_recorder = null;
+        }
         self.controller.deinit();
     }
 
@@ -43,11 +58,21 @@ pub const Core = struct {
             return;
         }
         const camera = game_memory.camera.takeCopy();
-        var frame = self.capturer.captureFrame(&.{ .player_1 = player_1, .player_2 = player_2, .camera = camera });
+        const snapshot = core.Snapshot{ .player_1 = player_1, .player_2 = player_2, .camera = camera };
+        if (self.snapshot_recorder) |*recorder| {
+            recorder.record(&snapshot) catch |err| {
+                sdk.misc.error_context.append("Failed to record raw snapshot.", .{});
+                sdk.misc.error_context.logError(err);
+            };
+        }
+        var frame = self.capturer.captureFrame(&snapshot);
         self.pause_detector.update();
         self.hit_detector.detect(&frame);
         self.move_detector.detect(&frame);
         self.move_measurer.measure(&frame);
+        if (self.frame_feed) |*feed| {
+            feed.publish(&frame);
+        }
         self.controller.processFrame(&frame, context, processFrame);
     }
 
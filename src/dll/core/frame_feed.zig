@@ -0,0 +1,11 @@
+const sdk = @import("../../sdk/root.zig");
+const core = @import("../core/root.zig");
+const model = @import("../model/root.zig");
+
+// Every captured frame gets published into this shared memory ring so other processes can follow the game live without
+// going through recordings. Consumers open it with the game's process ID and the name below.
+pub const frame_feed_name = "frame_feed";
+pub const FrameFeed = sdk.os.SharedRing(model.Frame, .{
+    .capacity = 256,
+    .layout = sdk.io.getFrameLayout(model.Frame, &core.Controller.serialization_config),
+});
@@ -0,0 +1,430 @@
+const std = @import("std");
+const sdk = @import("../../sdk/root.zig");
+const model = @import("../model/root.zig");
+
+// Frame indexes of everything that can be searched for. The first events are presses of the input with the same name.
+pub const InputEvent = enum {
+    forward,
+    back,
+    up,
+    down,
+    left,
+    right,
+    button_1,
+    button_2,
+    button_3,
+    button_4,
+    special_style,
+    rage,
+    heat,
+    // Hit outcome changed into one of the blocking outcomes.
+    blocked,
+    // Hit outcome changed into one of the outcomes that are not blocking.
+    got_hit,
+    // Player regained the ability to move.
+    recovered,
+    // Player regained the ability to move while the last hit outcome was a block.
+    block_stun_end,
+    // Player regained the ability to move while the last hit outcome was a hit.
+    hit_stun_end,
+};
+
+pub const InputQuery = struct {
+    steps: []const Step,
+
+    pub const Step = struct {
+        player_id: model.PlayerId,
+        event: InputEvent,
+        // Inputs that have to be held in the frame of the event. For example down and forward for d/f+2.
+        held: model.Input = .{},
+        // Range of frames relative to the frame of the previous step in which this step has to happen.
+        // Negative values allow the step to happen before the previous step. Ignored for the first step.
+        min_offset: i32 = 0,
+        max_offset: i32 = 0,
+    };
+};
+
+pub const InputMatch = struct {
+    first_frame: u32,
+    last_frame: u32,
+};
+
+pub const InputRun = struct {
+    start: u32,
+    input: model.Input,
+};
+
+// Run-length encoded input streams of both players plus a list of frame indexes for every event.
+// Searching visits only the frames where the query's events happen instead of stepping through every frame.
+pub const InputIndex = struct {
+    allocator: std.mem.Allocator,
+    number_of_frames: usize,
+    players: [2]PlayerIndex,
+
+    const Self = @This();
+    const InputBits = std.meta.Int(.unsigned, @bitSizeOf(model.Input));
+    const PlayerIndex = struct {
+        runs: []const InputRun,
+        postings: std.EnumArray(InputEvent, []const u32),
+    };
+
+    pub fn init(allocator: std.mem.Allocator, frames: []const model.Frame) !Self {
+        if (frames.len > std.math.maxInt(u32)) {
+            sdk.misc.error_context.new("Too many frames to index: {}", .{frames.len});
+            return error.TooManyFrames;
+        }
+        var self = Self{
+            .allocator = allocator,
+            .number_of_frames = frames.len,
+            .players = undefined,
+        };
+        var number_of_initialized: usize = 0;
+        errdefer {
+            for (self.players[0..number_of_initialized]) |*player| {
+                freePlayerIndex(allocator, player);
+            }
+        }
+        for (&self.players, 0..) |*player, player_index| {
+            player.* = buildPlayerIndex(allocator, frames, player_index) catch |err| {
+                sdk.misc.error_context.append("Failed to index inputs of player: {}", .{player_index + 1});
+                return err;
+            };
+            number_of_initialized += 1;
+        }
+        return self;
+    }
+
+    pub fn deinit(self: *Self) void {
+        for (&self.players) |*player| {
+            freePlayerIndex(self.allocator, player);
+        }
+    }
+
+    pub fn getRuns(self: *const Self, player_id: model.PlayerId) []const InputRun {
+        return self.getPlayer(player_id).runs;
+    }
+
+    pub fn getEventFrames(self: *const Self, player_id: model.PlayerId, event: InputEvent) []const u32 {
+        return self.getPlayer(player_id).postings.get(event);
+    }
+
+    pub fn getInput(self: *const Self, player_id: model.PlayerId, frame_index: u32) model.Input {
+        const runs = self.getPlayer(player_id).runs;
+        var low: usize = 0;
+        var high: usize = runs.len;
+        while (low < high) {
+            const middle = low + (high - low) / 2;
+            if (runs[middle].start <= frame_index) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        if (low == 0) {
+            return .{};
+        }
+        return runs[low - 1].input;
+    }
+
+    // Appends a match for every frame where the first step of the query happens and all the other steps follow.
+    pub fn search(
+        self: *const Self,
+        allocator: std.mem.Allocator,
+        query: *const InputQuery,
+        matches: *std.ArrayList(InputMatch),
+    ) !void {
+        if (query.steps.len == 0) {
+            return;
+        }
+        const first_step = &query.steps[0];
+        for (self.getEventFrames(first_step.player_id, first_step.event)) |frame_index| {
+            if (!self.isHeld(first_step, frame_index)) {
+                continue;
+            }
+            const last_frame = self.matchRemainingSteps(query.steps[1..], frame_index) orelse continue;
+            matches.append(allocator, .{ .first_frame = frame_index, .last_frame = last_frame }) catch |err| {
+                sdk.misc.error_context.new("Failed to append input match.", .{});
+                return err;
+            };
+        }
+    }
+
+    fn matchRemainingSteps(self: *const Self, steps: []const InputQuery.Step, previous_frame: u32) ?u32 {
+        if (steps.len == 0) {
+            return previous_frame;
+        }
+        const step = &steps[0];
+        const frames = self.getEventFrames(step.player_id, step.event);
+        const previous: i64 = previous_frame;
+        const min_frame = std.math.clamp(previous + step.min_offset, 0, std.math.maxInt(u32));
+        const max_frame = previous + step.max_offset;
+        var index = lowerBound(frames, @intCast(min_frame));
+        while (index < frames.len and frames[index] <= max_frame) : (index += 1) {
+            const frame_index = frames[index];
+            if (!self.isHeld(step, frame_index)) {
+                continue;
+            }
+            if (self.matchRemainingSteps(steps[1..], frame_index)) |last_frame| {
+                return last_frame;
+            }
+        }
+        return null;
+    }
+
+    fn isHeld(self: *const Self, step: *const InputQuery.Step, frame_index: u32) bool {
+        const held: InputBits = @bitCast(step.held);
+        const input: InputBits = @bitCast(self.getInput(step.player_id, frame_index));
+        return input & held == held;
+    }
+
+    fn getPlayer(self: *const Self, player_id: model.PlayerId) *const PlayerIndex {
+        return switch (player_id) {
+            .player_1 => &self.players[0],
+            .player_2 => &self.players[1],
+        };
+    }
+
+    fn buildPlayerIndex(allocator: std.mem.Allocator, frames: []const model.Frame, player_index: usize) !PlayerIndex {
+        var runs: std.ArrayList(InputRun) = .empty;
+        defer runs.deinit(allocator);
+        var lists = std.EnumArray(InputEvent, std.ArrayList(u32)).initFill(.empty);
+        defer {
+            for (&lists.values) |*list| {
+                list.deinit(allocator);
+            }
+        }
+
+        var previous_maybe: ?*const model.Player = null;
+        for (frames, 0..) |*frame, frame_index| {
+            const current = &frame.players[player_index];
+            const index: u32 = @intCast(frame_index);
+            const input = current.input orelse model.Input{};
+            const last_input: InputBits = if (runs.items.len > 0) @bitCast(runs.getLast().input) else 0;
+            if (runs.items.len == 0 or @as(InputBits, @bitCast(input)) != last_input) {
+                runs.append(allocator, .{ .start = index, .input = input }) catch |err| {
+                    sdk.misc.error_context.new("Failed to append input run.", .{});
+                    return err;
+                };
+            }
+            var iterator = lists.iterator();
+            while (iterator.next()) |entry| {
+                if (!isEventHappening(entry.key, previous_maybe, current, last_input)) {
+                    continue;
+                }
+                entry.value.append(allocator, index) catch |err| {
+                    sdk.misc.error_context.new("Failed to append event frame: {s}", .{@tagName(entry.key)});
+                    return err;
+                };
+            }
+            previous_maybe = current;
+        }
+
+        var player = PlayerIndex{ .runs = &.{}, .postings = .initFill(&.{}) };
+        errdefer freePlayerIndex(allocator, &player);
+        player.runs = runs.toOwnedSlice(allocator) catch |err| {
+            sdk.misc.error_context.new("Failed to convert input runs to owned slice.", .{});
+            return err;
+        };
+        var iterator = lists.iterator();
+        while (iterator.next()) |entry| {
+            player.postings.set(entry.key, entry.value.toOwnedSlice(allocator) catch |err| {
+                sdk.misc.error_context.new("Failed to convert event frames to owned slice.", .{});
+                return err;
+            });
+        }
+        return player;
+    }
+
+    fn freePlayerIndex(allocator: std.mem.Allocator, player: *PlayerIndex) void {
+        allocator.free(player.runs);
+        for (&player.postings.values) |frames| {
+            allocator.free(frames);
+        }
+    }
+
+    fn isEventHappening(
+        event: InputEvent,
+        previous_maybe: ?*const model.Player,
+        current: *const model.Player,
+        previous_input: InputBits,
+    ) bool {
+        switch (event) {
+            .blocked, .got_hit => {
+                const current_outcome = current.hit_outcome orelse return false;
+                const previous_outcome = if (previous_maybe) |previous| previous.hit_outcome else null;
+                if (previous_outcome == current_outcome) {
+                    return false;
+                }
+                return switch (event) {
+                    .blocked => isBlock(current_outcome),
+                    else => current_outcome != .none and !isBlock(current_outcome),
+                };
+            },
+            .recovered, .block_stun_end, .hit_stun_end => {
+                const previous = previous_maybe orelse return false;
+                if (previous.can_move != false or current.can_move != true) {
+                    return false;
+                }
+                const outcome = previous.hit_outcome orelse return event == .recovered;
+                return switch (event) {
+                    .block_stun_end => isBlock(outcome),
+                    .hit_stun_end => outcome != .none and !isBlock(outcome),
+                    else => true,
+                };
+            },
+            inline else => |input_event| {
+                const name = @tagName(input_event);
+                const input = current.input orelse return false;
+                const bit = @as(InputBits, 1) << @bitOffsetOf(model.Input, name);
+                return @field(input, name) and previous_input & bit == 0;
+            },
+        }
+    }
+
+    fn isBlock(outcome: model.HitOutcome) bool {
+        return outcome == .blocked_standing or outcome == .blocked_crouching;
+    }
+
+    fn lowerBound(frames: []const u32, value: u32) usize {
+        var low: usize = 0;
+        var high: usize = frames.len;
+        while (low < high) {
+            const middle = low + (high - low) / 2;
+            if (frames[middle] < value) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+};
+
+const testing = std.testing;
+
+fn testingFrame(input_1: ?model.Input, input_2: ?model.Input) model.Frame {
+    var frame = model.Frame{};
+    frame.players[0].input = input_1;
+    frame.players[1].input = input_2;
+    return frame;
+}
+
+test "should run-length encode input streams of both players" {
+    const frames = [_]model.Frame{
+        testingFrame(.{ .forward = true }, null),
+        testingFrame(.{ .forward = true }, null),
+        testingFrame(.{ .forward = true, .button_1 = true }, .{ .back = true }),
+        testingFrame(null, .{ .back = true }),
+        testingFrame(null, .{ .back = true }),
+    };
+    var index = try InputIndex.init(testing.allocator, &frames);
+    defer index.deinit();
+
+    try testing.expectEqualSlices(InputRun, &.{
+        .{ .start = 0, .input = .{ .forward = true } },
+        .{ .start = 2, .input = .{ .forward = true, .button_1 = true } },
+        .{ .start = 3, .input = .{} },
+    }, index.getRuns(.player_1));
+    try testing.expectEqualSlices(InputRun, &.{
+        .{ .start = 0, .input = .{} },
+        .{ .start = 2, .input = .{ .back = true } },
+    }, index.getRuns(.player_2));
+    try testing.expectEqual(model.Input{ .forward = true }, index.getInput(.player_1, 1));
+    try testing.expectEqual(model.Input{ .forward = true, .button_1 = true }, index.getInput(.player_1, 2));
+    try testing.expectEqual(model.Input{ .back = true }, index.getInput(.player_2, 4));
+}
+
+test "should index frames where inputs get pressed and where stun ends" {
+    var frames = [_]model.Frame{
+        testingFrame(.{ .button_2 = true }, null),
+        testingFrame(.{ .button_2 = true }, null),
+        testingFrame(.{}, null),
+        testingFrame(.{ .button_2 = true }, null),
+        testingFrame(.{}, null),
+        testingFrame(.{}, null),
+    };
+    frames[1].players[1].hit_outcome = .blocked_standing;
+    frames[1].players[1].can_move = false;
+    frames[2].players[1].hit_outcome = .blocked_standing;
+    frames[2].players[1].can_move = false;
+    frames[3].players[1].hit_outcome = .blocked_standing;
+    frames[3].players[1].can_move = true;
+    frames[4].players[1].hit_outcome = .normal_hit_standing;
+    frames[4].players[1].can_move = false;
+    frames[5].players[1].hit_outcome = .normal_hit_standing;
+    frames[5].players[1].can_move = true;
+    var index = try InputIndex.init(testing.allocator, &frames);
+    defer index.deinit();
+
+    try testing.expectEqualSlices(u32, &.{ 0, 3 }, index.getEventFrames(.player_1, .button_2));
+    try testing.expectEqualSlices(u32, &.{}, index.getEventFrames(.player_1, .button_1));
+    try testing.expectEqualSlices(u32, &.{1}, index.getEventFrames(.player_2, .blocked));
+    try testing.expectEqualSlices(u32, &.{4}, index.getEventFrames(.player_2, .got_hit));
+    try testing.expectEqualSlices(u32, &.{ 3, 5 }, index.getEventFrames(.player_2, .recovered));
+    try testing.expectEqualSlices(u32, &.{3}, index.getEventFrames(.player_2, .block_stun_end));
+    try testing.expectEqualSlices(u32, &.{5}, index.getEventFrames(.player_2, .hit_stun_end));
+}
+
+test "search should find sequences that satisfy held inputs and timing constraints" {
+    var frames: [20]model.Frame = undefined;
+    for (&frames) |*frame| {
+        frame.* = testingFrame(.{}, .{});
+        frame.players[0].can_move = true;
+    }
+    // Block stun ends at 4, d/f+2 pressed at 5.
+    frames[3].players[0].can_move = false;
+    frames[3].players[0].hit_outcome = .blocked_standing;
+    frames[4].players[0].hit_outcome = .blocked_standing;
+    frames[5].players[0].input = .{ .down = true, .forward = true, .button_2 = true };
+    // Block stun ends at 11, d/f+2 pressed at 14 which is too late.
+    frames[10].players[0].can_move = false;
+    frames[10].players[0].hit_outcome = .blocked_crouching;
+    frames[11].players[0].hit_outcome = .blocked_crouching;
+    frames[14].players[0].input = .{ .down = true, .forward = true, .button_2 = true };
+    // Plain 2 pressed at 17 without the direction.
+    frames[16].players[0].can_move = false;
+    frames[16].players[0].hit_outcome = .blocked_standing;
+    frames[17].players[0].hit_outcome = .blocked_standing;
+    frames[17].players[0].input = .{ .button_2 = true };
+    var index = try InputIndex.init(testing.allocator, &frames);
+    defer index.deinit();
+
+    const query = InputQuery{ .steps = &.{
+        .{ .player_id = .player_1, .event = .block_stun_end },
+        .{
+            .player_id = .player_1,
+            .event = .button_2,
+            .held = .{ .down = true, .forward = true },
+            .min_offset = -1,
+            .max_offset = 1,
+        },
+    } };
+    var matches: std.ArrayList(InputMatch) = .empty;
+    defer matches.deinit(testing.allocator);
+    try index.search(testing.allocator, &query, &matches);
+
+    try testing.expectEqualSlices(InputMatch, &.{.{ .first_frame = 4, .last_frame = 5 }}, matches.items);
+}
+
+test "search should match steps across both players" {
+    const frames = [_]model.Frame{
+        testingFrame(.{ .button_1 = true }, .{}),
+        testingFrame(.{}, .{ .button_3 = true }),
+        testingFrame(.{ .button_1 = true }, .{}),
+        testingFrame(.{}, .{}),
+        testingFrame(.{}, .{}),
+        testingFrame(.{}, .{ .button_3 = true }),
+    };
+    var index = try InputIndex.init(testing.allocator, &frames);
+    defer index.deinit();
+
+    const query = InputQuery{ .steps = &.{
+        .{ .player_id = .player_1, .event = .button_1 },
+        .{ .player_id = .player_2, .event = .button_3, .min_offset = 1, .max_offset = 2 },
+    } };
+    var matches: std.ArrayList(InputMatch) = .empty;
+    defer matches.deinit(testing.allocator);
+    try index.search(testing.allocator, &query, &matches);
+
+    try testing.expectEqualSlices(InputMatch, &.{.{ .first_frame = 0, .last_frame = 1 }}, matches.items);
+}
@@ -0,0 +1,168 @@
+const std = @import("std");
+const build_info = @import("build_info");
+const sdk = @import("../../sdk/root.zig");
+const model = @import("../model/root.zig");
+
+// Always on capture of the last few seconds of live frames, so that something interesting can be kept after it
+// happened. Frames are stored packed inside a ring that gets allocated once, so capturing a frame never allocates and
+// the memory stays the same no matter how long the game runs. Kept replays get saved into new files inside the
+// directory, so they never touch the recording that is currently open.
+pub const InstantReplay = struct {
+    allocator: std.mem.Allocator,
+    ring: *Ring,
+    directory_buffer: [sdk.os.max_file_path_length]u8,
+    directory_len: usize,
+
+    const Self = @This();
+    pub const duration = 30;
+    pub const capacity = duration * 60;
+    pub const memory_size = @sizeOf(Ring);
+    const Ring = sdk.misc.CircularBuffer(capacity, model.PackedFrame);
+    const file_extension = "." ++ @tagName(build_info.name);
+    const max_files_per_second = 100;
+
+    pub fn init(allocator: std.mem.Allocator, directory_path: []const u8) !Self {
+        var directory_buffer: [sdk.os.max_file_path_length]u8 = undefined;
+        if (directory_path.len > directory_buffer.len) {
+            sdk.misc.error_context.new("Instant replay directory path is too long: {s}", .{directory_path});
+            return error.NameTooLong;
+        }
+        @memcpy(directory_buffer[0..directory_path.len], directory_path);
+        const ring = allocator.create(Ring) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate instant replay ring of {} bytes.", .{memory_size});
+            return err;
+        };
+        ring.* = .{};
+        return .{
+            .allocator = allocator,
+            .ring = ring,
+            .directory_buffer = directory_buffer,
+            .directory_len = directory_path.len,
+        };
+    }
+
+    pub fn deinit(self: *Self) void {
+        self.allocator.destroy(self.ring);
+    }
+
+    pub fn capture(self: *Self, frame: *const model.Frame) void {
+        self.ring.addOneToBack().* = .pack(frame);
+    }
+
+    pub fn clear(self: *Self) void {
+        self.ring.clear();
+    }
+
+    pub fn getLen(self: *const Self) usize {
+        return self.ring.len;
+    }
+
+    pub fn getDirectory(self: *const Self) []const u8 {
+        return self.directory_buffer[0..self.directory_len];
+    }
+
+    // Creates the directory when it's missing and returns the path of a file inside it that doesn't exist yet, named
+    // after the current local time. Replays kept within the same second get numbered instead of overwriting each other.
+    pub fn getNewFilePath(self: *const Self, buffer: *[sdk.os.max_file_path_length]u8) ![]const u8 {
+        const directory = self.getDirectory();
+        std.fs.cwd().makePath(directory) catch |err| {
+            sdk.misc.error_context.new("Failed to make directory: {s}", .{directory});
+            return err;
+        };
+        const nano = std.time.nanoTimestamp();
+        const ts = sdk.misc.Timestamp.fromNano(nano, .local) catch |err| {
+            sdk.misc.error_context.append("Failed to construct timestamp structure for nano timestamp: {}", .{nano});
+            return err;
+        };
+        var stem_buffer: [sdk.os.max_file_path_length]u8 = undefined;
+        const stem = std.fmt.bufPrint(
+            &stem_buffer,
+            "{s}" ++ std.fs.path.sep_str ++ "{:0>4}-{:0>2}-{:0>2} {:0>2}-{:0>2}-{:0>2} Replay",
+            .{ directory, @abs(ts.year), ts.month, ts.day, ts.hour, ts.minute, ts.second },
+        ) catch |err| {
+            sdk.misc.error_context.new("Failed to construct instant replay file name.", .{});
+            return err;
+        };
+        for (1..(max_files_per_second + 1)) |number| {
+            const path = if (number == 1)
+                std.fmt.bufPrint(buffer, "{s}" ++ file_extension, .{stem})
+            else
+                std.fmt.bufPrint(buffer, "{s} {}" ++ file_extension, .{ stem, number });
+            const file_path = path catch |err| {
+                sdk.misc.error_context.new("Failed to construct instant replay file path.", .{});
+                return err;
+            };
+            std.fs.cwd().access(file_path, .{}) catch |err| switch (err) {
+                error.FileNotFound => return file_path,
+                else => {
+                    sdk.misc.error_context.new("Failed to check if file exists: {s}", .{file_path});
+                    return err;
+                },
+            };
+        }
+        sdk.misc.error_context.new("Too many instant replays were kept within the same second: {s}", .{stem});
+        return error.PathAlreadyExists;
+    }
+
+    // Unpacks the captured frames, oldest first, into the destination that has to hold at least getLen frames.
+    pub fn unpackInto(self: *const Self, destination: []model.Frame) void {
+        std.debug.assert(destination.len >= self.ring.len);
+        for (destination[0..self.ring.len], 0..) |*frame, index| {
+            const packed_frame = self.ring.get(index) catch unreachable;
+            frame.* = packed_frame.unpack();
+        }
+    }
+};
+
+const testing = std.testing;
+
+test "should keep only the last capacity frames in the order they were captured" {
+    var replay = try InstantReplay.init(testing.allocator, "./test_assets");
+    defer replay.deinit();
+    for (0..InstantReplay.capacity + 10) |index| {
+        replay.capture(&.{ .frames_since_round_start = @intCast(index) });
+    }
+    try testing.expectEqual(InstantReplay.capacity, replay.getLen());
+    const frames = try testing.allocator.alloc(model.Frame, replay.getLen());
+    defer testing.allocator.free(frames);
+    replay.unpackInto(frames);
+    for (frames, 0..) |*frame, index| {
+        try testing.expectEqual(index + 10, frame.frames_since_round_start.?);
+    }
+}
+
+test "should unpack into the same frames that were captured" {
+    var replay = try InstantReplay.init(testing.allocator, "./test_assets");
+    defer replay.deinit();
+    const captured = [_]model.Frame{
+        .{ .floor_z = 1, .players = .{ .{ .health = 100, .input = .{ .button_1 = true } }, .{ .rage = .activated } } },
+        .{ .camera = .{ .position = .fromArray(.{ 1, 2, 3 }), .pitch = 4, .yaw = 5, .roll = 6 } },
+    };
+    for (&captured) |*frame| {
+        replay.capture(frame);
+    }
+    var unpacked: [2]model.Frame = undefined;
+    replay.unpackInto(&unpacked);
+    try testing.expectEqualDeep(captured, unpacked);
+
+    replay.clear();
+    try testing.expectEqual(0, replay.getLen());
+}
+
+test "getNewFilePath should number the files that would otherwise overwrite each other" {
+    var replay = try InstantReplay.init(testing.allocator, "./test_assets/instant_replay");
+    defer replay.deinit();
+    defer std.fs.cwd().deleteTree("./test_assets/instant_replay") catch @panic("Failed to cleanup test directory.");
+
+    var buffer_1: [sdk.os.max_file_path_length]u8 = undefined;
+    const path_1 = try replay.getNewFilePath(&buffer_1);
+    try testing.expect(std.mem.startsWith(u8, path_1, "./test_assets/instant_replay"));
+    try testing.expect(std.mem.endsWith(u8, path_1, " Replay" ++ InstantReplay.file_extension));
+    const file = try std.fs.cwd().createFile(path_1, .{});
+    file.close();
+
+    var buffer_2: [sdk.os.max_file_path_length]u8 = undefined;
+    const path_2 = try replay.getNewFilePath(&buffer_2);
+    try testing.expect(!std.mem.eql(u8, path_1, path_2));
+    try testing.expect(std.mem.endsWith(u8, path_2, InstantReplay.file_extension));
+}
@@ -0,0 +1,803 @@
+const std = @import("std");
+const sdk = @import("../../sdk/root.zig");
+const core = @import("../core/root.zig");
+const model = @import("../model/root.zig");
+
+pub const MoveKey = struct {
+    character_id: u32,
+    animation_id: u32,
+};
+
+pub const MoveOutcome = enum(u8) {
+    whiffed = 0,
+    blocked = 1,
+    hit = 2,
+};
+
+// Everything that got measured about a single performance of an attack.
+pub const MoveObservation = struct {
+    key: MoveKey,
+    outcome: MoveOutcome = .whiffed,
+    startup: ?u32 = null,
+    active: ?u32 = null,
+    attack_range: ?f32 = null,
+    recovery_range: ?f32 = null,
+    advantage: ?i32 = null,
+};
+
+// Number of times every value was observed. Values outside of the range get counted as the nearest value in range.
+pub fn Distribution(comptime min_value: i32, comptime max_value: i32) type {
+    return struct {
+        counts: [max_value - min_value + 1]u32 = [1]u32{0} ** (max_value - min_value + 1),
+        total: u32 = 0,
+
+        const Self = @This();
+        pub const min = min_value;
+        pub const max = max_value;
+
+        pub fn add(self: *Self, value: i32) void {
+            const clamped = std.math.clamp(value, min_value, max_value);
+            self.counts[@intCast(clamped - min_value)] += 1;
+            self.total += 1;
+        }
+
+        pub fn getMin(self: *const Self) ?i32 {
+            for (self.counts, 0..) |count, index| {
+                if (count > 0) {
+                    return min_value + @as(i32, @intCast(index));
+                }
+            }
+            return null;
+        }
+
+        pub fn getMax(self: *const Self) ?i32 {
+            var index = self.counts.len;
+            while (index > 0) {
+                index -= 1;
+                if (self.counts[index] > 0) {
+                    return min_value + @as(i32, @intCast(index));
+                }
+            }
+            return null;
+        }
+
+        // Most commonly observed value. Ties are resolved in favor of the smaller value.
+        pub fn getMode(self: *const Self) ?i32 {
+            if (self.total == 0) {
+                return null;
+            }
+            const index = std.mem.indexOfMax(u32, &self.counts);
+            return min_value + @as(i32, @intCast(index));
+        }
+
+        pub fn getMean(self: *const Self) ?f32 {
+            if (self.total == 0) {
+                return null;
+            }
+            var sum: i64 = 0;
+            for (self.counts, 0..) |count, index| {
+                sum += @as(i64, count) * (min_value + @as(i64, @intCast(index)));
+            }
+            return @as(f32, @floatFromInt(sum)) / @as(f32, @floatFromInt(self.total));
+        }
+    };
+}
+
+pub const RangeSummary = struct {
+    min: ?f32 = null,
+    max: ?f32 = null,
+    sum: f64 = 0,
+    count: u32 = 0,
+
+    const Self = @This();
+
+    pub fn add(self: *Self, value: f32) void {
+        self.min = if (self.min) |m| @min(m, value) else value;
+        self.max = if (self.max) |m| @max(m, value) else value;
+        self.sum += value;
+        self.count += 1;
+    }
+
+    pub fn getMean(self: *const Self) ?f32 {
+        if (self.count == 0) {
+            return null;
+        }
+        return @floatCast(self.sum / @as(f64, @floatFromInt(self.count)));
+    }
+};
+
+// Aggregate of all observations of a single move.
+pub const MoveStats = struct {
+    key: MoveKey,
+    number_of_whiffs: u32 = 0,
+    number_of_blocks: u32 = 0,
+    number_of_hits: u32 = 0,
+    startup: Distribution(0, 127) = .{},
+    active: Distribution(0, 127) = .{},
+    attack_range: RangeSummary = .{},
+    recovery_range: RangeSummary = .{},
+    advantage_on_block: Distribution(-64, 63) = .{},
+    advantage_on_hit: Distribution(-64, 63) = .{},
+
+    const Self = @This();
+
+    pub fn add(self: *Self, observation: *const MoveObservation) void {
+        switch (observation.outcome) {
+            .whiffed => self.number_of_whiffs += 1,
+            .blocked => self.number_of_blocks += 1,
+            .hit => self.number_of_hits += 1,
+        }
+        if (observation.startup) |value| self.startup.add(@intCast(@min(value, std.math.maxInt(i32))));
+        if (observation.active) |value| self.active.add(@intCast(@min(value, std.math.maxInt(i32))));
+        if (observation.attack_range) |value| self.attack_range.add(value);
+        if (observation.recovery_range) |value| self.recovery_range.add(value);
+        if (observation.advantage) |value| switch (observation.outcome) {
+            .whiffed => {},
+            .blocked => self.advantage_on_block.add(value),
+            .hit => self.advantage_on_hit.add(value),
+        };
+    }
+
+    pub fn getNumberOfObservations(self: *const Self) u32 {
+        return self.number_of_whiffs + self.number_of_blocks + self.number_of_hits;
+    }
+};
+
+// Statistics of every move ever seen in the ingested recordings, looked up by character and animation ID.
+// Observations are stored inside an append-only file as one block per recording. Opening the database replays the
+// file into an in-memory hash map, and ingesting a directory only decodes the recordings that are not in the file yet.
+pub const MoveDatabase = struct {
+    allocator: std.mem.Allocator,
+    file_path: []const u8,
+    valid_file_size: u64,
+    moves: std.AutoHashMapUnmanaged(MoveKey, MoveStats),
+    sources: std.AutoHashMapUnmanaged(SourceHash, void),
+
+    const Self = @This();
+    pub const file_name = "moves.db";
+    pub const SourceHash = u64;
+    const magic = "IRONYMOVES";
+    const version: u16 = 1;
+    const file_start_size = magic.len + @sizeOf(u16);
+    const block_header_size = @sizeOf(SourceHash) + @sizeOf(u32);
+    const observation_size = 1 + 1 + 4 * 7;
+    const endian = std.builtin.Endian.little;
+    const max_file_size = 1024 * 1024 * 1024;
+
+    pub const IngestSummary = struct {
+        number_of_files: usize = 0,
+        number_of_new_files: usize = 0,
+        number_of_failed_files: usize = 0,
+        number_of_observations: usize = 0,
+    };
+
+    // Opens the database stored at the path. A missing file is treated as an empty database.
+    // A block that got cut short, for example by a crash during appending, gets ignored and overwritten later.
+    pub fn open(allocator: std.mem.Allocator, file_path: []const u8) !Self {
+        const path_copy = allocator.dupe(u8, file_path) catch |err| {
+            sdk.misc.error_context.new("Failed to copy the database path.", .{});
+            return err;
+        };
+        var self = Self{
+            .allocator = allocator,
+            .file_path = path_copy,
+            .valid_file_size = 0,
+            .moves = .empty,
+            .sources = .empty,
+        };
+        errdefer self.deinit();
+
+        const data = std.fs.cwd().readFileAlloc(allocator, file_path, max_file_size) catch |err| switch (err) {
+            error.FileNotFound => return self,
+            else => {
+                sdk.misc.error_context.new("Failed to read file: {s}", .{file_path});
+                return err;
+            },
+        };
+        defer allocator.free(data);
+        if (data.len == 0) {
+            return self;
+        }
+        self.replay(data) catch |err| {
+            sdk.misc.error_context.append("Failed to replay move database: {s}", .{file_path});
+            return err;
+        };
+        return self;
+    }
+
+    pub fn deinit(self: *Self) void {
+        self.moves.deinit(self.allocator);
+        self.sources.deinit(self.allocator);
+        self.allocator.free(self.file_path);
+    }
+
+    pub fn get(self: *const Self, key: MoveKey) ?*const MoveStats {
+        return self.moves.getPtr(key);
+    }
+
+    pub fn containsSource(self: *const Self, source_hash: SourceHash) bool {
+        return self.sources.contains(source_hash);
+    }
+
+    // Writes the observations of a single source to the end of the file and adds them into the in-memory statistics.
+    pub fn append(self: *Self, source_hash: SourceHash, observations: []const MoveObservation) !void {
+        self.sources.ensureUnusedCapacity(self.allocator, 1) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate source lookup capacity.", .{});
+            return err;
+        };
+        self.moves.ensureUnusedCapacity(self.allocator, @intCast(observations.len)) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate move lookup capacity.", .{});
+            return err;
+        };
+        self.writeBlock(source_hash, observations) catch |err| {
+            sdk.misc.error_context.append("Failed to write observations block to: {s}", .{self.file_path});
+            return err;
+        };
+        self.sources.putAssumeCapacity(source_hash, {});
+        for (observations) |*observation| {
+            self.addAssumeCapacity(observation);
+        }
+    }
+
+    // Decodes every recording inside the directory that is not in the database yet and appends its observations.
+    // Recordings get decoded in parallel, while appending to the file happens from the calling thread in file order.
+    pub fn ingestDirectory(self: *Self, dir_path: []const u8, file_extension: []const u8) !IngestSummary {
+        var summary = IngestSummary{};
+        var jobs = self.collectIngestJobs(dir_path, file_extension, &summary) catch |err| {
+            sdk.misc.error_context.append("Failed to collect recordings to ingest from: {s}", .{dir_path});
+            return err;
+        };
+        defer {
+            for (jobs.items) |*job| {
+                job.deinit(self.allocator);
+            }
+            jobs.deinit(self.allocator);
+        }
+        summary.number_of_new_files = jobs.items.len;
+        runIngestJobs(self.allocator, jobs.items) catch |err| {
+            sdk.misc.error_context.append("Failed to run ingest jobs.", .{});
+            return err;
+        };
+        for (jobs.items) |*job| {
+            if (job.has_failed) {
+                summary.number_of_failed_files += 1;
+                continue;
+            }
+            self.append(job.source_hash, job.observations.items) catch |err| {
+                sdk.misc.error_context.append("Failed to append observations of: {s}", .{job.file_path});
+                return err;
+            };
+            summary.number_of_observations += job.observations.items.len;
+        }
+        return summary;
+    }
+
+    // Walks the frames of both players and produces an observation every time a player finishes performing an attack.
+    pub fn extractObservations(
+        allocator: std.mem.Allocator,
+        frames: []const model.Frame,
+        observations: *std.ArrayList(MoveObservation),
+    ) !void {
+        for (0..2) |player_index| {
+            var tracker: ?MoveTracker = null;
+            for (frames) |*frame| {
+                const player = &frame.players[player_index];
+                const other = &frame.players[1 - player_index];
+                if (tracker) |*t| {
+                    if (!t.isSameMove(player)) {
+                        try t.finish(allocator, observations);
+                        tracker = null;
+                    }
+                }
+                if (tracker == null) {
+                    tracker = MoveTracker.start(player);
+                }
+                if (tracker) |*t| {
+                    t.update(player, other);
+                }
+            }
+            if (tracker) |*t| {
+                try t.finish(allocator, observations);
+            }
+        }
+    }
+
+    fn addAssumeCapacity(self: *Self, observation: *const MoveObservation) void {
+        const entry = self.moves.getOrPutAssumeCapacity(observation.key);
+        if (!entry.found_existing) {
+            entry.value_ptr.* = .{ .key = observation.key };
+        }
+        entry.value_ptr.add(observation);
+    }
+
+    fn replay(self: *Self, data: []const u8) !void {
+        var reader = std.io.Reader.fixed(data);
+        const file_magic = reader.take(magic.len) catch |err| {
+            sdk.misc.error_context.new("Failed to read the magic bytes.", .{});
+            return err;
+        };
+        if (!std.mem.eql(u8, file_magic, magic)) {
+            sdk.misc.error_context.new("File is not a move database.", .{});
+            return error.InvalidMagic;
+        }
+        const file_version = reader.takeInt(u16, endian) catch |err| {
+            sdk.misc.error_context.new("Failed to read the version.", .{});
+            return err;
+        };
+        if (file_version != version) {
+            sdk.misc.error_context.new("Unsupported move database version: {}", .{file_version});
+            return error.UnsupportedVersion;
+        }
+        self.valid_file_size = file_start_size;
+        while (data.len - reader.seek >= block_header_size) {
+            const source_hash = reader.takeInt(SourceHash, endian) catch unreachable;
+            const number_of_observations = reader.takeInt(u32, endian) catch unreachable;
+            const block_size = @as(usize, number_of_observations) * observation_size;
+            if (data.len - reader.seek < block_size) {
+                break;
+            }
+            self.sources.put(self.allocator, source_hash, {}) catch |err| {
+                sdk.misc.error_context.new("Failed to put source into the lookup.", .{});
+                return err;
+            };
+            self.moves.ensureUnusedCapacity(self.allocator, number_of_observations) catch |err| {
+                sdk.misc.error_context.new("Failed to allocate move lookup capacity.", .{});
+                return err;
+            };
+            for (0..number_of_observations) |_| {
+                const observation = readObservation(&reader) catch |err| {
+                    sdk.misc.error_context.append("Failed to read observation.", .{});
+                    return err;
+                };
+                self.addAssumeCapacity(&observation);
+            }
+            self.valid_file_size = reader.seek;
+        }
+        if (self.valid_file_size != data.len) {
+            std.log.warn("Ignoring {} bytes of incomplete data at the end of: {s}", .{
+                data.len - self.valid_file_size,
+                self.file_path,
+            });
+        }
+    }
+
+    fn writeBlock(self: *Self, source_hash: SourceHash, observations: []const MoveObservation) !void {
+        const file = std.fs.cwd().createFile(self.file_path, .{ .read = true, .truncate = false }) catch |err| {
+            sdk.misc.error_context.new("Failed to create or open file: {s}", .{self.file_path});
+            return err;
+        };
+        defer file.close();
+        const start = self.valid_file_size;
+        file.setEndPos(start) catch |err| {
+            sdk.misc.error_context.new("Failed to cut the file at: {}", .{start});
+            return err;
+        };
+        var buffer: [4096]u8 = undefined;
+        var file_writer = file.writer(&buffer);
+        file_writer.seekTo(start) catch |err| {
+            sdk.misc.error_context.new("Failed to seek to: {}", .{start});
+            return err;
+        };
+        const writer = &file_writer.interface;
+        errdefer file.setEndPos(start) catch {};
+
+        if (start == 0) {
+            writer.writeAll(magic) catch |err| {
+                sdk.misc.error_context.new("Failed to write the magic bytes.", .{});
+                return err;
+            };
+            writer.writeInt(u16, version, endian) catch |err| {
+                sdk.misc.error_context.new("Failed to write the version.", .{});
+                return err;
+            };
+        }
+        writer.writeInt(SourceHash, source_hash, endian) catch |err| {
+            sdk.misc.error_context.new("Failed to write the source hash.", .{});
+            return err;
+        };
+        writer.writeInt(u32, @intCast(observations.len), endian) catch |err| {
+            sdk.misc.error_context.new("Failed to write the number of observations.", .{});
+            return err;
+        };
+        for (observations) |*observation| {
+            writeObservation(writer, observation) catch |err| {
+                sdk.misc.error_context.append("Failed to write observation.", .{});
+                return err;
+            };
+        }
+        writer.flush() catch |err| {
+            sdk.misc.error_context.new("Failed to flush the file writer.", .{});
+            return err;
+        };
+        const header_size: usize = if (start == 0) file_start_size else 0;
+        self.valid_file_size = start + header_size + block_header_size + observations.len * observation_size;
+    }
+
+    fn writeObservation(writer: *std.io.Writer, observation: *const MoveObservation) !void {
+        const flags: u8 = @as(u8, @intFromBool(observation.startup != null)) |
+            @as(u8, @intFromBool(observation.active != null)) << 1 |
+            @as(u8, @intFromBool(observation.attack_range != null)) << 2 |
+            @as(u8, @intFromBool(observation.recovery_range != null)) << 3 |
+            @as(u8, @intFromBool(observation.advantage != null)) << 4;
+        try writer.writeByte(flags);
+        try writer.writeByte(@intFromEnum(observation.outcome));
+        try writer.writeInt(u32, observation.key.character_id, endian);
+        try writer.writeInt(u32, observation.key.animation_id, endian);
+        try writer.writeInt(u32, observation.startup orelse 0, endian);
+        try writer.writeInt(u32, observation.active orelse 0, endian);
+        try writer.writeInt(u32, @bitCast(observation.attack_range orelse 0), endian);
+        try writer.writeInt(u32, @bitCast(observation.recovery_range orelse 0), endian);
+        try writer.writeInt(i32, observation.advantage orelse 0, endian);
+    }
+
+    fn readObservation(reader: *std.io.Reader) !MoveObservation {
+        const flags = try reader.takeByte();
+        const outcome = std.meta.intToEnum(MoveOutcome, try reader.takeByte()) catch |err| {
+            sdk.misc.error_context.new("Invalid move outcome.", .{});
+            return err;
+        };
+        const character_id = try reader.takeInt(u32, endian);
+        const animation_id = try reader.takeInt(u32, endian);
+        const startup = try reader.takeInt(u32, endian);
+        const active = try reader.takeInt(u32, endian);
+        const attack_range: f32 = @bitCast(try reader.takeInt(u32, endian));
+        const recovery_range: f32 = @bitCast(try reader.takeInt(u32, endian));
+        const advantage = try reader.takeInt(i32, endian);
+        return .{
+            .key = .{ .character_id = character_id, .animation_id = animation_id },
+            .outcome = outcome,
+            .startup = if (flags & 1 != 0) startup else null,
+            .active = if (flags & 2 != 0) active else null,
+            .attack_range = if (flags & 4 != 0) attack_range else null,
+            .recovery_range = if (flags & 8 != 0) recovery_range else null,
+            .advantage = if (flags & 16 != 0) advantage else null,
+        };
+    }
+
+    const IngestJob = struct {
+        file_path: [:0]const u8,
+        source_hash: SourceHash,
+        observations: std.ArrayList(MoveObservation) = .empty,
+        has_failed: bool = false,
+
+        fn deinit(self: *IngestJob, allocator: std.mem.Allocator) void {
+            allocator.free(self.file_path);
+            self.observations.deinit(allocator);
+        }
+    };
+
+    fn collectIngestJobs(
+        self: *const Self,
+        dir_path: []const u8,
+        file_extension: []const u8,
+        summary: *IngestSummary,
+    ) !std.ArrayList(IngestJob) {
+        var jobs: std.ArrayList(IngestJob) = .empty;
+        errdefer {
+            for (jobs.items) |*job| {
+                job.deinit(self.allocator);
+            }
+            jobs.deinit(self.allocator);
+        }
+        var dir = std.fs.cwd().openDir(dir_path, .{ .iterate = true }) catch |err| {
+            sdk.misc.error_context.new("Failed to open directory: {s}", .{dir_path});
+            return err;
+        };
+        defer dir.close();
+        var iterator = dir.iterate();
+        while (iterator.next() catch |err| {
+            sdk.misc.error_context.new("Failed to iterate directory: {s}", .{dir_path});
+            return err;
+        }) |entry| {
+            if (entry.kind != .file or !std.mem.endsWith(u8, entry.name, file_extension)) {
+                continue;
+            }
+            summary.number_of_files += 1;
+            const file_path = std.fs.path.joinZ(self.allocator, &.{ dir_path, entry.name }) catch |err| {
+                sdk.misc.error_context.new("Failed to construct path of recording: {s}", .{entry.name});
+                return err;
+            };
+            var job = IngestJob{ .file_path = file_path, .source_hash = undefined };
+            errdefer job.deinit(self.allocator);
+            job.source_hash = getSourceHash(file_path) catch |err| {
+                sdk.misc.error_context.append("Failed to identify recording: {s}", .{file_path});
+                sdk.misc.error_context.logWarning(err);
+                summary.number_of_failed_files += 1;
+                job.deinit(self.allocator);
+                continue;
+            };
+            if (self.containsSource(job.source_hash)) {
+                job.deinit(self.allocator);
+                continue;
+            }
+            jobs.append(self.allocator, job) catch |err| {
+                sdk.misc.error_context.new("Failed to append ingest job.", .{});
+                return err;
+            };
+        }
+        return jobs;
+    }
+
+    // Recordings that store a content hash are identified by it. Older recordings fall back to name, size and time.
+    fn getSourceHash(file_path: []const u8) !SourceHash {
+        const info = sdk.io.loadRecordingInfo(file_path) catch |err| {
+            sdk.misc.error_context.append("Failed to load recording info.", .{});
+            return err;
+        };
+        if (info.content_hash) |hash| {
+            return hash;
+        }
+        const stat = std.fs.cwd().statFile(file_path) catch |err| {
+            sdk.misc.error_context.new("Failed to stat file: {s}", .{file_path});
+            return err;
+        };
+        var hasher = std.hash.Wyhash.init(0);
+        hasher.update(std.fs.path.basename(file_path));
+        hasher.update(std.mem.asBytes(&stat.size));
+        hasher.update(std.mem.asBytes(&stat.mtime));
+        return hasher.final();
+    }
+
+    // Recordings get loaded on the default thread pool. A recording that fails only marks it's own job as failed.
+    fn runIngestJobs(allocator: std.mem.Allocator, jobs: []IngestJob) !void {
+        const Context = struct {
+            allocator: std.mem.Allocator,
+            jobs: []IngestJob,
+
+            fn processRange(context: *const @This(), start: usize, end: usize) void {
+                for (context.jobs[start..end]) |*job| {
+                    processJob(context.allocator, job) catch |err| {
+                        sdk.misc.error_context.append("Failed to ingest recording: {s}", .{job.file_path});
+                        sdk.misc.error_context.logWarning(err);
+                        job.has_failed = true;
+                    };
+                }
+            }
+        };
+        const pool = sdk.misc.ThreadPool.getDefault() catch |err| {
+            sdk.misc.error_context.append("Failed to get the default thread pool.", .{});
+            return err;
+        };
+        const context = Context{ .allocator = allocator, .jobs = jobs };
+        pool.parallelFor(allocator, jobs.len, &context, Context.processRange) catch |err| {
+            sdk.misc.error_context.append("Failed to process ingest jobs in parallel.", .{});
+            return err;
+        };
+    }
+
+    fn processJob(allocator: std.mem.Allocator, job: *IngestJob) !void {
+        const config = &core.Controller.serialization_config;
+        const frames = sdk.io.loadRecording(model.Frame, allocator, job.file_path, config) catch |err| {
+            sdk.misc.error_context.append("Failed to load recording.", .{});
+            return err;
+        };
+        defer allocator.free(frames);
+        extractObservations(allocator, frames, &job.observations) catch |err| {
+            sdk.misc.error_context.append("Failed to extract move observations.", .{});
+            return err;
+        };
+    }
+};
+
+// Follows a single player while the same animation keeps playing.
+const MoveTracker = struct {
+    key: MoveKey,
+    previous_animation_frame: ?u32,
+    is_attack: bool = false,
+    observation: MoveObservation,
+
+    const Self = @This();
+
+    fn start(player: *const model.Player) ?Self {
+        const key = MoveKey{
+            .character_id = player.character_id orelse return null,
+            .animation_id = player.animation_id orelse return null,
+        };
+        return .{
+            .key = key,
+            .previous_animation_frame = null,
+            .observation = .{ .key = key },
+        };
+    }
+
+    // Animation restarting from a lower frame means the same move got performed again.
+    fn isSameMove(self: *const Self, player: *const model.Player) bool {
+        if (player.character_id != self.key.character_id or player.animation_id != self.key.animation_id) {
+            return false;
+        }
+        const previous = self.previous_animation_frame orelse return true;
+        const current = player.animation_frame orelse return true;
+        return current >= previous;
+    }
+
+    fn update(self: *Self, player: *const model.Player, other: *const model.Player) void {
+        self.previous_animation_frame = player.animation_frame;
+        if (player.attack_type) |attack_type| {
+            self.is_attack = self.is_attack or attack_type != .not_attack;
+        }
+        const observation = &self.observation;
+        if (player.first_active_frame) |value| observation.startup = value;
+        if (player.getActiveFrames().max) |value| observation.active = value;
+        if (player.attack_range) |value| observation.attack_range = value;
+        if (player.recovery_range) |value| observation.recovery_range = value;
+        if (player.getFrameAdvantage(other).actual) |value| observation.advantage = value;
+        if (player.connected_frame != null and observation.outcome == .whiffed) {
+            observation.outcome = switch (other.hit_outcome orelse .none) {
+                .none => .whiffed,
+                .blocked_standing, .blocked_crouching => .blocked,
+                else => .hit,
+            };
+        }
+    }
+
+    fn finish(
+        self: *const Self,
+        allocator: std.mem.Allocator,
+        observations: *std.ArrayList(MoveObservation),
+    ) !void {
+        if (!self.is_attack) {
+            return;
+        }
+        observations.append(allocator, self.observation) catch |err| {
+            sdk.misc.error_context.new("Failed to append move observation.", .{});
+            return err;
+        };
+    }
+};
+
+const testing = std.testing;
+
+fn testingAttack(frames: []model.Frame, player_index: usize, animation_id: u32, outcome: model.HitOutcome) void {
+    for (frames, 1..) |*frame, animation_frame| {
+        const player = &frame.players[player_index];
+        const other = &frame.players[1 - player_index];
+        player.* = .{
+            .character_id = 7,
+            .animation_id = animation_id,
+            .animation_frame = @intCast(animation_frame),
+            .animation_total_frames = @intCast(frames.len),
+            .attack_type = .mid,
+            .first_active_frame = 3,
+            .last_active_frame = 4,
+            .connected_frame = if (animation_frame >= 3) 3 else null,
+            .attack_range = 2.5,
+            .recovery_range = 1.5,
+        };
+        other.* = .{
+            .character_id = 8,
+            .animation_id = 1,
+            .hit_outcome = if (animation_frame >= 3) outcome else .none,
+        };
+    }
+}
+
+test "Distribution should track min, max, mode and mean of added values" {
+    var distribution = Distribution(-2, 2){};
+    try testing.expectEqual(null, distribution.getMin());
+    try testing.expectEqual(null, distribution.getMode());
+    distribution.add(1);
+    distribution.add(1);
+    distribution.add(-1);
+    distribution.add(100);
+    try testing.expectEqual(-1, distribution.getMin());
+    try testing.expectEqual(2, distribution.getMax());
+    try testing.expectEqual(1, distribution.getMode());
+    try testing.expectEqual(0.75, distribution.getMean());
+}
+
+test "extractObservations should produce one observation per performed attack" {
+    var frames: [12]model.Frame = [1]model.Frame{.{}} ** 12;
+    testingAttack(frames[0..5], 0, 100, .blocked_standing);
+    testingAttack(frames[5..10], 0, 100, .normal_hit_standing);
+    testingAttack(frames[10..12], 1, 200, .none);
+    frames[10].players[1].attack_type = .not_attack;
+    frames[11].players[1].attack_type = .not_attack;
+
+    var observations: std.ArrayList(MoveObservation) = .empty;
+    defer observations.deinit(testing.allocator);
+    try MoveDatabase.extractObservations(testing.allocator, &frames, &observations);
+
+    try testing.expectEqual(2, observations.items.len);
+    for (observations.items) |*observation| {
+        try testing.expectEqual(MoveKey{ .character_id = 7, .animation_id = 100 }, observation.key);
+        try testing.expectEqual(3, observation.startup);
+        try testing.expectEqual(2, observation.active);
+        try testing.expectEqual(2.5, observation.attack_range);
+        try testing.expectEqual(1.5, observation.recovery_range);
+    }
+    try testing.expectEqual(.blocked, observations.items[0].outcome);
+    try testing.expectEqual(.hit, observations.items[1].outcome);
+}
+
+test "MoveDatabase should persist appended observations and aggregate them on open" {
+    const path = "./test_assets/move_database_test.db";
+    defer std.fs.cwd().deleteFile(path) catch @panic("Failed to cleanup test file.");
+    const key = MoveKey{ .character_id = 1, .animation_id = 2 };
+    const observations = [_]MoveObservation{
+        .{ .key = key, .outcome = .blocked, .startup = 10, .active = 2, .advantage = -12, .attack_range = 2 },
+        .{ .key = key, .outcome = .blocked, .startup = 10, .active = 2, .advantage = -10, .attack_range = 3 },
+        .{ .key = key, .outcome = .hit, .startup = 10, .active = 2, .advantage = 5 },
+        .{ .key = .{ .character_id = 1, .animation_id = 3 }, .startup = 15 },
+    };
+    {
+        var database = try MoveDatabase.open(testing.allocator, path);
+        defer database.deinit();
+        try database.append(123, observations[0..2]);
+        try database.append(456, observations[2..]);
+    }
+
+    var database = try MoveDatabase.open(testing.allocator, path);
+    defer database.deinit();
+    try testing.expect(database.containsSource(123));
+    try testing.expect(database.containsSource(456));
+    try testing.expect(!database.containsSource(789));
+    const stats = database.get(key) orelse return error.MoveNotFound;
+    try testing.expectEqual(3, stats.getNumberOfObservations());
+    try testing.expectEqual(2, stats.number_of_blocks);
+    try testing.expectEqual(1, stats.number_of_hits);
+    try testing.expectEqual(10, stats.startup.getMode());
+    try testing.expectEqual(-12, stats.advantage_on_block.getMin());
+    try testing.expectEqual(-10, stats.advantage_on_block.getMax());
+    try testing.expectEqual(5, stats.advantage_on_hit.getMode());
+    try testing.expectEqual(2.5, stats.attack_range.getMean());
+    try testing.expect(database.get(.{ .character_id = 1, .animation_id = 3 }) != null);
+    try testing.expectEqual(null, database.get(.{ .character_id = 9, .animation_id = 9 }));
+}
+
+test "MoveDatabase should ignore incomplete block at the end of the file and overwrite it" {
+    const path = "./test_assets/move_database_incomplete_test.db";
+    defer std.fs.cwd().deleteFile(path) catch @panic("Failed to cleanup test file.");
+    const key = MoveKey{ .character_id = 1, .animation_id = 2 };
+    {
+        var database = try MoveDatabase.open(testing.allocator, path);
+        defer database.deinit();
+        try database.append(1, &.{.{ .key = key, .startup = 10 }});
+        try database.append(2, &.{.{ .key = key, .startup = 11 }});
+    }
+    {
+        const file = try std.fs.cwd().openFile(path, .{ .mode = .read_write });
+        defer file.close();
+        try file.setEndPos(try file.getEndPos() - 5);
+    }
+    {
+        var database = try MoveDatabase.open(testing.allocator, path);
+        defer database.deinit();
+        try testing.expect(database.containsSource(1));
+        try testing.expect(!database.containsSource(2));
+        try database.append(3, &.{.{ .key = key, .startup = 12 }});
+    }
+
+    var database = try MoveDatabase.open(testing.allocator, path);
+    defer database.deinit();
+    try testing.expect(database.containsSource(1));
+    try testing.expect(!database.containsSource(2));
+    try testing.expect(database.containsSource(3));
+    try testing.expectEqual(2, database.get(key).?.getNumberOfObservations());
+}
+
+test "MoveDatabase.ingestDirectory should ingest only the recordings that are not in the database" {
+    const dir_path = "./test_assets/move_database_recordings";
+    try std.fs.cwd().makePath(dir_path);
+    defer std.fs.cwd().deleteTree(dir_path) catch @panic("Failed to cleanup test directory.");
+    const config = &core.Controller.serialization_config;
+    var frames: [5]model.Frame = [1]model.Frame{.{}} ** 5;
+    testingAttack(&frames, 0, 100, .blocked_standing);
+    try sdk.io.saveRecording(model.Frame, testing.allocator, &frames, dir_path ++ "/1.irony", config);
+    testingAttack(&frames, 0, 101, .normal_hit_standing);
+    try sdk.io.saveRecording(model.Frame, testing.allocator, &frames, dir_path ++ "/2.irony", config);
+
+    var database = try MoveDatabase.open(testing.allocator, dir_path ++ "/" ++ MoveDatabase.file_name);
+    defer database.deinit();
+    const summary_1 = try database.ingestDirectory(dir_path, ".irony");
+    try testing.expectEqual(2, summary_1.number_of_files);
+    try testing.expectEqual(2, summary_1.number_of_new_files);
+    try testing.expectEqual(0, summary_1.number_of_failed_files);
+    try testing.expectEqual(2, summary_1.number_of_observations);
+    try testing.expectEqual(1, database.get(.{ .character_id = 7, .animation_id = 100 }).?.number_of_blocks);
+    try testing.expectEqual(1, database.get(.{ .character_id = 7, .animation_id = 101 }).?.number_of_hits);
+
+    const summary_2 = try database.ingestDirectory(dir_path, ".irony");
+    try testing.expectEqual(2, summary_2.number_of_files);
+    try testing.expectEqual(0, summary_2.number_of_new_files);
+    try testing.expectEqual(1, database.get(.{ .character_id = 7, .animation_id = 100 }).?.getNumberOfObservations());
+}
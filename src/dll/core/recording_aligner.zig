@@ -0,0 +1,590 @@
+const std = @import("std");
+const sdk = @import("../../sdk/root.zig");
+const model = @import("../model/root.zig");
+
+pub const AlignmentConfig = struct {
+    // Compares only the first player of the pair inside the first recording to the second player of the pair inside the
+    // second recording. For example our player 1 to the pro's player 2. Compares both players when null.
+    players: ?[2]model.PlayerId = null,
+    // Number of consecutive equal frames that two recordings need to share before the frames are considered related.
+    seed_length: usize = 12,
+    // Sequences that repeat more often then this inside the second recording, like idling, are useless as seeds.
+    max_seed_occurrences: usize = 8,
+    // Number of previous anchors that every anchor is tried to be chained with.
+    max_chain_lookback: usize = 64,
+    // Longest stretch of frames between two anchors that still gets aligned frame by frame.
+    max_gap: usize = 600,
+    // Number of frames the alignment between two anchors is allowed to drift away from the straight line.
+    band_margin: usize = 16,
+};
+
+// Index of the corresponding frame inside the second recording for every frame of the first recording.
+// Frames get compared by the character, animation and move frame of the players. Sequences of frames that are equal in
+// both recordings serve as anchors. The longest chain of anchors that moves forward in both recordings gets picked and
+// the frames between the chained anchors get aligned by banded dynamic programming. Work grows linearly with the
+// length of recordings, which keeps aligning hour long recordings fast.
+pub const RecordingAlignment = struct {
+    allocator: std.mem.Allocator,
+    mapping: []const u32,
+    held_mapping: []const u32,
+
+    const Self = @This();
+    const unmatched = std.math.maxInt(u32);
+    const Anchor = struct {
+        first_start: usize,
+        second_start: usize,
+        len: usize,
+
+        fn getDiagonal(self: *const Anchor) i64 {
+            return @as(i64, @intCast(self.second_start)) - @as(i64, @intCast(self.first_start));
+        }
+    };
+
+    pub fn init(
+        allocator: std.mem.Allocator,
+        first: []const model.Frame,
+        second: []const model.Frame,
+        config: *const AlignmentConfig,
+    ) !Self {
+        if (first.len >= unmatched or second.len >= unmatched) {
+            sdk.misc.error_context.new("Too many frames to align: {} and {}", .{ first.len, second.len });
+            return error.TooManyFrames;
+        }
+        if (config.seed_length == 0) {
+            sdk.misc.error_context.new("Seed length has to be larger then zero.", .{});
+            return error.InvalidConfig;
+        }
+        const first_player = if (config.players) |players| players[0] else null;
+        const second_player = if (config.players) |players| players[1] else null;
+        const first_keys = getFrameKeys(allocator, first, first_player) catch |err| {
+            sdk.misc.error_context.append("Failed to get frame keys of the first recording.", .{});
+            return err;
+        };
+        defer allocator.free(first_keys);
+        const second_keys = getFrameKeys(allocator, second, second_player) catch |err| {
+            sdk.misc.error_context.append("Failed to get frame keys of the second recording.", .{});
+            return err;
+        };
+        defer allocator.free(second_keys);
+
+        const anchors = findAnchors(allocator, first_keys, second_keys, config) catch |err| {
+            sdk.misc.error_context.append("Failed to find anchors.", .{});
+            return err;
+        };
+        defer allocator.free(anchors);
+        const chain = chainAnchors(allocator, anchors, config) catch |err| {
+            sdk.misc.error_context.append("Failed to chain anchors.", .{});
+            return err;
+        };
+        defer allocator.free(chain);
+
+        const mapping = allocator.alloc(u32, first.len) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate mapping of {} frames.", .{first.len});
+            return err;
+        };
+        errdefer allocator.free(mapping);
+        @memset(mapping, unmatched);
+        fillMapping(allocator, first_keys, second_keys, chain, config, mapping) catch |err| {
+            sdk.misc.error_context.append("Failed to fill frame mapping.", .{});
+            return err;
+        };
+        const held_mapping = allocator.dupe(u32, mapping) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate held mapping of {} frames.", .{first.len});
+            return err;
+        };
+        for (1..held_mapping.len) |index| {
+            if (held_mapping[index] == unmatched) {
+                held_mapping[index] = held_mapping[index - 1];
+            }
+        }
+        return .{ .allocator = allocator, .mapping = mapping, .held_mapping = held_mapping };
+    }
+
+    pub fn deinit(self: *Self) void {
+        self.allocator.free(self.mapping);
+        self.allocator.free(self.held_mapping);
+    }
+
+    // Returns null when the frame has no corresponding frame inside the second recording.
+    pub fn getMatchedIndex(self: *const Self, first_index: usize) ?usize {
+        if (first_index >= self.mapping.len or self.mapping[first_index] == unmatched) {
+            return null;
+        }
+        return self.mapping[first_index];
+    }
+
+    // Unmatched frames hold the last matched frame before them, so the second recording waits while the first recording
+    // goes through frames that the second one doesn't have. Returns null when no frame up to this one is matched.
+    pub fn getCorrespondingIndex(self: *const Self, first_index: usize) ?usize {
+        if (self.held_mapping.len == 0) {
+            return null;
+        }
+        const index = self.held_mapping[@min(first_index, self.held_mapping.len - 1)];
+        return if (index != unmatched) index else null;
+    }
+
+    pub fn getNumberOfMatched(self: *const Self) usize {
+        var count: usize = 0;
+        for (self.mapping) |index| {
+            if (index != unmatched) {
+                count += 1;
+            }
+        }
+        return count;
+    }
+
+    fn getFrameKeys(allocator: std.mem.Allocator, frames: []const model.Frame, player_id: ?model.PlayerId) ![]u64 {
+        const keys = allocator.alloc(u64, frames.len) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate {} frame keys.", .{frames.len});
+            return err;
+        };
+        for (keys, frames) |*key, *frame| {
+            var hasher = std.hash.Wyhash.init(0);
+            if (player_id) |id| {
+                hashPlayer(&hasher, frame.getPlayerById(id));
+            } else for (&frame.players) |*player| {
+                hashPlayer(&hasher, player);
+            }
+            key.* = hasher.final();
+        }
+        return keys;
+    }
+
+    fn hashPlayer(hasher: *std.hash.Wyhash, player: *const model.Player) void {
+        const values = [3]u32{
+            player.character_id orelse unmatched,
+            player.animation_id orelse unmatched,
+            player.getMoveFrame() orelse unmatched,
+        };
+        hasher.update(std.mem.asBytes(&values));
+    }
+
+    // Finds every sequence of seed length frames that appears in both recordings and merges overlapping sequences that
+    // lie on the same diagonal into anchors. Returns anchors sorted by their start in the first recording.
+    fn findAnchors(
+        allocator: std.mem.Allocator,
+        first_keys: []const u64,
+        second_keys: []const u64,
+        config: *const AlignmentConfig,
+    ) ![]Anchor {
+        const seed_length = config.seed_length;
+        if (first_keys.len < seed_length or second_keys.len < seed_length) {
+            return allocator.alloc(Anchor, 0);
+        }
+        const SeedPosition = struct { hash: u64, position: usize };
+        const second_hashes = getSeedHashes(allocator, second_keys, seed_length) catch |err| {
+            sdk.misc.error_context.append("Failed to hash seeds of the second recording.", .{});
+            return err;
+        };
+        defer allocator.free(second_hashes);
+        const second_seeds = allocator.alloc(SeedPosition, second_hashes.len) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate {} seed positions.", .{second_hashes.len});
+            return err;
+        };
+        defer allocator.free(second_seeds);
+        for (second_seeds, second_hashes, 0..) |*seed, hash, position| {
+            seed.* = .{ .hash = hash, .position = position };
+        }
+        std.sort.pdq(SeedPosition, second_seeds, {}, struct {
+            fn call(_: void, a: SeedPosition, b: SeedPosition) bool {
+                return a.hash < b.hash or (a.hash == b.hash and a.position < b.position);
+            }
+        }.call);
+
+        const first_hashes = getSeedHashes(allocator, first_keys, seed_length) catch |err| {
+            sdk.misc.error_context.append("Failed to hash seeds of the first recording.", .{});
+            return err;
+        };
+        defer allocator.free(first_hashes);
+        var seeds: std.ArrayList(Anchor) = .empty;
+        defer seeds.deinit(allocator);
+        for (first_hashes, 0..) |hash, first_position| {
+            var low: usize = 0;
+            var high: usize = second_seeds.len;
+            while (low < high) {
+                const middle = low + (high - low) / 2;
+                if (second_seeds[middle].hash < hash) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            var end = low;
+            while (end < second_seeds.len and second_seeds[end].hash == hash) : (end += 1) {}
+            if (end - low > config.max_seed_occurrences) {
+                continue;
+            }
+            const first_seed = first_keys[first_position..][0..seed_length];
+            for (second_seeds[low..end]) |*seed| {
+                // Equal hashes of different sequences are possible, so the frames get compared too.
+                if (!std.mem.eql(u64, first_seed, second_keys[seed.position..][0..seed_length])) {
+                    continue;
+                }
+                seeds.append(allocator, .{
+                    .first_start = first_position,
+                    .second_start = seed.position,
+                    .len = seed_length,
+                }) catch |err| {
+                    sdk.misc.error_context.new("Failed to append seed.", .{});
+                    return err;
+                };
+            }
+        }
+
+        std.sort.pdq(Anchor, seeds.items, {}, struct {
+            fn call(_: void, a: Anchor, b: Anchor) bool {
+                const diagonal_a = a.getDiagonal();
+                const diagonal_b = b.getDiagonal();
+                return diagonal_a < diagonal_b or (diagonal_a == diagonal_b and a.first_start < b.first_start);
+            }
+        }.call);
+        var anchors: std.ArrayList(Anchor) = .empty;
+        defer anchors.deinit(allocator);
+        for (seeds.items) |*seed| {
+            if (anchors.items.len > 0) {
+                const last = &anchors.items[anchors.items.len - 1];
+                if (last.getDiagonal() == seed.getDiagonal() and seed.first_start <= last.first_start + last.len) {
+                    last.len = @max(last.len, seed.first_start + seed.len - last.first_start);
+                    continue;
+                }
+            }
+            anchors.append(allocator, seed.*) catch |err| {
+                sdk.misc.error_context.new("Failed to append anchor.", .{});
+                return err;
+            };
+        }
+        std.sort.pdq(Anchor, anchors.items, {}, struct {
+            fn call(_: void, a: Anchor, b: Anchor) bool {
+                return a.first_start < b.first_start or
+                    (a.first_start == b.first_start and a.second_start < b.second_start);
+            }
+        }.call);
+        return anchors.toOwnedSlice(allocator) catch |err| {
+            sdk.misc.error_context.new("Failed to convert anchors to owned slice.", .{});
+            return err;
+        };
+    }
+
+    // Polynomial rolling hash of every sequence of seed length keys.
+    fn getSeedHashes(allocator: std.mem.Allocator, keys: []const u64, seed_length: usize) ![]u64 {
+        const base: u64 = 0x100000001B3;
+        const hashes = allocator.alloc(u64, keys.len - seed_length + 1) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate {} seed hashes.", .{keys.len - seed_length + 1});
+            return err;
+        };
+        var top_power: u64 = 1;
+        var hash: u64 = 0;
+        for (keys[0..seed_length], 0..) |key, index| {
+            hash = hash *% base +% key;
+            if (index > 0) {
+                top_power *%= base;
+            }
+        }
+        hashes[0] = hash;
+        for (1..hashes.len) |start| {
+            hash = (hash -% keys[start - 1] *% top_power) *% base +% keys[start + seed_length - 1];
+            hashes[start] = hash;
+        }
+        return hashes;
+    }
+
+    // Picks the chain of anchors that moves forward in both recordings and covers the most frames. Jumps between
+    // diagonals cost as many frames as the recordings drift apart, up to a limit, so that a chain can survive a long
+    // insertion. Returns the chain in order.
+    fn chainAnchors(allocator: std.mem.Allocator, anchors: []const Anchor, config: *const AlignmentConfig) ![]Anchor {
+        if (anchors.len == 0) {
+            return allocator.alloc(Anchor, 0);
+        }
+        const scores = allocator.alloc(i64, anchors.len) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate {} chain scores.", .{anchors.len});
+            return err;
+        };
+        defer allocator.free(scores);
+        const previous = allocator.alloc(?usize, anchors.len) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate {} chain links.", .{anchors.len});
+            return err;
+        };
+        defer allocator.free(previous);
+        const max_penalty: u64 = 2 * config.seed_length;
+
+        var best_index: usize = 0;
+        for (anchors, 0..) |*anchor, index| {
+            scores[index] = @intCast(anchor.len);
+            previous[index] = null;
+            for ((index -| config.max_chain_lookback)..index) |other_index| {
+                const other = &anchors[other_index];
+                if (other.first_start >= anchor.first_start or other.second_start >= anchor.second_start) {
+                    continue;
+                }
+                const first_overlap = (other.first_start + other.len) -| anchor.first_start;
+                const second_overlap = (other.second_start + other.len) -| anchor.second_start;
+                const overlap = @max(first_overlap, second_overlap);
+                if (overlap >= anchor.len) {
+                    continue;
+                }
+                const gain: i64 = @intCast(anchor.len - overlap);
+                const penalty = @min(@abs(anchor.getDiagonal() - other.getDiagonal()), max_penalty);
+                const score = scores[other_index] + gain - @as(i64, @intCast(penalty));
+                if (score > scores[index]) {
+                    scores[index] = score;
+                    previous[index] = other_index;
+                }
+            }
+            if (scores[index] > scores[best_index]) {
+                best_index = index;
+            }
+        }
+
+        var chain: std.ArrayList(Anchor) = .empty;
+        defer chain.deinit(allocator);
+        var maybe_index: ?usize = best_index;
+        while (maybe_index) |index| : (maybe_index = previous[index]) {
+            chain.append(allocator, anchors[index]) catch |err| {
+                sdk.misc.error_context.new("Failed to append anchor to the chain.", .{});
+                return err;
+            };
+        }
+        std.mem.reverse(Anchor, chain.items);
+        return chain.toOwnedSlice(allocator) catch |err| {
+            sdk.misc.error_context.new("Failed to convert chain to owned slice.", .{});
+            return err;
+        };
+    }
+
+    fn fillMapping(
+        allocator: std.mem.Allocator,
+        first_keys: []const u64,
+        second_keys: []const u64,
+        chain: []const Anchor,
+        config: *const AlignmentConfig,
+        mapping: []u32,
+    ) !void {
+        var first_end: usize = 0;
+        var second_end: usize = 0;
+        for (chain, 0..) |*anchor, anchor_index| {
+            // Chained anchors can overlap, in which case the overlapping frames are already mapped.
+            const skip = @max(first_end -| anchor.first_start, second_end -| anchor.second_start);
+            if (skip >= anchor.len) {
+                continue;
+            }
+            const first_start = anchor.first_start + skip;
+            const second_start = anchor.second_start + skip;
+            const first_gap = first_start - first_end;
+            const second_gap = second_start - second_end;
+            const is_gap_aligned = anchor_index > 0 and
+                first_gap > 0 and second_gap > 0 and
+                first_gap <= config.max_gap and second_gap <= config.max_gap;
+            if (is_gap_aligned) {
+                alignGap(
+                    allocator,
+                    first_keys[first_end..first_start],
+                    second_keys[second_end..second_start],
+                    first_end,
+                    second_end,
+                    config.band_margin,
+                    mapping,
+                ) catch |err| {
+                    sdk.misc.error_context.append("Failed to align frames between anchors.", .{});
+                    return err;
+                };
+            }
+            for (0..(anchor.len - skip)) |offset| {
+                mapping[first_start + offset] = @intCast(second_start + offset);
+            }
+            first_end = first_start + anchor.len - skip;
+            second_end = second_start + anchor.len - skip;
+        }
+    }
+
+    // Global alignment of two short stretches of frames that scores equal frames as +1 and unequal frames and skipped
+    // frames as -1. Only cells close to the straight line between the corners of the table are computed.
+    fn alignGap(
+        allocator: std.mem.Allocator,
+        first_keys: []const u64,
+        second_keys: []const u64,
+        first_offset: usize,
+        second_offset: usize,
+        band_margin: usize,
+        mapping: []u32,
+    ) !void {
+        const Direction = enum(u8) { diagonal, up, left };
+        const min_score = std.math.minInt(i32) / 2;
+        const first_len = first_keys.len;
+        const second_len = second_keys.len;
+        const half_width = band_margin + std.math.divCeil(usize, second_len, first_len) catch unreachable;
+        const width = 2 * half_width + 1;
+        const Band = struct {
+            first_len: usize,
+            second_len: usize,
+            half_width: usize,
+
+            fn getStart(self: *const @This(), row: usize) usize {
+                return (row * self.second_len / self.first_len) -| self.half_width;
+            }
+
+            fn getEnd(self: *const @This(), row: usize) usize {
+                return @min(row * self.second_len / self.first_len + self.half_width, self.second_len);
+            }
+        };
+        const band = Band{ .first_len = first_len, .second_len = second_len, .half_width = half_width };
+
+        const directions = allocator.alloc(Direction, (first_len + 1) * width) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate alignment table of {}x{} cells.", .{ first_len + 1, width });
+            return err;
+        };
+        defer allocator.free(directions);
+        const scores = allocator.alloc(i32, 2 * width) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate {} alignment scores.", .{2 * width});
+            return err;
+        };
+        defer allocator.free(scores);
+        var previous_row = scores[0..width];
+        var current_row = scores[width..];
+
+        for (0..(first_len + 1)) |row| {
+            const start = band.getStart(row);
+            const end = band.getEnd(row);
+            const previous_start = if (row > 0) band.getStart(row - 1) else 0;
+            const previous_end = if (row > 0) band.getEnd(row - 1) else 0;
+            @memset(current_row, min_score);
+            for (start..(end + 1)) |column| {
+                const cell = column - start;
+                if (row == 0 and column == 0) {
+                    current_row[cell] = 0;
+                    directions[cell] = .diagonal;
+                    continue;
+                }
+                var best_score: i32 = min_score;
+                var best_direction = Direction.left;
+                const has_diagonal = row > 0 and column > 0 and
+                    column - 1 >= previous_start and column - 1 <= previous_end;
+                if (has_diagonal) {
+                    const is_equal = first_keys[row - 1] == second_keys[column - 1];
+                    const score = previous_row[column - 1 - previous_start] + @as(i32, if (is_equal) 1 else -1);
+                    if (score > best_score) {
+                        best_score = score;
+                        best_direction = .diagonal;
+                    }
+                }
+                if (row > 0 and column >= previous_start and column <= previous_end) {
+                    const score = previous_row[column - previous_start] - 1;
+                    if (score > best_score) {
+                        best_score = score;
+                        best_direction = .up;
+                    }
+                }
+                if (column > start) {
+                    const score = current_row[cell - 1] - 1;
+                    if (score > best_score) {
+                        best_score = score;
+                        best_direction = .left;
+                    }
+                }
+                current_row[cell] = best_score;
+                directions[row * width + cell] = best_direction;
+            }
+            std.mem.swap([]i32, &previous_row, &current_row);
+        }
+
+        var row = first_len;
+        var column = second_len;
+        while (row > 0 and column > 0) {
+            switch (directions[row * width + column - band.getStart(row)]) {
+                .diagonal => {
+                    mapping[first_offset + row - 1] = @intCast(second_offset + column - 1);
+                    row -= 1;
+                    column -= 1;
+                },
+                .up => row -= 1,
+                .left => column -= 1,
+            }
+        }
+    }
+};
+
+const testing = std.testing;
+
+fn getTestFrames(allocator: std.mem.Allocator, animations: []const u32) ![]model.Frame {
+    const frames = try allocator.alloc(model.Frame, animations.len * 10);
+    for (animations, 0..) |animation_id, animation_index| {
+        for (0..10) |move_frame| {
+            const frame = &frames[animation_index * 10 + move_frame];
+            frame.* = .{};
+            frame.players[0] = .{
+                .character_id = 1,
+                .animation_id = animation_id,
+                .animation_frame = @intCast(move_frame),
+                .animation_to_move_delta = 0,
+            };
+            frame.players[1] = .{ .character_id = 2, .animation_id = 100 + animation_id };
+        }
+    }
+    return frames;
+}
+
+test "RecordingAlignment should map equal parts of recordings onto each other" {
+    const first = try getTestFrames(testing.allocator, &.{ 1, 2, 3, 4, 5, 6, 7, 8 });
+    defer testing.allocator.free(first);
+    const second = try getTestFrames(testing.allocator, &.{ 9, 9, 1, 2, 3, 4, 5, 6, 7, 8 });
+    defer testing.allocator.free(second);
+
+    var alignment = try RecordingAlignment.init(testing.allocator, first, second, &.{});
+    defer alignment.deinit();
+    for (0..first.len) |index| {
+        try testing.expectEqual(index + 20, alignment.getMatchedIndex(index));
+    }
+    try testing.expectEqual(first.len, alignment.getNumberOfMatched());
+}
+
+test "RecordingAlignment should align frames between anchors and skip inserted frames" {
+    const first = try getTestFrames(testing.allocator, &.{ 1, 2, 3, 4, 10, 5, 6, 7, 8 });
+    defer testing.allocator.free(first);
+    const second = try getTestFrames(testing.allocator, &.{ 1, 2, 3, 4, 5, 6, 7, 8 });
+    defer testing.allocator.free(second);
+
+    var alignment = try RecordingAlignment.init(testing.allocator, first, second, &.{});
+    defer alignment.deinit();
+    for (0..40) |index| {
+        try testing.expectEqual(index, alignment.getMatchedIndex(index));
+    }
+    for (50..90) |index| {
+        try testing.expectEqual(index - 10, alignment.getMatchedIndex(index));
+    }
+    try testing.expectEqual(null, alignment.getMatchedIndex(45));
+    try testing.expectEqual(39, alignment.getCorrespondingIndex(45));
+}
+
+test "RecordingAlignment should map frames that differ between anchors onto each other" {
+    const first = try getTestFrames(testing.allocator, &.{ 1, 2, 3, 4, 10, 6, 7, 8 });
+    defer testing.allocator.free(first);
+    const second = try getTestFrames(testing.allocator, &.{ 1, 2, 3, 4, 5, 6, 7, 8 });
+    defer testing.allocator.free(second);
+
+    var alignment = try RecordingAlignment.init(testing.allocator, first, second, &.{});
+    defer alignment.deinit();
+    for (0..first.len) |index| {
+        try testing.expectEqual(index, alignment.getMatchedIndex(index));
+    }
+}
+
+test "RecordingAlignment should compare only the selected players when players are given" {
+    const first = try getTestFrames(testing.allocator, &.{ 1, 2, 3, 4 });
+    defer testing.allocator.free(first);
+    const second = try getTestFrames(testing.allocator, &.{ 1, 2, 3, 4 });
+    defer testing.allocator.free(second);
+    for (second) |*frame| {
+        std.mem.swap(model.Player, &frame.players[0], &frame.players[1]);
+    }
+
+    var unaligned = try RecordingAlignment.init(testing.allocator, first, second, &.{});
+    defer unaligned.deinit();
+    try testing.expectEqual(0, unaligned.getNumberOfMatched());
+    try testing.expectEqual(null, unaligned.getCorrespondingIndex(20));
+
+    var aligned = try RecordingAlignment.init(testing.allocator, first, second, &.{
+        .players = .{ .player_1, .player_2 },
+    });
+    defer aligned.deinit();
+    try testing.expectEqual(first.len, aligned.getNumberOfMatched());
+    try testing.expectEqual(20, aligned.getMatchedIndex(20));
+}
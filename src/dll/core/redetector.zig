@@ -0,0 +1,294 @@
+const std = @import("std");
+const sdk = @import("../../sdk/root.zig");
+const core = @import("../core/root.zig");
+const model = @import("../model/root.zig");
+
+// State that the detectors carry from one frame to the next. Running the same frames from the same state always
+// produces the same frames, which is what makes checking chunk boundaries enough to prove a parallel run correct.
+pub const Detectors = struct {
+    hit_detector: core.HitDetector = .{},
+    move_detector: core.MoveDetector = .{},
+    move_measurer: core.MoveMeasurer = .{},
+
+    const Self = @This();
+
+    pub fn process(self: *Self, frame: *model.Frame) void {
+        clearDetection(frame);
+        self.hit_detector.detect(frame);
+        self.move_detector.detect(frame);
+        self.move_measurer.measure(frame);
+    }
+
+    pub fn eql(self: *const Self, other: *const Self) bool {
+        return areBitwiseEqual(self.*, other.*);
+    }
+};
+
+pub const RedetectionConfig = struct {
+    chunk_size: usize = 4096,
+    // Frames before each chunk that are used only to bring the chunk's detector state up to speed.
+    warm_up_frames: usize = 600,
+};
+
+pub const RedetectionStats = struct {
+    number_of_chunks: usize = 0,
+    // Chunks whose warmed up state didn't match the state that the previous chunk ended with.
+    number_of_serial_chunks: usize = 0,
+};
+
+// Runs the detectors over the recording again, replacing everything that was detected before.
+pub fn redetect(frames: []model.Frame) void {
+    var detectors = Detectors{};
+    for (frames) |*frame| {
+        detectors.process(frame);
+    }
+}
+
+// Same result as redetect, bit for bit, but the recording gets split into chunks that are detected in parallel. Each
+// chunk warms it's state up on the frames before it. If the warmed up state turns out different from the state that the
+// previous chunk ended with, the chunk gets detected again serially, starting from the correct state.
+pub fn redetectParallel(
+    allocator: std.mem.Allocator,
+    pool: *sdk.misc.ThreadPool,
+    frames: []model.Frame,
+    config: RedetectionConfig,
+) !RedetectionStats {
+    const chunk_size = @max(config.chunk_size, 1);
+    const number_of_chunks = std.math.divCeil(usize, frames.len, chunk_size) catch unreachable;
+    if (number_of_chunks <= 1) {
+        redetect(frames);
+        return .{ .number_of_chunks = number_of_chunks };
+    }
+    const chunks = allocator.alloc(Chunk, number_of_chunks) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate {} chunks.", .{number_of_chunks});
+        return err;
+    };
+    defer allocator.free(chunks);
+    const context = ChunkContext{
+        .frames = frames,
+        .chunks = chunks,
+        .chunk_size = chunk_size,
+        .warm_up_frames = config.warm_up_frames,
+    };
+    // Warming up reads frames of other chunks, so it has to finish before any chunk starts writing into it's frames.
+    pool.parallelFor(allocator, number_of_chunks, &context, ChunkContext.warmUpRange) catch |err| {
+        sdk.misc.error_context.append("Failed to warm up chunks in parallel.", .{});
+        return err;
+    };
+    pool.parallelFor(allocator, number_of_chunks, &context, ChunkContext.detectRange) catch |err| {
+        sdk.misc.error_context.append("Failed to detect chunks in parallel.", .{});
+        return err;
+    };
+
+    var stats = RedetectionStats{ .number_of_chunks = number_of_chunks };
+    var expected = chunks[0].end_state;
+    for (chunks[1..], 1..) |*chunk, index| {
+        if (chunk.start_state.eql(&expected)) {
+            expected = chunk.end_state;
+            continue;
+        }
+        const start = index * chunk_size;
+        const end = @min(start + chunk_size, frames.len);
+        for (frames[start..end]) |*frame| {
+            expected.process(frame);
+        }
+        stats.number_of_serial_chunks += 1;
+    }
+    return stats;
+}
+
+const Chunk = struct {
+    start_state: Detectors,
+    end_state: Detectors,
+};
+
+const ChunkContext = struct {
+    frames: []model.Frame,
+    chunks: []Chunk,
+    chunk_size: usize,
+    warm_up_frames: usize,
+
+    fn warmUpRange(self: *const ChunkContext, start_index: usize, end_index: usize) void {
+        for (start_index..end_index) |index| {
+            const start = index * self.chunk_size;
+            var detectors = Detectors{};
+            for (self.frames[start -| self.warm_up_frames..start]) |*frame| {
+                var copy = frame.*;
+                detectors.process(&copy);
+            }
+            self.chunks[index].start_state = detectors;
+        }
+    }
+
+    fn detectRange(self: *const ChunkContext, start_index: usize, end_index: usize) void {
+        for (start_index..end_index) |index| {
+            const start = index * self.chunk_size;
+            const end = @min(start + self.chunk_size, self.frames.len);
+            var detectors = self.chunks[index].start_state;
+            for (self.frames[start..end]) |*frame| {
+                detectors.process(frame);
+            }
+            self.chunks[index].end_state = detectors;
+        }
+    }
+};
+
+// Resets everything the detectors write, so detecting a frame that was already detected gives the same result.
+fn clearDetection(frame: *model.Frame) void {
+    for (&frame.players) |*player| {
+        player.move_phase = null;
+        player.animation_to_move_delta = null;
+        player.first_active_frame = null;
+        player.last_active_frame = null;
+        player.connected_frame = null;
+        player.min_attack_z = null;
+        player.max_attack_z = null;
+        player.attack_range = null;
+        player.recovery_range = null;
+        for (player.hit_lines.asMutableSlice()) |*line| {
+            line.flags = .{};
+        }
+        if (player.hurt_cylinders) |*cylinders| {
+            for (&cylinders.values) |*cylinder| {
+                cylinder.flags = .{};
+            }
+        }
+    }
+}
+
+// Floats get compared by their bits, because -0 and 0 are equal but can still end up producing different frames.
+// Padding doesn't take part in the comparison.
+fn areBitwiseEqual(a: anytype, b: @TypeOf(a)) bool {
+    const Type = @TypeOf(a);
+    switch (@typeInfo(Type)) {
+        .@"struct" => |info| {
+            if (info.layout == .@"packed") {
+                return @as(info.backing_integer.?, @bitCast(a)) == @as(info.backing_integer.?, @bitCast(b));
+            }
+            inline for (info.fields) |*field| {
+                if (!areBitwiseEqual(@field(a, field.name), @field(b, field.name))) {
+                    return false;
+                }
+            }
+            return true;
+        },
+        .optional => {
+            if (a == null or b == null) {
+                return a == null and b == null;
+            }
+            return areBitwiseEqual(a.?, b.?);
+        },
+        .array => {
+            for (a, b) |a_element, b_element| {
+                if (!areBitwiseEqual(a_element, b_element)) {
+                    return false;
+                }
+            }
+            return true;
+        },
+        .float => |info| {
+            const Bits = std.meta.Int(.unsigned, info.bits);
+            return @as(Bits, @bitCast(a)) == @as(Bits, @bitCast(b));
+        },
+        .int, .bool, .@"enum" => return a == b,
+        else => @compileError("Unsupported type: " ++ @typeName(Type)),
+    }
+}
+
+const testing = std.testing;
+
+fn getTestFrames(len: usize) ![]model.Frame {
+    const frames = try testing.allocator.alloc(model.Frame, len);
+    for (frames, 0..) |*frame, index| {
+        const animation_frame: u32 = @intCast(index % 37 + 1);
+        const position: f32 = @floatFromInt(index % 53);
+        frame.* = .{ .players = .{
+            .{
+                .animation_id = @intCast(index / 37),
+                .animation_frame = animation_frame,
+                .animation_total_frames = 37,
+                .attack_type = if ((index / 37) % 3 == 0) .not_attack else .mid,
+                .can_move = animation_frame > 30,
+                .rotation = 0,
+                .collision_spheres = .initFill(.{ .center = .fromArray(.{ position, 0, 0 }), .radius = 0 }),
+                .hurt_cylinders = .initFill(.{
+                    .cylinder = .{ .center = .fromArray(.{ position, 0, 1 }), .radius = 1, .half_height = 1 },
+                }),
+            },
+            .{
+                .animation_id = @intCast(index / 41),
+                .animation_frame = @intCast(index % 41 + 1),
+                .animation_total_frames = 41,
+                .attack_type = .not_attack,
+                .can_move = true,
+                .rotation = std.math.pi,
+                .collision_spheres = .initFill(.{ .center = .fromArray(.{ position + 2, 0, 0 }), .radius = 0 }),
+                .hurt_cylinders = .initFill(.{
+                    .cylinder = .{ .center = .fromArray(.{ position + 2, 0, 1 }), .radius = 1, .half_height = 1 },
+                }),
+                .hit_outcome = if (animation_frame == 12) .normal_hit_standing else .none,
+            },
+        } };
+        if (animation_frame >= 10 and animation_frame < 13) {
+            frame.players[0].hit_lines.buffer[0] = .{ .line = .{
+                .point_1 = .fromArray(.{ position, 0, 1 }),
+                .point_2 = .fromArray(.{ position + 3, 0, 1 }),
+            } };
+            frame.players[0].hit_lines.len = 1;
+        }
+    }
+    return frames;
+}
+
+test "redetect should give the same frames when detecting already detected frames" {
+    const expected = try getTestFrames(300);
+    defer testing.allocator.free(expected);
+    redetect(expected);
+    const actual = try testing.allocator.dupe(model.Frame, expected);
+    defer testing.allocator.free(actual);
+    redetect(actual);
+    try testing.expectEqualSlices(model.Frame, expected, actual);
+}
+
+test "redetectParallel should give the same frames as redetect" {
+    var pool: sdk.misc.ThreadPool = undefined;
+    try pool.init(testing.allocator, .{ .number_of_threads = 4 });
+    defer pool.deinit();
+
+    const expected = try getTestFrames(1000);
+    defer testing.allocator.free(expected);
+    redetect(expected);
+    const actual = try getTestFrames(1000);
+    defer testing.allocator.free(actual);
+    const stats = try redetectParallel(testing.allocator, &pool, actual, .{ .chunk_size = 64, .warm_up_frames = 100 });
+    try testing.expectEqual(16, stats.number_of_chunks);
+    try testing.expectEqual(0, stats.number_of_serial_chunks);
+    try testing.expectEqualSlices(model.Frame, expected, actual);
+}
+
+test "redetectParallel should fall back to serial detection when chunk state doesn't converge" {
+    var pool: sdk.misc.ThreadPool = undefined;
+    try pool.init(testing.allocator, .{ .number_of_threads = 4 });
+    defer pool.deinit();
+
+    const expected = try getTestFrames(1000);
+    defer testing.allocator.free(expected);
+    redetect(expected);
+    const actual = try getTestFrames(1000);
+    defer testing.allocator.free(actual);
+    const stats = try redetectParallel(testing.allocator, &pool, actual, .{ .chunk_size = 64, .warm_up_frames = 0 });
+    try testing.expectEqual(16, stats.number_of_chunks);
+    try testing.expect(stats.number_of_serial_chunks > 0);
+    try testing.expectEqualSlices(model.Frame, expected, actual);
+}
+
+test "Detectors.eql should compare floats by their bits" {
+    var a = Detectors{};
+    var b = Detectors{};
+    try testing.expect(a.eql(&b));
+    a.move_measurer.player_1_state.attack_range = 0.0;
+    b.move_measurer.player_1_state.attack_range = -0.0;
+    try testing.expect(!a.eql(&b));
+    b.move_measurer.player_1_state.attack_range = 0.0;
+    try testing.expect(a.eql(&b));
+}
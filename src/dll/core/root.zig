@@ -1,6 +1,29 @@
 pub const Controller = @import("controller.zig").Controller;
 pub const Core = @import("core.zig").Core;
+pub const frame_feed_name = @import("frame_feed.zig").frame_feed_name;
+pub const FrameFeed = @import("frame_feed.zig").FrameFeed;
 pub const HitDetector = @import("hit_detector.zig").HitDetector;
+pub const InputEvent = @import("input_index.zig").InputEvent;
+pub const InputQuery = @import("input_index.zig").InputQuery;
+pub const InputMatch = @import("input_index.zig").InputMatch;
+pub const InputRun = @import("input_index.zig").InputRun;
+pub const InputIndex = @import("input_index.zig").InputIndex;
+pub const InstantReplay = @import("instant_replay.zig").InstantReplay;
+pub const MoveKey = @import("move_database.zig").MoveKey;
+pub const MoveOutcome = @import("move_database.zig").MoveOutcome;
+pub const MoveObservation = @import("move_database.zig").MoveObservation;
+pub const MoveStats = @import("move_database.zig").MoveStats;
+pub const MoveDatabase = @import("move_database.zig").MoveDatabase;
 pub const MoveMeasurer = @import("move_measurer.zig").MoveMeasurer;
 pub const MoveDetector = @import("move_detector.zig").MoveDetector;
 pub const PauseDetector = @import("pause_detector.zig").PauseDetector;
+pub const Detectors = @import("redetector.zig").Detectors;
+pub const RedetectionConfig = @import("redetector.zig").RedetectionConfig;
+pub const RedetectionStats = @import("redetector.zig").RedetectionStats;
+pub const redetect = @import("redetector.zig").redetect;
+pub const redetectParallel = @import("redetector.zig").redetectParallel;
+pub const AlignmentConfig = @import("recording_aligner.zig").AlignmentConfig;
+pub const RecordingAlignment = @import("recording_aligner.zig").RecordingAlignment;
+pub const Snapshot = @import("snapshot_recorder.zig").Snapshot;
+pub const SnapshotRecorder = @import("snapshot_recorder.zig").SnapshotRecorder;
+pub const replaySnapshots = @import("snapshot_recorder.zig").replaySnapshots;
@@ -0,0 +1,451 @@
+const std = @import("std");
+const builtin = @import("builtin");
+const build_info = @import("build_info");
+const sdk = @import("../../sdk/root.zig");
+const core = @import("../core/root.zig");
+const game = @import("../game/root.zig");
+const model = @import("../model/root.zig");
+
+// Game memory exactly as it was copied out of the game, before the capturer turned it into a frame.
+pub const Snapshot = game.Capturer(build_info.game).GameMemory;
+
+const endian = std.builtin.Endian.little;
+const magic = @tagName(build_info.name) ++ "-snapshots";
+const version = 1;
+const snapshot_size = @sizeOf(Snapshot);
+// Deltas are never much bigger than the snapshot itself, so a bigger size means a broken file.
+const max_delta_size = 3 * snapshot_size;
+const layout_hash = std.hash.Fnv1a_64.hash(getLayout());
+
+// Records raw snapshots so that recordings can be captured again after a bug in the capturer or the conversions gets
+// fixed. Every snapshot is stored as a delta to the previous one, see sdk.io.encodeDelta. Most of the game memory stays
+// the same from one tick to the next, so a snapshot usually costs a few hundred bytes. Deltas get collected into a
+// single batch that is handed to a thread pool job whenever it fills up, so the tick never waits for the disk. Only one
+// batch gets written at a time, so memory stays bounded and a crash loses at most two batches.
+//
+// File structure: magic | version (u16) | game (u8) | snapshot size (u32) | layout hash (u64) | deltas,
+// where delta = size (u32) | delta bytes
+pub const SnapshotRecorder = struct {
+    allocator: std.mem.Allocator,
+    file: std.fs.File,
+    file_path: []const u8,
+    batch: std.ArrayList(u8),
+    written_batch: std.ArrayList(u8),
+    write_task: ?WriteTask,
+    number_of_snapshots: usize,
+    number_of_delta_bytes: usize,
+    previous: *Snapshot,
+    current: *Snapshot,
+
+    const Self = @This();
+    const WriteTask = sdk.misc.Task(?void);
+    pub const batch_size = 64 * 1024;
+
+    pub fn init(allocator: std.mem.Allocator, file_path: []const u8) !Self {
+        const previous = allocator.create(Snapshot) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate previous snapshot.", .{});
+            return err;
+        };
+        errdefer allocator.destroy(previous);
+        const current = allocator.create(Snapshot) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate current snapshot.", .{});
+            return err;
+        };
+        errdefer allocator.destroy(current);
+        var batch = std.ArrayList(u8).initCapacity(allocator, batch_size) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate delta batch of {} bytes.", .{batch_size});
+            return err;
+        };
+        errdefer batch.deinit(allocator);
+        var written_batch = std.ArrayList(u8).initCapacity(allocator, batch_size) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate written delta batch of {} bytes.", .{batch_size});
+            return err;
+        };
+        errdefer written_batch.deinit(allocator);
+        const owned_file_path = allocator.dupe(u8, file_path) catch |err| {
+            sdk.misc.error_context.new("Failed to copy file path: {s}", .{file_path});
+            return err;
+        };
+        errdefer allocator.free(owned_file_path);
+        const file = std.fs.cwd().createFile(file_path, .{}) catch |err| {
+            sdk.misc.error_context.new("Failed to create or open file: {s}", .{file_path});
+            return err;
+        };
+        errdefer file.close();
+        var buffer: [64]u8 = undefined;
+        var file_writer = file.writer(&buffer);
+        const writer = &file_writer.interface;
+        writeFileStart(writer) catch |err| {
+            sdk.misc.error_context.append("Failed to write file start: {s}", .{file_path});
+            return err;
+        };
+        writer.flush() catch |err| {
+            sdk.misc.error_context.new("Failed to flush the file writer.", .{});
+            return err;
+        };
+        // Only fields get copied into the snapshots, so zeroed padding and unused optional payloads stay zeroed and
+        // never show up in the deltas.
+        @memset(std.mem.asBytes(previous), 0);
+        @memset(std.mem.asBytes(current), 0);
+        return .{
+            .allocator = allocator,
+            .file = file,
+            .file_path = owned_file_path,
+            .batch = batch,
+            .written_batch = written_batch,
+            .write_task = null,
+            .number_of_snapshots = 0,
+            .number_of_delta_bytes = 0,
+            .previous = previous,
+            .current = current,
+        };
+    }
+
+    // Deltas that were not flushed yet get lost.
+    pub fn deinit(self: *Self) void {
+        self.finishWrite() catch |err| {
+            sdk.misc.error_context.append("Failed to finish writing snapshot deltas.", .{});
+            sdk.misc.error_context.logError(err);
+        };
+        self.file.close();
+        self.allocator.free(self.file_path);
+        self.allocator.destroy(self.previous);
+        self.allocator.destroy(self.current);
+        self.batch.deinit(self.allocator);
+        self.written_batch.deinit(self.allocator);
+    }
+
+    pub fn record(self: *Self, snapshot: *const Snapshot) !void {
+        inline for (@typeInfo(Snapshot).@"struct".fields) |*field| {
+            @field(self.current, field.name) = @field(snapshot, field.name);
+        }
+        const start = self.batch.items.len;
+        errdefer self.batch.shrinkRetainingCapacity(start);
+        self.batch.appendNTimes(self.allocator, 0, @sizeOf(u32)) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate delta size.", .{});
+            return err;
+        };
+        sdk.io.encodeDelta(
+            self.allocator,
+            std.mem.asBytes(self.previous),
+            std.mem.asBytes(self.current),
+            &self.batch,
+        ) catch |err| {
+            sdk.misc.error_context.append("Failed to encode snapshot delta.", .{});
+            return err;
+        };
+        const delta_size: u32 = @intCast(self.batch.items.len - start - @sizeOf(u32));
+        std.mem.writeInt(u32, self.batch.items[start..][0..@sizeOf(u32)], delta_size, endian);
+        std.mem.swap(*Snapshot, &self.previous, &self.current);
+        self.number_of_snapshots += 1;
+        self.number_of_delta_bytes += self.batch.items.len - start;
+        if (self.batch.items.len >= batch_size) {
+            // Delta is already part of the batch, so a failed write gets retried with the next write.
+            self.startWrite() catch |err| {
+                sdk.misc.error_context.append("Failed to start writing a full delta batch.", .{});
+                return err;
+            };
+        }
+    }
+
+    // Writes the deltas that were recorded since the last flush to the file and waits for the write to finish.
+    pub fn flush(self: *Self) !void {
+        self.startWrite() catch |err| {
+            sdk.misc.error_context.append("Failed to start writing the delta batch.", .{});
+            return err;
+        };
+        self.finishWrite() catch |err| {
+            sdk.misc.error_context.append("Failed to finish writing the delta batch.", .{});
+            return err;
+        };
+    }
+
+    // Waits for the previous batch to get written, so that batches end up inside the file in order. Deltas of a batch
+    // that failed to get written stay in front of the new ones and get written again.
+    fn startWrite(self: *Self) !void {
+        self.finishWrite() catch |err| {
+            sdk.misc.error_context.append("Failed to write the previous delta batch.", .{});
+            sdk.misc.error_context.logWarning(err);
+        };
+        self.written_batch.appendSlice(self.allocator, self.batch.items) catch |err| {
+            sdk.misc.error_context.new("Failed to move deltas into the written batch.", .{});
+            return err;
+        };
+        self.batch.clearRetainingCapacity();
+        self.write_task = WriteTask.spawn(self.allocator, writeBatch, .{
+            self.file,
+            self.file_path,
+            self.written_batch.items,
+        }) catch |err| {
+            sdk.misc.error_context.append("Failed to spawn the delta batch write.", .{});
+            return err;
+        };
+    }
+
+    fn finishWrite(self: *Self) !void {
+        var task = self.write_task orelse return;
+        self.write_task = null;
+        if (task.join().* == null) {
+            sdk.misc.error_context.new("Failed to write snapshot deltas: {s}", .{self.file_path});
+            return error.WriteFailed;
+        }
+        self.written_batch.clearRetainingCapacity();
+    }
+
+    fn writeBatch(file: std.fs.File, file_path: []const u8, batch: []const u8) ?void {
+        file.writeAll(batch) catch |err| {
+            sdk.misc.error_context.new("Failed to write snapshot deltas: {s}", .{file_path});
+            sdk.misc.error_context.logError(err);
+            return null;
+        };
+    }
+
+    fn writeFileStart(writer: *std.io.Writer) !void {
+        writer.writeAll(magic) catch |err| {
+            sdk.misc.error_context.new("Failed to write the magic bytes.", .{});
+            return err;
+        };
+        writer.writeInt(u16, version, endian) catch |err| {
+            sdk.misc.error_context.new("Failed to write the version.", .{});
+            return err;
+        };
+        writer.writeInt(u8, @intFromEnum(build_info.game), endian) catch |err| {
+            sdk.misc.error_context.new("Failed to write the game.", .{});
+            return err;
+        };
+        writer.writeInt(u32, snapshot_size, endian) catch |err| {
+            sdk.misc.error_context.new("Failed to write the snapshot size.", .{});
+            return err;
+        };
+        writer.writeInt(u64, layout_hash, endian) catch |err| {
+            sdk.misc.error_context.new("Failed to write the layout hash.", .{});
+            return err;
+        };
+    }
+};
+
+// Feeds every snapshot from the file through the capturer and the detectors, the same way Core.tick does, and passes
+// the resulting frames to the callback.
+pub fn replaySnapshots(
+    allocator: std.mem.Allocator,
+    file_path: []const u8,
+    context: anytype,
+    comptime onFrame: fn (@TypeOf(context), *const model.Frame) anyerror!void,
+) !void {
+    const file = std.fs.cwd().openFile(file_path, .{}) catch |err| {
+        sdk.misc.error_context.new("Failed to open file: {s}", .{file_path});
+        return err;
+    };
+    defer file.close();
+    const buffer = allocator.alloc(u8, SnapshotRecorder.batch_size) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate file read buffer.", .{});
+        return err;
+    };
+    defer allocator.free(buffer);
+    var file_reader = file.reader(buffer);
+    const reader = &file_reader.interface;
+    readFileStart(reader) catch |err| {
+        sdk.misc.error_context.append("Failed to read file start: {s}", .{file_path});
+        return err;
+    };
+
+    const snapshot = allocator.create(Snapshot) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate snapshot.", .{});
+        return err;
+    };
+    defer allocator.destroy(snapshot);
+    const snapshot_bytes = std.mem.asBytes(snapshot);
+    @memset(snapshot_bytes, 0);
+    const delta_buffer = allocator.alloc(u8, max_delta_size) catch |err| {
+        sdk.misc.error_context.new("Failed to allocate delta buffer.", .{});
+        return err;
+    };
+    defer allocator.free(delta_buffer);
+
+    var capturer = game.Capturer(build_info.game){};
+    var hit_detector = core.HitDetector{};
+    var move_detector = core.MoveDetector{};
+    var move_measurer = core.MoveMeasurer{};
+    var index: usize = 0;
+    while (true) : (index += 1) {
+        _ = reader.peekByte() catch |err| switch (err) {
+            error.EndOfStream => break,
+            else => {
+                sdk.misc.error_context.new("Failed to read snapshot delta {}.", .{index});
+                return err;
+            },
+        };
+        const delta_size = reader.takeInt(u32, endian) catch |err| {
+            sdk.misc.error_context.new("Failed to read size of snapshot delta {}.", .{index});
+            return err;
+        };
+        if (delta_size > max_delta_size) {
+            sdk.misc.error_context.new(
+                "Snapshot delta {} of {} bytes is bigger than the maximum of {} bytes.",
+                .{ index, delta_size, max_delta_size },
+            );
+            return error.InvalidDelta;
+        }
+        const delta = delta_buffer[0..delta_size];
+        reader.readSliceAll(delta) catch |err| {
+            sdk.misc.error_context.new("Failed to read snapshot delta {} of {} bytes.", .{ index, delta_size });
+            return err;
+        };
+        sdk.io.decodeDelta(snapshot_bytes, delta) catch |err| {
+            sdk.misc.error_context.append("Failed to decode snapshot delta {}.", .{index});
+            return err;
+        };
+        var frame = capturer.captureFrame(snapshot);
+        hit_detector.detect(&frame);
+        move_detector.detect(&frame);
+        move_measurer.measure(&frame);
+        onFrame(context, &frame) catch |err| {
+            sdk.misc.error_context.append("Failed to process frame of snapshot {}.", .{index});
+            return err;
+        };
+    }
+}
+
+fn readFileStart(reader: *std.io.Reader) !void {
+    const file_magic = reader.take(magic.len) catch |err| {
+        sdk.misc.error_context.new("Failed to read the magic bytes.", .{});
+        return err;
+    };
+    if (!std.mem.eql(u8, file_magic, magic)) {
+        sdk.misc.error_context.new("File is not a snapshot recording.", .{});
+        return error.InvalidMagic;
+    }
+    const file_version = reader.takeInt(u16, endian) catch |err| {
+        sdk.misc.error_context.new("Failed to read the version.", .{});
+        return err;
+    };
+    if (file_version != version) {
+        sdk.misc.error_context.new("Unsupported snapshot recording version: {}", .{file_version});
+        return error.UnsupportedVersion;
+    }
+    const file_game = reader.takeInt(u8, endian) catch |err| {
+        sdk.misc.error_context.new("Failed to read the game.", .{});
+        return err;
+    };
+    if (file_game != @intFromEnum(build_info.game)) {
+        sdk.misc.error_context.new("Snapshots were recorded from a different game.", .{});
+        return error.GameMismatch;
+    }
+    const file_snapshot_size = reader.takeInt(u32, endian) catch |err| {
+        sdk.misc.error_context.new("Failed to read the snapshot size.", .{});
+        return err;
+    };
+    const file_layout_hash = reader.takeInt(u64, endian) catch |err| {
+        sdk.misc.error_context.new("Failed to read the layout hash.", .{});
+        return err;
+    };
+    if (file_snapshot_size != snapshot_size or file_layout_hash != layout_hash) {
+        sdk.misc.error_context.new(
+            "Snapshots were recorded by a build with a different game memory layout. Snapshot size: {} (expected {})",
+            .{ file_snapshot_size, snapshot_size },
+        );
+        return error.LayoutMismatch;
+    }
+}
+
+// Names, offsets, sizes and types of the snapshot's fields and their fields. Changing any of these makes old snapshots
+// unreadable, while fixes to the capturer and the conversions don't.
+inline fn getLayout() []const u8 {
+    comptime {
+        @setEvalBranchQuota(100000);
+        var layout: []const u8 = builtin.zig_version_string ++ ";" ++ @tagName(builtin.cpu.arch) ++ ";";
+        for (@typeInfo(Snapshot).@"struct".fields) |*field| {
+            layout = layout ++ getFieldLayout(Snapshot, field.name);
+            const Child = switch (@typeInfo(field.type)) {
+                .optional => |info| info.child,
+                else => field.type,
+            };
+            if (@typeInfo(Child) != .@"struct") {
+                continue;
+            }
+            for (@typeInfo(Child).@"struct".fields) |*child_field| {
+                layout = layout ++ getFieldLayout(Child, child_field.name);
+            }
+        }
+        const result = layout;
+        return result;
+    }
+}
+
+fn getFieldLayout(comptime Struct: type, comptime name: []const u8) []const u8 {
+    const Field = @FieldType(Struct, name);
+    const offset = @offsetOf(Struct, name);
+    return std.fmt.comptimePrint("{s}:{}:{}:{s};", .{ name, offset, @sizeOf(Field), @typeName(Field) });
+}
+
+const testing = std.testing;
+
+test "replaySnapshots should produce the same frames as capturing the recorded snapshots directly" {
+    const file_path = "./test_assets/snapshot_recorder.snapshots";
+    defer std.fs.cwd().deleteFile(file_path) catch @panic("Failed to cleanup test file.");
+
+    var recorder = try SnapshotRecorder.init(testing.allocator, file_path);
+    defer recorder.deinit();
+    var expected: std.ArrayList(model.Frame) = .empty;
+    defer expected.deinit(testing.allocator);
+    var capturer = game.Capturer(build_info.game){};
+    var hit_detector = core.HitDetector{};
+    var move_detector = core.MoveDetector{};
+    var move_measurer = core.MoveMeasurer{};
+    for (0..10) |index| {
+        var snapshot = Snapshot{ .player_1 = .{}, .player_2 = .{} };
+        if (index % 3 != 0) {
+            snapshot.camera = std.mem.zeroes(game.Camera(build_info.game));
+        }
+        try recorder.record(&snapshot);
+        var frame = capturer.captureFrame(&snapshot);
+        hit_detector.detect(&frame);
+        move_detector.detect(&frame);
+        move_measurer.measure(&frame);
+        try expected.append(testing.allocator, frame);
+    }
+    try testing.expectEqual(10, recorder.number_of_snapshots);
+    try recorder.flush();
+
+    var actual: std.ArrayList(model.Frame) = .empty;
+    defer actual.deinit(testing.allocator);
+    try replaySnapshots(testing.allocator, file_path, &actual, struct {
+        fn call(list: *std.ArrayList(model.Frame), frame: *const model.Frame) anyerror!void {
+            try list.append(testing.allocator, frame.*);
+        }
+    }.call);
+    try testing.expectEqualSlices(model.Frame, expected.items, actual.items);
+}
+
+test "record should store unchanged snapshots in a few bytes" {
+    const file_path = "./test_assets/snapshot_recorder.snapshots";
+    defer std.fs.cwd().deleteFile(file_path) catch @panic("Failed to cleanup test file.");
+    var recorder = try SnapshotRecorder.init(testing.allocator, file_path);
+    defer recorder.deinit();
+    const snapshot = Snapshot{ .player_1 = .{}, .player_2 = .{} };
+    try recorder.record(&snapshot);
+    const first_size = recorder.number_of_delta_bytes;
+    try recorder.record(&snapshot);
+    try testing.expectEqual(first_size + @sizeOf(u32), recorder.number_of_delta_bytes);
+}
+
+test "record should write the deltas to the file whenever the batch fills up" {
+    const file_path = "./test_assets/snapshot_recorder.snapshots";
+    defer std.fs.cwd().deleteFile(file_path) catch @panic("Failed to cleanup test file.");
+    var recorder = try SnapshotRecorder.init(testing.allocator, file_path);
+    defer recorder.deinit();
+    const file_start_size = magic.len + @sizeOf(u16) + @sizeOf(u8) + @sizeOf(u32) + @sizeOf(u64);
+    const snapshot = Snapshot{ .player_1 = .{}, .player_2 = .{} };
+    for (0..(3 * SnapshotRecorder.batch_size / @sizeOf(u32))) |_| {
+        try recorder.record(&snapshot);
+        try testing.expect(recorder.batch.items.len < SnapshotRecorder.batch_size);
+    }
+    try recorder.finishWrite();
+    try testing.expectEqual(0, recorder.written_batch.items.len);
+    const written_size = recorder.number_of_delta_bytes - recorder.batch.items.len;
+    try testing.expect(written_size >= 2 * SnapshotRecorder.batch_size);
+    try testing.expectEqual(file_start_size + written_size, (try recorder.file.stat()).size);
+    try recorder.flush();
+    try testing.expectEqual(0, recorder.batch.items.len);
+    try testing.expectEqual(file_start_size + recorder.number_of_delta_bytes, (try recorder.file.stat()).size);
+}
@@ -2,6 +2,7 @@ const std = @import("std");
 const build_info = @import("build_info");
 const w32 = @import("win32").everything;
 const imgui = @import("imgui");
+const dll = @import("../dll.zig");
 const sdk = @import("../sdk/root.zig");
 const core = @import("core/root.zig");
 const model = @import("model/root.zig");
@@ -15,6 +16,7 @@ const dx = switch (rendering_api) {
 };
 
 pub const EventBuss = struct {
+    tagging_allocator: *const dll.TaggingAllocator,
     timer: sdk.misc.Timer(.{}),
     managed_dx_context: ?dx.ManagedContext,
     ui_context: ?UiContext,
@@ -27,13 +29,16 @@ pub const EventBuss = struct {
     const UiContext = sdk.ui.Context(rendering_api);
 
     const buffer_count = 3;
+    const snapshots_directory_name = "snapshots";
+    const recordings_directory_name = "recordings";
     const srv_heap_size = 64;
 
     pub fn init(
-        allocator: std.mem.Allocator,
+        tagging_allocator: *dll.TaggingAllocator,
         base_dir: *const sdk.misc.BaseDir,
         host_dx_context: *const dx.HostContext,
     ) Self {
+        const allocator = tagging_allocator.allocator(.other);
         std.log.debug("Initializing DirectX context...", .{});
         var managed_dx_context = if (dx.ManagedContext.init(allocator, host_dx_context)) |context| block: {
             std.log.info("DirectX context initialized.", .{});
@@ -50,7 +55,7 @@ pub const EventBuss = struct {
 
         const ui_context = if (dx_context) |*dxc| block: {
             std.log.debug("Initializing UI context...", .{});
-            if (UiContext.init(allocator, base_dir, dxc)) |context| {
+            if (UiContext.init(tagging_allocator.allocator(.imgui), base_dir, dxc)) |context| {
                 std.log.info("UI context initialized.", .{});
                 break :block context;
             } else |err| {
@@ -61,7 +66,7 @@ pub const EventBuss = struct {
         } else null;
 
         std.log.debug("Spawning settings loading task...", .{});
-        const settings_task = SettingsTask.spawn(allocator, struct {
+        const settings_task = SettingsTask.spawn(tagging_allocator.allocator(.tasks), struct {
             fn call(dir: *const sdk.misc.BaseDir) model.Settings {
                 std.log.info("Settings loading task spawned.", .{});
                 std.log.debug("Loading settings...", .{});
@@ -91,14 +96,24 @@ pub const EventBuss = struct {
         };
 
         std.log.debug("Initializing core...", .{});
-        const c = core.Core.init(allocator);
+        var c = core.Core.init(tagging_allocator.allocator(.recording), tagging_allocator.allocator(.io));
         std.log.info("Core initialized.", .{});
 
+        std.log.debug("Creating frame feed...", .{});
+        if (core.FrameFeed.create(core.frame_feed_name)) |frame_feed| {
+            c.frame_feed = frame_feed;
+            std.log.info("Frame feed created.", .{});
+        } else |err| {
+            sdk.misc.error_context.append("Failed to create frame feed. Continuing without it.", .{});
+            sdk.misc.error_context.logWarning(err);
+        }
+
         std.log.debug("Initializing UI...", .{});
         const ui_instance = ui.Ui.init(allocator);
         std.log.info("UI initialized.", .{});
 
         return .{
+            .tagging_allocator = tagging_allocator,
             .timer = .{},
             .managed_dx_context = managed_dx_context,
             .ui_context = ui_context,
@@ -124,6 +139,8 @@ pub const EventBuss = struct {
         _ = self.settings_task.join();
         std.log.info("Settings loading task joined.", .{});
 
+        self.stopSnapshotRecorder();
+
         std.log.debug("De-initializing core...", .{});
         self.core.deinit();
         std.log.info("Core de-initialized.", .{});
@@ -147,6 +164,120 @@ pub const EventBuss = struct {
         }
     }
 
+    // Raw snapshots get recorded into a file for as long as the setting is turned on. Recorder writes them to the file
+    // in batches while recording and writes the rest once the setting is turned off.
+    fn updateSnapshotRecorder(self: *Self, base_dir: *const sdk.misc.BaseDir) void {
+        const settings = self.settings_task.peek() orelse return;
+        const is_enabled = settings.misc.record_raw_snapshots;
+        if (is_enabled and self.core.snapshot_recorder == null) {
+            std.log.debug("Starting raw snapshot recording...", .{});
+            var buffer: [sdk.os.max_file_path_length]u8 = undefined;
+            const file_path = getSnapshotsFilePath(&buffer, base_dir) catch |err| {
+                sdk.misc.error_context.append("Failed to get raw snapshots file path.", .{});
+                sdk.misc.error_context.append("Failed to start raw snapshot recording.", .{});
+                sdk.misc.error_context.logError(err);
+                return;
+            };
+            if (core.SnapshotRecorder.init(self.core.controller.allocator, file_path)) |recorder| {
+                self.core.snapshot_recorder = recorder;
+                std.log.info("Raw snapshot recording started: {s}", .{file_path});
+            } else |err| {
+                sdk.misc.error_context.append("Failed to start raw snapshot recording.", .{});
+                sdk.misc.error_context.logError(err);
+            }
+        } else if (!is_enabled and self.core.snapshot_recorder != null) {
+            self.stopSnapshotRecorder();
+        }
+    }
+
+    // The instant replay ring gets allocated once when the setting is turned on and freed when it's turned off.
+    // Kept replays get saved into the recordings directory, so they show up in the recordings library.
+    fn updateInstantReplay(self: *Self, base_dir: *const sdk.misc.BaseDir) void {
+        const settings = self.settings_task.peek() orelse return;
+        const controller = &self.core.controller;
+        const is_enabled = settings.misc.instant_replay;
+        if (is_enabled and controller.instant_replay == null) {
+            std.log.debug("Starting instant replay...", .{});
+            var buffer: [sdk.os.max_file_path_length]u8 = undefined;
+            const directory_path = base_dir.getPath(&buffer, recordings_directory_name) catch |err| {
+                sdk.misc.error_context.append(
+                    "Failed to construct \"{s}\" directory path.",
+                    .{recordings_directory_name},
+                );
+                sdk.misc.error_context.append("Failed to start instant replay.", .{});
+                sdk.misc.error_context.logError(err);
+                return;
+            };
+            if (core.InstantReplay.init(controller.allocator, directory_path)) |replay| {
+                controller.instant_replay = replay;
+                std.log.info("Instant replay started. ({} bytes)", .{core.InstantReplay.memory_size});
+            } else |err| {
+                sdk.misc.error_context.append("Failed to start instant replay.", .{});
+                sdk.misc.error_context.logError(err);
+            }
+        } else if (!is_enabled and controller.instant_replay != null) {
+            controller.instant_replay.?.deinit();
+            controller.instant_replay = null;
+            std.log.info("Instant replay stopped.", .{});
+        }
+    }
+
+    fn stopSnapshotRecorder(self: *Self) void {
+        var recorder = self.core.snapshot_recorder orelse return;
+        self.core.snapshot_recorder = null;
+        if (recorder.number_of_snapshots == 0) {
+            var buffer: [sdk.os.max_file_path_length]u8 = undefined;
+            const file_path = buffer[0..recorder.file_path.len];
+            @memcpy(file_path, recorder.file_path);
+            recorder.deinit();
+            std.fs.cwd().deleteFile(file_path) catch |err| {
+                sdk.misc.error_context.new("Failed to delete empty raw snapshots file: {s}", .{file_path});
+                sdk.misc.error_context.logError(err);
+            };
+            std.log.info("Raw snapshot recording stopped without any snapshots.", .{});
+            return;
+        }
+        defer recorder.deinit();
+        std.log.debug("Saving remaining raw snapshots...", .{});
+        recorder.flush() catch |err| {
+            sdk.misc.error_context.append("Failed to save remaining raw snapshots.", .{});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+        std.log.info("Saved {} raw snapshots to: {s}", .{ recorder.number_of_snapshots, recorder.file_path });
+    }
+
+    fn getSnapshotsFilePath(buffer: *[sdk.os.max_file_path_length]u8, base_dir: *const sdk.misc.BaseDir) ![]const u8 {
+        var directory_buffer: [sdk.os.max_file_path_length]u8 = undefined;
+        const directory_path = base_dir.getPath(&directory_buffer, snapshots_directory_name) catch |err| {
+            sdk.misc.error_context.append("Failed to construct \"{s}\" directory path.", .{snapshots_directory_name});
+            return err;
+        };
+        std.fs.cwd().makePath(directory_path) catch |err| {
+            sdk.misc.error_context.new("Failed to make directory: {s}", .{directory_path});
+            return err;
+        };
+        const nano = std.time.nanoTimestamp();
+        const ts = sdk.misc.Timestamp.fromNano(nano, .local) catch |err| {
+            sdk.misc.error_context.append("Failed to construct timestamp structure for nano timestamp: {}", .{nano});
+            return err;
+        };
+        var name_buffer: [sdk.os.max_file_path_length]u8 = undefined;
+        const file_name = std.fmt.bufPrint(
+            &name_buffer,
+            "{:0>4}-{:0>2}-{:0>2} {:0>2}-{:0>2}-{:0>2}.snapshots",
+            .{ @abs(ts.year), ts.month, ts.day, ts.hour, ts.minute, ts.second },
+        ) catch |err| {
+            sdk.misc.error_context.new("Failed to construct raw snapshots file name.", .{});
+            return err;
+        };
+        var path_allocator = std.heap.FixedBufferAllocator.init(buffer);
+        return std.fs.path.join(path_allocator.allocator(), &.{ directory_path, file_name }) catch |err| {
+            sdk.misc.error_context.new("Failed to join raw snapshots file path: {s}", .{file_name});
+            return err;
+        };
+    }
+
     fn processFrame(self: *Self, frame: *const model.Frame) void {
         const settings = self.settings_task.peek() orelse return;
         self.ui.processFrame(settings, frame);
@@ -165,6 +296,11 @@ pub const EventBuss = struct {
         const delta_time = self.timer.measureDeltaTime();
         self.core.update(delta_time, self, processFrame);
         self.ui.update(delta_time, &self.core.controller);
+        self.updateSnapshotRecorder(base_dir);
+        self.updateInstantReplay(base_dir);
+        if (self.settings_task.peek()) |settings| {
+            self.core.controller.recording_profile = settings.misc.recording_profile;
+        }
 
         const managed_dx_context = if (self.managed_dx_context) |*context| context else return;
         const dx_context = dx.Context.fromHostAndManaged(host_dx_context, managed_dx_context);
@@ -178,6 +314,7 @@ pub const EventBuss = struct {
             self.settings_task.peek(),
             game_memory,
             &self.core.controller,
+            self.tagging_allocator,
         );
         ui_context.endFrame();
 
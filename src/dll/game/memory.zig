@@ -40,73 +40,7 @@ pub fn Memory(comptime game_id: build_info.Game) type {
                 deinitPatternCache(pattern_cache, base_dir, pattern_cache_file_name);
             };
 
-            const player_offsets = structOffsets(game.Player(game_id), switch (game_id) {
-                .t7 => .{
-                    .is_picked_by_main_player = 0x9,
-                    .character_id = 0xD8,
-                    .transform_matrix = 0x130,
-                    .floor_z = 0x1B0,
-                    .rotation = 0x1BE,
-                    .animation_frame = 0x1D4,
-                    .state_flags = 0x264,
-                    .attack_damage = 0x324,
-                    .attack_type = 0x328,
-                    .animation_id = 0x350,
-                    .can_move = 0x390,
-                    .animation_total_frames = 0x39C,
-                    .hit_outcome = 0x3D8,
-                    .simple_state = 0x428,
-                    .power_crushing = 0x6C0,
-                    .airborne_flags = 0x8D8,
-                    .frames_since_round_start = 0x95C,
-                    .in_rage = 0xC00,
-                    .phase_flags = 0xC40,
-                    .input_side = 0xDE4,
-                    .input = 0xE0C,
-                    .hit_lines = 0xE50,
-                    .hurt_cylinders = 0xF10,
-                    .collision_spheres = 0x10D0,
-                    .health = 0x14E8,
-                },
-                .t8 => .{
-                    .is_picked_by_main_player = 0x9,
-                    .character_id = 0x168,
-                    .transform_matrix = 0x200,
-                    .floor_z = 0x354,
-                    .rotation = 0x376,
-                    .state_flags = 0x434,
-                    .animation_frame = deref(u32, add(8, pattern(
-                        &cache,
-                        "8B 81 ?? ?? 00 00 39 81 ?? ?? 00 00 0F 84 ?? ?? 00 00 48 C7 81",
-                    ))),
-                    .attack_damage = 0x504,
-                    .attack_type = deref(u32, add(2, pattern(
-                        &cache,
-                        "89 8E ?? ?? 00 00 48 8D 8E ?? ?? 00 00 E8 ?? ?? ?? ?? 48 8D 8E ?? ?? ?? ?? E8 ?? ?? ?? ?? 8B 86",
-                    ))),
-                    .animation_id = 0x548,
-                    .can_move = 0x5C8,
-                    .animation_total_frames = 0x5D4,
-                    .hit_outcome = 0x610,
-                    .simple_state = 0x660,
-                    .is_a_parry_move = 0xA2C,
-                    .power_crushing = 0xBEC,
-                    .airborne_flags = 0xF1C,
-                    .in_rage = 0xF51,
-                    .used_rage = 0xF88,
-                    .frames_since_round_start = 0x1590,
-                    .phase_flags = 0x1BC4,
-                    .heat_gauge = 0x2440,
-                    .used_heat = 0x2450,
-                    .in_heat = 0x2471,
-                    .input_side = 0x27BC,
-                    .input = 0x27E4,
-                    .hit_lines = 0x2850,
-                    .hurt_cylinders = 0x2C50,
-                    .collision_spheres = 0x3090,
-                    .health = 0x3810,
-                },
-            });
+            const player_offsets = playerOffsets(&cache);
 
             const self: Self = switch (game_id) {
                 .t7 => .{
@@ -175,6 +109,87 @@ pub fn Memory(comptime game_id: build_info.Game) type {
             return self;
         }
 
+        // Player field offsets that change between game versions are read from instructions that use them.
+        pub const player_offset_patterns = switch (game_id) {
+            .t7 => struct {},
+            .t8 => struct {
+                pub const animation_frame = OffsetPattern{
+                    .pattern = "8B 81 ?? ?? 00 00 39 81 ?? ?? 00 00 0F 84 ?? ?? 00 00 48 C7 81",
+                    .offset_position = 8,
+                };
+                pub const attack_type = OffsetPattern{
+                    .pattern = "89 8E ?? ?? 00 00 48 8D 8E ?? ?? 00 00 E8 ?? ?? ?? ?? 48 8D 8E ?? ?? ?? ?? E8 ?? ?? ?? ?? 8B 86",
+                    .offset_position = 2,
+                };
+            },
+        };
+
+        pub fn playerOffsets(
+            cache: *?sdk.memory.PatternCache,
+        ) sdk.misc.FieldMap(game.Player(game_id), ?usize, null) {
+            return structOffsets(game.Player(game_id), switch (game_id) {
+                .t7 => .{
+                    .is_picked_by_main_player = 0x9,
+                    .character_id = 0xD8,
+                    .transform_matrix = 0x130,
+                    .floor_z = 0x1B0,
+                    .rotation = 0x1BE,
+                    .animation_frame = 0x1D4,
+                    .state_flags = 0x264,
+                    .attack_damage = 0x324,
+                    .attack_type = 0x328,
+                    .animation_id = 0x350,
+                    .can_move = 0x390,
+                    .animation_total_frames = 0x39C,
+                    .hit_outcome = 0x3D8,
+                    .simple_state = 0x428,
+                    .power_crushing = 0x6C0,
+                    .airborne_flags = 0x8D8,
+                    .frames_since_round_start = 0x95C,
+                    .in_rage = 0xC00,
+                    .phase_flags = 0xC40,
+                    .input_side = 0xDE4,
+                    .input = 0xE0C,
+                    .hit_lines = 0xE50,
+                    .hurt_cylinders = 0xF10,
+                    .collision_spheres = 0x10D0,
+                    .health = 0x14E8,
+                },
+                .t8 => .{
+                    .is_picked_by_main_player = 0x9,
+                    .character_id = 0x168,
+                    .transform_matrix = 0x200,
+                    .floor_z = 0x354,
+                    .rotation = 0x376,
+                    .state_flags = 0x434,
+                    .animation_frame = offsetFromPattern(cache, player_offset_patterns.animation_frame),
+                    .attack_damage = 0x504,
+                    .attack_type = offsetFromPattern(cache, player_offset_patterns.attack_type),
+                    .animation_id = 0x548,
+                    .can_move = 0x5C8,
+                    .animation_total_frames = 0x5D4,
+                    .hit_outcome = 0x610,
+                    .simple_state = 0x660,
+                    .is_a_parry_move = 0xA2C,
+                    .power_crushing = 0xBEC,
+                    .airborne_flags = 0xF1C,
+                    .in_rage = 0xF51,
+                    .used_rage = 0xF88,
+                    .frames_since_round_start = 0x1590,
+                    .phase_flags = 0x1BC4,
+                    .heat_gauge = 0x2440,
+                    .used_heat = 0x2450,
+                    .in_heat = 0x2471,
+                    .input_side = 0x27BC,
+                    .input = 0x27E4,
+                    .hit_lines = 0x2850,
+                    .hurt_cylinders = 0x2C50,
+                    .collision_spheres = 0x3090,
+                    .health = 0x3810,
+                },
+            });
+        }
+
         fn initPatternCache(
             allocator: std.mem.Allocator,
             base_dir: ?*const sdk.misc.BaseDir,
@@ -244,6 +259,11 @@ pub fn Memory(comptime game_id: build_info.Game) type {
     };
 }
 
+pub const OffsetPattern = struct {
+    pattern: []const u8,
+    offset_position: comptime_int,
+};
+
 fn structOffsets(
     comptime Struct: type,
     offsets: sdk.misc.FieldMap(Struct, anyerror!usize, null),
@@ -365,6 +385,10 @@ fn pattern(pattern_cache: *?sdk.memory.PatternCache, comptime pattern_string: []
     return address;
 }
 
+fn offsetFromPattern(pattern_cache: *?sdk.memory.PatternCache, comptime offset_pattern: OffsetPattern) !usize {
+    return deref(u32, add(offset_pattern.offset_position, pattern(pattern_cache, offset_pattern.pattern)));
+}
+
 fn deref(comptime Type: type, address: anyerror!usize) !usize {
     if (Type != u8 and Type != u16 and Type != u32 and Type != u64) {
         @compileError("Unsupported deref type: " ++ @typeName(Type));
@@ -1,4 +1,5 @@
 const std = @import("std");
+const sdk = @import("../../sdk/root.zig");
 const model = @import("root.zig");
 
 pub const Frame = struct {
@@ -33,6 +34,9 @@ pub const Frame = struct {
     }
 };
 
+// Frame without the padding and optional tags. Useful for holding many frames in memory or sending them somewhere.
+pub const PackedFrame = sdk.misc.Packed(Frame);
+
 const testing = std.testing;
 
 test "Frame.getPlayerById should return correct player" {
@@ -58,3 +62,29 @@ test "Frame.getPlayerByRole should return correct player" {
     try testing.expectEqual(&frame_2.players[1], frame_2.getPlayerByRole(.main));
     try testing.expectEqual(&frame_2.players[0], frame_2.getPlayerByRole(.secondary));
 }
+
+test "PackedFrame should unpack into the same frame that was packed" {
+    var frame = Frame{
+        .frames_since_round_start = 123,
+        .floor_z = null,
+        .camera = .{ .position = .fromArray(.{ 1, 2, 3 }), .pitch = 4, .yaw = 5, .roll = 6 },
+        .left_player_id = .player_2,
+        .main_player_id = .player_1,
+    };
+    frame.players[0] = .{
+        .character_id = 7,
+        .move_phase = .active,
+        .input = .{ .forward = true, .button_1 = true },
+        .heat = .{ .activated = .{ .gauge = 0.5 } },
+        .rage = .activated,
+    };
+    frame.players[0].hit_lines.buffer[0] = .{ .line = .{
+        .point_1 = .fromArray(.{ 8, 9, 10 }),
+        .point_2 = .fromArray(.{ 11, 12, 13 }),
+    } };
+    frame.players[0].hit_lines.len = 1;
+    frame.players[1] = .{ .health = 100, .heat = .used_up, .can_move = false };
+    const packed_frame = PackedFrame.pack(&frame);
+    try testing.expectEqualDeep(frame, packed_frame.unpack());
+    try testing.expect(@sizeOf(PackedFrame) < @sizeOf(Frame));
+}
@@ -158,3 +158,10 @@ pub const Camera = struct {
     yaw: f32,
     roll: f32,
 };
+
+// Which frame fields get stored when saving a recording. Leaving fields out makes saving faster and files smaller.
+pub const RecordingProfile = enum {
+    full,
+    gameplay,
+    inputs,
+};
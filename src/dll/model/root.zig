@@ -2,6 +2,7 @@ pub const CollisionSphereId = @import("collision_sphere.zig").CollisionSphereId;
 pub const CollisionSphere = @import("collision_sphere.zig").CollisionSphere;
 pub const CollisionSpheres = @import("collision_sphere.zig").CollisionSpheres;
 pub const Frame = @import("frame.zig").Frame;
+pub const PackedFrame = @import("frame.zig").PackedFrame;
 pub const HitLine = @import("hit_lines.zig").HitLine;
 pub const HitLineFlags = @import("hit_lines.zig").HitLineFlags;
 pub const HitLines = @import("hit_lines.zig").HitLines;
@@ -25,6 +26,7 @@ pub const Heat = @import("misc.zig").Heat;
 pub const HeatTag = @import("misc.zig").HeatTag;
 pub const Camera = @import("misc.zig").Camera;
 pub const ActivatedHeat = @import("misc.zig").ActivatedHeat;
+pub const RecordingProfile = @import("misc.zig").RecordingProfile;
 pub const PlayerId = @import("player.zig").PlayerId;
 pub const PlayerSide = @import("player.zig").PlayerSide;
 pub const PlayerRole = @import("player.zig").PlayerRole;
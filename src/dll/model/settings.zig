@@ -329,6 +329,9 @@ pub const DetailsSettings = struct {
 
 pub const MiscSettings = struct {
     ui_font_size: f32 = sdk.ui.default_font_size,
+    record_raw_snapshots: bool = false,
+    recording_profile: model.RecordingProfile = .full,
+    instant_replay: bool = true,
 };
 
 pub const PlayerSettingsMode = enum {
@@ -24,6 +24,7 @@ pub fn Controls(comptime config: ControlsConfig) type {
             handlePauseKey(controller);
             handleStopKey(controller);
             handleRecordKey(controller);
+            handleKeepReplayKey(controller);
             self.handleRewindKey(controller);
             handlePreviousFrameKey(controller);
             handleNextFrameKey(controller);
@@ -38,6 +39,10 @@ pub fn Controls(comptime config: ControlsConfig) type {
             const spacing = imgui.igGetStyle().*.ItemSpacing.x;
 
             drawCurrentFrame(controller);
+            if (controller.hasComparison()) {
+                imgui.igSameLine(0, spacing);
+                drawComparisonFrame(controller);
+            }
 
             imgui.igSameLine(0, spacing);
 
@@ -66,6 +71,8 @@ pub fn Controls(comptime config: ControlsConfig) type {
             drawStopButton(controller);
             imgui.igSameLine(0, spacing);
             drawRecordButton(controller);
+            imgui.igSameLine(0, spacing);
+            drawKeepReplayButton(controller);
 
             imgui.igSameLine(0, 2 * spacing);
 
@@ -103,6 +110,15 @@ pub fn Controls(comptime config: ControlsConfig) type {
             }
         }
 
+        // Frame of the comparison recording that got aligned with the current frame.
+        fn drawComparisonFrame(controller: *config.Controller) void {
+            if (controller.getComparisonFrameIndex()) |comparison| {
+                drawText("comparison_frame", "vs {d:0>5}", .{comparison});
+            } else {
+                drawText("comparison_frame", "vs ‒‒‒‒‒", .{});
+            }
+        }
+
         fn drawTotalFrames(controller: *config.Controller) void {
             const total = controller.getTotalFrames();
             if (total != 0) {
@@ -113,7 +129,7 @@ pub fn Controls(comptime config: ControlsConfig) type {
         }
 
         fn drawText(test_id: [:0]const u8, comptime fmt: []const u8, args: anytype) void {
-            var buffer: [32]u8 = undefined;
+            var buffer: [64]u8 = undefined;
             const text = std.fmt.bufPrintZ(&buffer, fmt, args) catch "error";
             imgui.igText("%s", text.ptr);
 
@@ -269,6 +285,32 @@ pub fn Controls(comptime config: ControlsConfig) type {
                 controller.mode == .load;
         }
 
+        fn drawKeepReplayButton(controller: *config.Controller) void {
+            const disabled = isKeepReplayDisabled(controller);
+            if (disabled) imgui.igBeginDisabled(true);
+            defer if (disabled) imgui.igEndDisabled();
+            if (imgui.igButton(" ⏮ ###keep_replay", .{})) {
+                controller.keepInstantReplay();
+            }
+            if (imgui.igIsItemHovered(0)) {
+                imgui.igSetTooltip("Keep Instant Replay [Insert]");
+            }
+        }
+
+        fn handleKeepReplayKey(controller: *config.Controller) void {
+            if (isKeepReplayDisabled(controller)) {
+                return;
+            }
+            if (imgui.igIsKeyPressed_Bool(imgui.ImGuiKey_Insert, false)) {
+                controller.keepInstantReplay();
+            }
+        }
+
+        // Kept replay goes into its own file, so keeping it doesn't depend on what the recording is doing.
+        fn isKeepReplayDisabled(controller: *const config.Controller) bool {
+            return controller.isSavingInstantReplay() or controller.getInstantReplayLen() == 0;
+        }
+
         fn drawRewindButton(self: *Self, controller: *config.Controller) void {
             const disabled = isRewindDisabled(controller);
             if (disabled) imgui.igBeginDisabled(true);
@@ -565,6 +607,8 @@ const MockController = struct {
     playback_speed: f32 = 1.0,
     total_frames: usize = 100,
     current_frame_index: ?usize = null,
+    has_comparison: bool = false,
+    comparison_frame_index: ?usize = null,
     scrub_direction: ?ScrubDirection = null,
     play_call_count: usize = 0,
     pause_call_count: usize = 0,
@@ -573,6 +617,9 @@ const MockController = struct {
     scrub_call_count: usize = 0,
     last_scrub_direction: ?ScrubDirection = null,
     clear_call_count: usize = 0,
+    instant_replay_len: usize = 0,
+    is_saving_instant_replay: bool = false,
+    keep_instant_replay_call_count: usize = 0,
     set_current_index_call_count: usize = 0,
     set_current_index_argument: ?usize = null,
 
@@ -612,6 +659,18 @@ const MockController = struct {
         self.clear_call_count += 1;
     }
 
+    pub fn keepInstantReplay(self: *Self) void {
+        self.keep_instant_replay_call_count += 1;
+    }
+
+    pub fn getInstantReplayLen(self: *const Self) usize {
+        return self.instant_replay_len;
+    }
+
+    pub fn isSavingInstantReplay(self: *const Self) bool {
+        return self.is_saving_instant_replay;
+    }
+
     pub fn scrub(self: *Self, direction: ScrubDirection) void {
         self.scrub_call_count += 1;
         self.last_scrub_direction = direction;
@@ -630,6 +689,14 @@ const MockController = struct {
         return self.current_frame_index;
     }
 
+    pub fn hasComparison(self: *const Self) bool {
+        return self.has_comparison;
+    }
+
+    pub fn getComparisonFrameIndex(self: *const Self) ?usize {
+        return self.comparison_frame_index;
+    }
+
     pub fn getScrubDirection(self: *const Self) ?ScrubDirection {
         return self.scrub_direction;
     }
@@ -677,6 +744,35 @@ test "should display current frame index correctly when null" {
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
 
+test "should display comparison frame index only when there is a comparison recording" {
+    const Test = struct {
+        var controller = MockController{ .mode = .pause, .current_frame_index = 123 };
+        var controls = Controls(.{ .Controller = MockController }){};
+
+        fn guiFunction(_: sdk.ui.TestContext) !void {
+            _ = imgui.igBegin("Window", null, 0);
+            defer imgui.igEnd();
+            controls.handleKeybinds(&controller);
+            controls.draw(&controller);
+        }
+
+        fn testFunction(ctx: sdk.ui.TestContext) !void {
+            ctx.setRef("Window");
+            try ctx.expectItemNotExists("comparison_frame");
+
+            controller.has_comparison = true;
+            ctx.yield(1);
+            try ctx.expectItemExists("comparison_frame: vs ‒‒‒‒‒");
+
+            controller.comparison_frame_index = 456;
+            ctx.yield(1);
+            try ctx.expectItemExists("comparison_frame: vs 00456");
+        }
+    };
+    const context = try sdk.ui.getTestingContext();
+    try context.runTest(.{}, Test.guiFunction, Test.testFunction);
+}
+
 test "should display total frames correctly when not zero" {
     const Test = struct {
         var controller = MockController{ .mode = .playback, .total_frames = 123 };
@@ -954,6 +1050,66 @@ test "should disable record when already recording" {
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
 
+test "should call keepInstantReplay when keep replay button is clicked or insert key is pressed" {
+    const Test = struct {
+        var controller = MockController{ .mode = .live, .instant_replay_len = 100 };
+        var controls = Controls(.{ .Controller = MockController }){};
+
+        fn guiFunction(_: sdk.ui.TestContext) !void {
+            _ = imgui.igBegin("Window", null, 0);
+            defer imgui.igEnd();
+            controls.handleKeybinds(&controller);
+            controls.draw(&controller);
+        }
+
+        fn testFunction(ctx: sdk.ui.TestContext) !void {
+            ctx.setRef("Window");
+            try testing.expectEqual(0, controller.keep_instant_replay_call_count);
+            ctx.itemClick("###keep_replay", 0, 0);
+            try testing.expectEqual(1, controller.keep_instant_replay_call_count);
+            ctx.keyPress(imgui.ImGuiKey_Insert, 1);
+            try testing.expectEqual(2, controller.keep_instant_replay_call_count);
+        }
+    };
+    const context = try sdk.ui.getTestingContext();
+    try context.runTest(.{}, Test.guiFunction, Test.testFunction);
+}
+
+test "should disable keep replay while saving the previous one or when nothing was captured" {
+    const Test = struct {
+        var controller = MockController{ .mode = .record, .instant_replay_len = 100, .is_saving_instant_replay = true };
+        var controls = Controls(.{ .Controller = MockController }){};
+
+        fn guiFunction(_: sdk.ui.TestContext) !void {
+            _ = imgui.igBegin("Window", null, 0);
+            defer imgui.igEnd();
+            controls.handleKeybinds(&controller);
+            controls.draw(&controller);
+        }
+
+        fn testFunction(ctx: sdk.ui.TestContext) !void {
+            ctx.setRef("Window");
+            ctx.itemClick("###keep_replay", 0, 0);
+            ctx.keyPress(imgui.ImGuiKey_Insert, 1);
+            try testing.expectEqual(0, controller.keep_instant_replay_call_count);
+
+            controller.is_saving_instant_replay = false;
+            controller.instant_replay_len = 0;
+            ctx.yield(1);
+            ctx.itemClick("###keep_replay", 0, 0);
+            ctx.keyPress(imgui.ImGuiKey_Insert, 1);
+            try testing.expectEqual(0, controller.keep_instant_replay_call_count);
+
+            controller.instant_replay_len = 100;
+            ctx.yield(1);
+            ctx.itemClick("###keep_replay", 0, 0);
+            try testing.expectEqual(1, controller.keep_instant_replay_call_count);
+        }
+    };
+    const context = try sdk.ui.getTestingContext();
+    try context.runTest(.{}, Test.guiFunction, Test.testFunction);
+}
+
 test "should call scrub(.backward) and pause when rewind button is clicked or F5 key is pressed and controller is not in playback" {
     const Test = struct {
         var controller = MockController{ .mode = .record };
@@ -17,8 +17,10 @@ pub fn FileMenu(comptime config: FileMenuConfig) type {
         progress: Progress = .start,
         menu_bar: MenuBar = .{},
         unsaved_dialog: UnsavedDialog = .{},
+        range_dialog: RangeDialog = .{},
         save_dialog: FileDialog = .{ .type = .save },
         open_dialog: FileDialog = .{ .type = .open },
+        library_dialog: LibraryDialog,
         file_path_buffer: [sdk.os.max_file_path_length]u8 = undefined,
         file_path_len: usize = 0,
 
@@ -27,20 +29,34 @@ pub fn FileMenu(comptime config: FileMenuConfig) type {
             idle,
             new,
             open,
+            open_from_library,
+            open_comparison,
             save,
             save_as,
+            save_range_as,
+            save_without_range_as,
             exit,
         };
         const Progress = enum {
             start,
             unsaved_dialog,
+            range_dialog,
             save_dialog,
             save_in_progress,
             open_dialog,
+            library_dialog,
             open_in_progress,
             finnish,
         };
 
+        pub fn init(allocator: std.mem.Allocator) Self {
+            return .{ .library_dialog = .init(allocator) };
+        }
+
+        pub fn deinit(self: *Self) void {
+            self.library_dialog.deinit();
+        }
+
         pub fn update(self: *Self, controller: *config.Controller) void {
             var action = self.action;
             defer self.action = action;
@@ -58,8 +74,13 @@ pub fn FileMenu(comptime config: FileMenuConfig) type {
                     .no_action, .close_ui => {},
                     .new => action = .new,
                     .open => action = .open,
+                    .open_from_library => action = .open_from_library,
+                    .open_comparison => action = .open_comparison,
+                    .close_comparison => controller.clearComparison(),
                     .save => action = .save,
                     .save_as => action = .save_as,
+                    .save_range_as => action = .save_range_as,
+                    .save_without_range_as => action = .save_without_range_as,
                     .exit => action = .exit,
                 }
             }
@@ -70,8 +91,12 @@ pub fn FileMenu(comptime config: FileMenuConfig) type {
                     .idle => unreachable,
                     .new, .exit => if (unsaved_changes) .unsaved_dialog else .finnish,
                     .open => if (unsaved_changes) .unsaved_dialog else .open_dialog,
+                    .open_from_library => if (unsaved_changes) .unsaved_dialog else .library_dialog,
+                    // Comparison recording does not replace the current recording, so nothing can get lost.
+                    .open_comparison => .open_dialog,
                     .save => if (self.file_path_len == 0) .save_dialog else .save_in_progress,
                     .save_as => .save_dialog,
+                    .save_range_as, .save_without_range_as => .range_dialog,
                 };
             }
 
@@ -80,10 +105,22 @@ pub fn FileMenu(comptime config: FileMenuConfig) type {
                     .no_action => {},
                     .save => progress = if (self.file_path_len == 0) .save_dialog else .save_in_progress,
                     .dont_save => switch (action) {
-                        .idle, .save, .save_as => unreachable,
+                        .idle, .open_comparison, .save, .save_as, .save_range_as, .save_without_range_as => unreachable,
                         .new, .exit => progress = .finnish,
                         .open => progress = .open_dialog,
+                        .open_from_library => progress = .library_dialog,
+                    },
+                    .cancel => {
+                        action = .idle;
+                        progress = .start;
                     },
+                }
+            }
+
+            if (progress == .range_dialog) {
+                switch (self.range_dialog.action) {
+                    .no_action => {},
+                    .proceed => progress = .save_dialog,
                     .cancel => {
                         action = .idle;
                         progress = .start;
@@ -104,17 +141,37 @@ pub fn FileMenu(comptime config: FileMenuConfig) type {
 
             if (self.progress != .save_in_progress and progress == .save_in_progress) {
                 const path = self.save_dialog.getLastSelectedPath() orelse self.getFilePath() orelse unreachable;
-                controller.save(path);
+                switch (action) {
+                    .save_range_as, .save_without_range_as => {
+                        // Unchanged linked file allows the controller to edit the file instead of re-encoding it.
+                        const source_path = if (unsaved_changes) null else self.getFilePath();
+                        const edit: config.Controller.RangeEdit = if (action == .save_range_as) .keep else .delete;
+                        const start = self.range_dialog.getStart();
+                        const end = self.range_dialog.getEnd();
+                        controller.saveRange(path, source_path, edit, start, end);
+                    },
+                    else => controller.save(path),
+                }
             }
 
             if (progress == .save_in_progress and controller.mode != .save) {
                 if (controller.did_last_save_or_load_succeed) {
                     switch (action) {
-                        .idle => unreachable,
-                        .new, .save, .save_as, .exit => progress = .finnish,
+                        .idle, .open_comparison => unreachable,
+                        .new, .save, .save_as, .save_range_as, .save_without_range_as, .exit => progress = .finnish,
                         .open => progress = .open_dialog,
+                        .open_from_library => progress = .library_dialog,
                     }
-                    if (self.save_dialog.last_selected_path_len > 0) {
+                    if (action == .save_range_as or action == .save_without_range_as) {
+                        // Saved range is a different recording then the one in memory, so it does not get linked.
+                        // When it overwrites the linked file, the recording in memory is no longer saved anywhere.
+                        const destination = self.save_dialog.getLastSelectedPath();
+                        const file_path = self.getFilePath();
+                        if (destination != null and file_path != null and std.mem.eql(u8, destination.?, file_path.?)) {
+                            self.file_path_len = 0;
+                            controller.contains_unsaved_changes = true;
+                        }
+                    } else if (self.save_dialog.last_selected_path_len > 0) {
                         self.file_path_buffer = self.save_dialog.last_selected_path_buffer;
                         self.file_path_len = self.save_dialog.last_selected_path_len;
                     }
@@ -136,17 +193,41 @@ pub fn FileMenu(comptime config: FileMenuConfig) type {
                 }
             }
 
+            if (progress == .library_dialog) {
+                switch (self.library_dialog.action) {
+                    .no_action => {},
+                    .proceed => progress = .open_in_progress,
+                    .cancel => {
+                        action = .idle;
+                        progress = .start;
+                    },
+                }
+            }
+
             if (self.progress != .open_in_progress and progress == .open_in_progress) {
-                const path = self.open_dialog.getLastSelectedPath() orelse unreachable;
-                controller.load(path);
+                const path = switch (action) {
+                    .open_from_library => self.library_dialog.getSelectedPath(),
+                    else => self.open_dialog.getLastSelectedPath(),
+                } orelse unreachable;
+                switch (action) {
+                    .open_comparison => controller.loadComparison(path),
+                    else => controller.load(path),
+                }
             }
 
             if (progress == .open_in_progress and controller.mode != .load) {
                 if (controller.did_last_save_or_load_succeed) {
                     progress = .finnish;
-                    if (self.open_dialog.last_selected_path_len > 0) {
-                        self.file_path_buffer = self.open_dialog.last_selected_path_buffer;
-                        self.file_path_len = self.open_dialog.last_selected_path_len;
+                    // Comparison recording is only looked at, so the current recording stays linked to it's file.
+                    const path = switch (action) {
+                        .open_comparison => null,
+                        .open_from_library => self.library_dialog.getSelectedPath(),
+                        else => self.open_dialog.getLastSelectedPath(),
+                    };
+                    if (path) |p| {
+                        @memcpy(self.file_path_buffer[0..p.len], p);
+                        self.file_path_buffer[p.len] = 0;
+                        self.file_path_len = p.len;
                     }
                 } else {
                     action = .idle;
@@ -158,7 +239,8 @@ pub fn FileMenu(comptime config: FileMenuConfig) type {
             if (progress == .finnish) {
                 switch (action) {
                     .idle => unreachable,
-                    .open, .save, .save_as => {},
+                    .open, .open_from_library, .open_comparison => {},
+                    .save, .save_as, .save_range_as, .save_without_range_as => {},
                     .new => controller.clear(),
                     .exit => config.selfShutDown(),
                 }
@@ -174,10 +256,16 @@ pub fn FileMenu(comptime config: FileMenuConfig) type {
             controller: *config.Controller,
             is_ui_open: *bool,
         ) void {
-            self.menu_bar.draw(self.action == .idle, controller.getTotalFrames() == 0);
+            self.menu_bar.draw(self.action == .idle, controller.getTotalFrames() == 0, controller.hasComparison());
             self.unsaved_dialog.draw(self.progress == .unsaved_dialog);
-            self.save_dialog.draw(file_dialog_context, base_dir, self.getFilePath(), self.progress == .save_dialog);
+            self.range_dialog.draw(self.progress == .range_dialog, controller.getTotalFrames());
+            const save_path = switch (self.action) {
+                .save_range_as, .save_without_range_as => null,
+                else => self.getFilePath(),
+            };
+            self.save_dialog.draw(file_dialog_context, base_dir, save_path, self.progress == .save_dialog);
             self.open_dialog.draw(file_dialog_context, base_dir, self.getFilePath(), self.progress == .open_dialog);
+            self.library_dialog.draw(base_dir, self.progress == .library_dialog);
 
             if (self.menu_bar.action == .close_ui and is_ui_open.*) {
                 is_ui_open.* = false;
@@ -202,13 +290,18 @@ const MenuBar = struct {
         no_action,
         new,
         open,
+        open_from_library,
+        open_comparison,
+        close_comparison,
         save,
         save_as,
+        save_range_as,
+        save_without_range_as,
         close_ui,
         exit,
     };
 
-    fn draw(self: *Self, is_idle: bool, is_recording_empty: bool) void {
+    fn draw(self: *Self, is_idle: bool, is_recording_empty: bool, has_comparison: bool) void {
         var action = Action.no_action;
         defer self.action = action;
 
@@ -226,6 +319,9 @@ const MenuBar = struct {
         if (imgui.igMenuItem_Bool("Open", null, false, true)) {
             action = .open;
         }
+        if (imgui.igMenuItem_Bool("Open From Library", null, false, true)) {
+            action = .open_from_library;
+        }
         imgui.igBeginDisabled(is_recording_empty);
         if (imgui.igMenuItem_Bool("Save", null, false, true)) {
             action = .save;
@@ -233,6 +329,23 @@ const MenuBar = struct {
         if (imgui.igMenuItem_Bool("Save As", null, false, true)) {
             action = .save_as;
         }
+        if (imgui.igMenuItem_Bool("Save Range As", null, false, true)) {
+            action = .save_range_as;
+        }
+        if (imgui.igMenuItem_Bool("Save Without Range As", null, false, true)) {
+            action = .save_without_range_as;
+        }
+        imgui.igEndDisabled();
+        imgui.igSeparator();
+        imgui.igBeginDisabled(is_recording_empty);
+        if (imgui.igMenuItem_Bool("Open Comparison", null, false, true)) {
+            action = .open_comparison;
+        }
+        imgui.igEndDisabled();
+        imgui.igBeginDisabled(!has_comparison);
+        if (imgui.igMenuItem_Bool("Close Comparison", null, false, true)) {
+            action = .close_comparison;
+        }
         imgui.igEndDisabled();
         imgui.igEndDisabled();
         imgui.igSeparator();
@@ -297,6 +410,69 @@ const UnsavedDialog = struct {
     }
 };
 
+const RangeDialog = struct {
+    is_open: bool = false,
+    action: Action = .no_action,
+    first_frame: c_int = 1,
+    last_frame: c_int = 1,
+
+    const Self = @This();
+    pub const Action = enum { no_action, proceed, cancel };
+
+    pub fn draw(self: *Self, is_open: bool, total_frames: usize) void {
+        defer self.is_open = is_open;
+        var action = Action.no_action;
+        defer self.action = action;
+
+        const max_frame: c_int = @intCast(std.math.clamp(total_frames, 1, std.math.maxInt(c_int)));
+        if (!self.is_open and is_open) {
+            self.first_frame = 1;
+            self.last_frame = max_frame;
+            imgui.igOpenPopup_Str("Frame Range", 0);
+        }
+
+        var remains_open = self.is_open or is_open;
+        if (!imgui.igBeginPopupModal(
+            "Frame Range",
+            &remains_open,
+            imgui.ImGuiWindowFlags_AlwaysAutoResize,
+        )) {
+            return;
+        }
+        defer imgui.igEndPopup();
+
+        imgui.igText("Select the range of frames. First and last frame are included in the range.");
+        _ = imgui.igInputInt("First Frame", &self.first_frame, 1, 60, 0);
+        _ = imgui.igInputInt("Last Frame", &self.last_frame, 1, 60, 0);
+        self.first_frame = std.math.clamp(self.first_frame, 1, max_frame);
+        self.last_frame = std.math.clamp(self.last_frame, self.first_frame, max_frame);
+        imgui.igSeparator();
+        if (imgui.igButton("OK", .{})) {
+            action = .proceed;
+        }
+        imgui.igSameLine(0, -1);
+        if (imgui.igButton("Cancel", .{})) {
+            action = .cancel;
+        }
+        if (!remains_open) {
+            action = .cancel;
+        }
+        if (!is_open) {
+            imgui.igCloseCurrentPopup();
+        }
+    }
+
+    // Index of the first frame in the range.
+    pub fn getStart(self: *const Self) usize {
+        return @intCast(self.first_frame - 1);
+    }
+
+    // Index after the last frame in the range.
+    pub fn getEnd(self: *const Self) usize {
+        return @intCast(self.last_frame);
+    }
+};
+
 const FileDialog = struct {
     type: Type,
     is_open: bool = false,
@@ -451,6 +627,319 @@ const FileDialog = struct {
     }
 };
 
+// Lists the recordings from the recordings directory using the recording index, so sorting and filtering thousands of
+// recordings never has to decompress any of them.
+const LibraryDialog = struct {
+    allocator: std.mem.Allocator,
+    task: Task,
+    is_open: bool = false,
+    action: Action = .no_action,
+    filter_buffer: [64:0]u8 = [1:0]u8{0} ** 64,
+    sort: Sort = .{ .column = .modified, .descending = true },
+    rows: std.ArrayList(usize) = .empty,
+    are_rows_dirty: bool = true,
+    selected_row: ?usize = null,
+    dir_path_buffer: [sdk.os.max_file_path_length]u8 = undefined,
+    dir_path_len: usize = 0,
+    selected_path_buffer: [sdk.os.max_file_path_length]u8 = undefined,
+    selected_path_len: usize = 0,
+
+    const Self = @This();
+    const Task = sdk.misc.Task(?sdk.io.RecordingIndex);
+    const Entry = sdk.io.RecordingIndex.Entry;
+    pub const Action = enum { no_action, proceed, cancel };
+    const Column = enum(imgui.ImGuiID) { file, characters, duration, rounds, modified };
+    const Sort = struct {
+        column: Column,
+        descending: bool,
+    };
+
+    pub fn init(allocator: std.mem.Allocator) Self {
+        return .{ .allocator = allocator, .task = .createCompleted(null) };
+    }
+
+    pub fn deinit(self: *Self) void {
+        if (self.task.join().*) |*index| {
+            index.deinit();
+        }
+        self.rows.deinit(self.allocator);
+    }
+
+    pub fn draw(self: *Self, base_dir: *const sdk.misc.BaseDir, is_open: bool) void {
+        defer self.is_open = is_open;
+        var action = Action.no_action;
+        defer self.action = action;
+
+        if (!self.is_open and is_open) {
+            self.startIndexing(base_dir);
+            imgui.igOpenPopup_Str("Recordings Library", 0);
+        }
+
+        const display_size = imgui.igGetIO_Nil().*.DisplaySize;
+        imgui.igSetNextWindowSize(.{ .x = 0.6 * display_size.x, .y = 0.6 * display_size.y }, imgui.ImGuiCond_Appearing);
+        var remains_open = self.is_open or is_open;
+        if (!imgui.igBeginPopupModal("Recordings Library", &remains_open, 0)) {
+            return;
+        }
+        defer imgui.igEndPopup();
+
+        imgui.igSetNextItemWidth(-std.math.floatMin(f32));
+        if (imgui.igInputTextWithHint(
+            "##filter",
+            "Filter by file name or character ID",
+            &self.filter_buffer,
+            self.filter_buffer.len + 1,
+            0,
+            null,
+            null,
+        )) {
+            self.are_rows_dirty = true;
+        }
+        if (self.task.peek()) |result| {
+            if (result.*) |*index| {
+                self.drawTable(index);
+            } else {
+                imgui.igText("Failed to index the recordings. See logs for details.");
+            }
+        } else {
+            imgui.igText("Indexing recordings...");
+        }
+
+        imgui.igSeparator();
+        imgui.igBeginDisabled(self.selected_path_len == 0);
+        if (imgui.igButton("Open", .{})) {
+            action = .proceed;
+        }
+        imgui.igEndDisabled();
+        imgui.igSameLine(0, -1);
+        if (imgui.igButton("Cancel", .{})) {
+            action = .cancel;
+        }
+        if (!remains_open) {
+            action = .cancel;
+        }
+        if (!is_open) {
+            imgui.igCloseCurrentPopup();
+        }
+    }
+
+    pub fn getSelectedPath(self: *const Self) ?[:0]const u8 {
+        if (self.selected_path_len == 0) {
+            return null;
+        }
+        return self.selected_path_buffer[0..self.selected_path_len :0];
+    }
+
+    fn startIndexing(self: *Self, base_dir: *const sdk.misc.BaseDir) void {
+        if (self.task.join().*) |*index| {
+            index.deinit();
+        }
+        self.task = .createCompleted(null);
+        self.are_rows_dirty = true;
+        self.selected_row = null;
+        self.selected_path_len = 0;
+
+        const dir_path = FileDialog.createAndGetRecordingsDirectory(&self.dir_path_buffer, base_dir) catch |err| {
+            sdk.misc.error_context.append("Failed to create \"{s}\" directory.", .{FileDialog.directory_name});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+        self.dir_path_len = dir_path.len;
+        self.task = Task.spawn(
+            self.allocator,
+            struct {
+                fn call(
+                    allocator: std.mem.Allocator,
+                    path_buffer: [sdk.os.max_file_path_length]u8,
+                    path_len: usize,
+                ) ?sdk.io.RecordingIndex {
+                    const path = path_buffer[0..path_len];
+                    const extension = FileDialog.file_extension;
+                    return sdk.io.RecordingIndex.loadAndRefresh(allocator, path, extension) catch |err| {
+                        sdk.misc.error_context.append("Failed to index recordings inside: {s}", .{path});
+                        sdk.misc.error_context.logError(err);
+                        return null;
+                    };
+                }
+            }.call,
+            .{ self.allocator, self.dir_path_buffer, self.dir_path_len },
+        ) catch |err| {
+            sdk.misc.error_context.append("Failed to spawn recording indexing task.", .{});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+    }
+
+    fn drawTable(self: *Self, index: *const sdk.io.RecordingIndex) void {
+        const table_flags = imgui.ImGuiTableFlags_RowBg |
+            imgui.ImGuiTableFlags_BordersInner |
+            imgui.ImGuiTableFlags_Resizable |
+            imgui.ImGuiTableFlags_ScrollY |
+            imgui.ImGuiTableFlags_Sortable;
+        var table_size: imgui.ImVec2 = undefined;
+        imgui.igGetContentRegionAvail(&table_size);
+        table_size.y -= imgui.igGetFrameHeightWithSpacing() + imgui.igGetStyle().*.ItemSpacing.y;
+        if (table_size.y < 5) {
+            return; // Prevents crash from happening when user makes the window too small.
+        }
+        if (!imgui.igBeginTable("recordings", 5, table_flags, table_size, 0)) {
+            return;
+        }
+        defer imgui.igEndTable();
+
+        const descending = imgui.ImGuiTableColumnFlags_PreferSortDescending;
+        imgui.igTableSetupScrollFreeze(0, 1);
+        imgui.igTableSetupColumn("File", 0, 0, @intFromEnum(Column.file));
+        imgui.igTableSetupColumn("Characters", 0, 0, @intFromEnum(Column.characters));
+        imgui.igTableSetupColumn("Duration", descending, 0, @intFromEnum(Column.duration));
+        imgui.igTableSetupColumn("Rounds", descending, 0, @intFromEnum(Column.rounds));
+        imgui.igTableSetupColumn(
+            "Modified",
+            imgui.ImGuiTableColumnFlags_DefaultSort | descending,
+            0,
+            @intFromEnum(Column.modified),
+        );
+        imgui.igTableHeadersRow();
+
+        const sort_specs = imgui.igTableGetSortSpecs();
+        if (sort_specs != null and sort_specs.*.SpecsDirty) {
+            if (sort_specs.*.SpecsCount > 0) {
+                const spec = sort_specs.*.Specs[0];
+                self.sort = .{
+                    .column = @enumFromInt(spec.ColumnUserID),
+                    .descending = spec.SortDirection == imgui.ImGuiSortDirection_Descending,
+                };
+            }
+            sort_specs.*.SpecsDirty = false;
+            self.are_rows_dirty = true;
+        }
+        if (self.are_rows_dirty) {
+            self.updateRows(index);
+            self.are_rows_dirty = false;
+        }
+
+        const clipper = imgui.ImGuiListClipper_ImGuiListClipper();
+        defer imgui.ImGuiListClipper_destroy(clipper);
+        imgui.ImGuiListClipper_Begin(clipper, @intCast(self.rows.items.len), -1);
+        while (imgui.ImGuiListClipper_Step(clipper)) {
+            const start: usize = @intCast(clipper.*.DisplayStart);
+            const end: usize = @intCast(clipper.*.DisplayEnd);
+            for (self.rows.items[start..end]) |row| {
+                self.drawRow(index, row);
+            }
+        }
+    }
+
+    fn drawRow(self: *Self, index: *const sdk.io.RecordingIndex, row: usize) void {
+        const entry = &index.entries.items[row];
+        var buffer: [sdk.os.max_file_path_length]u8 = undefined;
+        imgui.igTableNextRow(0, 0);
+
+        if (imgui.igTableNextColumn()) {
+            imgui.igPushID_Int(@intCast(row));
+            defer imgui.igPopID();
+            const name = std.fmt.bufPrintZ(&buffer, "{s}", .{entry.file_name}) catch "error";
+            const flags = imgui.ImGuiSelectableFlags_SpanAllColumns;
+            if (imgui.igSelectable_Bool(name, self.selected_row == row, flags, .{})) {
+                self.select(entry, row);
+            }
+        }
+        if (imgui.igTableNextColumn()) {
+            var writer = std.io.Writer.fixed(buffer[0..(buffer.len - 1)]);
+            for (entry.labels, 0..) |label, label_index| {
+                const separator = if (label_index == 0) "" else ", ";
+                writer.print("{s}{}", .{ separator, label }) catch break;
+            }
+            buffer[writer.end] = 0;
+            const text = buffer[0..writer.end :0];
+            imgui.igText("%s", text.ptr);
+        }
+        if (imgui.igTableNextColumn()) {
+            const text = if (entry.number_of_frames) |frames| block: {
+                const seconds: u64 = @intFromFloat(@as(f64, @floatFromInt(frames)) * core.Controller.frame_time);
+                break :block std.fmt.bufPrintZ(&buffer, "{}:{:0>2}", .{ seconds / 60, seconds % 60 }) catch "error";
+            } else "?";
+            imgui.igText("%s", text.ptr);
+        }
+        if (imgui.igTableNextColumn()) {
+            const text = if (entry.number_of_frames != null) block: {
+                break :block std.fmt.bufPrintZ(&buffer, "{}", .{entry.number_of_markers}) catch "error";
+            } else "?";
+            imgui.igText("%s", text.ptr);
+        }
+        if (imgui.igTableNextColumn()) {
+            const text = if (sdk.misc.Timestamp.fromNano(entry.modified_time, .local)) |ts| block: {
+                break :block std.fmt.bufPrintZ(
+                    &buffer,
+                    "{:0>4}-{:0>2}-{:0>2} {:0>2}:{:0>2}",
+                    .{ @abs(ts.year), ts.month, ts.day, ts.hour, ts.minute },
+                ) catch "error";
+            } else |_| "?";
+            imgui.igText("%s", text.ptr);
+        }
+    }
+
+    fn select(self: *Self, entry: *const Entry, row: usize) void {
+        const dir_path = self.dir_path_buffer[0..self.dir_path_len];
+        const path = std.fmt.bufPrintZ(
+            &self.selected_path_buffer,
+            "{s}" ++ std.fs.path.sep_str ++ "{s}",
+            .{ dir_path, entry.file_name },
+        ) catch |err| {
+            sdk.misc.error_context.new("Failed to construct path of recording: {s}", .{entry.file_name});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+        self.selected_path_len = path.len;
+        self.selected_row = row;
+    }
+
+    fn updateRows(self: *Self, index: *const sdk.io.RecordingIndex) void {
+        const entries = index.entries.items;
+        self.rows.clearRetainingCapacity();
+        self.rows.ensureTotalCapacity(self.allocator, entries.len) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate {} library rows.", .{entries.len});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+        const filter = std.mem.sliceTo(&self.filter_buffer, 0);
+        for (entries, 0..) |*entry, entry_index| {
+            if (matchesFilter(entry, filter)) {
+                self.rows.appendAssumeCapacity(entry_index);
+            }
+        }
+        const Context = struct {
+            entries: []const Entry,
+            sort: Sort,
+
+            fn lessThan(context: @This(), a: usize, b: usize) bool {
+                const order = compareEntries(&context.entries[a], &context.entries[b], context.sort.column);
+                return if (context.sort.descending) order == .gt else order == .lt;
+            }
+        };
+        std.sort.pdq(usize, self.rows.items, Context{ .entries = entries, .sort = self.sort }, Context.lessThan);
+    }
+
+    fn matchesFilter(entry: *const Entry, filter: []const u8) bool {
+        const trimmed = std.mem.trim(u8, filter, " ");
+        if (trimmed.len == 0 or std.ascii.indexOfIgnoreCase(entry.file_name, trimmed) != null) {
+            return true;
+        }
+        const character_id = std.fmt.parseInt(u32, trimmed, 10) catch return false;
+        return std.mem.indexOfScalar(u32, entry.labels, character_id) != null;
+    }
+
+    fn compareEntries(a: *const Entry, b: *const Entry, column: Column) std.math.Order {
+        return switch (column) {
+            .file => std.mem.order(u8, a.file_name, b.file_name),
+            .characters => std.mem.order(u32, a.labels, b.labels),
+            .duration => std.math.order(a.number_of_frames orelse 0, b.number_of_frames orelse 0),
+            .rounds => std.math.order(a.number_of_markers, b.number_of_markers),
+            .modified => std.math.order(a.modified_time, b.modified_time),
+        };
+    }
+};
+
 const testing = std.testing;
 const testing_base_dir = sdk.misc.BaseDir.fromStr("test_assets") catch unreachable;
 
@@ -464,6 +953,12 @@ const MockController = struct {
     last_save_path: ?[]const u8 = null,
     load_call_count: usize = 0,
     last_load_path: ?[]const u8 = null,
+    save_range_call_count: usize = 0,
+    last_save_range: ?SaveRangeCall = null,
+    load_comparison_call_count: usize = 0,
+    last_load_comparison_path: ?[]const u8 = null,
+    clear_comparison_call_count: usize = 0,
+    has_comparison: bool = false,
 
     const Self = @This();
     pub const Mode = enum {
@@ -480,6 +975,17 @@ const MockController = struct {
         backward,
         neutral,
     };
+    pub const RangeEdit = enum {
+        keep,
+        delete,
+    };
+    pub const SaveRangeCall = struct {
+        path: []const u8,
+        source_path: ?[]const u8,
+        edit: RangeEdit,
+        start: usize,
+        end: usize,
+    };
 
     pub fn clear(self: *Self) void {
         self.clear_call_count += 1;
@@ -492,12 +998,40 @@ const MockController = struct {
         self.mode = .save;
     }
 
+    pub fn saveRange(
+        self: *Self,
+        path: []const u8,
+        source_path: ?[]const u8,
+        edit: RangeEdit,
+        start: usize,
+        end: usize,
+    ) void {
+        self.save_range_call_count += 1;
+        self.last_save_range = .{ .path = path, .source_path = source_path, .edit = edit, .start = start, .end = end };
+        self.mode = .save;
+    }
+
     pub fn load(self: *Self, path: []const u8) void {
         self.load_call_count += 1;
         self.last_load_path = path;
         self.mode = .load;
     }
 
+    pub fn loadComparison(self: *Self, path: []const u8) void {
+        self.load_comparison_call_count += 1;
+        self.last_load_comparison_path = path;
+        self.mode = .load;
+    }
+
+    pub fn clearComparison(self: *Self) void {
+        self.clear_comparison_call_count += 1;
+        self.has_comparison = false;
+    }
+
+    pub fn hasComparison(self: *const Self) bool {
+        return self.has_comparison;
+    }
+
     pub fn getTotalFrames(self: *const Self) usize {
         return self.total_frames;
     }
@@ -508,7 +1042,7 @@ test "should call clear on controller when new is clicked without unsaved change
         var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
         var controller: MockController = .{ .contains_unsaved_changes = false };
         var is_ui_open: bool = true;
-        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .{};
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
 
         fn selfShutdown() void {}
 
@@ -531,6 +1065,7 @@ test "should call clear on controller when new is clicked without unsaved change
     Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
     defer imgui.IGFD_Destroy(Test.file_dialog_context);
     const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
 
@@ -539,7 +1074,7 @@ test "new should be disabled when total frames is zero" {
         var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
         var controller: MockController = .{ .total_frames = 0 };
         var is_ui_open: bool = true;
-        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .{};
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
 
         fn selfShutdown() void {}
 
@@ -564,6 +1099,7 @@ test "new should be disabled when total frames is zero" {
     Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
     defer imgui.IGFD_Destroy(Test.file_dialog_context);
     const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
 
@@ -572,7 +1108,7 @@ test "should show correctly working unsaved changes dialog when new is clicked w
         var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
         var controller: MockController = .{ .contains_unsaved_changes = true };
         var is_ui_open: bool = true;
-        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .{};
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
 
         fn selfShutdown() void {}
 
@@ -643,6 +1179,7 @@ test "should show correctly working unsaved changes dialog when new is clicked w
     Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
     defer imgui.IGFD_Destroy(Test.file_dialog_context);
     const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
 
@@ -651,7 +1188,7 @@ test "should call load on controller when open is clicked without unsaved change
         var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
         var controller: MockController = .{ .contains_unsaved_changes = false };
         var is_ui_open: bool = true;
-        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .{};
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
 
         fn selfShutdown() void {}
 
@@ -692,6 +1229,56 @@ test "should call load on controller when open is clicked without unsaved change
     Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
     defer imgui.IGFD_Destroy(Test.file_dialog_context);
     const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
+    try context.runTest(.{}, Test.guiFunction, Test.testFunction);
+}
+
+test "should call load comparison on controller without linking the file when open comparison is clicked" {
+    const Test = struct {
+        var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
+        var controller: MockController = .{ .contains_unsaved_changes = true };
+        var is_ui_open: bool = true;
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
+
+        fn selfShutdown() void {}
+
+        fn guiFunction(_: sdk.ui.TestContext) !void {
+            _ = imgui.igBegin("Window", null, imgui.ImGuiWindowFlags_MenuBar);
+            defer imgui.igEnd();
+            if (!imgui.igBeginMenuBar()) return;
+            defer imgui.igEndMenuBar();
+            file_menu.draw(&testing_base_dir, file_dialog_context, &controller, &is_ui_open);
+            file_menu.update(&controller);
+        }
+
+        fn testFunction(ctx: sdk.ui.TestContext) !void {
+            try testing.expectEqual(0, controller.load_comparison_call_count);
+
+            ctx.setRef("Window");
+            ctx.menuClick("File/Open Comparison");
+            ctx.setRef("//$FOCUSED");
+            ctx.itemInputValueStr("**/##FileName", "test"); // Presses enter so no need to click OK.
+            try testing.expectEqual(1, controller.load_comparison_call_count);
+            try testing.expectEqual(0, controller.load_call_count);
+            try testing.expectEqual(0, controller.save_call_count);
+            try testing.expectStringEndsWith(controller.last_load_comparison_path.?, "test.irony");
+            controller.mode = .live;
+            controller.did_last_save_or_load_succeed = true;
+            controller.has_comparison = true;
+            ctx.yield(1);
+            try testing.expectEqual(null, file_menu.getFilePath());
+            try testing.expectEqual(true, controller.contains_unsaved_changes);
+
+            ctx.setRef("Window");
+            ctx.menuClick("File/Close Comparison");
+            try testing.expectEqual(1, controller.clear_comparison_call_count);
+            try testing.expectEqual(false, controller.has_comparison);
+        }
+    };
+    Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
+    defer imgui.IGFD_Destroy(Test.file_dialog_context);
+    const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
 
@@ -700,7 +1287,7 @@ test "should show correctly working unsaved changes dialog when open is clicked
         var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
         var controller: MockController = .{ .contains_unsaved_changes = true };
         var is_ui_open: bool = true;
-        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .{};
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
 
         fn selfShutdown() void {}
 
@@ -822,6 +1409,7 @@ test "should show correctly working unsaved changes dialog when open is clicked
     Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
     defer imgui.IGFD_Destroy(Test.file_dialog_context);
     const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
 
@@ -830,7 +1418,7 @@ test "should call save on controller when save is clicked and file is selected"
         var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
         var controller: MockController = .{};
         var is_ui_open: bool = true;
-        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .{};
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
 
         fn selfShutdown() void {}
 
@@ -879,6 +1467,7 @@ test "should call save on controller when save is clicked and file is selected"
     Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
     defer imgui.IGFD_Destroy(Test.file_dialog_context);
     const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
 
@@ -887,7 +1476,7 @@ test "save should be disabled when total frames is zero" {
         var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
         var controller: MockController = .{ .total_frames = 0 };
         var is_ui_open: bool = true;
-        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .{};
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
 
         fn selfShutdown() void {}
 
@@ -912,6 +1501,7 @@ test "save should be disabled when total frames is zero" {
     Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
     defer imgui.IGFD_Destroy(Test.file_dialog_context);
     const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
 
@@ -920,7 +1510,7 @@ test "should call save on controller when save as is clicked and file is selecte
         var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
         var controller: MockController = .{};
         var is_ui_open: bool = true;
-        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .{};
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
 
         fn selfShutdown() void {}
 
@@ -974,6 +1564,7 @@ test "should call save on controller when save as is clicked and file is selecte
     Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
     defer imgui.IGFD_Destroy(Test.file_dialog_context);
     const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
 
@@ -982,7 +1573,7 @@ test "save as should be disabled when total frames is zero" {
         var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
         var controller: MockController = .{ .total_frames = 0 };
         var is_ui_open: bool = true;
-        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .{};
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
 
         fn selfShutdown() void {}
 
@@ -1007,6 +1598,140 @@ test "save as should be disabled when total frames is zero" {
     Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
     defer imgui.IGFD_Destroy(Test.file_dialog_context);
     const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
+    try context.runTest(.{}, Test.guiFunction, Test.testFunction);
+}
+
+test "should call save range on controller when save range as is clicked and range and file are selected" {
+    const Test = struct {
+        var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
+        var controller: MockController = .{};
+        var is_ui_open: bool = true;
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
+
+        fn selfShutdown() void {}
+
+        fn guiFunction(_: sdk.ui.TestContext) !void {
+            _ = imgui.igBegin("Window", null, imgui.ImGuiWindowFlags_MenuBar);
+            defer imgui.igEnd();
+            if (!imgui.igBeginMenuBar()) return;
+            defer imgui.igEndMenuBar();
+            file_menu.draw(&testing_base_dir, file_dialog_context, &controller, &is_ui_open);
+            file_menu.update(&controller);
+        }
+
+        fn testFunction(ctx: sdk.ui.TestContext) !void {
+            try testing.expectEqual(0, controller.save_range_call_count);
+
+            ctx.setRef("Window");
+            ctx.menuClick("File/Save Range As");
+            ctx.setRef("//$FOCUSED");
+            ctx.itemClick("Cancel", imgui.ImGuiMouseButton_Left, 0);
+            try testing.expectEqual(0, controller.save_range_call_count);
+
+            ctx.setRef("Window");
+            ctx.menuClick("File/Save Range As");
+            ctx.setRef("//$FOCUSED");
+            ctx.itemInputValueInt("First Frame", 11);
+            ctx.itemInputValueInt("Last Frame", 20);
+            ctx.itemClick("OK", imgui.ImGuiMouseButton_Left, 0);
+            try testing.expectEqual(0, controller.save_range_call_count);
+            ctx.setRef("//$FOCUSED");
+            ctx.itemInputValueStr("**/##FileName", "test1"); // Presses enter so no need to click OK.
+            try testing.expectEqual(1, controller.save_range_call_count);
+            try testing.expectEqual(0, controller.save_call_count);
+            const call = controller.last_save_range.?;
+            try testing.expectStringEndsWith(call.path, "test1.irony");
+            try testing.expectEqual(null, call.source_path);
+            try testing.expectEqual(.keep, call.edit);
+            try testing.expectEqual(10, call.start);
+            try testing.expectEqual(20, call.end);
+            controller.mode = .live;
+            controller.did_last_save_or_load_succeed = true;
+            ctx.yield(1);
+            try testing.expect(file_menu.getFilePath() == null); // Saved range does not get linked.
+
+            ctx.setRef("Window");
+            ctx.menuClick("File/Save Without Range As");
+            ctx.setRef("//$FOCUSED");
+            ctx.itemClick("OK", imgui.ImGuiMouseButton_Left, 0);
+            ctx.setRef("//$FOCUSED");
+            ctx.itemInputValueStr("**/##FileName", "test2"); // Presses enter so no need to click OK.
+            try testing.expectEqual(2, controller.save_range_call_count);
+            try testing.expectEqual(.delete, controller.last_save_range.?.edit);
+            try testing.expectEqual(0, controller.last_save_range.?.start);
+            try testing.expectEqual(controller.total_frames, controller.last_save_range.?.end);
+            controller.mode = .live;
+            controller.did_last_save_or_load_succeed = true;
+            ctx.yield(1);
+        }
+    };
+    Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
+    defer imgui.IGFD_Destroy(Test.file_dialog_context);
+    const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
+    try context.runTest(.{}, Test.guiFunction, Test.testFunction);
+}
+
+test "should call load on controller when a recording is selected in the library" {
+    const Test = struct {
+        var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
+        var controller: MockController = .{};
+        var is_ui_open: bool = true;
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
+
+        fn selfShutdown() void {}
+
+        fn guiFunction(_: sdk.ui.TestContext) !void {
+            _ = imgui.igBegin("Window", null, imgui.ImGuiWindowFlags_MenuBar);
+            defer imgui.igEnd();
+            if (!imgui.igBeginMenuBar()) return;
+            defer imgui.igEndMenuBar();
+            file_menu.draw(&testing_base_dir, file_dialog_context, &controller, &is_ui_open);
+            file_menu.update(&controller);
+        }
+
+        fn testFunction(ctx: sdk.ui.TestContext) !void {
+            ctx.setRef("Window");
+            ctx.menuClick("File/Open From Library");
+            while (file_menu.library_dialog.task.peek() == null) {
+                ctx.yield(1);
+            }
+            ctx.setRef("//$FOCUSED");
+            ctx.itemClick("Cancel", imgui.ImGuiMouseButton_Left, 0);
+            try testing.expectEqual(0, controller.load_call_count);
+
+            ctx.setRef("Window");
+            ctx.menuClick("File/Open From Library");
+            while (file_menu.library_dialog.task.peek() == null) {
+                ctx.yield(1);
+            }
+            ctx.yield(1);
+            ctx.setRef("//$FOCUSED");
+            ctx.itemInputValueStr("##filter", "library");
+            ctx.itemClick("**/library_test.irony", imgui.ImGuiMouseButton_Left, 0);
+            ctx.itemClick("Open", imgui.ImGuiMouseButton_Left, 0);
+            try testing.expectEqual(1, controller.load_call_count);
+            try testing.expectStringEndsWith(controller.last_load_path.?, "library_test.irony");
+            controller.mode = .live;
+            controller.did_last_save_or_load_succeed = true;
+            ctx.yield(1);
+            try testing.expect(file_menu.getFilePath() != null);
+            try testing.expectEqualSlices(u8, controller.last_load_path.?, file_menu.getFilePath().?);
+        }
+    };
+    try std.fs.cwd().makePath("./test_assets/recordings");
+    const frames = [_]model.Frame{ .{ .frames_since_round_start = 0 }, .{ .frames_since_round_start = 1 } };
+    const file_path = "./test_assets/recordings/library_test.irony";
+    const index_path = "./test_assets/recordings/" ++ sdk.io.RecordingIndex.file_name;
+    try sdk.io.saveRecording(model.Frame, testing.allocator, &frames, file_path, &core.Controller.serialization_config);
+    defer std.fs.cwd().deleteFile(file_path) catch @panic("Failed to cleanup test file.");
+    defer std.fs.cwd().deleteFile(index_path) catch {};
+
+    Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
+    defer imgui.IGFD_Destroy(Test.file_dialog_context);
+    const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
 
@@ -1015,7 +1740,7 @@ test "should set is_ui_open to false when close ui button is clicked" {
         var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
         var controller: MockController = .{};
         var is_ui_open: bool = true;
-        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .{};
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
 
         fn selfShutdown() void {}
 
@@ -1038,6 +1763,7 @@ test "should set is_ui_open to false when close ui button is clicked" {
     Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
     defer imgui.IGFD_Destroy(Test.file_dialog_context);
     const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
 
@@ -1046,7 +1772,7 @@ test "should call self shutdown when exit is clicked without unsaved changes" {
         var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
         var controller: MockController = .{ .contains_unsaved_changes = false };
         var is_ui_open: bool = true;
-        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .{};
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
         var shutdown_call_count: usize = 0;
 
         fn selfShutdown() void {
@@ -1072,6 +1798,7 @@ test "should call self shutdown when exit is clicked without unsaved changes" {
     Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
     defer imgui.IGFD_Destroy(Test.file_dialog_context);
     const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
 
@@ -1080,7 +1807,7 @@ test "should show correctly working unsaved changes dialog when exit is clicked
         var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
         var controller: MockController = .{ .contains_unsaved_changes = true };
         var is_ui_open: bool = true;
-        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .{};
+        var file_menu: FileMenu(.{ .Controller = MockController, .selfShutDown = selfShutdown }) = .init(testing.allocator);
         var shutdown_call_count: usize = 0;
 
         fn selfShutdown() void {
@@ -1154,5 +1881,6 @@ test "should show correctly working unsaved changes dialog when exit is clicked
     Test.file_dialog_context = imgui.IGFD_Create() orelse @panic("Failed to create file dialog context.");
     defer imgui.IGFD_Destroy(Test.file_dialog_context);
     const context = try sdk.ui.getTestingContext();
+    defer Test.file_menu.deinit();
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
@@ -52,6 +52,11 @@ pub const HitLines = struct {
         }
     }
 
+    // True while the drawn lines keep fading from one update to the next, even if the frame stays the same.
+    pub fn isAnimating(self: *const Self) bool {
+        return self.lingering.len > 0;
+    }
+
     pub fn draw(
         self: *Self,
         settings: *const model.PlayerSettings(model.HitLinesSettings),
@@ -75,6 +75,21 @@ pub const HurtCylinders = struct {
         }
     }
 
+    // True while the drawn cylinders keep changing from one update to the next, even if the frame stays the same.
+    pub fn isAnimating(self: *const Self) bool {
+        if (self.lingering.len > 0) {
+            return true;
+        }
+        for (&self.connected_remaining_time.values) |*player_cylinders| {
+            for (player_cylinders.values) |remaining_time| {
+                if (remaining_time > 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
     pub fn draw(
         self: *const Self,
         settings: *const model.PlayerSettings(model.HurtCylindersSettings),
@@ -0,0 +1,547 @@
+const std = @import("std");
+const imgui = @import("imgui");
+const build_info = @import("build_info");
+const sdk = @import("../../sdk/root.zig");
+const core = @import("../core/root.zig");
+const model = @import("../model/root.zig");
+
+// Finds sequences of inputs and state changes inside the current recording or inside all the recordings from the
+// recordings directory. For example: d/f+2 pressed within 1 frame of block stun ending.
+pub const InputSearchWindow = struct {
+    allocator: std.mem.Allocator,
+    is_open: bool = false,
+    steps: [max_steps]Step = [1]Step{default_step} ** max_steps,
+    number_of_steps: usize = 1,
+    scope: Scope = .current_recording,
+    task: Task,
+    selected_row: ?usize = null,
+    pending_frame_index: ?usize = null,
+
+    const Self = @This();
+    pub const name = "Input Search";
+    pub const max_steps = 8;
+    pub const Step = core.InputQuery.Step;
+    pub const Scope = enum { current_recording, recordings_directory };
+    const Task = sdk.misc.Task(?Results);
+    const default_step = Step{ .player_id = .player_1, .event = .button_1 };
+    const recordings_directory_name = "recordings";
+    const file_extension = "." ++ @tagName(build_info.name);
+
+    pub const Results = struct {
+        file_paths: std.ArrayList([:0]u8) = .empty,
+        matches: std.ArrayList(Match) = .empty,
+        number_of_frames: usize = 0,
+        duration: u64 = 0,
+
+        pub fn deinit(self: *Results, allocator: std.mem.Allocator) void {
+            for (self.file_paths.items) |path| {
+                allocator.free(path);
+            }
+            self.file_paths.deinit(allocator);
+            self.matches.deinit(allocator);
+        }
+    };
+
+    // Null file index means the match is inside the current recording.
+    pub const Match = struct {
+        file_index: ?usize,
+        first_frame: u32,
+        last_frame: u32,
+    };
+
+    pub fn init(allocator: std.mem.Allocator) Self {
+        return .{ .allocator = allocator, .task = .createCompleted(null) };
+    }
+
+    pub fn deinit(self: *Self) void {
+        self.clearResults();
+    }
+
+    pub fn update(self: *Self, controller: *core.Controller) void {
+        const frame_index = self.pending_frame_index orelse return;
+        if (controller.mode == .load) {
+            return;
+        }
+        if (frame_index < controller.getTotalFrames()) {
+            controller.setCurrentFrameIndex(frame_index);
+        }
+        self.pending_frame_index = null;
+    }
+
+    pub fn draw(self: *Self, base_dir: *const sdk.misc.BaseDir, controller: *core.Controller) void {
+        if (!self.is_open) {
+            return;
+        }
+
+        const display_size = imgui.igGetIO_Nil().*.DisplaySize;
+        imgui.igSetNextWindowPos(
+            .{ .x = 0.5 * display_size.x, .y = 0.5 * display_size.y },
+            imgui.ImGuiCond_FirstUseEver,
+            .{ .x = 0.5, .y = 0.5 },
+        );
+        imgui.igSetNextWindowSize(.{ .x = 720, .y = 540 }, imgui.ImGuiCond_FirstUseEver);
+
+        const render_content = imgui.igBegin(name, &self.is_open, 0);
+        defer imgui.igEnd();
+        if (!render_content) {
+            return;
+        }
+
+        self.drawSteps();
+        imgui.igSeparator();
+        self.drawSearchControls(base_dir, controller);
+        imgui.igSeparator();
+        self.drawResults(controller);
+    }
+
+    pub fn getQuery(self: *const Self) core.InputQuery {
+        return .{ .steps = self.steps[0..self.number_of_steps] };
+    }
+
+    fn drawSteps(self: *Self) void {
+        const table_flags = imgui.ImGuiTableFlags_RowBg | imgui.ImGuiTableFlags_BordersInner;
+        if (imgui.igBeginTable("steps", 5, table_flags, .{}, 0)) {
+            defer imgui.igEndTable();
+            imgui.igTableSetupColumn("Player", 0, 0, 0);
+            imgui.igTableSetupColumn("Event", 0, 0, 0);
+            imgui.igTableSetupColumn("Held Inputs", 0, 0, 0);
+            imgui.igTableSetupColumn("Frames After Previous Step", 0, 0, 0);
+            imgui.igTableSetupColumn("", 0, 0, 0);
+            imgui.igTableHeadersRow();
+
+            var removed_step: ?usize = null;
+            for (self.steps[0..self.number_of_steps], 0..) |*step, index| {
+                imgui.igPushID_Int(@intCast(index));
+                defer imgui.igPopID();
+                imgui.igTableNextRow(0, 0);
+                if (imgui.igTableNextColumn()) {
+                    drawPlayerCombo(&step.player_id);
+                }
+                if (imgui.igTableNextColumn()) {
+                    drawEventCombo(&step.event);
+                }
+                if (imgui.igTableNextColumn()) {
+                    drawHeldInputs(&step.held);
+                }
+                if (imgui.igTableNextColumn()) {
+                    drawOffsets(step, index == 0);
+                }
+                if (imgui.igTableNextColumn()) {
+                    imgui.igBeginDisabled(self.number_of_steps <= 1);
+                    if (imgui.igButton("Remove", .{})) {
+                        removed_step = index;
+                    }
+                    imgui.igEndDisabled();
+                }
+            }
+            if (removed_step) |index| {
+                std.mem.copyForwards(
+                    Step,
+                    self.steps[index..(self.number_of_steps - 1)],
+                    self.steps[(index + 1)..self.number_of_steps],
+                );
+                self.number_of_steps -= 1;
+            }
+        }
+        imgui.igBeginDisabled(self.number_of_steps >= max_steps);
+        if (imgui.igButton("Add Step", .{})) {
+            const previous = &self.steps[self.number_of_steps - 1];
+            self.steps[self.number_of_steps] = .{ .player_id = previous.player_id, .event = previous.event };
+            self.number_of_steps += 1;
+        }
+        imgui.igEndDisabled();
+    }
+
+    fn drawSearchControls(self: *Self, base_dir: *const sdk.misc.BaseDir, controller: *core.Controller) void {
+        if (imgui.igRadioButton_Bool("Current Recording", self.scope == .current_recording)) {
+            self.scope = .current_recording;
+        }
+        imgui.igSameLine(0, -1);
+        if (imgui.igRadioButton_Bool("Recordings Directory", self.scope == .recordings_directory)) {
+            self.scope = .recordings_directory;
+        }
+        imgui.igSameLine(0, -1);
+        const is_searching = self.task.peek() == null;
+        const is_recording_busy = switch (controller.mode) {
+            .record, .load, .save => true,
+            else => false,
+        };
+        imgui.igBeginDisabled(is_searching or (self.scope == .current_recording and is_recording_busy));
+        if (imgui.igButton("Search", .{})) {
+            switch (self.scope) {
+                .current_recording => self.searchCurrentRecording(controller.recording.items),
+                .recordings_directory => self.startDirectorySearch(base_dir),
+            }
+        }
+        imgui.igEndDisabled();
+
+        if (self.task.peek()) |result| {
+            if (result.*) |*results| {
+                const milliseconds = @as(f64, @floatFromInt(results.duration)) / std.time.ns_per_ms;
+                imgui.igText(
+                    "Found %zu matches in %zu frames. Took %.2f ms.",
+                    results.matches.items.len,
+                    results.number_of_frames,
+                    milliseconds,
+                );
+            }
+        } else {
+            imgui.igText("Searching...");
+        }
+    }
+
+    fn drawResults(self: *Self, controller: *core.Controller) void {
+        const result = self.task.peek() orelse return;
+        const results = if (result.*) |*r| r else return;
+
+        const table_flags = imgui.ImGuiTableFlags_RowBg |
+            imgui.ImGuiTableFlags_BordersInner |
+            imgui.ImGuiTableFlags_Resizable |
+            imgui.ImGuiTableFlags_ScrollY;
+        var table_size: imgui.ImVec2 = undefined;
+        imgui.igGetContentRegionAvail(&table_size);
+        if (table_size.y < 5) {
+            return; // Prevents crash from happening when user makes the window too small.
+        }
+        if (!imgui.igBeginTable("results", 3, table_flags, table_size, 0)) {
+            return;
+        }
+        defer imgui.igEndTable();
+        imgui.igTableSetupScrollFreeze(0, 1);
+        imgui.igTableSetupColumn("Recording", 0, 0, 0);
+        imgui.igTableSetupColumn("First Frame", 0, 0, 0);
+        imgui.igTableSetupColumn("Last Frame", 0, 0, 0);
+        imgui.igTableHeadersRow();
+
+        const clipper = imgui.ImGuiListClipper_ImGuiListClipper();
+        defer imgui.ImGuiListClipper_destroy(clipper);
+        imgui.ImGuiListClipper_Begin(clipper, @intCast(results.matches.items.len), -1);
+        while (imgui.ImGuiListClipper_Step(clipper)) {
+            const start: usize = @intCast(clipper.*.DisplayStart);
+            const end: usize = @intCast(clipper.*.DisplayEnd);
+            for (results.matches.items[start..end], start..) |*match, row| {
+                self.drawRow(results, match, row, controller);
+            }
+        }
+    }
+
+    fn drawRow(
+        self: *Self,
+        results: *const Results,
+        match: *const Match,
+        row: usize,
+        controller: *core.Controller,
+    ) void {
+        var buffer: [sdk.os.max_file_path_length]u8 = undefined;
+        imgui.igTableNextRow(0, 0);
+        if (imgui.igTableNextColumn()) {
+            imgui.igPushID_Int(@intCast(row));
+            defer imgui.igPopID();
+            const file_path = if (match.file_index) |index| results.file_paths.items[index] else null;
+            const label = if (file_path) |path| sdk.os.pathToFileName(path) else "Current Recording";
+            const text = std.fmt.bufPrintZ(&buffer, "{s}", .{label}) catch "error";
+            const flags = imgui.ImGuiSelectableFlags_SpanAllColumns;
+            if (imgui.igSelectable_Bool(text, self.selected_row == row, flags, .{})) {
+                self.selected_row = row;
+                self.goToMatch(file_path, match, controller);
+            }
+        }
+        if (imgui.igTableNextColumn()) {
+            const text = std.fmt.bufPrintZ(&buffer, "{}", .{match.first_frame + 1}) catch "error";
+            imgui.igText("%s", text.ptr);
+        }
+        if (imgui.igTableNextColumn()) {
+            const text = std.fmt.bufPrintZ(&buffer, "{}", .{match.last_frame + 1}) catch "error";
+            imgui.igText("%s", text.ptr);
+        }
+    }
+
+    fn goToMatch(self: *Self, file_path_maybe: ?[:0]const u8, match: *const Match, controller: *core.Controller) void {
+        const file_path = file_path_maybe orelse {
+            controller.setCurrentFrameIndex(match.first_frame);
+            return;
+        };
+        if (controller.contains_unsaved_changes) {
+            sdk.ui.toasts.send(.warn, null, "Save the current recording before opening another one.", .{});
+            return;
+        }
+        controller.load(file_path);
+        self.pending_frame_index = match.first_frame;
+    }
+
+    fn searchCurrentRecording(self: *Self, frames: []const model.Frame) void {
+        self.clearResults();
+        var results = Results{};
+        if (searchFrames(self.allocator, frames, &self.getQuery(), null, &results)) {
+            self.task = .createCompleted(results);
+        } else |err| {
+            results.deinit(self.allocator);
+            sdk.misc.error_context.append("Failed to search the current recording.", .{});
+            sdk.misc.error_context.logError(err);
+        }
+    }
+
+    fn startDirectorySearch(self: *Self, base_dir: *const sdk.misc.BaseDir) void {
+        self.clearResults();
+        var path_buffer: [sdk.os.max_file_path_length]u8 = undefined;
+        const dir_path = base_dir.getPath(&path_buffer, recordings_directory_name) catch |err| {
+            sdk.misc.error_context.append("Failed to construct \"{s}\" directory path.", .{recordings_directory_name});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+        self.task = Task.spawn(self.allocator, struct {
+            fn call(
+                allocator: std.mem.Allocator,
+                buffer: [sdk.os.max_file_path_length]u8,
+                path_len: usize,
+                steps: [max_steps]Step,
+                number_of_steps: usize,
+            ) ?Results {
+                const path = buffer[0..path_len];
+                const query = core.InputQuery{ .steps = steps[0..number_of_steps] };
+                return searchDirectory(allocator, path, &query) catch |err| {
+                    sdk.misc.error_context.append("Failed to search recordings inside: {s}", .{path});
+                    sdk.misc.error_context.logError(err);
+                    return null;
+                };
+            }
+        }.call, .{ self.allocator, path_buffer, dir_path.len, self.steps, self.number_of_steps }) catch |err| {
+            sdk.misc.error_context.append("Failed to spawn input search task.", .{});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+    }
+
+    fn clearResults(self: *Self) void {
+        if (self.task.join().*) |*results| {
+            results.deinit(self.allocator);
+        }
+        self.task = .createCompleted(null);
+        self.selected_row = null;
+    }
+
+    fn searchDirectory(allocator: std.mem.Allocator, dir_path: []const u8, query: *const core.InputQuery) !Results {
+        var results = Results{};
+        errdefer results.deinit(allocator);
+        var timer = std.time.Timer.start() catch |err| {
+            sdk.misc.error_context.new("Failed to start timer.", .{});
+            return err;
+        };
+        var dir = std.fs.cwd().openDir(dir_path, .{ .iterate = true }) catch |err| {
+            sdk.misc.error_context.new("Failed to open directory: {s}", .{dir_path});
+            return err;
+        };
+        defer dir.close();
+        var iterator = dir.iterate();
+        while (iterator.next() catch |err| {
+            sdk.misc.error_context.new("Failed to iterate directory: {s}", .{dir_path});
+            return err;
+        }) |entry| {
+            if (entry.kind != .file or !std.mem.endsWith(u8, entry.name, file_extension)) {
+                continue;
+            }
+            const file_path = std.fs.path.joinZ(allocator, &.{ dir_path, entry.name }) catch |err| {
+                sdk.misc.error_context.new("Failed to construct path of recording: {s}", .{entry.name});
+                return err;
+            };
+            var is_path_owned = false;
+            defer if (!is_path_owned) allocator.free(file_path);
+            const config = &core.Controller.serialization_config;
+            const frames = sdk.io.loadRecording(model.Frame, allocator, file_path, config) catch |err| {
+                // One broken recording should not prevent searching through all the other ones.
+                sdk.misc.error_context.append("Failed to load recording: {s}", .{file_path});
+                sdk.misc.error_context.logError(err);
+                continue;
+            };
+            defer allocator.free(frames);
+            const number_of_matches = results.matches.items.len;
+            searchFrames(allocator, frames, query, results.file_paths.items.len, &results) catch |err| {
+                sdk.misc.error_context.append("Failed to search recording: {s}", .{file_path});
+                return err;
+            };
+            if (results.matches.items.len == number_of_matches) {
+                continue;
+            }
+            results.file_paths.append(allocator, file_path) catch |err| {
+                sdk.misc.error_context.new("Failed to append recording path.", .{});
+                return err;
+            };
+            is_path_owned = true;
+        }
+        results.duration = timer.read();
+        return results;
+    }
+
+    fn searchFrames(
+        allocator: std.mem.Allocator,
+        frames: []const model.Frame,
+        query: *const core.InputQuery,
+        file_index: ?usize,
+        results: *Results,
+    ) !void {
+        var timer = std.time.Timer.start() catch |err| {
+            sdk.misc.error_context.new("Failed to start timer.", .{});
+            return err;
+        };
+        var index = core.InputIndex.init(allocator, frames) catch |err| {
+            sdk.misc.error_context.append("Failed to index inputs.", .{});
+            return err;
+        };
+        defer index.deinit();
+        var matches: std.ArrayList(core.InputMatch) = .empty;
+        defer matches.deinit(allocator);
+        index.search(allocator, query, &matches) catch |err| {
+            sdk.misc.error_context.append("Failed to search the input index.", .{});
+            return err;
+        };
+        results.matches.ensureUnusedCapacity(allocator, matches.items.len) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate {} input search results.", .{matches.items.len});
+            return err;
+        };
+        for (matches.items) |*match| {
+            results.matches.appendAssumeCapacity(.{
+                .file_index = file_index,
+                .first_frame = match.first_frame,
+                .last_frame = match.last_frame,
+            });
+        }
+        results.number_of_frames += frames.len;
+        if (file_index == null) {
+            results.duration = timer.read();
+        }
+    }
+
+    fn drawPlayerCombo(player_id: *model.PlayerId) void {
+        imgui.igSetNextItemWidth(100);
+        const label = switch (player_id.*) {
+            .player_1 => "Player 1",
+            .player_2 => "Player 2",
+        };
+        if (imgui.igBeginCombo("##player", label, 0)) {
+            defer imgui.igEndCombo();
+            if (imgui.igSelectable_Bool("Player 1", player_id.* == .player_1, 0, .{})) {
+                player_id.* = .player_1;
+            }
+            if (imgui.igSelectable_Bool("Player 2", player_id.* == .player_2, 0, .{})) {
+                player_id.* = .player_2;
+            }
+        }
+    }
+
+    fn drawEventCombo(event: *core.InputEvent) void {
+        imgui.igSetNextItemWidth(150);
+        if (imgui.igBeginCombo("##event", getEventName(event.*), 0)) {
+            defer imgui.igEndCombo();
+            inline for (@typeInfo(core.InputEvent).@"enum".fields) |*field| {
+                const value: core.InputEvent = @enumFromInt(field.value);
+                if (imgui.igSelectable_Bool(getEventName(value), event.* == value, 0, .{})) {
+                    event.* = value;
+                }
+            }
+        }
+    }
+
+    fn drawHeldInputs(held: *model.Input) void {
+        inline for (@typeInfo(model.Input).@"struct".fields, 0..) |*field, index| {
+            if (index != 0) {
+                imgui.igSameLine(0, -1);
+            }
+            _ = imgui.igCheckbox(comptime getInputName(field.name), &@field(held, field.name));
+        }
+    }
+
+    fn drawOffsets(step: *Step, is_first: bool) void {
+        imgui.igBeginDisabled(is_first);
+        defer imgui.igEndDisabled();
+        var min_offset: c_int = step.min_offset;
+        var max_offset: c_int = step.max_offset;
+        imgui.igSetNextItemWidth(90);
+        _ = imgui.igInputInt("##min_offset", &min_offset, 1, 10, 0);
+        imgui.igSameLine(0, -1);
+        imgui.igText("to");
+        imgui.igSameLine(0, -1);
+        imgui.igSetNextItemWidth(90);
+        _ = imgui.igInputInt("##max_offset", &max_offset, 1, 10, 0);
+        step.min_offset = min_offset;
+        step.max_offset = @max(min_offset, max_offset);
+    }
+
+    fn getEventName(event: core.InputEvent) [:0]const u8 {
+        return switch (event) {
+            .blocked => "Blocked",
+            .got_hit => "Got Hit",
+            .recovered => "Recovered",
+            .block_stun_end => "Block Stun End",
+            .hit_stun_end => "Hit Stun End",
+            inline else => |input_event| "Pressed " ++ comptime getInputName(@tagName(input_event)),
+        };
+    }
+
+    fn getInputName(comptime field_name: []const u8) [:0]const u8 {
+        const names = .{
+            .forward = "f",
+            .back = "b",
+            .up = "u",
+            .down = "d",
+            .left = "l",
+            .right = "r",
+            .button_1 = "1",
+            .button_2 = "2",
+            .button_3 = "3",
+            .button_4 = "4",
+            .special_style = "ss",
+            .rage = "rage",
+            .heat = "heat",
+        };
+        return @field(names, field_name);
+    }
+};
+
+const testing = std.testing;
+
+test "should find matches in the current recording and go to the clicked match" {
+    const Test = struct {
+        var window = InputSearchWindow.init(testing.allocator);
+        var controller = core.Controller.init(testing.allocator);
+        const base_dir = sdk.misc.BaseDir.fromStr("test_assets") catch unreachable;
+
+        fn guiFunction(_: sdk.ui.TestContext) !void {
+            window.draw(&base_dir, &controller);
+            window.update(&controller);
+        }
+
+        fn testFunction(ctx: sdk.ui.TestContext) !void {
+            ctx.setRef(InputSearchWindow.name);
+            ctx.itemClick("Search", imgui.ImGuiMouseButton_Left, 0);
+            const results = &(window.task.peek().?.*.?);
+            try testing.expectEqual(1, results.matches.items.len);
+            try testing.expectEqual(null, results.matches.items[0].file_index);
+            try testing.expectEqual(3, results.matches.items[0].first_frame);
+            try testing.expectEqual(4, results.matches.items[0].last_frame);
+
+            ctx.itemClick("**/Current Recording", imgui.ImGuiMouseButton_Left, 0);
+            try testing.expectEqual(3, controller.getCurrentFrameIndex());
+        }
+    };
+    for (0..6) |index| {
+        var frame = model.Frame{};
+        frame.players[0].input = if (index % 3 == 0) .{ .button_1 = true } else .{};
+        frame.players[1].input = if (index == 4) .{ .down = true, .button_2 = true } else .{};
+        try Test.controller.recording.append(testing.allocator, frame);
+    }
+    Test.controller.mode = .{ .pause = .{ .frame_index = 0, .unprocessed_frames_start = null } };
+    defer Test.controller.deinit();
+    Test.window.is_open = true;
+    Test.window.steps[0] = .{ .player_id = .player_1, .event = .button_1 };
+    Test.window.steps[1] = .{
+        .player_id = .player_2,
+        .event = .button_2,
+        .held = .{ .down = true },
+        .min_offset = 0,
+        .max_offset = 1,
+    };
+    Test.window.number_of_steps = 2;
+    defer Test.window.deinit();
+    const context = try sdk.ui.getTestingContext();
+    try context.runTest(.{}, Test.guiFunction, Test.testFunction);
+}
@@ -1,6 +1,7 @@
 const std = @import("std");
 const imgui = @import("imgui");
 const build_info = @import("build_info");
+const dll = @import("../../dll.zig");
 const sdk = @import("../../sdk/root.zig");
 const core = @import("../core/root.zig");
 const model = @import("../model/root.zig");
@@ -8,10 +9,10 @@ const ui = @import("root.zig");
 
 pub const MainWindow = struct {
     quadrant_layout: ui.QuadrantLayout = .{},
-    view: ui.View = .{},
+    view: ui.View,
     details: ui.Details = .{},
     controls: ui.Controls(.{}) = .{},
-    file_menu: ui.FileMenu(.{}) = .{},
+    file_menu: ui.FileMenu(.{}),
     controls_height: f32 = 0,
 
     const Self = @This();
@@ -21,6 +22,18 @@ pub const MainWindow = struct {
         frame: ?*const model.Frame,
     };
 
+    pub fn init(allocator: std.mem.Allocator) Self {
+        return .{
+            .view = .init(allocator),
+            .file_menu = .init(allocator),
+        };
+    }
+
+    pub fn deinit(self: *Self) void {
+        self.file_menu.deinit();
+        self.view.deinit();
+    }
+
     pub fn processFrame(self: *Self, settings: *const model.Settings, frame: *const model.Frame) void {
         self.view.processFrame(settings, frame);
         self.details.processFrame(&settings.details, frame);
@@ -112,6 +125,20 @@ pub const MainWindow = struct {
             }
         }
 
+        if (imgui.igMenuItem_Bool(ui.InputSearchWindow.name, null, false, true)) {
+            ui_instance.input_search_window.is_open = !ui_instance.input_search_window.is_open;
+            if (ui_instance.input_search_window.is_open) {
+                imgui.igSetWindowFocus_Str(ui.InputSearchWindow.name);
+            }
+        }
+
+        if (imgui.igMenuItem_Bool(ui.MoveDatabaseWindow.name, null, false, true)) {
+            ui_instance.move_database_window.is_open = !ui_instance.move_database_window.is_open;
+            if (ui_instance.move_database_window.is_open) {
+                imgui.igSetWindowFocus_Str(ui.MoveDatabaseWindow.name);
+            }
+        }
+
         if (imgui.igBeginMenu("Help", true)) {
             defer imgui.igEndMenu();
             if (imgui.igMenuItem_Bool(ui.LogsWindow.name, null, false, true)) {
@@ -126,6 +153,10 @@ pub const MainWindow = struct {
                 ui_instance.frame_window.is_open = true;
                 imgui.igSetWindowFocus_Str(ui.FrameWindow.name);
             }
+            if (imgui.igMenuItem_Bool(ui.MemoryWindow(dll.MemoryTag).name, null, false, true)) {
+                ui_instance.memory_window.is_open = true;
+                imgui.igSetWindowFocus_Str(ui.MemoryWindow(dll.MemoryTag).name);
+            }
             imgui.igSeparator();
             if (imgui.igBeginMenu("Donate", true)) {
                 defer imgui.igEndMenu();
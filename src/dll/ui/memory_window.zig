@@ -0,0 +1,182 @@
+const std = @import("std");
+const builtin = @import("builtin");
+const imgui = @import("imgui");
+const sdk = @import("../../sdk/root.zig");
+
+pub fn MemoryWindow(comptime Tag: type) type {
+    return struct {
+        is_open: bool = false,
+        time_since_rate_update: f32 = 0,
+        last_stats: std.EnumArray(Tag, Stats) = .initFill(.{}),
+        rates: std.EnumArray(Tag, Rate) = .initFill(.{}),
+
+        const Self = @This();
+        pub const name = "Memory Usage";
+        const TaggingAllocator = sdk.misc.TaggingAllocator(Tag);
+        const Stats = TaggingAllocator.Stats;
+        const Rate = struct {
+            bytes_per_second: f32 = 0,
+            allocations_per_second: f32 = 0,
+        };
+        const rate_update_period = 1.0;
+
+        pub fn draw(self: *Self, tagging_allocator: *const TaggingAllocator) void {
+            if (!self.is_open) {
+                return;
+            }
+            self.updateRates(tagging_allocator, imgui.igGetIO_Nil().*.DeltaTime);
+
+            const display_size = imgui.igGetIO_Nil().*.DisplaySize;
+            imgui.igSetNextWindowPos(
+                .{ .x = 0.5 * display_size.x, .y = 0.5 * display_size.y },
+                imgui.ImGuiCond_FirstUseEver,
+                .{ .x = 0.5, .y = 0.5 },
+            );
+            imgui.igSetNextWindowSize(.{ .x = 600, .y = 250 }, imgui.ImGuiCond_FirstUseEver);
+
+            const render_content = imgui.igBegin(name, &self.is_open, 0);
+            defer imgui.igEnd();
+            if (!render_content) {
+                return;
+            }
+
+            if (imgui.igButton("Write To Log", .{})) {
+                tagging_allocator.logStats();
+                sdk.ui.toasts.send(.info, null, "Memory usage written to the log.", .{});
+            }
+            self.drawTable(tagging_allocator);
+        }
+
+        // Rates are measured over a period instead of every frame so the numbers stay readable.
+        fn updateRates(self: *Self, tagging_allocator: *const TaggingAllocator, delta_time: f32) void {
+            self.time_since_rate_update += delta_time;
+            if (self.time_since_rate_update < rate_update_period) {
+                return;
+            }
+            for (std.enums.values(Tag)) |tag| {
+                const stats = tagging_allocator.getStats(tag);
+                const last = self.last_stats.get(tag);
+                const bytes: f32 = @floatFromInt(stats.total_bytes -| last.total_bytes);
+                const allocations: f32 = @floatFromInt(stats.total_allocations -| last.total_allocations);
+                self.rates.set(tag, .{
+                    .bytes_per_second = bytes / self.time_since_rate_update,
+                    .allocations_per_second = allocations / self.time_since_rate_update,
+                });
+                self.last_stats.set(tag, stats);
+            }
+            self.time_since_rate_update = 0;
+        }
+
+        fn drawTable(self: *const Self, tagging_allocator: *const TaggingAllocator) void {
+            const table_flags = imgui.ImGuiTableFlags_RowBg |
+                imgui.ImGuiTableFlags_BordersInner |
+                imgui.ImGuiTableFlags_Resizable;
+            if (!imgui.igBeginTable("memory", 6, table_flags, .{}, 0)) {
+                return;
+            }
+            defer imgui.igEndTable();
+            imgui.igTableSetupColumn("Tag", 0, 0, 0);
+            imgui.igTableSetupColumn("Live", 0, 0, 0);
+            imgui.igTableSetupColumn("Live Allocations", 0, 0, 0);
+            imgui.igTableSetupColumn("Peak", 0, 0, 0);
+            imgui.igTableSetupColumn("Allocated Per Second", 0, 0, 0);
+            imgui.igTableSetupColumn("Allocations Per Second", 0, 0, 0);
+            imgui.igTableHeadersRow();
+
+            var total = Stats{};
+            var total_rate = Rate{};
+            for (std.enums.values(Tag)) |tag| {
+                const stats = tagging_allocator.getStats(tag);
+                const rate = self.rates.get(tag);
+                drawRow(@tagName(tag), &stats, &rate);
+                total.live_bytes += stats.live_bytes;
+                total.live_allocations += stats.live_allocations;
+                total.peak_bytes += stats.peak_bytes;
+                total_rate.bytes_per_second += rate.bytes_per_second;
+                total_rate.allocations_per_second += rate.allocations_per_second;
+            }
+            drawRow("total", &total, &total_rate);
+        }
+
+        fn drawRow(label: []const u8, stats: *const Stats, rate: *const Rate) void {
+            var buffer: [64]u8 = undefined;
+            imgui.igTableNextRow(0, 0);
+            if (imgui.igTableNextColumn()) {
+                const text = drawText(&buffer, "{s}", .{label});
+                if (builtin.is_test) {
+                    var rect: imgui.ImRect = undefined;
+                    imgui.igGetItemRectMin(&rect.Min);
+                    imgui.igGetItemRectMax(&rect.Max);
+                    imgui.teItemAdd(imgui.igGetCurrentContext(), imgui.igGetID_Str(text), &rect, null);
+                }
+            }
+            if (imgui.igTableNextColumn()) {
+                _ = drawText(&buffer, "{Bi:.2}", .{stats.live_bytes});
+            }
+            if (imgui.igTableNextColumn()) {
+                _ = drawText(&buffer, "{}", .{stats.live_allocations});
+            }
+            if (imgui.igTableNextColumn()) {
+                _ = drawText(&buffer, "{Bi:.2}", .{stats.peak_bytes});
+            }
+            if (imgui.igTableNextColumn()) {
+                const bytes_per_second: usize = @intFromFloat(rate.bytes_per_second);
+                _ = drawText(&buffer, "{Bi:.2}", .{bytes_per_second});
+            }
+            if (imgui.igTableNextColumn()) {
+                _ = drawText(&buffer, "{d:.1}", .{rate.allocations_per_second});
+            }
+        }
+
+        fn drawText(buffer: []u8, comptime fmt: []const u8, args: anytype) [:0]const u8 {
+            const text = std.fmt.bufPrintZ(buffer, fmt, args) catch "error";
+            imgui.igText("%s", text.ptr);
+            return text;
+        }
+    };
+}
+
+const testing = std.testing;
+
+test "should measure allocation rate of every tag" {
+    const Tag = enum { a, b };
+    var tagging_allocator = sdk.misc.TaggingAllocator(Tag).init(testing.allocator);
+    var window = MemoryWindow(Tag){};
+
+    const slice_1 = try tagging_allocator.allocator(.a).alloc(u8, 100);
+    defer tagging_allocator.allocator(.a).free(slice_1);
+    window.updateRates(&tagging_allocator, 0.5);
+    try testing.expectEqual(0, window.rates.get(.a).bytes_per_second);
+
+    const slice_2 = try tagging_allocator.allocator(.a).alloc(u8, 100);
+    defer tagging_allocator.allocator(.a).free(slice_2);
+    window.updateRates(&tagging_allocator, 0.5);
+    try testing.expectEqual(200, window.rates.get(.a).bytes_per_second);
+    try testing.expectEqual(2, window.rates.get(.a).allocations_per_second);
+    try testing.expectEqual(0, window.rates.get(.b).bytes_per_second);
+
+    window.updateRates(&tagging_allocator, 1.0);
+    try testing.expectEqual(0, window.rates.get(.a).bytes_per_second);
+}
+
+test "should draw memory usage of every tag" {
+    const Tag = enum { first_tag, second_tag };
+    const Test = struct {
+        var tagging_allocator = sdk.misc.TaggingAllocator(Tag).init(testing.allocator);
+        var window = MemoryWindow(Tag){ .is_open = true };
+
+        fn guiFunction(_: sdk.ui.TestContext) !void {
+            window.draw(&tagging_allocator);
+        }
+
+        fn testFunction(ctx: sdk.ui.TestContext) !void {
+            ctx.setRef(MemoryWindow(Tag).name);
+            try ctx.expectItemExists("Write To Log");
+            try ctx.expectItemExists("**/first_tag");
+            try ctx.expectItemExists("**/second_tag");
+            try ctx.expectItemExists("**/total");
+        }
+    };
+    const context = try sdk.ui.getTestingContext();
+    try context.runTest(.{}, Test.guiFunction, Test.testFunction);
+}
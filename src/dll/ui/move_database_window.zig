@@ -0,0 +1,345 @@
+const std = @import("std");
+const imgui = @import("imgui");
+const build_info = @import("build_info");
+const sdk = @import("../../sdk/root.zig");
+const core = @import("../core/root.zig");
+const model = @import("../model/root.zig");
+
+// Shows what the move database knows about the moves that are currently being performed and lists all known moves.
+// Opening the window ingests the recordings that were added to the recordings directory since the last time.
+pub const MoveDatabaseWindow = struct {
+    allocator: std.mem.Allocator,
+    is_open: bool = false,
+    was_open: bool = false,
+    task: Task,
+    filter_buffer: [16:0]u8 = [1:0]u8{0} ** 16,
+    rows: std.ArrayList(core.MoveKey) = .empty,
+    are_rows_dirty: bool = true,
+
+    const Self = @This();
+    pub const name = "Move Database";
+    const Task = sdk.misc.Task(?Loaded);
+    const recordings_directory_name = "recordings";
+    const file_extension = "." ++ @tagName(build_info.name);
+
+    pub const Loaded = struct {
+        database: core.MoveDatabase,
+        summary: core.MoveDatabase.IngestSummary,
+    };
+
+    pub fn init(allocator: std.mem.Allocator) Self {
+        return .{ .allocator = allocator, .task = .createCompleted(null) };
+    }
+
+    pub fn deinit(self: *Self) void {
+        if (self.task.join().*) |*loaded| {
+            loaded.database.deinit();
+        }
+        self.rows.deinit(self.allocator);
+    }
+
+    pub fn draw(self: *Self, base_dir: *const sdk.misc.BaseDir, frame: ?*const model.Frame) void {
+        defer self.was_open = self.is_open;
+        if (!self.is_open) {
+            return;
+        }
+        if (!self.was_open) {
+            self.startLoading(base_dir);
+        }
+
+        const display_size = imgui.igGetIO_Nil().*.DisplaySize;
+        imgui.igSetNextWindowPos(
+            .{ .x = 0.5 * display_size.x, .y = 0.5 * display_size.y },
+            imgui.ImGuiCond_FirstUseEver,
+            .{ .x = 0.5, .y = 0.5 },
+        );
+        imgui.igSetNextWindowSize(.{ .x = 800, .y = 500 }, imgui.ImGuiCond_FirstUseEver);
+
+        const render_content = imgui.igBegin(name, &self.is_open, 0);
+        defer imgui.igEnd();
+        if (!render_content) {
+            return;
+        }
+
+        const result = self.task.peek() orelse {
+            imgui.igText("Ingesting recordings...");
+            return;
+        };
+        const loaded = if (result.*) |*l| l else {
+            imgui.igText("Failed to load the move database. See logs for details.");
+            return;
+        };
+        const summary = &loaded.summary;
+        imgui.igText(
+            "Knows %u moves from %u recordings. Ingested %zu new recordings.",
+            loaded.database.moves.count(),
+            loaded.database.sources.count(),
+            summary.number_of_new_files - summary.number_of_failed_files,
+        );
+        if (frame) |f| {
+            drawCurrentMove(&loaded.database, "Player 1", &f.players[0]);
+            drawCurrentMove(&loaded.database, "Player 2", &f.players[1]);
+        }
+        imgui.igSeparator();
+        imgui.igSetNextItemWidth(-std.math.floatMin(f32));
+        if (imgui.igInputTextWithHint(
+            "##filter",
+            "Filter by character ID",
+            &self.filter_buffer,
+            self.filter_buffer.len + 1,
+            imgui.ImGuiInputTextFlags_CharsDecimal,
+            null,
+            null,
+        )) {
+            self.are_rows_dirty = true;
+        }
+        self.drawTable(&loaded.database);
+    }
+
+    fn startLoading(self: *Self, base_dir: *const sdk.misc.BaseDir) void {
+        if (self.task.join().*) |*loaded| {
+            loaded.database.deinit();
+        }
+        self.task = .createCompleted(null);
+        self.are_rows_dirty = true;
+
+        var path_buffer: [sdk.os.max_file_path_length]u8 = undefined;
+        const dir_path = base_dir.getPath(&path_buffer, recordings_directory_name) catch |err| {
+            sdk.misc.error_context.append("Failed to construct \"{s}\" directory path.", .{recordings_directory_name});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+        self.task = Task.spawn(self.allocator, struct {
+            fn call(
+                allocator: std.mem.Allocator,
+                buffer: [sdk.os.max_file_path_length]u8,
+                path_len: usize,
+            ) ?Loaded {
+                const path = buffer[0..path_len];
+                return load(allocator, path) catch |err| {
+                    sdk.misc.error_context.append("Failed to load move database of: {s}", .{path});
+                    sdk.misc.error_context.logError(err);
+                    return null;
+                };
+            }
+        }.call, .{ self.allocator, path_buffer, dir_path.len }) catch |err| {
+            sdk.misc.error_context.append("Failed to spawn move database task.", .{});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+    }
+
+    fn load(allocator: std.mem.Allocator, dir_path: []const u8) !Loaded {
+        std.fs.cwd().makePath(dir_path) catch |err| {
+            sdk.misc.error_context.new("Failed to make directory: {s}", .{dir_path});
+            return err;
+        };
+        const file_path = std.fs.path.join(allocator, &.{ dir_path, core.MoveDatabase.file_name }) catch |err| {
+            sdk.misc.error_context.new("Failed to construct move database path.", .{});
+            return err;
+        };
+        defer allocator.free(file_path);
+        var database = core.MoveDatabase.open(allocator, file_path) catch |err| {
+            sdk.misc.error_context.append("Failed to open move database: {s}", .{file_path});
+            return err;
+        };
+        errdefer database.deinit();
+        const summary = database.ingestDirectory(dir_path, file_extension) catch |err| {
+            sdk.misc.error_context.append("Failed to ingest recordings.", .{});
+            return err;
+        };
+        return .{ .database = database, .summary = summary };
+    }
+
+    fn drawCurrentMove(database: *const core.MoveDatabase, label: [*:0]const u8, player: *const model.Player) void {
+        const key = core.MoveKey{
+            .character_id = player.character_id orelse return,
+            .animation_id = player.animation_id orelse return,
+        };
+        const stats = database.get(key) orelse {
+            imgui.igText("%s: Animation %u was never seen attacking.", label, key.animation_id);
+            return;
+        };
+        var buffer: [256]u8 = undefined;
+        const text = std.fmt.bufPrintZ(
+            &buffer,
+            "{s}: Animation {} seen {} times. Startup {?}. On block {?} [{?} - {?}]. On hit {?}.",
+            .{
+                std.mem.span(label),
+                key.animation_id,
+                stats.getNumberOfObservations(),
+                stats.startup.getMode(),
+                stats.advantage_on_block.getMode(),
+                stats.advantage_on_block.getMin(),
+                stats.advantage_on_block.getMax(),
+                stats.advantage_on_hit.getMode(),
+            },
+        ) catch "error";
+        imgui.igText("%s", text.ptr);
+    }
+
+    fn drawTable(self: *Self, database: *const core.MoveDatabase) void {
+        const table_flags = imgui.ImGuiTableFlags_RowBg |
+            imgui.ImGuiTableFlags_BordersInner |
+            imgui.ImGuiTableFlags_Resizable |
+            imgui.ImGuiTableFlags_ScrollY;
+        var table_size: imgui.ImVec2 = undefined;
+        imgui.igGetContentRegionAvail(&table_size);
+        if (table_size.y < 5) {
+            return; // Prevents crash from happening when user makes the window too small.
+        }
+        if (!imgui.igBeginTable("moves", 8, table_flags, table_size, 0)) {
+            return;
+        }
+        defer imgui.igEndTable();
+        imgui.igTableSetupScrollFreeze(0, 1);
+        imgui.igTableSetupColumn("Character", 0, 0, 0);
+        imgui.igTableSetupColumn("Animation", 0, 0, 0);
+        imgui.igTableSetupColumn("Seen", 0, 0, 0);
+        imgui.igTableSetupColumn("Startup", 0, 0, 0);
+        imgui.igTableSetupColumn("Active", 0, 0, 0);
+        imgui.igTableSetupColumn("On Block", 0, 0, 0);
+        imgui.igTableSetupColumn("On Hit", 0, 0, 0);
+        imgui.igTableSetupColumn("Range", 0, 0, 0);
+        imgui.igTableHeadersRow();
+
+        if (self.are_rows_dirty) {
+            self.updateRows(database);
+            self.are_rows_dirty = false;
+        }
+
+        const clipper = imgui.ImGuiListClipper_ImGuiListClipper();
+        defer imgui.ImGuiListClipper_destroy(clipper);
+        imgui.ImGuiListClipper_Begin(clipper, @intCast(self.rows.items.len), -1);
+        while (imgui.ImGuiListClipper_Step(clipper)) {
+            const start: usize = @intCast(clipper.*.DisplayStart);
+            const end: usize = @intCast(clipper.*.DisplayEnd);
+            for (self.rows.items[start..end]) |key| {
+                const stats = database.get(key) orelse continue;
+                drawRow(stats);
+            }
+        }
+    }
+
+    fn drawRow(stats: *const core.MoveStats) void {
+        var buffer: [64]u8 = undefined;
+        imgui.igTableNextRow(0, 0);
+        if (imgui.igTableNextColumn()) {
+            imgui.igText("%u", stats.key.character_id);
+        }
+        if (imgui.igTableNextColumn()) {
+            imgui.igText("%u", stats.key.animation_id);
+        }
+        if (imgui.igTableNextColumn()) {
+            imgui.igText("%u", stats.getNumberOfObservations());
+        }
+        if (imgui.igTableNextColumn()) {
+            drawDistribution(&buffer, &stats.startup);
+        }
+        if (imgui.igTableNextColumn()) {
+            drawDistribution(&buffer, &stats.active);
+        }
+        if (imgui.igTableNextColumn()) {
+            drawDistribution(&buffer, &stats.advantage_on_block);
+        }
+        if (imgui.igTableNextColumn()) {
+            drawDistribution(&buffer, &stats.advantage_on_hit);
+        }
+        if (imgui.igTableNextColumn()) {
+            const range = &stats.attack_range;
+            const text = if (range.getMean()) |mean| std.fmt.bufPrintZ(
+                &buffer,
+                "{d:.2} [{d:.2} - {d:.2}]",
+                .{ mean, range.min.?, range.max.? },
+            ) catch "error" else "?";
+            imgui.igText("%s", text.ptr);
+        }
+    }
+
+    // Most common value with the observed extremes in brackets.
+    fn drawDistribution(buffer: []u8, distribution: anytype) void {
+        const text = if (distribution.getMode()) |mode| std.fmt.bufPrintZ(
+            buffer,
+            "{} [{} - {}]",
+            .{ mode, distribution.getMin().?, distribution.getMax().? },
+        ) catch "error" else "?";
+        imgui.igText("%s", text.ptr);
+    }
+
+    fn updateRows(self: *Self, database: *const core.MoveDatabase) void {
+        self.rows.clearRetainingCapacity();
+        self.rows.ensureTotalCapacity(self.allocator, database.moves.count()) catch |err| {
+            sdk.misc.error_context.new("Failed to allocate {} move rows.", .{database.moves.count()});
+            sdk.misc.error_context.logError(err);
+            return;
+        };
+        const filter = std.mem.trim(u8, std.mem.sliceTo(&self.filter_buffer, 0), " ");
+        const character_id = if (filter.len > 0) std.fmt.parseInt(u32, filter, 10) catch null else null;
+        var iterator = database.moves.keyIterator();
+        while (iterator.next()) |key| {
+            if (character_id != null and key.character_id != character_id.?) {
+                continue;
+            }
+            self.rows.appendAssumeCapacity(key.*);
+        }
+        std.sort.pdq(core.MoveKey, self.rows.items, {}, struct {
+            fn call(_: void, a: core.MoveKey, b: core.MoveKey) bool {
+                if (a.character_id != b.character_id) {
+                    return a.character_id < b.character_id;
+                }
+                return a.animation_id < b.animation_id;
+            }
+        }.call);
+    }
+};
+
+const testing = std.testing;
+
+test "should look up the moves of the current frame in the move database" {
+    const Test = struct {
+        var window = MoveDatabaseWindow.init(testing.allocator);
+        const base_dir = sdk.misc.BaseDir.fromStr("test_assets/move_database_window") catch unreachable;
+        var frame = model.Frame{};
+
+        fn guiFunction(_: sdk.ui.TestContext) !void {
+            window.draw(&base_dir, &frame);
+        }
+
+        fn testFunction(ctx: sdk.ui.TestContext) !void {
+            while (window.task.peek() == null) {
+                ctx.yield(1);
+            }
+            const loaded = &(window.task.peek().?.*.?);
+            try testing.expect(loaded.database.get(.{ .character_id = 1, .animation_id = 2 }) != null);
+            ctx.yield(1);
+            ctx.setRef(MoveDatabaseWindow.name);
+            ctx.itemInputValueStr("##filter", "1");
+            ctx.yield(1);
+            try testing.expectEqual(1, window.rows.items.len);
+            ctx.itemInputValueStr("##filter", "3");
+            ctx.yield(1);
+            try testing.expectEqual(0, window.rows.items.len);
+        }
+    };
+    const dir_path = "./test_assets/move_database_window/recordings";
+    try std.fs.cwd().makePath(dir_path);
+    defer std.fs.cwd().deleteTree("./test_assets/move_database_window") catch @panic("Failed to cleanup test files.");
+    var frames: [4]model.Frame = [1]model.Frame{.{}} ** 4;
+    for (&frames, 1..) |*frame, animation_frame| {
+        frame.players[0] = .{
+            .character_id = 1,
+            .animation_id = 2,
+            .animation_frame = @intCast(animation_frame),
+            .attack_type = .high,
+            .first_active_frame = 2,
+        };
+    }
+    const config = &core.Controller.serialization_config;
+    try sdk.io.saveRecording(model.Frame, testing.allocator, &frames, dir_path ++ "/test.irony", config);
+
+    Test.frame = frames[0];
+    Test.window.is_open = true;
+    defer Test.window.deinit();
+    const context = try sdk.ui.getTestingContext();
+    try context.runTest(.{}, Test.guiFunction, Test.testFunction);
+}
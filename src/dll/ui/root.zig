@@ -16,11 +16,14 @@ pub const GameMemoryWindow = @import("game_memory_window.zig").GameMemoryWindow;
 pub const HitLines = @import("hit_lines.zig").HitLines;
 pub const HurtCylinders = @import("hurt_cylinders.zig").HurtCylinders;
 pub const drawIngameCamera = @import("ingame_camera.zig").drawIngameCamera;
+pub const InputSearchWindow = @import("input_search_window.zig").InputSearchWindow;
 pub const LogsWindow = @import("logs_window.zig").LogsWindow;
 pub const MainWindow = @import("main_window.zig").MainWindow;
 pub const MeasureTool = @import("measure_tool.zig").MeasureTool;
+pub const MemoryWindow = @import("memory_window.zig").MemoryWindow;
 pub const MessageWindowPlacement = @import("message_window.zig").MessageWindowPlacement;
 pub const drawMessageWindow = @import("message_window.zig").drawMessageWindow;
+pub const MoveDatabaseWindow = @import("move_database_window.zig").MoveDatabaseWindow;
 pub const NavigationLayout = @import("navigation_layout.zig").NavigationLayout;
 pub const QuadrantLayout = @import("quadrant_layout.zig").QuadrantLayout;
 pub const drawPoint = @import("shapes.zig").drawPoint;
@@ -206,6 +206,27 @@ const MiscSettings = struct {
         default_settings: *const model.Settings,
     ) void {
         self.ui_font_size_input.draw(&settings.misc.ui_font_size, &default_settings.misc.ui_font_size);
+        drawBool(
+            "Record Raw Snapshots",
+            &settings.misc.record_raw_snapshots,
+            &default_settings.misc.record_raw_snapshots,
+        );
+        drawEnum(
+            model.RecordingProfile,
+            "Recording Profile",
+            &.{
+                .full = "Full",
+                .gameplay = "Gameplay (No Hurt Cylinders, Hit Lines And Camera)",
+                .inputs = "Inputs (Only Inputs, Positions, Health And Moves)",
+            },
+            &settings.misc.recording_profile,
+            &default_settings.misc.recording_profile,
+        );
+        drawBool(
+            "Instant Replay (Keep Last 30 Seconds With Insert)",
+            &settings.misc.instant_replay,
+            &default_settings.misc.instant_replay,
+        );
         imgui.igSeparator();
         self.reload_button.draw(base_dir, settings);
         self.defaults_button.draw(settings, default_settings);
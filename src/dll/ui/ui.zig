@@ -16,6 +16,9 @@ pub const Ui = struct {
     logs_window: ui.LogsWindow,
     game_memory_window: ui.GameMemoryWindow,
     frame_window: ui.FrameWindow,
+    input_search_window: ui.InputSearchWindow,
+    move_database_window: ui.MoveDatabaseWindow,
+    memory_window: ui.MemoryWindow(dll.MemoryTag),
     about_window: ui.AboutWindow(.{}),
 
     const Self = @This();
@@ -24,17 +27,23 @@ pub const Ui = struct {
         return .{
             .is_first_draw = true,
             .is_open = false,
-            .main_window = .{},
+            .main_window = .init(allocator),
             .settings_window = .init(allocator),
             .logs_window = .{},
             .game_memory_window = .{},
             .frame_window = .{},
+            .input_search_window = .init(allocator),
+            .move_database_window = .init(allocator),
+            .memory_window = .{},
             .about_window = .{},
         };
     }
 
     pub fn deinit(self: *Self) void {
+        self.main_window.deinit();
         self.settings_window.deinit();
+        self.input_search_window.deinit();
+        self.move_database_window.deinit();
     }
 
     pub fn processFrame(self: *Self, settings: *const model.Settings, frame: *const model.Frame) void {
@@ -44,6 +53,7 @@ pub const Ui = struct {
     pub fn update(self: *Self, delta_time: f32, controller: *core.Controller) void {
         sdk.ui.toasts.update(delta_time);
         self.main_window.update(delta_time, controller);
+        self.input_search_window.update(controller);
     }
 
     pub fn draw(
@@ -53,6 +63,7 @@ pub const Ui = struct {
         settings_maybe: ?*model.Settings,
         game_memory_maybe: ?*const game.Memory(build_info.game),
         controller: *core.Controller,
+        tagging_allocator: *const dll.TaggingAllocator,
     ) void {
         const font_size = if (settings_maybe) |s| s.misc.ui_font_size else sdk.ui.default_font_size;
         imgui.igPushFont(null, font_size);
@@ -93,6 +104,9 @@ pub const Ui = struct {
         self.logs_window.draw(dll.buffer_logger);
         self.game_memory_window.draw(build_info.game, game_memory);
         self.frame_window.draw(controller.getCurrentFrame());
+        self.input_search_window.draw(base_dir, controller);
+        self.move_database_window.draw(base_dir, controller.getCurrentFrame());
+        self.memory_window.draw(tagging_allocator);
         self.about_window.draw();
     }
 
@@ -10,15 +10,28 @@ pub const ViewDirection = enum {
     top,
 };
 
+const PackedSettings = sdk.misc.Packed(model.Settings);
+
 pub const View = struct {
     camera: ui.Camera = .{},
     hurt_cylinders: ui.HurtCylinders = .{},
     hit_lines: ui.HitLines = .{},
     measure_tool: ui.MeasureTool = .{},
     control_hints: ui.ControlHints = .{},
+    draw_caches: std.EnumArray(ViewDirection, sdk.ui.DrawListCache),
 
     const Self = @This();
 
+    pub fn init(allocator: std.mem.Allocator) Self {
+        return .{ .draw_caches = .initFill(.init(allocator)) };
+    }
+
+    pub fn deinit(self: *Self) void {
+        for (&self.draw_caches.values) |*cache| {
+            cache.deinit();
+        }
+    }
+
     pub fn processFrame(self: *Self, settings: *const model.Settings, frame: *const model.Frame) void {
         self.hurt_cylinders.processFrame(&settings.hurt_cylinders, frame);
         self.hit_lines.processFrame(&settings.hit_lines, frame);
@@ -44,6 +57,27 @@ pub const View = struct {
         self.measure_tool.processInput(&settings.measure_tool, matrix, inverse_matrix);
         self.camera.processInput(direction, inverse_matrix);
 
+        // While paused the same frame gets drawn over and over, so the shapes get drawn once and then replayed.
+        const cache = self.draw_caches.getPtr(direction);
+        if (self.hurt_cylinders.isAnimating() or self.hit_lines.isAnimating()) {
+            cache.invalidate();
+            self.drawShapes(settings, frame, direction, matrix, inverse_matrix);
+        } else if (!cache.begin(getCacheKey(settings, frame, direction, matrix))) {
+            self.drawShapes(settings, frame, direction, matrix, inverse_matrix);
+            cache.end();
+        }
+        self.measure_tool.draw(&settings.measure_tool, matrix);
+        self.control_hints.draw(direction);
+    }
+
+    fn drawShapes(
+        self: *Self,
+        settings: *const model.Settings,
+        frame: *const model.Frame,
+        direction: ViewDirection,
+        matrix: sdk.math.Mat4,
+        inverse_matrix: sdk.math.Mat4,
+    ) void {
         ui.drawIngameCamera(&settings.ingame_camera, frame, direction, matrix);
         ui.drawCollisionSpheres(&settings.collision_spheres, frame, matrix, inverse_matrix);
         self.hurt_cylinders.draw(&settings.hurt_cylinders, frame, direction, matrix, inverse_matrix);
@@ -51,7 +85,23 @@ pub const View = struct {
         ui.drawForwardDirections(&settings.forward_directions, frame, direction, matrix);
         ui.drawSkeletons(&settings.skeletons, frame, matrix);
         self.hit_lines.draw(&settings.hit_lines, frame, matrix);
-        self.measure_tool.draw(&settings.measure_tool, matrix);
-        self.control_hints.draw(direction);
+    }
+
+    fn getCacheKey(
+        settings: *const model.Settings,
+        frame: *const model.Frame,
+        direction: ViewDirection,
+        matrix: sdk.math.Mat4,
+    ) u64 {
+        // Hashing the packed values instead of the raw ones, so padding and payloads of null optionals, which can hold
+        // anything, don't change the key of equal settings and frames.
+        const packed_settings = PackedSettings.pack(settings);
+        const packed_frame = model.PackedFrame.pack(frame);
+        var hasher = std.hash.Wyhash.init(0);
+        hasher.update(std.mem.asBytes(&packed_settings));
+        hasher.update(std.mem.asBytes(&packed_frame));
+        std.hash.autoHash(&hasher, direction);
+        hasher.update(std.mem.asBytes(&matrix));
+        return hasher.final();
     }
 };
@@ -0,0 +1,744 @@
+const std = @import("std");
+const build_info = @import("build_info");
+const sdk = @import("sdk/root.zig");
+const core = @import("dll/core/root.zig");
+const model = @import("dll/model/root.zig");
+
+const console_logger = sdk.log.ConsoleLogger(.{ .level = .info });
+pub const std_options = std.Options{
+    .log_level = .info,
+    .logFn = console_logger.logFn,
+};
+
+const file_extension = "." ++ @tagName(build_info.name);
+const columnar_file_extension = ".columnar";
+// Small enough to keep the dictionary focused on the start of recordings, where it helps the most.
+const dictionary_size = 64 * 1024;
+
+const usage =
+    \\Usage: zig build recording -- <command> <arguments>
+    \\
+    \\Commands:
+    \\  trim <source> <destination> <start> <end>     Keep only the frames from start up to but not including end.
+    \\  delete <source> <destination> <start> <end>   Remove the frames from start up to but not including end.
+    \\  concat <destination> <source> <source>...     Join the recordings one after another.
+    \\  ingest-moves <database> <directory>           Add moves from not yet ingested recordings to the move database.
+    \\  lookup-move <database> <character> <animation> Print what the move database knows about a move.
+    \\  to-scratch <source> <destination>             Convert a recording into an uncompressed scratch recording.
+    \\  from-scratch <source> <destination>           Convert a scratch recording back into a compressed recording.
+    \\  recapture <snapshots> <destination>           Capture a recording again from raw snapshots.
+    \\  to-columnar <source> <destination>            Export a recording, or a directory of them, as columnar files.
+    \\  dedupe <directory>                            Move the recordings of the directory into a shared chunk store.
+    \\  collect-chunks <directory>                    Delete the stored chunks that no recording references anymore.
+    \\  archive <source> <destination>                Save a smaller copy with positions and rotations rounded.
+    \\  redetect <source> <destination>               Run hit and move detection again using the current logic.
+    \\  train-dictionary <directory> <destination>    Build a compression dictionary from a directory of recordings.
+    \\
+    \\Frames are counted from 0. Destination is allowed to be the same file as the source.
+    \\Untouched chunks of the source recordings get copied without being decompressed.
+    \\
+;
+
+const Command = union(enum) {
+    trim: RangeArguments,
+    delete: RangeArguments,
+    concat: ConcatArguments,
+    ingest_moves: IngestMovesArguments,
+    lookup_move: LookupMoveArguments,
+    to_scratch: ConvertArguments,
+    from_scratch: ConvertArguments,
+    recapture: ConvertArguments,
+    to_columnar: ConvertArguments,
+    dedupe: DirectoryArguments,
+    collect_chunks: DirectoryArguments,
+    archive: ConvertArguments,
+    redetect: ConvertArguments,
+    train_dictionary: ConvertArguments,
+};
+
+const RangeArguments = struct {
+    source_path: []const u8,
+    destination_path: []const u8,
+    start: usize,
+    end: usize,
+};
+
+const ConcatArguments = struct {
+    destination_path: []const u8,
+    source_paths: []const []const u8,
+};
+
+const ConvertArguments = struct {
+    source_path: []const u8,
+    destination_path: []const u8,
+};
+
+const DirectoryArguments = struct {
+    directory_path: []const u8,
+};
+
+const IngestMovesArguments = struct {
+    database_path: []const u8,
+    directory_path: []const u8,
+};
+
+const LookupMoveArguments = struct {
+    database_path: []const u8,
+    key: core.MoveKey,
+};
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    const args = std.process.argsAlloc(allocator) catch |err| {
+        sdk.misc.error_context.new("Failed to read process arguments.", .{});
+        sdk.misc.error_context.logError(err);
+        return err;
+    };
+    defer std.process.argsFree(allocator, args);
+    const command = parseCommand(args[1..]) catch |err| {
+        sdk.misc.error_context.logError(err);
+        std.debug.print("{s}", .{usage});
+        return err;
+    };
+
+    const config = &core.Controller.serialization_config;
+    var timer = std.time.Timer.start() catch |err| {
+        sdk.misc.error_context.new("Failed to start timer.", .{});
+        sdk.misc.error_context.logError(err);
+        return err;
+    };
+    const result = switch (command) {
+        .trim => |*a| sdk.io.trimRecording(
+            model.Frame,
+            allocator,
+            a.source_path,
+            a.destination_path,
+            a.start,
+            a.end,
+            config,
+        ),
+        .delete => |*a| sdk.io.deleteRecordingRange(
+            model.Frame,
+            allocator,
+            a.source_path,
+            a.destination_path,
+            a.start,
+            a.end,
+            config,
+        ),
+        .concat => |*a| sdk.io.concatenateRecordings(
+            model.Frame,
+            allocator,
+            a.source_paths,
+            a.destination_path,
+            config,
+        ),
+        .ingest_moves => |*a| ingestMoves(allocator, a),
+        .lookup_move => |*a| lookupMove(allocator, a),
+        .to_scratch => |*a| sdk.io.convertRecordingToScratch(
+            model.Frame,
+            allocator,
+            a.source_path,
+            a.destination_path,
+            config,
+        ),
+        .from_scratch => |*a| sdk.io.convertScratchToRecording(
+            model.Frame,
+            allocator,
+            a.source_path,
+            a.destination_path,
+            config,
+        ),
+        .recapture => |*a| recapture(allocator, a),
+        .to_columnar => |*a| toColumnar(allocator, a),
+        .dedupe => |*a| dedupe(allocator, a),
+        .collect_chunks => |*a| collectChunks(allocator, a),
+        .archive => |*a| archive(allocator, a),
+        .redetect => |*a| redetect(allocator, a),
+        .train_dictionary => |*a| trainDictionary(allocator, a),
+    };
+    result catch |err| {
+        sdk.misc.error_context.append("Failed to execute command: {s}", .{@tagName(command)});
+        sdk.misc.error_context.logError(err);
+        return err;
+    };
+    const elapsed_ms = @as(f64, @floatFromInt(timer.read())) / std.time.ns_per_ms;
+    std.log.info("Command {s} finished in {d:.2} ms.", .{ @tagName(command), elapsed_ms });
+}
+
+fn parseCommand(args: []const []const u8) !Command {
+    if (args.len == 0) {
+        sdk.misc.error_context.new("Missing command.", .{});
+        return error.MissingCommand;
+    }
+    const name = args[0];
+    const arguments = args[1..];
+    if (std.mem.eql(u8, name, "trim") or std.mem.eql(u8, name, "delete")) {
+        if (arguments.len != 4) {
+            sdk.misc.error_context.new("Command {s} expects 4 arguments but got: {}", .{ name, arguments.len });
+            return error.WrongNumberOfArguments;
+        }
+        const range = RangeArguments{
+            .source_path = arguments[0],
+            .destination_path = arguments[1],
+            .start = try parseFrameIndex(arguments[2]),
+            .end = try parseFrameIndex(arguments[3]),
+        };
+        if (range.start > range.end) {
+            sdk.misc.error_context.new("Range start {} is larger then range end {}.", .{ range.start, range.end });
+            return error.InvalidRange;
+        }
+        return if (name[0] == 't') .{ .trim = range } else .{ .delete = range };
+    }
+    if (std.mem.eql(u8, name, "concat")) {
+        if (arguments.len < 2) {
+            sdk.misc.error_context.new("Command concat expects at least 2 arguments but got: {}", .{arguments.len});
+            return error.WrongNumberOfArguments;
+        }
+        return .{ .concat = .{
+            .destination_path = arguments[0],
+            .source_paths = arguments[1..],
+        } };
+    }
+    if (std.mem.eql(u8, name, "ingest-moves")) {
+        if (arguments.len != 2) {
+            sdk.misc.error_context.new("Command ingest-moves expects 2 arguments but got: {}", .{arguments.len});
+            return error.WrongNumberOfArguments;
+        }
+        return .{ .ingest_moves = .{ .database_path = arguments[0], .directory_path = arguments[1] } };
+    }
+    if (std.mem.eql(u8, name, "lookup-move")) {
+        if (arguments.len != 3) {
+            sdk.misc.error_context.new("Command lookup-move expects 3 arguments but got: {}", .{arguments.len});
+            return error.WrongNumberOfArguments;
+        }
+        return .{ .lookup_move = .{
+            .database_path = arguments[0],
+            .key = .{
+                .character_id = try parseId(arguments[1]),
+                .animation_id = try parseId(arguments[2]),
+            },
+        } };
+    }
+    if (std.mem.eql(u8, name, "to-scratch") or std.mem.eql(u8, name, "from-scratch")) {
+        if (arguments.len != 2) {
+            sdk.misc.error_context.new("Command {s} expects 2 arguments but got: {}", .{ name, arguments.len });
+            return error.WrongNumberOfArguments;
+        }
+        const convert = ConvertArguments{ .source_path = arguments[0], .destination_path = arguments[1] };
+        return if (name[0] == 't') .{ .to_scratch = convert } else .{ .from_scratch = convert };
+    }
+    if (std.mem.eql(u8, name, "recapture")) {
+        if (arguments.len != 2) {
+            sdk.misc.error_context.new("Command recapture expects 2 arguments but got: {}", .{arguments.len});
+            return error.WrongNumberOfArguments;
+        }
+        return .{ .recapture = .{ .source_path = arguments[0], .destination_path = arguments[1] } };
+    }
+    if (std.mem.eql(u8, name, "archive")) {
+        if (arguments.len != 2) {
+            sdk.misc.error_context.new("Command archive expects 2 arguments but got: {}", .{arguments.len});
+            return error.WrongNumberOfArguments;
+        }
+        return .{ .archive = .{ .source_path = arguments[0], .destination_path = arguments[1] } };
+    }
+    if (std.mem.eql(u8, name, "redetect")) {
+        if (arguments.len != 2) {
+            sdk.misc.error_context.new("Command redetect expects 2 arguments but got: {}", .{arguments.len});
+            return error.WrongNumberOfArguments;
+        }
+        return .{ .redetect = .{ .source_path = arguments[0], .destination_path = arguments[1] } };
+    }
+    if (std.mem.eql(u8, name, "train-dictionary")) {
+        if (arguments.len != 2) {
+            sdk.misc.error_context.new("Command train-dictionary expects 2 arguments but got: {}", .{arguments.len});
+            return error.WrongNumberOfArguments;
+        }
+        return .{ .train_dictionary = .{ .source_path = arguments[0], .destination_path = arguments[1] } };
+    }
+    if (std.mem.eql(u8, name, "to-columnar")) {
+        if (arguments.len != 2) {
+            sdk.misc.error_context.new("Command to-columnar expects 2 arguments but got: {}", .{arguments.len});
+            return error.WrongNumberOfArguments;
+        }
+        return .{ .to_columnar = .{ .source_path = arguments[0], .destination_path = arguments[1] } };
+    }
+    if (std.mem.eql(u8, name, "dedupe") or std.mem.eql(u8, name, "collect-chunks")) {
+        if (arguments.len != 1) {
+            sdk.misc.error_context.new("Command {s} expects 1 argument but got: {}", .{ name, arguments.len });
+            return error.WrongNumberOfArguments;
+        }
+        const directory = DirectoryArguments{ .directory_path = arguments[0] };
+        return if (name[0] == 'd') .{ .dedupe = directory } else .{ .collect_chunks = directory };
+    }
+    sdk.misc.error_context.new("Unknown command: {s}", .{name});
+    return error.UnknownCommand;
+}
+
+fn parseFrameIndex(value: []const u8) !usize {
+    return std.fmt.parseInt(usize, value, 10) catch |err| {
+        sdk.misc.error_context.new("Invalid frame index: {s}", .{value});
+        return err;
+    };
+}
+
+fn parseId(value: []const u8) !u32 {
+    return std.fmt.parseInt(u32, value, 10) catch |err| {
+        sdk.misc.error_context.new("Invalid ID: {s}", .{value});
+        return err;
+    };
+}
+
+fn recapture(allocator: std.mem.Allocator, arguments: *const ConvertArguments) !void {
+    var frames: std.ArrayList(model.Frame) = .empty;
+    defer frames.deinit(allocator);
+    const Context = struct {
+        allocator: std.mem.Allocator,
+        frames: *std.ArrayList(model.Frame),
+    };
+    const context = Context{ .allocator = allocator, .frames = &frames };
+    core.replaySnapshots(allocator, arguments.source_path, &context, struct {
+        fn call(c: *const Context, frame: *const model.Frame) anyerror!void {
+            c.frames.append(c.allocator, frame.*) catch |err| {
+                sdk.misc.error_context.new("Failed to append frame.", .{});
+                return err;
+            };
+        }
+    }.call) catch |err| {
+        sdk.misc.error_context.append("Failed to replay snapshots: {s}", .{arguments.source_path});
+        return err;
+    };
+    const config = &core.Controller.serialization_config;
+    sdk.io.saveRecording(model.Frame, allocator, frames.items, arguments.destination_path, config) catch |err| {
+        sdk.misc.error_context.append("Failed to save recording: {s}", .{arguments.destination_path});
+        return err;
+    };
+    std.log.info("Captured {} frames from raw snapshots.", .{frames.items.len});
+}
+
+fn archive(allocator: std.mem.Allocator, arguments: *const ConvertArguments) !void {
+    const frames = sdk.io.loadRecording(
+        model.Frame,
+        allocator,
+        arguments.source_path,
+        &core.Controller.serialization_config,
+    ) catch |err| {
+        sdk.misc.error_context.append("Failed to load recording: {s}", .{arguments.source_path});
+        return err;
+    };
+    defer allocator.free(frames);
+    const source_stat = std.fs.cwd().statFile(arguments.source_path) catch |err| {
+        sdk.misc.error_context.new("Failed to stat file: {s}", .{arguments.source_path});
+        return err;
+    };
+    const config = &core.Controller.archival_config;
+    sdk.io.saveRecording(model.Frame, allocator, frames, arguments.destination_path, config) catch |err| {
+        sdk.misc.error_context.append("Failed to save recording: {s}", .{arguments.destination_path});
+        return err;
+    };
+    const destination_stat = std.fs.cwd().statFile(arguments.destination_path) catch |err| {
+        sdk.misc.error_context.new("Failed to stat file: {s}", .{arguments.destination_path});
+        return err;
+    };
+    std.log.info(
+        "Archived {} frames. Size went from {} to {} bytes.",
+        .{ frames.len, source_stat.size, destination_stat.size },
+    );
+}
+
+fn redetect(allocator: std.mem.Allocator, arguments: *const ConvertArguments) !void {
+    const config = &core.Controller.serialization_config;
+    const frames = sdk.io.loadRecording(model.Frame, allocator, arguments.source_path, config) catch |err| {
+        sdk.misc.error_context.append("Failed to load recording: {s}", .{arguments.source_path});
+        return err;
+    };
+    defer allocator.free(frames);
+    var pool: sdk.misc.ThreadPool = undefined;
+    pool.init(allocator, .{}) catch |err| {
+        sdk.misc.error_context.append("Failed to initialize thread pool.", .{});
+        return err;
+    };
+    defer pool.deinit();
+    const stats = core.redetectParallel(allocator, &pool, frames, .{}) catch |err| {
+        sdk.misc.error_context.append("Failed to detect {} frames.", .{frames.len});
+        return err;
+    };
+    sdk.io.saveRecording(model.Frame, allocator, frames, arguments.destination_path, config) catch |err| {
+        sdk.misc.error_context.append("Failed to save recording: {s}", .{arguments.destination_path});
+        return err;
+    };
+    std.log.info(
+        "Detected {} frames in {} chunks. {} chunks had to be detected serially.",
+        .{ frames.len, stats.number_of_chunks, stats.number_of_serial_chunks },
+    );
+}
+
+// Recordings only start using the dictionary once it gets listed inside Controller.serialization_config.dictionaries.
+fn trainDictionary(allocator: std.mem.Allocator, arguments: *const ConvertArguments) !void {
+    var dir = std.fs.cwd().openDir(arguments.source_path, .{ .iterate = true }) catch |err| {
+        sdk.misc.error_context.new("Failed to open directory: {s}", .{arguments.source_path});
+        return err;
+    };
+    defer dir.close();
+    var file_names: std.ArrayList([]const u8) = .empty;
+    defer freeFileNames(allocator, &file_names);
+    listRecordings(allocator, dir, &file_names) catch |err| {
+        sdk.misc.error_context.append("Failed to list recordings inside: {s}", .{arguments.source_path});
+        return err;
+    };
+    var paths: std.ArrayList([]const u8) = .empty;
+    defer freeFileNames(allocator, &paths);
+    for (file_names.items) |file_name| {
+        const path = std.fs.path.join(allocator, &.{ arguments.source_path, file_name }) catch |err| {
+            sdk.misc.error_context.new("Failed to join recording path.", .{});
+            return err;
+        };
+        paths.append(allocator, path) catch |err| {
+            allocator.free(path);
+            sdk.misc.error_context.new("Failed to append recording path.", .{});
+            return err;
+        };
+    }
+
+    const config = &core.Controller.serialization_config;
+    const dictionary = sdk.io.trainRecordingDictionary(
+        model.Frame,
+        allocator,
+        paths.items,
+        dictionary_size,
+        config,
+    ) catch |err| {
+        sdk.misc.error_context.append("Failed to train dictionary on {} recordings.", .{paths.items.len});
+        return err;
+    };
+    defer allocator.free(dictionary);
+    std.fs.cwd().writeFile(.{ .sub_path = arguments.destination_path, .data = dictionary }) catch |err| {
+        sdk.misc.error_context.new("Failed to write file: {s}", .{arguments.destination_path});
+        return err;
+    };
+    std.log.info("Trained a dictionary of {} bytes on {} recordings.", .{ dictionary.len, paths.items.len });
+}
+
+// A single recording gets converted into the destination file. A directory gets all of it's recordings converted into
+// the destination directory, in parallel, one columnar file per recording.
+fn toColumnar(allocator: std.mem.Allocator, arguments: *const ConvertArguments) !void {
+    const config = &core.Controller.serialization_config;
+    var source_dir = std.fs.cwd().openDir(arguments.source_path, .{ .iterate = true }) catch |err| switch (err) {
+        error.NotDir => return sdk.io.convertRecordingToColumnar(
+            model.Frame,
+            allocator,
+            arguments.source_path,
+            arguments.destination_path,
+            config,
+        ),
+        else => {
+            sdk.misc.error_context.new("Failed to open directory: {s}", .{arguments.source_path});
+            return err;
+        },
+    };
+    defer source_dir.close();
+    std.fs.cwd().makePath(arguments.destination_path) catch |err| {
+        sdk.misc.error_context.new("Failed to create directory: {s}", .{arguments.destination_path});
+        return err;
+    };
+
+    var file_names: std.ArrayList([]const u8) = .empty;
+    defer freeFileNames(allocator, &file_names);
+    listRecordings(allocator, source_dir, &file_names) catch |err| {
+        sdk.misc.error_context.append("Failed to list recordings inside: {s}", .{arguments.source_path});
+        return err;
+    };
+
+    var pool: sdk.misc.ThreadPool = undefined;
+    pool.init(allocator, .{}) catch |err| {
+        sdk.misc.error_context.append("Failed to initialize thread pool.", .{});
+        return err;
+    };
+    defer pool.deinit();
+    var context = ColumnarContext{
+        .allocator = allocator,
+        .arguments = arguments,
+        .file_names = file_names.items,
+    };
+    pool.parallelFor(allocator, file_names.items.len, &context, ColumnarContext.convertRange) catch |err| {
+        sdk.misc.error_context.append("Failed to convert recordings in parallel.", .{});
+        return err;
+    };
+    const number_of_failed = context.number_of_failed.load(.monotonic);
+    std.log.info(
+        "Found {} recordings. Converted {} recordings. Failed to convert {} recordings.",
+        .{ file_names.items.len, file_names.items.len - number_of_failed, number_of_failed },
+    );
+}
+
+// Appends the names of all the recording files inside the directory.
+fn listRecordings(allocator: std.mem.Allocator, dir: std.fs.Dir, file_names: *std.ArrayList([]const u8)) !void {
+    var iterator = dir.iterate();
+    while (iterator.next() catch |err| {
+        sdk.misc.error_context.new("Failed to iterate directory.", .{});
+        return err;
+    }) |entry| {
+        if (entry.kind != .file or !std.mem.endsWith(u8, entry.name, file_extension)) {
+            continue;
+        }
+        const file_name = allocator.dupe(u8, entry.name) catch |err| {
+            sdk.misc.error_context.new("Failed to copy file name: {s}", .{entry.name});
+            return err;
+        };
+        file_names.append(allocator, file_name) catch |err| {
+            allocator.free(file_name);
+            sdk.misc.error_context.new("Failed to append file name.", .{});
+            return err;
+        };
+    }
+}
+
+fn freeFileNames(allocator: std.mem.Allocator, file_names: *std.ArrayList([]const u8)) void {
+    for (file_names.items) |file_name| {
+        allocator.free(file_name);
+    }
+    file_names.deinit(allocator);
+}
+
+// Creates a chunk store inside the directory and saves every recording of the directory again, which turns the
+// recordings into manifests that reference chunks inside the store.
+fn dedupe(allocator: std.mem.Allocator, arguments: *const DirectoryArguments) !void {
+    sdk.io.ChunkStore.create(arguments.directory_path) catch |err| {
+        sdk.misc.error_context.append("Failed to create chunk store.", .{});
+        return err;
+    };
+    var dir = std.fs.cwd().openDir(arguments.directory_path, .{ .iterate = true }) catch |err| {
+        sdk.misc.error_context.new("Failed to open directory: {s}", .{arguments.directory_path});
+        return err;
+    };
+    defer dir.close();
+    var file_names: std.ArrayList([]const u8) = .empty;
+    defer freeFileNames(allocator, &file_names);
+    listRecordings(allocator, dir, &file_names) catch |err| {
+        sdk.misc.error_context.append("Failed to list recordings inside: {s}", .{arguments.directory_path});
+        return err;
+    };
+
+    const config = &core.Controller.serialization_config;
+    var number_of_failed: usize = 0;
+    for (file_names.items) |file_name| {
+        const path = std.fs.path.join(allocator, &.{ arguments.directory_path, file_name }) catch |err| {
+            sdk.misc.error_context.new("Failed to join recording path.", .{});
+            return err;
+        };
+        defer allocator.free(path);
+        const frames = sdk.io.loadRecording(model.Frame, allocator, path, config) catch |err| {
+            sdk.misc.error_context.append("Failed to load recording: {s}", .{path});
+            sdk.misc.error_context.logWarning(err);
+            number_of_failed += 1;
+            continue;
+        };
+        defer allocator.free(frames);
+        sdk.io.saveRecording(model.Frame, allocator, frames, path, config) catch |err| {
+            sdk.misc.error_context.append("Failed to save recording: {s}", .{path});
+            sdk.misc.error_context.logWarning(err);
+            number_of_failed += 1;
+            continue;
+        };
+    }
+    std.log.info(
+        "Found {} recordings. Moved {} recordings into the chunk store. Failed to move {} recordings.",
+        .{ file_names.items.len, file_names.items.len - number_of_failed, number_of_failed },
+    );
+}
+
+// Counts the references of every recording inside the directory from scratch and deletes the chunks without any.
+// Needed after recordings of the directory get deleted, since deleting a file doesn't release it's chunks.
+fn collectChunks(allocator: std.mem.Allocator, arguments: *const DirectoryArguments) !void {
+    var dir = std.fs.cwd().openDir(arguments.directory_path, .{ .iterate = true }) catch |err| {
+        sdk.misc.error_context.new("Failed to open directory: {s}", .{arguments.directory_path});
+        return err;
+    };
+    defer dir.close();
+    var file_names: std.ArrayList([]const u8) = .empty;
+    defer freeFileNames(allocator, &file_names);
+    listRecordings(allocator, dir, &file_names) catch |err| {
+        sdk.misc.error_context.append("Failed to list recordings inside: {s}", .{arguments.directory_path});
+        return err;
+    };
+
+    const maybe_store = sdk.io.ChunkStore.open(arguments.directory_path) catch |err| {
+        sdk.misc.error_context.append("Failed to open chunk store.", .{});
+        return err;
+    };
+    var store = maybe_store orelse {
+        sdk.misc.error_context.new("There is no chunk store inside: {s}", .{arguments.directory_path});
+        return error.MissingChunkStore;
+    };
+    defer store.close();
+    // Waits for saves in progress and keeps new ones from changing the references while the references get counted.
+    store.lock(.exclusive) catch |err| {
+        sdk.misc.error_context.append("Failed to lock chunk store.", .{});
+        return err;
+    };
+    defer store.unlock();
+
+    var references: std.ArrayList(sdk.io.ChunkHash) = .empty;
+    defer references.deinit(allocator);
+    for (file_names.items) |file_name| {
+        const path = std.fs.path.join(allocator, &.{ arguments.directory_path, file_name }) catch |err| {
+            sdk.misc.error_context.new("Failed to join recording path.", .{});
+            return err;
+        };
+        defer allocator.free(path);
+        // A recording that can't be read might still reference chunks, so it's safer to delete nothing.
+        const file_references = sdk.io.loadRecordingChunkReferences(allocator, path) catch |err| {
+            sdk.misc.error_context.append("Failed to load chunk references of: {s}", .{path});
+            return err;
+        };
+        defer allocator.free(file_references);
+        references.appendSlice(allocator, file_references) catch |err| {
+            sdk.misc.error_context.new("Failed to append chunk references.", .{});
+            return err;
+        };
+    }
+    const number_of_deleted = store.rebuildReferences(allocator, references.items) catch |err| {
+        sdk.misc.error_context.append("Failed to rebuild chunk references.", .{});
+        return err;
+    };
+    std.log.info(
+        "Found {} recordings referencing {} chunks. Deleted {} unreferenced chunks.",
+        .{ file_names.items.len, references.items.len, number_of_deleted },
+    );
+}
+
+const ColumnarContext = struct {
+    allocator: std.mem.Allocator,
+    arguments: *const ConvertArguments,
+    file_names: []const []const u8,
+    number_of_failed: std.atomic.Value(usize) = .init(0),
+
+    const Self = @This();
+
+    fn convertRange(self: *Self, start: usize, end: usize) void {
+        for (self.file_names[start..end]) |file_name| {
+            self.convert(file_name) catch |err| {
+                sdk.misc.error_context.append("Failed to convert recording: {s}", .{file_name});
+                sdk.misc.error_context.logWarning(err);
+                _ = self.number_of_failed.fetchAdd(1, .monotonic);
+            };
+        }
+    }
+
+    fn convert(self: *const Self, file_name: []const u8) !void {
+        const source_path = std.fs.path.join(self.allocator, &.{ self.arguments.source_path, file_name }) catch |err| {
+            sdk.misc.error_context.new("Failed to join source path.", .{});
+            return err;
+        };
+        defer self.allocator.free(source_path);
+        const stem = file_name[0 .. file_name.len - file_extension.len];
+        const destination_name = std.mem.concat(self.allocator, u8, &.{ stem, columnar_file_extension }) catch |err| {
+            sdk.misc.error_context.new("Failed to build destination file name.", .{});
+            return err;
+        };
+        defer self.allocator.free(destination_name);
+        const destination_path = std.fs.path.join(
+            self.allocator,
+            &.{ self.arguments.destination_path, destination_name },
+        ) catch |err| {
+            sdk.misc.error_context.new("Failed to join destination path.", .{});
+            return err;
+        };
+        defer self.allocator.free(destination_path);
+        const config = &core.Controller.serialization_config;
+        try sdk.io.convertRecordingToColumnar(model.Frame, self.allocator, source_path, destination_path, config);
+    }
+};
+
+fn ingestMoves(allocator: std.mem.Allocator, arguments: *const IngestMovesArguments) !void {
+    var database = core.MoveDatabase.open(allocator, arguments.database_path) catch |err| {
+        sdk.misc.error_context.append("Failed to open move database: {s}", .{arguments.database_path});
+        return err;
+    };
+    defer database.deinit();
+    const summary = database.ingestDirectory(arguments.directory_path, file_extension) catch |err| {
+        sdk.misc.error_context.append("Failed to ingest recordings from: {s}", .{arguments.directory_path});
+        return err;
+    };
+    std.log.info(
+        "Found {} recordings. Ingested {} new recordings containing {} moves. Failed to ingest {} recordings.",
+        .{
+            summary.number_of_files,
+            summary.number_of_new_files - summary.number_of_failed_files,
+            summary.number_of_observations,
+            summary.number_of_failed_files,
+        },
+    );
+}
+
+fn lookupMove(allocator: std.mem.Allocator, arguments: *const LookupMoveArguments) !void {
+    var database = core.MoveDatabase.open(allocator, arguments.database_path) catch |err| {
+        sdk.misc.error_context.append("Failed to open move database: {s}", .{arguments.database_path});
+        return err;
+    };
+    defer database.deinit();
+    const key = &arguments.key;
+    const stats = database.get(key.*) orelse {
+        sdk.misc.error_context.new(
+            "Move database contains no move with character ID {} and animation ID {}.",
+            .{ key.character_id, key.animation_id },
+        );
+        return error.MoveNotFound;
+    };
+    var buffer: [4096]u8 = undefined;
+    var stdout_writer = std.fs.File.stdout().writer(&buffer);
+    const writer = &stdout_writer.interface;
+    writer.print("Character: {}\nAnimation: {}\n", .{ key.character_id, key.animation_id }) catch |err| {
+        sdk.misc.error_context.new("Failed to write to standard output.", .{});
+        return err;
+    };
+    writer.print("Seen: {} times ({} whiffed, {} blocked, {} hit)\n", .{
+        stats.getNumberOfObservations(),
+        stats.number_of_whiffs,
+        stats.number_of_blocks,
+        stats.number_of_hits,
+    }) catch |err| {
+        sdk.misc.error_context.new("Failed to write to standard output.", .{});
+        return err;
+    };
+    writer.print("Startup: {?} [{?} - {?}]\nActive: {?} [{?} - {?}]\n", .{
+        stats.startup.getMode(),
+        stats.startup.getMin(),
+        stats.startup.getMax(),
+        stats.active.getMode(),
+        stats.active.getMin(),
+        stats.active.getMax(),
+    }) catch |err| {
+        sdk.misc.error_context.new("Failed to write to standard output.", .{});
+        return err;
+    };
+    writer.print("Attack Range: {?d:.2} [{?d:.2} - {?d:.2}]\nRecovery Range: {?d:.2} [{?d:.2} - {?d:.2}]\n", .{
+        stats.attack_range.getMean(),
+        stats.attack_range.min,
+        stats.attack_range.max,
+        stats.recovery_range.getMean(),
+        stats.recovery_range.min,
+        stats.recovery_range.max,
+    }) catch |err| {
+        sdk.misc.error_context.new("Failed to write to standard output.", .{});
+        return err;
+    };
+    writer.print("On Block: {?} [{?} - {?}]\nOn Hit: {?} [{?} - {?}]\n", .{
+        stats.advantage_on_block.getMode(),
+        stats.advantage_on_block.getMin(),
+        stats.advantage_on_block.getMax(),
+        stats.advantage_on_hit.getMode(),
+        stats.advantage_on_hit.getMin(),
+        stats.advantage_on_hit.getMax(),
+    }) catch |err| {
+        sdk.misc.error_context.new("Failed to write to standard output.", .{});
+        return err;
+    };
+    writer.flush() catch |err| {
+        sdk.misc.error_context.new("Failed to flush standard output.", .{});
+        return err;
+    };
+}
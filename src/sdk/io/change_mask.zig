@@ -0,0 +1,141 @@
+const std = @import("std");
+
+// Bitmask of the bytes that differ between two values of the same type, computed a whole vector of bytes at a time.
+// Padding between struct fields is left out of the comparison, so it doesn't matter what the padding contains. Padding
+// inside optionals and unions can't be located at comptime, so all of their bytes get compared.
+pub fn ChangeMask(comptime Type: type) type {
+    return struct {
+        blocks: [number_of_blocks]Block,
+
+        const Self = @This();
+        const block_len = std.simd.suggestVectorLength(u8) orelse 16;
+        const number_of_full_blocks = @sizeOf(Type) / block_len;
+        const number_of_blocks = std.math.divCeil(usize, @sizeOf(Type), block_len) catch unreachable;
+        const Block = std.meta.Int(.unsigned, block_len);
+        const Vector = @Vector(block_len, u8);
+        const significant_blocks = getSignificantBlocks();
+
+        pub fn init(value_1: *const Type, value_2: *const Type) Self {
+            const bytes_1 = std.mem.asBytes(value_1);
+            const bytes_2 = std.mem.asBytes(value_2);
+            var self: Self = undefined;
+            for (0..number_of_full_blocks) |index| {
+                const vector_1: Vector = bytes_1[(index * block_len)..][0..block_len].*;
+                const vector_2: Vector = bytes_2[(index * block_len)..][0..block_len].*;
+                const differs: Block = @bitCast(vector_1 != vector_2);
+                self.blocks[index] = differs & significant_blocks[index];
+            }
+            if (number_of_full_blocks < number_of_blocks) {
+                const start = number_of_full_blocks * block_len;
+                var tail_1 = [1]u8{0} ** block_len;
+                var tail_2 = [1]u8{0} ** block_len;
+                @memcpy(tail_1[0..(@sizeOf(Type) - start)], bytes_1[start..]);
+                @memcpy(tail_2[0..(@sizeOf(Type) - start)], bytes_2[start..]);
+                const vector_1: Vector = tail_1;
+                const vector_2: Vector = tail_2;
+                const differs: Block = @bitCast(vector_1 != vector_2);
+                self.blocks[number_of_full_blocks] = differs & significant_blocks[number_of_full_blocks];
+            }
+            return self;
+        }
+
+        // True if any significant byte inside the region differs. Region is given in bytes from the start of the value.
+        pub fn isChanged(self: *const Self, comptime offset: usize, comptime size: usize) bool {
+            if (offset + size > @sizeOf(Type)) {
+                @compileError(std.fmt.comptimePrint("Region [{}, {}) is out of bounds.", .{ offset, offset + size }));
+            }
+            comptime var position = offset;
+            inline while (position < offset + size) {
+                const start = position % block_len;
+                const end = @min(block_len, start + offset + size - position);
+                const bits: Block = comptime (((1 << (end - start)) - 1) << start);
+                if ((self.blocks[position / block_len] & bits) != 0) {
+                    return true;
+                }
+                position += end - start;
+            }
+            return false;
+        }
+
+        fn getSignificantBlocks() [number_of_blocks]Block {
+            comptime {
+                @setEvalBranchQuota(100 * number_of_blocks * block_len + 1000);
+                var significant = [1]bool{false} ** (number_of_blocks * block_len);
+                markSignificantBytes(Type, significant[0..@sizeOf(Type)]);
+                var blocks: [number_of_blocks]Block = undefined;
+                for (&blocks, 0..) |*block, index| {
+                    var bits: Block = 0;
+                    for (0..block_len) |bit_index| {
+                        if (significant[index * block_len + bit_index]) {
+                            bits |= @as(Block, 1) << bit_index;
+                        }
+                    }
+                    block.* = bits;
+                }
+                return blocks;
+            }
+        }
+    };
+}
+
+fn markSignificantBytes(comptime Type: type, bytes: []bool) void {
+    switch (@typeInfo(Type)) {
+        .@"struct" => |*info| if (info.layout != .@"packed") {
+            for (info.fields) |*field| {
+                if (field.is_comptime) {
+                    continue;
+                }
+                const offset = @offsetOf(Type, field.name);
+                markSignificantBytes(field.type, bytes[offset..][0..@sizeOf(field.type)]);
+            }
+            return;
+        },
+        .array => |*info| {
+            const size = @sizeOf(info.child);
+            for (0..info.len) |index| {
+                markSignificantBytes(info.child, bytes[(index * size)..][0..size]);
+            }
+            return;
+        },
+        else => {},
+    }
+    @memset(bytes, true);
+}
+
+const testing = std.testing;
+
+test "isChanged should detect changes only inside the changed regions" {
+    const Type = struct { a: [40]u8, b: u32, c: [30]u16 };
+    var value_1 = Type{ .a = [1]u8{1} ** 40, .b = 2, .c = [1]u16{3} ** 30 };
+    var value_2 = value_1;
+    try testing.expect(!ChangeMask(Type).init(&value_1, &value_2).isChanged(0, @sizeOf(Type)));
+
+    value_2.a[39] = 4;
+    value_2.c[29] = 5;
+    const mask = ChangeMask(Type).init(&value_1, &value_2);
+    const a_offset = @offsetOf(Type, "a");
+    const c_offset = @offsetOf(Type, "c");
+    try testing.expect(mask.isChanged(a_offset, 40));
+    try testing.expect(mask.isChanged(a_offset + 39, 1));
+    try testing.expect(!mask.isChanged(a_offset, 39));
+    try testing.expect(!mask.isChanged(@offsetOf(Type, "b"), 4));
+    try testing.expect(mask.isChanged(c_offset + 58, 2));
+    try testing.expect(!mask.isChanged(c_offset, 58));
+    value_1 = value_2;
+    try testing.expect(!ChangeMask(Type).init(&value_1, &value_2).isChanged(0, @sizeOf(Type)));
+}
+
+test "isChanged should ignore padding between struct fields" {
+    const Type = extern struct { a: u8, b: u32 };
+    var bytes_1: [@sizeOf(Type)]u8 align(@alignOf(Type)) = undefined;
+    var bytes_2: [@sizeOf(Type)]u8 align(@alignOf(Type)) = undefined;
+    const value_1: *Type = @ptrCast(&bytes_1);
+    const value_2: *Type = @ptrCast(&bytes_2);
+    value_1.* = .{ .a = 1, .b = 2 };
+    value_2.* = .{ .a = 1, .b = 2 };
+    @memset(bytes_1[1..4], 0xAA);
+    @memset(bytes_2[1..4], 0x55);
+    try testing.expect(!ChangeMask(Type).init(value_1, value_2).isChanged(0, @sizeOf(Type)));
+    value_2.b = 3;
+    try testing.expect(ChangeMask(Type).init(value_1, value_2).isChanged(0, @sizeOf(Type)));
+}
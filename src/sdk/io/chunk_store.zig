@@ -0,0 +1,525 @@
+const std = @import("std");
+const build_info = @import("build_info");
+const misc = @import("../misc/root.zig");
+
+// Content addressed store of compressed recording chunks, shared by all the recordings of a library directory.
+// Recordings saved into a directory that contains a store are written as manifests that reference chunks by hash, so
+// a chunk that appears in many recordings is stored only once. Chunks are keyed by the hash of their uncompressed
+// encoding, which lets the writer skip compressing chunks that are already inside the store.
+// Every chunk has a reference count. A chunk gets deleted once no manifest references it anymore.
+// The store can be shared by several processes, so it gets guarded by file locks instead of in process mutexes. Saves
+// hold a shared lock on the store for their whole duration, which lets them compress and put chunks at the same time.
+// Deleting chunks needs a exclusive lock, since a save that holds a shared lock might have found the chunk inside the
+// store and is about to reference it. Reference counts get read, modified and written back under a separate lock.
+//
+// Directory structure:
+// .chunk_store/lock                locked shared by saves and exclusive when deleting chunks
+// .chunk_store/references.lock     locked exclusive while reference counts get read, modified and written back
+// .chunk_store/references          reference count of every chunk
+// .chunk_store/blocks/ab/abcd...   compressed chunk blocks, named by their hash in hex
+//
+// References file structure:
+// magic number | version | number of chunks | (hash | reference count)...
+
+pub const ChunkHash = [std.crypto.hash.Blake3.digest_length]u8;
+
+const VersionNumber = u16;
+const NumberOfChunks = u64;
+const ReferenceCount = u32;
+const References = std.AutoHashMapUnmanaged(ChunkHash, ReferenceCount);
+
+const endian = std.builtin.Endian.little;
+const magic_number = @tagName(build_info.name) ++ "-chunk-references";
+const version_number = 1;
+const store_dir_name = ".chunk_store";
+const blocks_dir_name = "blocks";
+const references_file_name = "references";
+const lock_file_name = "lock";
+const references_lock_file_name = "references.lock";
+const max_block_size = std.math.maxInt(u32);
+const max_references_file_size = 1024 * 1024 * 1024;
+const buffer_size = 4096;
+
+pub const ChunkStore = struct {
+    dir: std.fs.Dir,
+    lock_file: ?std.fs.File = null,
+
+    const Self = @This();
+
+    // Makes the directory a library with a chunk store. Does nothing if it already is one.
+    pub fn create(library_path: []const u8) !void {
+        var library_dir = std.fs.cwd().openDir(library_path, .{}) catch |err| {
+            misc.error_context.new("Failed to open directory: {s}", .{library_path});
+            return err;
+        };
+        defer library_dir.close();
+        library_dir.makePath(store_dir_name ++ std.fs.path.sep_str ++ blocks_dir_name) catch |err| {
+            misc.error_context.new("Failed to create chunk store directory inside: {s}", .{library_path});
+            return err;
+        };
+    }
+
+    // Opens the store of the library that the recording file is inside of. Returns null when there is no store.
+    pub fn openForRecording(file_path: []const u8) !?Self {
+        return open(std.fs.path.dirname(file_path) orelse ".");
+    }
+
+    // Returns null when the directory is not a library with a chunk store.
+    pub fn open(library_path: []const u8) !?Self {
+        var library_dir = std.fs.cwd().openDir(library_path, .{}) catch |err| switch (err) {
+            error.FileNotFound => return null,
+            else => {
+                misc.error_context.new("Failed to open directory: {s}", .{library_path});
+                return err;
+            },
+        };
+        defer library_dir.close();
+        const dir = library_dir.openDir(store_dir_name, .{ .iterate = true }) catch |err| switch (err) {
+            error.FileNotFound => return null,
+            else => {
+                misc.error_context.new("Failed to open chunk store inside: {s}", .{library_path});
+                return err;
+            },
+        };
+        return .{ .dir = dir };
+    }
+
+    pub fn close(self: *Self) void {
+        self.unlock();
+        self.dir.close();
+        self.* = undefined;
+    }
+
+    // A shared lock has to be held from looking up chunks of a recording that is getting written until it's references
+    // are added. A exclusive lock waits for all the saves to finish and is needed for deleting chunks.
+    pub fn lock(self: *Self, mode: std.fs.File.Lock) !void {
+        std.debug.assert(self.lock_file == null);
+        self.lock_file = self.dir.createFile(lock_file_name, .{ .truncate = false, .lock = mode }) catch |err| {
+            misc.error_context.new("Failed to lock file: {s}", .{lock_file_name});
+            return err;
+        };
+    }
+
+    // Returns false instead of waiting when the lock is held by someone else.
+    pub fn tryLock(self: *Self, mode: std.fs.File.Lock) !bool {
+        std.debug.assert(self.lock_file == null);
+        self.lock_file = self.dir.createFile(
+            lock_file_name,
+            .{ .truncate = false, .lock = mode, .lock_nonblocking = true },
+        ) catch |err| switch (err) {
+            error.WouldBlock => return false,
+            else => {
+                misc.error_context.new("Failed to lock file: {s}", .{lock_file_name});
+                return err;
+            },
+        };
+        return true;
+    }
+
+    // Does nothing when the store is not locked.
+    pub fn unlock(self: *Self) void {
+        const file = self.lock_file orelse return;
+        file.close();
+        self.lock_file = null;
+    }
+
+    // The field list is part of the key, since the encoded chunk means nothing without it.
+    pub fn hashChunk(field_list: []const u8, encoded_chunk: []const u8) ChunkHash {
+        var hasher = std.crypto.hash.Blake3.init(.{});
+        var length_bytes: [@sizeOf(u64)]u8 = undefined;
+        std.mem.writeInt(u64, &length_bytes, field_list.len, endian);
+        hasher.update(&length_bytes);
+        hasher.update(field_list);
+        hasher.update(encoded_chunk);
+        var hash: ChunkHash = undefined;
+        hasher.final(&hash);
+        return hash;
+    }
+
+    pub fn contains(self: *const Self, hash: *const ChunkHash) bool {
+        const path = getBlockPath(hash);
+        self.dir.access(&path, .{}) catch return false;
+        return true;
+    }
+
+    // Blocks are written into a temporary file first, so a interrupted write never leaves a broken block behind.
+    // Temporary file name is random, since saves that hold a shared lock can put the same chunk at the same time.
+    pub fn put(self: *const Self, hash: *const ChunkHash, block: []const u8) !void {
+        if (self.contains(hash)) {
+            return;
+        }
+        const path = getBlockPath(hash);
+        self.dir.makePath(std.fs.path.dirname(&path).?) catch |err| {
+            misc.error_context.new("Failed to create chunk directory for: {s}", .{&path});
+            return err;
+        };
+        var temp_path_buffer: [path.len + 22]u8 = undefined;
+        const temp_path = std.fmt.bufPrint(
+            &temp_path_buffer,
+            "{s}.{x:0>16}.tmp",
+            .{ &path, std.crypto.random.int(u64) },
+        ) catch unreachable;
+        self.dir.writeFile(.{ .sub_path = temp_path, .data = block }) catch |err| {
+            self.dir.deleteFile(temp_path) catch {};
+            misc.error_context.new("Failed to write chunk block: {s}", .{temp_path});
+            return err;
+        };
+        self.dir.rename(temp_path, &path) catch |err| {
+            self.dir.deleteFile(temp_path) catch {};
+            misc.error_context.new("Failed to rename chunk block {s} to: {s}", .{ temp_path, &path });
+            return err;
+        };
+    }
+
+    pub fn get(self: *const Self, allocator: std.mem.Allocator, hash: *const ChunkHash) ![]u8 {
+        const path = getBlockPath(hash);
+        return self.dir.readFileAlloc(allocator, &path, max_block_size) catch |err| {
+            misc.error_context.new("Failed to read chunk block: {s}", .{&path});
+            return err;
+        };
+    }
+
+    // Every occurrence of a hash counts as a reference, including repeated occurrences inside the same manifest.
+    pub fn addReferences(self: *const Self, allocator: std.mem.Allocator, hashes: []const ChunkHash) !void {
+        if (hashes.len == 0) {
+            return;
+        }
+        const references_lock = try self.lockReferences();
+        defer references_lock.close();
+        var references = self.loadReferences(allocator) catch |err| {
+            misc.error_context.append("Failed to load chunk references.", .{});
+            return err;
+        };
+        defer references.deinit(allocator);
+        for (hashes) |*hash| {
+            const entry = references.getOrPut(allocator, hash.*) catch |err| {
+                misc.error_context.new("Failed to add chunk reference.", .{});
+                return err;
+            };
+            entry.value_ptr.* = if (entry.found_existing) entry.value_ptr.* +| 1 else 1;
+        }
+        self.saveReferences(&references) catch |err| {
+            misc.error_context.append("Failed to save chunk references.", .{});
+            return err;
+        };
+    }
+
+    // Chunks that end up without references stay inside the store until deleteUnreferenced gets called on them.
+    pub fn releaseReferences(self: *const Self, allocator: std.mem.Allocator, hashes: []const ChunkHash) !void {
+        if (hashes.len == 0) {
+            return;
+        }
+        const references_lock = try self.lockReferences();
+        defer references_lock.close();
+        var references = self.loadReferences(allocator) catch |err| {
+            misc.error_context.append("Failed to load chunk references.", .{});
+            return err;
+        };
+        defer references.deinit(allocator);
+        for (hashes) |*hash| {
+            const count = references.getPtr(hash.*) orelse continue;
+            count.* -|= 1;
+            if (count.* == 0) {
+                _ = references.remove(hash.*);
+            }
+        }
+        self.saveReferences(&references) catch |err| {
+            misc.error_context.append("Failed to save chunk references.", .{});
+            return err;
+        };
+    }
+
+    // Deletes the chunks out of the given ones that have no references. Store has to be locked exclusive.
+    pub fn deleteUnreferenced(self: *const Self, allocator: std.mem.Allocator, hashes: []const ChunkHash) !void {
+        std.debug.assert(self.lock_file != null);
+        if (hashes.len == 0) {
+            return;
+        }
+        const references_lock = try self.lockReferences();
+        defer references_lock.close();
+        var references = self.loadReferences(allocator) catch |err| {
+            misc.error_context.append("Failed to load chunk references.", .{});
+            return err;
+        };
+        defer references.deinit(allocator);
+        for (hashes) |*hash| {
+            if (!references.contains(hash.*)) {
+                self.deleteBlock(hash);
+            }
+        }
+    }
+
+    // Replaces the reference counts with the given references, which should come from every manifest inside the
+    // library, and deletes all the chunks that are not referenced. Fixes up the store after manifests were deleted or
+    // replaced by hand. Returns the number of deleted chunks. Store has to be locked exclusive.
+    pub fn rebuildReferences(self: *const Self, allocator: std.mem.Allocator, hashes: []const ChunkHash) !usize {
+        std.debug.assert(self.lock_file != null);
+        const references_lock = try self.lockReferences();
+        defer references_lock.close();
+        var references: References = .empty;
+        defer references.deinit(allocator);
+        for (hashes) |*hash| {
+            const entry = references.getOrPut(allocator, hash.*) catch |err| {
+                misc.error_context.new("Failed to add chunk reference.", .{});
+                return err;
+            };
+            entry.value_ptr.* = if (entry.found_existing) entry.value_ptr.* +| 1 else 1;
+        }
+
+        var blocks_dir = self.dir.openDir(blocks_dir_name, .{ .iterate = true }) catch |err| {
+            misc.error_context.new("Failed to open chunk blocks directory.", .{});
+            return err;
+        };
+        defer blocks_dir.close();
+        var walker = blocks_dir.walk(allocator) catch |err| {
+            misc.error_context.new("Failed to walk chunk blocks directory.", .{});
+            return err;
+        };
+        defer walker.deinit();
+        var number_of_deleted: usize = 0;
+        while (walker.next() catch |err| {
+            misc.error_context.new("Failed to walk chunk blocks directory.", .{});
+            return err;
+        }) |entry| {
+            if (entry.kind != .file) {
+                continue;
+            }
+            var hash: ChunkHash = undefined;
+            const is_referenced = if (std.fmt.hexToBytes(&hash, entry.basename)) |bytes|
+                bytes.len == hash.len and references.contains(hash)
+            else |_|
+                false;
+            if (is_referenced) {
+                continue;
+            }
+            entry.dir.deleteFile(entry.basename) catch |err| {
+                misc.error_context.new("Failed to delete chunk block: {s}", .{entry.path});
+                return err;
+            };
+            number_of_deleted += 1;
+        }
+
+        self.saveReferences(&references) catch |err| {
+            misc.error_context.append("Failed to save chunk references.", .{});
+            return err;
+        };
+        return number_of_deleted;
+    }
+
+    // Closing the returned file releases the lock.
+    fn lockReferences(self: *const Self) !std.fs.File {
+        return self.dir.createFile(references_lock_file_name, .{ .truncate = false, .lock = .exclusive }) catch |err| {
+            misc.error_context.new("Failed to lock file: {s}", .{references_lock_file_name});
+            return err;
+        };
+    }
+
+    fn deleteBlock(self: *const Self, hash: *const ChunkHash) void {
+        const path = getBlockPath(hash);
+        self.dir.deleteFile(&path) catch |err| {
+            misc.error_context.new("Failed to delete chunk block: {s}", .{&path});
+            misc.error_context.logWarning(err);
+        };
+    }
+
+    fn loadReferences(self: *const Self, allocator: std.mem.Allocator) !References {
+        var references: References = .empty;
+        errdefer references.deinit(allocator);
+        const data = self.dir.readFileAlloc(allocator, references_file_name, max_references_file_size) catch |err| {
+            if (err == error.FileNotFound) {
+                return references;
+            }
+            misc.error_context.new("Failed to read file: {s}", .{references_file_name});
+            return err;
+        };
+        defer allocator.free(data);
+
+        var reader = std.io.Reader.fixed(data);
+        const magic_buffer = reader.take(magic_number.len) catch |err| {
+            misc.error_context.new("Failed to read magic number.", .{});
+            return err;
+        };
+        if (!std.mem.eql(u8, magic_buffer, magic_number)) {
+            misc.error_context.new("Incorrect magic number.", .{});
+            return error.MagicNumber;
+        }
+        const version = reader.takeInt(VersionNumber, endian) catch |err| {
+            misc.error_context.new("Failed to read version number.", .{});
+            return err;
+        };
+        if (version != version_number) {
+            misc.error_context.new("Unsupported references version {}. Expected {}.", .{ version, version_number });
+            return error.UnsupportedVersion;
+        }
+        const number_of_chunks = reader.takeInt(NumberOfChunks, endian) catch |err| {
+            misc.error_context.new("Failed to read number of chunks.", .{});
+            return err;
+        };
+        for (0..number_of_chunks) |index| {
+            const hash = reader.takeArray(@sizeOf(ChunkHash)) catch |err| {
+                misc.error_context.new("Failed to read hash of chunk {}.", .{index});
+                return err;
+            };
+            const count = reader.takeInt(ReferenceCount, endian) catch |err| {
+                misc.error_context.new("Failed to read reference count of chunk {}.", .{index});
+                return err;
+            };
+            references.put(allocator, hash.*, count) catch |err| {
+                misc.error_context.new("Failed to put chunk reference.", .{});
+                return err;
+            };
+        }
+        return references;
+    }
+
+    fn saveReferences(self: *const Self, references: *const References) !void {
+        const temp_path = references_file_name ++ ".tmp";
+        const file = self.dir.createFile(temp_path, .{}) catch |err| {
+            misc.error_context.new("Failed to create file: {s}", .{temp_path});
+            return err;
+        };
+        writeReferences(file, references) catch |err| {
+            file.close();
+            self.dir.deleteFile(temp_path) catch {};
+            misc.error_context.append("Failed to write file: {s}", .{temp_path});
+            return err;
+        };
+        file.close();
+        self.dir.rename(temp_path, references_file_name) catch |err| {
+            self.dir.deleteFile(temp_path) catch {};
+            misc.error_context.new("Failed to rename file {s} to: {s}", .{ temp_path, references_file_name });
+            return err;
+        };
+    }
+};
+
+fn writeReferences(file: std.fs.File, references: *const References) !void {
+    var file_buffer: [buffer_size]u8 = undefined;
+    var file_writer = file.writer(&file_buffer);
+    const writer = &file_writer.interface;
+    writer.writeAll(magic_number) catch |err| {
+        misc.error_context.new("Failed to write magic number.", .{});
+        return err;
+    };
+    writer.writeInt(VersionNumber, version_number, endian) catch |err| {
+        misc.error_context.new("Failed to write version number.", .{});
+        return err;
+    };
+    writer.writeInt(NumberOfChunks, references.count(), endian) catch |err| {
+        misc.error_context.new("Failed to write number of chunks.", .{});
+        return err;
+    };
+    var iterator = references.iterator();
+    while (iterator.next()) |entry| {
+        writer.writeAll(entry.key_ptr) catch |err| {
+            misc.error_context.new("Failed to write chunk hash.", .{});
+            return err;
+        };
+        writer.writeInt(ReferenceCount, entry.value_ptr.*, endian) catch |err| {
+            misc.error_context.new("Failed to write reference count.", .{});
+            return err;
+        };
+    }
+    file_writer.end() catch |err| {
+        misc.error_context.new("Failed to end file writing.", .{});
+        return err;
+    };
+}
+
+fn getBlockPath(hash: *const ChunkHash) [blocks_dir_name.len + 4 + 2 * @sizeOf(ChunkHash)]u8 {
+    const hex = std.fmt.bytesToHex(hash, .lower);
+    return (blocks_dir_name ++ std.fs.path.sep_str).* ++ hex[0..2].* ++ std.fs.path.sep_str.* ++ hex;
+}
+
+const testing = std.testing;
+
+fn createTestStore() !ChunkStore {
+    std.fs.cwd().makePath("./test_assets/library") catch {};
+    try ChunkStore.create("./test_assets/library");
+    return (try ChunkStore.openForRecording("./test_assets/library/recording.irony")).?;
+}
+
+fn deleteTestStore() void {
+    std.fs.cwd().deleteTree("./test_assets/library") catch @panic("Failed to cleanup test directory.");
+}
+
+test "openForRecording should return null when there is no store next to the recording" {
+    try testing.expectEqual(null, try ChunkStore.openForRecording("./test_assets/recording.irony"));
+}
+
+test "ChunkStore should return the block that was put into it" {
+    var store = try createTestStore();
+    defer deleteTestStore();
+    defer store.close();
+
+    const hash = ChunkStore.hashChunk("fields", "encoded chunk");
+    try testing.expect(!store.contains(&hash));
+    try store.put(&hash, "compressed block");
+    try testing.expect(store.contains(&hash));
+    const block = try store.get(testing.allocator, &hash);
+    defer testing.allocator.free(block);
+    try testing.expectEqualStrings("compressed block", block);
+
+    const other_hash = ChunkStore.hashChunk("other fields", "encoded chunk");
+    try testing.expect(!std.mem.eql(u8, &hash, &other_hash));
+}
+
+test "deleteUnreferenced should delete chunks only once they lose the last reference" {
+    var store = try createTestStore();
+    defer deleteTestStore();
+    defer store.close();
+
+    const hash_1 = ChunkStore.hashChunk("fields", "chunk 1");
+    const hash_2 = ChunkStore.hashChunk("fields", "chunk 2");
+    try store.put(&hash_1, "block 1");
+    try store.put(&hash_2, "block 2");
+    try store.addReferences(testing.allocator, &.{ hash_1, hash_2, hash_1 });
+    try store.addReferences(testing.allocator, &.{hash_2});
+
+    try store.lock(.exclusive);
+    try store.releaseReferences(testing.allocator, &.{ hash_1, hash_2 });
+    try store.deleteUnreferenced(testing.allocator, &.{ hash_1, hash_2 });
+    try testing.expect(store.contains(&hash_1));
+    try testing.expect(store.contains(&hash_2));
+    try store.releaseReferences(testing.allocator, &.{hash_1});
+    try testing.expect(store.contains(&hash_1));
+    try store.deleteUnreferenced(testing.allocator, &.{hash_1});
+    try testing.expect(!store.contains(&hash_1));
+    try testing.expect(store.contains(&hash_2));
+}
+
+test "tryLock should fail to lock exclusive while a save holds a shared lock" {
+    var store = try createTestStore();
+    defer deleteTestStore();
+    defer store.close();
+    var other_store = (try ChunkStore.openForRecording("./test_assets/library/other.irony")).?;
+    defer other_store.close();
+
+    try store.lock(.shared);
+    try testing.expect(try other_store.tryLock(.shared));
+    other_store.unlock();
+    try testing.expect(!try other_store.tryLock(.exclusive));
+    store.unlock();
+    try testing.expect(try other_store.tryLock(.exclusive));
+    try testing.expect(!try store.tryLock(.shared));
+}
+
+test "rebuildReferences should delete chunks that are not referenced" {
+    var store = try createTestStore();
+    defer deleteTestStore();
+    defer store.close();
+
+    const hash_1 = ChunkStore.hashChunk("fields", "chunk 1");
+    const hash_2 = ChunkStore.hashChunk("fields", "chunk 2");
+    try store.put(&hash_1, "block 1");
+    try store.put(&hash_2, "block 2");
+    try store.addReferences(testing.allocator, &.{ hash_1, hash_2 });
+
+    try store.lock(.exclusive);
+    try testing.expectEqual(1, try store.rebuildReferences(testing.allocator, &.{hash_2}));
+    try testing.expect(!store.contains(&hash_1));
+    try testing.expect(store.contains(&hash_2));
+    try store.releaseReferences(testing.allocator, &.{hash_2});
+    try store.deleteUnreferenced(testing.allocator, &.{hash_2});
+    try testing.expect(!store.contains(&hash_2));
+}
@@ -0,0 +1,1052 @@
+const std = @import("std");
+const build_info = @import("build_info");
+const misc = @import("../misc/root.zig");
+const io = @import("root.zig");
+const recording = @import("recording.zig");
+
+// Columnar files are an export format for bulk analysis outside of the game. Every leaf of the frame gets a column of
+// it's own that holds the values of all frames one after another, so a tool interested in a handful of fields only
+// touches the bytes of those fields. Columns are derived from the recording's local fields. Atomic fields that are
+// structs, arrays or optionals get split further, so every column holds a single scalar.
+//
+// Every column has one of the following encodings:
+// - plain: the values as little endian integers of a power of two size, one per frame,
+// - dictionary: exhaustive enums, stored as an index into the enum's entries, one byte per frame in most cases,
+// - run-length: integers that change slowly, like animation IDs, stored as a list of values and frames where they end.
+// Columns that don't have a value in every frame, because they are inside a null optional or a different union field,
+// also have a validity bitmap. The frames without a value hold zero.
+//
+// Sections are aligned to 64 bytes and never compressed, so once the file is in memory a plain column can be scanned
+// by reinterpreting it's bytes as an array.
+//
+// File structure:
+// magic number | version | number of frames | number of columns | column descriptors | padding | sections
+// Column descriptor:
+// path | kind | bit size | value size | enum entries | encoding | code size | number of runs | section offsets
+
+const VersionNumber = u16;
+const NumberOfFrames = u64;
+const NumberOfColumns = u32;
+const StringLength = u16;
+const NumberOfEntries = u16;
+const EntryValue = i64;
+const NumberOfRuns = u64;
+const Offset = u64;
+pub const ColumnRunEnd = u32;
+
+const endian = std.builtin.Endian.little;
+const magic_number = @tagName(build_info.name) ++ "-columnar";
+const version_number = 1;
+const section_alignment = 64;
+const buffer_size = 64 * 1024;
+const max_value_bit_size = 64;
+
+pub const ColumnKind = enum(u8) {
+    bool = 0,
+    int = 1,
+    uint = 2,
+    float = 3,
+    @"enum" = 4,
+    // Packed structs and packed unions, stored as their backing integer.
+    bits = 5,
+};
+
+pub const ColumnEncoding = enum(u8) {
+    plain = 0,
+    dictionary = 1,
+    run_length = 2,
+};
+
+pub const ColumnEnumEntry = struct {
+    value: EntryValue,
+    name: []const u8,
+};
+
+pub const ColumnValue = union(ColumnKind) {
+    bool: bool,
+    int: i64,
+    uint: u64,
+    float: f64,
+    @"enum": EntryValue,
+    bits: u64,
+};
+
+// Column of a loaded columnar file. The slices point into the file's bytes.
+pub const Column = struct {
+    path: []const u8,
+    kind: ColumnKind,
+    bit_size: u8,
+    value_size: u8,
+    // Names of the values. Dictionary codes are indices into this list.
+    enum_entries: []const ColumnEnumEntry,
+    encoding: ColumnEncoding,
+    code_size: u8,
+    number_of_frames: usize,
+    // One bit per frame, least significant bit first. Null when every frame has a value.
+    validity: ?[]const u8,
+    // Plain: a value per frame. Dictionary: a code per frame. Run-length: a value per run.
+    values: []const u8,
+    // Run-length: the frame where each run ends, exclusive. Empty for other encodings.
+    run_ends: []const ColumnRunEnd,
+
+    const Self = @This();
+
+    pub fn isPresent(self: *const Self, frame_index: usize) bool {
+        const validity = self.validity orelse return true;
+        return validity[frame_index / 8] & (@as(u8, 1) << @intCast(frame_index % 8)) != 0;
+    }
+
+    // Random access. Run-length columns do a binary search, so sequential scans should use decodeBits instead.
+    pub fn getValue(self: *const Self, frame_index: usize) ?ColumnValue {
+        std.debug.assert(frame_index < self.number_of_frames);
+        if (!self.isPresent(frame_index)) {
+            return null;
+        }
+        const raw = switch (self.encoding) {
+            .plain => readUnsigned(self.values, frame_index, self.value_size),
+            .dictionary => {
+                const code = readUnsigned(self.values, frame_index, self.code_size);
+                return .{ .@"enum" = self.enum_entries[@intCast(code)].value };
+            },
+            .run_length => readUnsigned(self.values, self.findRun(frame_index), self.value_size),
+        };
+        return switch (self.kind) {
+            .bool => .{ .bool = raw != 0 },
+            .int => .{ .int = signExtend(raw, self.value_size) },
+            .uint => .{ .uint = raw },
+            .float => .{ .float = switch (self.value_size) {
+                2 => @as(f16, @bitCast(@as(u16, @intCast(raw)))),
+                4 => @as(f32, @bitCast(@as(u32, @intCast(raw)))),
+                8 => @as(f64, @bitCast(raw)),
+                else => unreachable,
+            } },
+            .@"enum" => unreachable,
+            .bits => .{ .bits = raw },
+        };
+    }
+
+    pub fn getEnumName(self: *const Self, value: EntryValue) ?[]const u8 {
+        for (self.enum_entries) |*entry| {
+            if (entry.value == value) {
+                return entry.name;
+            }
+        }
+        return null;
+    }
+
+    // Writes the raw value of every frame into the output, zero extended. Dictionary columns output the enum values.
+    pub fn decodeBits(self: *const Self, output: []u64) void {
+        std.debug.assert(output.len == self.number_of_frames);
+        switch (self.encoding) {
+            .plain => for (output, 0..) |*value, index| {
+                value.* = readUnsigned(self.values, index, self.value_size);
+            },
+            .dictionary => for (output, 0..) |*value, index| {
+                const code = readUnsigned(self.values, index, self.code_size);
+                value.* = @bitCast(self.enum_entries[@intCast(code)].value);
+            },
+            .run_length => {
+                var start: usize = 0;
+                for (self.run_ends, 0..) |end, run_index| {
+                    @memset(output[start..end], readUnsigned(self.values, run_index, self.value_size));
+                    start = end;
+                }
+            },
+        }
+    }
+
+    fn findRun(self: *const Self, frame_index: usize) usize {
+        var low: usize = 0;
+        var high: usize = self.run_ends.len;
+        while (low < high) {
+            const middle = low + (high - low) / 2;
+            if (self.run_ends[middle] <= frame_index) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+};
+
+// Whole columnar file loaded into memory.
+pub const ColumnarFile = struct {
+    allocator: std.mem.Allocator,
+    arena: std.heap.ArenaAllocator,
+    bytes: []align(section_alignment) const u8,
+    number_of_frames: usize,
+    columns: []const Column,
+
+    const Self = @This();
+
+    pub fn load(allocator: std.mem.Allocator, file_path: []const u8) !Self {
+        const bytes = readFile(allocator, file_path) catch |err| {
+            misc.error_context.append("Failed to read file: {s}", .{file_path});
+            return err;
+        };
+        errdefer allocator.free(bytes);
+        var arena = std.heap.ArenaAllocator.init(allocator);
+        errdefer arena.deinit();
+        var number_of_frames: usize = undefined;
+        const columns = readColumns(arena.allocator(), bytes, &number_of_frames) catch |err| {
+            misc.error_context.append("Failed to read columnar file: {s}", .{file_path});
+            return err;
+        };
+        return .{
+            .allocator = allocator,
+            .arena = arena,
+            .bytes = bytes,
+            .number_of_frames = number_of_frames,
+            .columns = columns,
+        };
+    }
+
+    pub fn deinit(self: *Self) void {
+        self.arena.deinit();
+        self.allocator.free(self.bytes);
+        self.* = undefined;
+    }
+
+    pub fn getColumn(self: *const Self, path: []const u8) ?*const Column {
+        for (self.columns) |*column| {
+            if (std.mem.eql(u8, column.path, path)) {
+                return column;
+            }
+        }
+        return null;
+    }
+};
+
+pub fn saveColumnar(
+    comptime Frame: type,
+    frames: []const Frame,
+    file_path: []const u8,
+    comptime config: *const io.RecordingConfig,
+) !void {
+    const file = std.fs.cwd().createFile(file_path, .{}) catch |err| {
+        misc.error_context.new("Failed to create or open file: {s}", .{file_path});
+        return err;
+    };
+    writeColumnar(Frame, frames, file, config) catch |err| {
+        file.close();
+        std.fs.cwd().deleteFile(file_path) catch {};
+        misc.error_context.append("Failed to write columnar file: {s}", .{file_path});
+        return err;
+    };
+    file.close();
+}
+
+pub fn convertRecordingToColumnar(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    source_path: []const u8,
+    file_path: []const u8,
+    comptime config: *const io.RecordingConfig,
+) !void {
+    const frames = io.loadRecording(Frame, allocator, source_path, config) catch |err| {
+        misc.error_context.append("Failed to load recording: {s}", .{source_path});
+        return err;
+    };
+    defer allocator.free(frames);
+    saveColumnar(Frame, frames, file_path, config) catch |err| {
+        misc.error_context.append("Failed to save columnar file: {s}", .{file_path});
+        return err;
+    };
+}
+
+// Scalar at the end of an access path. Tag columns hold the active tag of the tagged union at the end of the path.
+const ColumnField = struct {
+    path: []const u8,
+    access: []const recording.AccessElement,
+    Type: type,
+    is_tag: bool,
+};
+
+// Decided while analyzing the frames, before anything gets written.
+const ColumnLayout = struct {
+    encoding: ColumnEncoding,
+    number_of_runs: NumberOfRuns,
+    validity_offset: Offset,
+    values_offset: Offset,
+    run_ends_offset: Offset,
+};
+
+inline fn getColumnFields(comptime Frame: type, comptime config: *const io.RecordingConfig) []const ColumnField {
+    comptime {
+        @setEvalBranchQuota(1000000);
+        var fields: []const ColumnField = &.{};
+        for (recording.getLocalFields(Frame, config)) |*local_field| {
+            if (!local_field.has_children) {
+                fields = fields ++ getColumnFieldsRecursive(local_field.path, local_field.access, local_field.Type);
+            } else if (@typeInfo(local_field.Type) == .@"union") {
+                fields = fields ++ &[1]ColumnField{.{
+                    .path = local_field.path,
+                    .access = local_field.access,
+                    .Type = local_field.Type,
+                    .is_tag = true,
+                }};
+            }
+        }
+        const result = fields[0..fields.len].*;
+        return &result;
+    }
+}
+
+fn getColumnFieldsRecursive(
+    comptime path: []const u8,
+    comptime access: []const recording.AccessElement,
+    comptime Type: type,
+) []const ColumnField {
+    const field = ColumnField{ .path = path, .access = access, .Type = Type, .is_tag = false };
+    switch (@typeInfo(Type)) {
+        .void => return &.{},
+        .bool, .int, .float, .@"enum" => return &.{field},
+        .@"struct" => |*info| {
+            if (info.layout == .@"packed") {
+                return &.{field};
+            }
+            var fields: []const ColumnField = &.{};
+            for (info.fields) |*struct_field| {
+                fields = fields ++ getColumnFieldsRecursive(
+                    joinPath(path, struct_field.name),
+                    access ++ &[1]recording.AccessElement{.{ .struct_field = struct_field.name }},
+                    struct_field.type,
+                );
+            }
+            return fields;
+        },
+        .array => |*info| {
+            var fields: []const ColumnField = &.{};
+            for (0..info.len) |index| {
+                fields = fields ++ getColumnFieldsRecursive(
+                    joinPath(path, std.fmt.comptimePrint("{}", .{index})),
+                    access ++ &[1]recording.AccessElement{.{ .array_index = index }},
+                    info.child,
+                );
+            }
+            return fields;
+        },
+        .optional => |*info| return getColumnFieldsRecursive(
+            joinPath(path, recording.optional_payload_path_component),
+            access ++ &[1]recording.AccessElement{.optional_payload},
+            info.child,
+        ),
+        .@"union" => |*info| {
+            if (info.layout == .@"packed") {
+                return &.{field};
+            }
+            var fields: []const ColumnField = &.{.{ .path = path, .access = access, .Type = Type, .is_tag = true }};
+            for (info.fields) |*union_field| {
+                fields = fields ++ getColumnFieldsRecursive(
+                    joinPath(path, union_field.name),
+                    access ++ &[1]recording.AccessElement{.{ .union_field = union_field.name }},
+                    union_field.type,
+                );
+            }
+            return fields;
+        },
+        else => @compileError("Unsupported type: " ++ @typeName(Type)),
+    }
+}
+
+fn joinPath(comptime path: []const u8, comptime component: []const u8) []const u8 {
+    return if (path.len == 0) component else path ++ recording.path_separator_str ++ component;
+}
+
+fn ColumnValueType(comptime field: *const ColumnField) type {
+    return if (field.is_tag) std.meta.Tag(field.Type) else field.Type;
+}
+
+fn getKind(comptime Value: type) ColumnKind {
+    return switch (@typeInfo(Value)) {
+        .bool => .bool,
+        .int => |*info| if (info.signedness == .signed) .int else .uint,
+        .float => .float,
+        .@"enum" => |*info| if (info.is_exhaustive) .@"enum" else getKind(info.tag_type),
+        .@"struct", .@"union" => .bits,
+        else => @compileError("Unsupported column type: " ++ @typeName(Value)),
+    };
+}
+
+fn getBitSize(comptime Value: type) usize {
+    const bit_size = @bitSizeOf(Value);
+    if (bit_size > max_value_bit_size) {
+        @compileError("Column type " ++ @typeName(Value) ++ " is larger then 64 bits.");
+    }
+    return bit_size;
+}
+
+fn getValueSize(comptime Value: type) usize {
+    const bit_size = getBitSize(Value);
+    return if (bit_size <= 8) 1 else if (bit_size <= 16) 2 else if (bit_size <= 32) 4 else 8;
+}
+
+fn getEnumEntries(comptime Value: type) []const std.builtin.Type.EnumField {
+    return switch (@typeInfo(Value)) {
+        .@"enum" => |*info| info.fields,
+        else => &.{},
+    };
+}
+
+fn getCodeSize(comptime Value: type) usize {
+    if (getKind(Value) != .@"enum") {
+        return 0;
+    }
+    const number_of_entries = getEnumEntries(Value).len;
+    if (number_of_entries > std.math.maxInt(u16)) {
+        @compileError("Enum " ++ @typeName(Value) ++ " has too many fields to be dictionary encoded.");
+    }
+    return if (number_of_entries <= std.math.maxInt(u8) + 1) 1 else 2;
+}
+
+fn toBits(comptime Value: type, value: Value) u64 {
+    return switch (@typeInfo(Value)) {
+        .bool => @intFromBool(value),
+        .int => |*info| if (info.signedness == .signed) @bitCast(@as(i64, value)) else value,
+        .@"enum" => |*info| toBits(info.tag_type, @intFromEnum(value)),
+        else => @as(std.meta.Int(.unsigned, @bitSizeOf(Value)), @bitCast(value)),
+    };
+}
+
+fn getDictionaryCode(comptime Value: type, value: Value) u64 {
+    inline for (getEnumEntries(Value), 0..) |*entry, index| {
+        if (value == @field(Value, entry.name)) {
+            return index;
+        }
+    }
+    unreachable;
+}
+
+fn AccessedType(comptime Type: type, comptime access: []const recording.AccessElement) type {
+    if (access.len == 0) {
+        return Type;
+    }
+    return switch (access[0]) {
+        .struct_field, .union_field => |name| AccessedType(@FieldType(Type, name), access[1..]),
+        .array_index => AccessedType(@typeInfo(Type).array.child, access[1..]),
+        .optional_payload => AccessedType(@typeInfo(Type).optional.child, access[1..]),
+    };
+}
+
+// Returns null when a optional on the path is null or a tagged union on the path has a different active field.
+fn accessField(
+    comptime access: []const recording.AccessElement,
+    pointer: anytype,
+) ?*const AccessedType(@typeInfo(@TypeOf(pointer)).pointer.child, access) {
+    if (access.len == 0) {
+        return pointer;
+    }
+    const next_pointer = switch (access[0]) {
+        .struct_field => |name| &@field(pointer, name),
+        .array_index => |index| &pointer[index],
+        .optional_payload => if (pointer.*) |*payload| payload else return null,
+        .union_field => |name| block: {
+            const expected_tag = @field(std.meta.Tag(@TypeOf(pointer.*)), name);
+            if (std.meta.activeTag(pointer.*) != expected_tag) {
+                return null;
+            }
+            break :block &@field(pointer, name);
+        },
+    };
+    return accessField(access[1..], next_pointer);
+}
+
+fn getColumnValue(comptime field: *const ColumnField, frame: anytype) ?ColumnValueType(field) {
+    const pointer = accessField(field.access, frame) orelse return null;
+    return if (field.is_tag) std.meta.activeTag(pointer.*) else pointer.*;
+}
+
+fn getHeaderSize(comptime fields: []const ColumnField) usize {
+    @setEvalBranchQuota(1000000);
+    var size: usize = magic_number.len + @sizeOf(VersionNumber) + @sizeOf(NumberOfFrames) + @sizeOf(NumberOfColumns);
+    for (fields) |*field| {
+        size += @sizeOf(StringLength) + field.path.len + 3 + @sizeOf(NumberOfEntries);
+        for (getEnumEntries(ColumnValueType(field))) |*entry| {
+            size += @sizeOf(EntryValue) + @sizeOf(StringLength) + entry.name.len;
+        }
+        size += 2 + @sizeOf(NumberOfRuns) + 3 * @sizeOf(Offset);
+    }
+    return size;
+}
+
+fn writeColumnar(
+    comptime Frame: type,
+    frames: []const Frame,
+    file: std.fs.File,
+    comptime config: *const io.RecordingConfig,
+) !void {
+    if (frames.len > std.math.maxInt(ColumnRunEnd)) {
+        misc.error_context.new(
+            "Recording has {} frames while columnar files hold at most {} frames.",
+            .{ frames.len, std.math.maxInt(ColumnRunEnd) },
+        );
+        return error.TooManyFrames;
+    }
+    const fields = comptime getColumnFields(Frame, config);
+    const header_size = comptime getHeaderSize(fields);
+    var layouts: [fields.len]ColumnLayout = undefined;
+    var end: Offset = header_size;
+    inline for (fields, 0..) |*field, index| {
+        layouts[index] = analyzeColumn(field, frames, &end);
+    }
+
+    var file_buffer: [buffer_size]u8 = undefined;
+    var file_writer = file.writer(&file_buffer);
+    const writer = &file_writer.interface;
+    writeHeader(fields, writer, frames.len, &layouts) catch |err| {
+        misc.error_context.append("Failed to write columnar header.", .{});
+        return err;
+    };
+    var position: Offset = header_size;
+    inline for (fields, 0..) |*field, index| {
+        writeColumn(field, writer, frames, &layouts[index], &position) catch |err| {
+            misc.error_context.new("Failed to write column: {s}", .{field.path});
+            return err;
+        };
+    }
+    file_writer.end() catch |err| {
+        misc.error_context.new("Failed to end file writing.", .{});
+        return err;
+    };
+}
+
+// Picks the encoding and places the column's sections after the end of the previous column.
+fn analyzeColumn(comptime field: *const ColumnField, frames: anytype, end: *Offset) ColumnLayout {
+    const Value = ColumnValueType(field);
+    const value_size = comptime getValueSize(Value);
+    var has_nulls = false;
+    var number_of_runs: NumberOfRuns = 0;
+    var previous_bits: ?u64 = null;
+    for (frames) |*frame| {
+        const bits = if (getColumnValue(field, frame)) |value| toBits(Value, value) else block: {
+            has_nulls = true;
+            break :block 0;
+        };
+        if (previous_bits == null or previous_bits.? != bits) {
+            number_of_runs += 1;
+        }
+        previous_bits = bits;
+    }
+
+    const number_of_frames: u64 = frames.len;
+    const encoding: ColumnEncoding = switch (comptime getKind(Value)) {
+        .@"enum" => .dictionary,
+        .float => .plain,
+        .bool, .int, .uint, .bits => if (number_of_runs * (value_size + @sizeOf(ColumnRunEnd)) <
+            number_of_frames * value_size) .run_length else .plain,
+    };
+    var layout = ColumnLayout{
+        .encoding = encoding,
+        .number_of_runs = if (encoding == .run_length) number_of_runs else 0,
+        .validity_offset = 0,
+        .values_offset = 0,
+        .run_ends_offset = 0,
+    };
+    if (has_nulls) {
+        layout.validity_offset = std.mem.alignForward(Offset, end.*, section_alignment);
+        end.* = layout.validity_offset + getValiditySize(number_of_frames);
+    }
+    layout.values_offset = std.mem.alignForward(Offset, end.*, section_alignment);
+    end.* = layout.values_offset + switch (encoding) {
+        .plain => number_of_frames * value_size,
+        .dictionary => number_of_frames * getCodeSize(Value),
+        .run_length => number_of_runs * value_size,
+    };
+    if (encoding == .run_length) {
+        layout.run_ends_offset = std.mem.alignForward(Offset, end.*, section_alignment);
+        end.* = layout.run_ends_offset + number_of_runs * @sizeOf(ColumnRunEnd);
+    }
+    return layout;
+}
+
+fn getValiditySize(number_of_frames: u64) u64 {
+    return std.math.divCeil(u64, number_of_frames, 8) catch unreachable;
+}
+
+fn writeHeader(
+    comptime fields: []const ColumnField,
+    writer: *std.io.Writer,
+    number_of_frames: usize,
+    layouts: []const ColumnLayout,
+) !void {
+    writer.writeAll(magic_number) catch |err| {
+        misc.error_context.new("Failed to write magic number.", .{});
+        return err;
+    };
+    writer.writeInt(VersionNumber, version_number, endian) catch |err| {
+        misc.error_context.new("Failed to write version number.", .{});
+        return err;
+    };
+    writer.writeInt(NumberOfFrames, number_of_frames, endian) catch |err| {
+        misc.error_context.new("Failed to write number of frames.", .{});
+        return err;
+    };
+    writer.writeInt(NumberOfColumns, fields.len, endian) catch |err| {
+        misc.error_context.new("Failed to write number of columns.", .{});
+        return err;
+    };
+    inline for (fields, 0..) |*field, index| {
+        writeDescriptor(field, writer, &layouts[index]) catch |err| {
+            misc.error_context.new("Failed to write descriptor of column: {s}", .{field.path});
+            return err;
+        };
+    }
+}
+
+fn writeDescriptor(comptime field: *const ColumnField, writer: *std.io.Writer, layout: *const ColumnLayout) !void {
+    const Value = ColumnValueType(field);
+    const entries = comptime getEnumEntries(Value);
+    try writer.writeInt(StringLength, field.path.len, endian);
+    try writer.writeAll(field.path);
+    try writer.writeByte(@intFromEnum(comptime getKind(Value)));
+    try writer.writeByte(comptime getBitSize(Value));
+    try writer.writeByte(comptime getValueSize(Value));
+    try writer.writeInt(NumberOfEntries, entries.len, endian);
+    inline for (entries) |*entry| {
+        try writer.writeInt(EntryValue, @intCast(entry.value), endian);
+        try writer.writeInt(StringLength, entry.name.len, endian);
+        try writer.writeAll(entry.name);
+    }
+    try writer.writeByte(@intFromEnum(layout.encoding));
+    try writer.writeByte(if (layout.encoding == .dictionary) @intCast(getCodeSize(Value)) else 0);
+    try writer.writeInt(NumberOfRuns, layout.number_of_runs, endian);
+    try writer.writeInt(Offset, layout.validity_offset, endian);
+    try writer.writeInt(Offset, layout.values_offset, endian);
+    try writer.writeInt(Offset, layout.run_ends_offset, endian);
+}
+
+fn writeColumn(
+    comptime field: *const ColumnField,
+    writer: *std.io.Writer,
+    frames: anytype,
+    layout: *const ColumnLayout,
+    position: *Offset,
+) !void {
+    const Value = ColumnValueType(field);
+    const Stored = std.meta.Int(.unsigned, 8 * getValueSize(Value));
+    if (layout.validity_offset != 0) {
+        try padTo(writer, position, layout.validity_offset);
+        var byte: u8 = 0;
+        for (frames, 0..) |*frame, index| {
+            if (getColumnValue(field, frame) != null) {
+                byte |= @as(u8, 1) << @intCast(index % 8);
+            }
+            if (index % 8 == 7) {
+                try writer.writeByte(byte);
+                byte = 0;
+            }
+        }
+        if (frames.len % 8 != 0) {
+            try writer.writeByte(byte);
+        }
+        position.* += getValiditySize(frames.len);
+    }
+    try padTo(writer, position, layout.values_offset);
+    switch (layout.encoding) {
+        .plain => {
+            for (frames) |*frame| {
+                const bits = if (getColumnValue(field, frame)) |value| toBits(Value, value) else 0;
+                try writer.writeInt(Stored, @truncate(bits), endian);
+            }
+            position.* += frames.len * @sizeOf(Stored);
+        },
+        .dictionary => if (comptime getKind(Value) != .@"enum") unreachable else {
+            const Code = std.meta.Int(.unsigned, 8 * getCodeSize(Value));
+            for (frames) |*frame| {
+                const code = if (getColumnValue(field, frame)) |value| getDictionaryCode(Value, value) else 0;
+                try writer.writeInt(Code, @intCast(code), endian);
+            }
+            position.* += frames.len * @sizeOf(Code);
+        },
+        .run_length => {
+            var previous_bits: ?u64 = null;
+            for (frames) |*frame| {
+                const bits = if (getColumnValue(field, frame)) |value| toBits(Value, value) else 0;
+                if (previous_bits == null or previous_bits.? != bits) {
+                    try writer.writeInt(Stored, @truncate(bits), endian);
+                }
+                previous_bits = bits;
+            }
+            position.* += layout.number_of_runs * @sizeOf(Stored);
+            try padTo(writer, position, layout.run_ends_offset);
+            previous_bits = null;
+            for (frames, 0..) |*frame, index| {
+                const bits = if (getColumnValue(field, frame)) |value| toBits(Value, value) else 0;
+                if (previous_bits != null and previous_bits.? != bits) {
+                    try writer.writeInt(ColumnRunEnd, @intCast(index), endian);
+                }
+                previous_bits = bits;
+            }
+            if (frames.len != 0) {
+                try writer.writeInt(ColumnRunEnd, @intCast(frames.len), endian);
+            }
+            position.* += layout.number_of_runs * @sizeOf(ColumnRunEnd);
+        },
+    }
+}
+
+fn padTo(writer: *std.io.Writer, position: *Offset, offset: Offset) !void {
+    std.debug.assert(offset >= position.*);
+    try writer.splatByteAll(0, @intCast(offset - position.*));
+    position.* = offset;
+}
+
+fn readFile(allocator: std.mem.Allocator, file_path: []const u8) ![]align(section_alignment) u8 {
+    const file = std.fs.cwd().openFile(file_path, .{}) catch |err| {
+        misc.error_context.new("Failed to open file: {s}", .{file_path});
+        return err;
+    };
+    defer file.close();
+    const size = file.getEndPos() catch |err| {
+        misc.error_context.new("Failed to get file size.", .{});
+        return err;
+    };
+    const bytes = allocator.alignedAlloc(
+        u8,
+        std.mem.Alignment.fromByteUnits(section_alignment),
+        @intCast(size),
+    ) catch |err| {
+        misc.error_context.new("Failed to allocate {} bytes.", .{size});
+        return err;
+    };
+    errdefer allocator.free(bytes);
+    const read_size = file.readAll(bytes) catch |err| {
+        misc.error_context.new("Failed to read {} bytes.", .{size});
+        return err;
+    };
+    if (read_size != bytes.len) {
+        misc.error_context.new("Expected to read {} bytes but got {} bytes.", .{ bytes.len, read_size });
+        return error.EndOfStream;
+    }
+    return bytes;
+}
+
+fn readColumns(
+    allocator: std.mem.Allocator,
+    bytes: []align(section_alignment) const u8,
+    number_of_frames: *usize,
+) ![]const Column {
+    var reader = std.io.Reader.fixed(bytes);
+    const magic_buffer = reader.take(magic_number.len) catch |err| {
+        misc.error_context.new("Failed to read magic number.", .{});
+        return err;
+    };
+    if (!std.mem.eql(u8, magic_buffer, magic_number)) {
+        misc.error_context.new("Incorrect magic number.", .{});
+        return error.MagicNumber;
+    }
+    const version = reader.takeInt(VersionNumber, endian) catch |err| {
+        misc.error_context.new("Failed to read version number.", .{});
+        return err;
+    };
+    if (version != version_number) {
+        misc.error_context.new("Unsupported columnar version {}. Expected version {}.", .{ version, version_number });
+        return error.UnsupportedVersion;
+    }
+    const frames = reader.takeInt(NumberOfFrames, endian) catch |err| {
+        misc.error_context.new("Failed to read number of frames.", .{});
+        return err;
+    };
+    if (frames > std.math.maxInt(ColumnRunEnd)) {
+        misc.error_context.new("Number of frames {} is too large.", .{frames});
+        return error.TooManyFrames;
+    }
+    const number_of_columns = reader.takeInt(NumberOfColumns, endian) catch |err| {
+        misc.error_context.new("Failed to read number of columns.", .{});
+        return err;
+    };
+    var columns: std.ArrayList(Column) = .empty;
+    for (0..number_of_columns) |column_index| {
+        const column = readColumn(allocator, &reader, bytes, frames) catch |err| {
+            misc.error_context.append("Failed to read column {}.", .{column_index});
+            return err;
+        };
+        columns.append(allocator, column) catch |err| {
+            misc.error_context.new("Failed to append column.", .{});
+            return err;
+        };
+    }
+    number_of_frames.* = @intCast(frames);
+    return columns.items;
+}
+
+fn readColumn(
+    allocator: std.mem.Allocator,
+    reader: *std.io.Reader,
+    bytes: []align(section_alignment) const u8,
+    number_of_frames: u64,
+) !Column {
+    const path = try readString(reader, "column path");
+    const kind = try readEnum(ColumnKind, reader, "column kind");
+    const bit_size = try readInt(u8, reader, "bit size");
+    const value_size = try readInt(u8, reader, "value size");
+    if (bit_size > max_value_bit_size or !isValidSize(value_size) or @as(u16, bit_size) > 8 * value_size) {
+        misc.error_context.new("Invalid bit size {} or value size {} of column: {s}", .{ bit_size, value_size, path });
+        return error.InvalidColumn;
+    }
+    const number_of_entries = try readInt(NumberOfEntries, reader, "number of enum entries");
+    const entries = allocator.alloc(ColumnEnumEntry, number_of_entries) catch |err| {
+        misc.error_context.new("Failed to allocate {} enum entries.", .{number_of_entries});
+        return err;
+    };
+    for (entries) |*entry| {
+        entry.value = try readInt(EntryValue, reader, "enum entry value");
+        entry.name = try readString(reader, "enum entry name");
+    }
+    const encoding = try readEnum(ColumnEncoding, reader, "column encoding");
+    const code_size = try readInt(u8, reader, "code size");
+    const number_of_runs = try readInt(NumberOfRuns, reader, "number of runs");
+    const validity_offset = try readInt(Offset, reader, "validity offset");
+    const values_offset = try readInt(Offset, reader, "values offset");
+    const run_ends_offset = try readInt(Offset, reader, "run ends offset");
+    const is_consistent = switch (encoding) {
+        .plain => kind != .@"enum" and number_of_runs == 0,
+        .dictionary => kind == .@"enum" and (code_size == 1 or code_size == 2) and entries.len != 0,
+        .run_length => kind != .@"enum" and kind != .float and number_of_runs <= number_of_frames and
+            (number_of_runs != 0 or number_of_frames == 0),
+    };
+    if (!is_consistent) {
+        misc.error_context.new("Column {s} has a invalid {s} encoding.", .{ path, @tagName(encoding) });
+        return error.InvalidColumn;
+    }
+
+    var column = Column{
+        .path = path,
+        .kind = kind,
+        .bit_size = bit_size,
+        .value_size = value_size,
+        .enum_entries = entries,
+        .encoding = encoding,
+        .code_size = code_size,
+        .number_of_frames = @intCast(number_of_frames),
+        .validity = null,
+        .values = undefined,
+        .run_ends = &.{},
+    };
+    if (validity_offset != 0) {
+        column.validity = try getSection(bytes, validity_offset, getValiditySize(number_of_frames), path);
+    }
+    column.values = try getSection(bytes, values_offset, switch (encoding) {
+        .plain => number_of_frames * value_size,
+        .dictionary => number_of_frames * code_size,
+        .run_length => number_of_runs * value_size,
+    }, path);
+    switch (encoding) {
+        .plain => {},
+        .dictionary => for (0..column.number_of_frames) |index| {
+            const code = readUnsigned(column.values, index, code_size);
+            if (code >= entries.len) {
+                misc.error_context.new("Column {s} contains code {} at frame {}.", .{ path, code, index });
+                return error.InvalidColumn;
+            }
+        },
+        .run_length => {
+            const run_ends_bytes = try getSection(bytes, run_ends_offset, number_of_runs * @sizeOf(ColumnRunEnd), path);
+            const run_ends = std.mem.bytesAsSlice(ColumnRunEnd, run_ends_bytes);
+            var previous_end: ColumnRunEnd = 0;
+            for (run_ends) |run_end| {
+                if (run_end <= previous_end) {
+                    misc.error_context.new("Runs of column {s} are out of order.", .{path});
+                    return error.InvalidColumn;
+                }
+                previous_end = run_end;
+            }
+            if (previous_end != number_of_frames) {
+                misc.error_context.new(
+                    "Runs of column {s} end at frame {} instead of {}.",
+                    .{ path, previous_end, number_of_frames },
+                );
+                return error.InvalidColumn;
+            }
+            column.run_ends = run_ends;
+        },
+    }
+    return column;
+}
+
+fn getSection(
+    bytes: []align(section_alignment) const u8,
+    offset: Offset,
+    size: u64,
+    path: []const u8,
+) ![]align(section_alignment) const u8 {
+    if (offset % section_alignment != 0 or offset > bytes.len or size > bytes.len - offset) {
+        misc.error_context.new(
+            "Section of column {s} at offset {} with size {} is outside of the file of size {}.",
+            .{ path, offset, size, bytes.len },
+        );
+        return error.InvalidColumn;
+    }
+    return @alignCast(bytes[@intCast(offset)..][0..@intCast(size)]);
+}
+
+fn readInt(comptime Int: type, reader: *std.io.Reader, comptime name: []const u8) !Int {
+    return reader.takeInt(Int, endian) catch |err| {
+        misc.error_context.new("Failed to read " ++ name ++ ".", .{});
+        return err;
+    };
+}
+
+fn readString(reader: *std.io.Reader, comptime name: []const u8) ![]const u8 {
+    const length = try readInt(StringLength, reader, name ++ " length");
+    return reader.take(length) catch |err| {
+        misc.error_context.new("Failed to read " ++ name ++ ".", .{});
+        return err;
+    };
+}
+
+fn readEnum(comptime Enum: type, reader: *std.io.Reader, comptime name: []const u8) !Enum {
+    const int = try readInt(u8, reader, name);
+    return std.meta.intToEnum(Enum, int) catch {
+        misc.error_context.new("Invalid " ++ name ++ ": {}", .{int});
+        return error.InvalidColumn;
+    };
+}
+
+fn isValidSize(size: u8) bool {
+    return size == 1 or size == 2 or size == 4 or size == 8;
+}
+
+fn readUnsigned(bytes: []const u8, index: usize, size: u8) u64 {
+    const start = index * size;
+    return switch (size) {
+        1 => bytes[start],
+        2 => std.mem.readInt(u16, bytes[start..][0..2], endian),
+        4 => std.mem.readInt(u32, bytes[start..][0..4], endian),
+        8 => std.mem.readInt(u64, bytes[start..][0..8], endian),
+        else => unreachable,
+    };
+}
+
+fn signExtend(raw: u64, size: u8) i64 {
+    const shift: u6 = @intCast(64 - @as(u32, size) * 8);
+    return @as(i64, @bitCast(raw << shift)) >> shift;
+}
+
+const testing = std.testing;
+
+const TestPhase = enum(u8) { neutral = 3, active = 7, recovery = 11 };
+const TestFlags = packed struct { a: bool = false, b: bool = false, c: u6 = 0 };
+const TestFrame = struct {
+    animation_id: u32 = 0,
+    health: ?i16 = null,
+    phase: TestPhase = .neutral,
+    position: [2]f32 = .{ 0, 0 },
+    flags: TestFlags = .{},
+    heat: union(enum) { available: void, activated: struct { gauge: f32 } } = .available,
+};
+
+fn getTestFrames() [100]TestFrame {
+    var frames: [100]TestFrame = undefined;
+    for (&frames, 0..) |*frame, index| {
+        frame.* = .{
+            .animation_id = @intCast(1000 + index / 25),
+            .health = if (index % 4 == 0) null else -@as(i16, @intCast(index)),
+            .phase = switch (index % 3) {
+                0 => .neutral,
+                1 => .active,
+                else => .recovery,
+            },
+            .position = .{ @floatFromInt(index), -@as(f32, @floatFromInt(index)) },
+            .flags = .{ .a = index % 2 == 0, .c = @intCast(index % 64) },
+            .heat = if (index < 50) .available else .{ .activated = .{ .gauge = @floatFromInt(index) } },
+        };
+    }
+    return frames;
+}
+
+test "ColumnarFile should load the same values that saveColumnar saved" {
+    const frames = getTestFrames();
+    try saveColumnar(TestFrame, &frames, "./test_assets/recording.columnar", &.{});
+    defer std.fs.cwd().deleteFile("./test_assets/recording.columnar") catch @panic("Failed to cleanup test file.");
+
+    var file = try ColumnarFile.load(testing.allocator, "./test_assets/recording.columnar");
+    defer file.deinit();
+    try testing.expectEqual(frames.len, file.number_of_frames);
+    try testing.expectEqual(8, file.columns.len);
+
+    const animation_id = file.getColumn("animation_id").?;
+    const health = file.getColumn("health.payload").?;
+    const phase = file.getColumn("phase").?;
+    const position = file.getColumn("position.1").?;
+    const flags = file.getColumn("flags").?;
+    const heat = file.getColumn("heat").?;
+    const gauge = file.getColumn("heat.activated.gauge").?;
+    try testing.expectEqual(.run_length, animation_id.encoding);
+    try testing.expectEqual(4, animation_id.run_ends.len);
+    try testing.expectEqual(.dictionary, phase.encoding);
+    try testing.expectEqual(.plain, position.encoding);
+    try testing.expectEqual(.bits, flags.kind);
+    try testing.expectEqual(null, animation_id.validity);
+    try testing.expect(health.validity != null);
+    try testing.expectEqualStrings("recovery", phase.getEnumName(11).?);
+    try testing.expectEqualStrings("activated", heat.getEnumName(heat.getValue(99).?.@"enum").?);
+
+    for (&frames, 0..) |*frame, index| {
+        try testing.expectEqual(ColumnValue{ .uint = frame.animation_id }, animation_id.getValue(index));
+        if (frame.health) |value| {
+            try testing.expectEqual(ColumnValue{ .int = value }, health.getValue(index));
+        } else {
+            try testing.expectEqual(null, health.getValue(index));
+        }
+        try testing.expectEqual(ColumnValue{ .@"enum" = @intFromEnum(frame.phase) }, phase.getValue(index));
+        try testing.expectEqual(ColumnValue{ .float = frame.position[1] }, position.getValue(index));
+        try testing.expectEqual(ColumnValue{ .bits = @as(u8, @bitCast(frame.flags)) }, flags.getValue(index));
+        switch (frame.heat) {
+            .available => try testing.expectEqual(null, gauge.getValue(index)),
+            .activated => |*activated| {
+                try testing.expectEqual(ColumnValue{ .float = activated.gauge }, gauge.getValue(index));
+            },
+        }
+    }
+
+    var decoded: [frames.len]u64 = undefined;
+    animation_id.decodeBits(&decoded);
+    for (&frames, decoded) |*frame, value| {
+        try testing.expectEqual(frame.animation_id, value);
+    }
+}
+
+test "convertRecordingToColumnar should export every frame of the recording" {
+    const frames = getTestFrames();
+    const config = io.RecordingConfig{ .frames_per_chunk = 30 };
+    try io.saveRecording(TestFrame, testing.allocator, &frames, "./test_assets/recording.irony", &config);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+
+    try convertRecordingToColumnar(
+        TestFrame,
+        testing.allocator,
+        "./test_assets/recording.irony",
+        "./test_assets/recording.columnar",
+        &config,
+    );
+    defer std.fs.cwd().deleteFile("./test_assets/recording.columnar") catch @panic("Failed to cleanup test file.");
+    var file = try ColumnarFile.load(testing.allocator, "./test_assets/recording.columnar");
+    defer file.deinit();
+    const position = file.getColumn("position.0").?;
+    for (&frames, 0..) |*frame, index| {
+        try testing.expectEqual(ColumnValue{ .float = frame.position[0] }, position.getValue(index));
+    }
+}
+
+test "ColumnarFile should fail to load a file that is not a columnar file or is cut short" {
+    const frames = getTestFrames();
+    try saveColumnar(TestFrame, &frames, "./test_assets/recording.columnar", &.{});
+    defer std.fs.cwd().deleteFile("./test_assets/recording.columnar") catch @panic("Failed to cleanup test file.");
+
+    const file = try std.fs.cwd().openFile("./test_assets/recording.columnar", .{ .mode = .read_write });
+    const size = try file.getEndPos();
+    try file.setEndPos(size - 1);
+    file.close();
+    try testing.expectError(
+        error.InvalidColumn,
+        ColumnarFile.load(testing.allocator, "./test_assets/recording.columnar"),
+    );
+
+    try std.fs.cwd().writeFile(.{ .sub_path = "./test_assets/recording.columnar", .data = "not columnar at all" });
+    try testing.expectError(
+        error.MagicNumber,
+        ColumnarFile.load(testing.allocator, "./test_assets/recording.columnar"),
+    );
+}
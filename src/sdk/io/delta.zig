@@ -0,0 +1,162 @@
+const std = @import("std");
+const misc = @import("../misc/root.zig");
+
+// Changed regions get merged when they are separated by fewer unchanged bytes than this, because starting a new region
+// costs at least 2 bytes and usually more.
+const min_unchanged_run = 4;
+const max_varint_size = std.math.divCeil(usize, @bitSizeOf(usize), 7) catch unreachable;
+
+// Appends the difference between two values of the same size to the output. The difference is a list of regions, each
+// stored as the number of unchanged bytes before it, the number of changed bytes and the changed bytes XOR-ed with the
+// previous value. Numbers are stored as unsigned LEB128. Unchanged bytes after the last region are not stored, so two
+// equal values produce no bytes at all.
+pub fn encodeDelta(
+    allocator: std.mem.Allocator,
+    previous: []const u8,
+    current: []const u8,
+    output: *std.ArrayList(u8),
+) !void {
+    std.debug.assert(previous.len == current.len);
+    var index: usize = 0;
+    while (findChange(previous, current, index)) |change_start| {
+        const change_end = findChangeEnd(previous, current, change_start);
+        output.ensureUnusedCapacity(allocator, 2 * max_varint_size + change_end - change_start) catch |err| {
+            misc.error_context.new("Failed to grow delta output buffer.", .{});
+            return err;
+        };
+        appendVarint(output, change_start - index);
+        appendVarint(output, change_end - change_start);
+        for (previous[change_start..change_end], current[change_start..change_end]) |previous_byte, current_byte| {
+            output.appendAssumeCapacity(previous_byte ^ current_byte);
+        }
+        index = change_end;
+    }
+}
+
+// Turns the previous value into the current value by applying the difference produced by encodeDelta.
+pub fn decodeDelta(value: []u8, delta: []const u8) !void {
+    var value_index: usize = 0;
+    var delta_index: usize = 0;
+    while (delta_index < delta.len) {
+        const unchanged = try readVarint(delta, &delta_index);
+        const changed = try readVarint(delta, &delta_index);
+        if (unchanged > value.len - value_index or changed > value.len - value_index - unchanged) {
+            misc.error_context.new(
+                "Delta region of {} unchanged and {} changed bytes goes past the value's end at {}. Value size: {}",
+                .{ unchanged, changed, value_index, value.len },
+            );
+            return error.InvalidDelta;
+        }
+        if (changed > delta.len - delta_index) {
+            misc.error_context.new("Delta ends in the middle of a changed region.", .{});
+            return error.InvalidDelta;
+        }
+        value_index += unchanged;
+        for (value[value_index..][0..changed], delta[delta_index..][0..changed]) |*value_byte, delta_byte| {
+            value_byte.* ^= delta_byte;
+        }
+        value_index += changed;
+        delta_index += changed;
+    }
+}
+
+// Compares a word at a time, since most of the bytes are expected to be unchanged.
+fn findChange(previous: []const u8, current: []const u8, start: usize) ?usize {
+    const word_size = @sizeOf(usize);
+    var index = start;
+    while (index + word_size <= current.len) : (index += word_size) {
+        const previous_word = std.mem.readInt(usize, previous[index..][0..word_size], .little);
+        const current_word = std.mem.readInt(usize, current[index..][0..word_size], .little);
+        if (previous_word != current_word) {
+            return index + @ctz(previous_word ^ current_word) / 8;
+        }
+    }
+    while (index < current.len) : (index += 1) {
+        if (previous[index] != current[index]) {
+            return index;
+        }
+    }
+    return null;
+}
+
+fn findChangeEnd(previous: []const u8, current: []const u8, start: usize) usize {
+    var unchanged_run: usize = 0;
+    var index = start;
+    while (index < current.len and unchanged_run < min_unchanged_run) : (index += 1) {
+        if (previous[index] == current[index]) {
+            unchanged_run += 1;
+        } else {
+            unchanged_run = 0;
+        }
+    }
+    return index - unchanged_run;
+}
+
+fn appendVarint(output: *std.ArrayList(u8), value: usize) void {
+    var remaining = value;
+    while (remaining >= 0x80) : (remaining >>= 7) {
+        output.appendAssumeCapacity(@as(u8, @truncate(remaining)) | 0x80);
+    }
+    output.appendAssumeCapacity(@intCast(remaining));
+}
+
+fn readVarint(bytes: []const u8, index: *usize) !usize {
+    var value: usize = 0;
+    var shift: usize = 0;
+    while (index.* < bytes.len) {
+        const byte = bytes[index.*];
+        index.* += 1;
+        const is_too_large = shift >= @bitSizeOf(usize) or
+            @as(usize, byte & 0x7F) > std.math.maxInt(usize) >> @intCast(shift);
+        if (is_too_large) {
+            misc.error_context.new("Delta contains a number that is too large.", .{});
+            return error.InvalidDelta;
+        }
+        value |= @as(usize, byte & 0x7F) << @intCast(shift);
+        if (byte & 0x80 == 0) {
+            return value;
+        }
+        shift += 7;
+    }
+    misc.error_context.new("Delta ends in the middle of a number.", .{});
+    return error.InvalidDelta;
+}
+
+const testing = std.testing;
+
+test "decodeDelta should turn previous value into current value" {
+    var previous: [300]u8 = undefined;
+    for (&previous, 0..) |*byte, index| {
+        byte.* = @truncate(index * 7);
+    }
+    var current = previous;
+    current[0] = 1;
+    current[2] = 2;
+    current[150] ^= 0xFF;
+    current[151] ^= 0x0F;
+    current[299] = 3;
+
+    var delta: std.ArrayList(u8) = .empty;
+    defer delta.deinit(testing.allocator);
+    try encodeDelta(testing.allocator, &previous, &current, &delta);
+    try testing.expect(delta.items.len < 20);
+
+    var value = previous;
+    try decodeDelta(&value, delta.items);
+    try testing.expectEqualSlices(u8, &current, &value);
+}
+
+test "encodeDelta should produce no bytes when values are equal" {
+    const value = [_]u8{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+    var delta: std.ArrayList(u8) = .empty;
+    defer delta.deinit(testing.allocator);
+    try encodeDelta(testing.allocator, &value, &value, &delta);
+    try testing.expectEqual(0, delta.items.len);
+}
+
+test "decodeDelta should error when delta goes past the end of the value" {
+    var value = [_]u8{ 0, 0, 0, 0 };
+    try testing.expectError(error.InvalidDelta, decodeDelta(&value, &.{ 3, 2, 0xFF, 0xFF }));
+    try testing.expectError(error.InvalidDelta, decodeDelta(&value, &.{ 0, 2, 0xFF }));
+    try testing.expectError(error.InvalidDelta, decodeDelta(&value, &.{0x80}));
+}
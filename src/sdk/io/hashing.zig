@@ -0,0 +1,87 @@
+const std = @import("std");
+
+// Forwards everything written into it to the destination writer while hashing the written bytes.
+pub const HashingWriter = struct {
+    vtable: std.io.Writer.VTable,
+    des_writer: *std.io.Writer,
+    hasher: std.hash.Wyhash,
+
+    const Self = @This();
+
+    pub fn init(des_writer: *std.io.Writer) Self {
+        return .{
+            .vtable = .{
+                .drain = drain,
+                .flush = flush,
+            },
+            .des_writer = des_writer,
+            .hasher = .init(0),
+        };
+    }
+
+    pub fn writer(self: *Self, buffer: []u8) std.io.Writer {
+        return .{
+            .vtable = &self.vtable,
+            .buffer = buffer,
+        };
+    }
+
+    // Hash of all the bytes that got drained so far. Flush the writer before calling this.
+    pub fn final(self: *const Self) u64 {
+        var hasher = self.hasher;
+        return hasher.final();
+    }
+
+    fn drain(w: *std.io.Writer, data: []const []const u8, splat: usize) std.io.Writer.Error!usize {
+        const self: *Self = @constCast(@fieldParentPtr("vtable", w.vtable));
+
+        var consumed: usize = 0;
+        try self.consume(w.buffer[0..w.end]);
+        w.end = 0;
+        if (data.len == 0) {
+            return consumed;
+        }
+        for (data[0..(data.len - 1)]) |chunk| {
+            try self.consume(chunk);
+            consumed += chunk.len;
+        }
+        const last_chunk = data[data.len - 1];
+        for (0..splat) |_| {
+            try self.consume(last_chunk);
+            consumed += last_chunk.len;
+        }
+        return consumed;
+    }
+
+    fn flush(w: *std.io.Writer) std.io.Writer.Error!void {
+        const self: *Self = @constCast(@fieldParentPtr("vtable", w.vtable));
+        try self.consume(w.buffer[0..w.end]);
+        w.end = 0;
+        try self.des_writer.flush();
+    }
+
+    fn consume(self: *Self, data: []const u8) std.io.Writer.Error!void {
+        self.hasher.update(data);
+        try self.des_writer.writeAll(data);
+    }
+};
+
+const testing = std.testing;
+
+test "HashingWriter should forward written bytes and hash them" {
+    var buffer: [16]u8 = undefined;
+    var dest_writer = std.io.Writer.Allocating.init(testing.allocator);
+    defer dest_writer.deinit();
+    var hashing_writer = HashingWriter.init(&dest_writer.writer);
+    var writer = hashing_writer.writer(&buffer);
+
+    for (0..100) |i| {
+        try writer.writeInt(u32, @intCast(i), .little);
+    }
+    try writer.splatByteAll('a', 10);
+    try writer.flush();
+
+    const written = dest_writer.written();
+    try testing.expectEqual(410, written.len);
+    try testing.expectEqual(std.hash.Wyhash.hash(0, written), hashing_writer.final());
+}
@@ -0,0 +1,273 @@
+const std = @import("std");
+const misc = @import("../misc/root.zig");
+
+// Maximum number of items that are getting transformed or wait to get consumed at the same time.
+const max_in_flight = 8;
+
+pub const PipelineStageStats = struct {
+    number_of_items: u64 = 0,
+    busy_ns: u64 = 0,
+    wait_ns: u64 = 0,
+};
+
+// The stage with the most busy time is the bottleneck. Busy time of the transform stage is the sum over all the items,
+// so it can be larger then the total time. Produce stage waits for the oldest item to get transformed once too many
+// items are in flight, transform stage waits for a free worker and consume stage waits for the remaining items at the
+// end.
+pub const PipelineStats = struct {
+    stages: [3]PipelineStageStats = .{ .{}, .{}, .{} },
+    total_ns: u64 = 0,
+
+    const Self = @This();
+
+    pub fn log(self: *const Self, comptime name: []const u8, comptime stage_names: [3][]const u8) void {
+        std.log.debug("Pipeline {s} took {d:.3} ms.", .{ name, nanosecondsToMilliseconds(self.total_ns) });
+        inline for (stage_names, &self.stages) |stage_name, *stage| {
+            std.log.debug("Pipeline {s} stage {s}: {} items, {d:.3} ms busy, {d:.3} ms waiting", .{
+                name,
+                stage_name,
+                stage.number_of_items,
+                nanosecondsToMilliseconds(stage.busy_ns),
+                nanosecondsToMilliseconds(stage.wait_ns),
+            });
+        }
+    }
+};
+
+// Three stage pipeline on top of the default thread pool. The produce stage and the consume stage run on the calling
+// thread, while every emitted item gets transformed by a job of it's own, so several items get transformed at the same
+// time. Results get consumed in the same order as the items were emitted. Transform jobs never block, so a pipeline
+// that runs inside of a thread pool job can't occupy the workers that it's own items are waiting for. Ownership of an
+// item passes to the transform stage and ownership of a result passes to the consume stage. Items and results that
+// never reach their stage get freed.
+pub fn Pipeline(comptime Context: type, comptime Item: type, comptime Result: type) type {
+    return struct {
+        allocator: std.mem.Allocator,
+        pool: *misc.ThreadPool,
+        context: Context,
+        in_flight: misc.CircularBuffer(max_in_flight, TransformFuture) = .{},
+        is_emit_failed: bool = false,
+        stats: PipelineStats = .{},
+
+        const Self = @This();
+
+        const Transformed = struct {
+            result: anyerror!Result,
+            error_context: misc.ErrorContext(.{}) = .{},
+            wait_ns: u64,
+            busy_ns: u64,
+        };
+        const TransformFuture = misc.Future(Transformed);
+
+        pub const Stages = struct {
+            produce: fn (Context, *Emitter) anyerror!void,
+            transform: fn (Context, Item) anyerror!Result,
+            consume: fn (Context, Result) anyerror!void,
+            freeItem: fn (Context, Item) void,
+            freeResult: fn (Context, Result) void,
+        };
+
+        pub const Emitter = struct {
+            pipeline: *Self,
+            emitFn: *const fn (pipeline: *Self, item: Item) anyerror!void,
+            emit_ns: u64 = 0,
+
+            // Consumes the oldest result first when too many items are in flight.
+            pub fn emit(self: *Emitter, item: Item) !void {
+                var timer = startTimer();
+                defer self.emit_ns += timer.read();
+                self.emitFn(self.pipeline, item) catch |err| {
+                    self.pipeline.is_emit_failed = true;
+                    return err;
+                };
+            }
+        };
+
+        pub fn run(allocator: std.mem.Allocator, context: Context, comptime stages: Stages) !PipelineStats {
+            const pool = misc.ThreadPool.getDefault() catch |err| {
+                misc.error_context.append("Failed to get the default thread pool.", .{});
+                return err;
+            };
+            var self = Self{ .allocator = allocator, .pool = pool, .context = context };
+            defer self.cancelRemaining(stages);
+            var timer = startTimer();
+
+            const emitFn = struct {
+                fn call(pipeline: *Self, item: Item) anyerror!void {
+                    return pipeline.emit(item, stages);
+                }
+            }.call;
+            var emitter = Emitter{ .pipeline = &self, .emitFn = emitFn };
+            var produce_timer = startTimer();
+            stages.produce(context, &emitter) catch |err| {
+                if (!self.is_emit_failed) {
+                    misc.error_context.append("Failed to execute the produce stage.", .{});
+                }
+                return err;
+            };
+            self.stats.stages[0].busy_ns = produce_timer.read() -| emitter.emit_ns;
+
+            while (self.in_flight.len > 0) {
+                try self.consumeOldest(stages, &self.stats.stages[2].wait_ns);
+            }
+            self.stats.total_ns = timer.read();
+            return self.stats;
+        }
+
+        fn emit(self: *Self, item: Item, comptime stages: Stages) !void {
+            if (self.in_flight.len >= max_in_flight) {
+                self.consumeOldest(stages, &self.stats.stages[0].wait_ns) catch |err| {
+                    stages.freeItem(self.context, item);
+                    return err;
+                };
+            }
+            const future = self.pool.spawn(self.allocator, transformItem(stages), .{
+                self.context,
+                item,
+                startTimer(),
+            }) catch |err| {
+                stages.freeItem(self.context, item);
+                misc.error_context.append("Failed to spawn the transform job.", .{});
+                return err;
+            };
+            _ = self.in_flight.addToBack(future);
+            self.stats.stages[0].number_of_items += 1;
+        }
+
+        fn transformItem(comptime stages: Stages) fn (Context, Item, std.time.Timer) Transformed {
+            return struct {
+                fn call(context: Context, item: Item, spawn_timer: std.time.Timer) Transformed {
+                    var timer = spawn_timer;
+                    const wait_ns = timer.lap();
+                    const result = stages.transform(context, item);
+                    var transformed = Transformed{ .result = result, .wait_ns = wait_ns, .busy_ns = timer.read() };
+                    if (result) |_| {} else |_| {
+                        misc.error_context.append("Failed to execute the transform stage.", .{});
+                        transformed.error_context.copyFrom(&misc.error_context);
+                    }
+                    return transformed;
+                }
+            }.call;
+        }
+
+        // Helps executing queued jobs when called from a thread pool worker while the result is not ready yet.
+        fn consumeOldest(self: *Self, comptime stages: Stages, wait_ns: *u64) !void {
+            const future = self.in_flight.removeFirst() catch unreachable;
+            var wait_timer = startTimer();
+            // Transform jobs never get cancelled, so the result is always there.
+            const transformed = future.join() catch unreachable;
+            wait_ns.* += wait_timer.read();
+            self.addTransformStats(&transformed);
+            const result = transformed.result catch |err| {
+                misc.error_context.copyFrom(&transformed.error_context);
+                return err;
+            };
+            const consume_stats = &self.stats.stages[2];
+            var timer = startTimer();
+            defer consume_stats.busy_ns += timer.read();
+            consume_stats.number_of_items += 1;
+            try stages.consume(self.context, result);
+        }
+
+        fn addTransformStats(self: *Self, transformed: *const Transformed) void {
+            const transform_stats = &self.stats.stages[1];
+            transform_stats.wait_ns += transformed.wait_ns;
+            transform_stats.busy_ns += transformed.busy_ns;
+            if (transformed.result) |_| {
+                transform_stats.number_of_items += 1;
+            } else |_| {}
+        }
+
+        // Waits for the items that are still in flight after a failure and frees their results.
+        fn cancelRemaining(self: *Self, comptime stages: Stages) void {
+            while (self.in_flight.removeFirst()) |future| {
+                const transformed = future.join() catch unreachable;
+                const result = transformed.result catch continue;
+                stages.freeResult(self.context, result);
+            } else |_| {}
+        }
+    };
+}
+
+// Monotonic clock is always available on the targets this runs on, so failing to start a timer is not expected.
+fn startTimer() std.time.Timer {
+    return std.time.Timer.start() catch unreachable;
+}
+
+fn nanosecondsToMilliseconds(nanoseconds: u64) f64 {
+    const value: f64 = @floatFromInt(nanoseconds);
+    return value / std.time.ns_per_ms;
+}
+
+const testing = std.testing;
+
+const TestContext = struct {
+    number_of_items: usize,
+    fail_at: ?usize = null,
+    consumed: std.ArrayList(usize) = .empty,
+    number_of_live_items: std.atomic.Value(usize) = .init(0),
+
+    const TestPipeline = Pipeline(*TestContext, *usize, *usize);
+    const stages = TestPipeline.Stages{
+        .produce = produce,
+        .transform = transform,
+        .consume = consume,
+        .freeItem = free,
+        .freeResult = free,
+    };
+
+    fn produce(self: *TestContext, emitter: *TestPipeline.Emitter) anyerror!void {
+        for (0..self.number_of_items) |index| {
+            const item = try testing.allocator.create(usize);
+            _ = self.number_of_live_items.fetchAdd(1, .seq_cst);
+            item.* = index;
+            try emitter.emit(item);
+        }
+    }
+
+    fn transform(self: *TestContext, item: *usize) anyerror!*usize {
+        if (self.fail_at == item.*) {
+            misc.error_context.new("Test failure at: {}", .{item.*});
+            self.free(item);
+            return error.Test;
+        }
+        item.* *= 2;
+        return item;
+    }
+
+    fn consume(self: *TestContext, result: *usize) anyerror!void {
+        defer self.free(result);
+        try self.consumed.append(testing.allocator, result.*);
+    }
+
+    fn free(self: *TestContext, item: *usize) void {
+        testing.allocator.destroy(item);
+        _ = self.number_of_live_items.fetchSub(1, .seq_cst);
+    }
+};
+
+test "run should pass every item through all stages in order" {
+    var context = TestContext{ .number_of_items = 100 };
+    defer context.consumed.deinit(testing.allocator);
+    const stats = try TestContext.TestPipeline.run(testing.allocator, &context, TestContext.stages);
+    try testing.expectEqual(100, context.consumed.items.len);
+    for (context.consumed.items, 0..) |value, index| {
+        try testing.expectEqual(2 * index, value);
+    }
+    for (&stats.stages) |*stage| {
+        try testing.expectEqual(100, stage.number_of_items);
+    }
+    try testing.expectEqual(0, context.number_of_live_items.load(.seq_cst));
+}
+
+test "run should return the error of a worker stage with it's context and free the remaining items" {
+    var context = TestContext{ .number_of_items = 100, .fail_at = 10 };
+    defer context.consumed.deinit(testing.allocator);
+    misc.error_context.clear();
+    try testing.expectError(error.Test, TestContext.TestPipeline.run(testing.allocator, &context, TestContext.stages));
+    const message = try std.fmt.allocPrint(testing.allocator, "{f}", .{misc.error_context});
+    defer testing.allocator.free(message);
+    try testing.expectEqualStrings("1) Failed to execute the transform stage.\n2) Test failure at: 10\n", message);
+    try testing.expect(context.consumed.items.len <= 10);
+    try testing.expectEqual(0, context.number_of_live_items.load(.seq_cst));
+}
@@ -0,0 +1,345 @@
+const std = @import("std");
+const misc = @import("../misc/root.zig");
+const io = @import("root.zig");
+
+pub const ScalarKind = enum(u8) {
+    int = 0,
+    float = 1,
+};
+
+pub const LayoutRun = struct {
+    kind: ScalarKind,
+    size: u8,
+    count: u16,
+};
+
+pub const max_scalar_size = @sizeOf(u64);
+const varint_group_bits = 7;
+
+pub fn getLayoutSize(layout: []const LayoutRun) usize {
+    var sum: usize = 0;
+    for (layout) |*run| {
+        sum += @as(usize, run.size) * run.count;
+    }
+    return sum;
+}
+
+pub fn validateLayout(layout: []const LayoutRun) !void {
+    for (layout, 0..) |*run, index| {
+        const is_valid = switch (run.kind) {
+            .int => run.size >= 1 and run.size <= max_scalar_size,
+            .float => run.size == 2 or run.size == 4 or run.size == 8,
+        };
+        if (!is_valid) {
+            misc.error_context.new(
+                "Layout run {} has unsupported {s} scalar size: {}",
+                .{ index, @tagName(run.kind), run.size },
+            );
+            return error.InvalidLayout;
+        }
+    }
+}
+
+pub fn encodeImage(
+    writer: *io.BitWriter,
+    layout: []const LayoutRun,
+    previous_image: []const u8,
+    current_image: []const u8,
+) !void {
+    std.debug.assert(previous_image.len == current_image.len);
+    std.debug.assert(getLayoutSize(layout) == current_image.len);
+    var offset: usize = 0;
+    for (layout) |*run| {
+        for (0..run.count) |_| {
+            const end = offset + run.size;
+            const prediction = loadScalar(previous_image[offset..end]);
+            const value = loadScalar(current_image[offset..end]);
+            switch (run.kind) {
+                .int => writeIntResidual(writer, run.size, prediction, value) catch |err| {
+                    misc.error_context.append("Failed to write int residual at offset: {}", .{offset});
+                    return err;
+                },
+                .float => writeFloatResidual(writer, run.size, prediction, value) catch |err| {
+                    misc.error_context.append("Failed to write float residual at offset: {}", .{offset});
+                    return err;
+                },
+            }
+            offset = end;
+        }
+    }
+}
+
+pub fn decodeImage(reader: *io.BitReader, layout: []const LayoutRun, image: []u8) !void {
+    if (getLayoutSize(layout) != image.len) {
+        misc.error_context.new(
+            "Layout size {} does not match the image size {}.",
+            .{ getLayoutSize(layout), image.len },
+        );
+        return error.InvalidLayout;
+    }
+    var offset: usize = 0;
+    for (layout) |*run| {
+        for (0..run.count) |_| {
+            const end = offset + run.size;
+            const prediction = loadScalar(image[offset..end]);
+            const value = switch (run.kind) {
+                .int => readIntResidual(reader, prediction) catch |err| {
+                    misc.error_context.append("Failed to read int residual at offset: {}", .{offset});
+                    return err;
+                },
+                .float => readFloatResidual(reader, run.size, prediction) catch |err| {
+                    misc.error_context.append("Failed to read float residual at offset: {}", .{offset});
+                    return err;
+                },
+            };
+            storeScalar(image[offset..end], value);
+            offset = end;
+        }
+    }
+}
+
+fn writeIntResidual(writer: *io.BitWriter, size: u8, prediction: u64, value: u64) !void {
+    const delta = signExtend(size, value -% prediction);
+    if (delta == 0) {
+        try writer.writeBool(false);
+        return;
+    }
+    try writer.writeBool(true);
+    var remaining = zigZagEncode(delta);
+    while (true) {
+        const group: u7 = @truncate(remaining);
+        remaining >>= varint_group_bits;
+        try writer.writeInt(u7, group);
+        try writer.writeBool(remaining != 0);
+        if (remaining == 0) {
+            break;
+        }
+    }
+}
+
+fn readIntResidual(reader: *io.BitReader, prediction: u64) !u64 {
+    const is_changed = try reader.readBool();
+    if (!is_changed) {
+        return prediction;
+    }
+    var zig_zag: u64 = 0;
+    var shift: u7 = 0;
+    while (true) {
+        if (shift >= @bitSizeOf(u64)) {
+            misc.error_context.new("Varint exceeds the maximum length of {} bits.", .{@bitSizeOf(u64)});
+            return error.InvalidValue;
+        }
+        const group = try reader.readInt(u7);
+        zig_zag |= @as(u64, group) << @intCast(shift);
+        const has_more = try reader.readBool();
+        if (!has_more) {
+            break;
+        }
+        shift += varint_group_bits;
+    }
+    const delta: u64 = @bitCast(zigZagDecode(zig_zag));
+    return prediction +% delta;
+}
+
+fn writeFloatResidual(writer: *io.BitWriter, size: u8, prediction: u64, value: u64) !void {
+    const xor = prediction ^ value;
+    if (xor == 0) {
+        try writer.writeBool(false);
+        return;
+    }
+    try writer.writeBool(true);
+    const bits: u7 = @intCast(@as(u32, size) * std.mem.byte_size_in_bits);
+    const header_bits = getFloatHeaderBits(size);
+    const leading: u7 = @clz(xor) - (@bitSizeOf(u64) - bits);
+    const trailing: u7 = @ctz(xor);
+    const meaningful = bits - leading - trailing;
+    try writeBits(writer, leading, header_bits);
+    try writeBits(writer, meaningful - 1, header_bits);
+    try writeBits(writer, xor >> @intCast(trailing), meaningful);
+}
+
+fn readFloatResidual(reader: *io.BitReader, size: u8, prediction: u64) !u64 {
+    const is_changed = try reader.readBool();
+    if (!is_changed) {
+        return prediction;
+    }
+    const bits: u64 = @as(u64, size) * std.mem.byte_size_in_bits;
+    const header_bits = getFloatHeaderBits(size);
+    const leading = try readBits(reader, header_bits);
+    const meaningful = (try readBits(reader, header_bits)) + 1;
+    if (leading + meaningful > bits) {
+        misc.error_context.new(
+            "Float residual has {} leading and {} meaningful bits which exceeds {} bits.",
+            .{ leading, meaningful, bits },
+        );
+        return error.InvalidValue;
+    }
+    const trailing = bits - leading - meaningful;
+    const xor = (try readBits(reader, @intCast(meaningful))) << @intCast(trailing);
+    return prediction ^ xor;
+}
+
+fn getFloatHeaderBits(size: u8) u7 {
+    return switch (size) {
+        2 => 4,
+        4 => 5,
+        8 => 6,
+        else => unreachable,
+    };
+}
+
+fn writeBits(writer: *io.BitWriter, value: u64, count: u7) !void {
+    var remaining_value = value;
+    var remaining_count = count;
+    while (remaining_count >= std.mem.byte_size_in_bits) {
+        try writer.writeInt(u8, @truncate(remaining_value));
+        remaining_value >>= std.mem.byte_size_in_bits;
+        remaining_count -= std.mem.byte_size_in_bits;
+    }
+    while (remaining_count > 0) {
+        try writer.writeBool((remaining_value & 1) != 0);
+        remaining_value >>= 1;
+        remaining_count -= 1;
+    }
+}
+
+fn readBits(reader: *io.BitReader, count: u7) !u64 {
+    var value: u64 = 0;
+    var shift: u7 = 0;
+    while (count - shift >= std.mem.byte_size_in_bits) {
+        const byte = try reader.readInt(u8);
+        value |= @as(u64, byte) << @intCast(shift);
+        shift += std.mem.byte_size_in_bits;
+    }
+    while (shift < count) {
+        if (try reader.readBool()) {
+            value |= @as(u64, 1) << @intCast(shift);
+        }
+        shift += 1;
+    }
+    return value;
+}
+
+fn loadScalar(bytes: []const u8) u64 {
+    var value: u64 = 0;
+    for (bytes, 0..) |byte, index| {
+        value |= @as(u64, byte) << @intCast(index * std.mem.byte_size_in_bits);
+    }
+    return value;
+}
+
+fn storeScalar(bytes: []u8, value: u64) void {
+    for (bytes, 0..) |*byte, index| {
+        byte.* = @truncate(value >> @intCast(index * std.mem.byte_size_in_bits));
+    }
+}
+
+fn signExtend(size: u8, value: u64) i64 {
+    const shift: u6 = @intCast(@bitSizeOf(u64) - @as(u32, size) * std.mem.byte_size_in_bits);
+    const signed: i64 = @bitCast(value << shift);
+    return signed >> shift;
+}
+
+fn zigZagEncode(value: i64) u64 {
+    const unsigned: u64 = @bitCast(value);
+    const sign: u64 = @bitCast(value >> (@bitSizeOf(i64) - 1));
+    return (unsigned << 1) ^ sign;
+}
+
+fn zigZagDecode(value: u64) i64 {
+    const magnitude: i64 = @bitCast(value >> 1);
+    const sign: i64 = -@as(i64, @intCast(value & 1));
+    return magnitude ^ sign;
+}
+
+const testing = std.testing;
+
+test "decodeImage should decode the same image that encodeImage encoded" {
+    const layout = [_]LayoutRun{
+        .{ .kind = .int, .size = 1, .count = 2 },
+        .{ .kind = .float, .size = 4, .count = 3 },
+        .{ .kind = .int, .size = 4, .count = 1 },
+        .{ .kind = .float, .size = 8, .count = 1 },
+        .{ .kind = .int, .size = 3, .count = 1 },
+        .{ .kind = .float, .size = 2, .count = 1 },
+    };
+    const Image = [getLayoutSize(&layout)]u8;
+    var images: [3]Image = undefined;
+    for (&images, 0..) |*image, index| {
+        var writer = std.io.Writer.fixed(image);
+        const i: i32 = @intCast(index);
+        const f: f32 = @floatFromInt(index);
+        const d: f64 = @floatFromInt(index);
+        try writer.writeByte(@intCast(index));
+        try writer.writeByte(@intCast(2 - index));
+        try writer.writeInt(u32, @bitCast(1.0 + 0.001 * f), .little);
+        try writer.writeInt(u32, @bitCast(-100.0 - 3.0 * f), .little);
+        try writer.writeInt(u32, @bitCast(@as(f32, 0)), .little);
+        try writer.writeInt(i32, 1000 - 700 * i, .little);
+        try writer.writeInt(u64, @bitCast(1e9 * d), .little);
+        try writer.writeInt(u24, @intCast(0xFFFFFF - index), .little);
+        try writer.writeInt(u16, @bitCast(@as(f16, 0.5) * @as(f16, @floatCast(f))), .little);
+    }
+
+    var buffer: [128]u8 = undefined;
+    var dest_writer = std.io.Writer.fixed(&buffer);
+    var bit_writer = io.BitWriter{ .dest_writer = &dest_writer };
+    const zero_image = [1]u8{0} ** @sizeOf(Image);
+    try encodeImage(&bit_writer, &layout, &zero_image, &images[0]);
+    try encodeImage(&bit_writer, &layout, &images[0], &images[1]);
+    try encodeImage(&bit_writer, &layout, &images[1], &images[2]);
+    try bit_writer.flush();
+
+    var src_reader = std.io.Reader.fixed(&buffer);
+    var bit_reader = io.BitReader{ .src_reader = &src_reader };
+    var image = zero_image;
+    try decodeImage(&bit_reader, &layout, &image);
+    try testing.expectEqualSlices(u8, &images[0], &image);
+    try decodeImage(&bit_reader, &layout, &image);
+    try testing.expectEqualSlices(u8, &images[1], &image);
+    try decodeImage(&bit_reader, &layout, &image);
+    try testing.expectEqualSlices(u8, &images[2], &image);
+}
+
+test "encodeImage should use a single bit for every scalar that matches the prediction" {
+    const layout = [_]LayoutRun{
+        .{ .kind = .int, .size = 4, .count = 5 },
+        .{ .kind = .float, .size = 4, .count = 6 },
+    };
+    const image = [1]u8{0xAB} ** getLayoutSize(&layout);
+    var buffer: [16]u8 = undefined;
+    var dest_writer = std.io.Writer.fixed(&buffer);
+    var bit_writer = io.BitWriter{ .dest_writer = &dest_writer };
+    try encodeImage(&bit_writer, &layout, &image, &image);
+    try testing.expectEqual(11, bit_writer.absolute_position);
+}
+
+test "encodeImage should use fewer bits for small float changes then for large ones" {
+    const layout = [_]LayoutRun{.{ .kind = .float, .size = 4, .count = 1 }};
+    const previous: [4]u8 = @bitCast(@as(f32, 123.456));
+    const small_change: [4]u8 = @bitCast(@as(f32, 123.457));
+    const large_change: [4]u8 = @bitCast(@as(f32, -0.001));
+    var buffer: [16]u8 = undefined;
+
+    var dest_writer_1 = std.io.Writer.fixed(&buffer);
+    var bit_writer_1 = io.BitWriter{ .dest_writer = &dest_writer_1 };
+    try encodeImage(&bit_writer_1, &layout, &previous, &small_change);
+
+    var dest_writer_2 = std.io.Writer.fixed(&buffer);
+    var bit_writer_2 = io.BitWriter{ .dest_writer = &dest_writer_2 };
+    try encodeImage(&bit_writer_2, &layout, &previous, &large_change);
+
+    try testing.expect(bit_writer_1.absolute_position < bit_writer_2.absolute_position);
+    try testing.expect(bit_writer_1.absolute_position < 32);
+}
+
+test "validateLayout should return error.InvalidLayout when scalar size is not supported" {
+    try validateLayout(&.{
+        .{ .kind = .int, .size = 1, .count = 1 },
+        .{ .kind = .int, .size = 8, .count = 1 },
+        .{ .kind = .float, .size = 4, .count = 1 },
+    });
+    try testing.expectError(error.InvalidLayout, validateLayout(&.{.{ .kind = .int, .size = 9, .count = 1 }}));
+    try testing.expectError(error.InvalidLayout, validateLayout(&.{.{ .kind = .int, .size = 0, .count = 1 }}));
+    try testing.expectError(error.InvalidLayout, validateLayout(&.{.{ .kind = .float, .size = 3, .count = 1 }}));
+}
@@ -5,18 +5,48 @@ const misc = @import("../misc/root.zig");
 const io = @import("root.zig");
 
 const VersionNumber = u16;
+const HeaderEntrySize = u16;
 const FieldIndex = u8;
 const FieldPathLength = u8;
 const FieldSize = u16;
+const LayoutLength = u16;
 const NumberOfFrames = u64;
-const LocalField = struct {
+const ChunkLength = u32;
+const BlockSize = u32;
+const ContentHash = u64;
+const Label = u32;
+const Precision = f64;
+const DictionaryId = u64;
+const BlockChecksum = u32;
+const HeaderEntryId = enum(u8) {
+    end = 0,
+    codec = 1,
+    content_hash = 2,
+    game = 3,
+    number_of_frames = 4,
+    markers = 5,
+    labels = 6,
+    profile = 7,
+    dictionary = 8,
+    _,
+};
+const Header = struct {
+    codec: RecordingCodec = .raw,
+    content_hash: ?ContentHash = null,
+    game: ?build_info.Game = null,
+    metadata: ?RecordingMetadata = null,
+    profile: ?RecordingProfileName = null,
+    dictionary_id: ?DictionaryId = null,
+};
+pub const LocalField = struct {
     path: []const u8,
     access: []const AccessElement,
     Type: type,
     parent_index: ?FieldIndex,
     has_children: bool,
+    precision: ?Precision = null,
 };
-const AccessElement = union(enum) {
+pub const AccessElement = union(enum) {
     struct_field: []const u8,
     array_index: usize,
     optional_payload: void,
@@ -25,141 +55,2104 @@ const AccessElement = union(enum) {
 const RemoteField = struct {
     local_index: ?usize,
     size: FieldSize,
+    layout_start: usize = 0,
+    layout_len: usize = 0,
+    image_offset: usize = 0,
+    precision: ?Precision = null,
+};
+const LayoutRun = io.PredictiveLayoutRun;
+const Chunk = struct {
+    number_of_frames: ChunkLength,
+    block_size: BlockSize,
+};
+// Chunk travelling through the load and save pipelines. Data is either the compressed block or the frame bytes.
+const ChunkData = struct {
+    chunk: Chunk,
+    data: []u8,
+
+    fn free(comptime Context: type) fn (Context, ChunkData) void {
+        return struct {
+            fn call(context: Context, chunk_data: ChunkData) void {
+                context.allocator.free(chunk_data.data);
+            }
+        }.call;
+    }
 };
 
 const endian = std.builtin.Endian.little;
 const magic_number = @tagName(build_info.name);
 const version_number = build_info.recording_version;
+const first_version_with_header = 2;
+const first_version_with_chunks = 3;
+const first_version_with_precisions = 4;
 const max_number_of_fields = std.math.maxInt(FieldIndex);
 const max_field_path_len = std.math.maxInt(FieldPathLength);
 const path_separator = '.';
-const path_separator_str = [1]u8{path_separator};
-const optional_payload_path_component = "payload";
+pub const path_separator_str = [1]u8{path_separator};
+pub const optional_payload_path_component = "payload";
 const pattern_wildcard = '?';
-const buffer_size = 4096;
+// Files and blocks are read and written in the same amount of bytes that the XZ encoder and decoder pass to liblzma,
+// so a buffer never gets split between two calls. Pipeline threads keep the decoding busy in the meantime.
+const buffer_size = io.xz_chunk_size;
+// Content hash is always the first header entry, so it can be patched in once the rest of the file is written.
+const content_hash_offset = magic_number.len + @sizeOf(VersionNumber) + 1 + @sizeOf(HeaderEntrySize);
+// Block size that marks a chunk kept inside the chunk store of the library. Header of such chunk is followed by the
+// hash of the chunk instead of the block. Only recordings saved into a library with a chunk store contain these chunks.
+const referenced_block_size = std.math.maxInt(BlockSize);
+
+pub const RecordingConfig = struct {
+    atomic_types: []const type = &.{},
+    atomic_paths: []const []const u8 = &.{},
+    codec: RecordingCodec = .raw,
+    // Floats inside fields that match these paths get stored as the nearest integer multiple of the precision instead
+    // of their exact value. Restored values are within half of the precision from the recorded ones. Integers change
+    // less from frame to frame than float bits do, so lossy recordings compress considerably better.
+    quantized_paths: []const QuantizedPath = &.{},
+    // Fields that match these paths, together with everything under them, don't get recorded at all. They are left out
+    // of the field list, so readers fill them with default values. Atomic types and paths that match only fields under
+    // excluded paths are allowed to stay unused, so that profiles can share them with the full configuration.
+    excluded_paths: []const []const u8 = &.{},
+    // Name of the field subset that the configuration records. Gets stored in the header, so the recording can be
+    // recognized without reading the field list.
+    profile: ?[]const u8 = null,
+    // Frames are split into independently compressed chunks so that recordings can be edited without re-encoding
+    // everything. Ten seconds of gameplay at 60 FPS keeps the compression ratio close to a single stream.
+    frames_per_chunk: usize = 600,
+    // Preset dictionaries that compression starts from instead of a empty window, so that short recordings don't spend
+    // most of their size re-learning the field list and the usual shape of frames. Recordings get written with the
+    // last dictionary and store it's ID inside the header. Readers find the dictionary by that ID, so a dictionary has
+    // to stay listed for as long as recordings written with it should stay readable. Dictionaries are referenced
+    // through pointers so that they can also be filled at runtime. Empty dictionaries are skipped.
+    dictionaries: []const *const RecordingDictionary = &.{},
+    // Optional type that describes the frames inside the uncompressed metadata header. It has to declare:
+    // `fn isMarker(previous: ?*const Frame, current: *const Frame) bool` marking notable frames like round starts and
+    // `fn getLabels(frame: *const Frame) [N]?u32` returning values that the whole recording gets tagged with.
+    MetadataExtractor: ?type = null,
+};
+
+pub const QuantizedPath = struct {
+    pattern: []const u8,
+    precision: Precision,
+};
+
+pub const RecordingDictionary = struct {
+    bytes: []const u8 = &.{},
+
+    const Self = @This();
+    // Preset dictionary can't be larger then the LZMA dictionary window of XzEncoder.
+    pub const max_size = 256 * 1024;
+
+    pub fn getId(self: *const Self) DictionaryId {
+        return std.hash.Wyhash.hash(0, self.bytes);
+    }
+};
+
+pub const RecordingProfileName = struct {
+    buffer: [max_len]u8 = undefined,
+    len: usize = 0,
+
+    const Self = @This();
+    pub const max_len = 32;
+
+    // Names longer then max_len get cut off.
+    pub fn init(name: []const u8) Self {
+        var self = Self{ .len = @min(name.len, max_len) };
+        @memcpy(self.buffer[0..self.len], name[0..self.len]);
+        return self;
+    }
+
+    pub fn get(self: *const Self) []const u8 {
+        return self.buffer[0..self.len];
+    }
+};
+
+// Summary of a recording that is stored uncompressed in the header, so it can be read without decoding any frames.
+pub const RecordingMetadata = struct {
+    number_of_frames: u64 = 0,
+    markers_buffer: [max_markers]u32 = undefined,
+    markers_len: usize = 0,
+    labels_buffer: [max_labels]Label = undefined,
+    labels_len: usize = 0,
+
+    const Self = @This();
+    pub const max_markers = 1024;
+    pub const max_labels = 32;
+
+    // Frame indices in ascending order. Markers after the first max_markers get dropped.
+    pub fn getMarkers(self: *const Self) []const u32 {
+        return self.markers_buffer[0..self.markers_len];
+    }
+
+    // Unique labels in ascending order. Labels after the first max_labels get dropped.
+    pub fn getLabels(self: *const Self) []const Label {
+        return self.labels_buffer[0..self.labels_len];
+    }
+
+    pub fn addMarker(self: *Self, frame_index: u32) void {
+        if (self.markers_len >= max_markers) {
+            return;
+        }
+        if (self.markers_len > 0 and self.markers_buffer[self.markers_len - 1] >= frame_index) {
+            return;
+        }
+        self.markers_buffer[self.markers_len] = frame_index;
+        self.markers_len += 1;
+    }
+
+    pub fn addLabel(self: *Self, label: Label) void {
+        var index: usize = 0;
+        while (index < self.labels_len and self.labels_buffer[index] < label) : (index += 1) {}
+        if (index < self.labels_len and self.labels_buffer[index] == label) {
+            return;
+        }
+        if (self.labels_len >= max_labels) {
+            return;
+        }
+        std.mem.copyBackwards(
+            Label,
+            self.labels_buffer[(index + 1)..(self.labels_len + 1)],
+            self.labels_buffer[index..self.labels_len],
+        );
+        self.labels_buffer[index] = label;
+        self.labels_len += 1;
+    }
+};
+
+// Everything that can be learned about a recording by reading only its header.
+pub const RecordingInfo = struct {
+    version: VersionNumber,
+    codec: RecordingCodec,
+    content_hash: ?ContentHash,
+    game: ?build_info.Game,
+    metadata: ?RecordingMetadata,
+    profile: ?RecordingProfileName,
+    dictionary_id: ?DictionaryId,
+};
+
+pub const RecordingCodec = enum(u8) {
+    // Changed fields are stored as raw little endian bytes.
+    raw = 0,
+    // Changed fields are stored as residuals against the previously stored value of the same field:
+    // floats as XOR with leading and trailing zeroes compacted, integers as zig-zag varints.
+    predictive = 1,
+};
+
+pub fn saveRecording(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    frames: []const Frame,
+    file_path: []const u8,
+    comptime config: *const RecordingConfig,
+) !void {
+    const fields = getLocalFields(Frame, config);
+    const field_list = serializeFieldList(allocator, fields, config.codec, version_number) catch |err| {
+        misc.error_context.append("Failed to serialize field list.", .{});
+        return err;
+    };
+    defer allocator.free(field_list);
+
+    // Has to be opened before the file gets overwritten, since it reads the chunks that the old file references.
+    var maybe_stored = StoredChunks.open(allocator, file_path, field_list) catch |err| {
+        misc.error_context.append("Failed to open the chunk store for: {s}", .{file_path});
+        return err;
+    };
+    defer if (maybe_stored) |*stored| stored.deinit();
+
+    const file = std.fs.cwd().createFile(file_path, .{}) catch |err| {
+        misc.error_context.new("Failed to create or open file: {s}", .{file_path});
+        return err;
+    };
+    defer file.close();
+
+    const header = Header{
+        .codec = config.codec,
+        .game = build_info.game,
+        .metadata = extractMetadata(Frame, frames, config),
+        .profile = getProfileName(config),
+        .dictionary_id = getWriterDictionaryId(config),
+    };
+    const Context = struct {
+        allocator: std.mem.Allocator,
+        frames: []const Frame,
+        field_list: []const u8,
+        stored: ?*StoredChunks,
+    };
+    const context = Context{
+        .allocator = allocator,
+        .frames = frames,
+        .field_list = field_list,
+        .stored = if (maybe_stored) |*stored| stored else null,
+    };
+    writeRecordingFile(file, &header, &context, struct {
+        fn call(c: *const Context, writer: *std.io.Writer) anyerror!void {
+            writeFieldListBlock(c.allocator, writer, c.field_list, getWriterDictionary(config)) catch |err| {
+                misc.error_context.append("Failed to write field list.", .{});
+                return err;
+            };
+            const fields = getLocalFields(Frame, config);
+            writeChunks(Frame, c.allocator, writer, c.frames, c.stored, fields, config) catch |err| {
+                misc.error_context.append("Failed to write chunks.", .{});
+                return err;
+            };
+            writeChunkEnd(writer) catch |err| {
+                misc.error_context.append("Failed to write chunk end marker.", .{});
+                return err;
+            };
+        }
+    }.call) catch |err| {
+        misc.error_context.append("Failed to write recording file: {s}", .{file_path});
+        return err;
+    };
+    if (maybe_stored) |*stored| {
+        stored.commit() catch |err| {
+            misc.error_context.append("Failed to commit chunk references of: {s}", .{file_path});
+            return err;
+        };
+    }
+}
+
+pub fn loadRecording(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    file_path: []const u8,
+    comptime config: *const RecordingConfig,
+) ![]Frame {
+    var frames: std.ArrayList(Frame) = .empty;
+    errdefer frames.deinit(allocator);
+    readRecordingFile(Frame, allocator, file_path, config, &frames, {}, struct {
+        fn call(_: void, _: *std.ArrayList(Frame)) anyerror!void {}
+    }.call) catch |err| {
+        misc.error_context.append("Failed to read recording file: {s}", .{file_path});
+        return err;
+    };
+    return frames.toOwnedSlice(allocator) catch |err| {
+        misc.error_context.new("Failed to convert frames to owned slice.", .{});
+        return err;
+    };
+}
+
+// Decodes the recording one chunk at a time and passes the frames of every chunk to the callback, so that only a
+// single chunk of frames is held in memory at any point. Recordings saved before chunks existed arrive as one chunk.
+pub fn loadRecordingChunks(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    file_path: []const u8,
+    comptime config: *const RecordingConfig,
+    context: anytype,
+    comptime onChunk: fn (@TypeOf(context), []const Frame) anyerror!void,
+) !void {
+    var frames: std.ArrayList(Frame) = .empty;
+    defer frames.deinit(allocator);
+    const Context = @TypeOf(context);
+    readRecordingFile(Frame, allocator, file_path, config, &frames, context, struct {
+        fn call(c: Context, chunk_frames: *std.ArrayList(Frame)) anyerror!void {
+            try onChunk(c, chunk_frames.items);
+            chunk_frames.clearRetainingCapacity();
+        }
+    }.call) catch |err| {
+        misc.error_context.append("Failed to read recording file: {s}", .{file_path});
+        return err;
+    };
+}
+
+// Appends the frames of every chunk into the list and calls the callback after each chunk.
+fn readRecordingFile(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    file_path: []const u8,
+    comptime config: *const RecordingConfig,
+    frames: *std.ArrayList(Frame),
+    context: anytype,
+    comptime onChunk: fn (@TypeOf(context), *std.ArrayList(Frame)) anyerror!void,
+) !void {
+    const file = std.fs.cwd().openFile(file_path, .{}) catch |err| {
+        misc.error_context.new("Failed to open file: {s}", .{file_path});
+        return err;
+    };
+    defer file.close();
+
+    var file_buffer: [buffer_size]u8 = undefined;
+    var file_reader = file.reader(&file_buffer);
+    const reader = &file_reader.interface;
+
+    const file_start = readFileStart(reader) catch |err| {
+        misc.error_context.append("Failed to read file start.", .{});
+        return err;
+    };
+
+    const local_fields = getLocalFields(Frame, config);
+    if (file_start.version < first_version_with_chunks) {
+        const stream_frames = readStreamRecording(
+            Frame,
+            allocator,
+            reader,
+            file_start.header.codec,
+            file_start.version,
+            local_fields,
+        ) catch |err| {
+            misc.error_context.append("Failed to read recording stream.", .{});
+            return err;
+        };
+        defer allocator.free(stream_frames);
+        frames.appendSlice(allocator, stream_frames) catch |err| {
+            misc.error_context.new("Failed to append {} frames.", .{stream_frames.len});
+            return err;
+        };
+        return onChunk(context, frames);
+    }
+
+    const dictionary = findDictionary(config, file_start.header.dictionary_id) catch |err| {
+        misc.error_context.append("Failed to find the compression dictionary.", .{});
+        return err;
+    };
+    const field_list = readFieldListBlock(allocator, reader, dictionary) catch |err| {
+        misc.error_context.append("Failed to read field list.", .{});
+        return err;
+    };
+    defer allocator.free(field_list);
+    var field_list_reader = std.io.Reader.fixed(field_list);
+    var byte_reader = io.ByteReader{ .src_reader = &field_list_reader, .endian = endian };
+    var remote_fields_buffer: [max_number_of_fields]RemoteField = undefined;
+    var layouts: std.ArrayList(LayoutRun) = .empty;
+    defer layouts.deinit(allocator);
+    const remote_fields = readFieldList(
+        allocator,
+        &byte_reader,
+        &remote_fields_buffer,
+        &layouts,
+        file_start.header.codec,
+        file_start.version,
+        local_fields,
+    ) catch |err| {
+        misc.error_context.append("Failed to read fields list.", .{});
+        return err;
+    };
+
+    var maybe_store = io.ChunkStore.openForRecording(file_path) catch |err| {
+        misc.error_context.append("Failed to open the chunk store for: {s}", .{file_path});
+        return err;
+    };
+    defer if (maybe_store) |*store| store.close();
+
+    // Chunks get decompressed by thread pool jobs while the next chunks get read and the previous ones decoded.
+    const LoadContext = struct {
+        allocator: std.mem.Allocator,
+        reader: *std.io.Reader,
+        store: ?*const io.ChunkStore,
+        codec: RecordingCodec,
+        dictionary: ?[]const u8,
+        remote_fields: []const RemoteField,
+        layouts: []const LayoutRun,
+        frames: *std.ArrayList(Frame),
+        context: @TypeOf(context),
+    };
+    const LoadPipeline = io.Pipeline(*const LoadContext, ChunkData, ChunkData);
+    const load_context = LoadContext{
+        .allocator = allocator,
+        .reader = reader,
+        .store = if (maybe_store) |*store| store else null,
+        .codec = file_start.header.codec,
+        .dictionary = dictionary,
+        .remote_fields = remote_fields,
+        .layouts = layouts.items,
+        .frames = frames,
+        .context = context,
+    };
+    const stats = LoadPipeline.run(allocator, &load_context, .{
+        .produce = struct {
+            fn call(c: *const LoadContext, emitter: *LoadPipeline.Emitter) anyerror!void {
+                var chunk_index: usize = 0;
+                while (true) : (chunk_index += 1) {
+                    errdefer misc.error_context.append("Failed to read chunk: {}", .{chunk_index});
+                    const maybe_chunk = readChunkHeader(c.reader) catch |err| {
+                        misc.error_context.append("Failed to read chunk header.", .{});
+                        return err;
+                    };
+                    const chunk = maybe_chunk orelse return;
+                    const block = readChunkBlock(c.allocator, c.reader, &chunk, c.store) catch |err| {
+                        misc.error_context.append("Failed to read chunk block.", .{});
+                        return err;
+                    };
+                    try emitter.emit(.{ .chunk = chunk, .data = block });
+                }
+            }
+        }.call,
+        .transform = struct {
+            fn call(c: *const LoadContext, item: ChunkData) anyerror!ChunkData {
+                defer c.allocator.free(item.data);
+                const bytes = decompressBlock(c.allocator, item.data, c.dictionary) catch |err| {
+                    misc.error_context.append("Failed to decompress chunk block.", .{});
+                    return err;
+                };
+                return .{ .chunk = item.chunk, .data = bytes };
+            }
+        }.call,
+        .consume = struct {
+            fn call(c: *const LoadContext, item: ChunkData) anyerror!void {
+                defer c.allocator.free(item.data);
+                decodeChunkBytes(
+                    Frame,
+                    c.allocator,
+                    item.data,
+                    &item.chunk,
+                    c.codec,
+                    c.remote_fields,
+                    c.layouts,
+                    getLocalFields(Frame, config),
+                    c.frames,
+                ) catch |err| {
+                    misc.error_context.append("Failed to decode chunk.", .{});
+                    return err;
+                };
+                try onChunk(c.context, c.frames);
+            }
+        }.call,
+        .freeItem = ChunkData.free(*const LoadContext),
+        .freeResult = ChunkData.free(*const LoadContext),
+    }) catch |err| {
+        misc.error_context.append("Failed to read chunks.", .{});
+        return err;
+    };
+    stats.log("loading recording", .{ "read", "decompress", "decode" });
+}
+
+// Describes a range of frames inside a recording file. Range end is exclusive. Null end means the end of the file.
+pub const RecordingSlice = struct {
+    file_path: []const u8,
+    start: usize = 0,
+    end: ?usize = null,
+};
+
+// Writes the slices one after another into a new recording file. Chunks that are completely inside a slice are
+// copied byte for byte without being decompressed. Only the chunks on slice boundaries get decoded and re-encoded.
+// Chunks kept inside a chunk store get referenced again when the destination library's store already contains them.
+// Source files have to be saved with the same codec and the same fields that this version uses.
+// Destination file is allowed to be one of the sources since it only gets replaced once all the sources are read.
+pub fn spliceRecordings(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    sources: []const RecordingSlice,
+    file_path: []const u8,
+    comptime config: *const RecordingConfig,
+) !void {
+    const fields = getLocalFields(Frame, config);
+    const field_list = serializeFieldList(allocator, fields, config.codec, version_number) catch |err| {
+        misc.error_context.append("Failed to serialize field list.", .{});
+        return err;
+    };
+    defer allocator.free(field_list);
+    var maybe_stored = StoredChunks.open(allocator, file_path, field_list) catch |err| {
+        misc.error_context.append("Failed to open the chunk store for: {s}", .{file_path});
+        return err;
+    };
+    defer if (maybe_stored) |*stored| stored.deinit();
+    const stored: ?*StoredChunks = if (maybe_stored) |*stored| stored else null;
+
+    var temp_path_buffer: [std.fs.max_path_bytes]u8 = undefined;
+    const temp_path = std.fmt.bufPrint(&temp_path_buffer, "{s}.tmp", .{file_path}) catch |err| {
+        misc.error_context.new("Failed to construct temporary file path for: {s}", .{file_path});
+        return err;
+    };
+    const file = std.fs.cwd().createFile(temp_path, .{}) catch |err| {
+        misc.error_context.new("Failed to create or open file: {s}", .{temp_path});
+        return err;
+    };
+    writeSplicedRecording(Frame, allocator, sources, file, field_list, stored, config) catch |err| {
+        file.close();
+        std.fs.cwd().deleteFile(temp_path) catch {};
+        misc.error_context.append("Failed to write spliced recording into: {s}", .{temp_path});
+        return err;
+    };
+    file.close();
+    std.fs.cwd().rename(temp_path, file_path) catch |err| {
+        std.fs.cwd().deleteFile(temp_path) catch {};
+        misc.error_context.new("Failed to rename file {s} to: {s}", .{ temp_path, file_path });
+        return err;
+    };
+    if (stored) |s| {
+        s.commit() catch |err| {
+            misc.error_context.append("Failed to commit chunk references of: {s}", .{file_path});
+            return err;
+        };
+    }
+}
+
+pub fn trimRecording(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    source_path: []const u8,
+    file_path: []const u8,
+    start: usize,
+    end: usize,
+    comptime config: *const RecordingConfig,
+) !void {
+    const sources = [_]RecordingSlice{.{ .file_path = source_path, .start = start, .end = end }};
+    return spliceRecordings(Frame, allocator, &sources, file_path, config);
+}
+
+pub fn deleteRecordingRange(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    source_path: []const u8,
+    file_path: []const u8,
+    start: usize,
+    end: usize,
+    comptime config: *const RecordingConfig,
+) !void {
+    if (start > end) {
+        misc.error_context.new("Range start {} is larger then range end {}.", .{ start, end });
+        return error.InvalidRange;
+    }
+    const sources = [_]RecordingSlice{
+        .{ .file_path = source_path, .end = start },
+        .{ .file_path = source_path, .start = end },
+    };
+    return spliceRecordings(Frame, allocator, &sources, file_path, config);
+}
+
+pub fn concatenateRecordings(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    source_paths: []const []const u8,
+    file_path: []const u8,
+    comptime config: *const RecordingConfig,
+) !void {
+    const sources = allocator.alloc(RecordingSlice, source_paths.len) catch |err| {
+        misc.error_context.new("Failed to allocate {} recording slices.", .{source_paths.len});
+        return err;
+    };
+    defer allocator.free(sources);
+    for (sources, source_paths) |*source, source_path| {
+        source.* = .{ .file_path = source_path };
+    }
+    return spliceRecordings(Frame, allocator, sources, file_path, config);
+}
+
+// Reads only the uncompressed start of the file, which makes it cheap enough to call on thousands of files.
+pub fn loadRecordingInfo(file_path: []const u8) !RecordingInfo {
+    const file = std.fs.cwd().openFile(file_path, .{}) catch |err| {
+        misc.error_context.new("Failed to open file: {s}", .{file_path});
+        return err;
+    };
+    defer file.close();
+
+    var file_buffer: [buffer_size]u8 = undefined;
+    var file_reader = file.reader(&file_buffer);
+    const file_start = readFileStart(&file_reader.interface) catch |err| {
+        misc.error_context.append("Failed to read file start.", .{});
+        return err;
+    };
+    return .{
+        .version = file_start.version,
+        .codec = file_start.header.codec,
+        .content_hash = file_start.header.content_hash,
+        .game = file_start.header.game,
+        .metadata = file_start.header.metadata,
+        .profile = file_start.header.profile,
+        .dictionary_id = file_start.header.dictionary_id,
+    };
+}
+
+// Hashes of all the chunks that the recording keeps inside the chunk store, in the order they appear in the file.
+// Reads only the chunk headers, without touching the chunk store.
+pub fn loadRecordingChunkReferences(allocator: std.mem.Allocator, file_path: []const u8) ![]io.ChunkHash {
+    const file = std.fs.cwd().openFile(file_path, .{}) catch |err| {
+        misc.error_context.new("Failed to open file: {s}", .{file_path});
+        return err;
+    };
+    defer file.close();
+    var file_buffer: [buffer_size]u8 = undefined;
+    var file_reader = file.reader(&file_buffer);
+    const reader = &file_reader.interface;
+
+    var references: std.ArrayList(io.ChunkHash) = .empty;
+    errdefer references.deinit(allocator);
+    const file_start = readFileStart(reader) catch |err| {
+        misc.error_context.append("Failed to read file start.", .{});
+        return err;
+    };
+    if (file_start.version >= first_version_with_chunks) {
+        const field_list_block_size = reader.takeInt(BlockSize, endian) catch |err| {
+            misc.error_context.new("Failed to read field list block size.", .{});
+            return err;
+        };
+        reader.discardAll(field_list_block_size) catch |err| {
+            misc.error_context.new("Failed to skip field list block of size: {}", .{field_list_block_size});
+            return err;
+        };
+        var chunk_index: usize = 0;
+        while (true) : (chunk_index += 1) {
+            errdefer misc.error_context.append("Failed to read chunk: {}", .{chunk_index});
+            const maybe_chunk = readChunkHeader(reader) catch |err| {
+                misc.error_context.append("Failed to read chunk header.", .{});
+                return err;
+            };
+            const chunk = maybe_chunk orelse break;
+            if (chunk.block_size == referenced_block_size) {
+                const hash = reader.takeArray(@sizeOf(io.ChunkHash)) catch |err| {
+                    misc.error_context.new("Failed to read chunk hash.", .{});
+                    return err;
+                };
+                references.append(allocator, hash.*) catch |err| {
+                    misc.error_context.new("Failed to append chunk reference.", .{});
+                    return err;
+                };
+            } else {
+                skipChunkBlock(reader, &chunk) catch |err| {
+                    misc.error_context.append("Failed to skip chunk block.", .{});
+                    return err;
+                };
+            }
+        }
+    }
+    return references.toOwnedSlice(allocator) catch |err| {
+        misc.error_context.new("Failed to convert chunk references to owned slice.", .{});
+        return err;
+    };
+}
+
+// Builds a preset dictionary for RecordingConfig.dictionaries out of the given recordings. Every recording contributes
+// a equal share of the size, split evenly between the starts of the encoded bytes of all it's chunks, since the start
+// of a chunk is where a empty dictionary hurts the most. Field list of this version goes last, because content closer
+// to the end of the dictionary is the cheapest to reference and every recording starts with the field list.
+pub fn trainRecordingDictionary(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    file_paths: []const []const u8,
+    max_size: usize,
+    comptime config: *const RecordingConfig,
+) ![]u8 {
+    const fields = getLocalFields(Frame, config);
+    const field_list = serializeFieldList(allocator, fields, config.codec, version_number) catch |err| {
+        misc.error_context.append("Failed to serialize field list.", .{});
+        return err;
+    };
+    defer allocator.free(field_list);
+    const size = @min(max_size, RecordingDictionary.max_size);
+    if (field_list.len > size) {
+        misc.error_context.new(
+            "Field list of size {} does not fit into dictionary of size {}.",
+            .{ field_list.len, size },
+        );
+        return error.DictionaryTooSmall;
+    }
+    const sample_size = if (file_paths.len != 0) (size - field_list.len) / file_paths.len else 0;
+
+    var dictionary: std.ArrayList(u8) = .empty;
+    errdefer dictionary.deinit(allocator);
+    for (file_paths) |file_path| {
+        const frames = loadRecording(Frame, allocator, file_path, config) catch |err| {
+            misc.error_context.append("Failed to load recording: {s}", .{file_path});
+            return err;
+        };
+        defer allocator.free(frames);
+        const number_of_chunks = std.math.divCeil(usize, frames.len, config.frames_per_chunk) catch unreachable;
+        const chunk_sample_size = if (number_of_chunks != 0) sample_size / number_of_chunks else 0;
+        if (chunk_sample_size == 0) {
+            continue;
+        }
+        var chunk_start: usize = 0;
+        while (chunk_start < frames.len) : (chunk_start += config.frames_per_chunk) {
+            const chunk_frames = frames[chunk_start..@min(chunk_start + config.frames_per_chunk, frames.len)];
+            var bytes_writer = std.io.Writer.Allocating.init(allocator);
+            defer bytes_writer.deinit();
+            writeStreamFrames(Frame, allocator, &bytes_writer.writer, chunk_frames, fields, config.codec) catch |err| {
+                misc.error_context.append("Failed to encode frames of: {s}", .{file_path});
+                return err;
+            };
+            const bytes = bytes_writer.written();
+            dictionary.appendSlice(allocator, bytes[0..@min(bytes.len, chunk_sample_size)]) catch |err| {
+                misc.error_context.new("Failed to append {} dictionary bytes.", .{@min(bytes.len, chunk_sample_size)});
+                return err;
+            };
+        }
+    }
+    dictionary.appendSlice(allocator, field_list) catch |err| {
+        misc.error_context.new("Failed to append field list to the dictionary.", .{});
+        return err;
+    };
+    return dictionary.toOwnedSlice(allocator) catch |err| {
+        misc.error_context.new("Failed to convert dictionary to owned slice.", .{});
+        return err;
+    };
+}
+
+fn writeSplicedRecording(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    sources: []const RecordingSlice,
+    file: std.fs.File,
+    field_list: []const u8,
+    stored: ?*StoredChunks,
+    comptime config: *const RecordingConfig,
+) !void {
+    const metadata = getSplicedMetadata(sources) catch |err| {
+        misc.error_context.append("Failed to read metadata of the spliced recordings.", .{});
+        return err;
+    };
+
+    const header = Header{
+        .codec = config.codec,
+        .game = build_info.game,
+        .metadata = metadata,
+        .profile = getProfileName(config),
+        .dictionary_id = getWriterDictionaryId(config),
+    };
+    const Context = struct {
+        allocator: std.mem.Allocator,
+        sources: []const RecordingSlice,
+        field_list: []const u8,
+        stored: ?*StoredChunks,
+    };
+    const context = Context{
+        .allocator = allocator,
+        .sources = sources,
+        .field_list = field_list,
+        .stored = stored,
+    };
+    return writeRecordingFile(file, &header, &context, struct {
+        fn call(c: *const Context, writer: *std.io.Writer) anyerror!void {
+            writeFieldListBlock(c.allocator, writer, c.field_list, getWriterDictionary(config)) catch |err| {
+                misc.error_context.append("Failed to write field list.", .{});
+                return err;
+            };
+            for (c.sources) |*source| {
+                spliceSource(Frame, c.allocator, writer, source, c.field_list, c.stored, config) catch |err| {
+                    misc.error_context.append("Failed to splice recording: {s}", .{source.file_path});
+                    return err;
+                };
+            }
+            writeChunkEnd(writer) catch |err| {
+                misc.error_context.append("Failed to write chunk end marker.", .{});
+                return err;
+            };
+        }
+    }.call);
+}
+
+// Metadata of the spliced recording gets assembled from the metadata of the sources, without decoding any frames.
+// Labels can not be narrowed down to a range of frames, so all labels of a source are kept.
+fn getSplicedMetadata(sources: []const RecordingSlice) !?RecordingMetadata {
+    var metadata = RecordingMetadata{};
+    for (sources) |*source| {
+        const info = loadRecordingInfo(source.file_path) catch |err| {
+            misc.error_context.append("Failed to load recording info: {s}", .{source.file_path});
+            return err;
+        };
+        const source_metadata = info.metadata orelse return null;
+        const source_frames = source_metadata.number_of_frames;
+        const end = @min(source.end orelse source_frames, source_frames);
+        const start = @min(source.start, end);
+        for (source_metadata.getMarkers()) |marker| {
+            if (marker < start or marker >= end) {
+                continue;
+            }
+            metadata.addMarker(std.math.cast(u32, metadata.number_of_frames + marker - start) orelse continue);
+        }
+        for (source_metadata.getLabels()) |label| {
+            metadata.addLabel(label);
+        }
+        metadata.number_of_frames += end - start;
+    }
+    return metadata;
+}
+
+fn spliceSource(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    writer: *std.io.Writer,
+    source: *const RecordingSlice,
+    field_list: []const u8,
+    stored: ?*StoredChunks,
+    comptime config: *const RecordingConfig,
+) !void {
+    const range_end = source.end orelse std.math.maxInt(usize);
+    if (source.start > range_end) {
+        misc.error_context.new("Range start {} is larger then range end {}.", .{ source.start, range_end });
+        return error.InvalidRange;
+    }
+
+    const file = std.fs.cwd().openFile(source.file_path, .{}) catch |err| {
+        misc.error_context.new("Failed to open file: {s}", .{source.file_path});
+        return err;
+    };
+    defer file.close();
+    var file_buffer: [buffer_size]u8 = undefined;
+    var file_reader = file.reader(&file_buffer);
+    const reader = &file_reader.interface;
+
+    const file_start = readFileStart(reader) catch |err| {
+        misc.error_context.append("Failed to read file start.", .{});
+        return err;
+    };
+    if (file_start.version < first_version_with_chunks) {
+        misc.error_context.new(
+            "Recording version {} is not split into chunks. Save the recording again to be able to edit it.",
+            .{file_start.version},
+        );
+        return error.UnsupportedVersion;
+    }
+    if (file_start.header.codec != config.codec) {
+        misc.error_context.new(
+            "Recording codec {s} does not match the expected codec {s}.",
+            .{ @tagName(file_start.header.codec), @tagName(config.codec) },
+        );
+        return error.CodecMismatch;
+    }
+    // Blocks get copied as they are, so blocks compressed with a dictionary need the destination to be written with the
+    // same dictionary. Blocks compressed without a dictionary stay readable no matter the dictionary.
+    if (file_start.header.dictionary_id) |dictionary_id| {
+        const writer_dictionary_id = getWriterDictionaryId(config);
+        if (writer_dictionary_id == null or writer_dictionary_id.? != dictionary_id) {
+            misc.error_context.new("Recording dictionary {X} is not the dictionary of this version.", .{dictionary_id});
+            return error.DictionaryMismatch;
+        }
+    }
+    const dictionary = if (file_start.header.dictionary_id != null) getWriterDictionary(config) else null;
+    const remote_field_list = readFieldListBlock(allocator, reader, dictionary) catch |err| {
+        misc.error_context.append("Failed to read field list.", .{});
+        return err;
+    };
+    defer allocator.free(remote_field_list);
+    const fields = getLocalFields(Frame, config);
+    // Recordings saved before precisions existed store the same chunks, only their field list lacks precisions.
+    var legacy_field_list: ?[]u8 = null;
+    defer if (legacy_field_list) |list| allocator.free(list);
+    if (file_start.version < first_version_with_precisions and comptime !hasQuantizedFields(fields)) {
+        legacy_field_list = serializeFieldList(allocator, fields, config.codec, file_start.version) catch |err| {
+            misc.error_context.append("Failed to serialize field list of version: {}", .{file_start.version});
+            return err;
+        };
+    }
+    if (!std.mem.eql(u8, remote_field_list, legacy_field_list orelse field_list)) {
+        misc.error_context.new("Recording fields do not match the fields of this version.", .{});
+        return error.FieldListMismatch;
+    }
+
+    // Matching field lists mean that remote fields map one to one to local fields.
+    var field_list_reader = std.io.Reader.fixed(field_list);
+    var byte_reader = io.ByteReader{ .src_reader = &field_list_reader, .endian = endian };
+    var remote_fields_buffer: [max_number_of_fields]RemoteField = undefined;
+    var layouts: std.ArrayList(LayoutRun) = .empty;
+    defer layouts.deinit(allocator);
+    const remote_fields = readFieldList(
+        allocator,
+        &byte_reader,
+        &remote_fields_buffer,
+        &layouts,
+        config.codec,
+        version_number,
+        fields,
+    ) catch |err| {
+        misc.error_context.append("Failed to read fields list.", .{});
+        return err;
+    };
+
+    var maybe_source_store = io.ChunkStore.openForRecording(source.file_path) catch |err| {
+        misc.error_context.append("Failed to open the chunk store for: {s}", .{source.file_path});
+        return err;
+    };
+    defer if (maybe_source_store) |*store| store.close();
+    const source_store: ?*const io.ChunkStore = if (maybe_source_store) |*store| store else null;
+
+    var boundary_frames: std.ArrayList(Frame) = .empty;
+    defer boundary_frames.deinit(allocator);
+    var chunk_start: usize = 0;
+    var chunk_index: usize = 0;
+    while (chunk_start < range_end) : (chunk_index += 1) {
+        errdefer misc.error_context.append("Failed to splice chunk: {}", .{chunk_index});
+        const maybe_chunk = readChunkHeader(reader) catch |err| {
+            misc.error_context.append("Failed to read chunk header.", .{});
+            return err;
+        };
+        const chunk = maybe_chunk orelse break;
+        const chunk_end = chunk_start + chunk.number_of_frames;
+        const is_inside_range = source.start <= chunk_start and chunk_end <= range_end;
+        if (chunk_end <= source.start) {
+            skipChunkBlock(reader, &chunk) catch |err| {
+                misc.error_context.append("Failed to skip chunk block.", .{});
+                return err;
+            };
+        } else if (is_inside_range and chunk.block_size == referenced_block_size) {
+            copyReferencedChunk(allocator, reader, writer, &chunk, source_store, stored) catch |err| {
+                misc.error_context.append("Failed to copy referenced chunk.", .{});
+                return err;
+            };
+        } else if (is_inside_range) {
+            writeChunkHeader(writer, &chunk) catch |err| {
+                misc.error_context.append("Failed to write chunk header.", .{});
+                return err;
+            };
+            reader.streamExact(writer, chunk.block_size) catch |err| {
+                misc.error_context.new("Failed to copy chunk block of size: {}", .{chunk.block_size});
+                return err;
+            };
+        } else {
+            const block = readChunkBlock(allocator, reader, &chunk, source_store) catch |err| {
+                misc.error_context.append("Failed to read chunk block.", .{});
+                return err;
+            };
+            defer allocator.free(block);
+            boundary_frames.clearRetainingCapacity();
+            decodeChunk(
+                Frame,
+                allocator,
+                block,
+                &chunk,
+                config.codec,
+                dictionary,
+                remote_fields,
+                layouts.items,
+                fields,
+                &boundary_frames,
+            ) catch |err| {
+                misc.error_context.append("Failed to decode chunk.", .{});
+                return err;
+            };
+            const slice_start = @max(source.start, chunk_start) - chunk_start;
+            const slice_end = @min(range_end, chunk_end) - chunk_start;
+            const sliced_frames = boundary_frames.items[slice_start..slice_end];
+            writeChunks(Frame, allocator, writer, sliced_frames, stored, fields, config) catch |err| {
+                misc.error_context.append("Failed to re-encode chunk frames: [{}, {})", .{ slice_start, slice_end });
+                return err;
+            };
+        }
+        chunk_start = chunk_end;
+    }
+    if (source.start > chunk_start or (source.end != null and range_end > chunk_start)) {
+        misc.error_context.new(
+            "Range [{}, {}) is out of bounds. Recording contains {} frames.",
+            .{ source.start, range_end, chunk_start },
+        );
+        return error.OutOfBounds;
+    }
+}
+
+// Writes the file start, lets writeBody write the rest of the file and then patches in the hash of the written body.
+fn writeRecordingFile(
+    file: std.fs.File,
+    header: *const Header,
+    context: anytype,
+    comptime writeBody: fn (@TypeOf(context), *std.io.Writer) anyerror!void,
+) !void {
+    var file_buffer: [buffer_size]u8 = undefined;
+    var file_writer = file.writer(&file_buffer);
+    const writer = &file_writer.interface;
+
+    var placeholder_header = header.*;
+    placeholder_header.content_hash = 0;
+    writeFileStart(writer, &placeholder_header) catch |err| {
+        misc.error_context.append("Failed to write file start.", .{});
+        return err;
+    };
+
+    var hashing_writer = io.HashingWriter.init(writer);
+    var body_buffer: [buffer_size]u8 = undefined;
+    var body_writer = hashing_writer.writer(&body_buffer);
+    try writeBody(context, &body_writer);
+    body_writer.flush() catch |err| {
+        misc.error_context.new("Failed to flush hashing writer.", .{});
+        return err;
+    };
+    file_writer.end() catch |err| {
+        misc.error_context.new("Failed to end file writing.", .{});
+        return err;
+    };
+
+    var hash_bytes: [@sizeOf(ContentHash)]u8 = undefined;
+    std.mem.writeInt(ContentHash, &hash_bytes, hashing_writer.final(), endian);
+    file.pwriteAll(&hash_bytes, content_hash_offset) catch |err| {
+        misc.error_context.new("Failed to write content hash.", .{});
+        return err;
+    };
+}
+
+// Chunk store of the library that a recording gets written into, together with the chunks that the recording
+// references. Store stays locked shared while open, so that no other save deletes the chunks that this save found
+// inside. Other saves can still compress and put their chunks at the same time.
+// Chunks that got put into the store by a save that failed stay without references until collectChunks removes them.
+const StoredChunks = struct {
+    allocator: std.mem.Allocator,
+    store: io.ChunkStore,
+    field_list: []const u8,
+    references: std.ArrayList(io.ChunkHash),
+    previous_references: []const io.ChunkHash,
+
+    const Self = @This();
+
+    // Returns null when there is no chunk store next to the file. References of the file that is getting replaced get
+    // read right away, so this has to be called before the file gets overwritten.
+    fn open(allocator: std.mem.Allocator, file_path: []const u8, field_list: []const u8) !?Self {
+        const maybe_store = io.ChunkStore.openForRecording(file_path) catch |err| {
+            misc.error_context.append("Failed to open the chunk store.", .{});
+            return err;
+        };
+        var store = maybe_store orelse return null;
+        errdefer store.close();
+        store.lock(.shared) catch |err| {
+            misc.error_context.append("Failed to lock the chunk store.", .{});
+            return err;
+        };
+        const maybe_previous_references = loadRecordingChunkReferences(allocator, file_path);
+        const previous_references: []const io.ChunkHash = maybe_previous_references catch |err| block: {
+            if (err != error.FileNotFound) {
+                misc.error_context.append("Failed to load chunk references of the replaced file: {s}", .{file_path});
+                misc.error_context.logWarning(err);
+            }
+            break :block &.{};
+        };
+        return .{
+            .allocator = allocator,
+            .store = store,
+            .field_list = field_list,
+            .references = .empty,
+            .previous_references = previous_references,
+        };
+    }
+
+    fn deinit(self: *Self) void {
+        self.allocator.free(self.previous_references);
+        self.references.deinit(self.allocator);
+        self.store.close();
+        self.* = undefined;
+    }
+
+    // Chunks already inside the store don't get compressed again. Stored chunks are shared between recordings, so they
+    // get compressed without a dictionary, which keeps them readable from recordings written with any dictionary.
+    fn storeChunk(self: *const Self, chunk: *const Chunk, bytes: []const u8) !ChunkData {
+        const hash = io.ChunkStore.hashChunk(self.field_list, bytes);
+        if (!self.store.contains(&hash)) {
+            const block = compressChunkBytes(self.allocator, bytes, null) catch |err| {
+                misc.error_context.append("Failed to compress chunk.", .{});
+                return err;
+            };
+            defer self.allocator.free(block);
+            self.store.put(&hash, block) catch |err| {
+                misc.error_context.append("Failed to put chunk into the chunk store.", .{});
+                return err;
+            };
+        }
+        const data = self.allocator.dupe(u8, &hash) catch |err| {
+            misc.error_context.new("Failed to allocate chunk hash.", .{});
+            return err;
+        };
+        return .{
+            .chunk = .{ .number_of_frames = chunk.number_of_frames, .block_size = referenced_block_size },
+            .data = data,
+        };
+    }
+
+    fn addReference(self: *Self, hash: []const u8) !void {
+        self.references.append(self.allocator, hash[0..@sizeOf(io.ChunkHash)].*) catch |err| {
+            misc.error_context.new("Failed to append chunk reference.", .{});
+            return err;
+        };
+    }
+
+    // Call once the file is completely written. New references get added before the old ones get released, so chunks
+    // shared by the old and the new version of the file never get deleted. Chunks that lost their last reference get
+    // deleted only when no other save is in progress. Otherwise they stay until collectChunks removes them.
+    fn commit(self: *Self) !void {
+        self.store.addReferences(self.allocator, self.references.items) catch |err| {
+            misc.error_context.append("Failed to add chunk references.", .{});
+            return err;
+        };
+        self.store.releaseReferences(self.allocator, self.previous_references) catch |err| {
+            misc.error_context.append("Failed to release chunk references of the replaced file.", .{});
+            return err;
+        };
+        self.store.unlock();
+        const is_locked = self.store.tryLock(.exclusive) catch |err| block: {
+            misc.error_context.append("Failed to lock the chunk store.", .{});
+            misc.error_context.logWarning(err);
+            break :block false;
+        };
+        if (is_locked) {
+            defer self.store.unlock();
+            self.store.deleteUnreferenced(self.allocator, self.previous_references) catch |err| {
+                misc.error_context.append("Failed to delete chunks of the replaced file.", .{});
+                misc.error_context.logWarning(err);
+            };
+        }
+        self.allocator.free(self.previous_references);
+        self.previous_references = &.{};
+        self.references.clearRetainingCapacity();
+    }
+};
+
+fn extractMetadata(
+    comptime Frame: type,
+    frames: []const Frame,
+    comptime config: *const RecordingConfig,
+) RecordingMetadata {
+    var metadata = RecordingMetadata{ .number_of_frames = frames.len };
+    const Extractor = config.MetadataExtractor orelse return metadata;
+    for (frames, 0..) |*frame, index| {
+        const previous = if (index > 0) &frames[index - 1] else null;
+        if (Extractor.isMarker(previous, frame)) {
+            if (std.math.cast(u32, index)) |marker| {
+                metadata.addMarker(marker);
+            }
+        }
+        for (Extractor.getLabels(frame)) |maybe_label| {
+            if (maybe_label) |label| {
+                metadata.addLabel(label);
+            }
+        }
+    }
+    return metadata;
+}
+
+const FileStart = struct {
+    version: VersionNumber,
+    header: Header,
+};
+
+fn writeFileStart(writer: *std.io.Writer, header: *const Header) !void {
+    writer.writeAll(magic_number) catch |err| {
+        misc.error_context.new("Failed to write magic number.", .{});
+        return err;
+    };
+    writer.writeInt(VersionNumber, version_number, endian) catch |err| {
+        misc.error_context.new("Failed to write version number.", .{});
+        return err;
+    };
+    writeHeader(writer, header) catch |err| {
+        misc.error_context.append("Failed to write header.", .{});
+        return err;
+    };
+}
+
+fn readFileStart(reader: *std.io.Reader) !FileStart {
+    var magic_buffer: [magic_number.len]u8 = undefined;
+    reader.readSliceAll(&magic_buffer) catch |err| {
+        misc.error_context.new("Failed to read magic number.", .{});
+        return err;
+    };
+    if (!std.mem.eql(u8, &magic_buffer, magic_number)) {
+        misc.error_context.new("Incorrect magic number.", .{});
+        return error.MagicNumber;
+    }
+
+    const version = reader.takeInt(VersionNumber, endian) catch |err| {
+        misc.error_context.new("Failed to read version number.", .{});
+        return err;
+    };
+    if (version > version_number) {
+        std.log.warn(
+            "File's version number {} is larger then expected {}. Expecting file parsing to fail but proceeding anyway.",
+            .{ version, version_number },
+        );
+    }
+
+    var header = Header{};
+    if (version >= first_version_with_header) {
+        header = readHeader(reader) catch |err| {
+            misc.error_context.append("Failed to read header.", .{});
+            return err;
+        };
+    }
+    return .{ .version = version, .header = header };
+}
+
+// Before chunks were introduced, the field list and all the frames were stored inside a single XZ stream.
+fn readStreamRecording(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    reader: *std.io.Reader,
+    codec: RecordingCodec,
+    version: VersionNumber,
+    comptime local_fields: []const LocalField,
+) ![]Frame {
+    var decoder = io.XzDecoder.init(allocator, reader) catch |err| {
+        misc.error_context.append("Failed to initialize XZ decoder.", .{});
+        return err;
+    };
+    defer decoder.deinit();
+    var decoder_buffer: [buffer_size]u8 = undefined;
+    var decoder_reader = decoder.reader(&decoder_buffer);
+    var byte_reader = io.ByteReader{ .src_reader = &decoder_reader, .endian = endian };
+
+    var remote_fields_buffer: [max_number_of_fields]RemoteField = undefined;
+    var layouts: std.ArrayList(LayoutRun) = .empty;
+    defer layouts.deinit(allocator);
+    const remote_fields = readFieldList(
+        allocator,
+        &byte_reader,
+        &remote_fields_buffer,
+        &layouts,
+        codec,
+        version,
+        local_fields,
+    ) catch |err| {
+        misc.error_context.append("Failed to read fields list.", .{});
+        return err;
+    };
+
+    var frames: std.ArrayList(Frame) = .empty;
+    errdefer frames.deinit(allocator);
+    readStreamFrames(
+        Frame,
+        allocator,
+        &decoder_reader,
+        codec,
+        remote_fields,
+        layouts.items,
+        local_fields,
+        &frames,
+    ) catch |err| {
+        misc.error_context.append("Failed to read frames.", .{});
+        return err;
+    };
+    return frames.toOwnedSlice(allocator) catch |err| {
+        misc.error_context.new("Failed to convert frames to owned slice.", .{});
+        return err;
+    };
+}
+
+fn serializeFieldList(
+    allocator: std.mem.Allocator,
+    comptime fields: []const LocalField,
+    comptime codec: RecordingCodec,
+    version: VersionNumber,
+) ![]u8 {
+    var field_list_writer = std.io.Writer.Allocating.init(allocator);
+    defer field_list_writer.deinit();
+    var byte_writer = io.ByteWriter{ .dest_writer = &field_list_writer.writer, .endian = endian };
+    try writeFieldList(&byte_writer, fields, codec, version);
+    return field_list_writer.toOwnedSlice() catch |err| {
+        misc.error_context.new("Failed to convert field list to owned slice.", .{});
+        return err;
+    };
+}
+
+fn writeFieldListBlock(
+    allocator: std.mem.Allocator,
+    writer: *std.io.Writer,
+    field_list: []const u8,
+    dictionary: ?[]const u8,
+) !void {
+    const block = compressBlock(allocator, dictionary, field_list, struct {
+        fn call(content: []const u8, block_writer: *std.io.Writer) anyerror!void {
+            block_writer.writeAll(content) catch |err| {
+                misc.error_context.new("Failed to write field list into the compressor.", .{});
+                return err;
+            };
+        }
+    }.call) catch |err| {
+        misc.error_context.append("Failed to compress field list.", .{});
+        return err;
+    };
+    defer allocator.free(block);
+    const block_size = std.math.cast(BlockSize, block.len) orelse {
+        misc.error_context.new("Field list block size {} exceeds the maximum size.", .{block.len});
+        return error.BlockTooLarge;
+    };
+    writer.writeInt(BlockSize, block_size, endian) catch |err| {
+        misc.error_context.new("Failed to write field list block size: {}", .{block_size});
+        return err;
+    };
+    writer.writeAll(block) catch |err| {
+        misc.error_context.new("Failed to write field list block.", .{});
+        return err;
+    };
+}
+
+fn readFieldListBlock(allocator: std.mem.Allocator, reader: *std.io.Reader, dictionary: ?[]const u8) ![]u8 {
+    const block_size = reader.takeInt(BlockSize, endian) catch |err| {
+        misc.error_context.new("Failed to read field list block size.", .{});
+        return err;
+    };
+    const block = readBlock(allocator, reader, block_size) catch |err| {
+        misc.error_context.append("Failed to read field list block.", .{});
+        return err;
+    };
+    defer allocator.free(block);
+    return decompressBlock(allocator, block, dictionary) catch |err| {
+        misc.error_context.append("Failed to decompress field list block.", .{});
+        return err;
+    };
+}
+
+fn writeChunks(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    writer: *std.io.Writer,
+    frames: []const Frame,
+    stored: ?*StoredChunks,
+    comptime fields: []const LocalField,
+    comptime config: *const RecordingConfig,
+) !void {
+    if (config.frames_per_chunk == 0 or config.frames_per_chunk > std.math.maxInt(ChunkLength)) {
+        @compileError(std.fmt.comptimePrint("Invalid number of frames per chunk: {}", .{config.frames_per_chunk}));
+    }
+    // Chunks get compressed by thread pool jobs while the next chunks get encoded and the previous ones written.
+    const SaveContext = struct {
+        allocator: std.mem.Allocator,
+        writer: *std.io.Writer,
+        frames: []const Frame,
+        stored: ?*StoredChunks,
+    };
+    const SavePipeline = io.Pipeline(*const SaveContext, ChunkData, ChunkData);
+    const save_context = SaveContext{ .allocator = allocator, .writer = writer, .frames = frames, .stored = stored };
+    const stats = SavePipeline.run(allocator, &save_context, .{
+        .produce = struct {
+            fn call(c: *const SaveContext, emitter: *SavePipeline.Emitter) anyerror!void {
+                var chunker = ContentDefinedChunker(Frame, fields, config.frames_per_chunk){};
+                var chunk_start: usize = 0;
+                while (chunk_start < c.frames.len) {
+                    const chunk_end = if (c.stored != null)
+                        chunker.findChunkEnd(c.frames, chunk_start)
+                    else
+                        @min(chunk_start + config.frames_per_chunk, c.frames.len);
+                    errdefer misc.error_context.append(
+                        "Failed to write chunk of frames: [{}, {})",
+                        .{ chunk_start, chunk_end },
+                    );
+                    const chunk_frames = c.frames[chunk_start..chunk_end];
+                    var bytes_writer = std.io.Writer.Allocating.init(c.allocator);
+                    defer bytes_writer.deinit();
+                    writeStreamFrames(
+                        Frame,
+                        c.allocator,
+                        &bytes_writer.writer,
+                        chunk_frames,
+                        fields,
+                        config.codec,
+                    ) catch |err| {
+                        misc.error_context.append("Failed to encode chunk.", .{});
+                        return err;
+                    };
+                    const bytes = bytes_writer.toOwnedSlice() catch |err| {
+                        misc.error_context.new("Failed to convert encoded chunk to owned slice.", .{});
+                        return err;
+                    };
+                    const chunk = Chunk{ .number_of_frames = @intCast(chunk_frames.len), .block_size = 0 };
+                    try emitter.emit(.{ .chunk = chunk, .data = bytes });
+                    chunk_start = chunk_end;
+                }
+            }
+        }.call,
+        .transform = struct {
+            fn call(c: *const SaveContext, item: ChunkData) anyerror!ChunkData {
+                defer c.allocator.free(item.data);
+                if (c.stored) |stored| {
+                    return stored.storeChunk(&item.chunk, item.data) catch |err| {
+                        misc.error_context.append("Failed to store chunk.", .{});
+                        return err;
+                    };
+                }
+                const block = compressChunkBytes(c.allocator, item.data, getWriterDictionary(config)) catch |err| {
+                    misc.error_context.append("Failed to compress chunk.", .{});
+                    return err;
+                };
+                var chunk = item.chunk;
+                chunk.block_size = @intCast(block.len);
+                return .{ .chunk = chunk, .data = block };
+            }
+        }.call,
+        .consume = struct {
+            fn call(c: *const SaveContext, item: ChunkData) anyerror!void {
+                defer c.allocator.free(item.data);
+                writeChunkHeader(c.writer, &item.chunk) catch |err| {
+                    misc.error_context.append("Failed to write chunk header.", .{});
+                    return err;
+                };
+                c.writer.writeAll(item.data) catch |err| {
+                    misc.error_context.new("Failed to write chunk block.", .{});
+                    return err;
+                };
+                if (c.stored) |stored| {
+                    stored.addReference(item.data) catch |err| {
+                        misc.error_context.append("Failed to add chunk reference.", .{});
+                        return err;
+                    };
+                }
+            }
+        }.call,
+        .freeItem = ChunkData.free(*const SaveContext),
+        .freeResult = ChunkData.free(*const SaveContext),
+    }) catch |err| {
+        misc.error_context.append("Failed to write chunks.", .{});
+        return err;
+    };
+    stats.log("saving recording", .{ "encode", "compress", "write" });
+}
+
+// Places chunk boundaries where the rolling hash of the last few frames matches a mask, instead of every fixed number of
+// frames. Frames inserted or removed in the middle of a recording then only move the boundaries near the edit, so the
+// rest of the chunks stay identical to the chunks of the original recording and the chunk store keeps them only once.
+// Masked bits of the rolling hash depend only on as many last frames as there are bits in the mask.
+fn ContentDefinedChunker(
+    comptime Frame: type,
+    comptime fields: []const LocalField,
+    comptime frames_per_chunk: usize,
+) type {
+    return struct {
+        rolling_hash: u64 = 0,
+
+        const Self = @This();
+        const min_length = @max(frames_per_chunk / 4, 1);
+        const max_length = @min(4 * frames_per_chunk, std.math.maxInt(ChunkLength));
+        // Makes the average chunk length roughly equal to frames per chunk.
+        const mask = std.math.floorPowerOfTwo(usize, @max(frames_per_chunk - min_length, 1)) - 1;
+
+        // Has to be called on consecutive chunks, since the rolling hash carries over from one chunk into the next.
+        fn findChunkEnd(self: *Self, frames: []const Frame, chunk_start: usize) usize {
+            const max_end = @min(chunk_start + max_length, frames.len);
+            var index = chunk_start;
+            while (index < max_end) {
+                self.rolling_hash = (self.rolling_hash << 1) +% hashFrame(Frame, &frames[index], fields);
+                index += 1;
+                if (index - chunk_start >= min_length and self.rolling_hash & mask == 0) {
+                    return index;
+                }
+            }
+            return max_end;
+        }
+    };
+}
+
+fn hashFrame(comptime Frame: type, frame: *const Frame, comptime fields: []const LocalField) u64 {
+    var hasher = std.hash.Wyhash.init(0);
+    inline for (fields) |*field| {
+        // Root fields contain the values of all the other fields.
+        if (field.parent_index == null) {
+            var buffer: [serializedSizeOf(field.Type)]u8 = undefined;
+            var buffer_writer = std.io.Writer.fixed(&buffer);
+            var byte_writer = io.ByteWriter{ .dest_writer = &buffer_writer, .endian = endian };
+            const field_pointer = getConstFieldPointer(frame, field) catch unreachable;
+            writeValue(&byte_writer, field_pointer) catch unreachable;
+            hasher.update(&buffer);
+        }
+    }
+    return hasher.final();
+}
+
+fn writeChunkHeader(writer: *std.io.Writer, chunk: *const Chunk) !void {
+    writer.writeInt(ChunkLength, chunk.number_of_frames, endian) catch |err| {
+        misc.error_context.new("Failed to write number of frames in chunk: {}", .{chunk.number_of_frames});
+        return err;
+    };
+    writer.writeInt(BlockSize, chunk.block_size, endian) catch |err| {
+        misc.error_context.new("Failed to write chunk block size: {}", .{chunk.block_size});
+        return err;
+    };
+}
+
+fn writeChunkEnd(writer: *std.io.Writer) !void {
+    writer.writeInt(ChunkLength, 0, endian) catch |err| {
+        misc.error_context.new("Failed to write chunk end marker.", .{});
+        return err;
+    };
+}
+
+// Returns null when reaching the chunk end marker.
+fn readChunkHeader(reader: *std.io.Reader) !?Chunk {
+    const number_of_frames = reader.takeInt(ChunkLength, endian) catch |err| {
+        misc.error_context.new("Failed to read number of frames in chunk.", .{});
+        return err;
+    };
+    if (number_of_frames == 0) {
+        return null;
+    }
+    const block_size = reader.takeInt(BlockSize, endian) catch |err| {
+        misc.error_context.new("Failed to read chunk block size.", .{});
+        return err;
+    };
+    return .{ .number_of_frames = number_of_frames, .block_size = block_size };
+}
+
+// Reads the block of the chunk, taking it out of the chunk store when the chunk only references it.
+fn readChunkBlock(
+    allocator: std.mem.Allocator,
+    reader: *std.io.Reader,
+    chunk: *const Chunk,
+    store: ?*const io.ChunkStore,
+) ![]u8 {
+    if (chunk.block_size != referenced_block_size) {
+        return readBlock(allocator, reader, chunk.block_size);
+    }
+    const hash = reader.takeArray(@sizeOf(io.ChunkHash)) catch |err| {
+        misc.error_context.new("Failed to read chunk hash.", .{});
+        return err;
+    };
+    const chunk_store = store orelse {
+        misc.error_context.new("Chunk is inside a chunk store but there is no chunk store next to the recording.", .{});
+        return error.MissingChunkStore;
+    };
+    return chunk_store.get(allocator, hash) catch |err| {
+        misc.error_context.append("Failed to get chunk out of the chunk store.", .{});
+        return err;
+    };
+}
+
+fn skipChunkBlock(reader: *std.io.Reader, chunk: *const Chunk) !void {
+    const size = if (chunk.block_size == referenced_block_size) @sizeOf(io.ChunkHash) else chunk.block_size;
+    reader.discardAll(size) catch |err| {
+        misc.error_context.new("Failed to skip chunk block of size: {}", .{size});
+        return err;
+    };
+}
+
+// Chunks that the destination store already contains only get referenced again. Other chunks get taken out of the
+// source store and either put into the destination store or written directly into the file.
+fn copyReferencedChunk(
+    allocator: std.mem.Allocator,
+    reader: *std.io.Reader,
+    writer: *std.io.Writer,
+    chunk: *const Chunk,
+    source_store: ?*const io.ChunkStore,
+    stored: ?*StoredChunks,
+) !void {
+    const hash = (reader.takeArray(@sizeOf(io.ChunkHash)) catch |err| {
+        misc.error_context.new("Failed to read chunk hash.", .{});
+        return err;
+    }).*;
+    const is_in_destination = if (stored) |s| s.store.contains(&hash) else false;
+    if (!is_in_destination) {
+        const store = source_store orelse {
+            misc.error_context.new("Chunk is inside a chunk store but there is no chunk store next to the file.", .{});
+            return error.MissingChunkStore;
+        };
+        const block = store.get(allocator, &hash) catch |err| {
+            misc.error_context.append("Failed to get chunk out of the chunk store.", .{});
+            return err;
+        };
+        defer allocator.free(block);
+        if (stored) |s| {
+            s.store.put(&hash, block) catch |err| {
+                misc.error_context.append("Failed to put chunk into the chunk store.", .{});
+                return err;
+            };
+        } else {
+            const inline_chunk = Chunk{ .number_of_frames = chunk.number_of_frames, .block_size = @intCast(block.len) };
+            writeChunkHeader(writer, &inline_chunk) catch |err| {
+                misc.error_context.append("Failed to write chunk header.", .{});
+                return err;
+            };
+            writer.writeAll(block) catch |err| {
+                misc.error_context.new("Failed to write chunk block.", .{});
+                return err;
+            };
+            return;
+        }
+    }
+    writeChunkHeader(writer, chunk) catch |err| {
+        misc.error_context.append("Failed to write chunk header.", .{});
+        return err;
+    };
+    writer.writeAll(&hash) catch |err| {
+        misc.error_context.new("Failed to write chunk hash.", .{});
+        return err;
+    };
+    stored.?.addReference(&hash) catch |err| {
+        misc.error_context.append("Failed to add chunk reference.", .{});
+        return err;
+    };
+}
 
-pub const RecordingConfig = struct {
-    atomic_types: []const type = &.{},
-    atomic_paths: []const []const u8 = &.{},
-};
+fn decodeChunk(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    block: []const u8,
+    chunk: *const Chunk,
+    codec: RecordingCodec,
+    dictionary: ?[]const u8,
+    remote_fields: []const RemoteField,
+    layouts: []const LayoutRun,
+    comptime local_fields: []const LocalField,
+    frames: *std.ArrayList(Frame),
+) !void {
+    const bytes = decompressBlock(allocator, block, dictionary) catch |err| {
+        misc.error_context.append("Failed to decompress chunk block.", .{});
+        return err;
+    };
+    defer allocator.free(bytes);
+    return decodeChunkBytes(Frame, allocator, bytes, chunk, codec, remote_fields, layouts, local_fields, frames);
+}
 
-pub fn saveRecording(
+fn decodeChunkBytes(
     comptime Frame: type,
     allocator: std.mem.Allocator,
-    frames: []const Frame,
-    file_path: []const u8,
-    comptime config: *const RecordingConfig,
+    bytes: []const u8,
+    chunk: *const Chunk,
+    codec: RecordingCodec,
+    remote_fields: []const RemoteField,
+    layouts: []const LayoutRun,
+    comptime local_fields: []const LocalField,
+    frames: *std.ArrayList(Frame),
 ) !void {
-    const file = std.fs.cwd().createFile(file_path, .{}) catch |err| {
-        misc.error_context.new("Failed to create or open file: {s}", .{file_path});
+    var bytes_reader = std.io.Reader.fixed(bytes);
+    const initial_len = frames.items.len;
+    readStreamFrames(
+        Frame,
+        allocator,
+        &bytes_reader,
+        codec,
+        remote_fields,
+        layouts,
+        local_fields,
+        frames,
+    ) catch |err| {
+        misc.error_context.append("Failed to read frames.", .{});
         return err;
     };
-    defer file.close();
+    const number_of_frames = frames.items.len - initial_len;
+    if (number_of_frames != chunk.number_of_frames) {
+        misc.error_context.new(
+            "Chunk contains {} frames while it's header says it contains {} frames.",
+            .{ number_of_frames, chunk.number_of_frames },
+        );
+        return error.InvalidChunk;
+    }
+}
 
-    var file_buffer: [buffer_size]u8 = undefined;
-    var file_writer = file.writer(&file_buffer);
+fn writeStreamFrames(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    writer: *std.io.Writer,
+    frames: []const Frame,
+    comptime fields: []const LocalField,
+    comptime codec: RecordingCodec,
+) !void {
+    switch (codec) {
+        .raw => {
+            var byte_writer = io.ByteWriter{ .dest_writer = writer, .endian = endian };
+            writeFrames(Frame, &byte_writer, frames, fields) catch |err| {
+                misc.error_context.append("Failed to write frames.", .{});
+                return err;
+            };
+            byte_writer.flush() catch |err| {
+                misc.error_context.append("Failed to flush byte writer.", .{});
+                return err;
+            };
+        },
+        .predictive => {
+            var bit_writer = io.BitWriter{ .dest_writer = writer };
+            writePredictiveFrames(Frame, allocator, &bit_writer, frames, fields) catch |err| {
+                misc.error_context.append("Failed to write predictive frames.", .{});
+                return err;
+            };
+            bit_writer.flush() catch |err| {
+                misc.error_context.append("Failed to flush bit writer.", .{});
+                return err;
+            };
+        },
+    }
+}
 
-    file_writer.interface.writeAll(magic_number) catch |err| {
-        misc.error_context.new("Failed to write magic number.", .{});
+fn readStreamFrames(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    reader: *std.io.Reader,
+    codec: RecordingCodec,
+    remote_fields: []const RemoteField,
+    layouts: []const LayoutRun,
+    comptime local_fields: []const LocalField,
+    frames: *std.ArrayList(Frame),
+) !void {
+    switch (codec) {
+        .raw => {
+            var byte_reader = io.ByteReader{ .src_reader = reader, .endian = endian };
+            readFrames(Frame, allocator, &byte_reader, remote_fields, local_fields, frames) catch |err| {
+                misc.error_context.append("Failed to read frames.", .{});
+                return err;
+            };
+        },
+        .predictive => {
+            var bit_reader = io.BitReader{ .src_reader = reader };
+            readPredictiveFrames(
+                Frame,
+                allocator,
+                &bit_reader,
+                remote_fields,
+                layouts,
+                local_fields,
+                frames,
+            ) catch |err| {
+                misc.error_context.append("Failed to read predictive frames.", .{});
+                return err;
+            };
+        },
+    }
+}
+
+// Every block is a separate XZ stream so that it can be copied into another file without being decompressed. Blocks
+// compressed with a dictionary are raw LZMA2 streams instead, which decompressBlock recognizes by the missing magic.
+// Raw streams have no integrity check of their own, so the CRC32 of the uncompressed content gets appended after them.
+fn compressBlock(
+    allocator: std.mem.Allocator,
+    dictionary: ?[]const u8,
+    context: anytype,
+    comptime writeContent: fn (@TypeOf(context), *std.io.Writer) anyerror!void,
+) ![]u8 {
+    var block_writer = std.io.Writer.Allocating.init(allocator);
+    defer block_writer.deinit();
+    const checksum = block: {
+        const maybe_encoder = if (dictionary) |bytes|
+            io.XzEncoder.initWithDictionary(allocator, &block_writer.writer, bytes)
+        else
+            io.XzEncoder.init(allocator, &block_writer.writer);
+        var encoder = maybe_encoder catch |err| {
+            misc.error_context.append("Failed to initialize XZ encoder.", .{});
+            return err;
+        };
+        defer encoder.deinit();
+        var encoded_buffer: [buffer_size]u8 = undefined;
+        var encoder_writer = encoder.writer(&encoded_buffer);
+        try writeContent(context, &encoder_writer);
+        encoder_writer.flush() catch |err| {
+            misc.error_context.new("Failed to flush XZ encoder.", .{});
+            return err;
+        };
+        break :block encoder.getChecksum();
+    };
+    if (dictionary != null) {
+        block_writer.writer.writeInt(BlockChecksum, checksum, endian) catch |err| {
+            misc.error_context.new("Failed to write block checksum.", .{});
+            return err;
+        };
+    }
+    return block_writer.toOwnedSlice() catch |err| {
+        misc.error_context.new("Failed to convert compressed block to owned slice.", .{});
         return err;
     };
+}
 
-    file_writer.interface.writeInt(VersionNumber, version_number, endian) catch |err| {
-        misc.error_context.new("Failed to write version number.", .{});
+// Compressed block of a chunk always fits into the chunk header and never collides with the referenced block size.
+fn compressChunkBytes(allocator: std.mem.Allocator, bytes: []const u8, dictionary: ?[]const u8) ![]u8 {
+    const block = compressBlock(allocator, dictionary, bytes, struct {
+        fn call(content: []const u8, block_writer: *std.io.Writer) anyerror!void {
+            return block_writer.writeAll(content);
+        }
+    }.call) catch |err| {
+        misc.error_context.append("Failed to compress block.", .{});
         return err;
     };
+    if (block.len >= referenced_block_size) {
+        allocator.free(block);
+        misc.error_context.new("Chunk block size {} exceeds the maximum size.", .{block.len});
+        return error.BlockTooLarge;
+    }
+    return block;
+}
 
-    var encoder = io.XzEncoder.init(allocator, &file_writer.interface) catch |err| {
-        misc.error_context.append("Failed to initialize XZ encoder.", .{});
+// Dictionary is only needed by blocks that were compressed with it. Blocks of the chunk store and blocks copied over
+// from recordings without a dictionary are regular XZ streams, which check their own integrity. Blocks compressed with
+// a dictionary get checked against the checksum that compressBlock appended after them.
+fn decompressBlock(allocator: std.mem.Allocator, block: []const u8, dictionary: ?[]const u8) ![]u8 {
+    if (io.isXzStream(block)) {
+        return decompressStream(allocator, block, null);
+    }
+    const bytes = dictionary orelse {
+        misc.error_context.new("Block of size {} is not a XZ stream and there is no dictionary.", .{block.len});
+        return error.MissingDictionary;
+    };
+    if (block.len < @sizeOf(BlockChecksum)) {
+        misc.error_context.new("Block of size {} is too small to contain a checksum.", .{block.len});
+        return error.MissingChecksum;
+    }
+    const stream = block[0..(block.len - @sizeOf(BlockChecksum))];
+    const expected = std.mem.readInt(BlockChecksum, block[stream.len..][0..@sizeOf(BlockChecksum)], endian);
+    const content = decompressStream(allocator, stream, bytes) catch |err| {
+        misc.error_context.append("Failed to decompress block compressed with a dictionary.", .{});
         return err;
     };
-    defer encoder.deinit();
-    var encoded_buffer: [buffer_size]u8 = undefined;
-    var encoder_writer = encoder.writer(&encoded_buffer);
-    var byte_writer = io.ByteWriter{ .dest_writer = &encoder_writer, .endian = endian };
+    const actual = std.hash.Crc32.hash(content);
+    if (actual != expected) {
+        allocator.free(content);
+        misc.error_context.new("Block checksum {X} does not match the stored checksum {X}.", .{ actual, expected });
+        return error.ChecksumMismatch;
+    }
+    return content;
+}
 
-    const fields = getLocalFields(Frame, config);
-    writeFieldList(&byte_writer, fields) catch |err| {
-        misc.error_context.append("Failed to write field list.", .{});
+fn decompressStream(allocator: std.mem.Allocator, stream: []const u8, dictionary: ?[]const u8) ![]u8 {
+    var stream_reader = std.io.Reader.fixed(stream);
+    const maybe_decoder = if (dictionary) |bytes|
+        io.XzDecoder.initWithDictionary(allocator, &stream_reader, bytes)
+    else
+        io.XzDecoder.init(allocator, &stream_reader);
+    var decoder = maybe_decoder catch |err| {
+        misc.error_context.append("Failed to initialize XZ decoder.", .{});
         return err;
     };
-
-    writeFrames(Frame, &byte_writer, frames, fields) catch |err| {
-        misc.error_context.append("Failed to write frames.", .{});
+    defer decoder.deinit();
+    var decoder_buffer: [buffer_size]u8 = undefined;
+    var decoder_reader = decoder.reader(&decoder_buffer);
+    return decoder_reader.allocRemaining(allocator, .unlimited) catch |err| {
+        misc.error_context.new("Failed to decompress block of size: {}", .{stream.len});
         return err;
     };
+}
 
-    byte_writer.flush() catch |err| {
-        misc.error_context.append("Failed to flush byte writer.", .{});
+fn readBlock(allocator: std.mem.Allocator, reader: *std.io.Reader, block_size: BlockSize) ![]u8 {
+    const block = allocator.alloc(u8, block_size) catch |err| {
+        misc.error_context.new("Failed to allocate block of size: {}", .{block_size});
         return err;
     };
-    file_writer.end() catch |err| {
-        misc.error_context.new("Failed to end file writing.", .{});
+    errdefer allocator.free(block);
+    reader.readSliceAll(block) catch |err| {
+        misc.error_context.new("Failed to read block of size: {}", .{block_size});
         return err;
     };
+    return block;
 }
 
-pub fn loadRecording(
-    comptime Frame: type,
-    allocator: std.mem.Allocator,
-    file_path: []const u8,
-    comptime config: *const RecordingConfig,
-) ![]Frame {
-    const file = std.fs.cwd().openFile(file_path, .{}) catch |err| {
-        misc.error_context.new("Failed to open file: {s}", .{file_path});
+fn writeHeader(writer: *std.io.Writer, header: *const Header) !void {
+    if (header.content_hash) |content_hash| {
+        var payload: [@sizeOf(ContentHash)]u8 = undefined;
+        std.mem.writeInt(ContentHash, &payload, content_hash, endian);
+        writeHeaderEntry(writer, .content_hash, &payload) catch |err| {
+            misc.error_context.append("Failed to write content hash header entry.", .{});
+            return err;
+        };
+    }
+    const codec = [1]u8{@intFromEnum(header.codec)};
+    writeHeaderEntry(writer, .codec, &codec) catch |err| {
+        misc.error_context.append("Failed to write codec header entry.", .{});
         return err;
     };
-    defer file.close();
-
-    var file_buffer: [buffer_size]u8 = undefined;
-    var file_reader = file.reader(&file_buffer);
+    if (header.game) |game| {
+        writeHeaderEntry(writer, .game, @tagName(game)) catch |err| {
+            misc.error_context.append("Failed to write game header entry.", .{});
+            return err;
+        };
+    }
+    if (header.metadata) |*metadata| {
+        writeMetadataEntries(writer, metadata) catch |err| {
+            misc.error_context.append("Failed to write metadata header entries.", .{});
+            return err;
+        };
+    }
+    if (header.profile) |*profile| {
+        writeHeaderEntry(writer, .profile, profile.get()) catch |err| {
+            misc.error_context.append("Failed to write profile header entry.", .{});
+            return err;
+        };
+    }
+    if (header.dictionary_id) |dictionary_id| {
+        var payload: [@sizeOf(DictionaryId)]u8 = undefined;
+        std.mem.writeInt(DictionaryId, &payload, dictionary_id, endian);
+        writeHeaderEntry(writer, .dictionary, &payload) catch |err| {
+            misc.error_context.append("Failed to write dictionary header entry.", .{});
+            return err;
+        };
+    }
+    writer.writeByte(@intFromEnum(HeaderEntryId.end)) catch |err| {
+        misc.error_context.new("Failed to write header end marker.", .{});
+        return err;
+    };
+}
 
-    var magic_buffer: [magic_number.len]u8 = undefined;
-    file_reader.interface.readSliceAll(&magic_buffer) catch |err| {
-        misc.error_context.new("Failed to read magic number.", .{});
+fn writeMetadataEntries(writer: *std.io.Writer, metadata: *const RecordingMetadata) !void {
+    var frames_payload: [@sizeOf(NumberOfFrames)]u8 = undefined;
+    std.mem.writeInt(NumberOfFrames, &frames_payload, metadata.number_of_frames, endian);
+    writeHeaderEntry(writer, .number_of_frames, &frames_payload) catch |err| {
+        misc.error_context.append("Failed to write number of frames header entry.", .{});
         return err;
     };
-    if (!std.mem.eql(u8, &magic_buffer, magic_number)) {
-        misc.error_context.new("Incorrect magic number.", .{});
-        return error.MagicNumber;
+    var markers_payload: [RecordingMetadata.max_markers * @sizeOf(u32)]u8 = undefined;
+    const markers = metadata.getMarkers();
+    for (markers, 0..) |marker, index| {
+        std.mem.writeInt(u32, markers_payload[(index * @sizeOf(u32))..][0..@sizeOf(u32)], marker, endian);
     }
-
-    const version = file_reader.interface.takeInt(VersionNumber, endian) catch |err| {
-        misc.error_context.new("Failed to read version number.", .{});
+    writeHeaderEntry(writer, .markers, markers_payload[0..(markers.len * @sizeOf(u32))]) catch |err| {
+        misc.error_context.append("Failed to write markers header entry.", .{});
         return err;
     };
-    if (version > version_number) {
-        std.log.warn(
-            "File's version number {} is larger then expected {}. Expecting file parsing to fail but proceeding anyway.",
-            .{ version, version_number },
-        );
+    var labels_payload: [RecordingMetadata.max_labels * @sizeOf(Label)]u8 = undefined;
+    const labels = metadata.getLabels();
+    for (labels, 0..) |label, index| {
+        std.mem.writeInt(Label, labels_payload[(index * @sizeOf(Label))..][0..@sizeOf(Label)], label, endian);
     }
-
-    var decoder = io.XzDecoder.init(allocator, &file_reader.interface) catch |err| {
-        misc.error_context.append("Failed to initialize XZ decoder.", .{});
+    writeHeaderEntry(writer, .labels, labels_payload[0..(labels.len * @sizeOf(Label))]) catch |err| {
+        misc.error_context.append("Failed to write labels header entry.", .{});
         return err;
     };
-    defer decoder.deinit();
-    var decoder_buffer: [buffer_size]u8 = undefined;
-    var decoder_reader = decoder.reader(&decoder_buffer);
-    var byte_reader = io.ByteReader{ .src_reader = &decoder_reader, .endian = endian };
+}
 
-    const local_fields = getLocalFields(Frame, config);
-    var remote_fields_buffer: [max_number_of_fields]RemoteField = undefined;
-    const remote_fields = readFieldList(&byte_reader, &remote_fields_buffer, local_fields) catch |err| {
-        misc.error_context.append("Failed to read fields list.", .{});
+fn writeHeaderEntry(writer: *std.io.Writer, id: HeaderEntryId, payload: []const u8) !void {
+    writer.writeByte(@intFromEnum(id)) catch |err| {
+        misc.error_context.new("Failed to write header entry ID: {}", .{@intFromEnum(id)});
         return err;
     };
-
-    const frames = readFrames(Frame, allocator, &byte_reader, remote_fields, local_fields) catch |err| {
-        misc.error_context.append("Failed to read frames.", .{});
+    writer.writeInt(HeaderEntrySize, @intCast(payload.len), endian) catch |err| {
+        misc.error_context.new("Failed to write header entry size: {}", .{payload.len});
+        return err;
+    };
+    writer.writeAll(payload) catch |err| {
+        misc.error_context.new("Failed to write header entry payload.", .{});
         return err;
     };
+}
 
-    return frames;
+fn readHeader(reader: *std.io.Reader) !Header {
+    var header = Header{};
+    while (true) {
+        const id_byte = reader.takeByte() catch |err| {
+            misc.error_context.new("Failed to read header entry ID.", .{});
+            return err;
+        };
+        const id: HeaderEntryId = @enumFromInt(id_byte);
+        if (id == .end) {
+            return header;
+        }
+        const size = reader.takeInt(HeaderEntrySize, endian) catch |err| {
+            misc.error_context.new("Failed to read header entry size. Entry ID is: {}", .{id_byte});
+            return err;
+        };
+        var consumed: usize = 0;
+        switch (id) {
+            .end => unreachable,
+            .codec => {
+                const codec_byte = reader.takeByte() catch |err| {
+                    misc.error_context.new("Failed to read codec header entry.", .{});
+                    return err;
+                };
+                consumed += 1;
+                header.codec = intToCodec(codec_byte) orelse {
+                    misc.error_context.new("Unsupported recording codec: {}", .{codec_byte});
+                    return error.UnsupportedCodec;
+                };
+            },
+            .content_hash => {
+                header.content_hash = reader.takeInt(ContentHash, endian) catch |err| {
+                    misc.error_context.new("Failed to read content hash header entry.", .{});
+                    return err;
+                };
+                consumed += @sizeOf(ContentHash);
+            },
+            .game => {
+                var game_buffer: [32]u8 = undefined;
+                const game_len = @min(size, game_buffer.len);
+                reader.readSliceAll(game_buffer[0..game_len]) catch |err| {
+                    misc.error_context.new("Failed to read game header entry.", .{});
+                    return err;
+                };
+                consumed += game_len;
+                header.game = std.meta.stringToEnum(build_info.Game, game_buffer[0..game_len]);
+            },
+            .profile => {
+                var profile = RecordingProfileName{ .len = @min(size, RecordingProfileName.max_len) };
+                reader.readSliceAll(profile.buffer[0..profile.len]) catch |err| {
+                    misc.error_context.new("Failed to read profile header entry.", .{});
+                    return err;
+                };
+                consumed += profile.len;
+                header.profile = profile;
+            },
+            .dictionary => {
+                header.dictionary_id = reader.takeInt(DictionaryId, endian) catch |err| {
+                    misc.error_context.new("Failed to read dictionary header entry.", .{});
+                    return err;
+                };
+                consumed += @sizeOf(DictionaryId);
+            },
+            .number_of_frames => {
+                const metadata = getOrInitMetadata(&header);
+                metadata.number_of_frames = reader.takeInt(NumberOfFrames, endian) catch |err| {
+                    misc.error_context.new("Failed to read number of frames header entry.", .{});
+                    return err;
+                };
+                consumed += @sizeOf(NumberOfFrames);
+            },
+            .markers => {
+                const metadata = getOrInitMetadata(&header);
+                for (0..(size / @sizeOf(u32))) |_| {
+                    const marker = reader.takeInt(u32, endian) catch |err| {
+                        misc.error_context.new("Failed to read markers header entry.", .{});
+                        return err;
+                    };
+                    metadata.addMarker(marker);
+                    consumed += @sizeOf(u32);
+                }
+            },
+            .labels => {
+                const metadata = getOrInitMetadata(&header);
+                for (0..(size / @sizeOf(Label))) |_| {
+                    const label = reader.takeInt(Label, endian) catch |err| {
+                        misc.error_context.new("Failed to read labels header entry.", .{});
+                        return err;
+                    };
+                    metadata.addLabel(label);
+                    consumed += @sizeOf(Label);
+                }
+            },
+            _ => {}, // Entries written by newer versions that this version does not understand get skipped.
+        }
+        if (consumed > size) {
+            misc.error_context.new("Header entry {} is smaller then expected: {}", .{ id_byte, size });
+            return error.InvalidHeader;
+        }
+        reader.discardAll(size - consumed) catch |err| {
+            misc.error_context.new("Failed to skip the rest of header entry: {}", .{id_byte});
+            return err;
+        };
+    }
+}
+
+fn getProfileName(comptime config: *const RecordingConfig) ?RecordingProfileName {
+    const name = config.profile orelse return null;
+    if (name.len > RecordingProfileName.max_len) {
+        @compileError("Recording profile name is too long: " ++ name);
+    }
+    return .init(name);
+}
+
+// Dictionary that new blocks get compressed with.
+fn getWriterDictionary(comptime config: *const RecordingConfig) ?[]const u8 {
+    if (config.dictionaries.len == 0) {
+        return null;
+    }
+    const dictionary = config.dictionaries[config.dictionaries.len - 1];
+    if (dictionary.bytes.len == 0) {
+        return null;
+    }
+    return dictionary.bytes;
+}
+
+fn getWriterDictionaryId(comptime config: *const RecordingConfig) ?DictionaryId {
+    if (getWriterDictionary(config) == null) {
+        return null;
+    }
+    return config.dictionaries[config.dictionaries.len - 1].getId();
+}
+
+fn findDictionary(comptime config: *const RecordingConfig, maybe_id: ?DictionaryId) !?[]const u8 {
+    const id = maybe_id orelse return null;
+    for (config.dictionaries) |dictionary| {
+        if (dictionary.bytes.len != 0 and dictionary.getId() == id) {
+            return dictionary.bytes;
+        }
+    }
+    misc.error_context.new("Recording was compressed with a unknown dictionary: {X}", .{id});
+    return error.UnknownDictionary;
+}
+
+fn getOrInitMetadata(header: *Header) *RecordingMetadata {
+    if (header.metadata == null) {
+        header.metadata = .{};
+    }
+    return &header.metadata.?;
 }
 
-fn writeFieldList(writer: *io.ByteWriter, comptime fields: []const LocalField) !void {
+fn intToCodec(value: u8) ?RecordingCodec {
+    inline for (@typeInfo(RecordingCodec).@"enum".fields) |*field| {
+        if (field.value == value) {
+            return @enumFromInt(value);
+        }
+    }
+    return null;
+}
+
+fn writeFieldList(
+    writer: *io.ByteWriter,
+    comptime fields: []const LocalField,
+    comptime codec: RecordingCodec,
+    version: VersionNumber,
+) !void {
     writer.writeInt(FieldIndex, @intCast(fields.len)) catch |err| {
         misc.error_context.append("Failed to write number of fields: {}", .{fields.len});
         return err;
@@ -179,12 +2172,81 @@ fn writeFieldList(writer: *io.ByteWriter, comptime fields: []const LocalField) !
             misc.error_context.append("Failed to write the field size: {}", .{size});
             return err;
         };
+        if (version >= first_version_with_precisions) {
+            // Zero precision means that the field is stored exactly.
+            const precision = field.precision orelse 0;
+            writer.writeFloat(Precision, precision) catch |err| {
+                misc.error_context.append("Failed to write the field precision: {}", .{precision});
+                return err;
+            };
+        }
+        if (codec == .predictive) {
+            writeLayout(writer, storedLayoutOf(field)) catch |err| {
+                misc.error_context.append("Failed to write the field layout.", .{});
+                return err;
+            };
+        }
+    }
+}
+
+fn writeLayout(writer: *io.ByteWriter, layout: []const LayoutRun) !void {
+    writer.writeInt(LayoutLength, @intCast(layout.len)) catch |err| {
+        misc.error_context.append("Failed to write layout length: {}", .{layout.len});
+        return err;
+    };
+    for (layout) |*run| {
+        writer.writeEnum(io.PredictiveScalarKind, run.kind) catch |err| {
+            misc.error_context.append("Failed to write layout run kind: {s}", .{@tagName(run.kind)});
+            return err;
+        };
+        writer.writeInt(u8, run.size) catch |err| {
+            misc.error_context.append("Failed to write layout run size: {}", .{run.size});
+            return err;
+        };
+        writer.writeInt(u16, run.count) catch |err| {
+            misc.error_context.append("Failed to write layout run count: {}", .{run.count});
+            return err;
+        };
+    }
+}
+
+fn readLayout(
+    allocator: std.mem.Allocator,
+    reader: *io.ByteReader,
+    layouts: *std.ArrayList(LayoutRun),
+) !void {
+    const len = reader.readInt(LayoutLength) catch |err| {
+        misc.error_context.append("Failed to read layout length.", .{});
+        return err;
+    };
+    for (0..len) |index| {
+        errdefer misc.error_context.append("Failed to read layout run: {}", .{index});
+        const kind = reader.readEnum(io.PredictiveScalarKind) catch |err| {
+            misc.error_context.append("Failed to read layout run kind.", .{});
+            return err;
+        };
+        const size = reader.readInt(u8) catch |err| {
+            misc.error_context.append("Failed to read layout run size.", .{});
+            return err;
+        };
+        const count = reader.readInt(u16) catch |err| {
+            misc.error_context.append("Failed to read layout run count.", .{});
+            return err;
+        };
+        layouts.append(allocator, .{ .kind = kind, .size = size, .count = count }) catch |err| {
+            misc.error_context.new("Failed to append layout run.", .{});
+            return err;
+        };
     }
 }
 
 fn readFieldList(
+    allocator: std.mem.Allocator,
     reader: *io.ByteReader,
     remote_fields_buffer: []RemoteField,
+    layouts: *std.ArrayList(LayoutRun),
+    codec: RecordingCodec,
+    version: VersionNumber,
     comptime local_fields: []const LocalField,
 ) ![]RemoteField {
     const remote_fields_len = reader.readInt(FieldIndex) catch |err| {
@@ -198,6 +2260,7 @@ fn readFieldList(
         );
         return error.TooManyFields;
     }
+    var image_offset: usize = 0;
     for (0..remote_fields_len) |index| {
         errdefer misc.error_context.append("Failed to read field: {}", .{index});
         const path_len = reader.readInt(FieldPathLength) catch |err| {
@@ -214,12 +2277,25 @@ fn readFieldList(
             misc.error_context.append("Failed to read the field size. Field path is: {s}", .{path});
             return err;
         };
+        var precision: ?Precision = null;
+        if (version >= first_version_with_precisions) {
+            const value = reader.readFloat(Precision) catch |err| {
+                misc.error_context.append("Failed to read the field precision. Field path is: {s}", .{path});
+                return err;
+            };
+            if (!(value >= 0) or !std.math.isFinite(value)) {
+                misc.error_context.new("Invalid field precision {}. Field path is: {s}", .{ value, path });
+                return error.InvalidPrecision;
+            }
+            precision = if (value != 0) value else null;
+        }
         inline for (local_fields, 0..) |*local_field, local_index| {
             const local_size = serializedSizeOf(local_field.Type);
             if (std.mem.eql(u8, local_field.path, path) and local_size == remote_size) {
                 remote_fields_buffer[index] = .{
                     .local_index = local_index,
                     .size = remote_size,
+                    .precision = precision,
                 };
                 break;
             }
@@ -227,7 +2303,31 @@ fn readFieldList(
             remote_fields_buffer[index] = .{
                 .local_index = null,
                 .size = remote_size,
+                .precision = precision,
+            };
+        }
+        if (codec == .predictive) {
+            const layout_start = layouts.items.len;
+            readLayout(allocator, reader, layouts) catch |err| {
+                misc.error_context.append("Failed to read the field layout. Field path is: {s}", .{path});
+                return err;
             };
+            const layout = layouts.items[layout_start..];
+            io.validatePredictiveLayout(layout) catch |err| {
+                misc.error_context.append("Invalid field layout. Field path is: {s}", .{path});
+                return err;
+            };
+            if (io.getPredictiveLayoutSize(layout) != remote_size) {
+                misc.error_context.new(
+                    "Field layout size {} does not match the field size {}. Field path is: {s}",
+                    .{ io.getPredictiveLayoutSize(layout), remote_size, path },
+                );
+                return error.InvalidLayout;
+            }
+            remote_fields_buffer[index].layout_start = layout_start;
+            remote_fields_buffer[index].layout_len = layout.len;
+            remote_fields_buffer[index].image_offset = image_offset;
+            image_offset += remote_size;
         }
     }
     return remote_fields_buffer[0..remote_fields_len];
@@ -261,7 +2361,7 @@ fn writeFrames(
                     return err;
                 };
                 const field_pointer = getConstFieldPointer(frame, field) catch unreachable;
-                writeValue(writer, field_pointer) catch |err| {
+                writeFieldValue(writer, field_pointer, field.precision) catch |err| {
                     misc.error_context.append("Failed to write the new value.", .{});
                     return err;
                 };
@@ -310,6 +2410,8 @@ fn findFieldChanges(
         }
         break :block array;
     };
+    // Raw bytes of the whole frame get compared first, so only fields whose bytes differ get compared by value.
+    const mask = io.ChangeMask(Frame).init(frame_1, frame_2);
     var number_of_changes: FieldIndex = 0;
     var field_changed: [fields.len]bool = [1]bool{false} ** fields.len;
     inline for (fields, 0..) |*field, field_index| {
@@ -323,44 +2425,20 @@ fn findFieldChanges(
             ancestor_index = parent_indices[index];
         }
         if (!ancestor_changed) { // Ancestor change supplies changes for all descendants. No need to duplicate changes.
-            if (getConstFieldPointer(frame_1, field) catch null) |field_pointer_1| {
-                if (getConstFieldPointer(frame_2, field) catch null) |field_pointer_2| {
-                    if (!field.has_children) { // Leaf nodes are the regular nodes that change when their raw value changes.
-                        if (!areValuesEqual(field_pointer_1.*, field_pointer_2.*)) {
-                            field_changed[field_index] = true;
-                            number_of_changes += 1;
-                        }
-                    } else switch (@typeInfo(field.Type)) { // Only optionals and tagged unions can have children.
-                        .optional => {
-                            // Optional root nodes need to change only when transitioning from and to a null value.
-                            // If only the payload changes, descendant nodes are responsible to store these changes.
-                            const changed = (field_pointer_1.* == null and field_pointer_2.* != null) or
-                                (field_pointer_1.* != null and field_pointer_2.* == null);
-                            if (changed) {
-                                field_changed[field_index] = true;
-                                number_of_changes += 1;
-                            }
-                        },
-                        .@"union" => |*info| {
-                            // Tagged union root node needs to change only when union's tag changes.
-                            // If only the payload changes, descendant nodes are responsible to store these changes.
-                            if (info.tag_type == null) {
-                                @compileError(
-                                    "Expected optional type or a tagged union but got: " ++ @typeName(field.Type),
-                                );
-                            }
-                            const tag_1 = std.meta.activeTag(field_pointer_1.*);
-                            const tag_2 = std.meta.activeTag(field_pointer_2.*);
-                            if (tag_1 != tag_2) {
-                                field_changed[field_index] = true;
-                                number_of_changes += 1;
-                            }
-                        },
-                        else => @compileError(
-                            "Expected optional type or a tagged union but got: " ++ @typeName(field.Type),
-                        ),
-                    }
+            const region = comptime getFieldRegion(Frame, field);
+            const is_quantized_leaf = comptime !field.has_children and field.precision != null;
+            const changed = if (mask.isChanged(region.offset, region.size)) block: {
+                if (comptime is_quantized_leaf) {
+                    break :block isQuantizedFieldChanged(frame_1, frame_2, field);
                 }
+                break :block isFieldChanged(frame_1, frame_2, field);
+            } else if (comptime !field.has_children and !is_quantized_leaf and containsFloats(field.Type))
+                isFieldNan(frame_1, field) // Equal bytes still make a NaN unequal to itself. Quantized NaN is 0 steps.
+            else
+                false;
+            if (changed) {
+                field_changed[field_index] = true;
+                number_of_changes += 1;
             }
         }
     }
@@ -370,6 +2448,161 @@ fn findFieldChanges(
     };
 }
 
+fn isFieldChanged(frame_1: anytype, frame_2: @TypeOf(frame_1), comptime field: *const LocalField) bool {
+    const field_pointer_1 = findConstFieldPointer(frame_1, field) orelse return false;
+    const field_pointer_2 = findConstFieldPointer(frame_2, field) orelse return false;
+    if (!field.has_children) { // Leaf nodes are the regular nodes that change when their raw value changes.
+        return !areValuesEqual(field_pointer_1.*, field_pointer_2.*);
+    }
+    switch (@typeInfo(field.Type)) { // Only optionals and tagged unions can have children.
+        .optional => {
+            // Optional root nodes need to change only when transitioning from and to a null value.
+            // If only the payload changes, descendant nodes are responsible to store these changes.
+            return (field_pointer_1.* == null) != (field_pointer_2.* == null);
+        },
+        .@"union" => |*info| {
+            // Tagged union root node needs to change only when union's tag changes.
+            // If only the payload changes, descendant nodes are responsible to store these changes.
+            if (info.tag_type == null) {
+                @compileError("Expected optional type or a tagged union but got: " ++ @typeName(field.Type));
+            }
+            return std.meta.activeTag(field_pointer_1.*) != std.meta.activeTag(field_pointer_2.*);
+        },
+        else => @compileError("Expected optional type or a tagged union but got: " ++ @typeName(field.Type)),
+    }
+}
+
+// Quantized leaf fields change only when the number of precision steps of any of their floats changes, since that is
+// all that gets stored. Noise smaller then the precision doesn't produce changes.
+fn isQuantizedFieldChanged(frame_1: anytype, frame_2: @TypeOf(frame_1), comptime field: *const LocalField) bool {
+    const field_pointer_1 = findConstFieldPointer(frame_1, field) orelse return false;
+    const field_pointer_2 = findConstFieldPointer(frame_2, field) orelse return false;
+    // Values that fail to serialize count as changed, so that writing them reports the error.
+    const image_1 = quantizeValue(field_pointer_1, field.precision.?) catch return true;
+    const image_2 = quantizeValue(field_pointer_2, field.precision.?) catch return true;
+    return !std.mem.eql(u8, &image_1, &image_2);
+}
+
+fn quantizeValue(value_pointer: anytype, precision: Precision) ![serializedSizeOf(@TypeOf(value_pointer.*))]u8 {
+    const Type = @TypeOf(value_pointer.*);
+    var image: [serializedSizeOf(Type)]u8 = undefined;
+    var image_writer = std.io.Writer.fixed(&image);
+    var byte_writer = io.ByteWriter{ .dest_writer = &image_writer, .endian = endian };
+    try writeValue(&byte_writer, value_pointer);
+    quantizeImage(serializedLayoutOf(Type), &image, precision);
+    return image;
+}
+
+// Same as isFieldChanged(frame, frame, field) for leaf fields, without comparing the values.
+fn isFieldNan(frame: anytype, comptime field: *const LocalField) bool {
+    const field_pointer = findConstFieldPointer(frame, field) orelse return false;
+    return containsNan(field_pointer);
+}
+
+// Only NaN floats make a value unequal to itself. Floats get found at comptime, so this only tests the raw bits at
+// their offsets, without going through the values that can't contain floats.
+fn containsNan(value: anytype) bool {
+    const Type = @TypeOf(value.*);
+    switch (@typeInfo(Type)) {
+        .float => |*info| {
+            if (info.bits == 80) { // Explicit integer bit doesn't fit the bit pattern of the other formats.
+                return std.math.isNan(value.*);
+            }
+            const Bits = std.meta.Int(.unsigned, info.bits);
+            const bits: Bits = @bitCast(value.*);
+            const infinity_bits: Bits = @bitCast(std.math.inf(Type));
+            return (bits & (std.math.maxInt(Bits) >> 1)) > infinity_bits;
+        },
+        .@"struct" => |*info| {
+            inline for (info.fields) |*field| {
+                if (comptime !field.is_comptime and containsFloats(field.type)) {
+                    if (containsNan(&@field(value.*, field.name))) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        },
+        .array => |*info| {
+            if (comptime !containsFloats(info.child)) {
+                return false;
+            }
+            for (value) |*element| {
+                if (containsNan(element)) {
+                    return true;
+                }
+            }
+            return false;
+        },
+        .optional => {
+            const payload = if (value.*) |*payload| payload else return false;
+            return containsNan(payload);
+        },
+        .@"union" => |*info| {
+            if (info.layout == .@"packed") { // Packed unions get compared by their bits.
+                return false;
+            }
+            switch (value.*) {
+                inline else => |*payload| return containsNan(payload),
+            }
+        },
+        .vector => return !areValuesEqual(value.*, value.*),
+        else => return false,
+    }
+}
+
+const FieldRegion = struct {
+    offset: usize,
+    size: usize,
+};
+
+// Bytes of the frame that the field lives in. Where the payload of an optional or a union lies isn't known at comptime,
+// and fields of packed structs don't have to start at a byte, so the region stops at the first one of those.
+fn getFieldRegion(comptime Frame: type, comptime field: *const LocalField) FieldRegion {
+    comptime {
+        var Type = Frame;
+        var offset: usize = 0;
+        for (field.access) |*element| {
+            switch (element.*) {
+                .struct_field => |name| {
+                    if (@typeInfo(Type).@"struct".layout == .@"packed") {
+                        break;
+                    }
+                    offset += @offsetOf(Type, name);
+                    Type = @FieldType(Type, name);
+                },
+                .array_index => |index| {
+                    const Element = @typeInfo(Type).array.child;
+                    offset += index * @sizeOf(Element);
+                    Type = Element;
+                },
+                .optional_payload, .union_field => break,
+            }
+        }
+        return .{ .offset = offset, .size = @sizeOf(Type) };
+    }
+}
+
+fn containsFloats(comptime Type: type) bool {
+    return switch (@typeInfo(Type)) {
+        .float => true,
+        .@"struct" => |*info| for (info.fields) |*field| {
+            if (containsFloats(field.type)) {
+                break true;
+            }
+        } else false,
+        .@"union" => |*info| info.layout != .@"packed" and for (info.fields) |*field| {
+            if (containsFloats(field.type)) {
+                break true;
+            }
+        } else false,
+        .optional => |*info| containsFloats(info.child),
+        .array => |*info| containsFloats(info.child),
+        .vector => |*info| containsFloats(info.child),
+        else => false,
+    };
+}
+
 fn areValuesEqual(value_1: anytype, value_2: @TypeOf(value_1)) bool {
     const Type = @TypeOf(value_1);
     return switch (@typeInfo(Type)) {
@@ -392,12 +2625,13 @@ fn readFrames(
     reader: *io.ByteReader,
     remote_fields: []const RemoteField,
     comptime local_fields: []const LocalField,
-) ![]Frame {
+    frames: *std.ArrayList(Frame),
+) !void {
     const number_of_frames = reader.readInt(NumberOfFrames) catch |err| {
         misc.error_context.append("Failed to read number of frames.", .{});
         return err;
     };
-    const frames = allocator.alloc(Frame, number_of_frames) catch |err| {
+    frames.ensureUnusedCapacity(allocator, number_of_frames) catch |err| {
         misc.error_context.new(
             "Failed to allocate enough memory to store the recording frames. Number of frames is: {}",
             .{number_of_frames},
@@ -432,36 +2666,198 @@ fn readFrames(
                 };
                 continue;
             };
-            inline for (local_fields, 0..) |*local_field, index| {
-                if (index == local_index) {
-                    if (readValue(local_field.Type, reader)) |field_value| {
-                        if (getFieldPointer(&current_frame, local_field)) |field_pointer| {
-                            field_pointer.* = field_value;
-                        } else |err| {
-                            misc.error_context.append("Failed to access field: {s}", .{local_field.path});
-                            if (!builtin.is_test) {
-                                misc.error_context.logWarning(err);
-                            }
-                            setFieldToDefaultValue(Frame, &current_frame, index, local_fields);
-                        }
-                    } else |err| {
-                        misc.error_context.append("Failed to read the new value of: {s}", .{local_field.path});
-                        if (err == error.InvalidValue) {
-                            if (!builtin.is_test) {
-                                misc.error_context.logWarning(err);
-                            }
-                            setFieldToDefaultValue(Frame, &current_frame, index, local_fields);
-                        } else {
-                            return err;
-                        }
+            const precision = remote_field.precision;
+            readFieldValue(Frame, &current_frame, reader, local_index, precision, local_fields) catch |err| {
+                misc.error_context.append("Failed to read field value.", .{});
+                return err;
+            };
+        }
+        frames.appendAssumeCapacity(current_frame);
+    }
+}
+
+fn readFieldValue(
+    comptime Frame: type,
+    frame: *Frame,
+    reader: *io.ByteReader,
+    local_index: usize,
+    precision: ?Precision,
+    comptime local_fields: []const LocalField,
+) !void {
+    inline for (local_fields, 0..) |*local_field, index| {
+        if (index == local_index) {
+            const maybe_value = if (precision) |p| block: {
+                break :block readQuantizedValue(local_field.Type, reader, p);
+            } else block: {
+                break :block readValue(local_field.Type, reader);
+            };
+            if (maybe_value) |field_value| {
+                if (getFieldPointer(frame, local_field)) |field_pointer| {
+                    field_pointer.* = field_value;
+                } else |err| {
+                    misc.error_context.append("Failed to access field: {s}", .{local_field.path});
+                    if (!builtin.is_test) {
+                        misc.error_context.logWarning(err);
                     }
-                    break;
+                    setFieldToDefaultValue(Frame, frame, index, local_fields);
+                }
+            } else |err| {
+                misc.error_context.append("Failed to read the new value of: {s}", .{local_field.path});
+                if (err == error.InvalidValue) {
+                    if (!builtin.is_test) {
+                        misc.error_context.logWarning(err);
+                    }
+                    setFieldToDefaultValue(Frame, frame, index, local_fields);
+                } else {
+                    return err;
+                }
+            }
+            return;
+        }
+    } else unreachable;
+}
+
+fn writePredictiveFrames(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    writer: *io.BitWriter,
+    frames: []const Frame,
+    comptime fields: []const LocalField,
+) !void {
+    const image_offsets, const images_size, const max_image_size = comptime block: {
+        var offsets: [fields.len]usize = undefined;
+        var size: usize = 0;
+        var max_size: usize = 0;
+        for (fields, 0..) |*field, index| {
+            offsets[index] = size;
+            size += serializedSizeOf(field.Type);
+            max_size = @max(max_size, serializedSizeOf(field.Type));
+        }
+        break :block .{ offsets, size, max_size };
+    };
+    // Every field is predicted from the last value that was stored for that field. Initially that are all zeroes.
+    const previous_images = allocator.alloc(u8, images_size) catch |err| {
+        misc.error_context.new("Failed to allocate previous field images. Size is: {}", .{images_size});
+        return err;
+    };
+    defer allocator.free(previous_images);
+    @memset(previous_images, 0);
+    var image_buffer: [max_image_size]u8 = undefined;
+
+    writer.writeInt(NumberOfFrames, @intCast(frames.len)) catch |err| {
+        misc.error_context.append("Failed to write number of frames: {}", .{frames.len});
+        return err;
+    };
+    for (frames, 0..) |*frame, frame_index| {
+        errdefer misc.error_context.append("Failed to write frame: {}", .{frame_index});
+        const changes = switch (frame_index) {
+            0 => getInitialChanges(fields),
+            else => findFieldChanges(Frame, frame, &frames[frame_index - 1], fields),
+        };
+        writer.writeInt(FieldIndex, changes.number_of_changes) catch |err| {
+            misc.error_context.append("Failed to write number of changes: {}", .{changes.number_of_changes});
+            return err;
+        };
+        inline for (fields, 0..) |*field, field_index| {
+            if (changes.field_changed[field_index]) {
+                errdefer misc.error_context.append("Failed to write change for field: {s}", .{field.path});
+                writer.writeInt(FieldIndex, @intCast(field_index)) catch |err| {
+                    misc.error_context.append("Failed to write field index: {}", .{field_index});
+                    return err;
+                };
+                const size = serializedSizeOf(field.Type);
+                const image = image_buffer[0..size];
+                var image_writer = std.io.Writer.fixed(image);
+                var byte_writer = io.ByteWriter{ .dest_writer = &image_writer, .endian = endian };
+                const field_pointer = getConstFieldPointer(frame, field) catch unreachable;
+                writeValue(&byte_writer, field_pointer) catch |err| {
+                    misc.error_context.append("Failed to serialize the new value.", .{});
+                    return err;
+                };
+                if (field.precision) |precision| {
+                    quantizeImage(serializedLayoutOf(field.Type), image, precision);
                 }
-            } else unreachable;
+                const previous_image = previous_images[image_offsets[field_index]..][0..size];
+                io.encodePredictiveImage(writer, storedLayoutOf(field), previous_image, image) catch |err| {
+                    misc.error_context.append("Failed to write the new value.", .{});
+                    return err;
+                };
+                @memcpy(previous_image, image);
+            }
         }
-        frames[frame_index] = current_frame;
     }
-    return frames;
+}
+
+fn readPredictiveFrames(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    reader: *io.BitReader,
+    remote_fields: []const RemoteField,
+    layouts: []const LayoutRun,
+    comptime local_fields: []const LocalField,
+    frames: *std.ArrayList(Frame),
+) !void {
+    var images_size: usize = 0;
+    for (remote_fields) |*remote_field| {
+        images_size = @max(images_size, remote_field.image_offset + remote_field.size);
+    }
+    const images = allocator.alloc(u8, images_size) catch |err| {
+        misc.error_context.new("Failed to allocate field images. Size is: {}", .{images_size});
+        return err;
+    };
+    defer allocator.free(images);
+    @memset(images, 0);
+
+    const number_of_frames = reader.readInt(NumberOfFrames) catch |err| {
+        misc.error_context.append("Failed to read number of frames.", .{});
+        return err;
+    };
+    frames.ensureUnusedCapacity(allocator, number_of_frames) catch |err| {
+        misc.error_context.new(
+            "Failed to allocate enough memory to store the recording frames. Number of frames is: {}",
+            .{number_of_frames},
+        );
+        return err;
+    };
+    var current_frame = Frame{};
+    for (0..number_of_frames) |frame_index| {
+        errdefer misc.error_context.append("Failed read frame: {}", .{frame_index});
+        const number_of_changes = reader.readInt(FieldIndex) catch |err| {
+            misc.error_context.append("Failed to read number changes.", .{});
+            return err;
+        };
+        for (0..number_of_changes) |change_index| {
+            errdefer misc.error_context.append("Failed read change: {}", .{change_index});
+            const remote_index = reader.readInt(FieldIndex) catch |err| {
+                misc.error_context.append("Failed to read field index.", .{});
+                return err;
+            };
+            if (remote_index >= remote_fields.len) {
+                misc.error_context.new(
+                    "Field index {} is out of bounds. Number of fields is: {}",
+                    .{ remote_index, remote_fields.len },
+                );
+                return error.IndexOutOfBounds;
+            }
+            const remote_field = &remote_fields[remote_index];
+            const layout = layouts[remote_field.layout_start..][0..remote_field.layout_len];
+            const image = images[remote_field.image_offset..][0..remote_field.size];
+            // Unknown fields still need to be decoded because their image is the prediction for their next change.
+            io.decodePredictiveImage(reader, layout, image) catch |err| {
+                misc.error_context.append("Failed to read the new value.", .{});
+                return err;
+            };
+            const local_index = remote_field.local_index orelse continue;
+            var image_reader = std.io.Reader.fixed(image);
+            var byte_reader = io.ByteReader{ .src_reader = &image_reader, .endian = endian };
+            const precision = remote_field.precision;
+            readFieldValue(Frame, &current_frame, &byte_reader, local_index, precision, local_fields) catch |err| {
+                misc.error_context.append("Failed to read field value.", .{});
+                return err;
+            };
+        }
+        frames.appendAssumeCapacity(current_frame);
+    }
 }
 
 fn setFieldToDefaultValue(
@@ -488,6 +2884,36 @@ fn setFieldToDefaultValue(
     }
 }
 
+fn writeFieldValue(writer: *io.ByteWriter, value_pointer: anytype, comptime precision: ?Precision) !void {
+    const Type = @TypeOf(value_pointer.*);
+    const p = precision orelse return writeValue(writer, value_pointer);
+    var image: [serializedSizeOf(Type)]u8 = undefined;
+    var image_writer = std.io.Writer.fixed(&image);
+    var byte_writer = io.ByteWriter{ .dest_writer = &image_writer, .endian = endian };
+    writeValue(&byte_writer, value_pointer) catch |err| {
+        misc.error_context.append("Failed to serialize the value that gets quantized.", .{});
+        return err;
+    };
+    quantizeImage(serializedLayoutOf(Type), &image, p);
+    writer.writeBytes(&image) catch |err| {
+        misc.error_context.append("Failed to write quantized value.", .{});
+        return err;
+    };
+}
+
+// The whole value gets read before it is restored, so the reader stays in place even if the value is invalid.
+fn readQuantizedValue(comptime Type: type, reader: *io.ByteReader, precision: Precision) anyerror!Type {
+    var image: [serializedSizeOf(Type)]u8 = undefined;
+    reader.readBytes(&image) catch |err| {
+        misc.error_context.append("Failed to read quantized value. ({s})", .{@typeName(Type)});
+        return err;
+    };
+    dequantizeImage(serializedLayoutOf(Type), &image, precision);
+    var image_reader = std.io.Reader.fixed(&image);
+    var byte_reader = io.ByteReader{ .src_reader = &image_reader, .endian = endian };
+    return readValue(Type, &byte_reader);
+}
+
 fn writeValue(writer: *io.ByteWriter, value_pointer: anytype) !void {
     const Type = switch (@typeInfo(@TypeOf(value_pointer))) {
         .pointer => |info| info.child,
@@ -784,6 +3210,159 @@ fn serializedSizeOf(comptime Type: type) comptime_int {
     };
 }
 
+// Describes how the bytes produced by writeValue split into scalars. Used by the predictive codec.
+fn serializedLayoutOf(comptime Type: type) []const LayoutRun {
+    comptime {
+        var layout: []const LayoutRun = &.{};
+        appendSerializedLayout(&layout, Type);
+        const final = layout[0..layout.len].*;
+        return &final;
+    }
+}
+
+fn appendSerializedLayout(comptime layout: *[]const LayoutRun, comptime Type: type) void {
+    switch (@typeInfo(Type)) {
+        .void => {},
+        .bool => appendLayoutRun(layout, .int, 1, 1),
+        .int => {
+            const size = serializedSizeOf(Type);
+            if (size <= io.predictive_max_scalar_size) {
+                appendLayoutRun(layout, .int, size, 1);
+            } else {
+                appendLayoutRun(layout, .int, 1, size);
+            }
+        },
+        .float => |*info| switch (info.bits) {
+            16, 32, 64 => appendLayoutRun(layout, .float, serializedSizeOf(Type), 1),
+            else => appendLayoutRun(layout, .int, 1, serializedSizeOf(Type)),
+        },
+        .@"enum" => |*info| appendSerializedLayout(layout, info.tag_type),
+        .optional => |*info| {
+            appendSerializedLayout(layout, bool);
+            appendSerializedLayout(layout, info.child);
+        },
+        .array => |*info| for (0..info.len) |_| {
+            appendSerializedLayout(layout, info.child);
+        },
+        .@"struct" => |*info| if (info.backing_integer) |IntType| {
+            appendSerializedLayout(layout, IntType);
+        } else {
+            for (info.fields) |*field| {
+                appendSerializedLayout(layout, field.type);
+            }
+        },
+        .@"union" => |*info| if (info.layout == .@"packed") {
+            const IntType = @Type(.{ .int = .{ .signedness = .unsigned, .bits = @bitSizeOf(Type) } });
+            appendSerializedLayout(layout, IntType);
+        } else {
+            const Tag = info.tag_type orelse {
+                @compileError("Union " ++ @typeName(Type) ++ " is not serializable. (Not tagged and not packed.)");
+            };
+            appendSerializedLayout(layout, Tag);
+            // Payloads of different variants overlap, so there is no single scalar layout to describe them.
+            appendLayoutRun(layout, .int, 1, serializedSizeOf(Type) - serializedSizeOf(Tag));
+        },
+        else => @compileError("Unsupported type: " ++ @typeName(Type)),
+    }
+}
+
+fn appendLayoutRun(
+    comptime layout: *[]const LayoutRun,
+    comptime kind: io.PredictiveScalarKind,
+    comptime size: u8,
+    comptime count: usize,
+) void {
+    if (count == 0) {
+        return;
+    }
+    const max_count = std.math.maxInt(@FieldType(LayoutRun, "count"));
+    if (layout.len > 0) {
+        const last = layout.*[layout.len - 1];
+        if (last.kind == kind and last.size == size and last.count < max_count) {
+            const merged = @min(count, max_count - last.count);
+            layout.* = layout.*[0 .. layout.len - 1] ++ [1]LayoutRun{.{
+                .kind = kind,
+                .size = size,
+                .count = last.count + merged,
+            }};
+            appendLayoutRun(layout, kind, size, count - merged);
+            return;
+        }
+    }
+    const taken = @min(count, max_count);
+    layout.* = layout.* ++ [1]LayoutRun{.{ .kind = kind, .size = size, .count = taken }};
+    appendLayoutRun(layout, kind, size, count - taken);
+}
+
+// Layout of the field as it is stored. Quantized floats are stored as integers of the same size.
+fn storedLayoutOf(comptime field: *const LocalField) []const LayoutRun {
+    comptime {
+        const layout = serializedLayoutOf(field.Type);
+        if (field.precision == null) {
+            return layout;
+        }
+        var stored: []const LayoutRun = &.{};
+        for (layout) |*run| {
+            appendLayoutRun(&stored, .int, run.size, run.count);
+        }
+        const final = stored[0..stored.len].*;
+        return &final;
+    }
+}
+
+fn hasQuantizedFields(comptime fields: []const LocalField) bool {
+    for (fields) |*field| {
+        if (field.precision != null) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Replaces every float inside the serialized image with a signed integer of the same size that holds the number of
+// precision steps nearest to the float. Values that do not fit get saturated and NaN becomes zero.
+fn quantizeImage(layout: []const LayoutRun, image: []u8, precision: Precision) void {
+    var offset: usize = 0;
+    for (layout) |*run| {
+        for (0..run.count) |_| {
+            if (run.kind == .float) switch (run.size) {
+                inline 2, 4, 8 => |size| {
+                    const Float = std.meta.Float(size * std.mem.byte_size_in_bits);
+                    const Bits = std.meta.Int(.unsigned, size * std.mem.byte_size_in_bits);
+                    const Steps = std.meta.Int(.signed, size * std.mem.byte_size_in_bits);
+                    const bytes = image[offset..][0..size];
+                    const value: Float = @bitCast(std.mem.readInt(Bits, bytes, endian));
+                    const steps = std.math.lossyCast(Steps, @round(@as(f64, @floatCast(value)) / precision));
+                    std.mem.writeInt(Steps, bytes, steps, endian);
+                },
+                else => unreachable,
+            };
+            offset += run.size;
+        }
+    }
+}
+
+fn dequantizeImage(layout: []const LayoutRun, image: []u8, precision: Precision) void {
+    var offset: usize = 0;
+    for (layout) |*run| {
+        for (0..run.count) |_| {
+            if (run.kind == .float) switch (run.size) {
+                inline 2, 4, 8 => |size| {
+                    const Float = std.meta.Float(size * std.mem.byte_size_in_bits);
+                    const Bits = std.meta.Int(.unsigned, size * std.mem.byte_size_in_bits);
+                    const Steps = std.meta.Int(.signed, size * std.mem.byte_size_in_bits);
+                    const bytes = image[offset..][0..size];
+                    const steps = std.mem.readInt(Steps, bytes, endian);
+                    const value: Float = @floatCast(@as(f64, @floatFromInt(steps)) * precision);
+                    std.mem.writeInt(Bits, bytes, @bitCast(value), endian);
+                },
+                else => unreachable,
+            };
+            offset += run.size;
+        }
+    }
+}
+
 fn getFieldPointer(frame: anytype, comptime field: *const LocalField) error{Inaccessible}!*field.Type {
     return getFieldPointerRecursive(*field.Type, frame, field.access);
 }
@@ -841,14 +3420,47 @@ fn getFieldPointerRecursive(
     };
 }
 
+// Same as getConstFieldPointer but without building the error context, for code that runs for every field of a frame.
+fn findConstFieldPointer(frame: anytype, comptime field: *const LocalField) ?*const field.Type {
+    return findFieldPointerRecursive(*const field.Type, frame, field.access);
+}
+
+fn findFieldPointerRecursive(
+    comptime Pointer: type,
+    lhs_pointer: anytype,
+    comptime access: []const AccessElement,
+) ?Pointer {
+    if (access.len == 0) {
+        return lhs_pointer;
+    }
+    const next_pointer = switch (access[0]) {
+        .struct_field => |name| &@field(lhs_pointer, name),
+        .array_index => |index| &lhs_pointer[index],
+        .optional_payload => if (lhs_pointer.*) |*pointer| pointer else return null,
+        .union_field => |name| block: {
+            const expected_tag = @field(std.meta.Tag(@TypeOf(lhs_pointer.*)), name);
+            if (std.meta.activeTag(lhs_pointer.*) != expected_tag) {
+                return null;
+            }
+            break :block &@field(lhs_pointer, name);
+        },
+    };
+    return findFieldPointerRecursive(Pointer, next_pointer, access[1..]);
+}
+
 const GetLocalFieldsState = struct {
     fields_buffer: []LocalField,
     fields_len: *usize,
     atomic_type_usage: []bool,
     atomic_path_usage: []bool,
+    quantized_path_usage: []bool,
+    excluded_path_usage: []bool,
+    excluded_atomic_type_usage: []bool,
+    excluded_atomic_path_usage: []bool,
+    is_excluded: bool = false,
 };
 
-inline fn getLocalFields(comptime Frame: type, comptime config: *const RecordingConfig) []const LocalField {
+pub inline fn getLocalFields(comptime Frame: type, comptime config: *const RecordingConfig) []const LocalField {
     comptime {
         @setEvalBranchQuota(100000);
 
@@ -856,6 +3468,10 @@ inline fn getLocalFields(comptime Frame: type, comptime config: *const Recording
         var fields_len: usize = 0;
         var atomic_type_usage = [1]bool{false} ** config.atomic_types.len;
         var atomic_path_usage = [1]bool{false} ** config.atomic_paths.len;
+        var quantized_path_usage = [1]bool{false} ** config.quantized_paths.len;
+        var excluded_path_usage = [1]bool{false} ** config.excluded_paths.len;
+        var excluded_atomic_type_usage = [1]bool{false} ** config.atomic_types.len;
+        var excluded_atomic_path_usage = [1]bool{false} ** config.atomic_paths.len;
 
         const field = LocalField{
             .path = "",
@@ -869,21 +3485,37 @@ inline fn getLocalFields(comptime Frame: type, comptime config: *const Recording
             .fields_len = &fields_len,
             .atomic_type_usage = &atomic_type_usage,
             .atomic_path_usage = &atomic_path_usage,
+            .quantized_path_usage = &quantized_path_usage,
+            .excluded_path_usage = &excluded_path_usage,
+            .excluded_atomic_type_usage = &excluded_atomic_type_usage,
+            .excluded_atomic_path_usage = &excluded_atomic_path_usage,
         };
         getLocalFieldsRecursive(config, &field, &state);
 
-        for (atomic_type_usage, 0..) |is_used, index| {
-            if (!is_used) {
+        for (atomic_type_usage, excluded_atomic_type_usage, 0..) |is_used, is_used_by_excluded, index| {
+            if (!is_used and !is_used_by_excluded) {
                 const Type = config.atomic_types[index];
                 @compileError("Unused atomic type in configuration: " ++ @typeName(Type));
             }
         }
-        for (atomic_path_usage, 0..) |is_used, index| {
-            if (!is_used) {
+        for (atomic_path_usage, excluded_atomic_path_usage, 0..) |is_used, is_used_by_excluded, index| {
+            if (!is_used and !is_used_by_excluded) {
                 const path = config.atomic_paths[index];
                 @compileError("Unused atomic path in configuration: " ++ path);
             }
         }
+        for (quantized_path_usage, 0..) |is_used, index| {
+            if (!is_used) {
+                const path = config.quantized_paths[index].pattern;
+                @compileError("Unused quantized path in configuration: " ++ path);
+            }
+        }
+        for (excluded_path_usage, 0..) |is_used, index| {
+            if (!is_used) {
+                const path = config.excluded_paths[index];
+                @compileError("Unused excluded path in configuration: " ++ path);
+            }
+        }
 
         const fields = fields_buffer[0..fields_len].*;
         return &fields;
@@ -892,9 +3524,32 @@ inline fn getLocalFields(comptime Frame: type, comptime config: *const Recording
 
 fn getLocalFieldsRecursive(
     comptime config: *const RecordingConfig,
-    field: *const LocalField,
+    inherited_field: *const LocalField,
     state: *const GetLocalFieldsState,
 ) void {
+    if (!state.is_excluded) {
+        for (config.excluded_paths, 0..) |pattern, index| {
+            if (doesPathMatchPattern(inherited_field.path, pattern)) {
+                state.excluded_path_usage[index] = true;
+                markExcludedUsage(config, inherited_field, state);
+                return;
+            }
+        }
+    }
+    // Precision of a quantized path applies to every field under that path.
+    var quantized_field = inherited_field.*;
+    for (config.quantized_paths, 0..) |*quantized_path, index| {
+        if (!doesPathMatchPattern(inherited_field.path, quantized_path.pattern)) {
+            continue;
+        }
+        if (!(quantized_path.precision > 0)) {
+            @compileError("Precision of quantized path " ++ quantized_path.pattern ++ " has to be larger than zero.");
+        }
+        quantized_field.precision = quantized_path.precision;
+        state.quantized_path_usage[index] = true;
+        break;
+    }
+    const field = &quantized_field;
     for (config.atomic_types, 0..) |AtomicType, index| {
         if (AtomicType != field.Type) {
             continue;
@@ -930,6 +3585,7 @@ fn getLocalFieldsRecursive(
                     .Type = struct_field.type,
                     .parent_index = field.parent_index,
                     .has_children = false,
+                    .precision = field.precision,
                 };
                 getLocalFieldsRecursive(config, &sub_field, state);
             }
@@ -946,6 +3602,7 @@ fn getLocalFieldsRecursive(
                     .Type = info.child,
                     .parent_index = field.parent_index,
                     .has_children = false,
+                    .precision = field.precision,
                 };
                 getLocalFieldsRecursive(config, &sub_field, state);
             }
@@ -958,6 +3615,7 @@ fn getLocalFieldsRecursive(
                 .Type = field.Type,
                 .parent_index = field.parent_index,
                 .has_children = true,
+                .precision = field.precision,
             };
             addLocalField(&root_field, state);
             const sub_field = LocalField{
@@ -970,6 +3628,7 @@ fn getLocalFieldsRecursive(
                 .Type = info.child,
                 .parent_index = root_index,
                 .has_children = false,
+                .precision = field.precision,
             };
             getLocalFieldsRecursive(config, &sub_field, state);
         },
@@ -986,6 +3645,7 @@ fn getLocalFieldsRecursive(
                 .Type = field.Type,
                 .parent_index = field.parent_index,
                 .has_children = true,
+                .precision = field.precision,
             };
             addLocalField(&root_field, state);
             for (info.fields) |*union_field| {
@@ -999,6 +3659,7 @@ fn getLocalFieldsRecursive(
                     .Type = union_field.type,
                     .parent_index = root_index,
                     .has_children = false,
+                    .precision = field.precision,
                 };
                 getLocalFieldsRecursive(config, &sub_field, state);
             }
@@ -1007,6 +3668,30 @@ fn getLocalFieldsRecursive(
     }
 }
 
+// Walks the fields under a excluded path without keeping them, so that atomic types and paths matching only those
+// fields count as used by the excluded path instead of being reported as unused.
+fn markExcludedUsage(
+    comptime config: *const RecordingConfig,
+    excluded_field: *const LocalField,
+    state: *const GetLocalFieldsState,
+) void {
+    var fields_buffer: [max_number_of_fields]LocalField = undefined;
+    var fields_len: usize = 0;
+    var quantized_path_usage = [1]bool{false} ** config.quantized_paths.len;
+    const excluded_state = GetLocalFieldsState{
+        .fields_buffer = &fields_buffer,
+        .fields_len = &fields_len,
+        .atomic_type_usage = state.excluded_atomic_type_usage,
+        .atomic_path_usage = state.excluded_atomic_path_usage,
+        .quantized_path_usage = &quantized_path_usage,
+        .excluded_path_usage = state.excluded_path_usage,
+        .excluded_atomic_type_usage = state.excluded_atomic_type_usage,
+        .excluded_atomic_path_usage = state.excluded_atomic_path_usage,
+        .is_excluded = true,
+    };
+    getLocalFieldsRecursive(config, excluded_field, &excluded_state);
+}
+
 fn addLocalField(field: *const LocalField, state: *const GetLocalFieldsState) void {
     if (state.fields_len.* >= state.fields_buffer.len) {
         @compileError("Maximum number of fields exceeded.");
@@ -1365,6 +4050,807 @@ test "loadRecording should load the same recording that saveRecording saved when
     }
 }
 
+test "loadRecording should load the same recording that saveRecording saved when using predictive codec" {
+    const Frame = struct {
+        bool: bool = false,
+        u8: u8 = 0,
+        u64: u64 = 0,
+        i16: i16 = 0,
+        i64: i64 = 0,
+        f16: f16 = 0,
+        f32: f32 = 0,
+        f64: f64 = 0,
+        optional: ?f32 = 0,
+        @"enum": enum { a, b } = .a,
+        packed_struct: packed struct { a: u18 = 0, b: u14 = 0 } = .{},
+        array: [2]f32 = .{ 0, 0 },
+        tagged_union: union(enum) { i: i32, f: f32 } = .{ .i = 0 },
+    };
+    var saved_recording: [64]Frame = undefined;
+    for (&saved_recording, 0..) |*frame, index| {
+        const i: i64 = @intCast(index);
+        const f: f32 = @floatFromInt(index);
+        frame.* = .{
+            .bool = index % 3 == 0,
+            .u8 = @intCast(index * 3 % 256),
+            .u64 = std.math.maxInt(u64) - index,
+            .i16 = @intCast(100 - 7 * i),
+            .i64 = std.math.minInt(i64) + i * i,
+            .f16 = @floatCast(0.5 * f),
+            .f32 = @sin(0.1 * f),
+            .f64 = -1000.0 + @as(f64, @floatCast(f)) * 0.001,
+            .optional = if (index % 5 == 0) null else f,
+            .@"enum" = if (index % 2 == 0) .a else .b,
+            .packed_struct = .{ .a = @intCast(index), .b = @intCast(64 - index) },
+            .array = .{ f, -f },
+            .tagged_union = if (index % 4 == 0) .{ .i = @intCast(-i) } else .{ .f = f },
+        };
+    }
+    try saveRecording(Frame, testing.allocator, &saved_recording, "./test_assets/recording.irony", &.{
+        .codec = .predictive,
+    });
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    const loaded_recording = try loadRecording(Frame, testing.allocator, "./test_assets/recording.irony", &.{});
+    defer testing.allocator.free(loaded_recording);
+    try testing.expectEqualSlices(Frame, &saved_recording, loaded_recording);
+}
+
+test "loadRecording should skip unknown fields when using predictive codec" {
+    const SavedFrame = struct { a: f32 = -1, b: ?u16 = null, c: f64 = -2 };
+    const LoadedFrame = struct { a: f32 = -3, c: f64 = -4 };
+    try saveRecording(SavedFrame, testing.allocator, &.{
+        .{ .a = 1, .b = 2, .c = 3 },
+        .{ .a = 4, .b = null, .c = 3 },
+        .{ .a = 4, .b = 5, .c = 6 },
+    }, "./test_assets/recording.irony", &.{ .codec = .predictive });
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    const recording = try loadRecording(LoadedFrame, testing.allocator, "./test_assets/recording.irony", &.{});
+    defer testing.allocator.free(recording);
+    try testing.expectEqualSlices(LoadedFrame, &.{
+        .{ .a = 1, .c = 3 },
+        .{ .a = 4, .c = 3 },
+        .{ .a = 4, .c = 6 },
+    }, recording);
+}
+
+test "saveRecording should produce smaller files with predictive codec when values change smoothly" {
+    const Frame = struct { position: [3]f32 = .{ 0, 0, 0 }, counter: u32 = 0 };
+    var recording: [1000]Frame = undefined;
+    for (&recording, 0..) |*frame, index| {
+        const t: f32 = @floatFromInt(index);
+        frame.* = .{
+            .position = .{ 100 * @cos(0.01 * t), 100 * @sin(0.01 * t), 0.5 * t },
+            .counter = @intCast(index),
+        };
+    }
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    try saveRecording(Frame, testing.allocator, &recording, "./test_assets/recording.irony", &.{ .codec = .raw });
+    const raw_size = (try std.fs.cwd().statFile("./test_assets/recording.irony")).size;
+    try saveRecording(Frame, testing.allocator, &recording, "./test_assets/recording.irony", &.{
+        .codec = .predictive,
+    });
+    const predictive_size = (try std.fs.cwd().statFile("./test_assets/recording.irony")).size;
+    try testing.expect(predictive_size < raw_size);
+}
+
+const QuantizedTestFrame = struct {
+    position: [3]f32 = .{ 0, 0, 0 },
+    rotation: ?f32 = null,
+    counter: u32 = 0,
+};
+const quantized_test_paths = [_]QuantizedPath{
+    .{ .pattern = "position", .precision = 0.01 },
+    .{ .pattern = "rotation", .precision = 0.001 },
+};
+
+fn getQuantizedTestFrames(comptime len: usize) [len]QuantizedTestFrame {
+    var frames: [len]QuantizedTestFrame = undefined;
+    var random = std.Random.DefaultPrng.init(0);
+    for (&frames, 0..) |*frame, index| {
+        const t: f32 = @floatFromInt(index);
+        const noise = random.random().float(f32) - 0.5;
+        frame.* = .{
+            .position = .{ 100 * @cos(0.01 * t) + noise, 100 * @sin(0.01 * t) - noise, 0.5 * t },
+            .rotation = if (index % 7 == 0) null else std.math.pi * @sin(0.003 * t) + 0.01 * noise,
+            .counter = @intCast(index),
+        };
+    }
+    return frames;
+}
+
+fn expectWithinPrecision(expected: f32, actual: f32, precision: f64) !void {
+    // Besides the quantization step, the restored value is rounded to the nearest float.
+    const tolerance = precision / 2 + @abs(expected) * std.math.floatEps(f32);
+    try testing.expect(@abs(@as(f64, actual) - @as(f64, expected)) <= tolerance);
+}
+
+fn expectQuantizedTestFrames(expected: []const QuantizedTestFrame, actual: []const QuantizedTestFrame) !void {
+    try testing.expectEqual(expected.len, actual.len);
+    for (expected, actual) |*expected_frame, *actual_frame| {
+        for (expected_frame.position, actual_frame.position) |expected_value, actual_value| {
+            try expectWithinPrecision(expected_value, actual_value, quantized_test_paths[0].precision);
+        }
+        if (expected_frame.rotation) |expected_value| {
+            const actual_value = actual_frame.rotation orelse return error.TestExpectedEqual;
+            try expectWithinPrecision(expected_value, actual_value, quantized_test_paths[1].precision);
+        } else {
+            try testing.expectEqual(null, actual_frame.rotation);
+        }
+        try testing.expectEqual(expected_frame.counter, actual_frame.counter);
+    }
+}
+
+test "getLocalFields should apply precision of quantized paths to all fields under them" {
+    const Frame = struct { a: struct { b: f32 = 0, c: ?f64 = null } = .{}, d: f32 = 0 };
+    const fields = getLocalFields(Frame, &.{ .quantized_paths = &.{.{ .pattern = "a", .precision = 0.5 }} });
+    inline for (fields) |*field| {
+        const expected: ?Precision = if (std.mem.startsWith(u8, field.path, "a.")) 0.5 else null;
+        try testing.expectEqual(expected, field.precision);
+    }
+}
+
+test "loadRecording should restore quantized fields within half of the precision" {
+    const saved_recording = getQuantizedTestFrames(300);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    inline for (.{ RecordingCodec.raw, RecordingCodec.predictive }) |codec| {
+        const config = RecordingConfig{ .codec = codec, .quantized_paths = &quantized_test_paths };
+        const path = "./test_assets/recording.irony";
+        try saveRecording(QuantizedTestFrame, testing.allocator, &saved_recording, path, &config);
+        // Precision is stored inside the file, so the recording can be loaded without knowing it.
+        const loaded_recording = try loadRecording(QuantizedTestFrame, testing.allocator, path, &.{ .codec = codec });
+        defer testing.allocator.free(loaded_recording);
+        try expectQuantizedTestFrames(&saved_recording, loaded_recording);
+    }
+}
+
+test "loadRecording should saturate quantized values that do not fit" {
+    const Frame = struct { a: f32 = 0, b: f32 = 0 };
+    const config = RecordingConfig{ .quantized_paths = &.{.{ .pattern = "?", .precision = 1 }} };
+    const max: f32 = @floatFromInt(std.math.maxInt(i32));
+    const min: f32 = @floatFromInt(std.math.minInt(i32));
+    try saveRecording(Frame, testing.allocator, &.{
+        .{ .a = 1e30, .b = -1e30 },
+        .{ .a = std.math.nan(f32), .b = 2.4 },
+    }, "./test_assets/recording.irony", &config);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    const recording = try loadRecording(Frame, testing.allocator, "./test_assets/recording.irony", &config);
+    defer testing.allocator.free(recording);
+    try testing.expectEqualSlices(Frame, &.{ .{ .a = max, .b = min }, .{ .a = 0, .b = 2 } }, recording);
+}
+
+test "saveRecording should produce smaller files when floats are quantized" {
+    const saved_recording = getQuantizedTestFrames(1000);
+    const path = "./test_assets/recording.irony";
+    defer std.fs.cwd().deleteFile(path) catch @panic("Failed to cleanup test file.");
+    inline for (.{ RecordingCodec.raw, RecordingCodec.predictive }) |codec| {
+        try saveRecording(QuantizedTestFrame, testing.allocator, &saved_recording, path, &.{ .codec = codec });
+        const exact_size = (try std.fs.cwd().statFile(path)).size;
+        try saveRecording(QuantizedTestFrame, testing.allocator, &saved_recording, path, &.{
+            .codec = codec,
+            .quantized_paths = &quantized_test_paths,
+        });
+        const quantized_size = (try std.fs.cwd().statFile(path)).size;
+        try testing.expect(quantized_size < exact_size);
+    }
+}
+
+test "trimRecording should keep precision of quantized recordings" {
+    const config = RecordingConfig{
+        .codec = .predictive,
+        .frames_per_chunk = 40,
+        .quantized_paths = &quantized_test_paths,
+    };
+    const saved_recording = getQuantizedTestFrames(200);
+    const path = "./test_assets/recording.irony";
+    try saveRecording(QuantizedTestFrame, testing.allocator, &saved_recording, path, &config);
+    defer std.fs.cwd().deleteFile(path) catch @panic("Failed to cleanup test file.");
+    const trimmed_path = "./test_assets/trimmed.irony";
+    try trimRecording(QuantizedTestFrame, testing.allocator, path, trimmed_path, 30, 170, &config);
+    defer std.fs.cwd().deleteFile(trimmed_path) catch @panic("Failed to cleanup test file.");
+    const loaded_recording = try loadRecording(QuantizedTestFrame, testing.allocator, trimmed_path, &config);
+    defer testing.allocator.free(loaded_recording);
+    try expectQuantizedTestFrames(saved_recording[30..170], loaded_recording);
+    // Exact field list doesn't match the quantized one, so quantized chunks can't be copied into exact recordings.
+    try testing.expectError(error.FieldListMismatch, trimRecording(
+        QuantizedTestFrame,
+        testing.allocator,
+        path,
+        trimmed_path,
+        30,
+        170,
+        &.{ .codec = .predictive, .frames_per_chunk = 40 },
+    ));
+}
+
+test "loadRecording should load recordings that were saved before the header was introduced" {
+    const Frame = struct { a: f32 = 0, b: ?u8 = null };
+    const saved_recording = [_]Frame{
+        .{ .a = 1, .b = null },
+        .{ .a = 2, .b = 3 },
+        .{ .a = 2, .b = 4 },
+    };
+    {
+        const file = try std.fs.cwd().createFile("./test_assets/recording.irony", .{});
+        defer file.close();
+        var file_buffer: [buffer_size]u8 = undefined;
+        var file_writer = file.writer(&file_buffer);
+        try file_writer.interface.writeAll(magic_number);
+        try file_writer.interface.writeInt(VersionNumber, 1, endian);
+        var encoder = try io.XzEncoder.init(testing.allocator, &file_writer.interface);
+        defer encoder.deinit();
+        var encoded_buffer: [buffer_size]u8 = undefined;
+        var encoder_writer = encoder.writer(&encoded_buffer);
+        var byte_writer = io.ByteWriter{ .dest_writer = &encoder_writer, .endian = endian };
+        const fields = getLocalFields(Frame, &.{});
+        try writeFieldList(&byte_writer, fields, .raw, 1);
+        try writeFrames(Frame, &byte_writer, &saved_recording, fields);
+        try byte_writer.flush();
+        try file_writer.end();
+    }
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    const loaded_recording = try loadRecording(Frame, testing.allocator, "./test_assets/recording.irony", &.{});
+    defer testing.allocator.free(loaded_recording);
+    try testing.expectEqualSlices(Frame, &saved_recording, loaded_recording);
+}
+
+test "loadRecording should load recordings that span multiple chunks" {
+    const Frame = struct { a: f32 = 0, b: ?u8 = null };
+    var saved_recording: [10]Frame = undefined;
+    for (&saved_recording, 0..) |*frame, index| {
+        frame.* = .{ .a = @floatFromInt(index), .b = if (index % 3 == 0) null else @intCast(index) };
+    }
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    inline for (.{ RecordingCodec.raw, RecordingCodec.predictive }) |codec| {
+        const config = RecordingConfig{ .codec = codec, .frames_per_chunk = 3 };
+        try saveRecording(Frame, testing.allocator, &saved_recording, "./test_assets/recording.irony", &config);
+        const loaded_recording = try loadRecording(Frame, testing.allocator, "./test_assets/recording.irony", &config);
+        defer testing.allocator.free(loaded_recording);
+        try testing.expectEqualSlices(Frame, &saved_recording, loaded_recording);
+    }
+}
+
+test "loadRecordingChunks should pass frames to the callback one chunk at a time" {
+    const Frame = struct { a: f32 = 0, b: ?u8 = null };
+    var saved_recording: [10]Frame = undefined;
+    for (&saved_recording, 0..) |*frame, index| {
+        frame.* = .{ .a = @floatFromInt(index), .b = if (index % 3 == 0) null else @intCast(index) };
+    }
+    const config = RecordingConfig{ .frames_per_chunk = 4 };
+    try saveRecording(Frame, testing.allocator, &saved_recording, "./test_assets/recording.irony", &config);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+
+    const Context = struct {
+        frames: std.ArrayList(Frame) = .empty,
+        chunk_sizes: std.ArrayList(usize) = .empty,
+
+        fn onChunk(self: *@This(), frames: []const Frame) anyerror!void {
+            try self.frames.appendSlice(testing.allocator, frames);
+            try self.chunk_sizes.append(testing.allocator, frames.len);
+        }
+    };
+    var context = Context{};
+    defer context.frames.deinit(testing.allocator);
+    defer context.chunk_sizes.deinit(testing.allocator);
+    try loadRecordingChunks(
+        Frame,
+        testing.allocator,
+        "./test_assets/recording.irony",
+        &config,
+        &context,
+        Context.onChunk,
+    );
+    try testing.expectEqualSlices(usize, &.{ 4, 4, 2 }, context.chunk_sizes.items);
+    try testing.expectEqualSlices(Frame, &saved_recording, context.frames.items);
+}
+
+test "getLocalFields should leave out excluded paths and everything under them" {
+    const Frame = struct {
+        a: struct { b: f32 = 0, c: ?f64 = null } = .{},
+        d: [2]struct { e: u8 = 0, f: u8 = 0 } = .{},
+    };
+    const fields = getLocalFields(Frame, &.{ .excluded_paths = &.{ "a.c", "d.?.f" } });
+    try testing.expectEqual(3, fields.len);
+    try testing.expectEqualStrings("a.b", fields[0].path);
+    try testing.expectEqualStrings("d.0.e", fields[1].path);
+    try testing.expectEqualStrings("d.1.e", fields[2].path);
+}
+
+test "getLocalFields should allow atomic types and paths that match only excluded fields" {
+    const Atomic = struct { x: u8 = 0, y: u8 = 0 };
+    const Frame = struct {
+        a: struct { b: Atomic = .{}, c: [2]u8 = .{ 0, 0 } } = .{},
+        d: u32 = 0,
+    };
+    const fields = getLocalFields(Frame, &.{
+        .atomic_types = &.{Atomic},
+        .atomic_paths = &.{"a.c"},
+        .excluded_paths = &.{"a"},
+    });
+    try testing.expectEqual(1, fields.len);
+    try testing.expectEqualStrings("d", fields[0].path);
+}
+
+test "loadRecording should fill excluded fields with default values" {
+    const Frame = struct { a: u32 = 0, b: ?f32 = null, c: [2]i16 = .{ -1, -1 } };
+    const config = RecordingConfig{ .excluded_paths = &.{ "b", "c" }, .profile = "slim" };
+    try saveRecording(Frame, testing.allocator, &.{
+        .{ .a = 1, .b = 2, .c = .{ 3, 4 } },
+        .{ .a = 5, .b = null, .c = .{ 6, 7 } },
+    }, "./test_assets/recording.irony", &config);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    // Readers don't have to know the profile, since the excluded fields are missing from the field list.
+    const recording = try loadRecording(Frame, testing.allocator, "./test_assets/recording.irony", &.{});
+    defer testing.allocator.free(recording);
+    try testing.expectEqualSlices(Frame, &.{ .{ .a = 1 }, .{ .a = 5 } }, recording);
+    const info = try loadRecordingInfo("./test_assets/recording.irony");
+    const profile = &(info.profile orelse return error.MissingProfile);
+    try testing.expectEqualStrings("slim", profile.get());
+}
+
+test "saveRecording should produce smaller files when paths are excluded" {
+    const saved_recording = getQuantizedTestFrames(1000);
+    const path = "./test_assets/recording.irony";
+    defer std.fs.cwd().deleteFile(path) catch @panic("Failed to cleanup test file.");
+    try saveRecording(QuantizedTestFrame, testing.allocator, &saved_recording, path, &.{});
+    const full_size = (try std.fs.cwd().statFile(path)).size;
+    try testing.expectEqual(null, (try loadRecordingInfo(path)).profile);
+    const config = RecordingConfig{ .excluded_paths = &.{ "position", "rotation" }, .profile = "counter" };
+    try saveRecording(QuantizedTestFrame, testing.allocator, &saved_recording, path, &config);
+    const slim_size = (try std.fs.cwd().statFile(path)).size;
+    try testing.expect(slim_size < full_size);
+}
+
+const SplicedTestFrame = struct { a: u32 = 0, b: f32 = 0 };
+
+fn getSplicedTestFrames(comptime len: usize) [len]SplicedTestFrame {
+    var frames: [len]SplicedTestFrame = undefined;
+    for (&frames, 0..) |*frame, index| {
+        const t: f32 = @floatFromInt(index);
+        frame.* = .{ .a = @intCast(index), .b = @sin(0.1 * t) };
+    }
+    return frames;
+}
+
+test "trimRecording should keep only the frames inside the range" {
+    const config = RecordingConfig{ .codec = .predictive, .frames_per_chunk = 4 };
+    const Frame = SplicedTestFrame;
+    const saved_recording = getSplicedTestFrames(20);
+    try saveRecording(Frame, testing.allocator, &saved_recording, "./test_assets/recording.irony", &config);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    try trimRecording(
+        Frame,
+        testing.allocator,
+        "./test_assets/recording.irony",
+        "./test_assets/trimmed.irony",
+        3,
+        13,
+        &config,
+    );
+    defer std.fs.cwd().deleteFile("./test_assets/trimmed.irony") catch @panic("Failed to cleanup test file.");
+    const loaded_recording = try loadRecording(Frame, testing.allocator, "./test_assets/trimmed.irony", &config);
+    defer testing.allocator.free(loaded_recording);
+    try testing.expectEqualSlices(Frame, saved_recording[3..13], loaded_recording);
+}
+
+test "trimRecording should copy the whole recording byte for byte when range covers all frames" {
+    const config = RecordingConfig{ .codec = .raw, .frames_per_chunk = 4 };
+    const Frame = SplicedTestFrame;
+    const saved_recording = getSplicedTestFrames(20);
+    try saveRecording(Frame, testing.allocator, &saved_recording, "./test_assets/recording.irony", &config);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    try trimRecording(
+        Frame,
+        testing.allocator,
+        "./test_assets/recording.irony",
+        "./test_assets/trimmed.irony",
+        0,
+        saved_recording.len,
+        &config,
+    );
+    defer std.fs.cwd().deleteFile("./test_assets/trimmed.irony") catch @panic("Failed to cleanup test file.");
+    const max_size = 1024 * 1024;
+    const original = try std.fs.cwd().readFileAlloc(testing.allocator, "./test_assets/recording.irony", max_size);
+    defer testing.allocator.free(original);
+    const trimmed = try std.fs.cwd().readFileAlloc(testing.allocator, "./test_assets/trimmed.irony", max_size);
+    defer testing.allocator.free(trimmed);
+    try testing.expectEqualSlices(u8, original, trimmed);
+}
+
+test "deleteRecordingRange should remove the frames inside the range even when editing the file in place" {
+    const config = RecordingConfig{ .codec = .predictive, .frames_per_chunk = 4 };
+    const Frame = SplicedTestFrame;
+    const saved_recording = getSplicedTestFrames(20);
+    try saveRecording(Frame, testing.allocator, &saved_recording, "./test_assets/recording.irony", &config);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    try deleteRecordingRange(
+        Frame,
+        testing.allocator,
+        "./test_assets/recording.irony",
+        "./test_assets/recording.irony",
+        6,
+        15,
+        &config,
+    );
+    const loaded_recording = try loadRecording(Frame, testing.allocator, "./test_assets/recording.irony", &config);
+    defer testing.allocator.free(loaded_recording);
+    try testing.expectEqual(11, loaded_recording.len);
+    try testing.expectEqualSlices(Frame, saved_recording[0..6], loaded_recording[0..6]);
+    try testing.expectEqualSlices(Frame, saved_recording[15..20], loaded_recording[6..11]);
+}
+
+test "concatenateRecordings should join the recordings one after another" {
+    const config = RecordingConfig{ .codec = .raw, .frames_per_chunk = 4 };
+    const Frame = SplicedTestFrame;
+    const saved_recording = getSplicedTestFrames(20);
+    try saveRecording(Frame, testing.allocator, saved_recording[0..7], "./test_assets/recording_1.irony", &config);
+    defer std.fs.cwd().deleteFile("./test_assets/recording_1.irony") catch @panic("Failed to cleanup test file.");
+    try saveRecording(Frame, testing.allocator, saved_recording[7..20], "./test_assets/recording_2.irony", &config);
+    defer std.fs.cwd().deleteFile("./test_assets/recording_2.irony") catch @panic("Failed to cleanup test file.");
+    try concatenateRecordings(
+        Frame,
+        testing.allocator,
+        &.{ "./test_assets/recording_1.irony", "./test_assets/recording_2.irony" },
+        "./test_assets/recording.irony",
+        &config,
+    );
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    const loaded_recording = try loadRecording(Frame, testing.allocator, "./test_assets/recording.irony", &config);
+    defer testing.allocator.free(loaded_recording);
+    try testing.expectEqualSlices(Frame, &saved_recording, loaded_recording);
+}
+
+test "spliceRecordings should fail and leave the destination untouched when sources are incompatible" {
+    const Frame = struct { a: u32 = 0 };
+    const OtherFrame = struct { b: u32 = 0 };
+    try saveRecording(Frame, testing.allocator, &.{ .{ .a = 1 }, .{ .a = 2 } }, "./test_assets/recording.irony", &.{});
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    try testing.expectError(error.CodecMismatch, trimRecording(
+        Frame,
+        testing.allocator,
+        "./test_assets/recording.irony",
+        "./test_assets/recording.irony",
+        0,
+        1,
+        &.{ .codec = .predictive },
+    ));
+    try testing.expectError(error.FieldListMismatch, trimRecording(
+        OtherFrame,
+        testing.allocator,
+        "./test_assets/recording.irony",
+        "./test_assets/recording.irony",
+        0,
+        1,
+        &.{},
+    ));
+    try testing.expectError(error.OutOfBounds, trimRecording(
+        Frame,
+        testing.allocator,
+        "./test_assets/recording.irony",
+        "./test_assets/recording.irony",
+        1,
+        3,
+        &.{},
+    ));
+    const recording = try loadRecording(Frame, testing.allocator, "./test_assets/recording.irony", &.{});
+    defer testing.allocator.free(recording);
+    try testing.expectEqualSlices(Frame, &.{ .{ .a = 1 }, .{ .a = 2 } }, recording);
+}
+
+var test_dictionary = RecordingDictionary{};
+
+test "loadRecording should load the same recording that saveRecording saved with a dictionary" {
+    const config = RecordingConfig{ .codec = .predictive, .frames_per_chunk = 4, .dictionaries = &.{&test_dictionary} };
+    const saved_recording = getSplicedTestFrames(20);
+    const path = "./test_assets/recording.irony";
+    try saveRecording(SplicedTestFrame, testing.allocator, &saved_recording, path, &config);
+    defer std.fs.cwd().deleteFile(path) catch @panic("Failed to cleanup test file.");
+    try testing.expectEqual(null, (try loadRecordingInfo(path)).dictionary_id);
+
+    const dictionary = try trainRecordingDictionary(SplicedTestFrame, testing.allocator, &.{path}, 4096, &config);
+    defer testing.allocator.free(dictionary);
+    test_dictionary = .{ .bytes = dictionary };
+    defer test_dictionary = .{};
+    try saveRecording(SplicedTestFrame, testing.allocator, &saved_recording, path, &config);
+    const info = try loadRecordingInfo(path);
+    try testing.expectEqual(test_dictionary.getId(), info.dictionary_id orelse return error.MissingDictionary);
+    const loaded_recording = try loadRecording(SplicedTestFrame, testing.allocator, path, &config);
+    defer testing.allocator.free(loaded_recording);
+    try testing.expectEqualSlices(SplicedTestFrame, &saved_recording, loaded_recording);
+
+    try trimRecording(SplicedTestFrame, testing.allocator, path, path, 3, 13, &config);
+    const trimmed_recording = try loadRecording(SplicedTestFrame, testing.allocator, path, &config);
+    defer testing.allocator.free(trimmed_recording);
+    try testing.expectEqualSlices(SplicedTestFrame, saved_recording[3..13], trimmed_recording);
+}
+
+test "trainRecordingDictionary should sample the start of every chunk" {
+    const config = RecordingConfig{ .codec = .predictive, .frames_per_chunk = 4 };
+    const saved_recording = getSplicedTestFrames(12);
+    const path = "./test_assets/recording.irony";
+    try saveRecording(SplicedTestFrame, testing.allocator, &saved_recording, path, &config);
+    defer std.fs.cwd().deleteFile(path) catch @panic("Failed to cleanup test file.");
+
+    const dictionary = try trainRecordingDictionary(SplicedTestFrame, testing.allocator, &.{path}, 4096, &config);
+    defer testing.allocator.free(dictionary);
+    const fields = getLocalFields(SplicedTestFrame, &config);
+    for (0..3) |chunk_index| {
+        var bytes_writer = std.io.Writer.Allocating.init(testing.allocator);
+        defer bytes_writer.deinit();
+        const chunk_frames = saved_recording[(4 * chunk_index)..(4 * chunk_index + 4)];
+        const writer = &bytes_writer.writer;
+        try writeStreamFrames(SplicedTestFrame, testing.allocator, writer, chunk_frames, fields, .predictive);
+        try testing.expect(std.mem.indexOf(u8, dictionary, bytes_writer.written()) != null);
+    }
+}
+
+test "loadRecording should fail when recording was saved with a unknown dictionary" {
+    const config = RecordingConfig{ .dictionaries = &.{&test_dictionary} };
+    test_dictionary = .{ .bytes = "a: 1, b: 0.5, a: 2, b: 0.25" };
+    defer test_dictionary = .{};
+    const saved_recording = getSplicedTestFrames(5);
+    const path = "./test_assets/recording.irony";
+    try saveRecording(SplicedTestFrame, testing.allocator, &saved_recording, path, &config);
+    defer std.fs.cwd().deleteFile(path) catch @panic("Failed to cleanup test file.");
+    try testing.expectError(error.UnknownDictionary, loadRecording(SplicedTestFrame, testing.allocator, path, &.{}));
+    try testing.expectError(error.DictionaryMismatch, trimRecording(
+        SplicedTestFrame,
+        testing.allocator,
+        path,
+        path,
+        0,
+        1,
+        &.{},
+    ));
+    const loaded_recording = try loadRecording(SplicedTestFrame, testing.allocator, path, &config);
+    defer testing.allocator.free(loaded_recording);
+    try testing.expectEqualSlices(SplicedTestFrame, &saved_recording, loaded_recording);
+}
+
+test "saveRecording should produce smaller short recordings with a trained dictionary" {
+    const config = RecordingConfig{ .dictionaries = &.{&test_dictionary} };
+    const corpus_recording = getQuantizedTestFrames(1000);
+    const corpus_path = "./test_assets/corpus.irony";
+    try saveRecording(QuantizedTestFrame, testing.allocator, &corpus_recording, corpus_path, &config);
+    defer std.fs.cwd().deleteFile(corpus_path) catch @panic("Failed to cleanup test file.");
+    const path = "./test_assets/recording.irony";
+    try saveRecording(QuantizedTestFrame, testing.allocator, corpus_recording[0..60], path, &config);
+    defer std.fs.cwd().deleteFile(path) catch @panic("Failed to cleanup test file.");
+    const plain_size = (try std.fs.cwd().statFile(path)).size;
+
+    const dictionary = try trainRecordingDictionary(
+        QuantizedTestFrame,
+        testing.allocator,
+        &.{corpus_path},
+        RecordingDictionary.max_size,
+        &config,
+    );
+    defer testing.allocator.free(dictionary);
+    test_dictionary = .{ .bytes = dictionary };
+    defer test_dictionary = .{};
+    try saveRecording(QuantizedTestFrame, testing.allocator, corpus_recording[0..60], path, &config);
+    const dictionary_size = (try std.fs.cwd().statFile(path)).size;
+    try testing.expect(dictionary_size < plain_size);
+    const loaded_recording = try loadRecording(QuantizedTestFrame, testing.allocator, path, &config);
+    defer testing.allocator.free(loaded_recording);
+    try testing.expectEqualSlices(QuantizedTestFrame, corpus_recording[0..60], loaded_recording);
+}
+
+test "decompressBlock should fail when a block compressed with a dictionary is corrupted" {
+    const dictionary = "a: 1, b: 0.5, a: 2, b: 0.25";
+    const content = "a: 1, b: 0.5, a: 2, b: 0.25, a: 3, b: 0.125";
+    const block = try compressChunkBytes(testing.allocator, content, dictionary);
+    defer testing.allocator.free(block);
+    try testing.expect(!io.isXzStream(block));
+    const decompressed = try decompressBlock(testing.allocator, block, dictionary);
+    defer testing.allocator.free(decompressed);
+    try testing.expectEqualStrings(content, decompressed);
+
+    block[block.len - 1] ^= 0xFF;
+    try testing.expectError(error.ChecksumMismatch, decompressBlock(testing.allocator, block, dictionary));
+    block[block.len - 1] ^= 0xFF;
+
+    // Corrupted stream either fails to decode or decodes into different content, which the checksum catches.
+    block[block.len / 2] ^= 0xFF;
+    if (decompressBlock(testing.allocator, block, dictionary)) |corrupted| {
+        testing.allocator.free(corrupted);
+        return error.TestUnexpectedResult;
+    } else |_| {}
+    block[block.len / 2] ^= 0xFF;
+
+    try testing.expectError(error.MissingChecksum, decompressBlock(testing.allocator, block[0..3], dictionary));
+}
+
+const TestMetadataExtractor = struct {
+    pub fn isMarker(previous: ?*const SplicedTestFrame, current: *const SplicedTestFrame) bool {
+        _ = previous;
+        return current.a % 6 == 0;
+    }
+
+    pub fn getLabels(frame: *const SplicedTestFrame) [2]?u32 {
+        return .{ frame.a / 5, null };
+    }
+};
+
+test "loadRecordingInfo should read the metadata that saveRecording extracted from the frames" {
+    const config = RecordingConfig{ .frames_per_chunk = 4, .MetadataExtractor = TestMetadataExtractor };
+    const saved_recording = getSplicedTestFrames(20);
+    try saveRecording(SplicedTestFrame, testing.allocator, &saved_recording, "./test_assets/recording.irony", &config);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    const info = try loadRecordingInfo("./test_assets/recording.irony");
+    try testing.expectEqual(version_number, info.version);
+    try testing.expectEqual(RecordingCodec.raw, info.codec);
+    try testing.expectEqual(build_info.game, info.game);
+    try testing.expect(info.content_hash != null);
+    const metadata = &(info.metadata orelse return error.MissingMetadata);
+    try testing.expectEqual(20, metadata.number_of_frames);
+    try testing.expectEqualSlices(u32, &.{ 0, 6, 12, 18 }, metadata.getMarkers());
+    try testing.expectEqualSlices(u32, &.{ 0, 1, 2, 3 }, metadata.getLabels());
+}
+
+test "content hash should depend only on the recorded frames" {
+    const config = RecordingConfig{ .frames_per_chunk = 4 };
+    var saved_recording = getSplicedTestFrames(20);
+    const path = "./test_assets/recording.irony";
+    defer std.fs.cwd().deleteFile(path) catch @panic("Failed to cleanup test file.");
+    try saveRecording(SplicedTestFrame, testing.allocator, &saved_recording, path, &config);
+    const hash_1 = (try loadRecordingInfo(path)).content_hash;
+    saved_recording[10].b = 123;
+    try saveRecording(SplicedTestFrame, testing.allocator, &saved_recording, path, &config);
+    const hash_2 = (try loadRecordingInfo(path)).content_hash;
+    saved_recording[10] = getSplicedTestFrames(20)[10];
+    try saveRecording(SplicedTestFrame, testing.allocator, &saved_recording, path, &config);
+    const hash_3 = (try loadRecordingInfo(path)).content_hash;
+    try testing.expect(hash_1 != hash_2);
+    try testing.expectEqual(hash_1, hash_3);
+}
+
+test "spliceRecordings should assemble the metadata from the metadata of the sources" {
+    const config = RecordingConfig{ .frames_per_chunk = 4, .MetadataExtractor = TestMetadataExtractor };
+    const saved_recording = getSplicedTestFrames(20);
+    try saveRecording(SplicedTestFrame, testing.allocator, &saved_recording, "./test_assets/recording.irony", &config);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+    try spliceRecordings(
+        SplicedTestFrame,
+        testing.allocator,
+        &.{
+            .{ .file_path = "./test_assets/recording.irony", .start = 5, .end = 15 },
+            .{ .file_path = "./test_assets/recording.irony", .start = 17 },
+        },
+        "./test_assets/spliced.irony",
+        &config,
+    );
+    defer std.fs.cwd().deleteFile("./test_assets/spliced.irony") catch @panic("Failed to cleanup test file.");
+    const info = try loadRecordingInfo("./test_assets/spliced.irony");
+    const metadata = &(info.metadata orelse return error.MissingMetadata);
+    try testing.expectEqual(13, metadata.number_of_frames);
+    try testing.expectEqualSlices(u32, &.{ 1, 7, 11 }, metadata.getMarkers());
+    try testing.expectEqualSlices(u32, &.{ 0, 1, 2, 3 }, metadata.getLabels());
+}
+
+fn createTestLibrary() !void {
+    std.fs.cwd().makePath("./test_assets/library") catch {};
+    try io.ChunkStore.create("./test_assets/library");
+}
+
+fn deleteTestLibrary() void {
+    std.fs.cwd().deleteTree("./test_assets/library") catch @panic("Failed to cleanup test directory.");
+}
+
+test "saveRecording should store the chunks shared by near duplicate recordings only once" {
+    const config = RecordingConfig{ .codec = .predictive, .frames_per_chunk = 8 };
+    const Frame = SplicedTestFrame;
+    const saved_recording = getSplicedTestFrames(200);
+    var edited_recording: [201]Frame = undefined;
+    @memcpy(edited_recording[0..100], saved_recording[0..100]);
+    edited_recording[100] = .{ .a = 12345, .b = 1 };
+    @memcpy(edited_recording[101..201], saved_recording[100..200]);
+
+    try createTestLibrary();
+    defer deleteTestLibrary();
+    const path_1 = "./test_assets/library/recording_1.irony";
+    const path_2 = "./test_assets/library/recording_2.irony";
+    try saveRecording(Frame, testing.allocator, &saved_recording, path_1, &config);
+    try saveRecording(Frame, testing.allocator, &edited_recording, path_2, &config);
+
+    const loaded_recording_1 = try loadRecording(Frame, testing.allocator, path_1, &config);
+    defer testing.allocator.free(loaded_recording_1);
+    try testing.expectEqualSlices(Frame, &saved_recording, loaded_recording_1);
+    const loaded_recording_2 = try loadRecording(Frame, testing.allocator, path_2, &config);
+    defer testing.allocator.free(loaded_recording_2);
+    try testing.expectEqualSlices(Frame, &edited_recording, loaded_recording_2);
+
+    const references_1 = try loadRecordingChunkReferences(testing.allocator, path_1);
+    defer testing.allocator.free(references_1);
+    const references_2 = try loadRecordingChunkReferences(testing.allocator, path_2);
+    defer testing.allocator.free(references_2);
+    try testing.expect(references_1.len > 10);
+    var number_of_shared: usize = 0;
+    for (references_2) |*hash_2| {
+        for (references_1) |*hash_1| {
+            if (std.mem.eql(u8, hash_1, hash_2)) {
+                number_of_shared += 1;
+                break;
+            }
+        }
+    }
+    try testing.expect(references_2.len - number_of_shared <= 3);
+}
+
+test "saveRecording should release the chunks of the recording it overwrites" {
+    const config = RecordingConfig{ .codec = .raw, .frames_per_chunk = 4 };
+    const Frame = SplicedTestFrame;
+    const saved_recording = getSplicedTestFrames(20);
+    try createTestLibrary();
+    defer deleteTestLibrary();
+    const path = "./test_assets/library/recording.irony";
+
+    try saveRecording(Frame, testing.allocator, saved_recording[0..10], path, &config);
+    const old_references = try loadRecordingChunkReferences(testing.allocator, path);
+    defer testing.allocator.free(old_references);
+    try saveRecording(Frame, testing.allocator, saved_recording[10..20], path, &config);
+    const loaded_recording = try loadRecording(Frame, testing.allocator, path, &config);
+    defer testing.allocator.free(loaded_recording);
+    try testing.expectEqualSlices(Frame, saved_recording[10..20], loaded_recording);
+
+    var store = (try io.ChunkStore.openForRecording(path)).?;
+    defer store.close();
+    for (old_references) |*hash| {
+        try testing.expect(!store.contains(hash));
+    }
+}
+
+test "trimRecording should reference the chunks of the source when both are inside the same library" {
+    const config = RecordingConfig{ .codec = .predictive, .frames_per_chunk = 4 };
+    const Frame = SplicedTestFrame;
+    const saved_recording = getSplicedTestFrames(40);
+    try createTestLibrary();
+    defer deleteTestLibrary();
+    const path = "./test_assets/library/recording.irony";
+    const trimmed_path = "./test_assets/library/trimmed.irony";
+
+    try saveRecording(Frame, testing.allocator, &saved_recording, path, &config);
+    try trimRecording(Frame, testing.allocator, path, trimmed_path, 0, saved_recording.len, &config);
+    const references = try loadRecordingChunkReferences(testing.allocator, path);
+    defer testing.allocator.free(references);
+    const trimmed_references = try loadRecordingChunkReferences(testing.allocator, trimmed_path);
+    defer testing.allocator.free(trimmed_references);
+    try testing.expectEqualSlices(io.ChunkHash, references, trimmed_references);
+
+    try trimRecording(Frame, testing.allocator, path, trimmed_path, 5, 35, &config);
+    const loaded_recording = try loadRecording(Frame, testing.allocator, trimmed_path, &config);
+    defer testing.allocator.free(loaded_recording);
+    try testing.expectEqualSlices(Frame, saved_recording[5..35], loaded_recording);
+}
+
+test "RecordingMetadata should keep labels sorted and unique" {
+    var metadata = RecordingMetadata{};
+    for ([_]u32{ 5, 1, 3, 5, 1, 0, 7 }) |label| {
+        metadata.addLabel(label);
+    }
+    try testing.expectEqualSlices(u32, &.{ 0, 1, 3, 5, 7 }, metadata.getLabels());
+}
+
+test "serializedLayoutOf should describe the scalars written by writeValue" {
+    const Type = struct {
+        a: u8,
+        b: u8,
+        c: f32,
+        d: ?f32,
+        e: [2]f64,
+        f: u128,
+        g: union(enum(u8)) { x: u32, y: u8 },
+    };
+    try testing.expectEqualSlices(LayoutRun, &.{
+        .{ .kind = .int, .size = 1, .count = 2 },
+        .{ .kind = .float, .size = 4, .count = 1 },
+        .{ .kind = .int, .size = 1, .count = 1 },
+        .{ .kind = .float, .size = 4, .count = 1 },
+        .{ .kind = .float, .size = 8, .count = 2 },
+        .{ .kind = .int, .size = 1, .count = 21 },
+    }, serializedLayoutOf(Type));
+    try testing.expectEqual(serializedSizeOf(Type), io.getPredictiveLayoutSize(serializedLayoutOf(Type)));
+}
+
 test "should correctly match paths with patterns" {
     try testing.expectEqual(true, doesPathMatchPattern("", ""));
     try testing.expectEqual(false, doesPathMatchPattern("", "a"));
@@ -1462,3 +4948,105 @@ test "should correctly atomically represent parts of the struct based on configu
     try testing.expectEqual(false, contains(fields, "f4.1.a"));
     try testing.expectEqual(false, contains(fields, "f4.1.b"));
 }
+
+test "containsNan should be true only for values that are unequal to themselves" {
+    const Value = struct {
+        a: f32 = 0,
+        b: [2]f64 = .{ 0, 0 },
+        c: ?f16 = null,
+        d: union(enum) { e: u8, f: f32 } = .{ .e = 0 },
+        g: packed struct { h: f32 = 0, i: u32 = 0 } = .{},
+    };
+    const values = [_]Value{
+        .{},
+        .{ .a = -0.0, .b = .{ std.math.inf(f64), -std.math.inf(f64) }, .c = std.math.floatMax(f16) },
+        .{ .a = std.math.floatMin(f32), .d = .{ .f = -std.math.inf(f32) }, .g = .{ .h = -1, .i = 0xFFFFFFFF } },
+        .{ .a = std.math.nan(f32) },
+        .{ .a = -std.math.nan(f32) },
+        .{ .b = .{ 0, std.math.nan(f64) } },
+        .{ .c = std.math.nan(f16) },
+        .{ .d = .{ .f = std.math.nan(f32) } },
+        .{ .g = .{ .h = std.math.nan(f32) } },
+    };
+    for (&values) |*value| {
+        try testing.expectEqual(!areValuesEqual(value.*, value.*), containsNan(value));
+    }
+    try testing.expectEqual(false, containsNan(&values[2]));
+    try testing.expectEqual(true, containsNan(&values[values.len - 1]));
+}
+
+test "findFieldChanges should ignore changes of quantized fields that are smaller than the precision" {
+    const fields = getLocalFields(QuantizedTestFrame, &.{ .quantized_paths = &quantized_test_paths });
+    const frame = QuantizedTestFrame{ .position = .{ 1, 2, 3 }, .rotation = 0.5, .counter = 1 };
+    const noisy_frame = QuantizedTestFrame{ .position = .{ 1.002, 1.997, 3 }, .rotation = 0.5002, .counter = 1 };
+    try testing.expectEqual(0, findFieldChanges(QuantizedTestFrame, &noisy_frame, &frame, fields).number_of_changes);
+    const nan_frame = QuantizedTestFrame{ .position = .{ 1, 2, 3 }, .rotation = std.math.nan(f32), .counter = 1 };
+    try testing.expectEqual(0, findFieldChanges(QuantizedTestFrame, &nan_frame, &nan_frame, fields).number_of_changes);
+
+    const moved_frame = QuantizedTestFrame{ .position = .{ 1.02, 2, 3 }, .rotation = 0.5, .counter = 1 };
+    const changes = findFieldChanges(QuantizedTestFrame, &moved_frame, &frame, fields);
+    try testing.expectEqual(1, changes.number_of_changes);
+    inline for (fields, 0..) |*field, index| {
+        const is_expected = comptime std.mem.eql(u8, field.path, "position.0");
+        try testing.expectEqual(is_expected, changes.field_changed[index]);
+    }
+}
+
+test "findFieldChanges should find the same changes as comparing every field by value" {
+    const Frame = struct {
+        a: u8 = 0,
+        b: f32 = 0,
+        c: ?struct { d: u8 = 0, e: f64 = 0 } = null,
+        f: union(enum) { g: u16, h: f32 } = .{ .g = 0 },
+        i: [3]f32 = .{ 0, 0, 0 },
+    };
+    const fields = getLocalFields(Frame, &.{});
+    const nan = std.math.nan(f32);
+    const frames = [_]Frame{
+        .{},
+        .{ .b = -0.0 },
+        .{ .b = nan, .i = .{ 0, nan, 0 } },
+        .{ .b = nan, .i = .{ 0, nan, 0 } },
+        .{ .a = 1, .c = .{ .d = 1 } },
+        .{ .a = 1, .c = .{ .d = 1, .e = 2 } },
+        .{ .f = .{ .h = 0 } },
+        .{ .f = .{ .h = 1 } },
+        .{ .f = .{ .g = 1 } },
+        .{ .c = .{ .e = std.math.nan(f64) } },
+        .{ .c = .{ .e = std.math.nan(f64) } },
+        .{ .f = .{ .h = nan } },
+        .{ .f = .{ .h = nan } },
+        .{},
+    };
+    const withGarbagePadding = struct {
+        fn call(frame: *const Frame, garbage: u8) Frame {
+            var copy: Frame = undefined;
+            @memset(std.mem.asBytes(&copy), garbage);
+            inline for (@typeInfo(Frame).@"struct".fields) |*field| {
+                @field(copy, field.name) = @field(frame, field.name);
+            }
+            return copy;
+        }
+    }.call;
+    for (frames[1..], frames[0..(frames.len - 1)]) |*current, *previous| {
+        const frame_1 = withGarbagePadding(current, 0xAA);
+        const frame_2 = withGarbagePadding(previous, 0x55);
+        var expected = Changes(fields.len){
+            .number_of_changes = 0,
+            .field_changed = [1]bool{false} ** fields.len,
+        };
+        inline for (fields, 0..) |*field, field_index| {
+            var ancestor_changed = false;
+            comptime var ancestor_index = field.parent_index;
+            inline while (ancestor_index != null) : (ancestor_index = fields[ancestor_index.?].parent_index) {
+                ancestor_changed = ancestor_changed or expected.field_changed[ancestor_index.?];
+            }
+            if (!ancestor_changed and isFieldChanged(&frame_1, &frame_2, field)) {
+                expected.field_changed[field_index] = true;
+                expected.number_of_changes += 1;
+            }
+        }
+        const actual = findFieldChanges(Frame, &frame_1, &frame_2, fields);
+        try testing.expectEqual(expected, actual);
+    }
+}
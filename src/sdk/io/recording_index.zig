@@ -0,0 +1,385 @@
+const std = @import("std");
+const build_info = @import("build_info");
+const misc = @import("../misc/root.zig");
+const io = @import("root.zig");
+
+// Persistent summary of all the recordings inside a directory. Only recordings that were added or modified since the
+// last refresh get their headers read, so keeping thousands of recordings listed costs one directory scan.
+pub const RecordingIndex = struct {
+    allocator: std.mem.Allocator,
+    entries: std.ArrayList(Entry),
+
+    const Self = @This();
+    pub const file_name = "index.json";
+    pub const Entry = struct {
+        file_name: []const u8,
+        modified_time: i128,
+        size: u64,
+        content_hash: ?u64 = null,
+        game: ?build_info.Game = null,
+        // Null when the header could not be read or the recording was saved by a version without metadata.
+        number_of_frames: ?u64 = null,
+        number_of_markers: usize = 0,
+        labels: []const u32 = &.{},
+    };
+    const StoredIndex = struct {
+        version: u16 = build_info.recording_version,
+        entries: []const Entry = &.{},
+    };
+
+    pub fn init(allocator: std.mem.Allocator) Self {
+        return .{ .allocator = allocator, .entries = .empty };
+    }
+
+    pub fn deinit(self: *Self) void {
+        for (self.entries.items) |*entry| {
+            freeEntry(self.allocator, entry);
+        }
+        self.entries.deinit(self.allocator);
+    }
+
+    // Loads the index file from the directory and brings it up to date with the recordings inside the directory.
+    // Missing or corrupted index file is not an error, it only means that every recording's header has to be read.
+    pub fn loadAndRefresh(allocator: std.mem.Allocator, dir_path: []const u8, file_extension: []const u8) !Self {
+        var self = load(allocator, dir_path) catch |err| block: {
+            if (err != error.FileNotFound) {
+                misc.error_context.append("Failed to load recording index. Rebuilding it from scratch.", .{});
+                misc.error_context.logWarning(err);
+            }
+            break :block init(allocator);
+        };
+        errdefer self.deinit();
+        const changed = self.refresh(dir_path, file_extension) catch |err| {
+            misc.error_context.append("Failed to refresh recording index.", .{});
+            return err;
+        };
+        if (changed) {
+            self.save(dir_path) catch |err| {
+                misc.error_context.append("Failed to save recording index.", .{});
+                misc.error_context.logWarning(err);
+            };
+        }
+        return self;
+    }
+
+    pub fn load(allocator: std.mem.Allocator, dir_path: []const u8) !Self {
+        var path_buffer: [std.fs.max_path_bytes]u8 = undefined;
+        const path = getIndexPath(&path_buffer, dir_path) catch |err| {
+            misc.error_context.append("Failed to construct recording index path.", .{});
+            return err;
+        };
+        const max_size = 256 * 1024 * 1024;
+        const data = std.fs.cwd().readFileAlloc(allocator, path, max_size) catch |err| {
+            misc.error_context.new("Failed to read file: {s}", .{path});
+            return err;
+        };
+        defer allocator.free(data);
+        const parsed = std.json.parseFromSlice(StoredIndex, allocator, data, .{
+            .ignore_unknown_fields = true,
+            .allocate = .alloc_always,
+        }) catch |err| {
+            misc.error_context.new("Failed to parse recording index: {s}", .{path});
+            return err;
+        };
+        defer parsed.deinit();
+        // Entries written by a different version could be missing metadata that the current version would extract.
+        if (parsed.value.version != build_info.recording_version) {
+            misc.error_context.new(
+                "Recording index version {} does not match the current version {}.",
+                .{ parsed.value.version, build_info.recording_version },
+            );
+            return error.UnsupportedVersion;
+        }
+
+        var self = init(allocator);
+        errdefer self.deinit();
+        self.entries.ensureTotalCapacity(allocator, parsed.value.entries.len) catch |err| {
+            misc.error_context.new("Failed to allocate {} recording index entries.", .{parsed.value.entries.len});
+            return err;
+        };
+        for (parsed.value.entries) |*entry| {
+            const copy = dupeEntry(allocator, entry) catch |err| {
+                misc.error_context.append("Failed to copy recording index entry: {s}", .{entry.file_name});
+                return err;
+            };
+            self.entries.appendAssumeCapacity(copy);
+        }
+        return self;
+    }
+
+    pub fn save(self: *const Self, dir_path: []const u8) !void {
+        var path_buffer: [std.fs.max_path_bytes]u8 = undefined;
+        const path = getIndexPath(&path_buffer, dir_path) catch |err| {
+            misc.error_context.append("Failed to construct recording index path.", .{});
+            return err;
+        };
+        const file = std.fs.cwd().createFile(path, .{}) catch |err| {
+            misc.error_context.new("Failed to create or open file: {s}", .{path});
+            return err;
+        };
+        defer file.close();
+        var buffer: [4096]u8 = undefined;
+        var writer = file.writer(&buffer);
+
+        const stored = StoredIndex{ .entries = self.entries.items };
+        std.json.Stringify.value(stored, .{}, &writer.interface) catch |err| {
+            misc.error_context.new("Failed to stringify recording index as JSON.", .{});
+            return err;
+        };
+        writer.end() catch |err| {
+            misc.error_context.new("Failed to end file writing.", .{});
+            return err;
+        };
+    }
+
+    // Reads headers of recordings that are new or have a different modification time or size then the indexed ones
+    // and drops entries of recordings that no longer exist. Returns true if anything changed.
+    pub fn refresh(self: *Self, dir_path: []const u8, file_extension: []const u8) !bool {
+        var dir = std.fs.cwd().openDir(dir_path, .{ .iterate = true }) catch |err| {
+            misc.error_context.new("Failed to open directory: {s}", .{dir_path});
+            return err;
+        };
+        defer dir.close();
+
+        var indices: std.StringHashMapUnmanaged(usize) = .empty;
+        defer indices.deinit(self.allocator);
+        indices.ensureTotalCapacity(self.allocator, @intCast(self.entries.items.len)) catch |err| {
+            misc.error_context.new("Failed to allocate the entry lookup table.", .{});
+            return err;
+        };
+        for (self.entries.items, 0..) |*entry, index| {
+            indices.putAssumeCapacity(entry.file_name, index);
+        }
+        var is_present: std.DynamicBitSetUnmanaged = .{};
+        defer is_present.deinit(self.allocator);
+        is_present.resize(self.allocator, self.entries.items.len, false) catch |err| {
+            misc.error_context.new("Failed to allocate the entry presence set.", .{});
+            return err;
+        };
+
+        var changed = false;
+        var iterator = dir.iterate();
+        while (true) {
+            const maybe_dir_entry = iterator.next() catch |err| {
+                misc.error_context.new("Failed to iterate directory: {s}", .{dir_path});
+                return err;
+            };
+            const dir_entry = maybe_dir_entry orelse break;
+            if (dir_entry.kind != .file or !std.mem.endsWith(u8, dir_entry.name, file_extension)) {
+                continue;
+            }
+            const stat = dir.statFile(dir_entry.name) catch |err| {
+                misc.error_context.new("Failed to stat file: {s}", .{dir_entry.name});
+                misc.error_context.logWarning(err);
+                continue;
+            };
+            if (indices.get(dir_entry.name)) |index| {
+                const entry = &self.entries.items[index];
+                is_present.set(index);
+                if (entry.modified_time == stat.mtime and entry.size == stat.size) {
+                    continue;
+                }
+                var updated = readEntry(self.allocator, dir_path, dir_entry.name, &stat) catch |err| {
+                    misc.error_context.append("Failed to read recording index entry: {s}", .{dir_entry.name});
+                    return err;
+                };
+                // Old file name stays in use since the lookup table references it.
+                self.allocator.free(updated.file_name);
+                updated.file_name = entry.file_name;
+                self.allocator.free(entry.labels);
+                entry.* = updated;
+            } else {
+                var added = readEntry(self.allocator, dir_path, dir_entry.name, &stat) catch |err| {
+                    misc.error_context.append("Failed to read recording index entry: {s}", .{dir_entry.name});
+                    return err;
+                };
+                self.entries.append(self.allocator, added) catch |err| {
+                    freeEntry(self.allocator, &added);
+                    misc.error_context.new("Failed to append recording index entry: {s}", .{dir_entry.name});
+                    return err;
+                };
+            }
+            changed = true;
+        }
+
+        // Entries appended during the scan are past the end of the presence set and always present.
+        var index = is_present.bit_length;
+        while (index > 0) {
+            index -= 1;
+            if (!is_present.isSet(index)) {
+                var removed = self.entries.orderedRemove(index);
+                freeEntry(self.allocator, &removed);
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    fn readEntry(
+        allocator: std.mem.Allocator,
+        dir_path: []const u8,
+        entry_file_name: []const u8,
+        stat: *const std.fs.File.Stat,
+    ) !Entry {
+        var entry = Entry{
+            .file_name = "",
+            .modified_time = stat.mtime,
+            .size = stat.size,
+        };
+        var path_buffer: [std.fs.max_path_bytes]u8 = undefined;
+        const path = std.fmt.bufPrint(&path_buffer, "{s}" ++ std.fs.path.sep_str ++ "{s}", .{
+            dir_path,
+            entry_file_name,
+        }) catch |err| {
+            misc.error_context.new("Failed to construct path of file: {s}", .{entry_file_name});
+            return err;
+        };
+        // Unreadable recordings stay indexed without metadata, so they don't get re-read on every refresh.
+        const maybe_info = io.loadRecordingInfo(path) catch |err| block: {
+            misc.error_context.append("Failed to read recording info: {s}", .{path});
+            misc.error_context.logWarning(err);
+            break :block null;
+        };
+        if (maybe_info) |*info| {
+            entry.content_hash = info.content_hash;
+            entry.game = info.game;
+            if (info.metadata) |*metadata| {
+                entry.number_of_frames = metadata.number_of_frames;
+                entry.number_of_markers = metadata.getMarkers().len;
+                entry.labels = metadata.getLabels();
+            }
+        }
+        return dupeEntry(allocator, &entry) catch |err| {
+            misc.error_context.append("Failed to copy recording index entry.", .{});
+            return err;
+        };
+    }
+
+    fn dupeEntry(allocator: std.mem.Allocator, entry: *const Entry) !Entry {
+        var copy = entry.*;
+        copy.file_name = allocator.dupe(u8, entry.file_name) catch |err| {
+            misc.error_context.new("Failed to allocate file name: {s}", .{entry.file_name});
+            return err;
+        };
+        errdefer allocator.free(copy.file_name);
+        copy.labels = allocator.dupe(u32, entry.labels) catch |err| {
+            misc.error_context.new("Failed to allocate {} labels.", .{entry.labels.len});
+            return err;
+        };
+        return copy;
+    }
+
+    fn freeEntry(allocator: std.mem.Allocator, entry: *const Entry) void {
+        allocator.free(entry.file_name);
+        allocator.free(entry.labels);
+    }
+
+    fn getIndexPath(buffer: []u8, dir_path: []const u8) ![]const u8 {
+        return std.fmt.bufPrint(buffer, "{s}" ++ std.fs.path.sep_str ++ file_name, .{dir_path}) catch |err| {
+            misc.error_context.new("Path is too long: {s}", .{dir_path});
+            return err;
+        };
+    }
+};
+
+const testing = std.testing;
+
+test "loadAndRefresh should index recordings and pick up only new, changed and deleted files" {
+    const dir_path = "./test_assets/recording_index";
+    try std.fs.cwd().makePath(dir_path);
+    defer std.fs.cwd().deleteTree(dir_path) catch @panic("Failed to cleanup test directory.");
+    const Frame = struct { a: u32 = 0 };
+    const Extractor = struct {
+        pub fn isMarker(previous: ?*const Frame, current: *const Frame) bool {
+            return previous == null or current.a < previous.?.a;
+        }
+
+        pub fn getLabels(frame: *const Frame) [1]?u32 {
+            return .{frame.a};
+        }
+    };
+    const config = io.RecordingConfig{ .MetadataExtractor = Extractor };
+    const frames = [_]Frame{ .{ .a = 1 }, .{ .a = 2 }, .{ .a = 1 }, .{ .a = 2 }, .{ .a = 3 } };
+    try io.saveRecording(Frame, testing.allocator, &frames, dir_path ++ "/1.irony", &config);
+    try io.saveRecording(Frame, testing.allocator, frames[0..2], dir_path ++ "/2.irony", &config);
+    try std.fs.cwd().writeFile(.{ .sub_path = dir_path ++ "/ignored.txt", .data = "text" });
+
+    {
+        var index = try RecordingIndex.loadAndRefresh(testing.allocator, dir_path, ".irony");
+        defer index.deinit();
+        try testing.expectEqual(2, index.entries.items.len);
+        for (index.entries.items) |*entry| {
+            try testing.expectEqual(build_info.game, entry.game);
+            if (std.mem.eql(u8, entry.file_name, "1.irony")) {
+                try testing.expectEqual(5, entry.number_of_frames);
+                try testing.expectEqual(2, entry.number_of_markers);
+                try testing.expectEqualSlices(u32, &.{ 1, 2, 3 }, entry.labels);
+            } else {
+                try testing.expectEqualStrings("2.irony", entry.file_name);
+                try testing.expectEqual(2, entry.number_of_frames);
+                try testing.expectEqual(1, entry.number_of_markers);
+                try testing.expectEqualSlices(u32, &.{ 1, 2 }, entry.labels);
+            }
+        }
+    }
+
+    try std.fs.cwd().deleteFile(dir_path ++ "/2.irony");
+    try io.saveRecording(Frame, testing.allocator, frames[2..], dir_path ++ "/3.irony", &config);
+    {
+        var index = try RecordingIndex.load(testing.allocator, dir_path);
+        defer index.deinit();
+        try testing.expectEqual(2, index.entries.items.len);
+        try testing.expectEqual(true, try index.refresh(dir_path, ".irony"));
+        try testing.expectEqual(false, try index.refresh(dir_path, ".irony"));
+        try testing.expectEqual(2, index.entries.items.len);
+        for (index.entries.items) |*entry| {
+            if (!std.mem.eql(u8, entry.file_name, "1.irony")) {
+                try testing.expectEqualStrings("3.irony", entry.file_name);
+                try testing.expectEqual(3, entry.number_of_frames);
+                try testing.expectEqualSlices(u32, &.{ 1, 2, 3 }, entry.labels);
+            }
+        }
+    }
+}
+
+test "loadAndRefresh should keep unreadable recordings indexed without metadata" {
+    const dir_path = "./test_assets/recording_index_corrupted";
+    try std.fs.cwd().makePath(dir_path);
+    defer std.fs.cwd().deleteTree(dir_path) catch @panic("Failed to cleanup test directory.");
+    try std.fs.cwd().writeFile(.{ .sub_path = dir_path ++ "/corrupted.irony", .data = "not a recording" });
+    try std.fs.cwd().writeFile(.{ .sub_path = dir_path ++ "/" ++ RecordingIndex.file_name, .data = "{ corrupted" });
+
+    var index = try RecordingIndex.loadAndRefresh(testing.allocator, dir_path, ".irony");
+    defer index.deinit();
+    try testing.expectEqual(1, index.entries.items.len);
+    try testing.expectEqualStrings("corrupted.irony", index.entries.items[0].file_name);
+    try testing.expectEqual(null, index.entries.items[0].number_of_frames);
+    try testing.expectEqual(null, index.entries.items[0].content_hash);
+}
+
+test "loadAndRefresh should rebuild index saved by a different version" {
+    const dir_path = "./test_assets/recording_index_version";
+    try std.fs.cwd().makePath(dir_path);
+    defer std.fs.cwd().deleteTree(dir_path) catch @panic("Failed to cleanup test directory.");
+    const Frame = struct { a: u32 = 0 };
+    try io.saveRecording(Frame, testing.allocator, &.{ .{ .a = 1 }, .{ .a = 2 } }, dir_path ++ "/1.irony", &.{});
+    const stat = try std.fs.cwd().statFile(dir_path ++ "/1.irony");
+    const stale = RecordingIndex.StoredIndex{
+        .version = build_info.recording_version -% 1,
+        .entries = &.{.{ .file_name = "1.irony", .modified_time = stat.mtime, .size = stat.size }},
+    };
+    var buffer: [1024]u8 = undefined;
+    var writer = std.io.Writer.fixed(&buffer);
+    try std.json.Stringify.value(stale, .{}, &writer);
+    try std.fs.cwd().writeFile(.{ .sub_path = dir_path ++ "/" ++ RecordingIndex.file_name, .data = writer.buffered() });
+
+    try testing.expectError(error.UnsupportedVersion, RecordingIndex.load(testing.allocator, dir_path));
+    var index = try RecordingIndex.loadAndRefresh(testing.allocator, dir_path, ".irony");
+    defer index.deinit();
+    try testing.expectEqual(1, index.entries.items.len);
+    try testing.expectEqual(2, index.entries.items[0].number_of_frames);
+
+    var reloaded = try RecordingIndex.load(testing.allocator, dir_path);
+    defer reloaded.deinit();
+    try testing.expectEqual(1, reloaded.entries.items.len);
+}
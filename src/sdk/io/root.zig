@@ -2,11 +2,59 @@ pub const BitWriter = @import("bit.zig").BitWriter;
 pub const BitReader = @import("bit.zig").BitReader;
 pub const ByteWriter = @import("byte.zig").ByteWriter;
 pub const ByteReader = @import("byte.zig").ByteReader;
+pub const ChangeMask = @import("change_mask.zig").ChangeMask;
+pub const ChunkStore = @import("chunk_store.zig").ChunkStore;
+pub const ChunkHash = @import("chunk_store.zig").ChunkHash;
+pub const saveColumnar = @import("columnar.zig").saveColumnar;
+pub const convertRecordingToColumnar = @import("columnar.zig").convertRecordingToColumnar;
+pub const ColumnarFile = @import("columnar.zig").ColumnarFile;
+pub const Column = @import("columnar.zig").Column;
+pub const ColumnKind = @import("columnar.zig").ColumnKind;
+pub const ColumnEncoding = @import("columnar.zig").ColumnEncoding;
+pub const ColumnEnumEntry = @import("columnar.zig").ColumnEnumEntry;
+pub const ColumnValue = @import("columnar.zig").ColumnValue;
+pub const ColumnRunEnd = @import("columnar.zig").ColumnRunEnd;
+pub const encodeDelta = @import("delta.zig").encodeDelta;
+pub const decodeDelta = @import("delta.zig").decodeDelta;
+pub const HashingWriter = @import("hashing.zig").HashingWriter;
+pub const Pipeline = @import("pipeline.zig").Pipeline;
+pub const PipelineStats = @import("pipeline.zig").PipelineStats;
+pub const PipelineStageStats = @import("pipeline.zig").PipelineStageStats;
+pub const PredictiveScalarKind = @import("predictive.zig").ScalarKind;
+pub const PredictiveLayoutRun = @import("predictive.zig").LayoutRun;
+pub const getPredictiveLayoutSize = @import("predictive.zig").getLayoutSize;
+pub const validatePredictiveLayout = @import("predictive.zig").validateLayout;
+pub const encodePredictiveImage = @import("predictive.zig").encodeImage;
+pub const decodePredictiveImage = @import("predictive.zig").decodeImage;
+pub const predictive_max_scalar_size = @import("predictive.zig").max_scalar_size;
 pub const saveRecording = @import("recording.zig").saveRecording;
 pub const loadRecording = @import("recording.zig").loadRecording;
+pub const loadRecordingChunks = @import("recording.zig").loadRecordingChunks;
+pub const loadRecordingInfo = @import("recording.zig").loadRecordingInfo;
+pub const loadRecordingChunkReferences = @import("recording.zig").loadRecordingChunkReferences;
+pub const trainRecordingDictionary = @import("recording.zig").trainRecordingDictionary;
+pub const spliceRecordings = @import("recording.zig").spliceRecordings;
+pub const trimRecording = @import("recording.zig").trimRecording;
+pub const deleteRecordingRange = @import("recording.zig").deleteRecordingRange;
+pub const concatenateRecordings = @import("recording.zig").concatenateRecordings;
+pub const RecordingSlice = @import("recording.zig").RecordingSlice;
+pub const RecordingMetadata = @import("recording.zig").RecordingMetadata;
+pub const RecordingInfo = @import("recording.zig").RecordingInfo;
+pub const RecordingDictionary = @import("recording.zig").RecordingDictionary;
+pub const RecordingProfileName = @import("recording.zig").RecordingProfileName;
 pub const RecordingConfig = @import("recording.zig").RecordingConfig;
+pub const QuantizedPath = @import("recording.zig").QuantizedPath;
+pub const RecordingCodec = @import("recording.zig").RecordingCodec;
+pub const RecordingIndex = @import("recording_index.zig").RecordingIndex;
+pub const saveScratchRecording = @import("scratch.zig").saveScratchRecording;
+pub const ScratchRecording = @import("scratch.zig").ScratchRecording;
+pub const convertRecordingToScratch = @import("scratch.zig").convertRecordingToScratch;
+pub const convertScratchToRecording = @import("scratch.zig").convertScratchToRecording;
+pub const getFrameLayout = @import("scratch.zig").getFrameLayout;
 pub const saveSettings = @import("settings.zig").saveSettings;
 pub const loadSettings = @import("settings.zig").loadSettings;
 pub const settingsInnerParse = @import("settings.zig").settingsInnerParse;
 pub const XzEncoder = @import("xz.zig").XzEncoder;
 pub const XzDecoder = @import("xz.zig").XzDecoder;
+pub const isXzStream = @import("xz.zig").isXzStream;
+pub const xz_chunk_size = @import("xz.zig").chunk_size;
@@ -0,0 +1,492 @@
+const std = @import("std");
+const builtin = @import("builtin");
+const build_info = @import("build_info");
+const w32 = @import("win32").everything;
+const misc = @import("../misc/root.zig");
+const os = @import("../os/root.zig");
+const io = @import("root.zig");
+const recording = @import("recording.zig");
+
+// Scratch recordings store frames uncompressed, exactly the way they are laid out in memory, one after another with a
+// fixed stride. Opening one only maps the file into memory, so even long recordings open instantly and the frames get
+// paged in by the OS when they are first touched. The price is size and portability: the file only makes sense to a
+// build with the exact same frame layout, which is why the header describes the layout and gets compared on open.
+// They are meant as a working copy for editing and analysis sessions. Recordings get archived and shared using the
+// compressed recording format, and the converters below move frames between the two formats one chunk at a time.
+//
+// File structure:
+// magic number | version | number of frames | frame size | data offset | layout size | layout | padding | frames
+
+const VersionNumber = u16;
+const NumberOfFrames = u64;
+const FrameSize = u32;
+const DataOffset = u32;
+const LayoutSize = u32;
+const LayoutStringLength = u16;
+const FieldOffset = u32;
+const FieldSize = u32;
+
+const endian = std.builtin.Endian.little;
+const magic_number = @tagName(build_info.name) ++ "-scratch";
+const version_number = 1;
+const number_of_frames_offset = magic_number.len + @sizeOf(VersionNumber);
+const buffer_size = 4096;
+
+pub fn saveScratchRecording(
+    comptime Frame: type,
+    frames: []const Frame,
+    file_path: []const u8,
+    comptime config: *const io.RecordingConfig,
+) !void {
+    const file = std.fs.cwd().createFile(file_path, .{}) catch |err| {
+        misc.error_context.new("Failed to create or open file: {s}", .{file_path});
+        return err;
+    };
+    defer file.close();
+
+    var file_buffer: [buffer_size]u8 = undefined;
+    var file_writer = file.writer(&file_buffer);
+    const writer = &file_writer.interface;
+    writeHeader(Frame, writer, frames.len, config) catch |err| {
+        misc.error_context.append("Failed to write scratch header.", .{});
+        return err;
+    };
+    writer.writeAll(std.mem.sliceAsBytes(frames)) catch |err| {
+        misc.error_context.new("Failed to write {} frames.", .{frames.len});
+        return err;
+    };
+    file_writer.end() catch |err| {
+        misc.error_context.new("Failed to end file writing.", .{});
+        return err;
+    };
+}
+
+// Memory mapped scratch recording. Frames point directly into the mapped file, so they are only valid until close.
+// Only files written by a build with the same frame layout can be opened, since frames are not validated.
+pub fn ScratchRecording(comptime Frame: type, comptime config: *const io.RecordingConfig) type {
+    return struct {
+        mapping: FileMapping,
+        frames: []const Frame,
+
+        const Self = @This();
+
+        pub fn open(file_path: []const u8) !Self {
+            var mapping = FileMapping.open(file_path) catch |err| {
+                misc.error_context.append("Failed to map file: {s}", .{file_path});
+                return err;
+            };
+            errdefer mapping.close();
+            const frames = readFrames(Frame, mapping.bytes, config) catch |err| {
+                misc.error_context.append("Failed to read scratch recording: {s}", .{file_path});
+                return err;
+            };
+            return .{ .mapping = mapping, .frames = frames };
+        }
+
+        pub fn close(self: *Self) void {
+            self.mapping.close();
+            self.* = undefined;
+        }
+    };
+}
+
+// Decodes the compressed recording one chunk at a time and appends the chunks to the scratch file, so memory usage
+// stays at a single chunk no matter the length of the recording.
+pub fn convertRecordingToScratch(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    source_path: []const u8,
+    file_path: []const u8,
+    comptime config: *const io.RecordingConfig,
+) !void {
+    const file = std.fs.cwd().createFile(file_path, .{}) catch |err| {
+        misc.error_context.new("Failed to create or open file: {s}", .{file_path});
+        return err;
+    };
+    writeConvertedScratch(Frame, allocator, source_path, file, config) catch |err| {
+        file.close();
+        std.fs.cwd().deleteFile(file_path) catch {};
+        misc.error_context.append("Failed to write scratch recording into: {s}", .{file_path});
+        return err;
+    };
+    file.close();
+}
+
+// The mapped frames are handed to the recording encoder as they are. Pages get read in while chunks are encoded, so
+// the scratch file never has to be copied into memory.
+pub fn convertScratchToRecording(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    source_path: []const u8,
+    file_path: []const u8,
+    comptime config: *const io.RecordingConfig,
+) !void {
+    var scratch = ScratchRecording(Frame, config).open(source_path) catch |err| {
+        misc.error_context.append("Failed to open scratch recording: {s}", .{source_path});
+        return err;
+    };
+    defer scratch.close();
+    io.saveRecording(Frame, allocator, scratch.frames, file_path, config) catch |err| {
+        misc.error_context.append("Failed to save recording: {s}", .{file_path});
+        return err;
+    };
+}
+
+fn writeConvertedScratch(
+    comptime Frame: type,
+    allocator: std.mem.Allocator,
+    source_path: []const u8,
+    file: std.fs.File,
+    comptime config: *const io.RecordingConfig,
+) !void {
+    var file_buffer: [buffer_size]u8 = undefined;
+    var file_writer = file.writer(&file_buffer);
+    const writer = &file_writer.interface;
+    writeHeader(Frame, writer, 0, config) catch |err| {
+        misc.error_context.append("Failed to write scratch header.", .{});
+        return err;
+    };
+
+    const Context = struct {
+        writer: *std.io.Writer,
+        number_of_frames: NumberOfFrames = 0,
+    };
+    var context = Context{ .writer = writer };
+    io.loadRecordingChunks(Frame, allocator, source_path, config, &context, struct {
+        fn call(c: *Context, frames: []const Frame) anyerror!void {
+            c.writer.writeAll(std.mem.sliceAsBytes(frames)) catch |err| {
+                misc.error_context.new("Failed to write {} frames.", .{frames.len});
+                return err;
+            };
+            c.number_of_frames += frames.len;
+        }
+    }.call) catch |err| {
+        misc.error_context.append("Failed to convert recording: {s}", .{source_path});
+        return err;
+    };
+    file_writer.end() catch |err| {
+        misc.error_context.new("Failed to end file writing.", .{});
+        return err;
+    };
+
+    // Number of frames is only known at the end, so it gets patched in once all the frames are written.
+    var number_bytes: [@sizeOf(NumberOfFrames)]u8 = undefined;
+    std.mem.writeInt(NumberOfFrames, &number_bytes, context.number_of_frames, endian);
+    file.pwriteAll(&number_bytes, number_of_frames_offset) catch |err| {
+        misc.error_context.new("Failed to write number of frames.", .{});
+        return err;
+    };
+}
+
+fn writeHeader(
+    comptime Frame: type,
+    writer: *std.io.Writer,
+    number_of_frames: usize,
+    comptime config: *const io.RecordingConfig,
+) !void {
+    const layout = getFrameLayout(Frame, config);
+    const data_offset = getDataOffset(Frame, layout.len);
+    writer.writeAll(magic_number) catch |err| {
+        misc.error_context.new("Failed to write magic number.", .{});
+        return err;
+    };
+    writer.writeInt(VersionNumber, version_number, endian) catch |err| {
+        misc.error_context.new("Failed to write version number.", .{});
+        return err;
+    };
+    writer.writeInt(NumberOfFrames, number_of_frames, endian) catch |err| {
+        misc.error_context.new("Failed to write number of frames.", .{});
+        return err;
+    };
+    writer.writeInt(FrameSize, @sizeOf(Frame), endian) catch |err| {
+        misc.error_context.new("Failed to write frame size.", .{});
+        return err;
+    };
+    writer.writeInt(DataOffset, data_offset, endian) catch |err| {
+        misc.error_context.new("Failed to write data offset.", .{});
+        return err;
+    };
+    writer.writeInt(LayoutSize, layout.len, endian) catch |err| {
+        misc.error_context.new("Failed to write layout size.", .{});
+        return err;
+    };
+    writer.writeAll(layout) catch |err| {
+        misc.error_context.new("Failed to write layout.", .{});
+        return err;
+    };
+    writer.splatByteAll(0, data_offset - getHeaderSize(layout.len)) catch |err| {
+        misc.error_context.new("Failed to write padding.", .{});
+        return err;
+    };
+}
+
+fn readFrames(
+    comptime Frame: type,
+    bytes: []align(std.heap.page_size_min) const u8,
+    comptime config: *const io.RecordingConfig,
+) ![]const Frame {
+    var reader = std.io.Reader.fixed(bytes);
+    const magic_buffer = reader.take(magic_number.len) catch |err| {
+        misc.error_context.new("Failed to read magic number.", .{});
+        return err;
+    };
+    if (!std.mem.eql(u8, magic_buffer, magic_number)) {
+        misc.error_context.new("Incorrect magic number.", .{});
+        return error.MagicNumber;
+    }
+    const version = reader.takeInt(VersionNumber, endian) catch |err| {
+        misc.error_context.new("Failed to read version number.", .{});
+        return err;
+    };
+    if (version != version_number) {
+        misc.error_context.new("Unsupported scratch version {}. Expected version {}.", .{ version, version_number });
+        return error.UnsupportedVersion;
+    }
+    const number_of_frames = reader.takeInt(NumberOfFrames, endian) catch |err| {
+        misc.error_context.new("Failed to read number of frames.", .{});
+        return err;
+    };
+    const frame_size = reader.takeInt(FrameSize, endian) catch |err| {
+        misc.error_context.new("Failed to read frame size.", .{});
+        return err;
+    };
+    const data_offset = reader.takeInt(DataOffset, endian) catch |err| {
+        misc.error_context.new("Failed to read data offset.", .{});
+        return err;
+    };
+    const layout_size = reader.takeInt(LayoutSize, endian) catch |err| {
+        misc.error_context.new("Failed to read layout size.", .{});
+        return err;
+    };
+    const layout = reader.take(layout_size) catch |err| {
+        misc.error_context.new("Failed to read layout.", .{});
+        return err;
+    };
+
+    const expected_layout = getFrameLayout(Frame, config);
+    if (frame_size != @sizeOf(Frame) or !std.mem.eql(u8, layout, expected_layout)) {
+        misc.error_context.new(
+            "Scratch recording was written with a different frame layout. Convert it from the compressed recording.",
+            .{},
+        );
+        return error.LayoutMismatch;
+    }
+    if (data_offset != getDataOffset(Frame, layout.len)) {
+        misc.error_context.new("Invalid data offset: {}", .{data_offset});
+        return error.InvalidDataOffset;
+    }
+    const data_size = std.math.mul(u64, number_of_frames, @sizeOf(Frame)) catch |err| {
+        misc.error_context.new("Number of frames {} is too large.", .{number_of_frames});
+        return err;
+    };
+    if (data_offset > bytes.len or data_size > bytes.len - data_offset) {
+        misc.error_context.new(
+            "File contains {} bytes of frames while the header says it contains {} frames.",
+            .{ bytes.len -| data_offset, number_of_frames },
+        );
+        return error.EndOfStream;
+    }
+    const data: []align(@alignOf(Frame)) const u8 = @alignCast(bytes[data_offset..][0..@intCast(data_size)]);
+    return std.mem.bytesAsSlice(Frame, data);
+}
+
+fn getHeaderSize(layout_size: usize) usize {
+    return magic_number.len + @sizeOf(VersionNumber) + @sizeOf(NumberOfFrames) + @sizeOf(FrameSize) +
+        @sizeOf(DataOffset) + @sizeOf(LayoutSize) + layout_size;
+}
+
+fn getDataOffset(comptime Frame: type, layout_size: usize) DataOffset {
+    return @intCast(std.mem.alignForward(usize, getHeaderSize(layout_size), @alignOf(Frame)));
+}
+
+// Describes everything that the meaning of the frame bytes depends on: the compiler that decided the memory layout,
+// the target and then the path, type, offset and size of every field. Fields that are inside optionals and tagged
+// unions are covered by their parent, since the placement of their payloads is up to the compiler.
+pub inline fn getFrameLayout(comptime Frame: type, comptime config: *const io.RecordingConfig) []const u8 {
+    comptime {
+        @setEvalBranchQuota(1000000);
+        var layout: []const u8 = "";
+        layout = layout ++ layoutString(builtin.zig_version_string);
+        layout = layout ++ layoutString(@tagName(builtin.cpu.arch));
+        layout = layout ++ layoutInt(FieldSize, @alignOf(Frame));
+        for (recording.getLocalFields(Frame, config)) |*field| {
+            if (field.parent_index != null) {
+                continue;
+            }
+            layout = layout ++ layoutString(field.path);
+            layout = layout ++ layoutString(@typeName(field.Type));
+            layout = layout ++ layoutInt(FieldOffset, getFieldOffset(Frame, field.access));
+            layout = layout ++ layoutInt(FieldSize, @sizeOf(field.Type));
+        }
+        const result = layout[0..layout.len].*;
+        return &result;
+    }
+}
+
+fn layoutString(comptime string: []const u8) []const u8 {
+    return layoutInt(LayoutStringLength, string.len) ++ string;
+}
+
+fn layoutInt(comptime Int: type, comptime value: comptime_int) []const u8 {
+    var bytes: [@sizeOf(Int)]u8 = undefined;
+    std.mem.writeInt(Int, &bytes, value, endian);
+    const result = bytes;
+    return &result;
+}
+
+fn getFieldOffset(comptime Type: type, comptime access: []const recording.AccessElement) comptime_int {
+    if (access.len == 0) {
+        return 0;
+    }
+    return switch (access[0]) {
+        .struct_field => |name| @offsetOf(Type, name) + getFieldOffset(@FieldType(Type, name), access[1..]),
+        .array_index => |index| block: {
+            const Element = @typeInfo(Type).array.child;
+            break :block index * @sizeOf(Element) + getFieldOffset(Element, access[1..]);
+        },
+        .optional_payload, .union_field => @compileError("Payload offsets are not part of the scratch layout."),
+    };
+}
+
+// Read only view of a whole file. The mapping stays valid after the file handle gets closed.
+const FileMapping = struct {
+    bytes: []align(std.heap.page_size_min) const u8,
+    handle: if (builtin.os.tag == .windows) w32.HANDLE else void,
+
+    const Self = @This();
+
+    fn open(file_path: []const u8) !Self {
+        const file = std.fs.cwd().openFile(file_path, .{}) catch |err| {
+            misc.error_context.new("Failed to open file: {s}", .{file_path});
+            return err;
+        };
+        defer file.close();
+        const size = file.getEndPos() catch |err| {
+            misc.error_context.new("Failed to get file size.", .{});
+            return err;
+        };
+        if (size == 0) {
+            misc.error_context.new("File is empty.", .{});
+            return error.EndOfStream;
+        }
+        if (builtin.os.tag == .windows) {
+            const handle = w32.CreateFileMappingW(file.handle, null, .{ .PAGE_READONLY = 1 }, 0, 0, null) orelse {
+                misc.error_context.new("{f}", .{os.Error.getLast()});
+                misc.error_context.append("CreateFileMappingW returned null.", .{});
+                return error.OsError;
+            };
+            errdefer _ = w32.CloseHandle(handle);
+            const pointer = w32.MapViewOfFile(handle, w32.FILE_MAP_READ, 0, 0, 0) orelse {
+                misc.error_context.new("{f}", .{os.Error.getLast()});
+                misc.error_context.append("MapViewOfFile returned null.", .{});
+                return error.OsError;
+            };
+            const many_pointer: [*]align(std.heap.page_size_min) const u8 = @ptrCast(@alignCast(pointer));
+            return .{ .bytes = many_pointer[0..@intCast(size)], .handle = handle };
+        } else {
+            const bytes = std.posix.mmap(
+                null,
+                @intCast(size),
+                std.posix.PROT.READ,
+                .{ .TYPE = .PRIVATE },
+                file.handle,
+                0,
+            ) catch |err| {
+                misc.error_context.new("Failed to memory map {} bytes.", .{size});
+                return err;
+            };
+            return .{ .bytes = bytes, .handle = {} };
+        }
+    }
+
+    fn close(self: *Self) void {
+        if (builtin.os.tag == .windows) {
+            if (w32.UnmapViewOfFile(@ptrCast(self.bytes.ptr)) == 0) {
+                misc.error_context.new("{f}", .{os.Error.getLast()});
+                misc.error_context.append("UnmapViewOfFile returned 0.", .{});
+                misc.error_context.logError(error.OsError);
+            }
+            if (w32.CloseHandle(self.handle) == 0) {
+                misc.error_context.new("{f}", .{os.Error.getLast()});
+                misc.error_context.append("CloseHandle returned 0.", .{});
+                misc.error_context.logError(error.OsError);
+            }
+        } else {
+            std.posix.munmap(self.bytes);
+        }
+    }
+};
+
+const testing = std.testing;
+
+const TestFrame = struct {
+    a: f32 = 0,
+    b: ?u8 = null,
+    c: [2]struct { x: u16 = 0, y: bool = false } = .{ .{}, .{} },
+    d: union(enum) { i: i32, f: f32 } = .{ .i = 0 },
+};
+
+fn getTestFrames() [10]TestFrame {
+    var frames: [10]TestFrame = undefined;
+    for (&frames, 0..) |*frame, index| {
+        frame.* = .{
+            .a = @floatFromInt(index),
+            .b = if (index % 3 == 0) null else @intCast(index),
+            .c = .{ .{ .x = @intCast(index), .y = true }, .{ .x = @intCast(2 * index), .y = index % 2 == 0 } },
+            .d = if (index % 2 == 0) .{ .i = @intCast(index) } else .{ .f = @floatFromInt(index) },
+        };
+    }
+    return frames;
+}
+
+test "ScratchRecording should map the same frames that saveScratchRecording saved" {
+    const frames = getTestFrames();
+    try saveScratchRecording(TestFrame, &frames, "./test_assets/recording.scratch", &.{});
+    defer std.fs.cwd().deleteFile("./test_assets/recording.scratch") catch @panic("Failed to cleanup test file.");
+
+    var scratch = try ScratchRecording(TestFrame, &.{}).open("./test_assets/recording.scratch");
+    defer scratch.close();
+    try testing.expectEqualSlices(TestFrame, &frames, scratch.frames);
+    try testing.expectEqual(0, @intFromPtr(scratch.frames.ptr) % @alignOf(TestFrame));
+}
+
+test "ScratchRecording should fail to open a file that was written with a different frame layout" {
+    const OtherFrame = struct { a: f32 = 0, b: ?u16 = null };
+    const frames = [_]OtherFrame{ .{ .a = 1 }, .{ .a = 2, .b = 3 } };
+    try saveScratchRecording(OtherFrame, &frames, "./test_assets/recording.scratch", &.{});
+    defer std.fs.cwd().deleteFile("./test_assets/recording.scratch") catch @panic("Failed to cleanup test file.");
+
+    const result = ScratchRecording(TestFrame, &.{}).open("./test_assets/recording.scratch");
+    try testing.expectError(error.LayoutMismatch, result);
+}
+
+test "converters should move frames between compressed and scratch recordings without changing them" {
+    const frames = getTestFrames();
+    const config = io.RecordingConfig{ .frames_per_chunk = 3 };
+    try io.saveRecording(TestFrame, testing.allocator, &frames, "./test_assets/recording.irony", &config);
+    defer std.fs.cwd().deleteFile("./test_assets/recording.irony") catch @panic("Failed to cleanup test file.");
+
+    try convertRecordingToScratch(
+        TestFrame,
+        testing.allocator,
+        "./test_assets/recording.irony",
+        "./test_assets/recording.scratch",
+        &config,
+    );
+    defer std.fs.cwd().deleteFile("./test_assets/recording.scratch") catch @panic("Failed to cleanup test file.");
+    var scratch = try ScratchRecording(TestFrame, &config).open("./test_assets/recording.scratch");
+    try testing.expectEqualSlices(TestFrame, &frames, scratch.frames);
+    scratch.close();
+
+    try convertScratchToRecording(
+        TestFrame,
+        testing.allocator,
+        "./test_assets/recording.scratch",
+        "./test_assets/converted.irony",
+        &config,
+    );
+    defer std.fs.cwd().deleteFile("./test_assets/converted.irony") catch @panic("Failed to cleanup test file.");
+    const loaded = try io.loadRecording(TestFrame, testing.allocator, "./test_assets/converted.irony", &config);
+    defer testing.allocator.free(loaded);
+    try testing.expectEqualSlices(TestFrame, &frames, loaded);
+}
@@ -2,39 +2,60 @@ const std = @import("std");
 const xz = @import("xz");
 const misc = @import("../misc/root.zig");
 
+// Amount of bytes that get passed to liblzma in one call. Large enough for most chunk blocks to go through in a few
+// calls. Readers and writers that sit in front of the encoder and decoder should use buffers of the same size.
+pub const chunk_size = 64 * 1024;
+
 pub const XzEncoder = struct {
     vtable: std.io.Writer.VTable,
     des_writer: *std.io.Writer,
     lzma_allocator: LzmaAllocator,
     lzma_stream: xz.lzma_stream,
     flushed: bool,
+    checksum: std.hash.Crc32,
 
     const Self = @This();
-    const chunk_size = 4096;
 
     pub fn init(allocator: std.mem.Allocator, des_writer: *std.io.Writer) !Self {
+        return initInternal(allocator, des_writer, null);
+    }
+
+    // Produces a raw LZMA2 stream that starts from the preset dictionary instead of a empty one. The .xz container has
+    // no place for a preset dictionary, so the output has no header or integrity check and can only be decoded by
+    // XzDecoder.initWithDictionary with the same dictionary. Callers that need a integrity check store getChecksum
+    // next to the stream.
+    pub fn initWithDictionary(allocator: std.mem.Allocator, des_writer: *std.io.Writer, dictionary: []const u8) !Self {
+        return initInternal(allocator, des_writer, dictionary);
+    }
+
+    fn initInternal(allocator: std.mem.Allocator, des_writer: *std.io.Writer, dictionary: ?[]const u8) !Self {
         var lzma_allocator = LzmaAllocator.init(allocator);
         errdefer lzma_allocator.deinit();
 
-        var options = xz.lzma_options_lzma{};
-        const options_result = xz.lzma_lzma_preset(&options, xz.LZMA_PRESET_EXTREME);
-        if (lzmaResultToError(options_result)) |err| {
-            misc.error_context.new("{s}", .{lzmaResultToDescription(options_result)});
-            misc.error_context.append("lzma_lzma_preset returned a error result: {}", .{options_result});
+        var options = getLzmaOptions(dictionary) catch |err| {
+            misc.error_context.append("Failed to get LZMA options.", .{});
             return err;
-        }
-
+        };
         var lzma_stream = xz.lzma_stream{};
         lzma_stream.allocator = &lzma_allocator.interface();
         const filters = [2]xz.lzma_filter{
             .{ .id = xz.LZMA_FILTER_LZMA2, .options = &options },
             .{ .id = xz.LZMA_VLI_UNKNOWN, .options = null },
         };
-        const stream_result = xz.lzma_stream_encoder(&lzma_stream, &filters, xz.LZMA_CHECK_CRC64);
-        if (lzmaResultToError(stream_result)) |err| {
-            misc.error_context.new("{s}", .{lzmaResultToDescription(stream_result)});
-            misc.error_context.append("lzma_stream_encoder returned a error result: {}", .{stream_result});
-            return err;
+        if (dictionary != null) {
+            const raw_result = xz.lzma_raw_encoder(&lzma_stream, &filters);
+            if (lzmaResultToError(raw_result)) |err| {
+                misc.error_context.new("{s}", .{lzmaResultToDescription(raw_result)});
+                misc.error_context.append("lzma_raw_encoder returned a error result: {}", .{raw_result});
+                return err;
+            }
+        } else {
+            const stream_result = xz.lzma_stream_encoder(&lzma_stream, &filters, xz.LZMA_CHECK_CRC64);
+            if (lzmaResultToError(stream_result)) |err| {
+                misc.error_context.new("{s}", .{lzmaResultToDescription(stream_result)});
+                misc.error_context.append("lzma_stream_encoder returned a error result: {}", .{stream_result});
+                return err;
+            }
         }
         errdefer xz.lzma_end(&lzma_stream);
 
@@ -47,6 +68,7 @@ pub const XzEncoder = struct {
             .lzma_allocator = lzma_allocator,
             .lzma_stream = lzma_stream,
             .flushed = false,
+            .checksum = .init(),
         };
     }
 
@@ -63,6 +85,12 @@ pub const XzEncoder = struct {
         };
     }
 
+    // CRC32 of the uncompressed bytes that got encoded so far. Flush the writer before calling this.
+    pub fn getChecksum(self: *const Self) u32 {
+        var checksum = self.checksum;
+        return checksum.final();
+    }
+
     fn drain(w: *std.io.Writer, data: []const []const u8, splat: usize) std.io.Writer.Error!usize {
         const self: *Self = @constCast(@fieldParentPtr("vtable", w.vtable));
         self.lzma_stream.allocator = &self.lzma_allocator.interface();
@@ -146,6 +174,7 @@ pub const XzEncoder = struct {
                 try self.des_writer.writeAll(buffer[0..output_size]);
             }
         }
+        self.checksum.update(data[0..(data.len - stream.avail_in)]);
         return data.len - stream.avail_in;
     }
 };
@@ -162,19 +191,44 @@ pub const XzDecoder = struct {
     output_leftovers_len: usize,
 
     const Self = @This();
-    const chunk_size = 4096;
 
     pub fn init(allocator: std.mem.Allocator, src_reader: *std.io.Reader) !Self {
+        return initInternal(allocator, src_reader, null);
+    }
+
+    // Decodes the raw LZMA2 stream produced by XzEncoder.initWithDictionary.
+    pub fn initWithDictionary(allocator: std.mem.Allocator, src_reader: *std.io.Reader, dictionary: []const u8) !Self {
+        return initInternal(allocator, src_reader, dictionary);
+    }
+
+    fn initInternal(allocator: std.mem.Allocator, src_reader: *std.io.Reader, dictionary: ?[]const u8) !Self {
         var lzma_allocator = LzmaAllocator.init(allocator);
         errdefer lzma_allocator.deinit();
 
         var lzma_stream = xz.lzma_stream{};
         lzma_stream.allocator = &lzma_allocator.interface();
-        const stream_result = xz.lzma_stream_decoder(&lzma_stream, std.math.maxInt(u64), xz.LZMA_CONCATENATED);
-        if (lzmaResultToError(stream_result)) |err| {
-            misc.error_context.new("{s}", .{lzmaResultToDescription(stream_result)});
-            misc.error_context.append("lzma_stream_decoder returned a error result: {}", .{stream_result});
-            return err;
+        if (dictionary != null) {
+            var options = getLzmaOptions(dictionary) catch |err| {
+                misc.error_context.append("Failed to get LZMA options.", .{});
+                return err;
+            };
+            const filters = [2]xz.lzma_filter{
+                .{ .id = xz.LZMA_FILTER_LZMA2, .options = &options },
+                .{ .id = xz.LZMA_VLI_UNKNOWN, .options = null },
+            };
+            const raw_result = xz.lzma_raw_decoder(&lzma_stream, &filters);
+            if (lzmaResultToError(raw_result)) |err| {
+                misc.error_context.new("{s}", .{lzmaResultToDescription(raw_result)});
+                misc.error_context.append("lzma_raw_decoder returned a error result: {}", .{raw_result});
+                return err;
+            }
+        } else {
+            const stream_result = xz.lzma_stream_decoder(&lzma_stream, std.math.maxInt(u64), xz.LZMA_CONCATENATED);
+            if (lzmaResultToError(stream_result)) |err| {
+                misc.error_context.new("{s}", .{lzmaResultToDescription(stream_result)});
+                misc.error_context.append("lzma_stream_decoder returned a error result: {}", .{stream_result});
+                return err;
+            }
         }
         errdefer xz.lzma_end(&lzma_stream);
 
@@ -275,6 +329,37 @@ pub const XzDecoder = struct {
     }
 };
 
+const xz_magic = [_]u8{ 0xFD, '7', 'z', 'X', 'Z', 0x00 };
+
+// Tells .xz streams apart from raw streams of XzEncoder.initWithDictionary. A raw LZMA2 stream that starts from a
+// preset dictionary never begins with a dictionary reset, so it can't begin with the first byte of the .xz magic.
+pub fn isXzStream(bytes: []const u8) bool {
+    return std.mem.startsWith(u8, bytes, &xz_magic);
+}
+
+// Encoder and decoder have to agree on the options, since raw streams don't store them.
+fn getLzmaOptions(dictionary: ?[]const u8) !xz.lzma_options_lzma {
+    var options = xz.lzma_options_lzma{};
+    const options_result = xz.lzma_lzma_preset(&options, xz.LZMA_PRESET_EXTREME);
+    if (lzmaResultToError(options_result)) |err| {
+        misc.error_context.new("{s}", .{lzmaResultToDescription(options_result)});
+        misc.error_context.append("lzma_lzma_preset returned a error result: {}", .{options_result});
+        return err;
+    }
+    if (dictionary) |bytes| {
+        if (bytes.len == 0 or bytes.len > options.dict_size) {
+            misc.error_context.new(
+                "Preset dictionary size {} is not between 1 and {} bytes.",
+                .{ bytes.len, options.dict_size },
+            );
+            return error.InvalidDictionary;
+        }
+        options.preset_dict = bytes.ptr;
+        options.preset_dict_size = @intCast(bytes.len);
+    }
+    return options;
+}
+
 const LzmaAllocator = struct {
     allocator: std.mem.Allocator,
     map: std.AutoHashMap([*]align(alignment) u8, usize),
@@ -397,3 +482,38 @@ test "XzDecoder should decode the same values that the XzEncoder encoded" {
         try testing.expectEqual(i, reader.takeInt(usize, .little));
     }
 }
+
+test "XzDecoder should decode the same values that the XzEncoder encoded with a preset dictionary" {
+    errdefer |err| misc.error_context.logError(err);
+    var buffer: [64]u8 = undefined;
+    var dictionary: [100 * @sizeOf(usize)]u8 = undefined;
+    for (0..100) |i| {
+        std.mem.writeInt(usize, dictionary[(i * @sizeOf(usize))..][0..@sizeOf(usize)], i, .little);
+    }
+
+    var dest_writer = std.io.Writer.Allocating.init(testing.allocator);
+    defer dest_writer.deinit();
+    var encoder = try XzEncoder.initWithDictionary(testing.allocator, &dest_writer.writer, &dictionary);
+    defer encoder.deinit();
+
+    var writter = encoder.writer(&buffer);
+    for (0..100) |i| {
+        try writter.writeInt(usize, i, .little);
+    }
+    try writter.flush();
+    try testing.expectEqual(std.hash.Crc32.hash(&dictionary), encoder.getChecksum());
+
+    const encoded = try dest_writer.toOwnedSlice();
+    defer testing.allocator.free(encoded);
+    try testing.expect(!isXzStream(encoded));
+    try testing.expect(encoded.len < 64);
+
+    var src_reader = std.io.Reader.fixed(encoded);
+    var decoder = try XzDecoder.initWithDictionary(testing.allocator, &src_reader, &dictionary);
+    defer decoder.deinit();
+    var reader = decoder.reader(&buffer);
+
+    for (0..100) |i| {
+        try testing.expectEqual(i, reader.takeInt(usize, .little));
+    }
+}
@@ -73,6 +73,8 @@ pub fn StructProxy(comptime Struct: type) type {
 
         pub fn takePartialCopy(self: *const Self) misc.Partial(Struct) {
             var copy: misc.Partial(Struct) = undefined;
+            // Keeps payloads of missing fields and padding deterministic, so copies of unchanged memory are equal.
+            @memset(std.mem.asBytes(&copy), 0);
             inline for (struct_fields) |*field| {
                 if (self.findConstFieldPointer(field.name)) |value_pointer| {
                     @field(copy, field.name) = value_pointer.*;
@@ -0,0 +1,79 @@
+const std = @import("std");
+const misc = @import("root.zig");
+
+// Bounded queue for passing items between threads. Pushing blocks while the channel is full and popping blocks while
+// the channel is empty. Once closed, pushing fails and popping returns the remaining items followed by null.
+pub fn Channel(comptime Item: type, comptime capacity: usize) type {
+    return struct {
+        items: misc.CircularBuffer(capacity, Item) = .{},
+        mutex: std.Thread.Mutex = .{},
+        condition: std.Thread.Condition = .{},
+        is_closed: bool = false,
+
+        const Self = @This();
+
+        pub fn push(self: *Self, item: Item) !void {
+            self.mutex.lock();
+            defer self.mutex.unlock();
+            while (!self.is_closed and self.items.len >= capacity) {
+                self.condition.wait(&self.mutex);
+            }
+            if (self.is_closed) {
+                misc.error_context.new("Failed to push item into a closed channel.", .{});
+                return error.ChannelClosed;
+            }
+            _ = self.items.addToBack(item);
+            self.condition.broadcast();
+        }
+
+        pub fn pop(self: *Self) ?Item {
+            self.mutex.lock();
+            defer self.mutex.unlock();
+            while (!self.is_closed and self.items.len == 0) {
+                self.condition.wait(&self.mutex);
+            }
+            const item = self.items.removeFirst() catch return null;
+            self.condition.broadcast();
+            return item;
+        }
+
+        pub fn close(self: *Self) void {
+            self.mutex.lock();
+            defer self.mutex.unlock();
+            self.is_closed = true;
+            self.condition.broadcast();
+        }
+    };
+}
+
+const testing = std.testing;
+
+test "pop should return items in the same order they were pushed from another thread" {
+    var channel = Channel(usize, 4){};
+    const thread = try std.Thread.spawn(.{}, struct {
+        fn call(c: *Channel(usize, 4)) void {
+            for (0..100) |index| {
+                c.push(index) catch @panic("Failed to push item.");
+            }
+            c.close();
+        }
+    }.call, .{&channel});
+    defer thread.join();
+
+    var expected: usize = 0;
+    while (channel.pop()) |item| : (expected += 1) {
+        try testing.expectEqual(expected, item);
+    }
+    try testing.expectEqual(100, expected);
+}
+
+test "closed channel should return remaining items and refuse new ones" {
+    var channel = Channel(usize, 4){};
+    try channel.push(1);
+    try channel.push(2);
+    channel.close();
+    try testing.expectError(error.ChannelClosed, channel.push(3));
+    try testing.expectEqual(1, channel.pop());
+    try testing.expectEqual(2, channel.pop());
+    try testing.expectEqual(null, channel.pop());
+}
@@ -26,6 +26,17 @@ pub fn CircularBuffer(comptime capacity: usize, comptime Element: type) type {
             return removed_element;
         }
 
+        // Same as addToBack, but the element gets written in place. The element that gets overwritten when the buffer
+        // is full doesn't get copied out, which matters when elements are large.
+        pub fn addOneToBack(self: *Self) *Element {
+            if (self.len >= capacity) {
+                self.start_index = self.getArrayIndex(1);
+            } else {
+                self.len += 1;
+            }
+            return self.getMut(self.len - 1) catch unreachable;
+        }
+
         pub fn removeFirst(self: *Self) !Element {
             const element = (try self.getFirst()).*;
             self.start_index = self.getArrayIndex(1);
@@ -138,6 +149,18 @@ test "addToBack should return the element that's been removed as the result of b
     try testing.expectEqual(2, buffer.len);
 }
 
+test "addOneToBack should return the element with the highest index and overwrite the lowest index when full" {
+    var buffer = CircularBuffer(2, i32){};
+    buffer.addOneToBack().* = 1;
+    buffer.addOneToBack().* = 2;
+    try testing.expectEqual(1, (try buffer.get(0)).*);
+    try testing.expectEqual(2, (try buffer.get(1)).*);
+    buffer.addOneToBack().* = 3;
+    try testing.expectEqual(2, (try buffer.get(0)).*);
+    try testing.expectEqual(3, (try buffer.get(1)).*);
+    try testing.expectEqual(2, buffer.len);
+}
+
 test "removeFirst should remove and return the element with the lowest index" {
     var buffer = CircularBuffer(5, i32){};
     _ = buffer.addToBack(1);
@@ -125,6 +125,18 @@ pub fn ErrorContext(comptime config: ErrorContextConfig) type {
             self.items.clear();
         }
 
+        // Error context is thread local, so errors that happen on worker threads carry their context over this way.
+        pub fn copyFrom(self: *Self, other: *const Self) void {
+            self.clear();
+            for (0..other.items.len) |index| {
+                const item = other.items.get(index) catch unreachable;
+                switch (item.message) {
+                    .static => |message| _ = self.items.addToBack(.{ .message = .{ .static = message } }),
+                    .dynamic => |message| self.dynamicAppend("{s}", .{message}),
+                }
+            }
+        }
+
         pub fn logError(self: *const Self, err: anyerror) void {
             if (self.items.getLast() catch null) |last_item| {
                 const message = switch (last_item.message) {
@@ -192,6 +204,22 @@ test "should correctly format error message" {
     try testing.expectEqualStrings("No items inside the error context.", message_3);
 }
 
+test "copyFrom should replace the items with copies of the other context's items" {
+    var source = ErrorContext(.{}){};
+    var destination = ErrorContext(.{}){};
+    var number: i32 = 1;
+    source.new("Error 1.", .{});
+    source.append("Error: {}", .{number});
+    destination.new("Error 3.", .{});
+
+    destination.copyFrom(&source);
+    number = 2;
+    source.new("Error: {}", .{number});
+    const message = try std.fmt.allocPrint(testing.allocator, "{f}", .{destination});
+    defer testing.allocator.free(message);
+    try testing.expectEqualStrings("1) Error: 1\n2) Error 1.\n", message);
+}
+
 test "should discard earliest items when exceeding max items" {
     var context = ErrorContext(.{
         .buffer_size = 4096,
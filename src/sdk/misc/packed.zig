@@ -0,0 +1,271 @@
+const std = @import("std");
+
+// Representation of a type that has no padding and no optional tags. Validity of every optional inside the type is a
+// single bit inside the bitmap and all the payloads are stored one after another as raw bytes.
+// Payloads of null optionals and of inactive union fields are zeroed, so equal values always pack into equal bytes.
+pub fn Packed(comptime Type: type) type {
+    const layout = comptime getLayout(Type);
+    return extern struct {
+        bitmap: [bitmap_size]u8,
+        payload: [payload_size]u8,
+
+        const Self = @This();
+        pub const Unpacked = Type;
+        pub const bitmap_size = std.math.divCeil(usize, layout.bits, 8) catch unreachable;
+        pub const payload_size = layout.bytes;
+
+        pub fn pack(value: *const Type) Self {
+            var self: Self = undefined;
+            @memset(&self.bitmap, 0);
+            packValue(Type, 0, 0, value, &self.bitmap, &self.payload);
+            return self;
+        }
+
+        pub fn unpack(self: *const Self) Type {
+            var value: Type = undefined;
+            unpackValue(Type, 0, 0, &value, &self.bitmap, &self.payload);
+            return value;
+        }
+    };
+}
+
+const Layout = struct {
+    bits: usize = 0,
+    bytes: usize = 0,
+};
+
+fn getLayout(comptime Type: type) Layout {
+    if (isScalar(Type)) {
+        return .{ .bytes = @sizeOf(Type) };
+    }
+    switch (@typeInfo(Type)) {
+        .void => return .{},
+        .optional => |*info| {
+            const child = getLayout(info.child);
+            return .{ .bits = 1 + child.bits, .bytes = child.bytes };
+        },
+        .array => |*info| {
+            const child = getLayout(info.child);
+            return .{ .bits = info.len * child.bits, .bytes = info.len * child.bytes };
+        },
+        .@"struct" => |*info| {
+            var layout = Layout{};
+            for (info.fields) |*field| {
+                if (field.is_comptime) {
+                    continue;
+                }
+                const field_layout = getLayout(field.type);
+                layout.bits += field_layout.bits;
+                layout.bytes += field_layout.bytes;
+            }
+            return layout;
+        },
+        .@"union" => |*info| {
+            const Tag = info.tag_type orelse @compileError("Untagged unions are not supported: " ++ @typeName(Type));
+            var largest = Layout{};
+            for (info.fields) |*field| {
+                const field_layout = getLayout(field.type);
+                largest.bits = @max(largest.bits, field_layout.bits);
+                largest.bytes = @max(largest.bytes, field_layout.bytes);
+            }
+            return .{ .bits = largest.bits, .bytes = @sizeOf(Tag) + largest.bytes };
+        },
+        else => @compileError("Unsupported type: " ++ @typeName(Type)),
+    }
+}
+
+// Types that have no padding or tags worth removing, so they get stored as their raw bytes.
+fn isScalar(comptime Type: type) bool {
+    return switch (@typeInfo(Type)) {
+        .bool, .int, .float, .@"enum" => true,
+        .@"struct" => |*info| info.layout == .@"packed",
+        else => false,
+    };
+}
+
+fn packValue(
+    comptime Type: type,
+    bit: usize,
+    byte: usize,
+    value: *const Type,
+    bitmap: []u8,
+    payload: []u8,
+) void {
+    if (comptime isScalar(Type)) {
+        @memcpy(payload[byte..][0..@sizeOf(Type)], std.mem.asBytes(value));
+        return;
+    }
+    switch (@typeInfo(Type)) {
+        .void => {},
+        .optional => |*info| {
+            if (value.*) |*child| {
+                bitmap[bit / 8] |= @as(u8, 1) << @intCast(bit % 8);
+                packValue(info.child, bit + 1, byte, child, bitmap, payload);
+            } else {
+                @memset(payload[byte..][0..comptime getLayout(info.child).bytes], 0);
+            }
+        },
+        .array => |*info| {
+            const child = comptime getLayout(info.child);
+            for (value, 0..) |*element, index| {
+                packValue(info.child, bit + (index * child.bits), byte + (index * child.bytes), element, bitmap, payload);
+            }
+        },
+        .@"struct" => |*info| {
+            comptime var field_bit = 0;
+            comptime var field_byte = 0;
+            inline for (info.fields) |*field| {
+                if (field.is_comptime) {
+                    continue;
+                }
+                const field_value = &@field(value.*, field.name);
+                packValue(field.type, bit + field_bit, byte + field_byte, field_value, bitmap, payload);
+                const field_layout = comptime getLayout(field.type);
+                field_bit += field_layout.bits;
+                field_byte += field_layout.bytes;
+            }
+        },
+        .@"union" => |*info| {
+            const Tag = info.tag_type.?;
+            const tag: Tag = value.*;
+            @memcpy(payload[byte..][0..@sizeOf(Tag)], std.mem.asBytes(&tag));
+            const field_byte = byte + @sizeOf(Tag);
+            @memset(payload[field_byte..][0..(comptime getLayout(Type).bytes - @sizeOf(Tag))], 0);
+            switch (value.*) {
+                inline else => |*field_value| {
+                    packValue(@TypeOf(field_value.*), bit, field_byte, field_value, bitmap, payload);
+                },
+            }
+        },
+        else => @compileError("Unsupported type: " ++ @typeName(Type)),
+    }
+}
+
+fn unpackValue(
+    comptime Type: type,
+    bit: usize,
+    byte: usize,
+    value: *Type,
+    bitmap: []const u8,
+    payload: []const u8,
+) void {
+    if (comptime isScalar(Type)) {
+        @memcpy(std.mem.asBytes(value), payload[byte..][0..@sizeOf(Type)]);
+        return;
+    }
+    switch (@typeInfo(Type)) {
+        .void => {},
+        .optional => |*info| {
+            if (bitmap[bit / 8] & (@as(u8, 1) << @intCast(bit % 8)) != 0) {
+                var child: info.child = undefined;
+                unpackValue(info.child, bit + 1, byte, &child, bitmap, payload);
+                value.* = child;
+            } else {
+                value.* = null;
+            }
+        },
+        .array => |*info| {
+            const child = comptime getLayout(info.child);
+            for (value, 0..) |*element, index| {
+                unpackValue(info.child, bit + (index * child.bits), byte + (index * child.bytes), element, bitmap, payload);
+            }
+        },
+        .@"struct" => |*info| {
+            comptime var field_bit = 0;
+            comptime var field_byte = 0;
+            inline for (info.fields) |*field| {
+                if (field.is_comptime) {
+                    continue;
+                }
+                const field_value = &@field(value.*, field.name);
+                unpackValue(field.type, bit + field_bit, byte + field_byte, field_value, bitmap, payload);
+                const field_layout = comptime getLayout(field.type);
+                field_bit += field_layout.bits;
+                field_byte += field_layout.bytes;
+            }
+        },
+        .@"union" => |*info| {
+            const Tag = info.tag_type.?;
+            var tag: Tag = undefined;
+            @memcpy(std.mem.asBytes(&tag), payload[byte..][0..@sizeOf(Tag)]);
+            const field_byte = byte + @sizeOf(Tag);
+            switch (tag) {
+                inline else => |comptime_tag| {
+                    const name = @tagName(comptime_tag);
+                    const Field = @FieldType(Type, name);
+                    var field_value: Field = undefined;
+                    unpackValue(Field, bit, field_byte, &field_value, bitmap, payload);
+                    value.* = @unionInit(Type, name, field_value);
+                },
+            }
+        },
+        else => @compileError("Unsupported type: " ++ @typeName(Type)),
+    }
+}
+
+const testing = std.testing;
+
+test "unpack should return the same value that was packed" {
+    const Type = struct {
+        a: ?u32,
+        b: ?f32,
+        c: [3]?struct { x: f32, y: ?bool },
+        d: union(enum(u2)) { i: ?i16, v: void, s: struct { p: u8, q: ?u64 } },
+        e: packed struct { f1: bool, f2: u7 },
+        f: enum { one, two },
+    };
+    const values = [_]Type{
+        .{
+            .a = 1,
+            .b = null,
+            .c = .{ .{ .x = 1, .y = true }, null, .{ .x = 3, .y = null } },
+            .d = .{ .s = .{ .p = 4, .q = 5 } },
+            .e = .{ .f1 = true, .f2 = 6 },
+            .f = .two,
+        },
+        .{
+            .a = null,
+            .b = 7.5,
+            .c = .{ null, null, null },
+            .d = .{ .i = -8 },
+            .e = .{ .f1 = false, .f2 = 9 },
+            .f = .one,
+        },
+        .{
+            .a = 10,
+            .b = 11,
+            .c = .{ .{ .x = 12, .y = false }, .{ .x = 13, .y = true }, .{ .x = 14, .y = false } },
+            .d = .v,
+            .e = .{ .f1 = true, .f2 = 0 },
+            .f = .one,
+        },
+    };
+    for (&values) |*value| {
+        const packed_value = Packed(Type).pack(value);
+        try testing.expectEqualDeep(value.*, packed_value.unpack());
+    }
+}
+
+test "Packed should be smaller then the unpacked type" {
+    const Type = struct {
+        a: ?u32,
+        b: ?f32,
+        c: [4]?struct { x: f32, y: ?u8 },
+        d: ?bool,
+    };
+    // 1 + 1 + 4 * (1 + 1) + 1 validity bits and 4 + 4 + 4 * (4 + 1) + 1 payload bytes.
+    try testing.expectEqual(2, Packed(Type).bitmap_size);
+    try testing.expectEqual(29, Packed(Type).payload_size);
+    try testing.expect(@sizeOf(Packed(Type)) < @sizeOf(Type));
+}
+
+test "pack should produce equal bytes for equal values no matter what the null payloads contained" {
+    const Type = struct { a: ?u32, b: union(enum) { x: u64, y: u8 } };
+    var value_1: Type = .{ .a = 123, .b = .{ .x = std.math.maxInt(u64) } };
+    value_1.a = null;
+    value_1.b = .{ .y = 1 };
+    const value_2: Type = .{ .a = null, .b = .{ .y = 1 } };
+    const packed_1 = Packed(Type).pack(&value_1);
+    const packed_2 = Packed(Type).pack(&value_2);
+    try testing.expectEqualSlices(u8, std.mem.asBytes(&packed_1), std.mem.asBytes(&packed_2));
+}
@@ -1,15 +1,22 @@
 pub const BaseDir = @import("base_dir.zig").BaseDir;
+pub const Channel = @import("channel.zig").Channel;
 pub const CircularBuffer = @import("circular_buffer.zig").CircularBuffer;
 pub const ErrorContextConfig = @import("error_context.zig").ErrorContextConfig;
 pub const ErrorContextItem = @import("error_context.zig").ErrorContextItem;
 pub const ErrorContextMessage = @import("error_context.zig").ErrorContextMessage;
 pub const ErrorContext = @import("error_context.zig").ErrorContext;
 pub threadlocal var error_context = ErrorContext(.{}){};
+pub const Packed = @import("packed.zig").Packed;
 pub const Partial = @import("meta.zig").Partial;
 pub const FieldMap = @import("meta.zig").FieldMap;
 pub const areAllFieldsNull = @import("meta.zig").areAllFieldsNull;
 pub const enumArrayToEnumFieldStruct = @import("meta.zig").enumArrayToEnumFieldStruct;
+pub const TaggingAllocator = @import("tagging_allocator.zig").TaggingAllocator;
 pub const Task = @import("task.zig").Task;
+pub const ThreadPoolConfig = @import("thread_pool.zig").ThreadPoolConfig;
+pub const JobContext = @import("thread_pool.zig").JobContext;
+pub const Future = @import("thread_pool.zig").Future;
+pub const ThreadPool = @import("thread_pool.zig").ThreadPool;
 pub const Timer = @import("timer.zig").Timer;
 pub const TimerConfig = @import("timer.zig").TimerConfig;
 pub const Timestamp = @import("timestamp.zig").Timestamp;
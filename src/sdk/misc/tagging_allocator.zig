@@ -0,0 +1,194 @@
+const std = @import("std");
+
+// Wraps the parent allocator and counts the memory used by every tag separately.
+// Counting is done with relaxed atomic operations, so it's cheap enough to always stay on and safe to share between
+// threads. Memory has to be freed with an allocator of the same tag that allocated it, otherwise the counts drift.
+pub fn TaggingAllocator(comptime Tag: type) type {
+    return struct {
+        parent: std.mem.Allocator,
+        counters: std.EnumArray(Tag, Counters),
+
+        const Self = @This();
+
+        const Counters = struct {
+            live_bytes: std.atomic.Value(usize) = .init(0),
+            peak_bytes: std.atomic.Value(usize) = .init(0),
+            live_allocations: std.atomic.Value(usize) = .init(0),
+            total_allocations: std.atomic.Value(usize) = .init(0),
+            total_bytes: std.atomic.Value(usize) = .init(0),
+        };
+
+        pub const Stats = struct {
+            live_bytes: usize = 0,
+            peak_bytes: usize = 0,
+            live_allocations: usize = 0,
+            total_allocations: usize = 0,
+            total_bytes: usize = 0,
+        };
+
+        pub fn init(parent: std.mem.Allocator) Self {
+            return .{ .parent = parent, .counters = .initFill(.{}) };
+        }
+
+        pub fn allocator(self: *Self, comptime tag: Tag) std.mem.Allocator {
+            return .{ .ptr = self, .vtable = &Functions(tag).vtable };
+        }
+
+        pub fn getStats(self: *const Self, tag: Tag) Stats {
+            const counters = self.counters.getPtrConst(tag);
+            return .{
+                .live_bytes = counters.live_bytes.load(.monotonic),
+                .peak_bytes = counters.peak_bytes.load(.monotonic),
+                .live_allocations = counters.live_allocations.load(.monotonic),
+                .total_allocations = counters.total_allocations.load(.monotonic),
+                .total_bytes = counters.total_bytes.load(.monotonic),
+            };
+        }
+
+        pub fn logStats(self: *const Self) void {
+            for (std.enums.values(Tag)) |tag| {
+                const stats = self.getStats(tag);
+                std.log.info(
+                    "Memory [{s}]: live {Bi:.2} in {} allocations, peak {Bi:.2}, total {Bi:.2} in {} allocations",
+                    .{
+                        @tagName(tag),
+                        stats.live_bytes,
+                        stats.live_allocations,
+                        stats.peak_bytes,
+                        stats.total_bytes,
+                        stats.total_allocations,
+                    },
+                );
+            }
+        }
+
+        fn onGrow(self: *Self, tag: Tag, bytes: usize) void {
+            const counters = self.counters.getPtr(tag);
+            const live_bytes = counters.live_bytes.fetchAdd(bytes, .monotonic) + bytes;
+            _ = counters.peak_bytes.fetchMax(live_bytes, .monotonic);
+            _ = counters.total_bytes.fetchAdd(bytes, .monotonic);
+        }
+
+        fn onShrink(self: *Self, tag: Tag, bytes: usize) void {
+            _ = self.counters.getPtr(tag).live_bytes.fetchSub(bytes, .monotonic);
+        }
+
+        fn onResize(self: *Self, tag: Tag, old_len: usize, new_len: usize) void {
+            if (new_len > old_len) {
+                self.onGrow(tag, new_len - old_len);
+            } else {
+                self.onShrink(tag, old_len - new_len);
+            }
+        }
+
+        fn Functions(comptime tag: Tag) type {
+            return struct {
+                const vtable = std.mem.Allocator.VTable{
+                    .alloc = alloc,
+                    .resize = resize,
+                    .remap = remap,
+                    .free = free,
+                };
+
+                fn alloc(context: *anyopaque, len: usize, alignment: std.mem.Alignment, ret_addr: usize) ?[*]u8 {
+                    const self: *Self = @ptrCast(@alignCast(context));
+                    const result = self.parent.rawAlloc(len, alignment, ret_addr) orelse return null;
+                    const counters = self.counters.getPtr(tag);
+                    _ = counters.live_allocations.fetchAdd(1, .monotonic);
+                    _ = counters.total_allocations.fetchAdd(1, .monotonic);
+                    self.onGrow(tag, len);
+                    return result;
+                }
+
+                fn resize(
+                    context: *anyopaque,
+                    memory: []u8,
+                    alignment: std.mem.Alignment,
+                    new_len: usize,
+                    ret_addr: usize,
+                ) bool {
+                    const self: *Self = @ptrCast(@alignCast(context));
+                    if (!self.parent.rawResize(memory, alignment, new_len, ret_addr)) {
+                        return false;
+                    }
+                    self.onResize(tag, memory.len, new_len);
+                    return true;
+                }
+
+                fn remap(
+                    context: *anyopaque,
+                    memory: []u8,
+                    alignment: std.mem.Alignment,
+                    new_len: usize,
+                    ret_addr: usize,
+                ) ?[*]u8 {
+                    const self: *Self = @ptrCast(@alignCast(context));
+                    const result = self.parent.rawRemap(memory, alignment, new_len, ret_addr) orelse return null;
+                    self.onResize(tag, memory.len, new_len);
+                    return result;
+                }
+
+                fn free(context: *anyopaque, memory: []u8, alignment: std.mem.Alignment, ret_addr: usize) void {
+                    const self: *Self = @ptrCast(@alignCast(context));
+                    self.parent.rawFree(memory, alignment, ret_addr);
+                    _ = self.counters.getPtr(tag).live_allocations.fetchSub(1, .monotonic);
+                    self.onShrink(tag, memory.len);
+                }
+            };
+        }
+    };
+}
+
+const testing = std.testing;
+
+test "should count live bytes, peak bytes and allocations per tag" {
+    const Tag = enum { a, b };
+    var tagging_allocator = TaggingAllocator(Tag).init(testing.allocator);
+    const allocator_a = tagging_allocator.allocator(.a);
+    const allocator_b = tagging_allocator.allocator(.b);
+
+    const slice_1 = try allocator_a.alloc(u8, 100);
+    const slice_2 = try allocator_a.alloc(u8, 50);
+    const slice_3 = try allocator_b.alloc(u8, 10);
+    allocator_a.free(slice_1);
+
+    try testing.expectEqual(TaggingAllocator(Tag).Stats{
+        .live_bytes = 50,
+        .peak_bytes = 150,
+        .live_allocations = 1,
+        .total_allocations = 2,
+        .total_bytes = 150,
+    }, tagging_allocator.getStats(.a));
+    try testing.expectEqual(TaggingAllocator(Tag).Stats{
+        .live_bytes = 10,
+        .peak_bytes = 10,
+        .live_allocations = 1,
+        .total_allocations = 1,
+        .total_bytes = 10,
+    }, tagging_allocator.getStats(.b));
+
+    allocator_a.free(slice_2);
+    allocator_b.free(slice_3);
+    try testing.expectEqual(0, tagging_allocator.getStats(.a).live_bytes);
+    try testing.expectEqual(0, tagging_allocator.getStats(.b).live_bytes);
+}
+
+test "should count resized memory" {
+    const Tag = enum { a };
+    var tagging_allocator = TaggingAllocator(Tag).init(testing.allocator);
+    const allocator = tagging_allocator.allocator(.a);
+
+    var list: std.ArrayList(u8) = .empty;
+    for (0..1000) |index| {
+        try list.append(allocator, @truncate(index));
+    }
+    try testing.expectEqual(list.capacity, tagging_allocator.getStats(.a).live_bytes);
+    list.shrinkAndFree(allocator, 10);
+    try testing.expectEqual(list.capacity, tagging_allocator.getStats(.a).live_bytes);
+    list.deinit(allocator);
+
+    const stats = tagging_allocator.getStats(.a);
+    try testing.expectEqual(0, stats.live_bytes);
+    try testing.expectEqual(0, stats.live_allocations);
+    try testing.expect(stats.peak_bytes >= 1000);
+}
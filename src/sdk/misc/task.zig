@@ -1,56 +1,36 @@
 const std = @import("std");
 const misc = @import("root.zig");
 
+// Runs the function on the default thread pool. Kept for callers that only need a single result to peek at or join.
 pub fn Task(comptime Result: type) type {
     return union(enum) {
-        in_progress: InProgress,
+        in_progress: misc.Future(Result),
         completed: Result,
 
         const Self = @This();
-        const State = struct {
-            result: Result,
-            is_ready: std.atomic.Value(bool),
-        };
-        const InProgress = struct {
-            allocator: std.mem.Allocator,
-            state: *State,
-            thread: std.Thread,
-        };
 
         pub fn spawn(allocator: std.mem.Allocator, comptime function: anytype, args: anytype) !Self {
-            const state = allocator.create(State) catch |err| {
-                misc.error_context.new("Failed to allocate the state memory.", .{});
+            const pool = misc.ThreadPool.getDefault() catch |err| {
+                misc.error_context.append("Failed to get the default thread pool.", .{});
                 return err;
             };
-            errdefer allocator.destroy(state);
-            state.* = .{
-                .result = undefined,
-                .is_ready = .init(false),
-            };
-            const thread = std.Thread.spawn(.{}, struct {
-                fn call(thread_state: *State, arguments: anytype) void {
-                    const result = @call(.auto, function, arguments);
-                    thread_state.result = result;
-                    thread_state.is_ready.store(true, .seq_cst);
+            const future = pool.spawn(allocator, struct {
+                // Lets the function return anything that coerces into the result.
+                fn call(arguments: @TypeOf(args)) Result {
+                    return @call(.auto, function, arguments);
                 }
-            }.call, .{ state, args }) catch |err| {
-                misc.error_context.new("Failed to spawn the task thread.", .{});
+            }.call, .{args}) catch |err| {
+                misc.error_context.append("Failed to spawn the task job.", .{});
                 return err;
             };
-            errdefer thread.join();
-            return .{ .in_progress = .{
-                .allocator = allocator,
-                .state = state,
-                .thread = thread,
-            } };
+            return .{ .in_progress = future };
         }
 
         pub fn join(self: *Self) *Result {
             switch (self.*) {
-                .in_progress => |*task| {
-                    task.thread.join();
-                    const result = task.state.result;
-                    task.allocator.destroy(task.state);
+                .in_progress => |*future| {
+                    // Tasks never get cancelled, so the result is always there.
+                    const result = future.join() catch unreachable;
                     self.* = .{ .completed = result };
                     return &self.completed;
                 },
@@ -64,9 +44,8 @@ pub fn Task(comptime Result: type) type {
 
         pub fn peek(self: *Self) ?*Result {
             switch (self.*) {
-                .in_progress => |*task| {
-                    const is_ready = task.state.is_ready.load(.seq_cst);
-                    if (is_ready) {
+                .in_progress => |*future| {
+                    if (future.isDone()) {
                         return self.join();
                     } else {
                         return null;
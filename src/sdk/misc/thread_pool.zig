@@ -0,0 +1,509 @@
+const std = @import("std");
+const misc = @import("root.zig");
+
+pub const ThreadPoolConfig = struct {
+    // Null means one thread per CPU core.
+    number_of_threads: ?usize = null,
+};
+
+// Handed to jobs whose function takes *JobContext as the first parameter.
+pub const JobContext = struct {
+    is_cancelled: std.atomic.Value(bool) = .init(false),
+    progress: std.atomic.Value(u32) = .init(@bitCast(@as(f32, 0))),
+
+    const Self = @This();
+
+    // Long running jobs should check this once in a while and return early when it's true.
+    pub fn isCancelled(self: *const Self) bool {
+        return self.is_cancelled.load(.monotonic);
+    }
+
+    // Progress goes from 0 to 1.
+    pub fn setProgress(self: *Self, progress: f32) void {
+        self.progress.store(@bitCast(std.math.clamp(progress, 0, 1)), .monotonic);
+    }
+
+    pub fn getProgress(self: *const Self) f32 {
+        return @bitCast(self.progress.load(.monotonic));
+    }
+};
+
+// Result of a job that was spawned on a thread pool. Every future has to be joined exactly once.
+pub fn Future(comptime Result: type) type {
+    return struct {
+        shared: *Shared,
+
+        const Self = @This();
+        pub const Shared = struct {
+            job: ThreadPool.Job,
+            pool: *ThreadPool,
+            context: JobContext = .{},
+            is_done: std.Thread.ResetEvent = .{},
+            // Stays null when the job got cancelled before it started.
+            result: ?Result = null,
+            destroy: *const fn (shared: *Shared) void,
+        };
+
+        pub fn isDone(self: *const Self) bool {
+            return self.shared.is_done.isSet();
+        }
+
+        // Jobs that didn't start yet get skipped. Jobs that already started have to check JobContext.isCancelled.
+        pub fn cancel(self: *const Self) void {
+            self.shared.context.is_cancelled.store(true, .monotonic);
+        }
+
+        pub fn getProgress(self: *const Self) f32 {
+            return self.shared.context.getProgress();
+        }
+
+        pub fn join(self: *const Self) !Result {
+            self.shared.pool.waitFor(&self.shared.is_done);
+            defer self.shared.destroy(self.shared);
+            return self.shared.result orelse {
+                misc.error_context.new("Job got cancelled before it started.", .{});
+                return error.Cancelled;
+            };
+        }
+    };
+}
+
+// Fixed number of worker threads, each with a queue of it's own. Jobs spawned from a worker go to the front of that
+// worker's queue and get executed by it in LIFO order, which keeps related data in the cache. Idle workers steal from
+// the back of other queues. Jobs spawned from other threads go into a shared FIFO queue.
+pub const ThreadPool = struct {
+    allocator: std.mem.Allocator,
+    workers: []Worker,
+    injected: Queue,
+    number_of_queued: std.atomic.Value(usize),
+    mutex: std.Thread.Mutex,
+    condition: std.Thread.Condition,
+    is_shutting_down: bool,
+
+    const Self = @This();
+    const chunks_per_thread = 4;
+    const helping_wait_ns = 100 * std.time.ns_per_us;
+
+    pub const Job = struct {
+        node: std.DoublyLinkedList.Node = .{},
+        run: *const fn (job: *Job) void,
+    };
+
+    const Queue = struct {
+        mutex: std.Thread.Mutex = .{},
+        list: std.DoublyLinkedList = .{},
+
+        fn pushFront(self: *Queue, job: *Job) void {
+            self.mutex.lock();
+            defer self.mutex.unlock();
+            self.list.prepend(&job.node);
+        }
+
+        fn pushBack(self: *Queue, job: *Job) void {
+            self.mutex.lock();
+            defer self.mutex.unlock();
+            self.list.append(&job.node);
+        }
+
+        fn popFront(self: *Queue) ?*Job {
+            self.mutex.lock();
+            defer self.mutex.unlock();
+            const node = self.list.popFirst() orelse return null;
+            return @fieldParentPtr("node", node);
+        }
+
+        fn popBack(self: *Queue) ?*Job {
+            self.mutex.lock();
+            defer self.mutex.unlock();
+            const node = self.list.pop() orelse return null;
+            return @fieldParentPtr("node", node);
+        }
+    };
+
+    const Worker = struct {
+        pool: *Self,
+        index: usize,
+        queue: Queue = .{},
+        thread: ?std.Thread = null,
+    };
+
+    threadlocal var current_worker: ?*Worker = null;
+    var default_pool: Self = undefined;
+    var default_pool_state: enum { not_initialized, initialized } = .not_initialized;
+    var default_pool_mutex: std.Thread.Mutex = .{};
+
+    // Workers keep a pointer to the pool, so the pool gets initialized in place and must not move afterwards.
+    pub fn init(self: *Self, allocator: std.mem.Allocator, config: ThreadPoolConfig) !void {
+        const number_of_threads = @max(config.number_of_threads orelse std.Thread.getCpuCount() catch 1, 1);
+        const workers = allocator.alloc(Worker, number_of_threads) catch |err| {
+            misc.error_context.new("Failed to allocate {} workers.", .{number_of_threads});
+            return err;
+        };
+        self.* = .{
+            .allocator = allocator,
+            .workers = workers,
+            .injected = .{},
+            .number_of_queued = .init(0),
+            .mutex = .{},
+            .condition = .{},
+            .is_shutting_down = false,
+        };
+        for (workers, 0..) |*worker, index| {
+            worker.* = .{ .pool = self, .index = index };
+        }
+        errdefer self.deinit();
+        for (workers) |*worker| {
+            worker.thread = std.Thread.spawn(.{}, workerMain, .{worker}) catch |err| {
+                misc.error_context.new("Failed to spawn worker thread {}.", .{worker.index});
+                return err;
+            };
+        }
+    }
+
+    // Executes all the jobs that are still queued before returning.
+    pub fn deinit(self: *Self) void {
+        self.mutex.lock();
+        self.is_shutting_down = true;
+        self.condition.broadcast();
+        self.mutex.unlock();
+        for (self.workers) |*worker| {
+            if (worker.thread) |thread| {
+                thread.join();
+            }
+        }
+        self.allocator.free(self.workers);
+        self.* = undefined;
+    }
+
+    // Pool shared by everything that doesn't need a pool of it's own, like Task. Started on first use.
+    pub fn getDefault() !*Self {
+        default_pool_mutex.lock();
+        defer default_pool_mutex.unlock();
+        if (default_pool_state == .not_initialized) {
+            const number_of_threads = std.math.clamp(std.Thread.getCpuCount() catch 2, 2, 16);
+            default_pool.init(std.heap.page_allocator, .{ .number_of_threads = number_of_threads }) catch |err| {
+                misc.error_context.append("Failed to initialize the default thread pool.", .{});
+                return err;
+            };
+            default_pool_state = .initialized;
+        }
+        return &default_pool;
+    }
+
+    // Has to be called before unloading code that used the default pool, once all of it's futures got joined.
+    pub fn deinitDefault() void {
+        default_pool_mutex.lock();
+        defer default_pool_mutex.unlock();
+        if (default_pool_state == .initialized) {
+            default_pool.deinit();
+            default_pool_state = .not_initialized;
+        }
+    }
+
+    // When the function's first parameter is *JobContext, the job's context gets passed before the arguments.
+    // The allocator is used only for the future's state, which gets freed by Future.join.
+    pub fn spawn(
+        self: *Self,
+        allocator: std.mem.Allocator,
+        comptime function: anytype,
+        args: anytype,
+    ) !Future(@typeInfo(@TypeOf(function)).@"fn".return_type.?) {
+        const Result = @typeInfo(@TypeOf(function)).@"fn".return_type.?;
+        const Shared = Future(Result).Shared;
+        const Closure = struct {
+            shared: Shared,
+            allocator: std.mem.Allocator,
+            args: @TypeOf(args),
+
+            fn run(job: *Job) void {
+                const shared: *Shared = @fieldParentPtr("job", job);
+                const closure: *@This() = @fieldParentPtr("shared", shared);
+                if (!shared.context.isCancelled()) {
+                    shared.result = if (comptime takesContext(function))
+                        @call(.auto, function, .{&shared.context} ++ closure.args)
+                    else
+                        @call(.auto, function, closure.args);
+                }
+                shared.is_done.set();
+            }
+
+            fn destroy(shared: *Shared) void {
+                const closure: *@This() = @fieldParentPtr("shared", shared);
+                closure.allocator.destroy(closure);
+            }
+        };
+        const closure = allocator.create(Closure) catch |err| {
+            misc.error_context.new("Failed to allocate the job.", .{});
+            return err;
+        };
+        closure.* = .{
+            .shared = .{ .job = .{ .run = Closure.run }, .pool = self, .destroy = Closure.destroy },
+            .allocator = allocator,
+            .args = args,
+        };
+        self.submit(&closure.shared.job);
+        return .{ .shared = &closure.shared };
+    }
+
+    // Splits the range into chunks and calls the body for each chunk in parallel. The calling thread executes chunks
+    // too and the function returns once all of them are done.
+    pub fn parallelFor(
+        self: *Self,
+        allocator: std.mem.Allocator,
+        count: usize,
+        context: anytype,
+        comptime body: fn (context: @TypeOf(context), start: usize, end: usize) void,
+    ) !void {
+        if (count == 0) {
+            return;
+        }
+        const number_of_chunks = @min(count, self.workers.len * chunks_per_thread);
+        if (number_of_chunks == 1) {
+            body(context, 0, count);
+            return;
+        }
+        const Shared = struct {
+            number_of_remaining: std.atomic.Value(usize),
+            is_done: std.Thread.ResetEvent = .{},
+        };
+        const Chunk = struct {
+            job: Job = .{ .run = run },
+            shared: *Shared,
+            context: @TypeOf(context),
+            start: usize,
+            end: usize,
+
+            fn run(job: *Job) void {
+                const chunk: *@This() = @fieldParentPtr("job", job);
+                chunk.execute();
+            }
+
+            fn execute(chunk: *@This()) void {
+                body(chunk.context, chunk.start, chunk.end);
+                if (chunk.shared.number_of_remaining.fetchSub(1, .acq_rel) == 1) {
+                    chunk.shared.is_done.set();
+                }
+            }
+        };
+        const chunks = allocator.alloc(Chunk, number_of_chunks) catch |err| {
+            misc.error_context.new("Failed to allocate {} chunks.", .{number_of_chunks});
+            return err;
+        };
+        defer allocator.free(chunks);
+        var shared = Shared{ .number_of_remaining = .init(number_of_chunks) };
+        for (chunks, 0..) |*chunk, index| {
+            chunk.* = .{
+                .shared = &shared,
+                .context = context,
+                .start = count * index / number_of_chunks,
+                .end = count * (index + 1) / number_of_chunks,
+            };
+        }
+        for (chunks[1..]) |*chunk| {
+            self.submit(&chunk.job);
+        }
+        chunks[0].execute();
+        self.waitFor(&shared.is_done);
+    }
+
+    fn submit(self: *Self, job: *Job) void {
+        // Counted before the job becomes visible, so a job can never be popped before it got counted. Otherwise the
+        // decrement of the pop could land first and wrap the count around.
+        _ = self.number_of_queued.fetchAdd(1, .release);
+        if (current_worker) |worker| {
+            if (worker.pool == self) {
+                worker.queue.pushFront(job);
+            } else {
+                self.injected.pushBack(job);
+            }
+        } else {
+            self.injected.pushBack(job);
+        }
+        // Locking makes sure that a worker that just found no jobs is already waiting when the signal arrives.
+        self.mutex.lock();
+        self.condition.signal();
+        self.mutex.unlock();
+    }
+
+    // Workers waiting on other jobs execute queued jobs in the meantime, so jobs that wait on their own sub jobs can
+    // never occupy all the workers. Other threads just block.
+    fn waitFor(self: *Self, event: *std.Thread.ResetEvent) void {
+        const worker = current_worker orelse return event.wait();
+        if (worker.pool != self) {
+            return event.wait();
+        }
+        while (!event.isSet()) {
+            if (self.findJob(worker)) |job| {
+                job.run(job);
+            } else {
+                event.timedWait(helping_wait_ns) catch {};
+            }
+        }
+    }
+
+    fn findJob(self: *Self, worker: *Worker) ?*Job {
+        if (self.number_of_queued.load(.acquire) == 0) {
+            return null;
+        }
+        const job = worker.queue.popFront() orelse
+            self.injected.popFront() orelse
+            self.steal(worker) orelse
+            return null;
+        _ = self.number_of_queued.fetchSub(1, .acq_rel);
+        return job;
+    }
+
+    fn steal(self: *Self, thief: *Worker) ?*Job {
+        for (1..self.workers.len) |offset| {
+            const victim = &self.workers[(thief.index + offset) % self.workers.len];
+            if (victim.queue.popBack()) |job| {
+                return job;
+            }
+        }
+        return null;
+    }
+
+    fn workerMain(worker: *Worker) void {
+        const self = worker.pool;
+        current_worker = worker;
+        defer current_worker = null;
+        while (true) {
+            if (self.findJob(worker)) |job| {
+                job.run(job);
+                continue;
+            }
+            self.mutex.lock();
+            defer self.mutex.unlock();
+            while (self.number_of_queued.load(.acquire) == 0 and !self.is_shutting_down) {
+                self.condition.wait(&self.mutex);
+            }
+            if (self.is_shutting_down and self.number_of_queued.load(.acquire) == 0) {
+                return;
+            }
+        }
+    }
+};
+
+fn takesContext(comptime function: anytype) bool {
+    const params = @typeInfo(@TypeOf(function)).@"fn".params;
+    return params.len > 0 and params[0].type == *JobContext;
+}
+
+const testing = std.testing;
+
+test "join should return the result of the spawned function" {
+    var pool: ThreadPool = undefined;
+    try pool.init(testing.allocator, .{ .number_of_threads = 2 });
+    defer pool.deinit();
+    const future = try pool.spawn(testing.allocator, struct {
+        fn call(a: usize, b: usize) usize {
+            return a + b;
+        }
+    }.call, .{ 1, 2 });
+    try testing.expectEqual(3, try future.join());
+}
+
+test "job should receive context with progress when the function asks for it" {
+    var pool: ThreadPool = undefined;
+    try pool.init(testing.allocator, .{ .number_of_threads = 1 });
+    defer pool.deinit();
+    const future = try pool.spawn(testing.allocator, struct {
+        fn call(context: *JobContext, value: usize) usize {
+            context.setProgress(0.5);
+            return value;
+        }
+    }.call, .{123});
+    try testing.expectEqual(123, try future.join());
+}
+
+test "cancelled job should not run when it was cancelled before it started" {
+    var pool: ThreadPool = undefined;
+    try pool.init(testing.allocator, .{ .number_of_threads = 1 });
+    defer pool.deinit();
+    var is_released = std.atomic.Value(bool).init(false);
+    const blocker = try pool.spawn(testing.allocator, struct {
+        fn call(released: *std.atomic.Value(bool)) void {
+            while (!released.load(.seq_cst)) {
+                std.Thread.yield() catch {};
+            }
+        }
+    }.call, .{&is_released});
+    var counter: usize = 0;
+    const cancelled = try pool.spawn(testing.allocator, struct {
+        fn call(c: *usize) void {
+            c.* += 1;
+        }
+    }.call, .{&counter});
+    cancelled.cancel();
+    is_released.store(true, .seq_cst);
+    try blocker.join();
+    try testing.expectError(error.Cancelled, cancelled.join());
+    try testing.expectEqual(0, counter);
+}
+
+test "parallelFor should call the body exactly once for every index" {
+    var pool: ThreadPool = undefined;
+    try pool.init(testing.allocator, .{ .number_of_threads = 4 });
+    defer pool.deinit();
+    var counts = [_]std.atomic.Value(u32){.init(0)} ** 1000;
+    try pool.parallelFor(testing.allocator, counts.len, &counts, struct {
+        fn call(c: *[1000]std.atomic.Value(u32), start: usize, end: usize) void {
+            for (c[start..end]) |*count| {
+                _ = count.fetchAdd(1, .seq_cst);
+            }
+        }
+    }.call);
+    for (&counts) |*count| {
+        try testing.expectEqual(1, count.load(.seq_cst));
+    }
+}
+
+test "jobs should be able to wait on their own jobs without deadlocking a single worker" {
+    var pool: ThreadPool = undefined;
+    try pool.init(testing.allocator, .{ .number_of_threads = 1 });
+    defer pool.deinit();
+    const future = try pool.spawn(testing.allocator, struct {
+        fn call(p: *ThreadPool) usize {
+            const inner = p.spawn(testing.allocator, struct {
+                fn call() usize {
+                    return 42;
+                }
+            }.call, .{}) catch return 0;
+            return inner.join() catch 0;
+        }
+    }.call, .{&pool});
+    try testing.expectEqual(42, try future.join());
+}
+
+test "deinit should return after many jobs got submitted from several threads at the same time" {
+    var pool: ThreadPool = undefined;
+    try pool.init(testing.allocator, .{ .number_of_threads = 4 });
+    var total = std.atomic.Value(usize).init(0);
+    const Submitter = struct {
+        fn call(p: *ThreadPool, t: *std.atomic.Value(usize)) void {
+            for (0..200) |_| {
+                const future = p.spawn(testing.allocator, struct {
+                    fn call(inner_total: *std.atomic.Value(usize)) void {
+                        _ = inner_total.fetchAdd(1, .seq_cst);
+                    }
+                }.call, .{t}) catch @panic("Failed to spawn a job.");
+                p.parallelFor(testing.allocator, 64, t, struct {
+                    fn call(inner_total: *std.atomic.Value(usize), start: usize, end: usize) void {
+                        _ = inner_total.fetchAdd(end - start, .seq_cst);
+                    }
+                }.call) catch @panic("Failed to run parallel for.");
+                future.join() catch @panic("Failed to join a job.");
+            }
+        }
+    };
+    var threads: [8]std.Thread = undefined;
+    for (&threads) |*thread| {
+        thread.* = try std.Thread.spawn(.{}, Submitter.call, .{ &pool, &total });
+    }
+    for (&threads) |*thread| {
+        thread.join();
+    }
+    try testing.expectEqual(threads.len * 200 * 65, total.load(.seq_cst));
+    try testing.expectEqual(0, pool.number_of_queued.load(.seq_cst));
+    pool.deinit();
+}
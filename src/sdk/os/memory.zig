@@ -1,7 +1,13 @@
 const std = @import("std");
+const builtin = @import("builtin");
 const w32 = @import("win32").everything;
 
 pub fn isMemoryReadable(address: usize, size_in_bytes: usize) bool {
+    switch (builtin.os.tag) {
+        .windows => {},
+        .linux => return isMemoryReadableByProbing(address, size_in_bytes),
+        else => @compileError("Checking memory access is not supported on " ++ @tagName(builtin.os.tag) ++ "."),
+    }
     return isMemoryAccessibleAndInOneOfModes(address, size_in_bytes, &.{
         w32.PAGE_EXECUTE_READ,
         w32.PAGE_EXECUTE_READWRITE,
@@ -13,6 +19,11 @@ pub fn isMemoryReadable(address: usize, size_in_bytes: usize) bool {
 }
 
 pub fn isMemoryWriteable(address: usize, size_in_bytes: usize) bool {
+    switch (builtin.os.tag) {
+        .windows => {},
+        .linux => return isMappedMemoryAccessible(address, size_in_bytes, true),
+        else => @compileError("Checking memory access is not supported on " ++ @tagName(builtin.os.tag) ++ "."),
+    }
     return isMemoryAccessibleAndInOneOfModes(address, size_in_bytes, &.{
         w32.PAGE_EXECUTE_READWRITE,
         w32.PAGE_EXECUTE_WRITECOPY,
@@ -70,6 +81,87 @@ fn isMemoryAccessibleAndInOneOfModes(
     return true;
 }
 
+// Linux implementation used by native benchmarks. Walks the sorted mappings listed in /proc/self/maps, so it must not
+// be used on other systems, where the file either does not exist or has a different format.
+fn isMappedMemoryAccessible(address: usize, size_in_bytes: usize, requires_write: bool) bool {
+    if (size_in_bytes == 0) {
+        return true;
+    }
+    if (!isMemoryRangeValid(address, size_in_bytes)) {
+        return false;
+    }
+    const file = std.fs.openFileAbsolute("/proc/self/maps", .{}) catch return false;
+    defer file.close();
+    var buffer: [4096]u8 = undefined;
+    var reader = file.readerStreaming(&buffer);
+    const last_address = address +% size_in_bytes -% 1;
+    var current_address = address;
+    while (true) {
+        const line = reader.interface.takeDelimiterInclusive('\n') catch return false;
+        var parts = std.mem.tokenizeScalar(u8, std.mem.trimRight(u8, line, "\n"), ' ');
+        const range = parts.next() orelse return false;
+        const permissions = parts.next() orelse return false;
+        const separator_index = std.mem.indexOfScalar(u8, range, '-') orelse return false;
+        const start = std.fmt.parseInt(usize, range[0..separator_index], 16) catch return false;
+        const end = std.fmt.parseInt(usize, range[separator_index + 1 ..], 16) catch return false;
+        if (end <= current_address) {
+            continue;
+        }
+        if (start > current_address or permissions.len < 2) {
+            return false;
+        }
+        if (permissions[0] != 'r' or (requires_write and permissions[1] != 'w')) {
+            return false;
+        }
+        if (end -% 1 >= last_address) {
+            return true;
+        }
+        current_address = end;
+    }
+}
+
+// Linux implementation used by native benchmarks. Reads one byte of every page in the range using process_vm_readv,
+// which reports unmapped memory as an error instead of faulting. Unlike parsing /proc/self/maps, this is cheap enough
+// to be called for every field of every struct proxy on every frame. Falls back to the mappings when the system call
+// is not permitted.
+fn isMemoryReadableByProbing(address: usize, size_in_bytes: usize) bool {
+    if (size_in_bytes == 0) {
+        return true;
+    }
+    if (address == 0 or !isMemoryRangeValid(address, size_in_bytes)) {
+        return false;
+    }
+    const linux = std.os.linux;
+    const page_size = std.heap.pageSize();
+    const last_address = address +% size_in_bytes -% 1;
+    const batch_size = 64;
+    var probe_buffer: [batch_size]u8 = undefined;
+    var remote: [batch_size]std.posix.iovec_const = undefined;
+    var current_address = address;
+    var is_last_batch = false;
+    while (!is_last_batch) {
+        var len: usize = 0;
+        while (len < batch_size) {
+            remote[len] = .{ .base = @ptrFromInt(current_address), .len = 1 };
+            len += 1;
+            const next_page = @addWithOverflow(std.mem.alignBackward(usize, current_address, page_size), page_size);
+            if (next_page[1] == 1 or next_page[0] > last_address) {
+                is_last_batch = true;
+                break;
+            }
+            current_address = next_page[0];
+        }
+        const local = [1]std.posix.iovec{.{ .base = &probe_buffer, .len = len }};
+        const result = linux.process_vm_readv(linux.getpid(), &local, remote[0..len], 0);
+        switch (linux.E.init(result)) {
+            .SUCCESS => if (result != len) return false,
+            .NOSYS, .PERM => return isMappedMemoryAccessible(address, size_in_bytes, false),
+            else => return false,
+        }
+    }
+    return true;
+}
+
 pub fn isMemoryRangeValid(address: usize, size_in_bytes: usize) bool {
     const add_result = @addWithOverflow(address, size_in_bytes);
     return add_result[1] == 0 or add_result[0] == 0;
@@ -1,4 +1,5 @@
 const std = @import("std");
+const builtin = @import("builtin");
 const w32 = @import("win32").everything;
 const misc = @import("../misc/root.zig");
 const os = @import("root.zig");
@@ -8,8 +9,13 @@ pub const ProcessId = struct {
 
     const Self = @This();
 
+    // Also works natively on Linux, so host tools like benchmarks can use shared memory.
     pub fn getCurrent() Self {
-        return .{ .raw = w32.GetCurrentProcessId() };
+        if (builtin.os.tag == .windows) {
+            return .{ .raw = w32.GetCurrentProcessId() };
+        } else {
+            return .{ .raw = @intCast(std.os.linux.getpid()) };
+        }
     }
 
     pub fn findAll() !Iterator {
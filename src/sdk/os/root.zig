@@ -16,5 +16,7 @@ pub const Process = @import("process.zig").Process;
 pub const ProcessId = @import("process_id.zig").ProcessId;
 pub const RemoteSlice = @import("remote_slice.zig").RemoteSlice;
 pub const RemoteThread = @import("remote_thread.zig").RemoteThread;
+pub const SharedRingConfig = @import("shared_ring.zig").SharedRingConfig;
+pub const SharedRing = @import("shared_ring.zig").SharedRing;
 pub const SharedValue = @import("shared_value.zig").SharedValue;
 pub const WindowProcedure = @import("window_procedure.zig").WindowProcedure;
@@ -0,0 +1,488 @@
+const std = @import("std");
+const builtin = @import("builtin");
+const w32 = @import("win32").everything;
+const misc = @import("../misc/root.zig");
+const os = @import("root.zig");
+
+pub const SharedRingConfig = struct {
+    capacity: usize = 256,
+    // Description of the item's bytes. Readers refuse to open rings with a different description.
+    layout: []const u8 = "",
+};
+
+// Lock-free ring of items inside named shared memory with a single producer and any number of consumers, which can be
+// inside other processes. Unlike SharedValue, the memory stays mapped for the whole lifetime of the ring.
+//
+// Every slot has a sequence number. While writing a slot the producer sets it to an odd number and once done it sets
+// it to twice the item's sequence number. Readers check it before and after copying the item, which detects both
+// reading a slot that is being written and getting overtaken by the producer. Nobody ever waits on a lock.
+//
+// Memory structure, with all the integers little endian and offsets stored in the header:
+// header (64 bytes) | layout | slots, where slot = sequence (u64) | padding | item bytes | padding
+// On Windows the memory is a named file mapping. On other systems it's a file inside /dev/shm, same as with shm_open.
+pub fn SharedRing(comptime Item: type, comptime config: SharedRingConfig) type {
+    if (config.capacity < 2) {
+        @compileError("Shared rings need a capacity of at least 2.");
+    }
+    return struct {
+        mapping: Mapping,
+        is_producer: bool,
+
+        const Self = @This();
+        pub const capacity = config.capacity;
+
+        const magic_number = 0x474e4952594e4f52; // "RONYRING" when read as bytes.
+        const version_number = 1;
+        const cache_line_size = 64;
+        const word_size = @sizeOf(u64);
+        const item_offset = std.mem.alignForward(usize, word_size, @max(@alignOf(Item), word_size));
+        const item_words = std.math.divCeil(usize, @sizeOf(Item), word_size) catch unreachable;
+        const slot_size = std.mem.alignForward(usize, item_offset + item_words * word_size, cache_line_size);
+        const layout_offset = @sizeOf(Header);
+        const slots_offset = std.mem.alignForward(usize, layout_offset + config.layout.len, cache_line_size);
+        const memory_size = slots_offset + capacity * slot_size;
+
+        const Header = extern struct {
+            magic_number: u64,
+            version: u32,
+            capacity: u32,
+            item_size: u32,
+            slot_size: u32,
+            layout_offset: u32,
+            layout_size: u32,
+            slots_offset: u32,
+            _padding: [20]u8 = @splat(0),
+            // Sequence number of the last published item. Zero means nothing was published yet.
+            write_sequence: u64 align(8),
+
+            comptime {
+                if (@sizeOf(@This()) != cache_line_size) {
+                    @compileError("Shared ring header has to take exactly one cache line.");
+                }
+            }
+        };
+
+        pub const ReadResult = struct {
+            sequence: u64,
+            // Items that the producer overwrote before this reader got to them.
+            number_of_skipped: u64,
+        };
+
+        pub const Reader = struct {
+            next_sequence: u64,
+
+            // Returns null when there is no new item.
+            pub fn poll(self: *Reader, ring: *const Self, item: *Item) ?ReadResult {
+                var number_of_skipped: u64 = 0;
+                while (true) {
+                    const write_sequence = @atomicLoad(u64, &ring.getHeader().write_sequence, .acquire);
+                    if (self.next_sequence > write_sequence) {
+                        return null;
+                    }
+                    // The oldest slot can get overwritten at any moment, so it counts as lost already.
+                    if (write_sequence - self.next_sequence >= capacity - 1) {
+                        const oldest_sequence = write_sequence - (capacity - 2);
+                        number_of_skipped += oldest_sequence - self.next_sequence;
+                        self.next_sequence = oldest_sequence;
+                    }
+                    const sequence = self.next_sequence;
+                    self.next_sequence += 1;
+                    if (ring.readSlot(sequence, item)) {
+                        return .{ .sequence = sequence, .number_of_skipped = number_of_skipped };
+                    }
+                    number_of_skipped += 1;
+                }
+            }
+
+            // Polls until an item arrives or the timeout runs out. Spins first, then yields and then sleeps in short
+            // intervals, so waiting through long pauses costs almost nothing while items arriving back to back are
+            // picked up right away.
+            pub fn wait(self: *Reader, ring: *const Self, item: *Item, timeout_ns: u64) ?ReadResult {
+                var timer = std.time.Timer.start() catch return self.poll(ring, item);
+                var attempt: usize = 0;
+                while (true) : (attempt += 1) {
+                    if (self.poll(ring, item)) |result| {
+                        return result;
+                    }
+                    if (timer.read() >= timeout_ns) {
+                        return null;
+                    }
+                    if (attempt < 64) {
+                        std.atomic.spinLoopHint();
+                    } else if (attempt < 128) {
+                        std.Thread.yield() catch {};
+                    } else {
+                        std.Thread.sleep(50 * std.time.ns_per_us);
+                    }
+                }
+            }
+        };
+
+        pub fn create(name: []const u8) !Self {
+            var mapping = Mapping.create(name, memory_size) catch |err| {
+                misc.error_context.append("Failed to create shared memory: {s}", .{name});
+                return err;
+            };
+            errdefer mapping.close(true);
+            const self = Self{ .mapping = mapping, .is_producer = true };
+            const header = self.getHeader();
+            header.* = .{
+                .magic_number = 0,
+                .version = version_number,
+                .capacity = capacity,
+                .item_size = @sizeOf(Item),
+                .slot_size = slot_size,
+                .layout_offset = layout_offset,
+                .layout_size = config.layout.len,
+                .slots_offset = slots_offset,
+                .write_sequence = 0,
+            };
+            @memcpy(mapping.bytes[layout_offset..][0..config.layout.len], config.layout);
+            for (0..capacity) |index| {
+                @atomicStore(u64, self.getSlotSequence(index), 0, .monotonic);
+            }
+            // Magic number goes in last, so readers never see a half initialized header.
+            @atomicStore(u64, &header.magic_number, magic_number, .release);
+            return self;
+        }
+
+        pub fn open(process_id: os.ProcessId, name: []const u8) !Self {
+            var mapping = Mapping.open(process_id, name, memory_size) catch |err| {
+                misc.error_context.append("Failed to open shared memory: {s}", .{name});
+                return err;
+            };
+            errdefer mapping.close(false);
+            const self = Self{ .mapping = mapping, .is_producer = false };
+            const header = self.getHeader();
+            if (@atomicLoad(u64, &header.magic_number, .acquire) != magic_number) {
+                misc.error_context.new("Incorrect magic number.", .{});
+                return error.MagicNumber;
+            }
+            if (header.version != version_number) {
+                misc.error_context.new(
+                    "Unsupported version {}. Expected version {}.",
+                    .{ header.version, version_number },
+                );
+                return error.UnsupportedVersion;
+            }
+            const layout = mapping.bytes[layout_offset..][0..@min(header.layout_size, memory_size - layout_offset)];
+            if (header.capacity != capacity or
+                header.item_size != @sizeOf(Item) or
+                header.slot_size != slot_size or
+                header.slots_offset != slots_offset or
+                !std.mem.eql(u8, layout, config.layout))
+            {
+                misc.error_context.new("Shared ring was created with a different item layout or capacity.", .{});
+                return error.LayoutMismatch;
+            }
+            return self;
+        }
+
+        pub fn close(self: *Self) void {
+            self.mapping.close(self.is_producer);
+            self.* = undefined;
+        }
+
+        // Readers created this way only see items published after this call.
+        pub fn reader(self: *const Self) Reader {
+            const write_sequence = @atomicLoad(u64, &self.getHeader().write_sequence, .acquire);
+            return .{ .next_sequence = write_sequence + 1 };
+        }
+
+        // Must only be called by the single producer.
+        pub fn publish(self: *const Self, item: *const Item) void {
+            const header = self.getHeader();
+            const sequence = @atomicLoad(u64, &header.write_sequence, .monotonic) + 1;
+            const index = sequence % capacity;
+            const slot_sequence = self.getSlotSequence(index);
+            const words = self.getSlotWords(index);
+            var buffer: [item_words]u64 = @splat(0);
+            @memcpy(std.mem.sliceAsBytes(&buffer)[0..@sizeOf(Item)], std.mem.asBytes(item));
+
+            @atomicStore(u64, slot_sequence, 2 * sequence - 1, .monotonic);
+            for (words, &buffer) |*word, value| {
+                @atomicStore(u64, word, value, .release);
+            }
+            @atomicStore(u64, slot_sequence, 2 * sequence, .release);
+            @atomicStore(u64, &header.write_sequence, sequence, .release);
+        }
+
+        pub fn getWriteSequence(self: *const Self) u64 {
+            return @atomicLoad(u64, &self.getHeader().write_sequence, .acquire);
+        }
+
+        fn readSlot(self: *const Self, sequence: u64, item: *Item) bool {
+            const index = sequence % capacity;
+            const slot_sequence = self.getSlotSequence(index);
+            const words = self.getSlotWords(index);
+            const sequence_before = @atomicLoad(u64, slot_sequence, .acquire);
+            if (sequence_before != 2 * sequence) {
+                return false;
+            }
+            // Acquire loads keep the second sequence check from being reordered before the copy.
+            var buffer: [item_words]u64 = undefined;
+            for (&buffer, words) |*value, *word| {
+                value.* = @atomicLoad(u64, word, .acquire);
+            }
+            const sequence_after = @atomicLoad(u64, slot_sequence, .monotonic);
+            if (sequence_after != sequence_before) {
+                return false;
+            }
+            @memcpy(std.mem.asBytes(item), std.mem.sliceAsBytes(&buffer)[0..@sizeOf(Item)]);
+            return true;
+        }
+
+        fn getHeader(self: *const Self) *Header {
+            return @ptrCast(self.mapping.bytes.ptr);
+        }
+
+        fn getSlotSequence(self: *const Self, index: usize) *u64 {
+            return @ptrCast(@alignCast(&self.mapping.bytes[slots_offset + index * slot_size]));
+        }
+
+        fn getSlotWords(self: *const Self, index: usize) *[item_words]u64 {
+            return @ptrCast(@alignCast(&self.mapping.bytes[slots_offset + index * slot_size + item_offset]));
+        }
+    };
+}
+
+// Named shared memory that stays mapped until closed. Names get prefixed with the ID of the creator's process, same as
+// with SharedValue, so multiple game processes don't collide.
+const Mapping = struct {
+    bytes: []align(std.heap.page_size_min) u8,
+    handle: if (builtin.os.tag == .windows) w32.HANDLE else void,
+    path_buffer: if (builtin.os.tag == .windows) void else [std.fs.max_path_bytes]u8,
+    path_len: if (builtin.os.tag == .windows) void else usize,
+
+    const Self = @This();
+
+    fn create(name: []const u8, size: usize) !Self {
+        if (builtin.os.tag == .windows) {
+            var buffer = [_:0]u16{0} ** os.max_file_path_length;
+            const full_name = try getWindowsName(&buffer, os.ProcessId.getCurrent(), name);
+            const handle = w32.CreateFileMappingW(
+                w32.INVALID_HANDLE_VALUE,
+                null,
+                .{ .PAGE_READWRITE = 1 },
+                @intCast(@as(u64, size) >> 32),
+                @intCast(size & 0xFFFFFFFF),
+                full_name,
+            ) orelse {
+                misc.error_context.new("{f}", .{os.Error.getLast()});
+                misc.error_context.append("CreateFileMappingW returned null.", .{});
+                return error.OsError;
+            };
+            errdefer _ = w32.CloseHandle(handle);
+            return mapView(handle, w32.FILE_MAP_WRITE, size);
+        } else {
+            var self = Self{ .bytes = undefined, .handle = {}, .path_buffer = undefined, .path_len = 0 };
+            const path = try getPosixPath(&self.path_buffer, os.ProcessId.getCurrent(), name);
+            self.path_len = path.len;
+            const file = std.fs.createFileAbsolute(path, .{ .read = true, .truncate = true }) catch |err| {
+                misc.error_context.new("Failed to create file: {s}", .{path});
+                return err;
+            };
+            defer file.close();
+            errdefer std.fs.deleteFileAbsolute(path) catch {};
+            file.setEndPos(size) catch |err| {
+                misc.error_context.new("Failed to resize file {s} to {} bytes.", .{ path, size });
+                return err;
+            };
+            self.bytes = std.posix.mmap(
+                null,
+                size,
+                std.posix.PROT.READ | std.posix.PROT.WRITE,
+                .{ .TYPE = .SHARED },
+                file.handle,
+                0,
+            ) catch |err| {
+                misc.error_context.new("Failed to memory map {} bytes of: {s}", .{ size, path });
+                return err;
+            };
+            return self;
+        }
+    }
+
+    fn open(process_id: os.ProcessId, name: []const u8, size: usize) !Self {
+        if (builtin.os.tag == .windows) {
+            var buffer = [_:0]u16{0} ** os.max_file_path_length;
+            const full_name = try getWindowsName(&buffer, process_id, name);
+            const handle = w32.OpenFileMappingW(@bitCast(w32.FILE_MAP_READ), 0, full_name) orelse {
+                misc.error_context.new("{f}", .{os.Error.getLast()});
+                misc.error_context.append("OpenFileMappingW returned null.", .{});
+                return error.OsError;
+            };
+            errdefer _ = w32.CloseHandle(handle);
+            return mapView(handle, w32.FILE_MAP_READ, size);
+        } else {
+            var self = Self{ .bytes = undefined, .handle = {}, .path_buffer = undefined, .path_len = 0 };
+            const path = try getPosixPath(&self.path_buffer, process_id, name);
+            self.path_len = path.len;
+            const file = std.fs.openFileAbsolute(path, .{}) catch |err| {
+                misc.error_context.new("Failed to open file: {s}", .{path});
+                return err;
+            };
+            defer file.close();
+            const file_size = file.getEndPos() catch |err| {
+                misc.error_context.new("Failed to get size of: {s}", .{path});
+                return err;
+            };
+            if (file_size < size) {
+                misc.error_context.new("Shared memory has {} bytes while {} were expected.", .{ file_size, size });
+                return error.LayoutMismatch;
+            }
+            const protection = std.posix.PROT.READ;
+            self.bytes = std.posix.mmap(null, size, protection, .{ .TYPE = .SHARED }, file.handle, 0) catch |err| {
+                misc.error_context.new("Failed to memory map {} bytes of: {s}", .{ size, path });
+                return err;
+            };
+            return self;
+        }
+    }
+
+    // Shared memory on Windows disappears with the last handle. On other systems the creator has to remove the file.
+    fn close(self: *Self, is_creator: bool) void {
+        if (builtin.os.tag == .windows) {
+            if (w32.UnmapViewOfFile(@ptrCast(self.bytes.ptr)) == 0) {
+                misc.error_context.new("{f}", .{os.Error.getLast()});
+                misc.error_context.append("UnmapViewOfFile returned 0.", .{});
+                misc.error_context.logError(error.OsError);
+            }
+            if (w32.CloseHandle(self.handle) == 0) {
+                misc.error_context.new("{f}", .{os.Error.getLast()});
+                misc.error_context.append("CloseHandle returned 0.", .{});
+                misc.error_context.logError(error.OsError);
+            }
+        } else {
+            std.posix.munmap(self.bytes);
+            if (is_creator) {
+                const path = self.path_buffer[0..self.path_len];
+                std.fs.deleteFileAbsolute(path) catch |err| {
+                    misc.error_context.new("Failed to delete file: {s}", .{path});
+                    misc.error_context.logError(err);
+                };
+            }
+        }
+    }
+
+    fn mapView(handle: w32.HANDLE, access: w32.FILE_MAP, size: usize) !Self {
+        const pointer = w32.MapViewOfFile(handle, access, 0, 0, size) orelse {
+            misc.error_context.new("{f}", .{os.Error.getLast()});
+            misc.error_context.append("MapViewOfFile returned null.", .{});
+            return error.OsError;
+        };
+        const many_pointer: [*]align(std.heap.page_size_min) u8 = @ptrCast(@alignCast(pointer));
+        return .{ .bytes = many_pointer[0..size], .handle = handle, .path_buffer = {}, .path_len = {} };
+    }
+
+    fn getWindowsName(
+        buffer: *[os.max_file_path_length:0]u16,
+        process_id: os.ProcessId,
+        name: []const u8,
+    ) ![:0]const u16 {
+        var utf8_buffer: [os.max_file_path_length]u8 = undefined;
+        const utf8_name = std.fmt.bufPrint(&utf8_buffer, "{}-{s}", .{ process_id.raw, name }) catch |err| {
+            misc.error_context.new("Failed to construct full name: \"{}-{s}\"", .{ process_id.raw, name });
+            return err;
+        };
+        const len = std.unicode.utf8ToUtf16Le(buffer, utf8_name) catch |err| {
+            misc.error_context.new("Failed to convert \"{s}\" to UTF-16LE.", .{utf8_name});
+            return err;
+        };
+        buffer[len] = 0;
+        return buffer[0..len :0];
+    }
+
+    fn getPosixPath(buffer: *[std.fs.max_path_bytes]u8, process_id: os.ProcessId, name: []const u8) ![]const u8 {
+        return std.fmt.bufPrint(buffer, "/dev/shm/{}-{s}", .{ process_id.raw, name }) catch |err| {
+            misc.error_context.new("Failed to construct shared memory path for: {s}", .{name});
+            return err;
+        };
+    }
+};
+
+const testing = std.testing;
+
+const TestItem = struct { a: u32, b: f64, c: [3]u8 };
+const TestRing = SharedRing(TestItem, .{ .capacity = 4, .layout = "test layout" });
+
+// Mappings are already named after the process, so a counter is enough to give every test a ring of it's own, even
+// when tests run in parallel.
+var test_ring_counter = std.atomic.Value(u32).init(0);
+
+fn getTestRingName(buffer: *[32]u8) []const u8 {
+    const index = test_ring_counter.fetchAdd(1, .monotonic);
+    return std.fmt.bufPrint(buffer, "test_ring_{}", .{index}) catch unreachable;
+}
+
+test "reader should receive items in order from a separately opened mapping" {
+    var name_buffer: [32]u8 = undefined;
+    const name = getTestRingName(&name_buffer);
+    var producer = try TestRing.create(name);
+    defer producer.close();
+    var consumer = try TestRing.open(os.ProcessId.getCurrent(), name);
+    defer consumer.close();
+    var reader = consumer.reader();
+
+    var item: TestItem = undefined;
+    try testing.expectEqual(null, reader.poll(&consumer, &item));
+    producer.publish(&.{ .a = 1, .b = 1.5, .c = .{ 1, 2, 3 } });
+    producer.publish(&.{ .a = 2, .b = 2.5, .c = .{ 4, 5, 6 } });
+    const first = reader.poll(&consumer, &item);
+    try testing.expectEqual(TestRing.ReadResult{ .sequence = 1, .number_of_skipped = 0 }, first);
+    try testing.expectEqual(TestItem{ .a = 1, .b = 1.5, .c = .{ 1, 2, 3 } }, item);
+    const second = reader.poll(&consumer, &item);
+    try testing.expectEqual(TestRing.ReadResult{ .sequence = 2, .number_of_skipped = 0 }, second);
+    try testing.expectEqual(TestItem{ .a = 2, .b = 2.5, .c = .{ 4, 5, 6 } }, item);
+    try testing.expectEqual(null, reader.poll(&consumer, &item));
+}
+
+test "reader should skip items that the producer overwrote" {
+    var name_buffer: [32]u8 = undefined;
+    const name = getTestRingName(&name_buffer);
+    var producer = try TestRing.create(name);
+    defer producer.close();
+    var reader = producer.reader();
+    for (1..11) |index| {
+        producer.publish(&.{ .a = @intCast(index), .b = 0, .c = .{ 0, 0, 0 } });
+    }
+    var item: TestItem = undefined;
+    const result = reader.poll(&producer, &item);
+    try testing.expect(result != null);
+    try testing.expectEqual(result.?.number_of_skipped + 1, result.?.sequence);
+    try testing.expectEqual(result.?.sequence, item.a);
+    try testing.expect(result.?.sequence > 10 - TestRing.capacity);
+}
+
+test "open should fail when the ring was created with a different item layout" {
+    var name_buffer: [32]u8 = undefined;
+    const name = getTestRingName(&name_buffer);
+    var producer = try TestRing.create(name);
+    defer producer.close();
+    const OtherRing = SharedRing(TestItem, .{ .capacity = 4, .layout = "other layout" });
+    try testing.expectError(error.LayoutMismatch, OtherRing.open(os.ProcessId.getCurrent(), name));
+}
+
+test "wait should receive items that another thread publishes" {
+    var name_buffer: [32]u8 = undefined;
+    const name = getTestRingName(&name_buffer);
+    var producer = try TestRing.create(name);
+    defer producer.close();
+    var reader = producer.reader();
+    const thread = try std.Thread.spawn(.{}, struct {
+        fn call(ring: *const TestRing) void {
+            for (1..4) |index| {
+                std.Thread.sleep(std.time.ns_per_ms);
+                ring.publish(&.{ .a = @intCast(index), .b = 0, .c = .{ 0, 0, 0 } });
+            }
+        }
+    }.call, .{&producer});
+    defer thread.join();
+
+    var item: TestItem = undefined;
+    for (1..4) |index| {
+        const result = reader.wait(&producer, &item, std.time.ns_per_s);
+        try testing.expect(result != null);
+        try testing.expectEqual(index, item.a);
+    }
+}
@@ -0,0 +1,192 @@
+const std = @import("std");
+const imgui = @import("imgui");
+const misc = @import("../misc/root.zig");
+const ui = @import("root.zig");
+
+// Remembers the geometry that got drawn into the window's draw list between begin and end. As long as the key stays
+// the same, the geometry gets copied into the draw list instead of being drawn again. The key has to cover everything
+// that the drawing depends on. Style alpha, anti-aliasing flags and the font atlas get mixed in by the cache itself.
+// Geometry only gets remembered once the same key shows up twice in a row, so keys that change every frame cost
+// nothing more than computing the key.
+pub const DrawListCache = struct {
+    allocator: std.mem.Allocator,
+    key: ?u64 = null,
+    previous_key: ?u64 = null,
+    vertices: std.ArrayList(imgui.ImDrawVert) = .empty,
+    indices: std.ArrayList(imgui.ImDrawIdx) = .empty,
+    recording: ?Recording = null,
+
+    const Self = @This();
+    const Recording = struct {
+        key: u64,
+        draw_list: *imgui.ImDrawList,
+        vertices_start: usize,
+        indices_start: usize,
+        number_of_commands: c_int,
+        vertex_index: c_uint,
+    };
+
+    pub fn init(allocator: std.mem.Allocator) Self {
+        return .{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *Self) void {
+        self.vertices.deinit(self.allocator);
+        self.indices.deinit(self.allocator);
+    }
+
+    pub fn invalidate(self: *Self) void {
+        self.key = null;
+        self.previous_key = null;
+    }
+
+    // Returns true if the cached geometry got replayed. Otherwise the caller has to draw and then call end.
+    pub fn begin(self: *Self, key: u64) bool {
+        const draw_list = imgui.igGetWindowDrawList();
+        const full_key = getFullKey(draw_list, key);
+        if (self.key == full_key) {
+            self.replay(draw_list);
+            return true;
+        }
+        self.key = null;
+        if (self.previous_key != full_key) {
+            self.previous_key = full_key;
+            return false;
+        }
+        self.recording = .{
+            .key = full_key,
+            .draw_list = draw_list,
+            .vertices_start = @intCast(draw_list.*.VtxBuffer.Size),
+            .indices_start = @intCast(draw_list.*.IdxBuffer.Size),
+            .number_of_commands = draw_list.*.CmdBuffer.Size,
+            .vertex_index = draw_list.*._VtxCurrentIdx,
+        };
+        return false;
+    }
+
+    pub fn end(self: *Self) void {
+        const recording = self.recording orelse return;
+        self.recording = null;
+        const draw_list = recording.draw_list;
+        // Geometry that ended up split between draw commands can not be replayed as a single block.
+        const number_of_vertices = @as(usize, @intCast(draw_list.*.VtxBuffer.Size)) - recording.vertices_start;
+        if (draw_list.*.CmdBuffer.Size != recording.number_of_commands or
+            draw_list.*._VtxCurrentIdx - recording.vertex_index != number_of_vertices)
+        {
+            return;
+        }
+        const number_of_indices = @as(usize, @intCast(draw_list.*.IdxBuffer.Size)) - recording.indices_start;
+        const vertices = draw_list.*.VtxBuffer.Data[recording.vertices_start..][0..number_of_vertices];
+        const indices = draw_list.*.IdxBuffer.Data[recording.indices_start..][0..number_of_indices];
+
+        self.vertices.clearRetainingCapacity();
+        self.indices.clearRetainingCapacity();
+        self.vertices.appendSlice(self.allocator, vertices) catch |err| {
+            misc.error_context.new("Failed to cache {} draw list vertices.", .{number_of_vertices});
+            misc.error_context.logError(err);
+            return;
+        };
+        self.indices.ensureTotalCapacity(self.allocator, number_of_indices) catch |err| {
+            misc.error_context.new("Failed to cache {} draw list indices.", .{number_of_indices});
+            misc.error_context.logError(err);
+            return;
+        };
+        // Indices are stored relative to the first vertex, so they can be moved to wherever the replay ends up.
+        for (indices) |index| {
+            self.indices.appendAssumeCapacity(@intCast(index - recording.vertex_index));
+        }
+        self.key = recording.key;
+    }
+
+    fn replay(self: *const Self, draw_list: *imgui.ImDrawList) void {
+        const number_of_vertices = self.vertices.items.len;
+        const number_of_indices = self.indices.items.len;
+        if (number_of_vertices == 0 or number_of_indices == 0) {
+            return;
+        }
+        imgui.ImDrawList_PrimReserve(draw_list, @intCast(number_of_indices), @intCast(number_of_vertices));
+        const vertex_index = draw_list._VtxCurrentIdx;
+        @memcpy(draw_list._VtxWritePtr[0..number_of_vertices], self.vertices.items);
+        for (self.indices.items, draw_list._IdxWritePtr[0..number_of_indices]) |index, *destination| {
+            destination.* = @intCast(vertex_index + index);
+        }
+        draw_list._VtxWritePtr += number_of_vertices;
+        draw_list._IdxWritePtr += number_of_indices;
+        draw_list._VtxCurrentIdx += @intCast(number_of_vertices);
+    }
+
+    fn getFullKey(draw_list: *const imgui.ImDrawList, key: u64) u64 {
+        var hasher = std.hash.Wyhash.init(key);
+        hasher.update(std.mem.asBytes(&imgui.igGetStyle().*.Alpha));
+        hasher.update(std.mem.asBytes(&draw_list.Flags));
+        hasher.update(std.mem.asBytes(&draw_list._FringeScale));
+        hasher.update(std.mem.asBytes(&imgui.igGetIO_Nil().*.Fonts.*.TexUvWhitePixel));
+        return hasher.final();
+    }
+};
+
+const testing = std.testing;
+
+test "should replay the same geometry while the key stays the same" {
+    const Test = struct {
+        var cache: DrawListCache = undefined;
+        var key: u64 = 1;
+        var was_replayed = false;
+        var positions: std.ArrayList(imgui.ImVec2) = .empty;
+
+        fn guiFunction(_: ui.TestContext) !void {
+            imgui.igSetNextWindowPos(.{ .x = 0, .y = 0 }, imgui.ImGuiCond_Always, .{});
+            _ = imgui.igBegin("Window", null, 0);
+            defer imgui.igEnd();
+            const draw_list = imgui.igGetWindowDrawList();
+            const indices_start: usize = @intCast(draw_list.*.IdxBuffer.Size);
+            was_replayed = cache.begin(key);
+            if (!was_replayed) {
+                const color = imgui.igGetColorU32_Vec4(.{ .x = 1, .y = 0, .z = 0, .w = 1 });
+                imgui.ImDrawList_AddLine(draw_list, .{ .x = 10, .y = 10 }, .{ .x = 50, .y = 20 }, color, 2);
+                imgui.ImDrawList_AddCircle(draw_list, .{ .x = 30, .y = 30 }, 10, color, 16, 1);
+                cache.end();
+            }
+            // Positions of the vertices in the order that the indices reference them.
+            positions.clearRetainingCapacity();
+            const cmd = &draw_list.*.CmdBuffer.Data[@intCast(draw_list.*.CmdBuffer.Size - 1)];
+            const indices_end: usize = @intCast(draw_list.*.IdxBuffer.Size);
+            for (draw_list.*.IdxBuffer.Data[indices_start..indices_end]) |index| {
+                const vertex = draw_list.*.VtxBuffer.Data[cmd.VtxOffset + index];
+                try positions.append(testing.allocator, vertex.pos);
+            }
+        }
+
+        fn testFunction(ctx: ui.TestContext) !void {
+            cache.invalidate();
+            ctx.yield(1);
+            try testing.expect(!was_replayed);
+            ctx.yield(1);
+            try testing.expect(!was_replayed);
+            const drawn = try testing.allocator.dupe(imgui.ImVec2, positions.items);
+            defer testing.allocator.free(drawn);
+            try testing.expect(drawn.len > 0);
+
+            ctx.yield(1);
+            try testing.expect(was_replayed);
+            try testing.expectEqualSlices(imgui.ImVec2, drawn, positions.items);
+
+            key = 2;
+            ctx.yield(1);
+            try testing.expect(!was_replayed);
+            ctx.yield(1);
+            try testing.expect(!was_replayed);
+            ctx.yield(1);
+            try testing.expect(was_replayed);
+
+            cache.invalidate();
+            ctx.yield(1);
+            try testing.expect(!was_replayed);
+        }
+    };
+    Test.cache = .init(testing.allocator);
+    defer Test.cache.deinit();
+    defer Test.positions.deinit(testing.allocator);
+    const context = try ui.getTestingContext();
+    try context.runTest(.{}, Test.guiFunction, Test.testFunction);
+}
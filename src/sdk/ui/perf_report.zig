@@ -0,0 +1,147 @@
+const std = @import("std");
+const builtin = @import("builtin");
+const misc = @import("../misc/root.zig");
+
+pub const PerfResult = struct {
+    name: []const u8,
+    number_of_frames: usize,
+    mean_frame_time_ns: u64,
+    max_frame_time_ns: u64,
+    mean_vertices: u64,
+    max_vertices: u64,
+    mean_draw_calls: u64,
+    max_draw_calls: u64,
+};
+
+pub const PerfReportFormat = enum { json, junit };
+
+pub fn writePerfReport(writer: *std.io.Writer, format: PerfReportFormat, results: []const PerfResult) !void {
+    switch (format) {
+        .json => writeJson(writer, results) catch |err| {
+            misc.error_context.new("Failed to write perf report as JSON.", .{});
+            return err;
+        },
+        .junit => writeJUnit(writer, results) catch |err| {
+            misc.error_context.new("Failed to write perf report as JUnit XML.", .{});
+            return err;
+        },
+    }
+}
+
+pub fn savePerfReport(file_path: []const u8, format: PerfReportFormat, results: []const PerfResult) !void {
+    const file = std.fs.cwd().createFile(file_path, .{}) catch |err| {
+        misc.error_context.new("Failed to create or open file: {s}", .{file_path});
+        return err;
+    };
+    defer file.close();
+    var buffer: [4096]u8 = undefined;
+    var file_writer = file.writer(&buffer);
+    writePerfReport(&file_writer.interface, format, results) catch |err| {
+        misc.error_context.append("Failed to write perf report to: {s}", .{file_path});
+        return err;
+    };
+    file_writer.end() catch |err| {
+        misc.error_context.new("Failed to end file writing.", .{});
+        return err;
+    };
+}
+
+fn writeJson(writer: *std.io.Writer, results: []const PerfResult) !void {
+    const report = struct {
+        build_mode: []const u8 = @tagName(builtin.mode),
+        results: []const PerfResult,
+    }{ .results = results };
+    try std.json.Stringify.value(report, .{ .whitespace = .indent_2 }, writer);
+    try writer.writeByte('\n');
+}
+
+// Every perf test becomes a test case with its frame time as the duration. The rest of the measurements go into
+// properties, so CI systems that understand JUnit can show them next to the test.
+fn writeJUnit(writer: *std.io.Writer, results: []const PerfResult) !void {
+    var total_time: u64 = 0;
+    for (results) |*result| {
+        total_time += result.mean_frame_time_ns;
+    }
+    try writer.writeAll("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    try writer.print(
+        "<testsuites tests=\"{}\" failures=\"0\" time=\"{d:.9}\">\n",
+        .{ results.len, nanosecondsToSeconds(total_time) },
+    );
+    try writer.print(
+        "  <testsuite name=\"perf\" tests=\"{}\" failures=\"0\" time=\"{d:.9}\">\n",
+        .{ results.len, nanosecondsToSeconds(total_time) },
+    );
+    for (results) |*result| {
+        try writer.writeAll("    <testcase classname=\"perf\" name=\"");
+        try writeXmlEscaped(writer, result.name);
+        try writer.print("\" time=\"{d:.9}\">\n", .{nanosecondsToSeconds(result.mean_frame_time_ns)});
+        try writer.writeAll("      <properties>\n");
+        inline for (@typeInfo(PerfResult).@"struct".fields) |*field| {
+            if (field.type == u64 or field.type == usize) {
+                try writer.print(
+                    "        <property name=\"{s}\" value=\"{}\"/>\n",
+                    .{ field.name, @field(result, field.name) },
+                );
+            }
+        }
+        try writer.writeAll("      </properties>\n");
+        try writer.writeAll("    </testcase>\n");
+    }
+    try writer.writeAll("  </testsuite>\n");
+    try writer.writeAll("</testsuites>\n");
+}
+
+fn writeXmlEscaped(writer: *std.io.Writer, text: []const u8) !void {
+    for (text) |character| {
+        switch (character) {
+            '&' => try writer.writeAll("&amp;"),
+            '<' => try writer.writeAll("&lt;"),
+            '>' => try writer.writeAll("&gt;"),
+            '"' => try writer.writeAll("&quot;"),
+            '\'' => try writer.writeAll("&apos;"),
+            else => try writer.writeByte(character),
+        }
+    }
+}
+
+fn nanosecondsToSeconds(nanoseconds: u64) f64 {
+    const value: f64 = @floatFromInt(nanoseconds);
+    return value / std.time.ns_per_s;
+}
+
+const testing = std.testing;
+
+const testing_results = [_]PerfResult{.{
+    .name = "main_window.<live>",
+    .number_of_frames = 600,
+    .mean_frame_time_ns = 1_500_000,
+    .max_frame_time_ns = 3_000_000,
+    .mean_vertices = 40_000,
+    .max_vertices = 45_000,
+    .mean_draw_calls = 120,
+    .max_draw_calls = 130,
+}};
+
+test "writePerfReport should write JSON that parses back into the same results" {
+    var writer = std.io.Writer.Allocating.init(testing.allocator);
+    defer writer.deinit();
+    try writePerfReport(&writer.writer, .json, &testing_results);
+
+    const Report = struct { build_mode: []const u8, results: []const PerfResult };
+    const parsed = try std.json.parseFromSlice(Report, testing.allocator, writer.written(), .{});
+    defer parsed.deinit();
+    try testing.expectEqualDeep(@as([]const PerfResult, &testing_results), parsed.value.results);
+}
+
+test "writePerfReport should write JUnit XML with escaped names and measurements as properties" {
+    var writer = std.io.Writer.Allocating.init(testing.allocator);
+    defer writer.deinit();
+    try writePerfReport(&writer.writer, .junit, &testing_results);
+    const xml = writer.written();
+
+    try testing.expect(std.mem.indexOf(u8, xml, "<testsuite name=\"perf\" tests=\"1\"") != null);
+    try testing.expect(std.mem.indexOf(u8, xml, "name=\"main_window.&lt;live&gt;\" time=\"0.001500000\"") != null);
+    try testing.expect(std.mem.indexOf(u8, xml, "<property name=\"mean_vertices\" value=\"40000\"/>") != null);
+    try testing.expect(std.mem.indexOf(u8, xml, "<property name=\"max_draw_calls\" value=\"130\"/>") != null);
+    try testing.expect(std.mem.endsWith(u8, xml, "</testsuites>\n"));
+}
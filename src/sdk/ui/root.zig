@@ -3,9 +3,16 @@ pub const getAllocator = @import("allocator.zig").getAllocator;
 pub const backend = @import("backend.zig");
 pub const default_font_size = @import("context.zig").default_font_size;
 pub const Context = @import("context.zig").Context;
+pub const DrawListCache = @import("draw_list_cache.zig").DrawListCache;
 pub const getTestingContext = @import("testing_context.zig").getTestingContext;
 pub const deinitTestingContextAndDetectLeaks = @import("testing_context.zig").deinitTestingContextAndDetectLeaks;
+pub const PerfResult = @import("perf_report.zig").PerfResult;
+pub const PerfReportFormat = @import("perf_report.zig").PerfReportFormat;
+pub const writePerfReport = @import("perf_report.zig").writePerfReport;
+pub const savePerfReport = @import("perf_report.zig").savePerfReport;
 pub const TestContext = @import("test_context.zig").TestContext;
 pub const TestingContext = @import("testing_context.zig").TestingContext;
+pub const PerfTest = @import("testing_context.zig").PerfTest;
+pub const PerfConfig = @import("testing_context.zig").PerfConfig;
 pub const ToastType = @import("toasts.zig").ToastType;
 pub const toasts = @import("toasts.zig").Toasts(.{});
@@ -42,6 +42,59 @@ pub fn deinitTestingContextAndDetectLeaks() void {
     }
 }
 
+pub const PerfTest = struct {
+    name: [:0]const u8,
+    guiFunction: *const TestingContext.Function,
+};
+
+pub const PerfConfig = struct {
+    category: [:0]const u8 = "perf",
+    number_of_warm_up_frames: c_int = 10,
+    number_of_frames: c_int = 600,
+    display_size: imgui.ImVec2 = .{ .x = 1920, .y = 1080 },
+    run_flags: imgui.ImGuiTestRunFlags = imgui.ImGuiTestRunFlags_None,
+};
+
+const PerfMeasurement = struct {
+    number_of_frames: usize = 0,
+    total_frame_time: u64 = 0,
+    max_frame_time: u64 = 0,
+    total_vertices: u64 = 0,
+    max_vertices: u64 = 0,
+    total_draw_calls: u64 = 0,
+    max_draw_calls: u64 = 0,
+
+    const Self = @This();
+
+    fn add(self: *Self, frame_time: u64, draw_data: *const imgui.ImDrawData) void {
+        const vertices: u64 = @intCast(draw_data.TotalVtxCount);
+        var draw_calls: u64 = 0;
+        for (0..@intCast(draw_data.CmdListsCount)) |index| {
+            draw_calls += @intCast(draw_data.CmdLists.Data[index].*.CmdBuffer.Size);
+        }
+        self.number_of_frames += 1;
+        self.total_frame_time += frame_time;
+        self.max_frame_time = @max(self.max_frame_time, frame_time);
+        self.total_vertices += vertices;
+        self.max_vertices = @max(self.max_vertices, vertices);
+        self.total_draw_calls += draw_calls;
+        self.max_draw_calls = @max(self.max_draw_calls, draw_calls);
+    }
+
+    fn toResult(self: *const Self, name: []const u8) ui.PerfResult {
+        return .{
+            .name = name,
+            .number_of_frames = self.number_of_frames,
+            .mean_frame_time_ns = self.total_frame_time / self.number_of_frames,
+            .max_frame_time_ns = self.max_frame_time,
+            .mean_vertices = self.total_vertices / self.number_of_frames,
+            .max_vertices = self.max_vertices,
+            .mean_draw_calls = self.total_draw_calls / self.number_of_frames,
+            .max_draw_calls = self.max_draw_calls,
+        };
+    }
+};
+
 pub const TestingContext = struct {
     allocator: std.mem.Allocator,
     old_allocator: ?std.mem.Allocator,
@@ -185,6 +238,94 @@ pub const TestingContext = struct {
         }
     }
 
+    // Runs the GUI functions of the perf tests as the engine's perf group and measures every frame they draw.
+    // Nothing gets rendered, so the frame time is only the CPU time of building the draw lists.
+    pub fn runPerfTests(
+        self: *const Self,
+        comptime config: PerfConfig,
+        comptime perf_tests: []const PerfTest,
+        filter: ?[:0]const u8,
+        results: *[perf_tests.len]?ui.PerfResult,
+    ) !void {
+        const State = struct {
+            var active_index: ?usize = null;
+            var is_measuring = false;
+            var returned_error: ?anyerror = null;
+        };
+        State.active_index = null;
+        State.is_measuring = false;
+        State.returned_error = null;
+
+        var registered: [perf_tests.len]*imgui.ImGuiTest = undefined;
+        defer {
+            for (registered) |the_test| {
+                imgui.teUnregisterTest(self.engine, the_test);
+            }
+        }
+        inline for (perf_tests, 0..) |*perf_test, index| {
+            const Functions = struct {
+                fn gui(raw_ctx: [*c]imgui.ImGuiTestContext) callconv(.c) void {
+                    if (State.returned_error != null) {
+                        return;
+                    }
+                    perf_test.guiFunction(.{ .raw = raw_ctx }) catch |err| {
+                        misc.error_context.append("Failed to execute perf test's GUI function: {s}", .{perf_test.name});
+                        misc.error_context.logError(err);
+                        State.returned_error = err;
+                    };
+                }
+
+                fn testFunction(raw_ctx: [*c]imgui.ImGuiTestContext) callconv(.c) void {
+                    const ctx = ui.TestContext{ .raw = raw_ctx };
+                    State.active_index = index;
+                    ctx.yield(config.number_of_warm_up_frames);
+                    State.is_measuring = true;
+                    ctx.yield(config.number_of_frames);
+                    State.is_measuring = false;
+                }
+            };
+            const the_test = imgui.teRegisterTest(self.engine, config.category, perf_test.name, null, 0);
+            the_test.*.Group = imgui.ImGuiTestGroup_Perfs;
+            the_test.*.GuiFunc = Functions.gui;
+            the_test.*.TestFunc = Functions.testFunction;
+            registered[index] = the_test;
+        }
+
+        var measurements: [perf_tests.len]PerfMeasurement = @splat(.{});
+        imgui.teClearUiState();
+        imgui.teQueueTests(self.engine, imgui.ImGuiTestGroup_Perfs, if (filter) |f| f.ptr else null, config.run_flags);
+        while (!imgui.teIsTestQueueEmpty(self.engine)) {
+            misc.error_context.clear();
+
+            const imgui_io = imgui.igGetIO_Nil();
+            imgui_io.*.DisplaySize = config.display_size;
+            imgui_io.*.DeltaTime = 1.0 / 60.00;
+
+            var timer = std.time.Timer.start() catch |err| {
+                misc.error_context.new("Failed to start the frame timer.", .{});
+                return err;
+            };
+            imgui.igNewFrame();
+            imgui.igRender();
+            const frame_time = timer.read();
+            if (State.is_measuring) {
+                measurements[State.active_index.?].add(frame_time, imgui.igGetDrawData());
+            }
+            imgui.tePostSwap(self.engine);
+        }
+        if (State.returned_error) |err| {
+            return err;
+        }
+
+        for (&measurements, perf_tests, results, registered) |*measurement, *perf_test, *result, the_test| {
+            result.* = if (measurement.number_of_frames > 0) measurement.toResult(perf_test.name) else null;
+            if (the_test.*.Output.Status == imgui.ImGuiTestStatus_Error) {
+                printTestFailedLog(.{}, the_test);
+                return error.UiTestFailed;
+            }
+        }
+    }
+
     fn printTestFailedLog(comptime config: Config, the_test: *imgui.ImGuiTest) void {
         if (config.disable_printing) {
             return;
@@ -293,3 +434,38 @@ test "should have a working clipboard" {
     const context = try getTestingContext();
     try context.runTest(.{}, Test.guiFunction, Test.testFunction);
 }
+
+test "runPerfTests should measure frames of every perf test" {
+    const Test = struct {
+        fn emptyWindow(_: ui.TestContext) !void {
+            _ = imgui.igBegin("Empty", null, 0);
+            defer imgui.igEnd();
+        }
+
+        fn manyButtons(_: ui.TestContext) !void {
+            _ = imgui.igBegin("Buttons", null, 0);
+            defer imgui.igEnd();
+            for (0..100) |index| {
+                imgui.igPushID_Int(@intCast(index));
+                defer imgui.igPopID();
+                _ = imgui.igButton("Button", .{});
+            }
+        }
+    };
+    const perf_tests = [_]PerfTest{
+        .{ .name = "empty_window", .guiFunction = Test.emptyWindow },
+        .{ .name = "many_buttons", .guiFunction = Test.manyButtons },
+    };
+    var results: [perf_tests.len]?ui.PerfResult = undefined;
+    const context = try getTestingContext();
+    try context.runPerfTests(.{ .number_of_frames = 5 }, &perf_tests, null, &results);
+
+    const empty_window = results[0] orelse return error.MissingResult;
+    const many_buttons = results[1] orelse return error.MissingResult;
+    try testing.expectEqualStrings("empty_window", empty_window.name);
+    try testing.expectEqualStrings("many_buttons", many_buttons.name);
+    try testing.expect(empty_window.number_of_frames > 0);
+    try testing.expect(many_buttons.number_of_frames > 0);
+    try testing.expect(many_buttons.mean_vertices > empty_window.mean_vertices);
+    try testing.expect(many_buttons.max_frame_time_ns >= many_buttons.mean_frame_time_ns);
+}
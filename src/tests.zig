@@ -16,7 +16,16 @@ test {
 
     _ = @import("sdk/io/bit.zig");
     _ = @import("sdk/io/byte.zig");
+    _ = @import("sdk/io/change_mask.zig");
+    _ = @import("sdk/io/chunk_store.zig");
+    _ = @import("sdk/io/columnar.zig");
+    _ = @import("sdk/io/delta.zig");
+    _ = @import("sdk/io/hashing.zig");
+    _ = @import("sdk/io/pipeline.zig");
+    _ = @import("sdk/io/predictive.zig");
     _ = @import("sdk/io/recording.zig");
+    _ = @import("sdk/io/recording_index.zig");
+    _ = @import("sdk/io/scratch.zig");
     _ = @import("sdk/io/settings.zig");
     _ = @import("sdk/io/xz.zig");
 
@@ -47,10 +56,14 @@ test {
     _ = @import("sdk/memory/struct_with_offsets.zig");
 
     _ = @import("sdk/misc/base_dir.zig");
+    _ = @import("sdk/misc/channel.zig");
     _ = @import("sdk/misc/circular_buffer.zig");
     _ = @import("sdk/misc/error_context.zig");
     _ = @import("sdk/misc/meta.zig");
+    _ = @import("sdk/misc/packed.zig");
+    _ = @import("sdk/misc/tagging_allocator.zig");
     _ = @import("sdk/misc/task.zig");
+    _ = @import("sdk/misc/thread_pool.zig");
     _ = @import("sdk/misc/timer.zig");
     _ = @import("sdk/misc/timestamp.zig");
 
@@ -62,14 +75,21 @@ test {
     _ = @import("sdk/os/process.zig");
     _ = @import("sdk/os/remote_slice.zig");
     _ = @import("sdk/os/remote_thread.zig");
+    _ = @import("sdk/os/shared_ring.zig");
     _ = @import("sdk/os/shared_value.zig");
     _ = @import("sdk/os/window_procedure.zig");
 
     _ = @import("sdk/ui/allocator.zig");
+    _ = @import("sdk/ui/perf_report.zig");
     _ = @import("sdk/ui/context.zig"); // Make sure this test gets executed before UI testing context is initialized.
     _ = @import("sdk/ui/testing_context.zig"); // First test using UI testing context.
+    _ = @import("sdk/ui/draw_list_cache.zig");
     _ = @import("sdk/ui/toasts.zig");
 
+    _ = @import("bench/game_memory.zig");
+    _ = @import("bench/report.zig");
+    _ = @import("bench/runner.zig");
+
     _ = @import("injector.zig");
     _ = @import("injector/injected_module.zig");
     _ = @import("injector/process_loop.zig");
@@ -80,9 +100,15 @@ test {
     _ = @import("dll/core/controller.zig");
     _ = @import("dll/core/core.zig");
     _ = @import("dll/core/hit_detector.zig");
+    _ = @import("dll/core/input_index.zig");
+    _ = @import("dll/core/instant_replay.zig");
+    _ = @import("dll/core/move_database.zig");
     _ = @import("dll/core/move_detector.zig");
     _ = @import("dll/core/move_measurer.zig");
     _ = @import("dll/core/pause_detector.zig");
+    _ = @import("dll/core/recording_aligner.zig");
+    _ = @import("dll/core/redetector.zig");
+    _ = @import("dll/core/snapshot_recorder.zig");
 
     _ = @import("dll/game/capturer.zig");
     _ = @import("dll/game/conversions.zig");
@@ -115,10 +141,13 @@ test {
     _ = @import("dll/ui/hit_lines.zig");
     _ = @import("dll/ui/hurt_cylinders.zig");
     _ = @import("dll/ui/ingame_camera.zig");
+    _ = @import("dll/ui/input_search_window.zig");
     _ = @import("dll/ui/logs_window.zig");
     _ = @import("dll/ui/main_window.zig");
     _ = @import("dll/ui/measure_tool.zig");
+    _ = @import("dll/ui/memory_window.zig");
     _ = @import("dll/ui/message_window.zig");
+    _ = @import("dll/ui/move_database_window.zig");
     _ = @import("dll/ui/navigation_layout.zig");
     _ = @import("dll/ui/quadrant_layout.zig");
     _ = @import("dll/ui/settings_window.zig");
@@ -0,0 +1,214 @@
+const std = @import("std");
+const imgui = @import("imgui");
+const sdk = @import("sdk/root.zig");
+const dll = @import("dll/root.zig");
+const bench = @import("bench/root.zig");
+
+const console_logger = sdk.log.ConsoleLogger(.{ .level = .info });
+pub const std_options = std.Options{
+    .log_level = .info,
+    .logFn = console_logger.logFn,
+};
+
+const usage =
+    \\Usage: zig build ui-perf -- [options]
+    \\
+    \\Options:
+    \\  --frames <n>            Number of measured frames per perf test. (Default: 600)
+    \\  --filter <text>         Only run perf tests whose name matches the test engine filter.
+    \\  --format <json|junit>   Format of the report. (Default: json)
+    \\  --output <path>         Write the report into a file instead of the standard output.
+    \\
+;
+
+const Arguments = struct {
+    number_of_frames: c_int = 600,
+    filter: ?[:0]const u8 = null,
+    format: sdk.ui.PerfReportFormat = .json,
+    output_path: ?[]const u8 = null,
+};
+
+const number_of_generated_frames = 3600;
+
+// Every perf test draws the whole main window with both players, lingering hit lines and hurt cylinders and all the
+// quadrant views, which is the heaviest thing the UI does while the game is running. The paused test keeps drawing the
+// same frame, so once the lingering shapes fade out the views replay their cached geometry.
+const perf_tests = [_]sdk.ui.PerfTest{
+    .{ .name = "main_window.live", .guiFunction = State.drawLive },
+    .{ .name = "main_window.playback", .guiFunction = State.drawPlayback },
+    .{ .name = "main_window.paused", .guiFunction = State.drawPaused },
+};
+
+const State = struct {
+    var ui_instance: dll.ui.Ui = undefined;
+    var controller: dll.core.Controller = undefined;
+    var settings = dll.model.Settings{};
+    var file_dialog_context: *imgui.ImGuiFileDialog = undefined;
+    var frames: []const dll.model.Frame = &.{};
+    var frame_index: usize = 0;
+    const base_dir = sdk.misc.BaseDir.fromStr(".") catch unreachable;
+    const delta_time = 1.0 / 60.0;
+
+    fn drawLive(ctx: sdk.ui.TestContext) !void {
+        if (ctx.isFirstGuiFrame()) {
+            controller.stop();
+            frame_index = 0;
+        }
+        const frame = &frames[frame_index % frames.len];
+        frame_index += 1;
+        controller.processFrame(frame, &ui_instance, onFrameChange);
+        drawMainWindow();
+    }
+
+    fn drawPlayback(ctx: sdk.ui.TestContext) !void {
+        if (ctx.isFirstGuiFrame()) {
+            controller.clear();
+            try controller.recording.appendSlice(controller.allocator, frames);
+            controller.play();
+        }
+        controller.update(delta_time, &ui_instance, onFrameChange);
+        drawMainWindow();
+    }
+
+    fn drawPaused(ctx: sdk.ui.TestContext) !void {
+        if (ctx.isFirstGuiFrame()) {
+            controller.clear();
+            try controller.recording.appendSlice(controller.allocator, frames);
+            controller.play();
+            controller.update(delta_time, &ui_instance, onFrameChange);
+            controller.pause();
+        }
+        controller.update(delta_time, &ui_instance, onFrameChange);
+        drawMainWindow();
+    }
+
+    fn onFrameChange(ui_pointer: *dll.ui.Ui, frame: *const dll.model.Frame) void {
+        ui_pointer.processFrame(&settings, frame);
+    }
+
+    fn drawMainWindow() void {
+        ui_instance.main_window.update(delta_time, &controller);
+        ui_instance.main_window.draw(&ui_instance, &base_dir, file_dialog_context, &controller, &settings);
+    }
+};
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    const args = std.process.argsAlloc(allocator) catch |err| {
+        sdk.misc.error_context.new("Failed to read process arguments.", .{});
+        sdk.misc.error_context.logError(err);
+        return err;
+    };
+    defer std.process.argsFree(allocator, args);
+    const arguments = parseArguments(args[1..]) catch |err| {
+        sdk.misc.error_context.logError(err);
+        std.debug.print("{s}", .{usage});
+        return err;
+    };
+
+    var context = sdk.ui.TestingContext.init(allocator) catch |err| {
+        sdk.misc.error_context.append("Failed to initialize UI testing context.", .{});
+        sdk.misc.error_context.logError(err);
+        return err;
+    };
+    defer context.deinit();
+
+    const frames = bench.generateFrames(allocator, number_of_generated_frames, 0) catch |err| {
+        sdk.misc.error_context.logError(err);
+        return err;
+    };
+    defer allocator.free(frames);
+    State.frames = frames;
+    State.ui_instance = .init(allocator);
+    defer State.ui_instance.deinit();
+    State.ui_instance.is_open = true;
+    State.controller = .init(allocator);
+    defer State.controller.deinit();
+    State.file_dialog_context = imgui.IGFD_Create() orelse {
+        sdk.misc.error_context.new("IGFD_Create returned null.", .{});
+        sdk.misc.error_context.logError(error.ImguiError);
+        return error.ImguiError;
+    };
+    defer imgui.IGFD_Destroy(State.file_dialog_context);
+
+    var results: [perf_tests.len]?sdk.ui.PerfResult = undefined;
+    context.runPerfTests(
+        .{ .number_of_frames = arguments.number_of_frames },
+        &perf_tests,
+        arguments.filter,
+        &results,
+    ) catch |err| {
+        sdk.misc.error_context.append("Failed to run perf tests.", .{});
+        sdk.misc.error_context.logError(err);
+        return err;
+    };
+    var measured: std.ArrayList(sdk.ui.PerfResult) = .empty;
+    defer measured.deinit(allocator);
+    for (&results) |*result| {
+        if (result.*) |*r| {
+            try measured.append(allocator, r.*);
+            std.log.info("{s}: {d:.3} ms per frame, {} vertices, {} draw calls", .{
+                r.name,
+                @as(f64, @floatFromInt(r.mean_frame_time_ns)) / std.time.ns_per_ms,
+                r.mean_vertices,
+                r.mean_draw_calls,
+            });
+        }
+    }
+
+    if (arguments.output_path) |path| {
+        sdk.ui.savePerfReport(path, arguments.format, measured.items) catch |err| {
+            sdk.misc.error_context.logError(err);
+            return err;
+        };
+        std.log.info("Report written to: {s}", .{path});
+    } else {
+        var buffer: [4096]u8 = undefined;
+        var stdout_writer = std.fs.File.stdout().writer(&buffer);
+        sdk.ui.writePerfReport(&stdout_writer.interface, arguments.format, measured.items) catch |err| {
+            sdk.misc.error_context.logError(err);
+            return err;
+        };
+        stdout_writer.interface.flush() catch |err| {
+            sdk.misc.error_context.new("Failed to flush the standard output.", .{});
+            sdk.misc.error_context.logError(err);
+            return err;
+        };
+    }
+}
+
+fn parseArguments(args: []const [:0]const u8) !Arguments {
+    var arguments = Arguments{};
+    var index: usize = 0;
+    while (index < args.len) : (index += 1) {
+        const arg = args[index];
+        if (index + 1 >= args.len) {
+            sdk.misc.error_context.new("Missing value for argument: {s}", .{arg});
+            return error.MissingValue;
+        }
+        index += 1;
+        const value = args[index];
+        if (std.mem.eql(u8, arg, "--frames")) {
+            arguments.number_of_frames = std.fmt.parseInt(c_int, value, 10) catch |err| {
+                sdk.misc.error_context.new("Invalid value \"{s}\" for argument: {s}", .{ value, arg });
+                return err;
+            };
+        } else if (std.mem.eql(u8, arg, "--filter")) {
+            arguments.filter = value;
+        } else if (std.mem.eql(u8, arg, "--format")) {
+            arguments.format = std.meta.stringToEnum(sdk.ui.PerfReportFormat, value) orelse {
+                sdk.misc.error_context.new("Invalid value \"{s}\" for argument: {s}", .{ value, arg });
+                return error.InvalidValue;
+            };
+        } else if (std.mem.eql(u8, arg, "--output")) {
+            arguments.output_path = value;
+        } else {
+            sdk.misc.error_context.new("Unknown argument: {s}", .{arg});
+            return error.UnknownArgument;
+        }
+    }
+    return arguments;
+}